@@ -0,0 +1,74 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ale_c_interface.h"
+
+// Benchmark of the audio path: plays the same random actions with sound
+// observations off and on (reading the audio after every step when on) and
+// reports the emulated frames per second of each.
+
+#define NUM_STEPS 20000
+#define FRAME_SKIP 4
+#define AUDIO_SAMPLES 512
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int bench(const char* rom_path, bool sound_obs) {
+    ALEInterface_handle ale = ale_create();
+    if (!ale) return 1;
+    ale_setInt(ale, "random_seed", 123);
+    ale_setInt(ale, "frame_skip", FRAME_SKIP);
+    ale_setBool(ale, "sound_obs", sound_obs);
+    if (ale_loadROM(ale, rom_path) != 0) {
+        ale_destroy(ale);
+        return 1;
+    }
+
+    int num_actions = ale_getMinimalActionSet(ale, NULL, 0);
+    Action* actions = malloc(sizeof(Action) * num_actions);
+    ale_getMinimalActionSet(ale, actions, num_actions);
+    uint8_t audio[AUDIO_SAMPLES];
+    unsigned checksum = 0;
+
+    srand(1);
+    double start = now();
+    for (int i = 0; i < NUM_STEPS; i++) {
+        ale_act(ale, actions[rand() % num_actions]);
+        if (sound_obs) {
+            ale_getAudio(ale, audio, sizeof(audio));
+            checksum += audio[i % AUDIO_SAMPLES];
+        }
+        if (ale_game_over(ale, true)) ale_reset_game(ale);
+    }
+    double elapsed = now() - start;
+
+    printf("%-24s %-10s %12.0f %10u\n", rom_path, sound_obs ? "on" : "off",
+           (double)NUM_STEPS * FRAME_SKIP / elapsed, checksum);
+
+    free(actions);
+    ale_destroy(ale);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <rom_file>...\n", argv[0]);
+        return 1;
+    }
+
+    printf("%-24s %-10s %12s %10s\n", "rom", "sound_obs", "frames/s", "checksum");
+    for (int i = 1; i < argc; i++) {
+        for (int sound_obs = 0; sound_obs < 2; sound_obs++) {
+            if (bench(argv[i], sound_obs) != 0) {
+                fprintf(stderr, "Failed to load %s.\n", argv[i]);
+                break;
+            }
+        }
+    }
+    return 0;
+}
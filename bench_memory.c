@@ -0,0 +1,96 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "ale_c_interface.h"
+
+// Benchmark of the memory footprint of an instance: creates 1, then 100, then
+// 1000 instances of one ROM and reports the bytes per instance both as
+// accounted by ale_getMemoryUsage and as measured by the growth of the
+// resident set (Linux only). The breakdown by component of the first instance
+// is printed first. An optional second argument sets observation_mode.
+
+#define MAX_COMPONENTS 64
+
+static const int counts[] = { 1, 100, 1000 };
+
+// Resident set size in bytes, or -1 where /proc is not available
+static long resident_bytes(void) {
+    long pages, resident;
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (!f) return -1;
+    int ok = fscanf(f, "%ld %ld", &pages, &resident) == 2;
+    fclose(f);
+    return ok ? resident * sysconf(_SC_PAGESIZE) : -1;
+}
+
+static ALEInterface_handle create(const char* rom_path, const char* observation_mode) {
+    ALEInterface_handle ale = ale_create();
+    if (!ale) return NULL;
+    ale_setInt(ale, "random_seed", 123);
+    if (observation_mode) ale_setString(ale, "observation_mode", observation_mode);
+    if (ale_loadROM(ale, rom_path) != 0) {
+        ale_destroy(ale);
+        return NULL;
+    }
+    // Step once so that buffers allocated on first use are counted
+    ale_act(ale, 0);
+    return ale;
+}
+
+static void print_components(ALEInterface_handle ale) {
+    const char* names[MAX_COMPONENTS];
+    size_t bytes[MAX_COMPONENTS];
+    int shared[MAX_COMPONENTS];
+    int n = ale_getMemoryUsageComponents(ale, names, bytes, shared, MAX_COMPONENTS);
+    if (n > MAX_COMPONENTS) n = MAX_COMPONENTS;
+    for (int i = 0; i < n; i++)
+        printf("  %-26s %10zu%s\n", names[i], bytes[i], shared[i] ? "  (shared)" : "");
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <rom_file> [observation_mode]\n", argv[0]);
+        return 1;
+    }
+    const char* observation_mode = argc > 2 ? argv[2] : NULL;
+    int max_count = counts[sizeof(counts) / sizeof(counts[0]) - 1];
+
+    ALEInterface_handle* ales = malloc(sizeof(ALEInterface_handle) * max_count);
+    long start = resident_bytes();
+    int created = 0;
+
+    // Instances are kept alive from one count to the next, so the resident set
+    // only ever grows and freed memory is never reused by a later count
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        for (; created < counts[c]; created++) {
+            ales[created] = create(argv[1], observation_mode);
+            if (!ales[created]) {
+                fprintf(stderr, "Failed to load %s.\n", argv[1]);
+                return 1;
+            }
+        }
+        if (c == 0) {
+            printf("Components of one instance (bytes):\n");
+            print_components(ales[0]);
+            printf("\n%8s %18s %18s\n", "envs", "accounted/env", "resident/env");
+        }
+
+        size_t accounted = 0;
+        for (int i = 0; i < created; i++) {
+            size_t total;
+            if (ale_getMemoryUsage(ales[i], &total) == 0) accounted += total;
+        }
+        long now = resident_bytes();
+        printf("%8d %18.0f", created, (double)accounted / created);
+        if (start >= 0 && now >= 0)
+            printf(" %18.0f\n", (double)(now - start) / created);
+        else
+            printf(" %18s\n", "n/a");
+    }
+
+    for (int i = 0; i < created; i++)
+        ale_destroy(ales[i]);
+    free(ales);
+    return 0;
+}
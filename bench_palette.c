@@ -0,0 +1,88 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ale_c_interface.h"
+
+// Microbenchmark for the palette converters: converts a batch of screens to
+// every observation format, with the vectorised converters on and off, and
+// checks that both produce the same bytes.
+
+#define NUM_SCREENS 64
+#define REPEATS 50
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static ALEInterface_handle create(const char* rom_path, bool simd) {
+    ALEInterface_handle ale = ale_create();
+    if (!ale) return NULL;
+    ale_setInt(ale, "random_seed", 123);
+    ale_setBool(ale, "palette_simd", simd);
+    if (ale_loadROM(ale, rom_path) != 0) {
+        ale_destroy(ale);
+        return NULL;
+    }
+    return ale;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <rom_file>\n", argv[0]);
+        return 1;
+    }
+
+    ALEInterface_handle ales[2] = { create(argv[1], false), create(argv[1], true) };
+    if (!ales[0] || !ales[1]) {
+        fprintf(stderr, "Failed to create ALE instances.\n");
+        return 1;
+    }
+
+    // Collect a batch of real screens to convert
+    size_t screen_size = (size_t)ale_getScreenWidth(ales[0]) * ale_getScreenHeight(ales[0]);
+    unsigned char* screens = malloc(screen_size * NUM_SCREENS);
+    int num_actions = ale_getMinimalActionSet(ales[0], NULL, 0);
+    Action* actions = malloc(sizeof(Action) * num_actions);
+    ale_getMinimalActionSet(ales[0], actions, num_actions);
+    for (int i = 0; i < NUM_SCREENS; i++) {
+        for (int j = 0; j < 10; j++) {
+            ale_act(ales[0], actions[(i + j) % num_actions]);
+            if (ale_game_over(ales[0], true)) ale_reset_game(ales[0]);
+        }
+        ale_getScreenBatch(&ales[0], 1, screens + i * screen_size, screen_size, NULL);
+    }
+
+    const char* names[] = { "palette", "grayscale", "rgb", "rgb_planar", "rgba" };
+    size_t out_size = screen_size * 4 * NUM_SCREENS;
+    unsigned char* out[2] = { malloc(out_size), malloc(out_size) };
+
+    printf("%-12s %14s %14s %8s\n", "format", "scalar Mpx/s", "simd Mpx/s", "speedup");
+    for (int format = ALE_OBS_PALETTE_INDEX; format <= ALE_OBS_RGBA; format++) {
+        double rate[2];
+        for (int simd = 0; simd < 2; simd++) {
+            double start = now();
+            for (int r = 0; r < REPEATS; r++) {
+                if (ale_convertScreens(ales[simd], screens, NUM_SCREENS, out[simd], out_size, format) < 0) {
+                    fprintf(stderr, "Conversion failed.\n");
+                    return 1;
+                }
+            }
+            rate[simd] = (double)screen_size * NUM_SCREENS * REPEATS / (now() - start) / 1e6;
+        }
+        int bytes = ale_convertScreens(ales[0], screens, NUM_SCREENS, out[0], out_size, format);
+        int same = memcmp(out[0], out[1], bytes) == 0;
+        printf("%-12s %14.1f %14.1f %7.2fx%s\n", names[format], rate[0], rate[1],
+               rate[1] / rate[0], same ? "" : "  MISMATCH");
+    }
+
+    free(out[0]);
+    free(out[1]);
+    free(actions);
+    free(screens);
+    ale_destroy(ales[0]);
+    ale_destroy(ales[1]);
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ale_c_interface.h"
+
+// Benchmark for the run-length encoded screen output: for every ROM given,
+// plays a few hundred steps, encodes each screen on its own and against the
+// screen before it, and reports the compression ratio and the encode/decode
+// throughput. Every encoding is decoded again and checked.
+
+#define NUM_SCREENS 256
+#define REPEATS 20
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int bench(const char* rom_path) {
+    ALEInterface_handle ale = ale_create();
+    if (!ale) return 1;
+    ale_setInt(ale, "random_seed", 123);
+    if (ale_loadROM(ale, rom_path) != 0) {
+        ale_destroy(ale);
+        return 1;
+    }
+
+    size_t screen_size = (size_t)ale_getScreenWidth(ale) * ale_getScreenHeight(ale);
+    size_t bound = (size_t)ale_encodeScreenRLE(ale, NULL, NULL, 0);
+    unsigned char* screens = malloc(screen_size * NUM_SCREENS);
+    unsigned char* encoded = malloc(bound * NUM_SCREENS);
+    size_t* sizes = malloc(sizeof(size_t) * NUM_SCREENS);
+    unsigned char* decoded = malloc(screen_size);
+
+    int num_actions = ale_getMinimalActionSet(ale, NULL, 0);
+    Action* actions = malloc(sizeof(Action) * num_actions);
+    ale_getMinimalActionSet(ale, actions, num_actions);
+
+    const char* names[] = { "rle", "rle+delta" };
+    for (int delta = 0; delta < 2; delta++) {
+        ale_reset_game(ale);
+        double encode_time = 0;
+        size_t total = 0;
+        for (int i = 0; i < NUM_SCREENS; i++) {
+            ale_act(ale, actions[(i / 4) % num_actions]);
+            if (ale_game_over(ale, true)) ale_reset_game(ale);
+            unsigned char* screen = screens + i * screen_size;
+            ale_getScreenBatch(&ale, 1, screen, screen_size, NULL);
+
+            const unsigned char* reference = delta && i > 0 ? screen - screen_size : NULL;
+            double start = now();
+            for (int r = 0; r < REPEATS; r++)
+                sizes[i] = ale_encodeScreenRLE(ale, reference, encoded + i * bound, bound);
+            encode_time += now() - start;
+            total += sizes[i];
+        }
+
+        // Decode the whole sequence in order, as a receiver would
+        double decode_time = 0;
+        int mismatches = 0;
+        for (int r = 0; r < REPEATS; r++) {
+            double start = now();
+            for (int i = 0; i < NUM_SCREENS; i++) {
+                bool use_delta = delta && i > 0;
+                if (ale_decodeScreenRLE(encoded + i * bound, sizes[i], decoded, screen_size, use_delta) < 0)
+                    mismatches++;
+            }
+            decode_time += now() - start;
+            if (memcmp(decoded, screens + (NUM_SCREENS - 1) * screen_size, screen_size) != 0)
+                mismatches++;
+        }
+
+        double bytes = (double)screen_size * NUM_SCREENS * REPEATS;
+        printf("%-24s %-10s %8.1fx %10.0f MB/s %10.0f MB/s%s\n", rom_path, names[delta],
+               (double)screen_size * NUM_SCREENS / total, bytes / encode_time / 1e6,
+               bytes / decode_time / 1e6, mismatches ? "  MISMATCH" : "");
+    }
+
+    free(actions);
+    free(decoded);
+    free(sizes);
+    free(encoded);
+    free(screens);
+    ale_destroy(ale);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <rom_file>...\n", argv[0]);
+        return 1;
+    }
+
+    printf("%-24s %-10s %9s %15s %15s\n", "rom", "encoding", "ratio", "encode", "decode");
+    for (int i = 1; i < argc; i++) {
+        if (bench(argv[i]) != 0)
+            fprintf(stderr, "Failed to load %s.\n", argv[i]);
+    }
+    return 0;
+}
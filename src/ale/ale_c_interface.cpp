@@ -1,5 +1,11 @@
 #include "ale_c_interface.h"
 #include "ale_interface.hpp" // Include the original C++ header
+#include "ale/common/SoundRaw.hxx" // For SoundRaw::SampleRate
+#include "ale/common/EpisodeVideo.hpp"
+#include "ale/common/TrajectoryDataset.hpp"
+#include "ale/emucore/Console.hxx"
+#include "ale/emucore/M6502.hxx"
+#include "ale/emucore/M6502Lockstep.hxx"
 
 #include <vector>
 #include <string>
@@ -8,6 +14,12 @@
 #include <cstring>   // For strncpy, memcpy
 #include <limits>   // For numeric_limits
 #include <new>      // For std::nothrow
+#include <thread>   // For std::thread
+#include <atomic>   // For std::atomic
+#include <mutex>    // For std::mutex
+#include <condition_variable> // For std::condition_variable
+#include <functional> // For std::function
+#include <algorithm> // For std::min
 
 // Helper macro for error handling
 #define ALE_TRY try {
@@ -26,6 +38,277 @@ struct ALEState_c : public ale::ALEState {
     ALEState_c(const ale::ALEState& other): ale::ALEState(other) {}
 };
 struct ScreenExporter_c : public ale::ScreenExporter {};
+struct EpisodeVideo_c : public ale::EpisodeVideoReader {
+    using ale::EpisodeVideoReader::EpisodeVideoReader;
+};
+struct TrajectoryDataset_c : public ale::TrajectoryDatasetReader {
+    using ale::TrajectoryDatasetReader::TrajectoryDatasetReader;
+};
+
+namespace {
+
+// Worker threads kept alive across batch calls, so that a batch step costs a
+// wake-up per thread rather than a thread creation. One batch runs at a time.
+class WorkerPool {
+public:
+    static WorkerPool& instance() {
+        static WorkerPool pool;
+        return pool;
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_work_ready.notify_all();
+        for (auto& thread : m_threads) thread.join();
+    }
+
+    // Runs task(t) for t in [0, num_tasks): task 0 on the calling thread, the
+    // others on the pool, which grows to num_tasks - 1 threads. task must not throw.
+    void run(int num_tasks, const std::function<void(int)>& task) {
+        std::lock_guard<std::mutex> batch(m_batch_mutex);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while ((int)m_threads.size() < num_tasks - 1)
+            m_threads.emplace_back(&WorkerPool::workerLoop, this);
+        m_task = &task;
+        m_num_tasks = num_tasks;
+        m_next_task = 1;
+        m_pending = num_tasks - 1;
+        lock.unlock();
+        m_work_ready.notify_all();
+
+        task(0);
+
+        lock.lock();
+        m_work_done.wait(lock, [this] { return m_pending == 0; });
+        m_task = nullptr;
+        m_num_tasks = 0;
+    }
+
+private:
+    WorkerPool() : m_task(nullptr), m_num_tasks(0), m_next_task(0), m_pending(0),
+                   m_stopping(false) {}
+
+    void workerLoop() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;) {
+            m_work_ready.wait(lock, [this] { return m_stopping || m_next_task < m_num_tasks; });
+            if (m_stopping) return;
+            int t = m_next_task++;
+            lock.unlock();
+            (*m_task)(t);
+            lock.lock();
+            if (--m_pending == 0) m_work_done.notify_all();
+        }
+    }
+
+    std::mutex m_batch_mutex; // Held for a whole batch
+    std::mutex m_mutex;       // Guards everything below
+    std::condition_variable m_work_ready;
+    std::condition_variable m_work_done;
+    std::vector<std::thread> m_threads;
+    const std::function<void(int)>* m_task;
+    int m_num_tasks;
+    int m_next_task; // Next task for a worker to take
+    int m_pending;   // Worker tasks not finished yet
+    bool m_stopping;
+};
+
+// Runs fn(i) for i in [0, n), split into contiguous chunks over num_threads threads
+// (the calling thread and num_threads - 1 pool workers).
+// Returns false if any call threw.
+template <typename Fn>
+bool parallelFor(int n, int num_threads, Fn fn) {
+    std::atomic<bool> ok(true);
+    auto run_chunk = [&](int begin, int end) {
+        try {
+            for (int i = begin; i < end; i++) fn(i);
+        } catch (const std::exception& e) {
+            std::cerr << "ALE C Interface Error: " << e.what() << std::endl;
+            ok = false;
+        } catch (...) {
+            std::cerr << "ALE C Interface Error: Unknown exception caught." << std::endl;
+            ok = false;
+        }
+    };
+
+    if (num_threads > n) num_threads = n;
+    if (num_threads <= 1) {
+        run_chunk(0, n);
+        return ok;
+    }
+
+    int chunk = (n + num_threads - 1) / num_threads;
+    int num_chunks = (n + chunk - 1) / chunk;
+    WorkerPool::instance().run(num_chunks, [&](int t) {
+        run_chunk(t * chunk, std::min(n, (t + 1) * chunk));
+    });
+    return ok;
+}
+
+} // namespace
+
+// Instances of one ROM whose processors run in lockstep (see
+// ale_lockstepActBatch). Each instance acts on a thread of its own; when its
+// TIA asks for the instructions of a frame the thread waits until every
+// instance still acting has asked too, and the last one to ask runs them all
+// on one M6502Lockstep while the others sleep.
+struct ALELockstepBatch_c : public ale::stella::ProcessorRunner {
+    struct Lane {
+        ale::stella::System* system;
+        ale::stella::Cartridge* cart;
+        bool lockstep; // Else its processor runs alone
+        bool waiting;
+        uint32_t number;
+    };
+
+    ALELockstepBatch_c(ALEInterface_c* const* ales, int n)
+        : m_ales(ales, ales + n), m_lanes(n), m_inside(0), m_waiting(0), m_generation(0) {
+        attach();
+        detach();
+    }
+
+    // Steps every instance once. Returns false if any act threw.
+    bool act(const Action* actions, const float* paddle_strengths, reward_t* rewards_out) {
+        int n = (int)m_ales.size();
+        attach();
+        m_inside = n;
+        m_waiting = 0;
+        std::atomic<bool> ok(true);
+        // Every instance needs a thread of its own, since they wait for each other
+        WorkerPool::instance().run(n, [&](int i) {
+            t_batch = this;
+            t_lane = i;
+            try {
+                float strength = paddle_strengths ? paddle_strengths[i] : 1.0f;
+                rewards_out[i] = m_ales[i]->act(static_cast<ale::Action>(actions[i]), strength);
+            } catch (const std::exception& e) {
+                std::cerr << "ALE C Interface Error: " << e.what() << std::endl;
+                ok = false;
+            } catch (...) {
+                std::cerr << "ALE C Interface Error: Unknown exception caught." << std::endl;
+                ok = false;
+            }
+            t_batch = nullptr;
+            finish();
+        });
+        detach();
+        return ok;
+    }
+
+    void execute(ale::stella::System& system, uint32_t number) override {
+        // Instructions asked for outside of act, or by another system
+        if (t_batch != this || &system != m_lanes[t_lane].system) {
+            system.m6502().execute(number);
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        Lane& lane = m_lanes[t_lane];
+        lane.waiting = true;
+        lane.number = number;
+        if (++m_waiting == m_inside) {
+            runWaiting();
+        } else {
+            uint64_t generation = m_generation;
+            m_released.wait(lock, [&] { return m_generation != generation; });
+        }
+    }
+
+    std::vector<ALEInterface_c*> m_ales;
+    std::vector<Lane> m_lanes;
+    ale::stella::M6502Lockstep m_core;
+    uint64_t m_runs = 0;   // Frames of instructions run for all waiting instances
+    uint64_t m_frames = 0; // Frames of instructions run for one instance
+
+private:
+    // Looks the systems of the instances up, which change when a ROM is
+    // loaded, and runs their processors through this batch
+    void attach() {
+        std::string md5;
+        for (size_t i = 0; i < m_ales.size(); i++) {
+            ale::stella::Console& console = m_ales[i]->theOSystem->console();
+            const std::string& lane_md5 = console.properties().get(ale::stella::Cartridge_MD5);
+            if (i == 0) md5 = lane_md5;
+            else if (lane_md5 != md5)
+                throw std::runtime_error("ale_lockstepActBatch: the instances run different ROMs");
+
+            Lane& lane = m_lanes[i];
+            lane.system = &console.system();
+            lane.cart = &console.cartridge();
+            lane.lockstep = ale::stella::M6502Lockstep::supports(*lane.system, *lane.cart);
+            lane.waiting = false;
+        }
+        for (Lane& lane : m_lanes) lane.system->setProcessorRunner(this);
+    }
+
+    void detach() {
+        for (Lane& lane : m_lanes) lane.system->setProcessorRunner(nullptr);
+    }
+
+    // Called with m_mutex unlocked when an instance has finished acting
+    void finish() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (--m_inside > 0 && m_waiting == m_inside) runWaiting();
+    }
+
+    // Runs the processors of the waiting instances, with m_mutex held, and
+    // wakes them up. Instances asking for the same number of instructions
+    // run in lockstep.
+    void runWaiting() {
+        std::vector<ale::stella::System*> systems;
+        std::vector<ale::stella::Cartridge*> carts;
+        try {
+            for (size_t i = 0; i < m_lanes.size(); i++) {
+                Lane& first = m_lanes[i];
+                if (!first.waiting) continue;
+                systems.clear();
+                carts.clear();
+                for (size_t j = i; j < m_lanes.size(); j++) {
+                    Lane& lane = m_lanes[j];
+                    if (!lane.waiting || lane.number != first.number) continue;
+                    lane.waiting = false;
+                    if (lane.lockstep) {
+                        systems.push_back(lane.system);
+                        carts.push_back(lane.cart);
+                    } else {
+                        lane.system->m6502().execute(lane.number);
+                    }
+                    m_frames++;
+                }
+                if (!systems.empty())
+                    m_core.execute(systems.data(), carts.data(), (uint32_t)systems.size(),
+                                   first.number);
+            }
+        } catch (...) {
+            release();
+            throw;
+        }
+        m_runs++;
+        release();
+    }
+
+    void release() {
+        for (Lane& lane : m_lanes) lane.waiting = false;
+        m_waiting = 0;
+        m_generation++;
+        m_released.notify_all();
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_released;
+    int m_inside;          // Instances still acting
+    int m_waiting;         // Instances waiting for their instructions
+    uint64_t m_generation; // Runs so far, which wakes the waiting instances up
+
+    static thread_local ALELockstepBatch_c* t_batch;
+    static thread_local int t_lane;
+};
+
+thread_local ALELockstepBatch_c* ALELockstepBatch_c::t_batch = nullptr;
+thread_local int ALELockstepBatch_c::t_lane = 0;
 
 
 extern "C" {
@@ -301,19 +584,26 @@ int ale_getEpisodeFrameNumber(ALEInterface_handle ale) {
     ALE_CATCH(-1)
 }
 
+int ale_getLastActFrames(ALEInterface_handle ale) {
+    if (!ale) return -1;
+    ALE_TRY
+        return static_cast<ALEInterface_c*>(ale)->getLastActFrames();
+    ALE_CATCH(-1)
+}
+
 // --- Screen Access ---
 
 int ale_getScreenWidth(ALEInterface_handle ale) {
      if (!ale) return -1;
     ALE_TRY
-        return static_cast<ALEInterface_c*>(ale)->getScreen().width();
+        return static_cast<ALEInterface_c*>(ale)->getScreenWidth();
     ALE_CATCH(-1)
 }
 
 int ale_getScreenHeight(ALEInterface_handle ale) {
      if (!ale) return -1;
     ALE_TRY
-        return static_cast<ALEInterface_c*>(ale)->getScreen().height();
+        return static_cast<ALEInterface_c*>(ale)->getScreenHeight();
     ALE_CATCH(-1)
 }
 
@@ -362,6 +652,202 @@ int ale_getScreenRGB(ALEInterface_handle ale, unsigned char* output_buffer, size
     ALE_CATCH(-1)
 }
 
+int ale_getScreenHash(ALEInterface_handle ale, uint64_t* hash_out) {
+    if (!ale || !hash_out) return -1;
+    ALE_TRY
+        *hash_out = static_cast<ALEInterface_c*>(ale)->getScreenHash();
+        return 0;
+    ALE_CATCH(-1)
+}
+
+namespace {
+
+// Bytes of one observation of the given screen in an ALE_OBS_* format, or 0
+// for an unknown format
+size_t observationSize(const ale::ALEScreen& screen, int format) {
+    if (format < ALE_OBS_PALETTE_INDEX || format > ALE_OBS_RGBA) return 0;
+    return screen.arraySize() *
+           ale::ColourPalette::bytesPerPixel(static_cast<ale::ObservationFormat>(format));
+}
+
+// Bytes of one observation written into an observation buffer, which may be
+// resized by the instance's preprocessing, or 0 for an unknown format
+size_t observationBufferSize(const ALEInterface_c* ale_ptr, int format) {
+    if (format < ALE_OBS_PALETTE_INDEX || format > ALE_OBS_RGBA) return 0;
+    return static_cast<size_t>(ale_ptr->getObservationWidth()) * ale_ptr->getObservationHeight() *
+           ale::ColourPalette::bytesPerPixel(static_cast<ale::ObservationFormat>(format));
+}
+
+} // namespace
+
+int ale_getObservation(ALEInterface_handle ale, unsigned char* output_buffer, size_t buffer_size, int format) {
+    if (!ale || !output_buffer) return -1;
+    ALE_TRY
+        ALEInterface_c* ale_ptr = static_cast<ALEInterface_c*>(ale);
+        size_t required_size = observationSize(ale_ptr->getScreen(), format);
+        if (required_size == 0) return -1; // Unknown format
+        if (buffer_size < required_size) return -1; // Buffer too small
+
+        ale_ptr->getObservation(output_buffer, static_cast<ale::ObservationFormat>(format));
+        return static_cast<int>(required_size);
+    ALE_CATCH(-1)
+}
+
+int ale_convertScreens(ALEInterface_handle ale, const unsigned char* src, int n,
+                       unsigned char* output_buffer, size_t buffer_size, int format) {
+    if (!ale || !src || n < 0 || !output_buffer) return -1;
+    ALE_TRY
+        ALEInterface_c* ale_ptr = static_cast<ALEInterface_c*>(ale);
+        const ale::ALEScreen& screen = ale_ptr->getScreen();
+        size_t frame_bytes = observationSize(screen, format);
+        if (frame_bytes == 0) return -1; // Unknown format
+        size_t required_size = frame_bytes * n;
+        if (buffer_size < required_size) return -1; // Buffer too small
+
+        ale_ptr->theOSystem->colourPalette().applyPalette(
+            output_buffer, src, screen.arraySize(),
+            static_cast<ale::ObservationFormat>(format), n);
+        return static_cast<int>(required_size);
+    ALE_CATCH(-1)
+}
+
+int ale_getObservationWidth(ALEInterface_handle ale) {
+    if (!ale) return -1;
+    ALE_TRY
+        return static_cast<ALEInterface_c*>(ale)->getObservationWidth();
+    ALE_CATCH(-1)
+}
+
+int ale_getObservationHeight(ALEInterface_handle ale) {
+    if (!ale) return -1;
+    ALE_TRY
+        return static_cast<ALEInterface_c*>(ale)->getObservationHeight();
+    ALE_CATCH(-1)
+}
+
+int ale_setObservationBuffer(ALEInterface_handle ale, unsigned char* buffer, size_t buffer_size, int format) {
+    if (!ale) return -1;
+    ALE_TRY
+        ALEInterface_c* ale_ptr = static_cast<ALEInterface_c*>(ale);
+        size_t required_size = observationBufferSize(ale_ptr, format);
+        if (required_size == 0) return -1; // Unknown format
+        if (buffer && buffer_size < required_size) return -1; // Buffer too small
+
+        ale_ptr->setObservationBuffer(buffer, static_cast<ale::ObservationFormat>(format));
+        return static_cast<int>(required_size);
+    ALE_CATCH(-1)
+}
+
+// --- Frame Stack ---
+
+int ale_getFrameStackDepth(ALEInterface_handle ale) {
+    if (!ale) return -1;
+    ALE_TRY
+        const ale::FrameStack* stack = static_cast<ALEInterface_c*>(ale)->getFrameStack();
+        return stack ? stack->depth() : 0;
+    ALE_CATCH(-1)
+}
+
+int ale_getFrameStack(ALEInterface_handle ale, const unsigned char** frames) {
+    if (!ale) return -1;
+    ALE_TRY
+        const ale::FrameStack* stack = static_cast<ALEInterface_c*>(ale)->getFrameStack();
+        if (!stack) return -1;
+        if (frames) *frames = stack->data();
+        return stack->head();
+    ALE_CATCH(-1)
+}
+
+int ale_copyFrameStack(ALEInterface_handle ale, unsigned char* output_buffer, size_t buffer_size) {
+    if (!ale || !output_buffer) return -1;
+    ALE_TRY
+        const ale::FrameStack* stack = static_cast<ALEInterface_c*>(ale)->getFrameStack();
+        if (!stack) return -1;
+        if (buffer_size < stack->size()) return -1; // Buffer too small
+        stack->copyOrdered(output_buffer);
+        return static_cast<int>(stack->size());
+    ALE_CATCH(-1)
+}
+
+int ale_setFrameStackBuffer(ALEInterface_handle ale, unsigned char* buffer, size_t buffer_size) {
+    if (!ale) return -1;
+    ALE_TRY
+        ALEInterface_c* ale_ptr = static_cast<ALEInterface_c*>(ale);
+        const ale::FrameStack* stack = ale_ptr->getFrameStack();
+        if (!stack) return -1;
+        if (buffer && buffer_size < stack->size()) return -1; // Buffer too small
+        ale_ptr->setFrameStackBuffer(buffer);
+        return static_cast<int>(stack->size());
+    ALE_CATCH(-1)
+}
+
+// --- Screen Deltas ---
+
+int ale_getScreenDirtyRows(ALEInterface_handle ale, unsigned char* output_buffer, size_t buffer_size) {
+    if (!ale || !output_buffer) return -1;
+    ALE_TRY
+        ALEInterface_c* ale_ptr = static_cast<ALEInterface_c*>(ale);
+        size_t required_size = (ale_ptr->getScreen().height() + 7) / 8;
+        if (buffer_size < required_size) return -1; // Buffer too small
+        ale_ptr->getScreenDirtyRows(output_buffer);
+        return static_cast<int>(required_size);
+    ALE_CATCH(-1)
+}
+
+int ale_getScreenDelta(ALEInterface_handle ale, unsigned char* output_buffer, size_t buffer_size) {
+    if (!ale) return -1;
+    ALE_TRY
+        ALEInterface_c* ale_ptr = static_cast<ALEInterface_c*>(ale);
+        const ale::ALEScreen& screen = ale_ptr->getScreen();
+        size_t bound = ale::screenDeltaBound(screen.width(), screen.height());
+        if (!output_buffer) return static_cast<int>(bound);
+        if (buffer_size < bound) return -1; // Buffer too small
+        return static_cast<int>(ale_ptr->getScreenDelta(output_buffer));
+    ALE_CATCH(-1)
+}
+
+int ale_resetScreenDelta(ALEInterface_handle ale) {
+    if (!ale) return -1;
+    ALE_TRY
+        static_cast<ALEInterface_c*>(ale)->resetScreenDelta();
+        return 0;
+    ALE_CATCH(-1)
+}
+
+int ale_applyScreenDelta(const unsigned char* delta, size_t delta_size, int width, int height,
+                         unsigned char* screen) {
+    if (!delta || !screen || width <= 0 || height <= 0) return -1;
+    ALE_TRY
+        size_t read = ale::decodeScreenDelta(delta, delta_size, width, height, screen);
+        if (read == 0) return -1; // Truncated
+        return static_cast<int>(read);
+    ALE_CATCH(-1)
+}
+
+// --- Run-Length Encoding ---
+
+int ale_encodeScreenRLE(ALEInterface_handle ale, const unsigned char* reference,
+                        unsigned char* output_buffer, size_t buffer_size) {
+    if (!ale) return -1;
+    ALE_TRY
+        ALEInterface_c* ale_ptr = static_cast<ALEInterface_c*>(ale);
+        size_t bound = ale::screenRLEBound(ale_ptr->getScreen().arraySize());
+        if (!output_buffer) return static_cast<int>(bound);
+        if (buffer_size < bound) return -1; // Buffer too small
+        return static_cast<int>(ale_ptr->encodeScreenRLE(output_buffer, reference));
+    ALE_CATCH(-1)
+}
+
+int ale_decodeScreenRLE(const unsigned char* src, size_t src_size, unsigned char* screen,
+                        size_t screen_size, bool delta) {
+    if (!src || !screen) return -1;
+    ALE_TRY
+        size_t read = ale::decodeScreenRLE(src, src_size, screen, screen_size, delta);
+        if (read == 0 && screen_size != 0) return -1; // Malformed
+        return static_cast<int>(read);
+    ALE_CATCH(-1)
+}
+
 // --- Audio Access ---
 
 int ale_getAudio(ALEInterface_handle ale, uint8_t* output_buffer, size_t buffer_size) {
@@ -376,6 +862,30 @@ int ale_getAudio(ALEInterface_handle ale, uint8_t* output_buffer, size_t buffer_
     ALE_CATCH(-1)
 }
 
+static_assert(ALE_AUDIO_SAMPLE_RATE == ale::SoundRaw::SampleRate,
+              "ALE_AUDIO_SAMPLE_RATE is the rate of the raw samples");
+
+int ale_getAudioLength(ALEInterface_handle ale, int sample_rate) {
+    if (!ale || sample_rate < 0) return -1;
+    ALE_TRY
+        size_t size = static_cast<ALEInterface_c*>(ale)->getAudio().size();
+        return static_cast<int>(ale::resampledLength(
+            size, ALE_AUDIO_SAMPLE_RATE, sample_rate > 0 ? sample_rate : ALE_AUDIO_SAMPLE_RATE));
+    ALE_CATCH(-1)
+}
+
+int ale_getAudioResampled(ALEInterface_handle ale, void* output_buffer, size_t buffer_size,
+                          size_t samples, int sample_rate, int format) {
+    if (!ale || !output_buffer || sample_rate < 0) return -1;
+    if (format < ALE_AUDIO_UINT8 || format > ALE_AUDIO_FLOAT32) return -1;
+    ALE_TRY
+        ale::AudioFormat audio_format = static_cast<ale::AudioFormat>(format);
+        if (buffer_size / ale::audioBytesPerSample(audio_format) < samples) return -1; // Buffer too small
+        return static_cast<int>(static_cast<ALEInterface_c*>(ale)->getAudio(
+            output_buffer, samples, sample_rate, audio_format));
+    ALE_CATCH(-1)
+}
+
 
 // --- RAM Access ---
 
@@ -409,6 +919,233 @@ int ale_setRAM(ALEInterface_handle ale, size_t memory_index, byte_t value) {
     ALE_CATCH(-1)
 }
 
+// --- Batched Stepping ---
+
+int ale_actBatch(ALEInterface_handle* ales, int n, const Action* actions,
+                 const float* paddle_strengths, reward_t* rewards_out, int num_threads) {
+    if (!ales || n < 0 || !actions || !rewards_out) return -1;
+    for (int i = 0; i < n; i++) {
+        if (!ales[i]) return -1;
+    }
+    ALE_TRY
+        bool ok = parallelFor(n, num_threads, [&](int i) {
+            float strength = paddle_strengths ? paddle_strengths[i] : 1.0f;
+            rewards_out[i] = static_cast<ALEInterface_c*>(ales[i])->act(
+                static_cast<ale::Action>(actions[i]), strength);
+        });
+        return ok ? n : -1;
+    ALE_CATCH(-1)
+}
+
+ALELockstepBatch_handle ale_createLockstepBatch(ALEInterface_handle* ales, int n) {
+    if (!ales || n <= 0) return nullptr;
+    for (int i = 0; i < n; i++) {
+        if (!ales[i]) return nullptr;
+    }
+    ALE_TRY
+        return new ALELockstepBatch_c(ales, n);
+    ALE_CATCH(nullptr)
+}
+
+void ale_destroyLockstepBatch(ALELockstepBatch_handle batch) {
+    delete batch;
+}
+
+int ale_lockstepActBatch(ALELockstepBatch_handle batch, const Action* actions,
+                         const float* paddle_strengths, reward_t* rewards_out) {
+    if (!batch || !actions || !rewards_out) return -1;
+    ALE_TRY
+        bool ok = batch->act(actions, paddle_strengths, rewards_out);
+        return ok ? (int)batch->m_ales.size() : -1;
+    ALE_CATCH(-1)
+}
+
+int ale_lockstepBatchStats(ALELockstepBatch_handle batch, uint64_t* stats_out) {
+    if (!batch || !stats_out) return -1;
+    const ale::stella::M6502Lockstep::Statistics& stats = batch->m_core.statistics();
+    stats_out[0] = batch->m_runs;
+    stats_out[1] = batch->m_frames;
+    stats_out[2] = stats.groupInstructions;
+    stats_out[3] = stats.laneInstructions;
+    stats_out[4] = stats.scalarInstructions;
+    return 0;
+}
+
+int ale_getScreenBatch(ALEInterface_handle* ales, int n, unsigned char* output_buffer, size_t buffer_size,
+                       size_t* bytes_out) {
+    if (!ales || n < 0 || !output_buffer) return -1;
+    ALE_TRY
+        size_t offset = 0;
+        for (int i = 0; i < n; i++) {
+            if (!ales[i]) return -1;
+            const ale::ALEScreen& screen = static_cast<ALEInterface_c*>(ales[i])->getScreen();
+            size_t size = screen.arraySize();
+            if (buffer_size - offset < size) return -1; // Buffer too small
+            std::memcpy(output_buffer + offset, screen.getArray(), size);
+            offset += size;
+        }
+        if (bytes_out) *bytes_out = offset;
+        return 0;
+    ALE_CATCH(-1)
+}
+
+int ale_getObservationBatch(ALEInterface_handle* ales, int n, unsigned char* output_buffer,
+                            size_t buffer_size, int format, size_t* bytes_out) {
+    if (!ales || n < 0 || !output_buffer) return -1;
+    ALE_TRY
+        size_t offset = 0;
+        for (int i = 0; i < n; i++) {
+            if (!ales[i]) return -1;
+            ALEInterface_c* ale_ptr = static_cast<ALEInterface_c*>(ales[i]);
+            size_t size = observationSize(ale_ptr->getScreen(), format);
+            if (size == 0) return -1; // Unknown format
+            if (buffer_size - offset < size) return -1; // Buffer too small
+            ale_ptr->getObservation(output_buffer + offset, static_cast<ale::ObservationFormat>(format));
+            offset += size;
+        }
+        if (bytes_out) *bytes_out = offset;
+        return 0;
+    ALE_CATCH(-1)
+}
+
+int ale_getAudioBatch(ALEInterface_handle* ales, int n, void* output_buffer, size_t buffer_size,
+                      size_t samples, int sample_rate, int format, int* lengths_out,
+                      size_t* bytes_out) {
+    if (!ales || n < 0 || !output_buffer || sample_rate < 0) return -1;
+    if (format < ALE_AUDIO_UINT8 || format > ALE_AUDIO_FLOAT32) return -1;
+    ALE_TRY
+        ale::AudioFormat audio_format = static_cast<ale::AudioFormat>(format);
+        size_t size = samples * ale::audioBytesPerSample(audio_format);
+        if (buffer_size / (n > 0 ? n : 1) < size) return -1; // Buffer too small
+        unsigned char* output = static_cast<unsigned char*>(output_buffer);
+        for (int i = 0; i < n; i++) {
+            if (!ales[i]) return -1;
+            size_t length = static_cast<ALEInterface_c*>(ales[i])->getAudio(
+                output + i * size, samples, sample_rate, audio_format);
+            if (lengths_out) lengths_out[i] = static_cast<int>(length);
+        }
+        if (bytes_out) *bytes_out = n * size;
+        return 0;
+    ALE_CATCH(-1)
+}
+
+int ale_getScreenHashBatch(ALEInterface_handle* ales, int n, uint64_t* hashes_out) {
+    if (!ales || n < 0 || !hashes_out) return -1;
+    ALE_TRY
+        for (int i = 0; i < n; i++) {
+            if (!ales[i]) return -1;
+            hashes_out[i] = static_cast<ALEInterface_c*>(ales[i])->getScreenHash();
+        }
+        return n;
+    ALE_CATCH(-1)
+}
+
+int ale_setObservationBufferBatch(ALEInterface_handle* ales, int n, unsigned char* buffer,
+                                  size_t buffer_size, int format, size_t* bytes_out) {
+    if (!ales || n < 0) return -1;
+    ALE_TRY
+        // Check every slot first so a failure leaves no instance half registered
+        size_t offset = 0;
+        for (int i = 0; i < n; i++) {
+            if (!ales[i]) return -1;
+            size_t size = observationBufferSize(static_cast<ALEInterface_c*>(ales[i]), format);
+            if (size == 0) return -1; // Unknown format
+            if (buffer && buffer_size - offset < size) return -1; // Buffer too small
+            offset += size;
+        }
+
+        offset = 0;
+        for (int i = 0; i < n; i++) {
+            ALEInterface_c* ale_ptr = static_cast<ALEInterface_c*>(ales[i]);
+            ale_ptr->setObservationBuffer(buffer ? buffer + offset : NULL,
+                                          static_cast<ale::ObservationFormat>(format));
+            offset += observationBufferSize(ale_ptr, format);
+        }
+        if (bytes_out) *bytes_out = offset;
+        return 0;
+    ALE_CATCH(-1)
+}
+
+int ale_setFrameStackBufferBatch(ALEInterface_handle* ales, int n, unsigned char* buffer,
+                                 size_t buffer_size, size_t* bytes_out) {
+    if (!ales || n < 0) return -1;
+    ALE_TRY
+        // Check every slot first so a failure leaves no instance half registered
+        size_t offset = 0;
+        for (int i = 0; i < n; i++) {
+            if (!ales[i]) return -1;
+            const ale::FrameStack* stack = static_cast<ALEInterface_c*>(ales[i])->getFrameStack();
+            if (!stack) return -1;
+            if (buffer && buffer_size - offset < stack->size()) return -1; // Buffer too small
+            offset += stack->size();
+        }
+
+        offset = 0;
+        for (int i = 0; i < n; i++) {
+            ALEInterface_c* ale_ptr = static_cast<ALEInterface_c*>(ales[i]);
+            ale_ptr->setFrameStackBuffer(buffer ? buffer + offset : NULL);
+            offset += ale_ptr->getFrameStack()->size();
+        }
+        if (bytes_out) *bytes_out = offset;
+        return 0;
+    ALE_CATCH(-1)
+}
+
+int ale_getFrameStackHeadBatch(ALEInterface_handle* ales, int n, int* heads_out) {
+    if (!ales || n < 0 || !heads_out) return -1;
+    ALE_TRY
+        for (int i = 0; i < n; i++) {
+            if (!ales[i]) return -1;
+            const ale::FrameStack* stack = static_cast<ALEInterface_c*>(ales[i])->getFrameStack();
+            if (!stack) return -1;
+            heads_out[i] = stack->head();
+        }
+        return n;
+    ALE_CATCH(-1)
+}
+
+int ale_getRAMBatch(ALEInterface_handle* ales, int n, unsigned char* output_buffer, size_t buffer_size,
+                    size_t* bytes_out) {
+    if (!ales || n < 0 || !output_buffer) return -1;
+    ALE_TRY
+        size_t offset = 0;
+        for (int i = 0; i < n; i++) {
+            if (!ales[i]) return -1;
+            const ale::ALERAM& ram = static_cast<ALEInterface_c*>(ales[i])->getRAM();
+            if (buffer_size - offset < ram.size()) return -1; // Buffer too small
+            std::memcpy(output_buffer + offset, ram.array(), ram.size());
+            offset += ram.size();
+        }
+        if (bytes_out) *bytes_out = offset;
+        return 0;
+    ALE_CATCH(-1)
+}
+
+// --- Memory Usage ---
+int ale_getMemoryUsage(ALEInterface_handle ale, size_t* total_out) {
+    if (!ale || !total_out) return -1;
+    ALE_TRY
+        *total_out = static_cast<ALEInterface_c*>(ale)->getMemoryUsage().total();
+        return 0;
+    ALE_CATCH(-1)
+}
+
+int ale_getMemoryUsageComponents(ALEInterface_handle ale, const char** names, size_t* bytes,
+                                 int* shared, int capacity) {
+    if (!ale || capacity < 0) return -1;
+    ALE_TRY
+        ale::MemoryUsage usage = static_cast<ALEInterface_c*>(ale)->getMemoryUsage();
+        const std::vector<ale::MemoryUsage::Component>& components = usage.components();
+        int count = static_cast<int>(components.size());
+        for (int i = 0; i < count && i < capacity; i++) {
+            if (names) names[i] = components[i].name;
+            if (bytes) bytes[i] = components[i].bytes;
+            if (shared) shared[i] = components[i].shared ? 1 : 0;
+        }
+        return count;
+    ALE_CATCH(-1)
+}
+
 // --- State Cloning and Restoration ---
 ALEState_handle ale_cloneState(ALEInterface_handle ale, bool include_rng) {
     if (!ale) return nullptr;
@@ -482,6 +1219,115 @@ void ale_destroyScreenExporter(ScreenExporter_handle exporter) {
     }
 }
 
+// --- Episode Videos ---
+
+EpisodeVideo_handle ale_openEpisodeVideo(const char* filename) {
+    if (!filename) return nullptr;
+    ALE_TRY
+        return new EpisodeVideo_c(filename);
+    ALE_CATCH(nullptr)
+}
+
+void ale_closeEpisodeVideo(EpisodeVideo_handle video) {
+    delete video;
+}
+
+int ale_episodeVideoInfo(EpisodeVideo_handle video, int* width, int* height) {
+    if (!video) return -1;
+    if (width) *width = video->width();
+    if (height) *height = video->height();
+    return static_cast<int>(video->numFrames());
+}
+
+int ale_episodeVideoReadFrames(EpisodeVideo_handle video, size_t first, size_t count,
+                               unsigned char* output_buffer, size_t buffer_size) {
+    if (!video || (!output_buffer && count > 0)) return -1;
+    if (count > buffer_size / ((size_t)video->width() * video->height())) return -1;
+    ALE_TRY
+        video->readFrames(first, count, output_buffer);
+        return 0;
+    ALE_CATCH(-1)
+}
+
+int ale_episodeVideoMetadata(EpisodeVideo_handle video, size_t first, size_t count,
+                             int* rewards, int* actions) {
+    if (!video) return -1;
+    if (first > video->numFrames() || count > video->numFrames() - first) return -1;
+    for (size_t i = 0; i < count; i++) {
+        if (rewards) rewards[i] = video->reward(first + i);
+        if (actions) actions[i] = video->action(first + i);
+    }
+    return 0;
+}
+
+int ale_episodeVideoPalette(EpisodeVideo_handle video, unsigned char* output_buffer,
+                            size_t buffer_size) {
+    if (!video || !output_buffer || buffer_size < 256 * 3) return -1;
+    std::memcpy(output_buffer, video->palette(), 256 * 3);
+    return 0;
+}
+
+int ale_episodeVideoSavePNG(EpisodeVideo_handle video, size_t frame,
+                            const char* filename) {
+    if (!video || !filename) return -1;
+    ALE_TRY
+        video->savePNG(frame, filename);
+        return 0;
+    ALE_CATCH(-1)
+}
+
+// --- Trajectory Datasets ---
+
+TrajectoryDataset_handle ale_openTrajectoryDataset(const char* filename) {
+    if (!filename) return nullptr;
+    ALE_TRY
+        return new TrajectoryDataset_c(filename);
+    ALE_CATCH(nullptr)
+}
+
+void ale_closeTrajectoryDataset(TrajectoryDataset_handle dataset) {
+    delete dataset;
+}
+
+int ale_trajectoryDatasetInfo(TrajectoryDataset_handle dataset, int* num_blocks,
+                              int* block_records, int* width, int* height,
+                              int* frames) {
+    if (!dataset) return -1;
+    if (num_blocks) *num_blocks = static_cast<int>(dataset->numBlocks());
+    if (block_records) *block_records = static_cast<int>(dataset->blockRecords());
+    if (width) *width = dataset->width();
+    if (height) *height = dataset->height();
+    if (frames) *frames = dataset->frames();
+    return static_cast<int>(dataset->numRecords());
+}
+
+const void* ale_trajectoryDatasetColumn(TrajectoryDataset_handle dataset, int block,
+                                        int column, int* records) {
+    if (!dataset || block < 0 || (size_t)block >= dataset->numBlocks()) return nullptr;
+    if (records) *records = dataset->block(block).records;
+    switch (column) {
+        case ALE_DATASET_ACTION: return dataset->actions(block);
+        case ALE_DATASET_REWARD: return dataset->rewards(block);
+        case ALE_DATASET_TERMINAL: return dataset->terminals(block);
+        case ALE_DATASET_LIVES: return dataset->lives(block);
+        case ALE_DATASET_RAM: return dataset->ram(block);
+        case ALE_DATASET_FRAMES: return dataset->rawFrames(block);
+        default: return nullptr;
+    }
+}
+
+int ale_trajectoryDatasetReadFrames(TrajectoryDataset_handle dataset, int block,
+                                    unsigned char* output_buffer, size_t buffer_size) {
+    if (!dataset || !output_buffer || block < 0 || (size_t)block >= dataset->numBlocks())
+        return -1;
+    if (buffer_size < (size_t)dataset->block(block).records * dataset->width() * dataset->height())
+        return -1;
+    ALE_TRY
+        dataset->readFrames(block, output_buffer);
+        return 0;
+    ALE_CATCH(-1)
+}
+
 // --- Static Utility Functions ---
 
 int ale_isSupportedROM(const char* rom_file_path, char* output_md5_buffer, size_t buffer_size) {
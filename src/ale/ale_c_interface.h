@@ -19,6 +19,12 @@ typedef ALEState_c* ALEState_handle;
 
 typedef struct ScreenExporter_c ScreenExporter_c;
 typedef ScreenExporter_c* ScreenExporter_handle;
+typedef struct EpisodeVideo_c EpisodeVideo_c;
+typedef EpisodeVideo_c* EpisodeVideo_handle;
+typedef struct TrajectoryDataset_c TrajectoryDataset_c;
+typedef TrajectoryDataset_c* TrajectoryDataset_handle;
+typedef struct ALELockstepBatch_c ALELockstepBatch_c;
+typedef ALELockstepBatch_c* ALELockstepBatch_handle;
 
 // --- Basic Type Definitions (Assumptions - Verify with ALE's actual types) ---
 typedef int Action;         // Assuming Action is an integer type
@@ -91,8 +97,14 @@ int ale_getMinimalActionSet(ALEInterface_handle ale, Action* action_buffer, size
 int ale_getFrameNumber(ALEInterface_handle ale);
 int ale_lives(ALEInterface_handle ale);
 int ale_getEpisodeFrameNumber(ALEInterface_handle ale);
+// Returns the number of frames the last ale_act emulated, or -1 on error.
+int ale_getLastActFrames(ALEInterface_handle ale);
 
 // --- Screen Access ---
+// With observation_mode ram or none the screen is not kept up to date, and the
+// functions that read it (the screen, observation, frame stack, delta, RLE,
+// hash and PNG functions, and their batch versions) fail with -1. The
+// dimensions are available in every mode.
 // Returns screen width, or -1 on error.
 int ale_getScreenWidth(ALEInterface_handle ale);
 // Returns screen height, or -1 on error.
@@ -102,12 +114,121 @@ int ale_getScreenHeight(ALEInterface_handle ale);
 int ale_getScreenGrayscale(ALEInterface_handle ale, unsigned char* output_buffer, size_t buffer_size);
 // Returns the number of bytes written (width * height * 3), or -1 on error or insufficient buffer.
 int ale_getScreenRGB(ALEInterface_handle ale, unsigned char* output_buffer, size_t buffer_size);
+// Writes the 64-bit hash of the palette-indexed screen into hash_out. Rows are
+// hashed as the emulator draws them, so this costs next to nothing.
+// Returns 0 on success, -1 on error.
+int ale_getScreenHash(ALEInterface_handle ale, uint64_t* hash_out);
+
+// Pixel formats for observations
+#define ALE_OBS_PALETTE_INDEX 0 // width * height bytes, as ale_getScreenBatch
+#define ALE_OBS_GRAYSCALE     1 // width * height bytes
+#define ALE_OBS_RGB           2 // width * height * 3 bytes, interleaved R, G, B (HWC)
+#define ALE_OBS_RGB_PLANAR    3 // width * height * 3 bytes, an R, a G and a B plane (CHW)
+#define ALE_OBS_RGBA          4 // width * height * 4 bytes, R, G, B and alpha 255
+
+// Writes the current screen in the given format (vectorised palette conversion).
+// Returns the number of bytes written, or -1 on error or insufficient buffer.
+int ale_getObservation(ALEInterface_handle ale, unsigned char* output_buffer, size_t buffer_size, int format);
+// Converts n palette-indexed screens stored back to back in src (e.g. from
+// ale_getScreenBatch) with the palette of ale, writing n observations back to back.
+// Returns the number of bytes written, or -1 on error or insufficient buffer.
+int ale_convertScreens(ALEInterface_handle ale, const unsigned char* src, int n,
+                       unsigned char* output_buffer, size_t buffer_size, int format);
+
+// Dimensions of the observations written into observation buffers. They are the
+// screen's unless the observation_width/observation_height settings resize them.
+// Returns -1 on error.
+int ale_getObservationWidth(ALEInterface_handle ale);
+int ale_getObservationHeight(ALEInterface_handle ale);
+// Registers caller memory that receives the observed screen, in the given format,
+// at the end of every ale_act and ale_reset_game; nothing is copied through
+// intermediate buffers. The observation_max_pool, observation_width/height and
+// observation_interpolation settings preprocess what is written (palette indices
+// can only be resized with nearest interpolation and cannot be max-pooled).
+// The memory must stay valid until it is replaced, or unregistered by passing NULL.
+// Returns the number of bytes of one observation, or -1 on error or insufficient buffer.
+int ale_setObservationBuffer(ALEInterface_handle ale, unsigned char* buffer, size_t buffer_size, int format);
+
+// --- Frame Stack ---
+// With the frame_stack setting K > 0, each instance keeps its last K observations
+// (in the frame_stack_format format, preprocessed like the observation buffer) in
+// the K slots of a ring buffer. ale_act and ale_reset_game write only the slot
+// after the head, which becomes the new head; ale_reset_game then copies it into
+// every other slot, so no observation of the previous episode remains.
+// Returns K, 0 without a frame stack, or -1 on error.
+int ale_getFrameStackDepth(ALEInterface_handle ale);
+// Returns the head, the slot of the newest observation (slot (head - k) mod K is
+// k steps older), or -1 on error or without a frame stack. If frames is not NULL,
+// *frames is pointed at the K slots, stored back to back; nothing is copied.
+int ale_getFrameStack(ALEInterface_handle ale, const unsigned char** frames);
+// Writes the K observations oldest first.
+// Returns the number of bytes written, or -1 on error or insufficient buffer.
+int ale_copyFrameStack(ALEInterface_handle ale, unsigned char* output_buffer, size_t buffer_size);
+// Keeps the K slots in caller memory from now on (the current slots are copied
+// there), or in the instance's own memory again if buffer is NULL.
+// Returns the number of bytes of the K slots, or -1 on error or insufficient buffer.
+int ale_setFrameStackBuffer(ALEInterface_handle ale, unsigned char* buffer, size_t buffer_size);
+
+// --- Screen Deltas ---
+// Writes a bitmap of the screen rows that changed since the previous frame:
+// (height + 7) / 8 bytes, bit row % 8 of byte row / 8 set for a changed row
+// (every row with color_averaging). The emulator tracks them while drawing.
+// Returns the number of bytes written, or -1 on error or insufficient buffer.
+int ale_getScreenDirtyRows(ALEInterface_handle ale, unsigned char* output_buffer, size_t buffer_size);
+// Writes the palette-indexed screen delta-encoded against the screen of the previous
+// call: the changed-row bitmap above, then the width bytes of each changed row, top to
+// bottom. The first call, and the first after ale_resetScreenDelta, lists every row.
+// The buffer must hold the largest possible delta, which a NULL output_buffer returns.
+// Returns the number of bytes written, or -1 on error or insufficient buffer.
+int ale_getScreenDelta(ALEInterface_handle ale, unsigned char* output_buffer, size_t buffer_size);
+// Makes the next ale_getScreenDelta list every row (e.g. for a new receiver).
+// Returns 0 on success, -1 on error.
+int ale_resetScreenDelta(ALEInterface_handle ale);
+// Applies a delta from ale_getScreenDelta to the width * height screen it was computed against.
+// Returns the number of delta bytes read, or -1 on error or if the delta is truncated.
+int ale_applyScreenDelta(const unsigned char* delta, size_t delta_size, int width, int height,
+                         unsigned char* screen);
+
+// --- Run-Length Encoding ---
+// Run-length encodes the palette-indexed screen (tokens of a control byte c and
+// then c + 1 literal bytes if c < 128, or one byte repeated c - 125 times). If
+// reference is not NULL (a width * height screen, e.g. the last one sent), the
+// screen XOR reference is encoded instead, which is mostly long zero runs.
+// A NULL output_buffer returns the largest possible size, which the buffer must hold.
+// Returns the number of bytes written, or -1 on error or insufficient buffer.
+int ale_encodeScreenRLE(ALEInterface_handle ale, const unsigned char* reference,
+                        unsigned char* output_buffer, size_t buffer_size);
+// Decodes src into the screen_size bytes of screen. With delta, screen must hold the
+// reference the screen was encoded against, which is updated in place.
+// Returns the number of bytes read, or -1 if src is malformed or of the wrong size.
+int ale_decodeScreenRLE(const unsigned char* src, size_t src_size, unsigned char* screen,
+                        size_t screen_size, bool delta);
 
 // --- Audio Access ---
+// With the sound_obs setting the audio holds the samples of the last frame, or
+// with sound_obs_window as well those of every frame of the last ale_act
+// (frame_skip * 512 unsigned 8-bit samples at ALE_AUDIO_SAMPLE_RATE).
 // Returns the number of audio bytes, or -1 on error.
 // Fills the buffer with audio data if not NULL and buffer_size is sufficient.
 int ale_getAudio(ALEInterface_handle ale, uint8_t* output_buffer, size_t buffer_size);
 
+// Rate of the samples of ale_getAudio (512 per frame at 60 frames per second)
+#define ALE_AUDIO_SAMPLE_RATE 30720
+
+// Sample formats for resampled mono audio
+#define ALE_AUDIO_UINT8   0 // 1 byte per sample, silence at 128 (as ale_getAudio)
+#define ALE_AUDIO_INT16   1 // 2 bytes per sample, signed, silence at 0
+#define ALE_AUDIO_FLOAT32 2 // 4 bytes per sample, in [-1, 1), silence at 0
+
+// Returns the number of samples the audio makes at sample_rate (0 keeps
+// ALE_AUDIO_SAMPLE_RATE), or -1 on error.
+int ale_getAudioLength(ALEInterface_handle ale, int sample_rate);
+// Writes exactly `samples` samples of the audio, resampled to sample_rate (0 keeps
+// ALE_AUDIO_SAMPLE_RATE) in the given format, padded with silence.
+// Returns the number of samples before the padding, or -1 on error or insufficient buffer.
+int ale_getAudioResampled(ALEInterface_handle ale, void* output_buffer, size_t buffer_size,
+                          size_t samples, int sample_rate, int format);
+
 // --- RAM Access ---
 // Returns RAM size, or -1 on error.
 int ale_getRAMSize(ALEInterface_handle ale);
@@ -116,6 +237,89 @@ byte_t ale_getRAM(ALEInterface_handle ale, size_t memory_index);
 // Returns 0 on success, -1 on error.
 int ale_setRAM(ALEInterface_handle ale, size_t memory_index, byte_t value);
 
+// --- Batched Stepping ---
+// Thread-parallel stepping of independent instances: every call advances each
+// instance once (each runs its own scalar emulator) and writes its result into
+// slot i of a contiguous output array. The instances are split into contiguous
+// chunks over the calling thread and num_threads - 1 workers of a process-wide
+// pool, which are kept alive between calls; num_threads <= 1 runs them all on
+// the calling thread.
+// paddle_strengths may be NULL (full strength for every instance).
+// Returns n on success, or -1 on error (rewards_out is then partially written).
+int ale_actBatch(ALEInterface_handle* ales, int n, const Action* actions,
+                 const float* paddle_strengths, reward_t* rewards_out, int num_threads);
+// Experimental: steps n instances of the same ROM with their processors run in
+// lockstep, decoding each instruction once for the instances at the same program
+// counter and bank, with the registers and RAM of up to 32 instances held as
+// arrays the compiler vectorises. Instances whose paths diverge wait for each
+// other where the paths join; instructions that cannot be run in lockstep, and
+// cartridges other than 2K, 4K, F8, F6 and F4 (with or without SC RAM), run on the
+// processor of each instance. The results are exactly those of ale_actBatch.
+// Each instance acts on a thread of its own, so the TIA, rendering and reward of
+// the instances run concurrently. The handle refers to the instances (which must
+// outlive it) and not to their consoles, so ROMs may be reloaded in between.
+// Returns NULL on error, or if the instances run different ROMs.
+ALELockstepBatch_handle ale_createLockstepBatch(ALEInterface_handle* ales, int n);
+void ale_destroyLockstepBatch(ALELockstepBatch_handle batch);
+// Like ale_actBatch for the instances of the batch. Returns n, or -1 on error.
+int ale_lockstepActBatch(ALELockstepBatch_handle batch, const Action* actions,
+                         const float* paddle_strengths, reward_t* rewards_out);
+// Writes 5 counters since the batch was created into stats_out: the runs of the
+// waiting instances, the frames of instructions of one instance, the instructions
+// decoded for a group of instances, the instructions those groups executed, and
+// the instructions run on the processor of an instance. Returns 0, or -1 on error.
+int ale_lockstepBatchStats(ALELockstepBatch_handle batch, uint64_t* stats_out);
+// The batch functions below that fill or register one buffer for all n instances,
+// which can pass 2 GB, return 0 on success or -1 on error or insufficient buffer,
+// and write the number of bytes of all n instances into bytes_out (may be NULL).
+// Writes the palette-indexed screens of all instances back to back (n * height * width).
+int ale_getScreenBatch(ALEInterface_handle* ales, int n, unsigned char* output_buffer, size_t buffer_size,
+                       size_t* bytes_out);
+// Writes the RAM of all instances back to back (n * RAM size).
+int ale_getRAMBatch(ALEInterface_handle* ales, int n, unsigned char* output_buffer, size_t buffer_size,
+                    size_t* bytes_out);
+// Writes the screens of all instances back to back in the given format.
+int ale_getObservationBatch(ALEInterface_handle* ales, int n, unsigned char* output_buffer,
+                            size_t buffer_size, int format, size_t* bytes_out);
+// Writes `samples` samples of the audio of every instance back to back, as an
+// [n, samples] array (see ale_getAudioResampled). If lengths_out is not NULL it
+// receives the number of samples before the padding of each instance (n ints).
+int ale_getAudioBatch(ALEInterface_handle* ales, int n, void* output_buffer, size_t buffer_size,
+                      size_t samples, int sample_rate, int format, int* lengths_out,
+                      size_t* bytes_out);
+// Writes the screen hash of every instance (see ale_getScreenHash) into hashes_out (n values).
+// Returns n, or -1 on error.
+int ale_getScreenHashBatch(ALEInterface_handle* ales, int n, uint64_t* hashes_out);
+// Registers slot i of a contiguous buffer as the observation buffer of instance i
+// (see ale_setObservationBuffer), so ale_actBatch fills an n-observation tensor in place.
+// buffer may be NULL to unregister every instance. bytes_out receives the size of
+// all n observations.
+int ale_setObservationBufferBatch(ALEInterface_handle* ales, int n, unsigned char* buffer,
+                                  size_t buffer_size, int format, size_t* bytes_out);
+// Keeps the frame stack of instance i in slot i of a contiguous buffer (see
+// ale_setFrameStackBuffer), which ale_actBatch then keeps up to date as an
+// [n, K, height, width(, channels)] tensor by writing one frame per instance.
+// buffer may be NULL to move every stack back into its instance. bytes_out
+// receives the size of all n stacks.
+int ale_setFrameStackBufferBatch(ALEInterface_handle* ales, int n, unsigned char* buffer,
+                                 size_t buffer_size, size_t* bytes_out);
+// Writes the head of every instance's frame stack into heads_out (n ints). Heads
+// differ between instances whose episodes were reset at different steps.
+// Returns n, or -1 on error or if an instance has no frame stack.
+int ale_getFrameStackHeadBatch(ALEInterface_handle* ales, int n, int* heads_out);
+
+// --- Memory Usage ---
+// Writes the number of bytes of memory held by this instance into total_out.
+// Lookup tables shared by every instance in the process are not included.
+// Returns 0 on success, -1 on error.
+int ale_getMemoryUsage(ALEInterface_handle ale, size_t* total_out);
+// Breaks the usage down by component (emulator core, each device, environment).
+// Fills the first `capacity` entries of names, bytes and shared (any may be NULL);
+// names are static strings. shared is 1 for the tables shared between instances.
+// Returns the number of components, or -1 on error.
+int ale_getMemoryUsageComponents(ALEInterface_handle ale, const char** names, size_t* bytes,
+                                 int* shared, int capacity);
+
 // --- State Cloning and Restoration ---
 // Remember to call ale_destroyState on the returned handle.
 ALEState_handle ale_cloneState(ALEInterface_handle ale, bool include_rng);
@@ -141,6 +345,80 @@ void ale_destroyScreenExporter(ScreenExporter_handle exporter);
 // Add frame saving functionality for ScreenExporter if needed.
 // int ale_screenExporter_saveFrame(ScreenExporter_handle exporter); // Example
 
+// --- Episode Videos ---
+// With the string setting "record_video_dir", every episode is recorded into
+// <record_video_dir>/episode_NNNNNN.alv: palette-index frames, delta-coded and
+// zlib-compressed in chunks, with a seek index and the reward and player A
+// action (as applied, after sticky actions) of every frame. The file is complete once the next reset (or the
+// destruction of the interface) closes it.
+
+// Opens a recorded episode video. Returns NULL on error.
+// Remember to call ale_closeEpisodeVideo.
+EpisodeVideo_handle ale_openEpisodeVideo(const char* filename);
+// Closes an episode video.
+void ale_closeEpisodeVideo(EpisodeVideo_handle video);
+// Writes the frame dimensions to width and height (either may be NULL).
+// Returns the number of frames, or -1 on error.
+int ale_episodeVideoInfo(EpisodeVideo_handle video, int* width, int* height);
+// Copies frames [first, first + count) back to back into output_buffer as
+// palette indices (width * height bytes each). Decodes at most one chunk per
+// 64 frames, so any range is cheap to reach. Returns 0 on success, -1 on error
+// (including a buffer_size below count * width * height).
+int ale_episodeVideoReadFrames(EpisodeVideo_handle video, size_t first, size_t count,
+                               unsigned char* output_buffer, size_t buffer_size);
+// Copies the rewards and actions of frames [first, first + count) into
+// rewards and actions (either may be NULL). Returns 0 on success, -1 on error.
+int ale_episodeVideoMetadata(EpisodeVideo_handle video, size_t first, size_t count,
+                             int* rewards, int* actions);
+// Copies the 256 RGB entries of the recording's palette (768 bytes) into
+// output_buffer. Returns 0 on success, -1 on error.
+int ale_episodeVideoPalette(EpisodeVideo_handle video, unsigned char* output_buffer,
+                            size_t buffer_size);
+// Saves one frame as a png file in the palette of the recording, e.g. to export
+// only the highlights of an episode. Returns 0 on success, -1 on error.
+int ale_episodeVideoSavePNG(EpisodeVideo_handle video, size_t frame,
+                            const char* filename);
+
+// --- Trajectory Datasets ---
+// With the string setting "dataset_dir", every transition is appended to
+// <dataset_dir>/trajectory_NNNNNN.ald: reset() records the first observation
+// of an episode (action -1, reward 0) and act() each following one, with the
+// action asked for, the clipped reward, the terminal flag, the lives and the
+// RAM, plus the palette-index screen unless "dataset_frames" is "none". Records
+// are written in blocks of "dataset_block_records", column by column, and a
+// new file is started every "dataset_file_blocks" blocks; a file is complete
+// once it is full or the interface is destroyed.
+
+// Columns of a dataset block
+#define ALE_DATASET_ACTION   0 // int32 per record (-1 after a reset)
+#define ALE_DATASET_REWARD   1 // int32 per record
+#define ALE_DATASET_TERMINAL 2 // uint8 per record: 1 game over, 2 truncated, else 0
+#define ALE_DATASET_LIVES    3 // int32 per record
+#define ALE_DATASET_RAM      4 // 128 bytes per record
+#define ALE_DATASET_FRAMES   5 // width * height bytes per record (raw frames only)
+
+// Maps a dataset file into memory. Returns NULL on error.
+// Remember to call ale_closeTrajectoryDataset.
+TrajectoryDataset_handle ale_openTrajectoryDataset(const char* filename);
+// Unmaps a dataset file; the column pointers it returned become invalid.
+void ale_closeTrajectoryDataset(TrajectoryDataset_handle dataset);
+// Writes the number of blocks, the records per full block, the frame
+// dimensions and whether frames are stored (0 none, 1 raw, 2 zlib) to the
+// non-NULL arguments. Every block but the last is full.
+// Returns the number of records, or -1 on error.
+int ale_trajectoryDatasetInfo(TrajectoryDataset_handle dataset, int* num_blocks,
+                              int* block_records, int* width, int* height,
+                              int* frames);
+// Returns a pointer to a column of a block, inside the mapping (no copy), and
+// writes its number of records to records if not NULL. Returns NULL on error,
+// and for ALE_DATASET_FRAMES unless the frames are stored raw.
+const void* ale_trajectoryDatasetColumn(TrajectoryDataset_handle dataset, int block,
+                                        int column, int* records);
+// Copies (or decompresses) the frames of a block into output_buffer, which
+// needs records * width * height bytes. Returns 0 on success, -1 on error.
+int ale_trajectoryDatasetReadFrames(TrajectoryDataset_handle dataset, int block,
+                                    unsigned char* output_buffer, size_t buffer_size);
+
 // --- Static Utility Functions ---
 // Returns 1 if supported and copies MD5 to buffer, 0 if not supported, -1 on error.
 // output_md5_buffer should be at least 33 bytes (32 hex chars + null terminator).
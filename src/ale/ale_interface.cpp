@@ -46,6 +46,7 @@
 
 #include "ale/common/ColourPalette.hpp"
 #include "ale/common/Constants.h"
+#include "ale/common/SoundRaw.hxx"
 #include "ale/emucore/Console.hxx"
 #include "ale/emucore/Props.hxx"
 #include "ale/emucore/MD5.hxx"
@@ -94,6 +95,8 @@ void ALEInterface::loadSettings(const fs::path& romfile,
 
   std::string currentDisplayFormat = theOSystem->console().getFormat();
   theOSystem->colourPalette().setPalette("standard", currentDisplayFormat);
+  theOSystem->colourPalette().setSimdEnabled(
+      theOSystem->settings().getBool("palette_simd"));
 }
 
 ALEInterface::ALEInterface() {
@@ -329,9 +332,77 @@ int ALEInterface::getEpisodeFrameNumber() const {
   return environment->getEpisodeFrameNumber();
 }
 
+// Returns the number of frames emulated by the last call to act()
+int ALEInterface::getLastActFrames() const {
+  return environment->getLastActFrames();
+}
+
 // Returns the current game screen
 const ALEScreen& ALEInterface::getScreen() const { return environment->getScreen(); }
 
+int ALEInterface::getScreenWidth() const { return environment->getScreenWidth(); }
+
+int ALEInterface::getScreenHeight() const { return environment->getScreenHeight(); }
+
+// Converts the current screen into the given format
+void ALEInterface::getObservation(uint8_t* buffer,
+                                  ObservationFormat format) const {
+  const ALEScreen& screen = environment->getScreen();
+  theOSystem->colourPalette().applyPalette(buffer, screen.getArray(),
+                                           screen.arraySize(), format);
+}
+
+// Registers caller memory for the observed screen
+void ALEInterface::setObservationBuffer(uint8_t* buffer,
+                                        ObservationFormat format) {
+  environment->setObservationBuffer(buffer, format);
+}
+
+// Dimensions of the observations written into the observation buffer
+int ALEInterface::getObservationWidth() const {
+  return environment->getObservationWidth();
+}
+
+int ALEInterface::getObservationHeight() const {
+  return environment->getObservationHeight();
+}
+
+// Ring buffer of the last frame_stack observations
+const FrameStack* ALEInterface::getFrameStack() const {
+  return environment->getFrameStack();
+}
+
+void ALEInterface::setFrameStackBuffer(uint8_t* buffer) {
+  environment->setFrameStackBuffer(buffer);
+}
+
+// Rows of the screen that changed since the previous frame
+void ALEInterface::getScreenDirtyRows(uint8_t* bitmap) const {
+  environment->getScreenDirtyRows(bitmap);
+}
+
+// Hash of the screen, kept up to date row by row by the TIA
+uint64_t ALEInterface::getScreenHash() const {
+  return environment->getScreenHash();
+}
+
+// Delta encoding of the screen against the one of the previous call
+size_t ALEInterface::getScreenDelta(uint8_t* buffer) {
+  return environment->getScreenDelta(buffer);
+}
+
+void ALEInterface::resetScreenDelta() {
+  environment->resetScreenDelta();
+}
+
+// Run-length encoding of the screen, optionally XORed with a reference
+size_t ALEInterface::encodeScreenRLE(uint8_t* buffer,
+                                     const uint8_t* reference) const {
+  const ALEScreen& screen = environment->getScreen();
+  return ale::encodeScreenRLE(screen.getArray(), reference, screen.arraySize(),
+                              buffer);
+}
+
 //This method should receive an empty vector to fill it with
 //the grayscale colours
 void ALEInterface::getScreenGrayscale(
@@ -364,6 +435,16 @@ const std::vector<uint8_t>& ALEInterface::getAudio() const {
   return environment->getAudio();
 }
 
+// Writes the current audio data at another rate and in another format
+size_t ALEInterface::getAudio(void* buffer, size_t samples, int sample_rate,
+                              AudioFormat format) const {
+  const std::vector<uint8_t>& audio = environment->getAudio();
+  return resampleAudio(audio.data(), audio.size(), SoundRaw::SampleRate,
+                       buffer, samples,
+                       sample_rate > 0 ? sample_rate : SoundRaw::SampleRate,
+                       format);
+}
+
 // Returns the current RAM content
 const ALERAM& ALEInterface::getRAM() const { return environment->getRAM(); }
 
@@ -401,4 +482,13 @@ ALEInterface::createScreenExporter(const std::string& filename) const {
   return new ScreenExporter(theOSystem->colourPalette(), filename);
 }
 
+MemoryUsage ALEInterface::getMemoryUsage() const {
+  MemoryUsage usage;
+  usage.add("ALEInterface", sizeof(*this));
+  theOSystem->memoryUsage(usage);
+  if (environment)
+    environment->memoryUsage(usage);
+  return usage;
+}
+
 }  // namespace ale
@@ -34,6 +34,9 @@
 #include "ale/emucore/OSystem.hxx"
 #include "ale/games/Roms.hpp"
 #include "ale/environment/stella_environment.hpp"
+#include "ale/common/AudioResampler.hpp"
+#include "ale/common/ScreenCodec.hpp"
+#include "ale/common/ScreenHash.hpp"
 #include "ale/common/ScreenExporter.hpp"
 #include "ale/common/Log.hpp"
 #include "version.hpp"
@@ -149,9 +152,72 @@ class ALEInterface {
   // Returns the frame number since the start of the current episode
   int getEpisodeFrameNumber() const;
 
-  // Returns the current game screen
+  // Returns the number of frames emulated by the last call to act(). This is
+  // frame_skip unless auto_frame_skip extended the step.
+  int getLastActFrames() const;
+
+  // Returns the current game screen. With observation_mode ram or none the
+  // screen is not kept up to date, so this and every other screen accessor
+  // below (observations, frame stack buffers, dirty rows, hashes, deltas, RLE,
+  // grayscale/RGB copies and PNGs) throw std::runtime_error instead.
   const ALEScreen& getScreen() const;
 
+  // Dimensions of the screen, in every observation_mode
+  int getScreenWidth() const;
+  int getScreenHeight() const;
+
+  // Writes the current screen into buffer in the given format; the buffer
+  // must hold width * height * ColourPalette::bytesPerPixel(format) bytes
+  void getObservation(uint8_t* buffer, ObservationFormat format) const;
+
+  // Registers caller memory that receives the observed screen after every
+  // act() and reset_game(), in the given format (sized as for
+  // getObservation). Pass NULL to stop writing to it.
+  void setObservationBuffer(uint8_t* buffer, ObservationFormat format);
+
+  // Dimensions of the observations written into the observation buffer; they
+  // differ from the screen's when observation_width/height are set
+  int getObservationWidth() const;
+  int getObservationHeight() const;
+
+  // The ring buffer of the last frame_stack observations (in
+  // frame_stack_format), or NULL if frame_stack is 0. Its slots are read in
+  // place: the newest observation is in slot head() and slot
+  // (head() - k) mod depth() is k steps older. reset_game() fills every slot
+  // with the first observation of the episode.
+  const FrameStack* getFrameStack() const;
+
+  // Keeps the frame stack's slots in caller memory of getFrameStack()->size()
+  // bytes, so they can be read there without copying; NULL switches back to
+  // memory of the environment's own. The current slots are copied across.
+  void setFrameStackBuffer(uint8_t* buffer);
+
+  // Writes a bitmap of the rows of getScreen() that changed since the frame
+  // before it: (height + 7) / 8 bytes, bit row % 8 of byte row / 8. The TIA
+  // tracks them while drawing. With color_averaging every row is marked.
+  void getScreenDirtyRows(uint8_t* bitmap) const;
+
+  // 64-bit hash of the palette-indexed screen, for deduplicating frames or
+  // spotting a stuck screen. The emulator hashes each row as it draws it, so
+  // this does not read the whole screen again; hashScreen() gives the same
+  // value for a screen held elsewhere.
+  uint64_t getScreenHash() const;
+
+  // Writes getScreen() delta-encoded against the screen of the previous call
+  // (a changed-row bitmap followed by the changed rows, see ScreenCodec.hpp)
+  // and returns its size; buffer must hold screenDeltaBound(width, height)
+  // bytes. The first call, and the first after resetScreenDelta(), sends
+  // every row. decodeScreenDelta() rebuilds the screen on the other side.
+  size_t getScreenDelta(uint8_t* buffer);
+  void resetScreenDelta();
+
+  // Run-length encodes the palette-indexed screen into buffer, which must
+  // hold screenRLEBound(width * height) bytes, and returns the encoded size.
+  // With a reference screen (e.g. the previously sent one) the screen is
+  // XORed with it first, so unchanged pixels cost next to nothing.
+  // decodeScreenRLE() is the matching decoder.
+  size_t encodeScreenRLE(uint8_t* buffer, const uint8_t* reference = NULL) const;
+
   //This method should receive an empty vector to fill it with
   //the grayscale colours
   void getScreenGrayscale(std::vector<unsigned char>& grayscale_output_buffer) const;
@@ -161,9 +227,17 @@ class ALEInterface {
   //followed by the green colours and then the blue colours
   void getScreenRGB(std::vector<unsigned char>& output_rgb_buffer) const;
 
-  // Returns the current audio data
+  // Returns the current audio data: SoundRaw::SamplesPerFrame unsigned 8-bit
+  // samples of the last frame, or of every frame of the last act() with the
+  // sound_obs_window setting
   const std::vector<uint8_t> &getAudio() const;
 
+  // Writes getAudio() resampled from SoundRaw::SampleRate to sample_rate (0
+  // keeps the rate) as exactly samples mono samples of the given format,
+  // padded with silence, and returns the number of samples before the padding
+  size_t getAudio(void* buffer, size_t samples, int sample_rate,
+                  AudioFormat format) const;
+
   // Returns the current RAM content
   const ALERAM& getRAM() const;
 
@@ -198,6 +272,12 @@ class ALEInterface {
   // to exists.
   ScreenExporter* createScreenExporter(const std::string& path) const;
 
+  // Bytes of memory held by this interface, broken down by component: the
+  // emulator core (settings, sound, console, CPU, each device) followed by
+  // the environment. Lookup tables shared by every interface in the process
+  // are listed as shared and left out of the total.
+  MemoryUsage getMemoryUsage() const;
+
  public:
   std::unique_ptr<stella::OSystem> theOSystem;
   std::unique_ptr<stella::Settings> theSettings;
@@ -0,0 +1,97 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  AudioResampler.cpp
+ *
+ *  Conversion of raw TIA samples to other sample rates and formats.
+ **************************************************************************** */
+
+#include "ale/common/AudioResampler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ale {
+
+namespace {
+
+// Stores a sample given as an offset from silence (-128 to 127, possibly
+// fractional) in the given format
+inline void store(void* dst, size_t i, float value, AudioFormat format) {
+  switch (format) {
+    case AUDIO_UINT8:
+      static_cast<uint8_t*>(dst)[i] = (uint8_t)std::lround(value + 128.0f);
+      break;
+    case AUDIO_INT16:
+      static_cast<int16_t*>(dst)[i] = (int16_t)std::lround(value * 256.0f);
+      break;
+    case AUDIO_FLOAT32:
+      static_cast<float*>(dst)[i] = value * (1.0f / 128.0f);
+      break;
+  }
+}
+
+}  // namespace
+
+size_t audioBytesPerSample(AudioFormat format) {
+  switch (format) {
+    case AUDIO_UINT8: return 1;
+    case AUDIO_INT16: return 2;
+    case AUDIO_FLOAT32: return 4;
+  }
+  return 0;
+}
+
+size_t resampledLength(size_t size, int src_rate, int dst_rate) {
+  return (size_t)((uint64_t)size * dst_rate / src_rate);
+}
+
+size_t resampleAudio(const uint8_t* src, size_t size, int src_rate, void* dst,
+                     size_t dst_size, int dst_rate, AudioFormat format) {
+  size_t length = std::min(dst_size, resampledLength(size, src_rate, dst_rate));
+
+  if (src_rate == dst_rate) {
+    for (size_t i = 0; i < length; i++)
+      store(dst, i, (float)src[i] - 128.0f, format);
+  } else if (dst_rate > src_rate) {
+    // Linear interpolation between the two nearest source samples
+    double step = (double)src_rate / dst_rate;
+    for (size_t i = 0; i < length; i++) {
+      double position = i * step;
+      size_t j = (size_t)position;
+      float t = (float)(position - j);
+      float a = src[j];
+      float b = j + 1 < size ? src[j + 1] : a;
+      store(dst, i, a + (b - a) * t - 128.0f, format);
+    }
+  } else {
+    // Average of the source samples covered by [i, i + 1) output samples,
+    // with the partly covered ones weighted by the covered fraction
+    double step = (double)src_rate / dst_rate;
+    for (size_t i = 0; i < length; i++) {
+      double begin = i * step;
+      double end = std::min(begin + step, (double)size);
+      size_t j = (size_t)begin;
+      double sum = 0;
+      for (double position = begin; position < end; j++) {
+        double next = std::min((double)(j + 1), end);
+        sum += src[j] * (next - position);
+        position = next;
+      }
+      store(dst, i, (float)(sum / (end - begin)) - 128.0f, format);
+    }
+  }
+
+  for (size_t i = length; i < dst_size; i++)
+    store(dst, i, 0.0f, format);
+  return length;
+}
+
+}  // namespace ale
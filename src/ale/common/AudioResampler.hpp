@@ -0,0 +1,43 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  AudioResampler.hpp
+ *
+ *  Conversion of raw TIA samples to other sample rates and formats.
+ **************************************************************************** */
+
+#ifndef __AUDIO_RESAMPLER_HPP__
+#define __AUDIO_RESAMPLER_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ale/common/Constants.h"
+
+namespace ale {
+
+/** Returns the number of bytes of one sample in the given format, or 0 for
+ *  an unknown format. */
+size_t audioBytesPerSample(AudioFormat format);
+
+/** Number of samples that size samples at src_rate make at dst_rate. */
+size_t resampledLength(size_t size, int src_rate, int dst_rate);
+
+/** Writes dst_size samples of the size unsigned 8-bit samples in src, taken
+ *  at src_rate, to dst at dst_rate in the given format. Upsampling
+ *  interpolates linearly between samples; downsampling averages the samples
+ *  each output sample covers. Samples past the end of src are silence.
+ *  Returns the number of samples written before the silence. */
+size_t resampleAudio(const uint8_t* src, size_t size, int src_rate, void* dst,
+                     size_t dst_size, int dst_rate, AudioFormat format);
+
+}  // namespace ale
+
+#endif  // __AUDIO_RESAMPLER_HPP__
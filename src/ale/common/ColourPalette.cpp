@@ -22,9 +22,17 @@
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <mutex>
 
 #include "ale/common/Palettes.hpp"
 
+#if (defined(__x86_64__) || defined(_M_X64) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define PALETTE_SIMD_AVX2
+#include <immintrin.h>
+#endif
+
 namespace ale {
 namespace {
 
@@ -42,44 +50,155 @@ inline uint32_t convertGrayscale(uint32_t packedRGBValue) {
   return packRGB(lum, lum, lum);
 }
 
+// Scalar converters: n pixels of src through the given table
+
+void convertBytes(uint8_t* dst, const uint8_t* src, std::size_t n,
+                  const uint8_t* table) {
+  for (std::size_t i = 0; i < n; i++)
+    dst[i] = table[src[i]];
+}
+
+void convertRGB(uint8_t* dst, const uint8_t* src, std::size_t n,
+                const uint32_t* rgba) {
+  for (std::size_t i = 0; i < n; i++, dst += 3) {
+    uint32_t c = rgba[src[i]];
+    dst[0] = (uint8_t)(c);
+    dst[1] = (uint8_t)(c >> 8);
+    dst[2] = (uint8_t)(c >> 16);
+  }
+}
+
+void convertRGBPlanar(uint8_t* r, uint8_t* g, uint8_t* b, const uint8_t* src,
+                      std::size_t n, const uint32_t* rgba) {
+  for (std::size_t i = 0; i < n; i++) {
+    uint32_t c = rgba[src[i]];
+    r[i] = (uint8_t)(c);
+    g[i] = (uint8_t)(c >> 8);
+    b[i] = (uint8_t)(c >> 16);
+  }
+}
+
+void convertRGBA(uint8_t* dst, const uint8_t* src, std::size_t n,
+                 const uint32_t* rgba) {
+  for (std::size_t i = 0; i < n; i++, dst += 4) {
+    uint32_t c = rgba[src[i]];
+    std::memcpy(dst, &c, 4);
+  }
+}
+
+#ifdef PALETTE_SIMD_AVX2
+#define PALETTE_AVX2 __attribute__((target("avx2")))
+
+// AVX2 converters: each handles as many whole groups of 8 (grayscale: 32)
+// pixels as fit in n and answers how many pixels it converted.  The colour
+// lookups are 32-bit gathers indexed by the zero-extended palette bytes.
+
+PALETTE_AVX2 inline __m256i gather8(const uint32_t* table, const uint8_t* src) {
+  __m128i bytes = _mm_loadl_epi64((const __m128i*)src);
+  return _mm256_i32gather_epi32((const int*)table,
+                                _mm256_cvtepu8_epi32(bytes), 4);
+}
+
+PALETTE_AVX2 std::size_t convertGrayscaleAVX2(uint8_t* dst, const uint8_t* src,
+                                              std::size_t n,
+                                              const uint32_t* gray) {
+  // Four gathers of 8 are narrowed to 32 bytes; the packs interleave the
+  // 128-bit lanes, which the final permute puts back in pixel order
+  const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __m256i low = _mm256_packus_epi32(gather8(gray, src + i),
+                                      gather8(gray, src + i + 8));
+    __m256i high = _mm256_packus_epi32(gather8(gray, src + i + 16),
+                                       gather8(gray, src + i + 24));
+    __m256i bytes = _mm256_packus_epi16(low, high);
+    _mm256_storeu_si256((__m256i*)(dst + i),
+                        _mm256_permutevar8x32_epi32(bytes, order));
+  }
+  return i;
+}
+
+PALETTE_AVX2 std::size_t convertRGBAVX2(uint8_t* dst, const uint8_t* src,
+                                        std::size_t n, const uint32_t* rgba) {
+  // Drop the alpha byte of each pixel (12 bytes per lane), then close the
+  // gap between the lanes so the 24 bytes are contiguous
+  const __m256i squeeze = _mm256_setr_epi8(
+      0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+      0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+  const __m256i join = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8, dst += 24) {
+    __m256i c = _mm256_shuffle_epi8(gather8(rgba, src + i), squeeze);
+    c = _mm256_permutevar8x32_epi32(c, join);
+    _mm_storeu_si128((__m128i*)dst, _mm256_castsi256_si128(c));
+    _mm_storel_epi64((__m128i*)(dst + 16), _mm256_extracti128_si256(c, 1));
+  }
+  return i;
+}
+
+PALETTE_AVX2 std::size_t convertRGBPlanarAVX2(uint8_t* r, uint8_t* g,
+                                              uint8_t* b, const uint8_t* src,
+                                              std::size_t n,
+                                              const uint32_t* rgba) {
+  // Group each lane's bytes by channel (R0-3 G0-3 B0-3 A0-3), then pair up
+  // the lanes so each 64-bit quarter holds one channel of all 8 pixels
+  const __m256i channels = _mm256_setr_epi8(
+      0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15,
+      0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+  const __m256i pair = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i c = _mm256_shuffle_epi8(gather8(rgba, src + i), channels);
+    c = _mm256_permutevar8x32_epi32(c, pair);
+    __m128i rg = _mm256_castsi256_si128(c);
+    _mm_storel_epi64((__m128i*)(r + i), rg);
+    _mm_storel_epi64((__m128i*)(g + i), _mm_unpackhi_epi64(rg, rg));
+    _mm_storel_epi64((__m128i*)(b + i), _mm256_extracti128_si256(c, 1));
+  }
+  return i;
+}
+
+PALETTE_AVX2 std::size_t convertRGBAAVX2(uint8_t* dst, const uint8_t* src,
+                                         std::size_t n, const uint32_t* rgba) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_si256((__m256i*)(dst + 4 * i), gather8(rgba, src + i));
+  return i;
+}
+
+#endif  // PALETTE_SIMD_AVX2
+
 }  // namespace
 
-ColourPalette::ColourPalette() : m_palette(NULL) {}
+ColourPalette::ColourPalette() { setSimdEnabled(true); }
 
 void ColourPalette::getRGB(int val, int& r, int& g, int& b) const {
-  assert(m_palette != NULL);
+  assert(m_tables);
   assert(val >= 0 && val <= 0xFF);
   // Make sure we are reading from RGB, not grayscale.
   assert((val & 0x01) == 0);
 
   // Set the RGB components accordingly
-  r = (m_palette[val] >> 16) & 0xFF;
-  g = (m_palette[val] >> 8) & 0xFF;
-  b = (m_palette[val] >> 0) & 0xFF;
+  const uint32_t* palette = m_tables->palette;
+  r = (palette[val] >> 16) & 0xFF;
+  g = (palette[val] >> 8) & 0xFF;
+  b = (palette[val] >> 0) & 0xFF;
 }
 
 uint8_t ColourPalette::getGrayscale(int val) const {
-  assert(m_palette != NULL);
+  assert(m_tables);
   assert(val >= 0 && val < 0xFF);
   assert((val & 0x01) == 1);
 
   // Set the RGB components accordingly
-  return (m_palette[val + 1] >> 0) & 0xFF;
+  return (m_tables->palette[val + 1] >> 0) & 0xFF;
 }
 
-uint32_t ColourPalette::getRGB(int val) const { return m_palette[val]; }
+uint32_t ColourPalette::getRGB(int val) const { return m_tables->palette[val]; }
 
 void ColourPalette::applyPaletteRGB(uint8_t* dst_buffer, uint8_t* src_buffer,
                                     std::size_t src_size) {
-  uint8_t* p = src_buffer;
-  uint8_t* q = dst_buffer;
-
-  for (std::size_t i = 0; i < src_size; i++, p++) {
-    int rgb = m_palette[*p];
-    *q = (unsigned char)((rgb >> 16)); q++;  // r
-    *q = (unsigned char)((rgb >>  8)); q++;  // g
-    *q = (unsigned char)((rgb >>  0)); q++;  // b
-  }
+  applyPalette(dst_buffer, src_buffer, src_size, OBS_RGB);
 }
 
 void ColourPalette::applyPaletteRGB(std::vector<unsigned char>& dst_buffer,
@@ -87,24 +206,12 @@ void ColourPalette::applyPaletteRGB(std::vector<unsigned char>& dst_buffer,
   dst_buffer.resize(3 * src_size);
   assert(dst_buffer.size() == 3 * src_size);
 
-  uint8_t* p = src_buffer;
-
-  for (std::size_t i = 0; i < src_size * 3; i += 3, p++) {
-    int rgb = m_palette[*p];
-    dst_buffer[i + 0] = (unsigned char)((rgb >> 16));  // r
-    dst_buffer[i + 1] = (unsigned char)((rgb >>  8));  // g
-    dst_buffer[i + 2] = (unsigned char)((rgb >>  0));  // b
-  }
+  applyPalette(dst_buffer.data(), src_buffer, src_size, OBS_RGB);
 }
 
 void ColourPalette::applyPaletteGrayscale(uint8_t* dst_buffer, uint8_t* src_buffer,
                                           std::size_t src_size) {
-  uint8_t* p = src_buffer;
-  uint8_t* q = dst_buffer;
-
-  for (std::size_t i = 0; i < src_size; i++, p++, q++) {
-    *q = (unsigned char)(m_palette[*p + 1] & 0xFF);
-  }
+  applyPalette(dst_buffer, src_buffer, src_size, OBS_GRAYSCALE);
 }
 
 void ColourPalette::applyPaletteGrayscale(
@@ -113,11 +220,118 @@ void ColourPalette::applyPaletteGrayscale(
   dst_buffer.resize(src_size);
   assert(dst_buffer.size() == src_size);
 
-  uint8_t* p = src_buffer;
+  applyPalette(dst_buffer.data(), src_buffer, src_size, OBS_GRAYSCALE);
+}
+
+void ColourPalette::applyPalette(uint8_t* dst_buffer, const uint8_t* src_buffer,
+                                 std::size_t frame_size,
+                                 ObservationFormat format,
+                                 std::size_t num_frames) const {
+  const uint32_t* rgba = m_tables->rgba;
+  const uint8_t* grayscale = m_tables->grayscale;
+  const uint32_t* gray = m_tables->gray;
+  for (std::size_t f = 0; f < num_frames; f++) {
+    const uint8_t* src = src_buffer + f * frame_size;
+    uint8_t* dst = dst_buffer + f * frame_size * bytesPerPixel(format);
+
+    // The vectorised converter takes the bulk, the scalar one the remainder
+    std::size_t done = 0;
+    switch (format) {
+      case OBS_PALETTE_INDEX:
+        std::memcpy(dst, src, frame_size);
+        break;
+      case OBS_GRAYSCALE:
+#ifdef PALETTE_SIMD_AVX2
+        if (m_use_avx2)
+          done = convertGrayscaleAVX2(dst, src, frame_size, gray);
+#endif
+        convertBytes(dst + done, src + done, frame_size - done, grayscale);
+        break;
+      case OBS_RGB:
+#ifdef PALETTE_SIMD_AVX2
+        if (m_use_avx2)
+          done = convertRGBAVX2(dst, src, frame_size, rgba);
+#endif
+        convertRGB(dst + 3 * done, src + done, frame_size - done, rgba);
+        break;
+      case OBS_RGB_PLANAR: {
+        uint8_t* r = dst;
+        uint8_t* g = dst + frame_size;
+        uint8_t* b = dst + 2 * frame_size;
+#ifdef PALETTE_SIMD_AVX2
+        if (m_use_avx2)
+          done = convertRGBPlanarAVX2(r, g, b, src, frame_size, rgba);
+#endif
+        convertRGBPlanar(r + done, g + done, b + done, src + done,
+                         frame_size - done, rgba);
+        break;
+      }
+      case OBS_RGBA:
+#ifdef PALETTE_SIMD_AVX2
+        if (m_use_avx2)
+          done = convertRGBAAVX2(dst, src, frame_size, rgba);
+#endif
+        convertRGBA(dst + 4 * done, src + done, frame_size - done, rgba);
+        break;
+    }
+  }
+}
+
+std::size_t ColourPalette::bytesPerPixel(ObservationFormat format) {
+  switch (format) {
+    case OBS_RGB:
+    case OBS_RGB_PLANAR:
+      return 3;
+    case OBS_RGBA:
+      return 4;
+    default:
+      return 1;
+  }
+}
 
-  for (std::size_t i = 0; i < src_size; i++, p++) {
-    dst_buffer[i] = (unsigned char)(m_palette[*p + 1] & 0xFF);
+void ColourPalette::setSimdEnabled(bool enabled) {
+  m_use_avx2 = false;
+#ifdef PALETTE_SIMD_AVX2
+  if (enabled) {
+    __builtin_cpu_init();
+    m_use_avx2 = __builtin_cpu_supports("avx2");
   }
+#endif
+}
+
+std::shared_ptr<const ColourPalette::Tables>
+ColourPalette::getTables(const uint32_t* colours) {
+  static std::mutex mutex;
+  static std::map<std::vector<uint32_t>, std::weak_ptr<const Tables>> tables;
+
+  std::vector<uint32_t> key(colours, colours + 256);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  std::shared_ptr<const Tables> shared = tables[key].lock();
+  if (!shared) {
+    std::shared_ptr<Tables> fresh = std::make_shared<Tables>();
+    makeTables(colours, *fresh);
+    shared = fresh;
+    tables[key] = shared;
+  }
+  return shared;
+}
+
+void ColourPalette::makeTables(const uint32_t* colours, Tables& tables) {
+  std::memcpy(tables.palette, colours, sizeof(tables.palette));
+  for (int i = 0; i < 256; i++) {
+    uint32_t rgb = colours[i];
+    tables.rgba[i] = ((rgb >> 16) & 0xFF) | (rgb & 0xFF00) |
+                     ((rgb & 0xFF) << 16) | 0xFF000000;
+    // Odd entries hold the grayscale version of the colour below them; the
+    // last index has no odd neighbour, so it uses its own low byte
+    tables.grayscale[i] = colours[i < 255 ? i + 1 : i] & 0xFF;
+    tables.gray[i] = tables.grayscale[i];
+  }
+}
+
+void ColourPalette::setPalette(const uint32_t* colours) {
+  m_tables = getTables(colours);
 }
 
 void ColourPalette::setPalette(const std::string& type,
@@ -128,7 +342,7 @@ void ColourPalette::setPalette(const std::string& type,
     paletteNum = 0;
   else if (type == "z26")
     paletteNum = 1;
-  else if (type == "user" && myUserPaletteDefined)
+  else if (type == "user" && m_user_palettes)
     paletteNum = 2;
 
   int paletteFormat = 0;
@@ -137,12 +351,14 @@ void ColourPalette::setPalette(const std::string& type,
   else if (displayFormat.compare(0, 5, "SECAM") == 0)
     paletteFormat = 2;
 
-  uint32_t* paletteMapping[3][3] = {
+  const UserPalettes* user = m_user_palettes.get();
+  const uint32_t* paletteMapping[3][3] = {
       {NTSCPalette, PALPalette, SECAMPalette},
       {NTSCPaletteZ26, PALPaletteZ26, SECAMPaletteZ26},
-      {m_userNTSCPalette, m_userPALPalette, m_userSECAMPalette}};
+      {user ? user->ntsc : NULL, user ? user->pal : NULL,
+       user ? user->secam : NULL}};
 
-  m_palette = paletteMapping[paletteNum][paletteFormat];
+  setPalette(paletteMapping[paletteNum][paletteFormat]);
 }
 
 void ColourPalette::loadUserPalette(const std::string& paletteFile) {
@@ -173,21 +389,22 @@ void ColourPalette::loadUserPalette(const std::string& paletteFile) {
   }
 
   // Now that we have valid data, create the user-defined palettes
+  std::shared_ptr<UserPalettes> user = std::make_shared<UserPalettes>();
   uint8_t pixbuf[bytesPerColor]; // Temporary buffer for one 24-bit pixel
 
   for (int i = 0; i < NTSCPaletteSize; i++) // NTSC palette
   {
     paletteStream.read((char*)pixbuf, bytesPerColor);
-    m_userNTSCPalette[(i << 1)] = packRGB(pixbuf[0], pixbuf[1], pixbuf[2]);
-    m_userNTSCPalette[(i << 1) + 1] =
-        convertGrayscale(m_userNTSCPalette[(i << 1)]);
+    user->ntsc[(i << 1)] = packRGB(pixbuf[0], pixbuf[1], pixbuf[2]);
+    user->ntsc[(i << 1) + 1] =
+        convertGrayscale(user->ntsc[(i << 1)]);
   }
   for (int i = 0; i < PALPaletteSize; i++) // PAL palette
   {
     paletteStream.read((char*)pixbuf, bytesPerColor);
-    m_userPALPalette[(i << 1)] = packRGB(pixbuf[0], pixbuf[1], pixbuf[2]);
-    m_userPALPalette[(i << 1) + 1] =
-        convertGrayscale(m_userPALPalette[(i << 1)]);
+    user->pal[(i << 1)] = packRGB(pixbuf[0], pixbuf[1], pixbuf[2]);
+    user->pal[(i << 1) + 1] =
+        convertGrayscale(user->pal[(i << 1)]);
   }
 
   uint32_t tmpSecam[SECAMPaletteSize *
@@ -199,7 +416,7 @@ void ColourPalette::loadUserPalette(const std::string& paletteFile) {
     tmpSecam[(i << 1) + 1] = convertGrayscale(tmpSecam[(i << 1)]);
   }
 
-  uint32_t* tmpSECAMPalettePtr = m_userSECAMPalette;
+  uint32_t* tmpSECAMPalettePtr = user->secam;
   for (int i = 0; i < 16; ++i) {
     memcpy(tmpSECAMPalettePtr, tmpSecam, SECAMPaletteSize * 2);
     tmpSECAMPalettePtr += SECAMPaletteSize * 2;
@@ -207,7 +424,7 @@ void ColourPalette::loadUserPalette(const std::string& paletteFile) {
 
   paletteStream.close();
 
-  myUserPaletteDefined = true;
+  m_user_palettes = user;
 }
 
 }  // namespace ale
@@ -16,12 +16,15 @@
 #ifndef __COLOUR_PALETTE_HPP__
 #define __COLOUR_PALETTE_HPP__
 
+#include <memory>
 #include <vector>
 #include <string>
 
 // Include obscure header file for uint32_t definition
 #include <cstdint>
 
+#include "ale/common/Constants.h"
+
 namespace ale {
 
 class ColourPalette {
@@ -54,6 +57,25 @@ class ColourPalette {
   void applyPaletteGrayscale(std::vector<unsigned char>& dst_buffer,
                              uint8_t* src_buffer, size_t src_size);
 
+  /** Converts num_frames palette-indexed frames of frame_size pixels each,
+   *  stored back to back in src_buffer, into the given format. Each output
+   *  frame takes frame_size * bytesPerPixel(format) bytes of dst_buffer, so
+   *  OBS_RGB_PLANAR keeps its three planes per frame. Whole vectors of
+   *  pixels go through AVX2 gathers when the CPU supports them.
+   */
+  void applyPalette(uint8_t* dst_buffer, const uint8_t* src_buffer,
+                    size_t frame_size, ObservationFormat format,
+                    size_t num_frames = 1) const;
+
+  /** Returns the number of output bytes per pixel of the given format. */
+  static size_t bytesPerPixel(ObservationFormat format);
+
+  /** Turns the vectorised converters on or off (for benchmarking). */
+  void setSimdEnabled(bool enabled);
+
+  /** Whether the vectorised converters are in use. */
+  bool simdEnabled() const { return m_use_avx2; }
+
   /** Loads all defined palettes with PAL color-loss data depending on 'state'.
    *  Sets the palette according to the given palette name.
    *
@@ -62,20 +84,56 @@ class ColourPalette {
    */
   void setPalette(const std::string& type, const std::string& displayFormat);
 
+  /** Uses the given 256 packed RGB colours (format 0x00RRGGBB) as the
+   *  palette, odd entries holding the grayscale of the colour below them.
+   */
+  void setPalette(const uint32_t* colours);
+
   /** Loads a user-defined palette file (from OSystem::paletteFile), filling the
    *  appropriate user-defined palette arrays.
    */
   void loadUserPalette(const std::string& paletteFile);
 
- private:
-  uint32_t* m_palette;
+  /** Bytes of the tables in use, which are shared with other palettes, or 0
+   *  before a palette is set. */
+  size_t tablesMemoryUsage() const { return m_tables ? sizeof(Tables) : 0; }
 
-  bool myUserPaletteDefined;
+  /** Bytes of the user-defined palettes, 0 unless a palette file was loaded. */
+  size_t userPalettesMemoryUsage() const {
+    return m_user_palettes ? sizeof(UserPalettes) : 0;
+  }
+
+  /** The colours of a palette and the conversion tables built from them.
+   *  Tables are immutable and shared by all palettes with the same colours. */
+  struct Tables {
+    uint32_t palette[256];
+
+    // RGBA in memory order (red in the lowest byte), the grayscale byte, and
+    // the grayscale zero-extended to 32 bits for gathers
+    uint32_t rgba[256];
+    uint8_t grayscale[256];
+    uint32_t gray[256];
+  };
+
+ private:
+  static std::shared_ptr<const Tables> getTables(const uint32_t* colours);
+  static void makeTables(const uint32_t* colours, Tables& tables);
 
   // Table of RGB values for NTSC, PAL and SECAM - user-defined
-  uint32_t m_userNTSCPalette[256];
-  uint32_t m_userPALPalette[256];
-  uint32_t m_userSECAMPalette[256];
+  struct UserPalettes {
+    uint32_t ntsc[256];
+    uint32_t pal[256];
+    uint32_t secam[256];
+  };
+
+ private:
+  std::shared_ptr<const Tables> m_tables;  // NULL until a palette is set
+
+  // Whether applyPalette may use the AVX2 converters
+  bool m_use_avx2;
+
+  // NULL until a palette file is loaded
+  std::shared_ptr<const UserPalettes> m_user_palettes;
 };
 
 }  // namespace ale
@@ -91,6 +91,22 @@ typedef int reward_t;
 // Other constant values
 #define RAM_LENGTH 128
 
+// Pixel formats for observations written straight into caller memory
+enum ObservationFormat {
+  OBS_PALETTE_INDEX = 0,  // One palette index per pixel (as in ALEScreen)
+  OBS_GRAYSCALE     = 1,  // One luminance byte per pixel
+  OBS_RGB           = 2,  // Three bytes per pixel, interleaved R, G, B (HWC)
+  OBS_RGB_PLANAR    = 3,  // A plane of R, then of G, then of B (CHW)
+  OBS_RGBA          = 4   // Four bytes per pixel, R, G, B and an opaque alpha
+};
+
+// Sample formats for mono audio written into caller memory
+enum AudioFormat {
+  AUDIO_UINT8   = 0,  // One byte per sample, silence at 128 (as getAudio())
+  AUDIO_INT16   = 1,  // Signed 16-bit samples, silence at 0
+  AUDIO_FLOAT32 = 2   // Floats in [-1, 1), silence at 0
+};
+
 }  // namespace ale
 
 #endif  // __CONSTANTS_H__
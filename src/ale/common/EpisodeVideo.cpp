@@ -0,0 +1,303 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  EpisodeVideo.cpp
+ *
+ *  Single-file recordings of the frames of an episode, with random access.
+ **************************************************************************** */
+
+#include "ale/common/EpisodeVideo.hpp"
+
+#include <zlib.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "ale/common/ScreenExporter.hpp"
+
+namespace ale {
+
+static const char HEADER_MAGIC[8] = {'A', 'L', 'E', 'V', 'I', 'D', 'E', 'O'};
+static const char TRAILER_MAGIC[8] = {'A', 'L', 'E', 'V', 'I', 'D', 'I', 'X'};
+static const uint16_t VERSION = 1;
+static const size_t HEADER_SIZE = 16 + 256 * 3;
+static const size_t TRAILER_SIZE = 24;
+
+// Little-endian integers appended to or read from a byte buffer
+static void putU16(std::vector<uint8_t>& out, uint16_t v) {
+  out.push_back(v & 0xFF);
+  out.push_back(v >> 8);
+}
+
+static void putU32(std::vector<uint8_t>& out, uint32_t v) {
+  for (int i = 0; i < 4; i++)
+    out.push_back((v >> (8 * i)) & 0xFF);
+}
+
+static void putU64(std::vector<uint8_t>& out, uint64_t v) {
+  for (int i = 0; i < 8; i++)
+    out.push_back((v >> (8 * i)) & 0xFF);
+}
+
+static uint16_t getU16(const uint8_t* p) {
+  return p[0] | (p[1] << 8);
+}
+
+static uint32_t getU32(const uint8_t* p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t getU64(const uint8_t* p) {
+  return getU32(p) | ((uint64_t)getU32(p + 4) << 32);
+}
+
+EpisodeVideoWriter::EpisodeVideoWriter(const ColourPalette& palette,
+                                       int frames_per_chunk,
+                                       int compression_level)
+    : m_palette(palette),
+      m_frames_per_chunk(frames_per_chunk > 0 ? frames_per_chunk : 1),
+      m_compression_level(compression_level),
+      m_width(0), m_height(0), m_chunk_frames(0), m_offset(0) {}
+
+EpisodeVideoWriter::~EpisodeVideoWriter() {
+  if (isOpen()) {
+    try {
+      close();
+    } catch (const std::exception&) {
+      // Nothing more can be done about a failing write here
+    }
+  }
+}
+
+void EpisodeVideoWriter::open(const std::string& filename, int width,
+                              int height) {
+  if (isOpen())
+    close();
+
+  m_file.open(filename.c_str(), std::ios_base::binary | std::ios_base::trunc);
+  if (!m_file.good())
+    throw std::runtime_error("Could not open " + filename + " for writing");
+
+  m_width = width;
+  m_height = height;
+  m_previous.assign((size_t)width * height, 0);
+  m_chunk.resize((size_t)width * height * m_frames_per_chunk);
+  m_chunk_frames = 0;
+  m_chunk_offsets.clear();
+  m_chunk_sizes.clear();
+  m_rewards.clear();
+  m_actions.clear();
+
+  std::vector<uint8_t> header(HEADER_MAGIC, HEADER_MAGIC + 8);
+  putU16(header, VERSION);
+  putU16(header, width);
+  putU16(header, height);
+  putU16(header, m_frames_per_chunk);
+  for (int i = 0; i < 256; i++) {
+    uint32_t rgb = m_palette.getRGB(i);
+    header.push_back((uint8_t)(rgb >> 16));
+    header.push_back((uint8_t)(rgb >> 8));
+    header.push_back((uint8_t)rgb);
+  }
+  m_file.write((const char*)&header[0], header.size());
+  m_offset = header.size();
+}
+
+void EpisodeVideoWriter::addFrame(const uint8_t* pixels, int reward,
+                                  int action) {
+  size_t size = (size_t)m_width * m_height;
+  uint8_t* dst = &m_chunk[m_chunk_frames * size];
+  if (m_chunk_frames == 0) {
+    std::memcpy(dst, pixels, size);
+  } else {
+    for (size_t i = 0; i < size; i++)
+      dst[i] = pixels[i] ^ m_previous[i];
+  }
+  std::memcpy(&m_previous[0], pixels, size);
+
+  m_rewards.push_back(reward);
+  m_actions.push_back(action);
+  if (++m_chunk_frames == m_frames_per_chunk)
+    flushChunk();
+}
+
+void EpisodeVideoWriter::flushChunk() {
+  if (m_chunk_frames == 0)
+    return;
+
+  uLong size = (uLong)m_chunk_frames * m_width * m_height;
+  uLongf compressed_size = compressBound(size);
+  m_compressed.resize(compressed_size);
+  if (compress2(&m_compressed[0], &compressed_size, &m_chunk[0], size,
+                m_compression_level) != Z_OK)
+    throw std::runtime_error("Could not compress an episode video chunk");
+
+  m_file.write((const char*)&m_compressed[0], compressed_size);
+  if (!m_file.good())
+    throw std::runtime_error("Could not write an episode video chunk");
+  m_chunk_offsets.push_back(m_offset);
+  m_chunk_sizes.push_back(compressed_size);
+  m_offset += compressed_size;
+  m_chunk_frames = 0;
+}
+
+void EpisodeVideoWriter::close() {
+  if (!isOpen())
+    return;
+  flushChunk();
+
+  std::vector<uint8_t> index;
+  for (size_t c = 0; c < m_chunk_offsets.size(); c++) {
+    putU64(index, m_chunk_offsets[c]);
+    putU32(index, m_chunk_sizes[c]);
+  }
+  for (size_t f = 0; f < m_rewards.size(); f++) {
+    putU32(index, (uint32_t)m_rewards[f]);
+    putU32(index, (uint32_t)m_actions[f]);
+  }
+  putU64(index, m_offset);
+  putU32(index, (uint32_t)m_rewards.size());
+  putU32(index, (uint32_t)m_chunk_offsets.size());
+  index.insert(index.end(), TRAILER_MAGIC, TRAILER_MAGIC + 8);
+
+  m_file.write((const char*)&index[0], index.size());
+  bool ok = m_file.good();
+  m_file.close();
+  if (!ok)
+    throw std::runtime_error("Could not write an episode video index");
+}
+
+size_t EpisodeVideoWriter::memoryUsage() const {
+  return sizeof(*this) + m_previous.capacity() + m_chunk.capacity() +
+         m_compressed.capacity() +
+         m_chunk_offsets.capacity() * sizeof(uint64_t) +
+         m_chunk_sizes.capacity() * sizeof(uint32_t) +
+         (m_rewards.capacity() + m_actions.capacity()) * sizeof(int32_t);
+}
+
+EpisodeVideoReader::EpisodeVideoReader(const std::string& filename)
+    : m_file(filename.c_str(), std::ios_base::binary),
+      m_chunk_index(SIZE_MAX) {
+  if (!m_file.good())
+    throw std::runtime_error("Could not open " + filename);
+
+  uint8_t header[HEADER_SIZE];
+  m_file.read((char*)header, HEADER_SIZE);
+  if (!m_file.good() || std::memcmp(header, HEADER_MAGIC, 8) != 0 ||
+      getU16(header + 8) != VERSION)
+    throw std::runtime_error(filename + " is not an episode video");
+  m_width = getU16(header + 10);
+  m_height = getU16(header + 12);
+  m_frames_per_chunk = getU16(header + 14);
+  std::memcpy(m_palette, header + 16, sizeof(m_palette));
+  if (m_width == 0 || m_height == 0)
+    throw std::runtime_error(filename + " has no frame size");
+
+  // The trailer locates the index; a recording that was never closed has none
+  uint8_t trailer[TRAILER_SIZE];
+  m_file.seekg(0, std::ios_base::end);
+  uint64_t file_size = (uint64_t)m_file.tellg();
+  if (file_size < HEADER_SIZE + TRAILER_SIZE)
+    throw std::runtime_error(filename + " is truncated");
+  m_file.seekg(file_size - TRAILER_SIZE);
+  m_file.read((char*)trailer, TRAILER_SIZE);
+  if (!m_file.good() || std::memcmp(trailer + 16, TRAILER_MAGIC, 8) != 0)
+    throw std::runtime_error(filename + " is truncated");
+
+  uint64_t index_offset = getU64(trailer);
+  uint32_t num_frames = getU32(trailer + 8);
+  uint32_t num_chunks = getU32(trailer + 12);
+  uint64_t index_size = (uint64_t)num_chunks * 12 + (uint64_t)num_frames * 8;
+  if (m_frames_per_chunk == 0 ||
+      num_chunks != (num_frames + m_frames_per_chunk - 1) / m_frames_per_chunk ||
+      index_offset + index_size + TRAILER_SIZE != file_size)
+    throw std::runtime_error(filename + " has a damaged index");
+
+  std::vector<uint8_t> index(index_size);
+  m_file.seekg(index_offset);
+  if (index_size > 0)
+    m_file.read((char*)&index[0], index_size);
+  if (!m_file.good())
+    throw std::runtime_error(filename + " has a damaged index");
+
+  const uint8_t* p = index.data();
+  for (uint32_t c = 0; c < num_chunks; c++, p += 12) {
+    m_chunk_offsets.push_back(getU64(p));
+    m_chunk_sizes.push_back(getU32(p + 8));
+  }
+  for (uint32_t f = 0; f < num_frames; f++, p += 8) {
+    m_rewards.push_back((int32_t)getU32(p));
+    m_actions.push_back((int32_t)getU32(p + 4));
+  }
+}
+
+void EpisodeVideoReader::loadChunk(size_t c) {
+  if (c == m_chunk_index)
+    return;
+  m_chunk_index = SIZE_MAX;
+
+  size_t frame_size = (size_t)m_width * m_height;
+  size_t first = c * m_frames_per_chunk;
+  size_t frames = std::min((size_t)m_frames_per_chunk, numFrames() - first);
+
+  m_compressed.resize(m_chunk_sizes[c]);
+  m_file.clear();
+  m_file.seekg(m_chunk_offsets[c]);
+  m_file.read((char*)&m_compressed[0], m_compressed.size());
+
+  uLongf size = frames * frame_size;
+  m_chunk.resize(size);
+  if (!m_file.good() ||
+      uncompress(&m_chunk[0], &size, &m_compressed[0], m_compressed.size()) != Z_OK ||
+      size != frames * frame_size)
+    throw std::runtime_error("Damaged episode video chunk");
+
+  // Undo the deltas, each frame from the one before it
+  for (size_t f = 1; f < frames; f++) {
+    uint8_t* frame = &m_chunk[f * frame_size];
+    const uint8_t* previous = frame - frame_size;
+    for (size_t i = 0; i < frame_size; i++)
+      frame[i] ^= previous[i];
+  }
+  m_chunk_index = c;
+}
+
+void EpisodeVideoReader::readFrames(size_t first, size_t count,
+                                    uint8_t* frames) {
+  if (first > numFrames() || count > numFrames() - first)
+    throw std::out_of_range("Frames past the end of the episode video");
+
+  size_t frame_size = (size_t)m_width * m_height;
+  for (size_t f = first; f < first + count; ) {
+    size_t c = f / m_frames_per_chunk;
+    loadChunk(c);
+    size_t chunk_first = c * m_frames_per_chunk;
+    size_t chunk_end = std::min(chunk_first + m_frames_per_chunk, first + count);
+    std::memcpy(frames + (f - first) * frame_size,
+                &m_chunk[(f - chunk_first) * frame_size],
+                (chunk_end - f) * frame_size);
+    f = chunk_end;
+  }
+}
+
+void EpisodeVideoReader::savePNG(size_t f, const std::string& filename) {
+  ALEScreen screen(m_height, m_width);
+  readFrames(f, 1, screen.getArray());
+
+  uint32_t colours[256];
+  for (int i = 0; i < 256; i++)
+    colours[i] = ((uint32_t)m_palette[3 * i] << 16) |
+                 ((uint32_t)m_palette[3 * i + 1] << 8) | m_palette[3 * i + 2];
+  ColourPalette palette;
+  palette.setPalette(colours);
+  ScreenExporter(palette).save(screen, filename);
+}
+
+}  // namespace ale
@@ -0,0 +1,138 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  EpisodeVideo.hpp
+ *
+ *  Single-file recordings of the frames of an episode, with random access.
+ **************************************************************************** */
+
+#ifndef __EPISODE_VIDEO_HPP__
+#define __EPISODE_VIDEO_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "ale/common/ColourPalette.hpp"
+
+namespace ale {
+
+/* File layout (integers little-endian):
+ *
+ *   header   "ALEVIDEO", u16 version (1), u16 width, u16 height,
+ *            u16 frames per chunk, then 256 RGB palette entries
+ *   chunks   one zlib stream per chunk of frames: the chunk's first frame as
+ *            palette indices, then each following frame XOR the one before
+ *            it (mostly zeros, which compress to next to nothing)
+ *   index    per chunk: u64 file offset, u32 compressed size;
+ *            per frame: i32 reward, i32 player A action
+ *   trailer  u64 index offset, u32 frames, u32 chunks, "ALEVIDIX"
+ *
+ * Frame f is in chunk f / frames per chunk, so reading any frame decodes at
+ * most one chunk. */
+
+/** Records the palette-indexed frames of an episode, with the reward and
+ *  action of each, into one file. */
+class EpisodeVideoWriter {
+ public:
+  /** frames_per_chunk trades compression against the cost of reaching a
+   *  frame in the middle of a chunk; compression_level is zlib's. */
+  EpisodeVideoWriter(const ColourPalette& palette, int frames_per_chunk = 64,
+                     int compression_level = 1);
+
+  /** Closes the file that is open. */
+  ~EpisodeVideoWriter();
+
+  /** Starts a new recording in filename (after closing the open one); throws
+   *  std::runtime_error if the file cannot be created. */
+  void open(const std::string& filename, int width, int height);
+
+  /** Whether a recording is open. */
+  bool isOpen() const { return m_file.is_open(); }
+
+  /** Appends a width * height frame of palette indices. */
+  void addFrame(const uint8_t* pixels, int reward, int action);
+
+  /** Writes the last chunk and the index, and closes the file. */
+  void close();
+
+  /** Frames recorded into the open file. */
+  size_t numFrames() const { return m_rewards.size(); }
+
+  /** Bytes of memory held, including the writer itself. */
+  size_t memoryUsage() const;
+
+ private:
+  /** Compresses the frames of the current chunk and writes them. */
+  void flushChunk();
+
+  const ColourPalette& m_palette;
+  int m_frames_per_chunk;
+  int m_compression_level;
+  std::ofstream m_file;
+  int m_width, m_height;
+  std::vector<uint8_t> m_previous;    // Last frame added
+  std::vector<uint8_t> m_chunk;       // Delta-coded frames of the current chunk
+  int m_chunk_frames;                 // Frames in m_chunk
+  std::vector<uint8_t> m_compressed;  // Compressed chunk being written
+  std::vector<uint64_t> m_chunk_offsets;
+  std::vector<uint32_t> m_chunk_sizes;
+  std::vector<int32_t> m_rewards;
+  std::vector<int32_t> m_actions;
+  uint64_t m_offset;                  // Bytes written so far
+};
+
+/** Reads frame ranges of a recording made by EpisodeVideoWriter. */
+class EpisodeVideoReader {
+ public:
+  /** Opens filename; throws std::runtime_error if it is not a complete
+   *  recording. */
+  explicit EpisodeVideoReader(const std::string& filename);
+
+  int width() const { return m_width; }
+  int height() const { return m_height; }
+  size_t numFrames() const { return m_rewards.size(); }
+
+  /** The 256 RGB entries (768 bytes) of the palette of the recording. */
+  const uint8_t* palette() const { return m_palette; }
+
+  /** Reward and player A action of frame f. */
+  int reward(size_t f) const { return m_rewards[f]; }
+  int action(size_t f) const { return m_actions[f]; }
+
+  /** Writes frames [first, first + count) back to back into frames as
+   *  palette indices (width * height bytes each); throws std::out_of_range
+   *  for frames past the end and std::runtime_error for a damaged file. */
+  void readFrames(size_t first, size_t count, uint8_t* frames);
+
+  /** Saves frame f as a png file in the palette of the recording. */
+  void savePNG(size_t f, const std::string& filename);
+
+ private:
+  /** Decodes chunk c into m_chunk, unless it is there already. */
+  void loadChunk(size_t c);
+
+  std::ifstream m_file;
+  int m_width, m_height, m_frames_per_chunk;
+  uint8_t m_palette[256 * 3];
+  std::vector<uint64_t> m_chunk_offsets;
+  std::vector<uint32_t> m_chunk_sizes;
+  std::vector<int32_t> m_rewards;
+  std::vector<int32_t> m_actions;
+  std::vector<uint8_t> m_compressed;
+  std::vector<uint8_t> m_chunk;  // Frames of chunk m_chunk_index, undone deltas
+  size_t m_chunk_index;          // SIZE_MAX when no chunk is decoded
+};
+
+}  // namespace ale
+
+#endif  // __EPISODE_VIDEO_HPP__
@@ -0,0 +1,63 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  MemoryUsage.hpp
+ *
+ *  Accounting of the memory held by the components of one emulator instance.
+ **************************************************************************** */
+
+#ifndef __MEMORY_USAGE_HPP__
+#define __MEMORY_USAGE_HPP__
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ale {
+
+/** Bytes held by each component of one emulator instance, in the order they
+ *  were added. Read-only data shared by all instances is listed as well, but
+ *  marked shared and left out of the total. */
+class MemoryUsage {
+ public:
+  struct Component {
+    const char* name;  // Static string
+    size_t bytes;
+    bool shared;
+  };
+
+  void add(const char* name, size_t bytes, bool shared = false) {
+    Component c = {name, bytes, shared};
+    m_components.push_back(c);
+  }
+
+  const std::vector<Component>& components() const { return m_components; }
+
+  /** Bytes owned by this instance alone. */
+  size_t total() const {
+    size_t bytes = 0;
+    for (size_t i = 0; i < m_components.size(); i++)
+      if (!m_components[i].shared)
+        bytes += m_components[i].bytes;
+    return bytes;
+  }
+
+  /** Heap bytes of a string beyond the string object itself. */
+  static size_t heapBytes(const std::string& s) {
+    return s.capacity() >= sizeof(std::string) ? s.capacity() + 1 : 0;
+  }
+
+ private:
+  std::vector<Component> m_components;
+};
+
+}  // namespace ale
+
+#endif  // __MEMORY_USAGE_HPP__
@@ -0,0 +1,205 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  ScreenCodec.cpp
+ *
+ *  Compact encodings of palette-indexed screens for sending or storing.
+ **************************************************************************** */
+
+#include "ale/common/ScreenCodec.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ale {
+
+size_t screenDeltaBound(int width, int height) {
+  return (size_t)(height + 7) / 8 + (size_t)width * height;
+}
+
+void findChangedRows(const uint8_t* screen, const uint8_t* reference,
+                     int width, int height, uint8_t* changed_rows) {
+  std::memset(changed_rows, 0, (height + 7) / 8);
+  for (int row = 0; row < height; row++) {
+    size_t offset = (size_t)row * width;
+    if (std::memcmp(screen + offset, reference + offset, width) != 0)
+      changed_rows[row >> 3] |= 1 << (row & 7);
+  }
+}
+
+size_t encodeScreenDelta(const uint8_t* screen, const uint8_t* changed_rows,
+                         int width, int height, uint8_t* dst) {
+  size_t bitmap_size = (height + 7) / 8;
+  std::memcpy(dst, changed_rows, bitmap_size);
+  // Bits past the last row are not part of the bitmap
+  if (height & 7)
+    dst[bitmap_size - 1] &= (1 << (height & 7)) - 1;
+
+  uint8_t* out = dst + bitmap_size;
+  for (int row = 0; row < height; row++) {
+    if (changed_rows[row >> 3] & (1 << (row & 7))) {
+      std::memcpy(out, screen + (size_t)row * width, width);
+      out += width;
+    }
+  }
+  return out - dst;
+}
+
+size_t decodeScreenDelta(const uint8_t* src, size_t size, int width,
+                         int height, uint8_t* screen) {
+  size_t bitmap_size = (height + 7) / 8;
+  if (size < bitmap_size)
+    return 0;
+
+  const uint8_t* in = src + bitmap_size;
+  const uint8_t* end = src + size;
+  for (int row = 0; row < height; row++) {
+    if (src[row >> 3] & (1 << (row & 7))) {
+      if (end - in < width)
+        return 0;
+      std::memcpy(screen + (size_t)row * width, in, width);
+      in += width;
+    }
+  }
+  return in - src;
+}
+
+namespace {
+
+// Longest literal and run a token holds
+const size_t kMaxLiteral = 128;
+const size_t kMinRun = 3;
+const size_t kMaxRun = 130;
+
+// Reads the bytes to encode: the plain screen, or its XOR with a reference
+struct PlainBytes {
+  const uint8_t* screen;
+  uint8_t operator()(size_t i) const { return screen[i]; }
+  uint64_t word(size_t i) const {
+    uint64_t w;
+    std::memcpy(&w, screen + i, 8);
+    return w;
+  }
+};
+
+struct XorBytes {
+  const uint8_t* screen;
+  const uint8_t* reference;
+  uint8_t operator()(size_t i) const { return screen[i] ^ reference[i]; }
+  uint64_t word(size_t i) const {
+    uint64_t a, b;
+    std::memcpy(&a, screen + i, 8);
+    std::memcpy(&b, reference + i, 8);
+    return a ^ b;
+  }
+};
+
+// Length of the run of `value` starting at i, at most `limit`; compares
+// eight bytes at a time, since Atari screens are mostly long runs
+template <class Bytes>
+size_t runLength(const Bytes& get, size_t i, size_t limit, uint8_t value) {
+  uint64_t pattern = value * 0x0101010101010101ULL;
+  size_t run = 1;
+  while (run + 8 <= limit && get.word(i + run) == pattern)
+    run += 8;
+  while (run < limit && get(i + run) == value)
+    run++;
+  return run;
+}
+
+template <class Bytes>
+size_t encodeRuns(size_t size, const Bytes& get, uint8_t* dst) {
+  uint8_t* out = dst;
+  size_t literal_start = 0;
+  size_t i = 0;
+
+  // Writes the pending literal bytes [literal_start, end) as tokens
+  auto flushLiteral = [&](size_t end) {
+    while (literal_start < end) {
+      size_t n = std::min(end - literal_start, kMaxLiteral);
+      *out++ = (uint8_t)(n - 1);
+      for (size_t k = 0; k < n; k++)
+        *out++ = get(literal_start + k);
+      literal_start += n;
+    }
+  };
+
+  while (i < size) {
+    uint8_t value = get(i);
+    size_t run = runLength(get, i, std::min(size - i, kMaxRun), value);
+
+    if (run >= kMinRun) {
+      flushLiteral(i);
+      *out++ = (uint8_t)(run + 125);
+      *out++ = value;
+      i += run;
+      literal_start = i;
+    } else {
+      i += run;
+    }
+  }
+  flushLiteral(size);
+  return out - dst;
+}
+
+}  // namespace
+
+size_t screenRLEBound(size_t size) {
+  return size + (size + kMaxLiteral - 1) / kMaxLiteral;
+}
+
+size_t encodeScreenRLE(const uint8_t* screen, const uint8_t* reference,
+                       size_t size, uint8_t* dst) {
+  if (reference == NULL)
+    return encodeRuns(size, PlainBytes{screen}, dst);
+  return encodeRuns(size, XorBytes{screen, reference}, dst);
+}
+
+size_t decodeScreenRLE(const uint8_t* src, size_t src_size, uint8_t* screen,
+                       size_t size, bool delta) {
+  const uint8_t* in = src;
+  const uint8_t* end = src + src_size;
+  size_t pos = 0;
+
+  while (in < end) {
+    uint8_t control = *in++;
+    if (control < kMaxLiteral) {
+      size_t n = control + 1;
+      if ((size_t)(end - in) < n || size - pos < n)
+        return 0;
+      if (delta) {
+        for (size_t k = 0; k < n; k++)
+          screen[pos + k] ^= in[k];
+      } else {
+        std::memcpy(screen + pos, in, n);
+      }
+      in += n;
+      pos += n;
+    } else {
+      size_t n = control - 125;
+      if (in == end || size - pos < n)
+        return 0;
+      uint8_t value = *in++;
+      if (delta) {
+        // Runs of zeros leave the reference as it is
+        if (value != 0) {
+          for (size_t k = 0; k < n; k++)
+            screen[pos + k] ^= value;
+        }
+      } else {
+        std::memset(screen + pos, value, n);
+      }
+      pos += n;
+    }
+  }
+  return pos == size ? (size_t)(in - src) : 0;
+}
+
+}  // namespace ale
@@ -0,0 +1,73 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  ScreenCodec.hpp
+ *
+ *  Compact encodings of palette-indexed screens for sending or storing.
+ **************************************************************************** */
+
+#ifndef __SCREEN_CODEC_HPP__
+#define __SCREEN_CODEC_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ale {
+
+/* Delta encoding: a bitmap of (height + 7) / 8 bytes in which bit (row % 8)
+ * of byte (row / 8) marks a row that changed, followed by the width bytes of
+ * every changed row, top to bottom. Decoding it over the screen it was
+ * computed against gives the new screen. */
+
+/** Largest possible size of a delta-encoded screen (every row changed). */
+size_t screenDeltaBound(int width, int height);
+
+/** Sets the bits of changed_rows ((height + 7) / 8 bytes) of the rows in
+ *  which screen differs from reference, clearing the others. */
+void findChangedRows(const uint8_t* screen, const uint8_t* reference,
+                     int width, int height, uint8_t* changed_rows);
+
+/** Writes the delta encoding of the given rows of screen into dst, which
+ *  must hold screenDeltaBound() bytes, and returns its size. */
+size_t encodeScreenDelta(const uint8_t* screen, const uint8_t* changed_rows,
+                         int width, int height, uint8_t* dst);
+
+/** Applies the size-byte delta in src to screen. Returns the number of
+ *  bytes read, or 0 if src is shorter than the rows it lists (screen may
+ *  then be partly updated). */
+size_t decodeScreenDelta(const uint8_t* src, size_t size, int width,
+                         int height, uint8_t* screen);
+
+/* Run-length encoding: a sequence of tokens, each a control byte c followed
+ * by either c + 1 literal bytes (c < 128) or one byte repeated
+ * c - 125 times (c >= 128, runs of 3 to 130). Runs continue across rows.
+ * The delta variant encodes the screen XORed with a reference screen, so
+ * unchanged pixels become runs of zeros; decoding XORs the result into a
+ * copy of the reference. */
+
+/** Largest possible size of the run-length encoding of size bytes. */
+size_t screenRLEBound(size_t size);
+
+/** Run-length encodes size bytes of screen into dst, which must hold
+ *  screenRLEBound(size) bytes, and returns the encoded size. If reference is
+ *  not NULL, encodes screen XOR reference instead. */
+size_t encodeScreenRLE(const uint8_t* screen, const uint8_t* reference,
+                       size_t size, uint8_t* dst);
+
+/** Decodes src_size bytes of run-length encoding into the size bytes of
+ *  screen; with delta, XORs them into screen, which must hold the reference.
+ *  Returns the number of bytes read, or 0 if src is malformed or does not
+ *  decode to exactly size bytes. */
+size_t decodeScreenRLE(const uint8_t* src, size_t src_size, uint8_t* screen,
+                       size_t size, bool delta);
+
+}  // namespace ale
+
+#endif  // __SCREEN_CODEC_HPP__
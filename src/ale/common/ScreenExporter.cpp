@@ -18,6 +18,7 @@
 
 #include <zlib.h>
 #include <cassert>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <string>
@@ -25,14 +26,18 @@
 #include <iomanip>
 
 #include "ale/common/Log.hpp"
+#include "ale/common/MemoryUsage.hpp"
 
 namespace ale {
 
+// Frame buffers in the pool per encoder thread: one being encoded and one queued
+static const int BUFFERS_PER_THREAD = 2;
+
 // MGB: These methods originally belonged to ExportScreen. Possibly these should be returned to
 // their own class, rather than be static methods. They are here to avoid exposing the gritty
 // details of PNG generation.
-static void writePNGChunk(std::ofstream& out, const char* type, uint8_t* data,
-                          int size) {
+static void appendPNGChunk(std::vector<uint8_t>& out, const char* type,
+                           const uint8_t* data, int size) {
   // Stuff the length/type into the buffer
   uint8_t temp[8];
   temp[0] = size >> 24;
@@ -45,12 +50,12 @@ static void writePNGChunk(std::ofstream& out, const char* type, uint8_t* data,
   temp[7] = type[3];
 
   // Write the header
-  out.write((const char*)temp, 8);
+  out.insert(out.end(), temp, temp + 8);
 
   // Append the actual data
   uint32_t crc = crc32(0, temp + 4, 4);
   if (size > 0) {
-    out.write((const char*)data, size);
+    out.insert(out.end(), data, data + size);
     crc = crc32(crc, data, size);
   }
 
@@ -59,16 +64,14 @@ static void writePNGChunk(std::ofstream& out, const char* type, uint8_t* data,
   temp[1] = crc >> 16;
   temp[2] = crc >> 8;
   temp[3] = crc;
-  out.write((const char*)temp, 4);
+  out.insert(out.end(), temp, temp + 4);
 }
 
-static void writePNGHeader(std::ofstream& out, const ALEScreen& screen,
-                           bool doubleWidth = true) {
-  int width = doubleWidth ? screen.width() * 2 : screen.width();
-  int height = screen.height();
+static void appendPNGHeader(std::vector<uint8_t>& out, int width, int height,
+                            bool indexed) {
   // PNG file header
   uint8_t header[8] = {137, 80, 78, 71, 13, 10, 26, 10};
-  out.write((const char*)header, sizeof(header));
+  out.insert(out.end(), header, header + sizeof(header));
 
   // PNG IHDR
   uint8_t ihdr[13];
@@ -80,82 +83,119 @@ static void writePNGHeader(std::ofstream& out, const ALEScreen& screen,
   ihdr[5] = (height >> 16) & 0xFF;
   ihdr[6] = (height >> 8) & 0xFF;
   ihdr[7] = (height >> 0) & 0xFF;
-  ihdr[8] = 8;  // 8 bits per sample (24 bits per pixel)
-  ihdr[9] = 2;  // PNG_COLOR_TYPE_RGB
+  ihdr[8] = 8;  // 8 bits per sample (24 bits per pixel, or a palette index)
+  ihdr[9] = indexed ? 3 : 2;  // PNG_COLOR_TYPE_PALETTE or PNG_COLOR_TYPE_RGB
   ihdr[10] = 0; // PNG_COMPRESSION_TYPE_DEFAULT
   ihdr[11] = 0; // PNG_FILTER_TYPE_DEFAULT
   ihdr[12] = 0; // PNG_INTERLACE_NONE
-  writePNGChunk(out, "IHDR", ihdr, sizeof(ihdr));
+  appendPNGChunk(out, "IHDR", ihdr, sizeof(ihdr));
 }
 
-static void writePNGData(std::ofstream& out, const ALEScreen& screen,
-                         const ColourPalette& palette,
-                         bool doubleWidth = true) {
-  int dataWidth = screen.width();
-  int width = doubleWidth ? dataWidth * 2 : dataWidth;
-  int height = screen.height();
-
-  // If so desired, double the width
-
-  // Fill the buffer with scanline data
-  int rowbytes = width * 3;
+static void appendPNGPalette(std::vector<uint8_t>& out,
+                             const ColourPalette& palette) {
+  uint8_t plte[256 * 3];
+  for (int i = 0; i < 256; i++) {
+    // Odd indices never appear on screen; they hold the grayscale entries
+    uint32_t rgb = palette.getRGB(i);
+    plte[i * 3 + 0] = (uint8_t)(rgb >> 16);
+    plte[i * 3 + 1] = (uint8_t)(rgb >> 8);
+    plte[i * 3 + 2] = (uint8_t)rgb;
+  }
+  appendPNGChunk(out, "PLTE", plte, sizeof(plte));
+}
 
-  std::vector<uint8_t> buffer((rowbytes + 1) * height, 0);
-  uint8_t* buf_ptr = &buffer[0];
+// Fills rows with the filtered scanlines of the width * height pixels, each
+// pixel doubled in width, as palette indices or RGB
+static void fillPNGRows(std::vector<uint8_t>& rows, const uint8_t* pixels,
+                        int dataWidth, int height,
+                        const ColourPalette& palette, bool indexed) {
+  int width = dataWidth * 2;
+  int rowbytes = indexed ? width : width * 3;
+  rows.resize((size_t)(rowbytes + 1) * height);
+  uint8_t* buf_ptr = &rows[0];
 
   for (int i = 0; i < height; i++) {
     *buf_ptr++ = 0; // first byte of row is filter type
-    for (int j = 0; j < dataWidth; j++) {
-      int r, g, b;
-
-      palette.getRGB(screen.getArray()[i * dataWidth + j], r, g, b);
-      // Double the pixel width, if so desired
-      int jj = doubleWidth ? 2 * j : j;
-
-      buf_ptr[jj * 3 + 0] = r;
-      buf_ptr[jj * 3 + 1] = g;
-      buf_ptr[jj * 3 + 2] = b;
-
-      if (doubleWidth) {
-        jj = jj + 1;
-
-        buf_ptr[jj * 3 + 0] = r;
-        buf_ptr[jj * 3 + 1] = g;
-        buf_ptr[jj * 3 + 2] = b;
+    const uint8_t* row = pixels + (size_t)i * dataWidth;
+    if (indexed) {
+      for (int j = 0; j < dataWidth; j++) {
+        buf_ptr[2 * j] = row[j];
+        buf_ptr[2 * j + 1] = row[j];
+      }
+    } else {
+      for (int j = 0; j < dataWidth; j++) {
+        int r, g, b;
+        palette.getRGB(row[j], r, g, b);
+        uint8_t* px = buf_ptr + j * 6;
+        px[0] = px[3] = r;
+        px[1] = px[4] = g;
+        px[2] = px[5] = b;
       }
     }
     buf_ptr += rowbytes; // add pitch
   }
+}
 
-  // Compress the data with zlib
-  uLongf compmemsize = (uLongf)((height * (width + 1) * 3 + 1) + 12);
-  std::vector<uint8_t> compmem(compmemsize, 0);
+ScreenExporter::ScreenExporter(ColourPalette& palette)
+    : m_palette(palette), m_frame_number(0), m_frame_field_width(6),
+      m_indexed(false), m_compression_level(Z_DEFAULT_COMPRESSION),
+      m_busy(0), m_stopping(false) {}
 
-  if ((compress(&compmem[0], &compmemsize, &buffer[0],
-                height * (width * 3 + 1)) != Z_OK)) {
+ScreenExporter::ScreenExporter(ColourPalette& palette, const std::string& path,
+                               int num_threads, bool indexed,
+                               int compression_level)
+    : m_palette(palette), m_frame_number(0), m_frame_field_width(6),
+      m_path(path), m_indexed(indexed), m_compression_level(compression_level),
+      m_busy(0), m_stopping(false) {
+  if (num_threads > 0) {
+    m_buffers.resize(num_threads * BUFFERS_PER_THREAD);
+    for (int i = (int)m_buffers.size() - 1; i >= 0; i--)
+      m_free_buffers.push_back(i);
+    for (int i = 0; i < num_threads; i++)
+      m_threads.push_back(std::thread(&ScreenExporter::encoderLoop, this));
+  }
+}
+
+ScreenExporter::~ScreenExporter() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_job_ready.notify_all();
+  for (size_t i = 0; i < m_threads.size(); i++)
+    m_threads[i].join();
+}
+
+void ScreenExporter::encode(const uint8_t* pixels, int width, int height,
+                            Scratch& scratch) const {
+  fillPNGRows(scratch.rows, pixels, width, height, m_palette, m_indexed);
+
+  // Compress the data with zlib
+  uLongf compmemsize = compressBound((uLong)scratch.rows.size());
+  scratch.compressed.resize(compmemsize);
+  if (compress2(&scratch.compressed[0], &compmemsize, &scratch.rows[0],
+                (uLong)scratch.rows.size(), m_compression_level) != Z_OK) {
     // @todo -- throw a proper exception
     Logger::Error << "Error: Couldn't compress PNG\n";
+    scratch.png.clear();
     return;
   }
 
+  std::vector<uint8_t>& png = scratch.png;
+  png.clear();
+  appendPNGHeader(png, width * 2, height, m_indexed);
+  if (m_indexed)
+    appendPNGPalette(png, m_palette);
   // Write the compressed framebuffer data
-  writePNGChunk(out, "IDAT", &compmem[0], compmemsize);
-}
-
-static void writePNGEnd(std::ofstream& out) {
+  appendPNGChunk(png, "IDAT", &scratch.compressed[0], (int)compmemsize);
   // Finish up
-  writePNGChunk(out, "IEND", 0, 0);
+  appendPNGChunk(png, "IEND", 0, 0);
 }
 
-ScreenExporter::ScreenExporter(ColourPalette& palette)
-    : m_palette(palette), m_frame_number(0), m_frame_field_width(6) {}
-
-ScreenExporter::ScreenExporter(ColourPalette& palette, const std::string& path)
-    : m_palette(palette), m_frame_number(0), m_frame_field_width(6),
-      m_path(path) {}
+void ScreenExporter::write(const std::string& filename, const Scratch& scratch) {
+  if (scratch.png.empty())
+    return;
 
-void ScreenExporter::save(const ALEScreen& screen,
-                          const std::string& filename) const {
   // Open file for writing
   std::ofstream out(filename.c_str(), std::ios_base::binary);
   if (!out.good()) {
@@ -163,13 +203,23 @@ void ScreenExporter::save(const ALEScreen& screen,
     Logger::Error << "Could not open " << filename << " for writing\n";
     return;
   }
+  out.write((const char*)&scratch.png[0], scratch.png.size());
+  out.close();
+}
 
-  // Now write the PNG proper
-  writePNGHeader(out, screen, true);
-  writePNGData(out, screen, m_palette, true);
-  writePNGEnd(out);
+void ScreenExporter::save(const ALEScreen& screen,
+                          const std::string& filename) const {
+  Scratch scratch;
+  encode(screen.getArray(), screen.width(), screen.height(), scratch);
+  write(filename, scratch);
+}
 
-  out.close();
+std::string ScreenExporter::frameFilename(int frame_number) const {
+  // Construct the filename from basepath & current frame number
+  std::ostringstream oss;
+  oss << m_path << "/" << std::setw(m_frame_field_width) << std::setfill('0')
+      << frame_number << ".png";
+  return oss.str();
 }
 
 void ScreenExporter::saveNext(const ALEScreen& screen) {
@@ -179,15 +229,77 @@ void ScreenExporter::saveNext(const ALEScreen& screen) {
   // MGB: It would be nice here to automagically create paths, but the only way I know of
   // doing this cleanly is via boost, which we don't include.
 
-  // Construct the filename from basepath & current frame number
-  std::ostringstream oss;
-  oss << m_path << "/" << std::setw(m_frame_field_width) << std::setfill('0')
-      << m_frame_number << ".png";
+  if (m_threads.empty()) {
+    // Save the png
+    encode(screen.getArray(), screen.width(), screen.height(), m_scratch);
+    write(frameFilename(m_frame_number), m_scratch);
+    m_frame_number++;
+    return;
+  }
 
-  // Save the png
-  save(screen, oss.str());
+  // Wait for a free buffer rather than queueing without bound
+  int buffer;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_free_buffers.empty())
+      m_buffer_free.wait(lock);
+    buffer = m_free_buffers.back();
+    m_free_buffers.pop_back();
+  }
 
+  size_t size = screen.arraySize();
+  m_buffers[buffer].resize(size);
+  std::memcpy(&m_buffers[buffer][0], screen.getArray(), size);
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Job job = {m_frame_number, buffer, (int)screen.width(), (int)screen.height()};
+    m_jobs.push_back(job);
+  }
+  m_job_ready.notify_one();
   m_frame_number++;
 }
 
+void ScreenExporter::flush() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_jobs.empty() || m_busy > 0)
+    m_buffer_free.wait(lock);
+}
+
+void ScreenExporter::encoderLoop() {
+  Scratch scratch;
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    while (m_jobs.empty() && !m_stopping)
+      m_job_ready.wait(lock);
+    // Queued frames are still written when stopping
+    if (m_jobs.empty())
+      return;
+
+    Job job = m_jobs.front();
+    m_jobs.pop_front();
+    m_busy++;
+    lock.unlock();
+
+    encode(&m_buffers[job.buffer][0], job.width, job.height, scratch);
+    write(frameFilename(job.frame_number), scratch);
+
+    lock.lock();
+    m_busy--;
+    m_free_buffers.push_back(job.buffer);
+    m_buffer_free.notify_all();
+  }
+}
+
+size_t ScreenExporter::memoryUsage() const {
+  size_t bytes = sizeof(*this) + MemoryUsage::heapBytes(m_path) +
+                 m_scratch.rows.capacity() + m_scratch.compressed.capacity() +
+                 m_scratch.png.capacity() +
+                 m_buffers.capacity() * sizeof(m_buffers[0]) +
+                 m_threads.capacity() * sizeof(std::thread);
+  for (size_t i = 0; i < m_buffers.size(); i++)
+    bytes += m_buffers[i].capacity();
+  return bytes;
+}
+
 }  // namespace ale
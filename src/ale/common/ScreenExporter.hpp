@@ -17,7 +17,13 @@
 #ifndef __SCREEN_EXPORTER_HPP__
 #define __SCREEN_EXPORTER_HPP__
 
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "ale/common/Constants.h"
 #include "ale/common/ColourPalette.hpp"
@@ -31,8 +37,18 @@ class ScreenExporter {
   ScreenExporter(ColourPalette& palette);
 
   /** Creates a new ScreenExporter which will save frames successively in the directory provided.
-   *  Frames are sequentially named with 6 digits, starting at 000000. */
-  ScreenExporter(ColourPalette& palette, const std::string& path);
+   *  Frames are sequentially named with 6 digits, starting at 000000.
+   *
+   *  With num_threads > 0, saveNext() only copies the palette-indexed frame into one of a
+   *  fixed pool of buffers, and that many background threads encode and write the PNGs;
+   *  when every buffer is waiting to be written, saveNext() waits for one to free up.
+   *  indexed writes 8-bit palette PNGs instead of RGB ones, and compression_level is
+   *  zlib's (-1 for its default, 1 for the fastest). */
+  ScreenExporter(ColourPalette& palette, const std::string& path, int num_threads = 0,
+                 bool indexed = false, int compression_level = -1);
+
+  /** Writes the frames still queued before returning. */
+  ~ScreenExporter();
 
   /** Save the given screen to the given filename. No paths are created. */
   void save(const ALEScreen& screen, const std::string& filename) const;
@@ -40,7 +56,39 @@ class ScreenExporter {
   /** Save the given screen according to our own internal numbering. */
   void saveNext(const ALEScreen& screen);
 
+  /** Waits until every frame given to saveNext() is written. */
+  void flush();
+
+  /** Bytes of memory held, including the exporter itself. */
+  size_t memoryUsage() const;
+
  private:
+  /** A frame waiting for an encoder thread. */
+  struct Job {
+    int frame_number;
+    int buffer;  // Index into m_buffers
+    int width, height;
+  };
+
+  /** Buffers an encoder thread reuses from one frame to the next. */
+  struct Scratch {
+    std::vector<uint8_t> rows;        // Filtered scanlines
+    std::vector<uint8_t> compressed;  // Deflated scanlines
+    std::vector<uint8_t> png;         // The whole file
+  };
+
+  /** Encodes the width * height palette-indexed pixels as a PNG in scratch.png. */
+  void encode(const uint8_t* pixels, int width, int height, Scratch& scratch) const;
+
+  /** Writes scratch.png to filename. */
+  static void write(const std::string& filename, const Scratch& scratch);
+
+  /** Filename of the given frame in m_path. */
+  std::string frameFilename(int frame_number) const;
+
+  /** Body of the encoder threads. */
+  void encoderLoop();
+
   ColourPalette& m_palette;
 
   /** The next frame number. */
@@ -51,6 +99,26 @@ class ScreenExporter {
 
   /** The directory where we save successive frames. */
   std::string m_path;
+
+  /** Whether PNGs are palette-indexed rather than RGB. */
+  bool m_indexed;
+
+  /** zlib compression level. */
+  int m_compression_level;
+
+  /** Scratch buffers of saveNext() without encoder threads. */
+  Scratch m_scratch;
+
+  /** Encoder threads, and the pool of frame buffers they take their frames from. */
+  std::vector<std::thread> m_threads;
+  std::vector<std::vector<uint8_t> > m_buffers;
+  std::vector<int> m_free_buffers;  // Buffers saveNext() may fill
+  std::deque<Job> m_jobs;           // Frames waiting for an encoder, oldest first
+  int m_busy;                       // Frames being encoded
+  bool m_stopping;
+  std::mutex m_mutex;
+  std::condition_variable m_job_ready;    // Signals the encoder threads
+  std::condition_variable m_buffer_free;  // Signals saveNext() and flush()
 };
 
 }  // namespace ale
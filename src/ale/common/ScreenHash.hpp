@@ -0,0 +1,68 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  ScreenHash.hpp
+ *
+ *  64-bit hash of palette-indexed screens, built from per-row hashes so the
+ *  TIA can hash each row as it draws it.
+ **************************************************************************** */
+
+#ifndef __SCREEN_HASH_HPP__
+#define __SCREEN_HASH_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace ale {
+
+/** Hash of a screen with no rows, the start value for combineRowHash(). */
+const uint64_t kScreenHashSeed = 0x9e3779b97f4a7c15ULL;
+
+/** Hashes one row of width pixels, eight at a time. */
+inline uint64_t hashScreenRow(const uint8_t* row, size_t width) {
+  uint64_t h = kScreenHashSeed ^ width;
+  size_t i = 0;
+  for (; i + 8 <= width; i += 8) {
+    uint64_t w;
+    std::memcpy(&w, row + i, 8);
+    h = (h ^ w) * 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 31;
+  }
+  if (i < width) {
+    uint64_t w = 0;
+    std::memcpy(&w, row + i, width - i);
+    h = (h ^ w) * 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 31;
+  }
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  return h;
+}
+
+/** Folds the hash of the next row (top to bottom) into a screen hash. */
+inline uint64_t combineRowHash(uint64_t hash, uint64_t row_hash) {
+  hash = ((hash << 5) | (hash >> 59)) ^ row_hash;
+  return hash * 0x94d049bb133111ebULL;
+}
+
+/** Hashes a whole screen; gives the same value as ALEInterface::getScreenHash()
+ *  for the same pixels. */
+inline uint64_t hashScreen(const uint8_t* screen, size_t width, size_t height) {
+  uint64_t hash = kScreenHashSeed;
+  for (size_t row = 0; row < height; row++)
+    hash = combineRowHash(hash, hashScreenRow(screen + row * width, width));
+  return hash;
+}
+
+}  // namespace ale
+
+#endif  // __SCREEN_HASH_HPP__
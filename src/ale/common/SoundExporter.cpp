@@ -2,6 +2,8 @@
 
 #include <cassert>
 
+#include "ale/common/MemoryUsage.hpp"
+
 namespace ale {
 namespace sound {
 
@@ -32,6 +34,11 @@ void SoundExporter::addSamples(SampleType* s, int len) {
   }
 }
 
+size_t SoundExporter::memoryUsage() const {
+  return sizeof(*this) + MemoryUsage::heapBytes(m_filename) +
+         m_data.capacity() * sizeof(SampleType);
+}
+
 void SoundExporter::writeWAVData() {
   // Taken from http://stackoverflow.com/questions/22226872/two-problems-when-writing-to-wav-c
   // Open file stream
@@ -47,6 +47,9 @@ class SoundExporter {
   /** Adds a buffer of samples. */
   void addSamples(SampleType* s, int len);
 
+  /** Bytes of memory held, including the exporter itself. */
+  size_t memoryUsage() const;
+
  private:
   /** Writes the data to disk. */
   void writeWAVData();
@@ -153,6 +153,17 @@ class SoundNull : public stella::Sound
       */
     virtual void process(uint8_t* buffer, uint32_t samples) { }
 
+    /**
+      * Answers the number of bytes of memory owned by the sound device,
+      * including the object itself
+      */
+    virtual size_t memoryUsage() const { return sizeof(*this); }
+
+    /**
+      * Answers true: the null device ignores everything it is given
+      */
+    virtual bool isNull() const { return true; }
+
 public:
     /**
       Loads the current state of this device from the given Deserializer.
@@ -31,7 +31,9 @@ SoundRaw::SoundRaw(Settings* settings)
   : Sound(settings),
     myIsEnabled(settings->getBool("sound_obs")),
     myIsInitializedFlag(false),
-    myLastRegisterSetCycle(0)
+    myLastRegisterSetCycle(0),
+    myRegWriteHead(0),
+    myRegWriteCount(0)
 {
 }
 
@@ -59,7 +61,7 @@ void SoundRaw::initialize()
   }
 
   // Make sure the sound queue is clear
-  myRegWriteQueue.clear();
+  myRegWriteHead = myRegWriteCount = 0;
   myTIASound.reset();
 
   myLastRegisterSetCycle = 0;
@@ -95,7 +97,7 @@ void SoundRaw::reset()
   {
     myLastRegisterSetCycle = 0;
     myTIASound.reset();
-    myRegWriteQueue.clear();
+    myRegWriteHead = myRegWriteCount = 0;
   }
 }
 
@@ -108,10 +110,21 @@ void SoundRaw::adjustCycleCounter(int amount)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void SoundRaw::set(uint16_t addr, uint8_t value, int cycle)
 {
-  TIARegister info;
+  // A full queue hands its oldest write to the TIASound at once.  Writes
+  // only latch register values, so the samples come out the same
+  if(myRegWriteCount == RegisterQueueSize)
+  {
+    TIARegister& oldest = myRegWriteQueue[myRegWriteHead];
+    myTIASound.set(oldest.addr, oldest.value);
+    myRegWriteHead = (myRegWriteHead + 1) % RegisterQueueSize;
+    --myRegWriteCount;
+  }
+
+  TIARegister& info =
+      myRegWriteQueue[(myRegWriteHead + myRegWriteCount) % RegisterQueueSize];
   info.addr = addr;
   info.value = value;
-  myRegWriteQueue.push_back(info);
+  ++myRegWriteCount;
 
   // Update last cycle counter to the current cycle
   myLastRegisterSetCycle = cycle;
@@ -122,17 +135,22 @@ void SoundRaw::process(uint8_t* buffer, uint32_t samples)
 {
   // Process all the audio register updates up to this frame
   // Set audio registers
-  uint32_t regSize = myRegWriteQueue.size();
-  for(uint32_t i = 0; i < regSize; ++i) {
-    TIARegister& info = myRegWriteQueue.front();
+  for(uint32_t i = 0; i < myRegWriteCount; ++i) {
+    TIARegister& info = myRegWriteQueue[(myRegWriteHead + i) % RegisterQueueSize];
     myTIASound.set(info.addr, info.value);
-    myRegWriteQueue.pop_front();
   }
+  myRegWriteHead = myRegWriteCount = 0;
 
   // Process audio registers
   myTIASound.process(buffer, samples);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t SoundRaw::memoryUsage() const
+{
+  return sizeof(*this);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool SoundRaw::load(Deserializer& in)
 {
@@ -157,7 +175,7 @@ bool SoundRaw::load(Deserializer& in)
     // Make sure to empty the queue of previous sound fragments
     if(myIsInitializedFlag)
     {
-      myRegWriteQueue.clear();
+      myRegWriteHead = myRegWriteCount = 0;
       myTIASound.set(0x15, reg1);
       myTIASound.set(0x16, reg2);
       myTIASound.set(0x17, reg3);
@@ -30,7 +30,6 @@ class Deserializer;
 
 #include "ale/emucore/Sound.hxx"
 #include "ale/emucore/TIASnd.hxx"
-#include <deque>
 
 namespace ale {
 
@@ -45,6 +44,12 @@ class SoundRaw : public stella::Sound
     // a default display rate of 60 FPS, we can expect 512 samples per frame.
     static constexpr int SamplesPerFrame = 512;
 
+    // Rate of the generated samples, taking 60 frames per second
+    static constexpr int SampleRate = SamplesPerFrame * 60;
+
+    // Capacity of the queue of TIA register writes waiting for process()
+    static constexpr int RegisterQueueSize = 1024;
+
     /**
       Create a new sound object.  The init method must be invoked before
       using the object.
@@ -156,6 +161,12 @@ class SoundRaw : public stella::Sound
       */
     virtual void process(uint8_t* buffer, uint32_t samples);
 
+    /**
+      * Answers the number of bytes of memory owned by the sound device,
+      * including the object itself
+      */
+    virtual size_t memoryUsage() const;
+
 public:
     /**
       Loads the current state of this device from the given Deserializer.
@@ -194,8 +205,11 @@ private:
     // Indicates the cycle when a sound register was last set
     int myLastRegisterSetCycle;
 
-    // Queue of TIA register writes
-    std::deque<TIARegister> myRegWriteQueue;
+    // Ring buffer of TIA register writes, holding myRegWriteCount writes
+    // starting at myRegWriteHead
+    TIARegister myRegWriteQueue[RegisterQueueSize];
+    uint32_t myRegWriteHead;
+    uint32_t myRegWriteCount;
 };
 
 }  // namespace ale
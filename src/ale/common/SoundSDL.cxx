@@ -169,6 +169,15 @@ void SoundSDL::close()
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t SoundSDL::memoryUsage() const
+{
+  size_t bytes = sizeof(*this) + myRegWriteQueue.capacity() * sizeof(RegWrite);
+  if(mySoundExporter)
+    bytes += mySoundExporter->memoryUsage();
+  return bytes;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool SoundSDL::isSuccessfullyInitialized() const
 {
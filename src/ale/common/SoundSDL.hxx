@@ -158,6 +158,12 @@ class SoundSDL : public stella::Sound
       */
     void process(uint8_t* buffer, uint32_t samples) { }
 
+    /**
+      * Answers the number of bytes of memory owned by the sound device,
+      * including the object itself
+      */
+    size_t memoryUsage() const;
+
   public:
     /**
       Loads the current state of this device from the given Deserializer.
@@ -247,6 +253,13 @@ class SoundSDL : public stella::Sound
         */
         uint32_t size() const;
 
+        /**
+          Answers the number of items the queue can hold without growing.
+
+          @return The capacity of the queue.
+        */
+        uint32_t capacity() const { return myCapacity; }
+
       private:
         // Increase the size of the queue
         void grow();
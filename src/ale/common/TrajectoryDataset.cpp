@@ -0,0 +1,367 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  TrajectoryDataset.cpp
+ *
+ *  Columnar files of transitions for offline learning, written as they are
+ *  played and read back through a memory mapping.
+ **************************************************************************** */
+
+#include "ale/common/TrajectoryDataset.hpp"
+
+#if defined(WIN32)
+  #include <windows.h>
+  #include <io.h>
+  #define SyncFile(f) _commit(_fileno(f))
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+  #define SyncFile(f) fsync(fileno(f))
+#endif
+
+#include <zlib.h>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace ale {
+
+static const char HEADER_MAGIC[8] = {'A', 'L', 'E', 'T', 'R', 'A', 'J', 0};
+static const char TRAILER_MAGIC[8] = {'A', 'L', 'E', 'T', 'R', 'J', 'I', 'X'};
+static const uint32_t VERSION = 1;
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+static const uint64_t ALIGNMENT = 64;
+
+static_assert(sizeof(TrajectoryHeader) == 64, "TrajectoryHeader must be 64 bytes");
+static_assert(sizeof(TrajectoryBlock) == 64, "TrajectoryBlock must be 64 bytes");
+static_assert(sizeof(TrajectoryTrailer) == 32, "TrajectoryTrailer must be 32 bytes");
+
+TrajectoryFrames TrajectoryDatasetWriter::parseFrames(const std::string& name) {
+  if (name == "none")
+    return TRAJECTORY_FRAMES_NONE;
+  if (name == "raw")
+    return TRAJECTORY_FRAMES_RAW;
+  if (name == "zlib")
+    return TRAJECTORY_FRAMES_ZLIB;
+  throw std::runtime_error("Unknown dataset_frames '" + name +
+                           "' (expected none, raw or zlib)");
+}
+
+TrajectoryDatasetWriter::TrajectoryDatasetWriter(const std::string& directory,
+                                                 TrajectoryFrames frames,
+                                                 int block_records,
+                                                 int file_blocks,
+                                                 int sync_blocks,
+                                                 int compression_level)
+    : m_directory(directory),
+      m_frames(frames),
+      m_block_records(block_records > 0 ? block_records : 1),
+      m_file_blocks(file_blocks > 0 ? file_blocks : 1),
+      m_sync_blocks(sync_blocks),
+      m_compression_level(compression_level),
+      m_file_number(0), m_file(NULL), m_offset(0), m_unsynced_blocks(0),
+      m_records(0) {
+  std::memset(&m_header, 0, sizeof(m_header));
+}
+
+TrajectoryDatasetWriter::~TrajectoryDatasetWriter() {
+  try {
+    close();
+  } catch (const std::exception&) {
+    // Nothing more can be done about a failing write here
+  }
+}
+
+void TrajectoryDatasetWriter::open(int width, int height, int ram_size) {
+  std::ostringstream filename;
+  filename << m_directory << "/trajectory_" << std::setw(6) << std::setfill('0')
+           << m_file_number++ << ".ald";
+  m_file = std::fopen(filename.str().c_str(), "wb");
+  if (m_file == NULL)
+    throw std::runtime_error("Could not open " + filename.str() + " for writing");
+  m_offset = 0;
+  m_blocks.clear();
+  m_unsynced_blocks = 0;
+
+  std::memcpy(m_header.magic, HEADER_MAGIC, sizeof(HEADER_MAGIC));
+  m_header.version = VERSION;
+  m_header.byte_order = BYTE_ORDER_MARK;
+  m_header.width = width;
+  m_header.height = height;
+  m_header.ram_size = ram_size;
+  m_header.frames = m_frames;
+  m_header.block_records = m_block_records;
+  write(&m_header, sizeof(m_header));
+
+  // The columns of a block are filled in place, record by record
+  size_t frame_size = m_frames == TRAJECTORY_FRAMES_NONE ? 0 : (size_t)width * height;
+  m_action.resize(m_block_records);
+  m_reward.resize(m_block_records);
+  m_terminal.resize(m_block_records);
+  m_lives.resize(m_block_records);
+  m_ram.resize((size_t)m_block_records * ram_size);
+  m_frame.resize((size_t)m_block_records * frame_size);
+}
+
+void TrajectoryDatasetWriter::addRecord(const uint8_t* frame, int width,
+                                        int height, int action, int reward,
+                                        int terminal, int lives,
+                                        const uint8_t* ram, int ram_size) {
+  if (m_file == NULL)
+    open(width, height, ram_size);
+
+  size_t frame_size = (size_t)m_header.width * m_header.height;
+  m_action[m_records] = action;
+  m_reward[m_records] = reward;
+  m_terminal[m_records] = terminal;
+  m_lives[m_records] = lives;
+  std::memcpy(&m_ram[(size_t)m_records * m_header.ram_size], ram, m_header.ram_size);
+  if (m_frames != TRAJECTORY_FRAMES_NONE)
+    std::memcpy(&m_frame[m_records * frame_size], frame, frame_size);
+
+  if (++m_records == m_block_records) {
+    flushBlock();
+    if ((int)m_blocks.size() == m_file_blocks)
+      close();
+  }
+}
+
+void TrajectoryDatasetWriter::write(const void* data, size_t size) {
+  if (size > 0 && std::fwrite(data, 1, size, m_file) != size)
+    throw std::runtime_error("Could not write a trajectory dataset file");
+  m_offset += size;
+}
+
+void TrajectoryDatasetWriter::align() {
+  static const uint8_t zeros[ALIGNMENT] = {0};
+  write(zeros, (ALIGNMENT - m_offset % ALIGNMENT) % ALIGNMENT);
+}
+
+void TrajectoryDatasetWriter::sync() {
+  if (std::fflush(m_file) != 0 || SyncFile(m_file) != 0)
+    throw std::runtime_error("Could not flush a trajectory dataset file");
+  m_unsynced_blocks = 0;
+}
+
+void TrajectoryDatasetWriter::flushBlock() {
+  if (m_records == 0)
+    return;
+
+  TrajectoryBlock block;
+  std::memset(&block, 0, sizeof(block));
+  block.records = m_records;
+
+  align();
+  block.action = m_offset;
+  write(&m_action[0], m_records * sizeof(int32_t));
+  align();
+  block.reward = m_offset;
+  write(&m_reward[0], m_records * sizeof(int32_t));
+  align();
+  block.terminal = m_offset;
+  write(&m_terminal[0], m_records);
+  align();
+  block.lives = m_offset;
+  write(&m_lives[0], m_records * sizeof(int32_t));
+  align();
+  block.ram = m_offset;
+  write(m_ram.data(), (size_t)m_records * m_header.ram_size);
+
+  size_t frames_size = (size_t)m_records * m_header.width * m_header.height;
+  align();
+  block.frames = m_offset;
+  if (m_frames == TRAJECTORY_FRAMES_RAW) {
+    block.frames_size = frames_size;
+    write(&m_frame[0], frames_size);
+  } else if (m_frames == TRAJECTORY_FRAMES_ZLIB) {
+    uLongf compressed_size = compressBound(frames_size);
+    m_compressed.resize(compressed_size);
+    if (compress2(&m_compressed[0], &compressed_size, &m_frame[0], frames_size,
+                  m_compression_level) != Z_OK)
+      throw std::runtime_error("Could not compress a trajectory dataset block");
+    block.frames_size = compressed_size;
+    write(&m_compressed[0], compressed_size);
+  }
+
+  m_blocks.push_back(block);
+  m_records = 0;
+  if (m_sync_blocks > 0 && ++m_unsynced_blocks >= m_sync_blocks)
+    sync();
+}
+
+void TrajectoryDatasetWriter::close() {
+  if (m_file == NULL)
+    return;
+
+  try {
+    flushBlock();
+
+    TrajectoryTrailer trailer;
+    std::memset(&trailer, 0, sizeof(trailer));
+    align();
+    trailer.footer_offset = m_offset;
+    for (size_t b = 0; b < m_blocks.size(); b++)
+      trailer.records += m_blocks[b].records;
+    trailer.blocks = m_blocks.size();
+    std::memcpy(trailer.magic, TRAILER_MAGIC, sizeof(TRAILER_MAGIC));
+    write(m_blocks.data(), m_blocks.size() * sizeof(TrajectoryBlock));
+    write(&trailer, sizeof(trailer));
+    sync();
+  } catch (...) {
+    std::fclose(m_file);
+    m_file = NULL;
+    m_records = 0;
+    throw;
+  }
+
+  int failed = std::fclose(m_file);
+  m_file = NULL;
+  if (failed != 0)
+    throw std::runtime_error("Could not close a trajectory dataset file");
+}
+
+size_t TrajectoryDatasetWriter::memoryUsage() const {
+  return sizeof(*this) + m_blocks.capacity() * sizeof(TrajectoryBlock) +
+         (m_action.capacity() + m_reward.capacity() + m_lives.capacity()) *
+             sizeof(int32_t) +
+         m_terminal.capacity() + m_ram.capacity() + m_frame.capacity() +
+         m_compressed.capacity();
+}
+
+TrajectoryDatasetReader::TrajectoryDatasetReader(const std::string& filename)
+    : m_data(NULL), m_size(0), m_mapping(NULL) {
+#if defined(WIN32)
+  HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE)
+    throw std::runtime_error("Could not open " + filename);
+  LARGE_INTEGER size;
+  if (GetFileSizeEx(file, &size))
+    m_size = (size_t)size.QuadPart;
+  if (m_size > 0)
+    m_mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  CloseHandle(file);
+  if (m_mapping != NULL)
+    m_data = (const uint8_t*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+  if (m_data == NULL) {
+    if (m_mapping != NULL)
+      CloseHandle(m_mapping);
+    throw std::runtime_error("Could not map " + filename);
+  }
+#else
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error("Could not open " + filename);
+  struct stat st;
+  if (fstat(fd, &st) == 0)
+    m_size = st.st_size;
+  void* data = m_size > 0 ? mmap(NULL, m_size, PROT_READ, MAP_SHARED, fd, 0)
+                          : MAP_FAILED;
+  ::close(fd);
+  if (data == MAP_FAILED)
+    throw std::runtime_error("Could not map " + filename);
+  m_data = (const uint8_t*)data;
+#endif
+
+  const char* error = checkLayout();
+  if (error != NULL) {
+    unmap();
+    throw std::runtime_error(filename + error);
+  }
+}
+
+const char* TrajectoryDatasetReader::checkLayout() {
+  m_header = column<TrajectoryHeader>(0);
+  if (m_size < sizeof(TrajectoryHeader) + sizeof(TrajectoryTrailer) ||
+      std::memcmp(m_header->magic, HEADER_MAGIC, sizeof(HEADER_MAGIC)) != 0)
+    return " is not a trajectory dataset";
+  if (m_header->version != VERSION || m_header->byte_order != BYTE_ORDER_MARK ||
+      m_header->frames > TRAJECTORY_FRAMES_ZLIB)
+    return " was written by another version or machine";
+
+  m_trailer = column<TrajectoryTrailer>(m_size - sizeof(TrajectoryTrailer));
+  if (std::memcmp(m_trailer->magic, TRAILER_MAGIC, sizeof(TRAILER_MAGIC)) != 0)
+    return " is truncated";
+  uint64_t footer_end = m_size - sizeof(TrajectoryTrailer);
+  if (m_trailer->footer_offset % ALIGNMENT != 0 ||
+      m_trailer->footer_offset > footer_end ||
+      m_trailer->blocks !=
+          (footer_end - m_trailer->footer_offset) / sizeof(TrajectoryBlock))
+    return " has a damaged index";
+
+  // Every column of every block lies in order between the header and the footer
+  m_blocks = column<TrajectoryBlock>(m_trailer->footer_offset);
+  uint64_t records = 0;
+  uint64_t frame_size = (uint64_t)m_header->width * m_header->height;
+  for (size_t b = 0; b < numBlocks(); b++) {
+    const TrajectoryBlock& block = m_blocks[b];
+    uint64_t n = block.records;
+    records += n;
+    uint64_t frames_size =
+        m_header->frames == TRAJECTORY_FRAMES_RAW ? n * frame_size
+        : m_header->frames == TRAJECTORY_FRAMES_NONE ? 0 : block.frames_size;
+    if (n == 0 || n > m_header->block_records ||
+        (n < m_header->block_records && b + 1 < numBlocks()) ||
+        block.action % ALIGNMENT != 0 || block.reward % ALIGNMENT != 0 ||
+        block.lives % ALIGNMENT != 0 ||
+        block.action < sizeof(TrajectoryHeader) ||
+        block.action + n * sizeof(int32_t) > block.reward ||
+        block.reward + n * sizeof(int32_t) > block.terminal ||
+        block.terminal + n > block.lives ||
+        block.lives + n * sizeof(int32_t) > block.ram ||
+        block.ram + n * m_header->ram_size > block.frames ||
+        block.frames_size != frames_size ||
+        block.frames + block.frames_size > m_trailer->footer_offset)
+      return " has a damaged index";
+  }
+  if (records != m_trailer->records)
+    return " has a damaged index";
+  return NULL;
+}
+
+TrajectoryDatasetReader::~TrajectoryDatasetReader() {
+  unmap();
+}
+
+void TrajectoryDatasetReader::unmap() {
+#if defined(WIN32)
+  UnmapViewOfFile(m_data);
+  CloseHandle(m_mapping);
+#else
+  munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+}
+
+const uint8_t* TrajectoryDatasetReader::rawFrames(size_t b) const {
+  if (frames() != TRAJECTORY_FRAMES_RAW)
+    return NULL;
+  return column<uint8_t>(m_blocks[b].frames);
+}
+
+void TrajectoryDatasetReader::readFrames(size_t b, uint8_t* frames) const {
+  const TrajectoryBlock& block = m_blocks[b];
+  uLongf size = (uLongf)block.records * width() * height();
+  if (this->frames() == TRAJECTORY_FRAMES_RAW) {
+    std::memcpy(frames, rawFrames(b), size);
+  } else if (this->frames() == TRAJECTORY_FRAMES_ZLIB) {
+    uLongf expected = size;
+    if (uncompress(frames, &size, column<uint8_t>(block.frames),
+                   block.frames_size) != Z_OK ||
+        size != expected)
+      throw std::runtime_error("Damaged trajectory dataset block");
+  } else {
+    throw std::runtime_error("The trajectory dataset has no frames");
+  }
+}
+
+}  // namespace ale
@@ -0,0 +1,209 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  TrajectoryDataset.hpp
+ *
+ *  Columnar files of transitions for offline learning, written as they are
+ *  played and read back through a memory mapping.
+ **************************************************************************** */
+
+#ifndef __TRAJECTORY_DATASET_HPP__
+#define __TRAJECTORY_DATASET_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace ale {
+
+/* File layout, in the byte order of the machine that wrote it (checked by the
+ * reader), so that columns can be used in place:
+ *
+ *   header   a TrajectoryHeader (64 bytes)
+ *   blocks   up to block_records records each, stored column by column, every
+ *            column starting on a 64-byte boundary:
+ *              action    int32   (-1 for the first observation of an episode)
+ *              reward    int32
+ *              terminal  uint8   (1 game over, 2 truncated, else 0)
+ *              lives     int32
+ *              ram       ram_size bytes per record
+ *              frames    width * height palette indices per record, raw, or
+ *                        all of the block's in one zlib stream, or absent
+ *   footer   one TrajectoryBlock per block
+ *   trailer  a TrajectoryTrailer (32 bytes)
+ *
+ * Every block but the last of a file is full, so record r of a file is in
+ * block r / block_records. A file whose writer did not close it has no
+ * trailer and cannot be read. */
+
+/** How the frames column is stored. */
+enum TrajectoryFrames {
+  TRAJECTORY_FRAMES_NONE = 0,
+  TRAJECTORY_FRAMES_RAW = 1,
+  TRAJECTORY_FRAMES_ZLIB = 2,
+};
+
+struct TrajectoryHeader {
+  char magic[8];  // "ALETRAJ"
+  uint32_t version;
+  uint32_t byte_order;  // 0x01020304 as written
+  uint32_t width, height, ram_size;
+  uint32_t frames;  // TrajectoryFrames
+  uint32_t block_records;
+  uint8_t reserved[28];
+};
+
+/** Where the columns of a block are, as file offsets. */
+struct TrajectoryBlock {
+  uint32_t records;
+  uint32_t reserved;
+  uint64_t action, reward, terminal, lives, ram, frames;
+  uint64_t frames_size;  // Bytes of the frames column
+};
+
+struct TrajectoryTrailer {
+  uint64_t footer_offset;
+  uint64_t records;
+  uint32_t blocks;
+  uint32_t reserved;
+  char magic[8];  // "ALETRJIX"
+};
+
+/** Appends transitions to numbered files trajectory_NNNNNN.ald in a
+ *  directory, starting the next file every file_blocks blocks. */
+class TrajectoryDatasetWriter {
+ public:
+  /** Parses "none", "raw" or "zlib"; throws std::runtime_error otherwise. */
+  static TrajectoryFrames parseFrames(const std::string& name);
+
+  /** Every sync_blocks blocks (0: only when a file is closed) the file is
+   *  flushed to disk, so a crash loses at most that many blocks of a file
+   *  that is then left without its index. compression_level is zlib's. */
+  TrajectoryDatasetWriter(const std::string& directory, TrajectoryFrames frames,
+                          int block_records = 256, int file_blocks = 64,
+                          int sync_blocks = 1, int compression_level = 1);
+
+  /** Closes the open file. */
+  ~TrajectoryDatasetWriter();
+
+  /** Appends a record. frame (width * height palette indices) is ignored
+   *  without a frames column; the dimensions must not change while a file is
+   *  open. Throws std::runtime_error if a file cannot be written. */
+  void addRecord(const uint8_t* frame, int width, int height, int action,
+                 int reward, int terminal, int lives, const uint8_t* ram,
+                 int ram_size);
+
+  /** Writes the buffered records and the index, and closes the file; the
+   *  next record starts a new one. */
+  void close();
+
+  /** Bytes of memory held, including the writer itself. */
+  size_t memoryUsage() const;
+
+ private:
+  /** Creates the next numbered file and writes its header. */
+  void open(int width, int height, int ram_size);
+
+  /** Writes the buffered records as a block. */
+  void flushBlock();
+
+  /** Writes size bytes at the end of the file. */
+  void write(const void* data, size_t size);
+
+  /** Pads the file with zeros to the next 64-byte boundary. */
+  void align();
+
+  /** Flushes the file through to the disk. */
+  void sync();
+
+  std::string m_directory;
+  TrajectoryFrames m_frames;
+  int m_block_records;
+  int m_file_blocks;
+  int m_sync_blocks;
+  int m_compression_level;
+  int m_file_number;       // Number of the next file
+  FILE* m_file;            // NULL between files
+  uint64_t m_offset;       // Bytes written to m_file
+  TrajectoryHeader m_header;
+  std::vector<TrajectoryBlock> m_blocks;  // Index of the open file
+  int m_unsynced_blocks;
+
+  // Columns of the records not yet written
+  int m_records;
+  std::vector<int32_t> m_action, m_reward, m_lives;
+  std::vector<uint8_t> m_terminal, m_ram, m_frame;
+  std::vector<uint8_t> m_compressed;
+};
+
+/** Maps a file written by TrajectoryDatasetWriter into memory; the columns
+ *  are pointers into the mapping, valid as long as the reader. */
+class TrajectoryDatasetReader {
+ public:
+  /** Throws std::runtime_error if filename is not a complete dataset file. */
+  explicit TrajectoryDatasetReader(const std::string& filename);
+  ~TrajectoryDatasetReader();
+
+  TrajectoryDatasetReader(const TrajectoryDatasetReader&) = delete;
+  TrajectoryDatasetReader& operator=(const TrajectoryDatasetReader&) = delete;
+
+  int width() const { return m_header->width; }
+  int height() const { return m_header->height; }
+  int ramSize() const { return m_header->ram_size; }
+  TrajectoryFrames frames() const { return (TrajectoryFrames)m_header->frames; }
+  size_t blockRecords() const { return m_header->block_records; }
+  size_t numRecords() const { return m_trailer->records; }
+  size_t numBlocks() const { return m_trailer->blocks; }
+
+  /** The index entry of block b, for its record count. */
+  const TrajectoryBlock& block(size_t b) const { return m_blocks[b]; }
+
+  /** Columns of block b, one entry per record. */
+  const int32_t* actions(size_t b) const { return column<int32_t>(m_blocks[b].action); }
+  const int32_t* rewards(size_t b) const { return column<int32_t>(m_blocks[b].reward); }
+  const uint8_t* terminals(size_t b) const { return column<uint8_t>(m_blocks[b].terminal); }
+  const int32_t* lives(size_t b) const { return column<int32_t>(m_blocks[b].lives); }
+  const uint8_t* ram(size_t b) const { return column<uint8_t>(m_blocks[b].ram); }
+
+  /** The raw frames of block b, or NULL unless frames() is
+   *  TRAJECTORY_FRAMES_RAW. */
+  const uint8_t* rawFrames(size_t b) const;
+
+  /** Copies (or decompresses) the frames of block b into frames, which holds
+   *  block(b).records * width * height bytes; throws std::runtime_error
+   *  without a frames column or for a damaged block. */
+  void readFrames(size_t b, uint8_t* frames) const;
+
+ private:
+  /** Points the header, trailer and index into the mapping; returns what is
+   *  wrong with the file, or NULL if every column lies within it. */
+  const char* checkLayout();
+
+  /** Releases the mapping. */
+  void unmap();
+
+  template <typename T>
+  const T* column(uint64_t offset) const {
+    return reinterpret_cast<const T*>(m_data + offset);
+  }
+
+  const uint8_t* m_data;  // The mapped file
+  size_t m_size;
+  void* m_mapping;        // Handle of the mapping (Windows only)
+  const TrajectoryHeader* m_header;
+  const TrajectoryTrailer* m_trailer;
+  const TrajectoryBlock* m_blocks;
+};
+
+}  // namespace ale
+
+#endif  // __TRAJECTORY_DATASET_HPP__
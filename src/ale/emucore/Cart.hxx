@@ -83,7 +83,7 @@ class Cartridge : public Device
     bool save(std::ofstream& out);
 
     /** MGB: Added to drop warning on overloaded save() method. */
-    virtual bool save(Serializer& out) = 0;
+    using Device::save;
 
     /**
       Lock/unlock bankswitching capability.
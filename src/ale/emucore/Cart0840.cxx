@@ -42,6 +42,12 @@ const char* Cartridge0840::name() const
   return "Cartridge0840";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t Cartridge0840::memoryUsage() const
+{
+  return sizeof(*this);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Cartridge0840::reset()
 {
@@ -63,6 +69,29 @@ void Cartridge0840::poke(uint16_t address, uint8_t value)
 {
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t Cartridge0840::stateSize() const
+{
+  return 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge0840::bindState(uint8_t*)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateWriter Cartridge0840::stateWriter() const
+{
+  return 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Cartridge0840::loadState(Deserializer&, int)
+{
+  return false;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge0840::save(Serializer& out)
 {
@@ -63,6 +63,14 @@ class Cartridge0840 : public Cartridge
     */
     virtual const char* name() const;
 
+    /**
+      Answers the number of bytes of memory owned by the device, including
+      the device object itself
+
+      @return The number of bytes
+    */
+    virtual size_t memoryUsage() const;
+
     /**
       Reset device to its power-on state
     */
@@ -76,6 +84,40 @@ class Cartridge0840 : public Cartridge
     */
     virtual void install(System& system);
 
+    /**
+      Answers the number of bytes of the state block of the cartridge.
+
+      @return The size of the state block
+    */
+    virtual size_t stateSize() const;
+
+    /**
+      Moves the state block of the cartridge to the given stateSize() bytes
+      of the machine state.
+
+      @param state The bytes to move the block to
+    */
+    virtual void bindState(uint8_t* state);
+
+    /**
+      Answers the function writing the state block of the cartridge to a
+      saved state in the portable format.
+
+      @return The null pointer, as there is no state block
+    */
+    virtual StateWriter stateWriter() const;
+
+    /**
+      Reads the state block of the cartridge from a saved state in the given
+      version of the portable format.
+
+      @param in The deserializer device to load from.
+      @param version The version of the format
+      @return False, as loading a state isn't supported for this
+              cartridge
+    */
+    virtual bool loadState(Deserializer& in, int version);
+
     /**
       Saves the current state of this device to the given Serializer.
 
@@ -19,8 +19,6 @@
 #include <cassert>
 
 #include "ale/emucore/System.hxx"
-#include "ale/emucore/Serializer.hxx"
-#include "ale/emucore/Deserializer.hxx"
 #include "ale/emucore/Cart2K.hxx"
 
 namespace ale {
@@ -47,6 +45,12 @@ const char* Cartridge2K::name() const
   return "Cartridge2K";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t Cartridge2K::memoryUsage() const
+{
+  return sizeof(*this);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Cartridge2K::reset()
 {
@@ -87,49 +91,25 @@ void Cartridge2K::poke(uint16_t, uint8_t)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge2K::save(Serializer& out)
+size_t Cartridge2K::stateSize() const
 {
-  std::string cart = name();
-
-  try
-  {
-    out.putString(cart);
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in save state for " << cart << std::endl;
-    return false;
-  }
-
-  return true;
+  return 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge2K::load(Deserializer& in)
+void Cartridge2K::bindState(uint8_t*)
 {
-  std::string cart = name();
+}
 
-  try
-  {
-    if(in.getString() != cart)
-      return false;
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in load state for " << cart << std::endl;
-    return false;
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateWriter Cartridge2K::stateWriter() const
+{
+  return 0;
+}
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Cartridge2K::loadState(Deserializer&, int)
+{
   return true;
 }
 
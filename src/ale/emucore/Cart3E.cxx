@@ -53,12 +53,18 @@ const char* Cartridge3E::name() const
   return "Cartridge3E";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t Cartridge3E::memoryUsage() const
+{
+  return sizeof(*this) + mySize;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Cartridge3E::reset()
 {
   // Initialize RAM with random values
   for(uint32_t i = 0; i < 32768; ++i)
-    myRam[i] = mySystem->rng().next();
+    myState->myRam[i] = mySystem->rng().next();
 
   // We'll map bank 0 into the first segment upon reset
   bank(0);
@@ -106,10 +112,10 @@ uint8_t Cartridge3E::peek(uint16_t address)
 
   if(address < 0x0800)
   {
-    if(myCurrentBank < 256)
-      return myImage[(address & 0x07FF) + myCurrentBank * 2048];
+    if(myState->myCurrentBank < 256)
+      return myImage[(address & 0x07FF) + myState->myCurrentBank * 2048];
     else
-      return myRam[(address & 0x03FF) + (myCurrentBank - 256) * 1024];
+      return myState->myRam[(address & 0x03FF) + (myState->myCurrentBank - 256) * 1024];
   }
   else
   {
@@ -141,68 +147,58 @@ void Cartridge3E::poke(uint16_t address, uint8_t value)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge3E::save(Serializer& out)
+size_t Cartridge3E::stateSize() const
 {
-  std::string cart = name();
-
-  try
-  {
-    out.putString(cart);
-    out.putInt(myCurrentBank);
+  return sizeof(Cartridge3EState);
+}
 
-    // Output RAM
-    out.putInt(32768);
-    for(uint32_t addr = 0; addr < 32768; ++addr)
-      out.putInt(myRam[addr]);
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in save state for " << cart << std::endl;
-    return false;
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge3E::bindState(uint8_t* state)
+{
+  myState.bind(state);
+}
 
-  return true;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateWriter Cartridge3E::stateWriter() const
+{
+  return &writeState;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge3E::load(Deserializer& in)
+void Cartridge3E::writeState(const uint8_t* block, Serializer& out)
 {
-  std::string cart = name();
+  const Cartridge3EState* state =
+      reinterpret_cast<const Cartridge3EState*>(block);
 
-  try
-  {
-    if(in.getString() != cart)
-      return false;
+  out.putInt(state->myCurrentBank);
 
-    myCurrentBank = (uint16_t) in.getInt();
+  // The 32K of RAM
+  out.putInt(32768);
+  for(uint32_t i = 0; i < 32768; ++i)
+    out.putInt(state->myRam[i]);
+}
 
-    // Input RAM
-    uint32_t limit = (uint32_t) in.getInt();
-    for(uint32_t addr = 0; addr < limit; ++addr)
-      myRam[addr] = (uint8_t) in.getInt();
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in load state for " << cart << std::endl;
-    return false;
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Cartridge3E::loadState(Deserializer& in, int)
+{
+  myState->myCurrentBank = (uint16_t) in.getInt();
 
-  // Now, go to the current bank
-  bank(myCurrentBank);
+  // The 32K of RAM
+  if((uint32_t) in.getInt() != 32768)
+    return false;
+  for(uint32_t i = 0; i < 32768; ++i)
+    myState->myRam[i] = (uint8_t) in.getInt();
 
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge3E::stateRestored()
+{
+  // Now, go to the current bank
+  bank(myState->myCurrentBank);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Cartridge3E::bank(uint16_t bank)
 {
@@ -213,16 +209,16 @@ void Cartridge3E::bank(uint16_t bank)
     // Make sure the bank they're asking for is reasonable
     if((uint32_t)bank * 2048 < mySize)
     {
-      myCurrentBank = bank;
+      myState->myCurrentBank = bank;
     }
     else
     {
       // Oops, the bank they're asking for isn't valid so let's wrap it
       // around to a valid bank number
-      myCurrentBank = bank % (mySize / 2048);
+      myState->myCurrentBank = bank % (mySize / 2048);
     }
 
-    uint32_t offset = myCurrentBank * 2048;
+    uint32_t offset = myState->myCurrentBank * 2048;
     uint16_t shift = mySystem->pageShift();
 
     // Setup the page access methods for the current bank
@@ -241,7 +237,7 @@ void Cartridge3E::bank(uint16_t bank)
   {
     bank -= 256;
     bank %= 32;
-    myCurrentBank = bank + 256;
+    myState->myCurrentBank = bank + 256;
 
     uint32_t offset = bank * 1024;
     uint16_t shift = mySystem->pageShift();
@@ -255,7 +251,7 @@ void Cartridge3E::bank(uint16_t bank)
     // Map read-port RAM image into the system
     for(address = 0x1000; address < 0x1400; address += (1 << shift))
     {
-      access.directPeekBase = &myRam[offset + (address & 0x03FF)];
+      access.directPeekBase = &myState->myRam[offset + (address & 0x03FF)];
       mySystem->setPageAccess(address >> shift, access);
     }
 
@@ -264,7 +260,7 @@ void Cartridge3E::bank(uint16_t bank)
     // Map write-port RAM image into the system
     for(address = 0x1400; address < 0x1800; address += (1 << shift))
     {
-      access.directPokeBase = &myRam[offset + (address & 0x03FF)];
+      access.directPokeBase = &myState->myRam[offset + (address & 0x03FF)];
       mySystem->setPageAccess(address >> shift, access);
     }
   }
@@ -273,7 +269,7 @@ void Cartridge3E::bank(uint16_t bank)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int Cartridge3E::bank()
 {
-  return myCurrentBank;
+  return myState->myCurrentBank;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -288,10 +284,10 @@ bool Cartridge3E::patch(uint16_t address, uint8_t value)
   address = address & 0x0FFF;
   if(address < 0x0800)
   {
-    if(myCurrentBank < 256)
-      myImage[(address & 0x07FF) + myCurrentBank * 2048] = value;
+    if(myState->myCurrentBank < 256)
+      myImage[(address & 0x07FF) + myState->myCurrentBank * 2048] = value;
     else
-      myRam[(address & 0x03FF) + (myCurrentBank - 256) * 1024] = value;
+      myState->myRam[(address & 0x03FF) + (myState->myCurrentBank - 256) * 1024] = value;
   }
   else
   {
@@ -23,8 +23,6 @@ namespace ale {
 namespace stella {
 
 class System;
-class Serializer;
-class Deserializer;
 
 }  // namespace stella
 }  // namespace ale
@@ -34,6 +32,19 @@ class Deserializer;
 namespace ale {
 namespace stella {
 
+/**
+  The bank switching state and RAM of the cartridge, kept apart from the
+  ROM image so that they can be saved and restored as one block.
+*/
+struct Cartridge3EState
+{
+  // Indicates which bank is currently active for the first segment
+  uint16_t myCurrentBank;
+
+  // RAM contents. For now every ROM gets all 32K of potential RAM
+  uint8_t myRam[32768];
+};
+
 /**
   This is the cartridge class for Tigervision's bankswitched
   games with RAM (basically, 3F plus up to 32K of RAM). This
@@ -94,6 +105,14 @@ class Cartridge3E : public Cartridge
     */
     virtual const char* name() const;
 
+    /**
+      Answers the number of bytes of memory owned by the device, including
+      the device object itself
+
+      @return The number of bytes
+    */
+    virtual size_t memoryUsage() const;
+
     /**
       Reset device to its power-on state
     */
@@ -108,20 +127,43 @@ class Cartridge3E : public Cartridge
     virtual void install(System& system);
 
     /**
-      Saves the current state of this device to the given Serializer.
+      Answers the number of bytes of the state block of the cartridge.
+
+      @return The size of the state block
+    */
+    virtual size_t stateSize() const;
+
+    /**
+      Moves the state block of the cartridge to the given stateSize() bytes
+      of the machine state.
 
-      @param out The serializer device to save to.
-      @return The result of the save.  True on success, false on failure.
+      @param state The bytes to move the block to
     */
-    virtual bool save(Serializer& out);
+    virtual void bindState(uint8_t* state);
 
     /**
-      Loads the current state of this device from the given Deserializer.
+      Answers the function writing the state block of the cartridge to a
+      saved state in the portable format.
+
+      @return The writer of the state block
+    */
+    virtual StateWriter stateWriter() const;
+
+    /**
+      Reads the state block of the cartridge from a saved state in the given
+      version of the portable format.
 
       @param in The deserializer device to load from.
+      @param version The version of the format
       @return The result of the load.  True on success, false on failure.
     */
-    virtual bool load(Deserializer& in);
+    virtual bool loadState(Deserializer& in, int version);
+
+    /**
+      Notification method invoked by the system right after it has
+      overwritten the machine state with a saved one.
+    */
+    virtual void stateRestored();
 
     /**
       Install pages for the specified bank in the system.
@@ -176,17 +218,18 @@ class Cartridge3E : public Cartridge
     virtual void poke(uint16_t address, uint8_t value);
 
   private:
-    // Indicates which bank is currently active for the first segment
-    uint16_t myCurrentBank;
-
     // Pointer to a dynamically allocated ROM image of the cartridge
     uint8_t* myImage;
 
-    // RAM contents. For now every ROM gets all 32K of potential RAM
-    uint8_t myRam[32768];
-
     // Size of the ROM image
     uint32_t mySize;
+
+  private:
+    // Writes a state block field by field
+    static void writeState(const uint8_t* block, Serializer& out);
+
+    // The bank switching state and RAM of the cartridge
+    StateView<Cartridge3EState> myState;
 };
 
 }  // namespace stella
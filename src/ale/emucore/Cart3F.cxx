@@ -53,6 +53,12 @@ const char* Cartridge3F::name() const
   return "Cartridge3F";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t Cartridge3F::memoryUsage() const
+{
+  return sizeof(*this) + mySize;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Cartridge3F::reset()
 {
@@ -103,7 +109,7 @@ uint8_t Cartridge3F::peek(uint16_t address)
 
   if(address < 0x0800)
   {
-    return myImage[(address & 0x07FF) + myCurrentBank * 2048];
+    return myImage[(address & 0x07FF) + myState->myCurrentBank * 2048];
   }
   else
   {
@@ -126,58 +132,47 @@ void Cartridge3F::poke(uint16_t address, uint8_t value)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge3F::save(Serializer& out)
+size_t Cartridge3F::stateSize() const
 {
-  std::string cart = name();
-
-  try
-  {
-    out.putString(cart);
-    out.putInt(myCurrentBank);
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in save state for " << cart << std::endl;
-    return false;
-  }
+  return sizeof(Cartridge3FState);
+}
 
-  return true;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge3F::bindState(uint8_t* state)
+{
+  myState.bind(state);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge3F::load(Deserializer& in)
+StateWriter Cartridge3F::stateWriter() const
 {
-  std::string cart = name();
+  return &writeState;
+}
 
-  try
-  {
-    if(in.getString() != cart)
-      return false;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge3F::writeState(const uint8_t* block, Serializer& out)
+{
+  const Cartridge3FState* state =
+      reinterpret_cast<const Cartridge3FState*>(block);
 
-    myCurrentBank = (uint16_t) in.getInt();
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in load state for " << cart << std::endl;
-    return false;
-  }
+  out.putInt(state->myCurrentBank);
+}
 
-  // Now, go to the current bank
-  bank(myCurrentBank);
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Cartridge3F::loadState(Deserializer& in, int)
+{
+  myState->myCurrentBank = (uint16_t) in.getInt();
 
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge3F::stateRestored()
+{
+  // Now, go to the current bank
+  bank(myState->myCurrentBank);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Cartridge3F::bank(uint16_t bank)
 {
@@ -186,16 +181,16 @@ void Cartridge3F::bank(uint16_t bank)
   // Make sure the bank they're asking for is reasonable
   if((uint32_t)bank * 2048 < mySize)
   {
-    myCurrentBank = bank;
+    myState->myCurrentBank = bank;
   }
   else
   {
     // Oops, the bank they're asking for isn't valid so let's wrap it
     // around to a valid bank number
-    myCurrentBank = bank % (mySize / 2048);
+    myState->myCurrentBank = bank % (mySize / 2048);
   }
 
-  uint32_t offset = myCurrentBank * 2048;
+  uint32_t offset = myState->myCurrentBank * 2048;
   uint16_t shift = mySystem->pageShift();
 
   // Setup the page access methods for the current bank
@@ -214,7 +209,7 @@ void Cartridge3F::bank(uint16_t bank)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int Cartridge3F::bank()
 {
-  return myCurrentBank;
+  return myState->myCurrentBank;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -229,7 +224,7 @@ bool Cartridge3F::patch(uint16_t address, uint8_t value)
   address = address & 0x0FFF;
   if(address < 0x0800)
   {
-    myImage[(address & 0x07FF) + myCurrentBank * 2048] = value;
+    myImage[(address & 0x07FF) + myState->myCurrentBank * 2048] = value;
   }
   else
   {
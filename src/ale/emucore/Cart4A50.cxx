@@ -42,6 +42,12 @@ const char* Cartridge4A50::name() const
   return "Cartridge4A50";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t Cartridge4A50::memoryUsage() const
+{
+  return sizeof(*this);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Cartridge4A50::reset()
 {
@@ -63,6 +69,29 @@ void Cartridge4A50::poke(uint16_t, uint8_t)
 {
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t Cartridge4A50::stateSize() const
+{
+  return 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge4A50::bindState(uint8_t*)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateWriter Cartridge4A50::stateWriter() const
+{
+  return 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Cartridge4A50::loadState(Deserializer&, int)
+{
+  return false;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge4A50::save(Serializer& out)
 {
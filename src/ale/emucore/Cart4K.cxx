@@ -19,8 +19,6 @@
 #include <cassert>
 
 #include "ale/emucore/System.hxx"
-#include "ale/emucore/Serializer.hxx"
-#include "ale/emucore/Deserializer.hxx"
 #include "ale/emucore/Cart4K.hxx"
 
 namespace ale {
@@ -47,6 +45,12 @@ const char* Cartridge4K::name() const
   return "Cartridge4K";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t Cartridge4K::memoryUsage() const
+{
+  return sizeof(*this);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Cartridge4K::reset()
 {
@@ -87,49 +91,25 @@ void Cartridge4K::poke(uint16_t, uint8_t)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge4K::save(Serializer& out)
+size_t Cartridge4K::stateSize() const
 {
-  std::string cart = name();
-
-  try
-  {
-    out.putString(cart);
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in save state for " << cart << std::endl;
-    return false;
-  }
-
-  return true;
+  return 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge4K::load(Deserializer& in)
+void Cartridge4K::bindState(uint8_t*)
 {
-  std::string cart = name();
+}
 
-  try
-  {
-    if(in.getString() != cart)
-      return false;
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in load state for " << cart << std::endl;
-    return false;
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateWriter Cartridge4K::stateWriter() const
+{
+  return 0;
+}
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Cartridge4K::loadState(Deserializer&, int)
+{
   return true;
 }
 
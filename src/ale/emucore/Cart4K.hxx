@@ -23,8 +23,6 @@ namespace ale {
 namespace stella {
 
 class System;
-class Serializer;
-class Deserializer;
 
 }  // namespace stella
 }  // namespace ale
@@ -64,6 +62,14 @@ class Cartridge4K : public Cartridge
     */
     virtual const char* name() const;
 
+    /**
+      Answers the number of bytes of memory owned by the device, including
+      the device object itself
+
+      @return The number of bytes
+    */
+    virtual size_t memoryUsage() const;
+
     /**
       Reset cartridge to its power-on state
     */
@@ -78,20 +84,37 @@ class Cartridge4K : public Cartridge
     virtual void install(System& system);
 
     /**
-      Saves the current state of this device to the given Serializer.
+      Answers the number of bytes of the state block of the cartridge.
+
+      @return The size of the state block
+    */
+    virtual size_t stateSize() const;
+
+    /**
+      Moves the state block of the cartridge to the given stateSize() bytes
+      of the machine state.
+
+      @param state The bytes to move the block to
+    */
+    virtual void bindState(uint8_t* state);
+
+    /**
+      Answers the function writing the state block of the cartridge to a
+      saved state in the portable format.
 
-      @param out The serializer device to save to.
-      @return The result of the save.  True on success, false on failure.
+      @return The null pointer, as there is no state block
     */
-    virtual bool save(Serializer& out);
+    virtual StateWriter stateWriter() const;
 
     /**
-      Loads the current state of this device from the given Deserializer.
+      Reads the state block of the cartridge from a saved state in the given
+      version of the portable format.
 
       @param in The deserializer device to load from.
+      @param version The version of the format
       @return The result of the load.  True on success, false on failure.
     */
-    virtual bool load(Deserializer& in);
+    virtual bool loadState(Deserializer& in, int version);
 
     /**
       Install pages for the specified bank in the system.
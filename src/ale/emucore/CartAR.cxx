@@ -54,20 +54,26 @@ const char* CartridgeAR::name() const
   return "CartridgeAR";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t CartridgeAR::memoryUsage() const
+{
+  return sizeof(*this) + myNumberOfLoadImages * 8448;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeAR::reset()
 {
   // Initialize RAM with random values
   for(uint32_t i = 0; i < 6 * 1024; ++i)
-    myImage[i] = mySystem->rng().next();
+    myState->myImage[i] = mySystem->rng().next();
 
-  myPower = true;
-  myPowerRomCycle = mySystem->cycles();
-  myWriteEnabled = false;
+  myState->myPower = true;
+  myState->myPowerRomCycle = mySystem->cycles();
+  myState->myWriteEnabled = false;
 
-  myDataHoldRegister = 0;
-  myNumberOfDistinctAccesses = 0;
-  myWritePending = false;
+  myState->myDataHoldRegister = 0;
+  myState->myNumberOfDistinctAccesses = 0;
+  myState->myWritePending = false;
 
   // Set bank configuration upon reset so ROM is selected and powered up
   bankConfiguration(0);
@@ -80,7 +86,7 @@ void CartridgeAR::systemCyclesReset()
   uint32_t cycles = mySystem->cycles();
 
   // Adjust cycle values
-  myPowerRomCycle -= cycles;
+  myState->myPowerRomCycle -= cycles;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -111,7 +117,7 @@ void CartridgeAR::install(System& system)
 uint8_t CartridgeAR::peek(uint16_t addr)
 {
   // Is the "dummy" SC BIOS hotspot for reading a load being accessed?
-  if(((addr & 0x1FFF) == 0x1850) && (myImageOffset[1] == (3 * 2048)))
+  if(((addr & 0x1FFF) == 0x1850) && (myState->myImageOffset[1] == (3 * 2048)))
   {
     // Get load that's being accessed (BIOS places load number at 0x80)
     uint8_t load = mySystem->peek(0x0080);
@@ -119,43 +125,43 @@ uint8_t CartridgeAR::peek(uint16_t addr)
     // Read the specified load into RAM
     loadIntoRAM(load);
 
-    return myImage[(addr & 0x07FF) + myImageOffset[1]];
+    return myState->myImage[(addr & 0x07FF) + myState->myImageOffset[1]];
   }
 
   // Cancel any pending write if more than 5 distinct accesses have occurred
   // TODO: Modify to handle when the distinct counter wraps around...
-  if(myWritePending &&
-      (my6502->distinctAccesses() > myNumberOfDistinctAccesses + 5))
+  if(myState->myWritePending &&
+      (my6502->distinctAccesses() > myState->myNumberOfDistinctAccesses + 5))
   {
-    myWritePending = false;
+    myState->myWritePending = false;
   }
 
   // Is the data hold register being set?
-  if(!(addr & 0x0F00) && (!myWriteEnabled || !myWritePending))
+  if(!(addr & 0x0F00) && (!myState->myWriteEnabled || !myState->myWritePending))
   {
-    myDataHoldRegister = addr;
-    myNumberOfDistinctAccesses = my6502->distinctAccesses();
-    myWritePending = true;
+    myState->myDataHoldRegister = addr;
+    myState->myNumberOfDistinctAccesses = my6502->distinctAccesses();
+    myState->myWritePending = true;
   }
   // Is the bank configuration hotspot being accessed?
   else if((addr & 0x1FFF) == 0x1FF8)
   {
     // Yes, so handle bank configuration
-    myWritePending = false;
-    bankConfiguration(myDataHoldRegister);
+    myState->myWritePending = false;
+    bankConfiguration(myState->myDataHoldRegister);
   }
   // Handle poke if writing enabled
-  else if(myWriteEnabled && myWritePending &&
-      (my6502->distinctAccesses() == (myNumberOfDistinctAccesses + 5)))
+  else if(myState->myWriteEnabled && myState->myWritePending &&
+      (my6502->distinctAccesses() == (myState->myNumberOfDistinctAccesses + 5)))
   {
     if((addr & 0x0800) == 0)
-      myImage[(addr & 0x07FF) + myImageOffset[0]] = myDataHoldRegister;
-    else if(myImageOffset[1] != 3 * 2048)    // Can't poke to ROM :-)
-      myImage[(addr & 0x07FF) + myImageOffset[1]] = myDataHoldRegister;
-    myWritePending = false;
+      myState->myImage[(addr & 0x07FF) + myState->myImageOffset[0]] = myState->myDataHoldRegister;
+    else if(myState->myImageOffset[1] != 3 * 2048)    // Can't poke to ROM :-)
+      myState->myImage[(addr & 0x07FF) + myState->myImageOffset[1]] = myState->myDataHoldRegister;
+    myState->myWritePending = false;
   }
 
-  return myImage[(addr & 0x07FF) + myImageOffset[(addr & 0x0800) ? 1 : 0]];
+  return myState->myImage[(addr & 0x07FF) + myState->myImageOffset[(addr & 0x0800) ? 1 : 0]];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -163,35 +169,35 @@ void CartridgeAR::poke(uint16_t addr, uint8_t)
 {
   // Cancel any pending write if more than 5 distinct accesses have occurred
   // TODO: Modify to handle when the distinct counter wraps around...
-  if(myWritePending &&
-      (my6502->distinctAccesses() > myNumberOfDistinctAccesses + 5))
+  if(myState->myWritePending &&
+      (my6502->distinctAccesses() > myState->myNumberOfDistinctAccesses + 5))
   {
-    myWritePending = false;
+    myState->myWritePending = false;
   }
 
   // Is the data hold register being set?
-  if(!(addr & 0x0F00) && (!myWriteEnabled || !myWritePending))
+  if(!(addr & 0x0F00) && (!myState->myWriteEnabled || !myState->myWritePending))
   {
-    myDataHoldRegister = addr;
-    myNumberOfDistinctAccesses = my6502->distinctAccesses();
-    myWritePending = true;
+    myState->myDataHoldRegister = addr;
+    myState->myNumberOfDistinctAccesses = my6502->distinctAccesses();
+    myState->myWritePending = true;
   }
   // Is the bank configuration hotspot being accessed?
   else if((addr & 0x1FFF) == 0x1FF8)
   {
     // Yes, so handle bank configuration
-    myWritePending = false;
-    bankConfiguration(myDataHoldRegister);
+    myState->myWritePending = false;
+    bankConfiguration(myState->myDataHoldRegister);
   }
   // Handle poke if writing enabled
-  else if(myWriteEnabled && myWritePending &&
-      (my6502->distinctAccesses() == (myNumberOfDistinctAccesses + 5)))
+  else if(myState->myWriteEnabled && myState->myWritePending &&
+      (my6502->distinctAccesses() == (myState->myNumberOfDistinctAccesses + 5)))
   {
     if((addr & 0x0800) == 0)
-      myImage[(addr & 0x07FF) + myImageOffset[0]] = myDataHoldRegister;
-    else if(myImageOffset[1] != 3 * 2048)    // Can't poke to ROM :-)
-      myImage[(addr & 0x07FF) + myImageOffset[1]] = myDataHoldRegister;
-    myWritePending = false;
+      myState->myImage[(addr & 0x07FF) + myState->myImageOffset[0]] = myState->myDataHoldRegister;
+    else if(myState->myImageOffset[1] != 3 * 2048)    // Can't poke to ROM :-)
+      myState->myImage[(addr & 0x07FF) + myState->myImageOffset[1]] = myState->myDataHoldRegister;
+    myState->myWritePending = false;
   }
 }
 
@@ -216,73 +222,73 @@ void CartridgeAR::bankConfiguration(uint8_t configuration)
   //  p = ROM Power (0 = enabled, 1 = off.)  Only power the ROM if you're
   //    wanting to access the ROM for multiloads.  Otherwise set to 1.
 
-  myCurrentBank = configuration & 0x1f; // remember for the bank() method
+  myState->myCurrentBank = configuration & 0x1f; // remember for the bank() method
 
   // Handle ROM power configuration
-  myPower = !(configuration & 0x01);
+  myState->myPower = !(configuration & 0x01);
 
-  if(myPower)
+  if(myState->myPower)
   {
-    myPowerRomCycle = mySystem->cycles();
+    myState->myPowerRomCycle = mySystem->cycles();
   }
 
-  myWriteEnabled = configuration & 0x02;
+  myState->myWriteEnabled = configuration & 0x02;
 
   switch((configuration >> 2) & 0x07)
   {
     case 0:
     {
-      myImageOffset[0] = 2 * 2048;
-      myImageOffset[1] = 3 * 2048;
+      myState->myImageOffset[0] = 2 * 2048;
+      myState->myImageOffset[1] = 3 * 2048;
       break;
     }
 
     case 1:
     {
-      myImageOffset[0] = 0 * 2048;
-      myImageOffset[1] = 3 * 2048;
+      myState->myImageOffset[0] = 0 * 2048;
+      myState->myImageOffset[1] = 3 * 2048;
       break;
     }
 
     case 2:
     {
-      myImageOffset[0] = 2 * 2048;
-      myImageOffset[1] = 0 * 2048;
+      myState->myImageOffset[0] = 2 * 2048;
+      myState->myImageOffset[1] = 0 * 2048;
       break;
     }
 
     case 3:
     {
-      myImageOffset[0] = 0 * 2048;
-      myImageOffset[1] = 2 * 2048;
+      myState->myImageOffset[0] = 0 * 2048;
+      myState->myImageOffset[1] = 2 * 2048;
       break;
     }
 
     case 4:
     {
-      myImageOffset[0] = 2 * 2048;
-      myImageOffset[1] = 3 * 2048;
+      myState->myImageOffset[0] = 2 * 2048;
+      myState->myImageOffset[1] = 3 * 2048;
       break;
     }
 
     case 5:
     {
-      myImageOffset[0] = 1 * 2048;
-      myImageOffset[1] = 3 * 2048;
+      myState->myImageOffset[0] = 1 * 2048;
+      myState->myImageOffset[1] = 3 * 2048;
       break;
     }
 
     case 6:
     {
-      myImageOffset[0] = 2 * 2048;
-      myImageOffset[1] = 1 * 2048;
+      myState->myImageOffset[0] = 2 * 2048;
+      myState->myImageOffset[1] = 1 * 2048;
       break;
     }
 
     case 7:
     {
-      myImageOffset[0] = 1 * 2048;
-      myImageOffset[1] = 2 * 2048;
+      myState->myImageOffset[0] = 1 * 2048;
+      myState->myImageOffset[1] = 2 * 2048;
       break;
     }
   }
@@ -341,20 +347,20 @@ void CartridgeAR::initializeROM(bool fastbios)
   // Initialize ROM with illegal 6502 opcode that causes a real 6502 to jam
   for(uint32_t i = 0; i < 2048; ++i)
   {
-    myImage[3 * 2048 + i] = 0x02;
+    myState->myImage[3 * 2048 + i] = 0x02;
   }
 
   // Copy the "dummy" Supercharger BIOS code into the ROM area
   for(uint32_t j = 0; j < size; ++j)
   {
-    myImage[3 * 2048 + j] = dummyROMCode[j];
+    myState->myImage[3 * 2048 + j] = dummyROMCode[j];
   }
 
   // Finally set 6502 vectors to point to initial load code at 0xF80A of BIOS
-  myImage[3 * 2048 + 2044] = 0x0A;
-  myImage[3 * 2048 + 2045] = 0xF8;
-  myImage[3 * 2048 + 2046] = 0x0A;
-  myImage[3 * 2048 + 2047] = 0xF8;
+  myState->myImage[3 * 2048 + 2044] = 0x0A;
+  myState->myImage[3 * 2048 + 2045] = 0xF8;
+  myState->myImage[3 * 2048 + 2046] = 0x0A;
+  myState->myImage[3 * 2048 + 2047] = 0xF8;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -382,22 +388,22 @@ void CartridgeAR::loadIntoRAM(uint8_t load)
     if(myLoadImages[(image * 8448) + 8192 + 5] == load)
     {
       // Copy the load's header
-      std::memcpy(myHeader, myLoadImages + (image * 8448) + 8192, 256);
+      std::memcpy(myState->myHeader, myLoadImages + (image * 8448) + 8192, 256);
 
       // Verify the load's header
-      if(checksum(myHeader, 8) != 0x55)
+      if(checksum(myState->myHeader, 8) != 0x55)
       {
         ale::Logger::Error << "WARNING: The Supercharger header checksum is invalid...\n";
       }
 
       // Load all of the pages from the load
       bool invalidPageChecksumSeen = false;
-      for(uint32_t j = 0; j < myHeader[3]; ++j)
+      for(uint32_t j = 0; j < myState->myHeader[3]; ++j)
       {
-        uint32_t bank = myHeader[16 + j] & 0x03;
-        uint32_t page = (myHeader[16 + j] >> 2) & 0x07;
+        uint32_t bank = myState->myHeader[16 + j] & 0x03;
+        uint32_t page = (myState->myHeader[16 + j] >> 2) & 0x07;
         uint8_t* src = myLoadImages + (image * 8448) + (j * 256);
-        uint8_t sum = checksum(src, 256) + myHeader[16 + j] + myHeader[64 + j];
+        uint8_t sum = checksum(src, 256) + myState->myHeader[16 + j] + myState->myHeader[64 + j];
 
         if(!invalidPageChecksumSeen && (sum != 0x55))
         {
@@ -408,15 +414,15 @@ void CartridgeAR::loadIntoRAM(uint8_t load)
         // Copy page to Supercharger RAM (don't allow a copy into ROM area)
         if(bank < 3)
         {
-          std::memcpy(myImage + (bank * 2048) + (page * 256), src, 256);
+          std::memcpy(myState->myImage + (bank * 2048) + (page * 256), src, 256);
         }
       }
 
       // Copy the bank switching byte and starting address into the 2600's
       // RAM for the "dummy" SC BIOS to access it
-      mySystem->poke(0xfe, myHeader[0]);
-      mySystem->poke(0xff, myHeader[1]);
-      mySystem->poke(0x80, myHeader[2]);
+      mySystem->poke(0xfe, myState->myHeader[0]);
+      mySystem->poke(0xff, myState->myHeader[1]);
+      mySystem->poke(0x80, myState->myHeader[2]);
 
       return;
     }
@@ -428,136 +434,117 @@ void CartridgeAR::loadIntoRAM(uint8_t load)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeAR::save(Serializer& out)
+size_t CartridgeAR::stateSize() const
 {
-  std::string cart = name();
+  return sizeof(CartridgeARState);
+}
 
-  try
-  {
-    uint32_t i;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeAR::bindState(uint8_t* state)
+{
+  myState.bind(state);
+}
 
-    out.putString(cart);
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateWriter CartridgeAR::stateWriter() const
+{
+  return &writeState;
+}
 
-    // Indicates the offest within the image for the corresponding bank
-    out.putInt(2);
-    for(i = 0; i < 2; ++i)
-      out.putInt(myImageOffset[i]);
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeAR::writeState(const uint8_t* block, Serializer& out)
+{
+  const CartridgeARState* state =
+      reinterpret_cast<const CartridgeARState*>(block);
 
-    // The 6K of RAM and 2K of ROM contained in the Supercharger
-    out.putInt(8192);
-    for(i = 0; i < 8192; ++i)
-      out.putInt(myImage[i]);
+  // Indicates the offest within the image for the corresponding bank
+  out.putInt(2);
+  for(uint32_t i = 0; i < 2; ++i)
+    out.putInt(state->myImageOffset[i]);
 
-    // The 256 byte header for the current 8448 byte load
-    out.putInt(256);
-    for(i = 0; i < 256; ++i)
-      out.putInt(myHeader[i]);
+  // The 6K of RAM and 2K of ROM contained in the Supercharger
+  out.putInt(8192);
+  for(uint32_t i = 0; i < 8192; ++i)
+    out.putInt(state->myImage[i]);
 
-    // All of the 8448 byte loads associated with the game
-    // Note that the size of this array is myNumberOfLoadImages * 8448
-    out.putInt(myNumberOfLoadImages * 8448);
-    for(i = 0; i < (uint32_t) myNumberOfLoadImages * 8448; ++i)
-      out.putInt(myLoadImages[i]);
+  // The 256 byte header for the current 8448 byte load
+  out.putInt(256);
+  for(uint32_t i = 0; i < 256; ++i)
+    out.putInt(state->myHeader[i]);
 
-    // Indicates how many 8448 loads there are
-    out.putInt(myNumberOfLoadImages);
+  // Indicates if the RAM is write enabled
+  out.putBool(state->myWriteEnabled);
 
-    // Indicates if the RAM is write enabled
-    out.putBool(myWriteEnabled);
+  // Indicates if the ROM's power is on or off
+  out.putBool(state->myPower);
 
-    // Indicates if the ROM's power is on or off
-    out.putBool(myPower);
+  // Indicates when the power was last turned on
+  out.putInt(state->myPowerRomCycle);
 
-    // Indicates when the power was last turned on
-    out.putInt(myPowerRomCycle);
+  // Data hold register used for writing
+  out.putInt(state->myDataHoldRegister);
 
-    // Data hold register used for writing
-    out.putInt(myDataHoldRegister);
+  // Indicates number of distinct accesses when data hold register was set
+  out.putInt(state->myNumberOfDistinctAccesses);
 
-    // Indicates number of distinct accesses when data hold register was set
-    out.putInt(myNumberOfDistinctAccesses);
+  // Indicates if a write is pending or not
+  out.putBool(state->myWritePending);
 
-    // Indicates if a write is pending or not
-    out.putBool(myWritePending);
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in save state for " << cart << std::endl;
-    return false;
-  }
-
-  return true;
+  // The bank configuration
+  out.putInt(state->myCurrentBank);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeAR::load(Deserializer& in)
+bool CartridgeAR::loadState(Deserializer& in, int version)
 {
-  std::string cart = name();
-
-  try
-  {
-    if(in.getString() != cart)
-      return false;
-
-    uint32_t i, limit;
-
-    // Indicates the offest within the image for the corresponding bank
-    limit = (uint32_t) in.getInt();
-    for(i = 0; i < limit; ++i)
-      myImageOffset[i] = (uint32_t) in.getInt();
+  // Indicates the offest within the image for the corresponding bank
+  if((uint32_t) in.getInt() != 2)
+    return false;
+  for(uint32_t i = 0; i < 2; ++i)
+    myState->myImageOffset[i] = (uint32_t) in.getInt();
 
-    // The 6K of RAM and 2K of ROM contained in the Supercharger
-    limit = (uint32_t) in.getInt();
-    for(i = 0; i < limit; ++i)
-      myImage[i] = (uint8_t) in.getInt();
+  // The 6K of RAM and 2K of ROM contained in the Supercharger
+  if((uint32_t) in.getInt() != 8192)
+    return false;
+  for(uint32_t i = 0; i < 8192; ++i)
+    myState->myImage[i] = (uint8_t) in.getInt();
 
-    // The 256 byte header for the current 8448 byte load
-    limit = (uint32_t) in.getInt();
-    for(i = 0; i < limit; ++i)
-      myHeader[i] = (uint8_t) in.getInt();
+  // The 256 byte header for the current 8448 byte load
+  if((uint32_t) in.getInt() != 256)
+    return false;
+  for(uint32_t i = 0; i < 256; ++i)
+    myState->myHeader[i] = (uint8_t) in.getInt();
 
-    // All of the 8448 byte loads associated with the game
-    // Note that the size of this array is myNumberOfLoadImages * 8448
-    limit = (uint32_t) in.getInt();
-    for(i = 0; i < limit; ++i)
-      myLoadImages[i] = (uint8_t) in.getInt();
+  // States of older versions of ALE go on with the 8448 byte loads
+  // of the game and their number, which the ROM image holds
+  if(version == 0)
+  {
+    uint32_t limit = (uint32_t) in.getInt();
+    for(uint32_t i = 0; i <= limit; ++i)
+      in.getInt();
+  }
 
-    // Indicates how many 8448 loads there are
-    myNumberOfLoadImages = (uint8_t) in.getInt();
+  // Indicates if the RAM is write enabled
+  myState->myWriteEnabled = in.getBool();
 
-    // Indicates if the RAM is write enabled
-    myWriteEnabled = in.getBool();
+  // Indicates if the ROM's power is on or off
+  myState->myPower = in.getBool();
 
-    // Indicates if the ROM's power is on or off
-    myPower = in.getBool();
+  // Indicates when the power was last turned on
+  myState->myPowerRomCycle = (int) in.getInt();
 
-    // Indicates when the power was last turned on
-    myPowerRomCycle = (int) in.getInt();
+  // Data hold register used for writing
+  myState->myDataHoldRegister = (uint8_t) in.getInt();
 
-    // Data hold register used for writing
-    myDataHoldRegister = (uint8_t) in.getInt();
+  // Indicates number of distinct accesses when data hold register was set
+  myState->myNumberOfDistinctAccesses = (uint32_t) in.getInt();
 
-    // Indicates number of distinct accesses when data hold register was set
-    myNumberOfDistinctAccesses = (uint32_t) in.getInt();
+  // Indicates if a write is pending or not
+  myState->myWritePending = in.getBool();
 
-    // Indicates if a write is pending or not
-    myWritePending = in.getBool();
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in load state for " << cart << std::endl;
-    return false;
-  }
+  // Not in states of older versions of ALE
+  if(version != 0)
+    myState->myCurrentBank = (uint16_t) in.getInt();
 
   return true;
 }
@@ -573,7 +560,7 @@ void CartridgeAR::bank(uint16_t bank)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int CartridgeAR::bank()
 {
-  return myCurrentBank;
+  return myState->myCurrentBank;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
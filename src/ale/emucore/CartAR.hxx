@@ -24,8 +24,6 @@ namespace stella {
 
 class M6502High;
 class System;
-class Serializer;
-class Deserializer;
 
 }  // namespace stella
 }  // namespace ale
@@ -35,6 +33,42 @@ class Deserializer;
 namespace ale {
 namespace stella {
 
+/**
+  The Supercharger RAM and bank configuration, kept apart from the loads
+  of the game so that they can be saved and restored as one block.
+*/
+struct CartridgeARState
+{
+  // Indicates the offest within the image for the corresponding bank
+  uint32_t myImageOffset[2];
+
+  // The 6K of RAM and 2K of ROM contained in the Supercharger
+  uint8_t myImage[8192];
+
+  // The 256 byte header for the current 8448 byte load
+  uint8_t myHeader[256];
+
+  // Indicates if the RAM is write enabled
+  bool myWriteEnabled;
+
+  // Indicates if the ROM's power is on or off
+  bool myPower;
+
+  // Indicates when the power was last turned on
+  int myPowerRomCycle;
+
+  // Data hold register used for writing
+  uint8_t myDataHoldRegister;
+
+  // Indicates number of distinct accesses when data hold register was set
+  uint32_t myNumberOfDistinctAccesses;
+
+  // Indicates if a write is pending or not
+  bool myWritePending;
+
+  uint16_t myCurrentBank;
+};
+
 /**
   This is the cartridge class for Arcadia (aka Starpath) Supercharger
   games.  Christopher Salomon provided most of the technical details
@@ -72,6 +106,14 @@ class CartridgeAR : public Cartridge
     */
     virtual const char* name() const;
 
+    /**
+      Answers the number of bytes of memory owned by the device, including
+      the device object itself
+
+      @return The number of bytes
+    */
+    virtual size_t memoryUsage() const;
+
     /**
       Reset device to its power-on state
     */
@@ -93,20 +135,37 @@ class CartridgeAR : public Cartridge
     virtual void install(System& system);
 
     /**
-      Saves the current state of this device to the given Serializer.
+      Answers the number of bytes of the state block of the cartridge.
 
-      @param out The serializer device to save to.
-      @return The result of the save.  True on success, false on failure.
+      @return The size of the state block
     */
-    virtual bool save(Serializer& out);
+    virtual size_t stateSize() const;
 
     /**
-      Loads the current state of this device from the given Deserializer.
+      Moves the state block of the cartridge to the given stateSize() bytes
+      of the machine state.
+
+      @param state The bytes to move the block to
+    */
+    virtual void bindState(uint8_t* state);
+
+    /**
+      Answers the function writing the state block of the cartridge to a
+      saved state in the portable format.
+
+      @return The writer of the state block
+    */
+    virtual StateWriter stateWriter() const;
+
+    /**
+      Reads the state block of the cartridge from a saved state in the given
+      version of the portable format.
 
       @param in The deserializer device to load from.
+      @param version The version of the format
       @return The result of the load.  True on success, false on failure.
     */
-    virtual bool load(Deserializer& in);
+    virtual bool loadState(Deserializer& in, int version);
 
     /**
       Install pages for the specified bank in the system.
@@ -177,40 +236,18 @@ class CartridgeAR : public Cartridge
     // Pointer to the 6502 processor in the system
     M6502High* my6502;
 
-    // Indicates the offest within the image for the corresponding bank
-    uint32_t myImageOffset[2];
-
-    // The 6K of RAM and 2K of ROM contained in the Supercharger
-    uint8_t myImage[8192];
-
-    // The 256 byte header for the current 8448 byte load
-    uint8_t myHeader[256];
-
     // All of the 8448 byte loads associated with the game
     uint8_t* myLoadImages;
 
     // Indicates how many 8448 loads there are
     uint8_t myNumberOfLoadImages;
 
-    // Indicates if the RAM is write enabled
-    bool myWriteEnabled;
-
-    // Indicates if the ROM's power is on or off
-    bool myPower;
-
-    // Indicates when the power was last turned on
-    int myPowerRomCycle;
-
-    // Data hold register used for writing
-    uint8_t myDataHoldRegister;
-
-    // Indicates number of distinct accesses when data hold register was set
-    uint32_t myNumberOfDistinctAccesses;
-
-    // Indicates if a write is pending or not
-    bool myWritePending;
+  private:
+    // Writes a state block field by field
+    static void writeState(const uint8_t* block, Serializer& out);
 
-    uint16_t myCurrentBank;
+    // The Supercharger's RAM, load and bank switching state
+    StateView<CartridgeARState> myState;
 };
 
 }  // namespace stella
@@ -66,16 +66,22 @@ const char* CartridgeCV::name() const
   return "CartridgeCV";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t CartridgeCV::memoryUsage() const
+{
+  return sizeof(*this) + (myInitialRAM ? 1024 : 0);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeCV::reset()
 {
   if (myInitialRAM) {
     // Copy the RAM image into my buffer
-    std::memcpy(myRAM, myInitialRAM, 1024);
+    std::memcpy(myState->myRAM, myInitialRAM, 1024);
   } else {
     // Initialize RAM with random values
     for(uint32_t i = 0; i < 1024; ++i)
-      myRAM[i] = mySystem->rng().next();
+      myState->myRAM[i] = mySystem->rng().next();
   }
 }
 
@@ -105,7 +111,7 @@ void CartridgeCV::install(System& system)
   {
     access.device = this;
     access.directPeekBase = 0;
-    access.directPokeBase = &myRAM[j & 0x03FF];
+    access.directPokeBase = &myState->myRAM[j & 0x03FF];
     mySystem->setPageAccess(j >> shift, access);
   }
 
@@ -113,7 +119,7 @@ void CartridgeCV::install(System& system)
   for(uint32_t k = 0x1000; k < 0x1400; k += (1 << shift))
   {
     access.device = this;
-    access.directPeekBase = &myRAM[k & 0x03FF];
+    access.directPeekBase = &myState->myRAM[k & 0x03FF];
     access.directPokeBase = 0;
     mySystem->setPageAccess(k >> shift, access);
   }
@@ -132,58 +138,43 @@ void CartridgeCV::poke(uint16_t, uint8_t)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeCV::save(Serializer& out)
+size_t CartridgeCV::stateSize() const
 {
-  std::string cart = name();
-
-  try
-  {
-    out.putString(cart);
+  return sizeof(CartridgeCVState);
+}
 
-    // Output RAM
-    out.putInt(1024);
-    for(uint32_t addr = 0; addr < 1024; ++addr)
-      out.putInt(myRAM[addr]);
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in save state for " << cart << std::endl;
-    return false;
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeCV::bindState(uint8_t* state)
+{
+  myState.bind(state);
+}
 
-  return true;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateWriter CartridgeCV::stateWriter() const
+{
+  return &writeState;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeCV::load(Deserializer& in)
+void CartridgeCV::writeState(const uint8_t* block, Serializer& out)
 {
-  std::string cart = name();
+  const CartridgeCVState* state =
+      reinterpret_cast<const CartridgeCVState*>(block);
 
-  try
-  {
-    if(in.getString() != cart)
-      return false;
+  // The 1K of RAM
+  out.putInt(1024);
+  for(uint32_t i = 0; i < 1024; ++i)
+    out.putInt(state->myRAM[i]);
+}
 
-    // Input RAM
-    uint32_t limit = (uint32_t) in.getInt();
-    for(uint32_t addr = 0; addr < limit; ++addr)
-      myRAM[addr] = (uint8_t) in.getInt();
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in load state for " << cart << std::endl;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeCV::loadState(Deserializer& in, int)
+{
+  // The 1K of RAM
+  if((uint32_t) in.getInt() != 1024)
     return false;
-  }
+  for(uint32_t i = 0; i < 1024; ++i)
+    myState->myRAM[i] = (uint8_t) in.getInt();
 
   return true;
 }
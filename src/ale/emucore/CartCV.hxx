@@ -23,8 +23,6 @@ namespace ale {
 namespace stella {
 
 class System;
-class Serializer;
-class Deserializer;
 
 }  // namespace stella
 }  // namespace ale
@@ -34,6 +32,16 @@ class Deserializer;
 namespace ale {
 namespace stella {
 
+/**
+  The 1K of RAM of the cartridge, kept apart from the ROM image so that
+  it can be saved and restored as one block.
+*/
+struct CartridgeCVState
+{
+  // The 1024 bytes of RAM
+  uint8_t myRAM[1024];
+};
+
 /**
   Cartridge class used for Commavid's extra-RAM games.
 
@@ -67,6 +75,14 @@ class CartridgeCV : public Cartridge
     */
     virtual const char* name() const;
 
+    /**
+      Answers the number of bytes of memory owned by the device, including
+      the device object itself
+
+      @return The number of bytes
+    */
+    virtual size_t memoryUsage() const;
+
     /**
       Reset cartridge to its power-on state
     */
@@ -81,20 +97,37 @@ class CartridgeCV : public Cartridge
     virtual void install(System& system);
 
     /**
-      Saves the current state of this device to the given Serializer.
+      Answers the number of bytes of the state block of the cartridge.
 
-      @param out The serializer device to save to.
-      @return The result of the save.  True on success, false on failure.
+      @return The size of the state block
     */
-    virtual bool save(Serializer& out);
+    virtual size_t stateSize() const;
 
     /**
-      Loads the current state of this device from the given Deserializer.
+      Moves the state block of the cartridge to the given stateSize() bytes
+      of the machine state.
+
+      @param state The bytes to move the block to
+    */
+    virtual void bindState(uint8_t* state);
+
+    /**
+      Answers the function writing the state block of the cartridge to a
+      saved state in the portable format.
+
+      @return The writer of the state block
+    */
+    virtual StateWriter stateWriter() const;
+
+    /**
+      Reads the state block of the cartridge from a saved state in the given
+      version of the portable format.
 
       @param in The deserializer device to load from.
+      @param version The version of the format
       @return The result of the load.  True on success, false on failure.
     */
-    virtual bool load(Deserializer& in);
+    virtual bool loadState(Deserializer& in, int version);
 
     /**
       Install pages for the specified bank in the system.
@@ -152,12 +185,16 @@ class CartridgeCV : public Cartridge
     // The 2k ROM image for the cartridge
     uint8_t myImage[2048];
 
-    // The 1024 bytes of RAM
-    uint8_t myRAM[1024];
-
     // Pointer to the initial RAM data from the cart
     // This doesn't always exist, so we don't pre-allocate it
     uint8_t* myInitialRAM;
+
+  private:
+    // Writes a state block field by field
+    static void writeState(const uint8_t* block, Serializer& out);
+
+    // The RAM of the cartridge
+    StateView<CartridgeCVState> myState;
 };
 
 }  // namespace stella
@@ -17,11 +17,12 @@
 //============================================================================
 
 #include <cassert>
+#include <cstring>
 #include <iostream>
-#include "ale/emucore/CartDPC.hxx"
-#include "ale/emucore/System.hxx"
 #include "ale/emucore/Serializer.hxx"
 #include "ale/emucore/Deserializer.hxx"
+#include "ale/emucore/CartDPC.hxx"
+#include "ale/emucore/System.hxx"
 
 namespace ale {
 namespace stella {
@@ -51,18 +52,18 @@ CartridgeDPC::CartridgeDPC(const uint8_t* image, uint32_t size)
   // Initialize the DPC data fetcher registers
   for(uint16_t i = 0; i < 8; ++i)
   {
-    myTops[i] = myBottoms[i] = myCounters[i] = myFlags[i] = 0;
+    myState->myTops[i] = myState->myBottoms[i] = myState->myCounters[i] = myState->myFlags[i] = 0;
   }
 
   // None of the data fetchers are in music mode
-  myMusicMode[0] = myMusicMode[1] = myMusicMode[2] = false;
+  myState->myMusicMode[0] = myState->myMusicMode[1] = myState->myMusicMode[2] = false;
 
   // Initialize the DPC's random number generator register (must be non-zero)
-  myRandomNumber = 1;
+  myState->myRandomNumber = 1;
 
   // Initialize the system cycles counter & fractional clock values
-  mySystemCycles = 0;
-  myFractionalClocks = 0.0;
+  myState->mySystemCycles = 0;
+  myState->myFractionalClocks = 0.0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -76,12 +77,18 @@ const char* CartridgeDPC::name() const
   return "CartridgeDPC";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t CartridgeDPC::memoryUsage() const
+{
+  return sizeof(*this);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeDPC::reset()
 {
   // Update cycles to the current system cycles
-  mySystemCycles = mySystem->cycles();
-  myFractionalClocks = 0.0;
+  myState->mySystemCycles = mySystem->cycles();
+  myState->myFractionalClocks = 0.0;
 
   // Upon reset we switch to bank 1
   bank(1);
@@ -94,7 +101,7 @@ void CartridgeDPC::systemCyclesReset()
   uint32_t cycles = mySystem->cycles();
 
   // Adjust the cycle counter so that it reflects the new value
-  mySystemCycles -= cycles;
+  myState->mySystemCycles -= cycles;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -141,24 +148,24 @@ inline void CartridgeDPC::clockRandomNumberGenerator()
 
   // Using bits 7, 5, 4, & 3 of the shift register compute the input
   // bit for the shift register
-  uint8_t bit = f[((myRandomNumber >> 3) & 0x07) |
-      ((myRandomNumber & 0x80) ? 0x08 : 0x00)];
+  uint8_t bit = f[((myState->myRandomNumber >> 3) & 0x07) |
+      ((myState->myRandomNumber & 0x80) ? 0x08 : 0x00)];
 
   // Update the shift register
-  myRandomNumber = (myRandomNumber << 1) | bit;
+  myState->myRandomNumber = (myState->myRandomNumber << 1) | bit;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline void CartridgeDPC::updateMusicModeDataFetchers()
 {
   // Calculate the number of cycles since the last update
-  int cycles = mySystem->cycles() - mySystemCycles;
-  mySystemCycles = mySystem->cycles();
+  int cycles = mySystem->cycles() - myState->mySystemCycles;
+  myState->mySystemCycles = mySystem->cycles();
 
   // Calculate the number of DPC OSC clocks since the last update
-  double clocks = ((15750.0 * cycles) / 1193191.66666667) + myFractionalClocks;
+  double clocks = ((15750.0 * cycles) / 1193191.66666667) + myState->myFractionalClocks;
   int wholeClocks = (int)clocks;
-  myFractionalClocks = clocks - (double)wholeClocks;
+  myState->myFractionalClocks = clocks - (double)wholeClocks;
 
   if(wholeClocks <= 0)
   {
@@ -169,12 +176,12 @@ inline void CartridgeDPC::updateMusicModeDataFetchers()
   for(int x = 5; x <= 7; ++x)
   {
     // Update only if the data fetcher is in music mode
-    if(myMusicMode[x - 5])
+    if(myState->myMusicMode[x - 5])
     {
-      int top = myTops[x] + 1;
-      int newLow = (int)(myCounters[x] & 0x00ff);
+      int top = myState->myTops[x] + 1;
+      int newLow = (int)(myState->myCounters[x] & 0x00ff);
 
-      if(myTops[x] != 0)
+      if(myState->myTops[x] != 0)
       {
         newLow -= (wholeClocks % top);
         if(newLow < 0)
@@ -188,16 +195,16 @@ inline void CartridgeDPC::updateMusicModeDataFetchers()
       }
 
       // Update flag register for this data fetcher
-      if(newLow <= myBottoms[x])
+      if(newLow <= myState->myBottoms[x])
       {
-        myFlags[x] = 0x00;
+        myState->myFlags[x] = 0x00;
       }
-      else if(newLow <= myTops[x])
+      else if(newLow <= myState->myTops[x])
       {
-        myFlags[x] = 0xff;
+        myState->myFlags[x] = 0xff;
       }
 
-      myCounters[x] = (myCounters[x] & 0x0700) | (uint16_t)newLow;
+      myState->myCounters[x] = (myState->myCounters[x] & 0x0700) | (uint16_t)newLow;
     }
   }
 }
@@ -221,13 +228,13 @@ uint8_t CartridgeDPC::peek(uint16_t address)
     uint32_t function = (address >> 3) & 0x07;
 
     // Update flag register for selected data fetcher
-    if((myCounters[index] & 0x00ff) == myTops[index])
+    if((myState->myCounters[index] & 0x00ff) == myState->myTops[index])
     {
-      myFlags[index] = 0xff;
+      myState->myFlags[index] = 0xff;
     }
-    else if((myCounters[index] & 0x00ff) == myBottoms[index])
+    else if((myState->myCounters[index] & 0x00ff) == myState->myBottoms[index])
     {
-      myFlags[index] = 0x00;
+      myState->myFlags[index] = 0x00;
     }
 
     switch(function)
@@ -237,7 +244,7 @@ uint8_t CartridgeDPC::peek(uint16_t address)
         // Is this a random number read
         if(index < 4)
         {
-          result = myRandomNumber;
+          result = myState->myRandomNumber;
         }
         // No, it's a music read
         else
@@ -250,15 +257,15 @@ uint8_t CartridgeDPC::peek(uint16_t address)
           updateMusicModeDataFetchers();
 
           uint8_t i = 0;
-          if(myMusicMode[0] && myFlags[5])
+          if(myState->myMusicMode[0] && myState->myFlags[5])
           {
             i |= 0x01;
           }
-          if(myMusicMode[1] && myFlags[6])
+          if(myState->myMusicMode[1] && myState->myFlags[6])
           {
             i |= 0x02;
           }
-          if(myMusicMode[2] && myFlags[7])
+          if(myState->myMusicMode[2] && myState->myFlags[7])
           {
             i |= 0x04;
           }
@@ -271,21 +278,21 @@ uint8_t CartridgeDPC::peek(uint16_t address)
       // DFx display data read
       case 0x01:
       {
-        result = myDisplayImage[2047 - myCounters[index]];
+        result = myDisplayImage[2047 - myState->myCounters[index]];
         break;
       }
 
       // DFx display data read AND'd w/flag
       case 0x02:
       {
-        result = myDisplayImage[2047 - myCounters[index]] & myFlags[index];
+        result = myDisplayImage[2047 - myState->myCounters[index]] & myState->myFlags[index];
         break;
       }
 
       // DFx flag
       case 0x07:
       {
-        result = myFlags[index];
+        result = myState->myFlags[index];
         break;
       }
 
@@ -296,9 +303,9 @@ uint8_t CartridgeDPC::peek(uint16_t address)
     }
 
     // Clock the selected data fetcher's counter if needed
-    if((index < 5) || ((index >= 5) && (!myMusicMode[index - 5])))
+    if((index < 5) || ((index >= 5) && (!myState->myMusicMode[index - 5])))
     {
-      myCounters[index] = (myCounters[index] - 1) & 0x07ff;
+      myState->myCounters[index] = (myState->myCounters[index] - 1) & 0x07ff;
     }
 
     return result;
@@ -321,7 +328,7 @@ uint8_t CartridgeDPC::peek(uint16_t address)
       default:
         break;
     }
-    return myProgramImage[myCurrentBank * 4096 + address];
+    return myProgramImage[myState->myCurrentBank * 4096 + address];
   }
 }
 
@@ -346,34 +353,34 @@ void CartridgeDPC::poke(uint16_t address, uint8_t value)
       // DFx top count
       case 0x00:
       {
-        myTops[index] = value;
-        myFlags[index] = 0x00;
+        myState->myTops[index] = value;
+        myState->myFlags[index] = 0x00;
         break;
       }
 
       // DFx bottom count
       case 0x01:
       {
-        myBottoms[index] = value;
+        myState->myBottoms[index] = value;
         break;
       }
 
       // DFx counter low
       case 0x02:
       {
-        if((index >= 5) && myMusicMode[index - 5])
+        if((index >= 5) && myState->myMusicMode[index - 5])
         {
           // Data fecther is in music mode so its low counter value
           // should be loaded from the top register not the poked value
-          myCounters[index] = (myCounters[index] & 0x0700) |
-              (uint16_t)myTops[index];
+          myState->myCounters[index] = (myState->myCounters[index] & 0x0700) |
+              (uint16_t)myState->myTops[index];
         }
         else
         {
           // Data fecther is either not a music mode data fecther or it
           // isn't in music mode so it's low counter value should be loaded
           // with the poked value
-          myCounters[index] = (myCounters[index] & 0x0700) | (uint16_t)value;
+          myState->myCounters[index] = (myState->myCounters[index] & 0x0700) | (uint16_t)value;
         }
         break;
       }
@@ -381,13 +388,13 @@ void CartridgeDPC::poke(uint16_t address, uint8_t value)
       // DFx counter high
       case 0x03:
       {
-        myCounters[index] = (((uint16_t)value & 0x07) << 8) |
-            (myCounters[index] & 0x00ff);
+        myState->myCounters[index] = (((uint16_t)value & 0x07) << 8) |
+            (myState->myCounters[index] & 0x00ff);
 
         // Execute special code for music mode data fetchers
         if(index >= 5)
         {
-          myMusicMode[index - 5] = (value & 0x10);
+          myState->myMusicMode[index - 5] = (value & 0x10);
 
           // NOTE: We are not handling the clock source input for
           // the music mode data fetchers.  We're going to assume
@@ -399,7 +406,7 @@ void CartridgeDPC::poke(uint16_t address, uint8_t value)
       // Random Number Generator Reset
       case 0x06:
       {
-        myRandomNumber = 1;
+        myState->myRandomNumber = 1;
         break;
       }
 
@@ -431,136 +438,144 @@ void CartridgeDPC::poke(uint16_t address, uint8_t value)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeDPC::save(Serializer& out)
+size_t CartridgeDPC::stateSize() const
 {
-  std::string cart = name();
-
-  try
-  {
-    uint32_t i;
-
-    out.putString(cart);
-
-    // Indicates which bank is currently active
-    out.putInt(myCurrentBank);
-
-    // The top registers for the data fetchers
-    out.putInt(8);
-    for(i = 0; i < 8; ++i)
-      out.putInt(myTops[i]);
-
-    // The bottom registers for the data fetchers
-    out.putInt(8);
-    for(i = 0; i < 8; ++i)
-      out.putInt(myBottoms[i]);
-
-    // The counter registers for the data fetchers
-    out.putInt(8);
-    for(i = 0; i < 8; ++i)
-      out.putInt(myCounters[i]);
-
-    // The flag registers for the data fetchers
-    out.putInt(8);
-    for(i = 0; i < 8; ++i)
-      out.putInt(myFlags[i]);
-
-    // The music mode flags for the data fetchers
-    out.putInt(3);
-    for(i = 0; i < 3; ++i)
-      out.putBool(myMusicMode[i]);
-
-    // The random number generator register
-    out.putInt(myRandomNumber);
-
-    out.putInt(mySystemCycles);
-    out.putInt((uint32_t)(myFractionalClocks * 100000000.0));
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in save state for " << cart << std::endl;
-    return false;
-  }
+  return sizeof(CartridgeDPCState);
+}
 
-  return true;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeDPC::bindState(uint8_t* state)
+{
+  myState.bind(state);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeDPC::load(Deserializer& in)
+StateWriter CartridgeDPC::stateWriter() const
 {
-  std::string cart = name();
+  return &writeState;
+}
 
-  try
-  {
-    if(in.getString() != cart)
-      return false;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeDPC::writeState(const uint8_t* block, Serializer& out)
+{
+  const CartridgeDPCState* state =
+      reinterpret_cast<const CartridgeDPCState*>(block);
+
+  // Indicates which bank is currently active
+  out.putInt(state->myCurrentBank);
+
+  // The top registers for the data fetchers
+  out.putInt(8);
+  for(uint32_t i = 0; i < 8; ++i)
+    out.putInt(state->myTops[i]);
+
+  // The bottom registers for the data fetchers
+  out.putInt(8);
+  for(uint32_t i = 0; i < 8; ++i)
+    out.putInt(state->myBottoms[i]);
+
+  // The counter registers for the data fetchers
+  out.putInt(8);
+  for(uint32_t i = 0; i < 8; ++i)
+    out.putInt(state->myCounters[i]);
+
+  // The flag registers for the data fetchers
+  out.putInt(8);
+  for(uint32_t i = 0; i < 8; ++i)
+    out.putInt(state->myFlags[i]);
+
+  // The music mode flags for the data fetchers
+  out.putInt(3);
+  for(uint32_t i = 0; i < 3; ++i)
+    out.putBool(state->myMusicMode[i]);
+
+  // The random number generator register
+  out.putInt(state->myRandomNumber);
+
+  // System cycle count when the last update to music data fetchers occurred
+  out.putInt(state->mySystemCycles);
+
+  // Fractional DPC music OSC clocks unused during the last update,
+  // as the bits of the double
+  uint64_t clocks;
+  std::memcpy(&clocks, &state->myFractionalClocks, sizeof(clocks));
+  out.putInt((uint32_t) clocks);
+  out.putInt((uint32_t) (clocks >> 32));
+}
 
-    uint32_t i, limit;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeDPC::loadState(Deserializer& in, int version)
+{
+  // Indicates which bank is currently active
+  myState->myCurrentBank = (uint16_t) in.getInt();
 
-    // Indicates which bank is currently active
-    myCurrentBank = (uint16_t) in.getInt();
+  // The top registers for the data fetchers
+  if((uint32_t) in.getInt() != 8)
+    return false;
+  for(uint32_t i = 0; i < 8; ++i)
+    myState->myTops[i] = (uint8_t) in.getInt();
 
-    // The top registers for the data fetchers
-    limit = (uint32_t) in.getInt();
-    for(i = 0; i < limit; ++i)
-      myTops[i] = (uint8_t) in.getInt();
+  // The bottom registers for the data fetchers
+  if((uint32_t) in.getInt() != 8)
+    return false;
+  for(uint32_t i = 0; i < 8; ++i)
+    myState->myBottoms[i] = (uint8_t) in.getInt();
 
-    // The bottom registers for the data fetchers
-    limit = (uint32_t) in.getInt();
-    for(i = 0; i < limit; ++i)
-      myBottoms[i] = (uint8_t) in.getInt();
+  // The counter registers for the data fetchers
+  if((uint32_t) in.getInt() != 8)
+    return false;
+  for(uint32_t i = 0; i < 8; ++i)
+    myState->myCounters[i] = (uint16_t) in.getInt();
 
-    // The counter registers for the data fetchers
-    limit = (uint32_t) in.getInt();
-    for(i = 0; i < limit; ++i)
-      myCounters[i] = (uint16_t) in.getInt();
+  // The flag registers for the data fetchers
+  if((uint32_t) in.getInt() != 8)
+    return false;
+  for(uint32_t i = 0; i < 8; ++i)
+    myState->myFlags[i] = (uint8_t) in.getInt();
 
-    // The flag registers for the data fetchers
-    limit = (uint32_t) in.getInt();
-    for(i = 0; i < limit; ++i)
-      myFlags[i] = (uint8_t) in.getInt();
+  // The music mode flags for the data fetchers
+  if((uint32_t) in.getInt() != 3)
+    return false;
+  for(uint32_t i = 0; i < 3; ++i)
+    myState->myMusicMode[i] = in.getBool();
 
-    // The music mode flags for the data fetchers
-    limit = (uint32_t) in.getInt();
-    for(i = 0; i < limit; ++i)
-      myMusicMode[i] = in.getBool();
+  // The random number generator register
+  myState->myRandomNumber = (uint8_t) in.getInt();
 
-    // The random number generator register
-    myRandomNumber = (uint8_t) in.getInt();
+  // System cycle count when the last update to music data fetchers occurred
+  myState->mySystemCycles = (int) in.getInt();
 
-    // Get system cycles and fractional clocks
-    mySystemCycles = in.getInt();
-    myFractionalClocks = (double)in.getInt() / 100000000.0;
-  }
-  catch(const char* msg)
+  // Fractional DPC music OSC clocks unused during the last update,
+  // which older versions of ALE saved in units of 1e-8
+  if(version == 0)
   {
-    ale::Logger::Error << msg << std::endl;
-    return false;
+    myState->myFractionalClocks = (double) in.getInt() / 100000000.0;
   }
-  catch(...)
+  else
   {
-    ale::Logger::Error << "Unknown error in load state for " << cart << std::endl;
-    return false;
+    uint64_t clocks = (uint32_t) in.getInt();
+    clocks |= (uint64_t) (uint32_t) in.getInt() << 32;
+    std::memcpy(&myState->myFractionalClocks, &clocks, sizeof(clocks));
   }
 
-  // Now, go to the current bank
-  bank(myCurrentBank);
-
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeDPC::stateRestored()
+{
+  // Now, go to the current bank
+  bank(myState->myCurrentBank);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeDPC::bank(uint16_t bank)
 {
   if(bankLocked) return;
 
   // Remember what bank we're in
-  myCurrentBank = bank;
-  uint16_t offset = myCurrentBank * 4096;
+  myState->myCurrentBank = bank;
+  uint16_t offset = myState->myCurrentBank * 4096;
   uint16_t shift = mySystem->pageShift();
   uint16_t mask = mySystem->pageMask();
 
@@ -581,7 +596,7 @@ void CartridgeDPC::bank(uint16_t bank)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int CartridgeDPC::bank()
 {
-  return myCurrentBank;
+  return myState->myCurrentBank;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -594,7 +609,7 @@ int CartridgeDPC::bankCount()
 bool CartridgeDPC::patch(uint16_t address, uint8_t value)
 {
   address = address & 0x0FFF;
-  myProgramImage[myCurrentBank * 4096 + address] = value;
+  myProgramImage[myState->myCurrentBank * 4096 + address] = value;
   return true;
 }
 
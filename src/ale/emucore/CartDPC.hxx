@@ -23,8 +23,6 @@ namespace ale {
 namespace stella {
 
 class System;
-class Serializer;
-class Deserializer;
 
 }  // namespace stella
 }  // namespace ale
@@ -34,6 +32,41 @@ class Deserializer;
 namespace ale {
 namespace stella {
 
+/**
+  The bank switching state and data fetcher registers of the cartridge,
+  kept apart from the ROM images so that they can be saved and restored
+  as one block.
+*/
+struct CartridgeDPCState
+{
+  // Indicates which bank is currently active
+  uint16_t myCurrentBank;
+
+  // The top registers for the data fetchers
+  uint8_t myTops[8];
+
+  // The bottom registers for the data fetchers
+  uint8_t myBottoms[8];
+
+  // The counter registers for the data fetchers
+  uint16_t myCounters[8];
+
+  // The flag registers for the data fetchers
+  uint8_t myFlags[8];
+
+  // The music mode DF5, DF6, & DF7 enabled flags
+  bool myMusicMode[3];
+
+  // The random number generator register
+  uint8_t myRandomNumber;
+
+  // System cycle count when the last update to music data fetchers occurred
+  int mySystemCycles;
+
+  // Fractional DPC music OSC clocks unused during the last update
+  double myFractionalClocks;
+};
+
 /**
   Cartridge class used for Pitfall II.  There are two 4K program banks, a
   2K display bank, and the DPC chip.  For complete details on the DPC chip
@@ -65,6 +98,14 @@ class CartridgeDPC : public Cartridge
     */
     virtual const char* name() const;
 
+    /**
+      Answers the number of bytes of memory owned by the device, including
+      the device object itself
+
+      @return The number of bytes
+    */
+    virtual size_t memoryUsage() const;
+
     /**
       Reset device to its power-on state
     */
@@ -86,20 +127,43 @@ class CartridgeDPC : public Cartridge
     virtual void install(System& system);
 
     /**
-      Saves the current state of this device to the given Serializer.
+      Answers the number of bytes of the state block of the cartridge.
+
+      @return The size of the state block
+    */
+    virtual size_t stateSize() const;
+
+    /**
+      Moves the state block of the cartridge to the given stateSize() bytes
+      of the machine state.
 
-      @param out The serializer device to save to.
-      @return The result of the save.  True on success, false on failure.
+      @param state The bytes to move the block to
     */
-    virtual bool save(Serializer& out);
+    virtual void bindState(uint8_t* state);
 
     /**
-      Loads the current state of this device from the given Deserializer.
+      Answers the function writing the state block of the cartridge to a
+      saved state in the portable format.
+
+      @return The writer of the state block
+    */
+    virtual StateWriter stateWriter() const;
+
+    /**
+      Reads the state block of the cartridge from a saved state in the given
+      version of the portable format.
 
       @param in The deserializer device to load from.
+      @param version The version of the format
       @return The result of the load.  True on success, false on failure.
     */
-    virtual bool load(Deserializer& in);
+    virtual bool loadState(Deserializer& in, int version);
+
+    /**
+      Notification method invoked by the system right after it has
+      overwritten the machine state with a saved one.
+    */
+    virtual void stateRestored();
 
     /**
       Install pages for the specified bank in the system.
@@ -166,9 +230,6 @@ class CartridgeDPC : public Cartridge
     void updateMusicModeDataFetchers();
 
   private:
-    // Indicates which bank is currently active
-    uint16_t myCurrentBank;
-
     // The 8K program ROM image of the cartridge
     uint8_t myProgramImage[8192];
 
@@ -178,29 +239,12 @@ class CartridgeDPC : public Cartridge
     // Copy of the raw image, for use by getImage()
     uint8_t myImageCopy[8192 + 2048 + 255];
 
-    // The top registers for the data fetchers
-    uint8_t myTops[8];
-
-    // The bottom registers for the data fetchers
-    uint8_t myBottoms[8];
-
-    // The counter registers for the data fetchers
-    uint16_t myCounters[8];
-
-    // The flag registers for the data fetchers
-    uint8_t myFlags[8];
-
-    // The music mode DF5, DF6, & DF7 enabled flags
-    bool myMusicMode[3];
-
-    // The random number generator register
-    uint8_t myRandomNumber;
-
-    // System cycle count when the last update to music data fetchers occurred
-    int mySystemCycles;
+  private:
+    // Writes a state block field by field
+    static void writeState(const uint8_t* block, Serializer& out);
 
-    // Fractional DPC music OSC clocks unused during the last update
-    double myFractionalClocks;
+    // The bank switching state and data fetchers of the cartridge
+    StateView<CartridgeDPCState> myState;
 };
 
 }  // namespace stella
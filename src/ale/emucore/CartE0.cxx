@@ -47,6 +47,12 @@ const char* CartridgeE0::name() const
   return "CartridgeE0";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t CartridgeE0::memoryUsage() const
+{
+  return sizeof(*this);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeE0::reset()
 {
@@ -76,7 +82,7 @@ void CartridgeE0::install(System& system)
     access.directPeekBase = &myImage[7168 + (i & 0x03FF)];
     mySystem->setPageAccess(i >> shift, access);
   }
-  myCurrentSlice[3] = 7;
+  myState->myCurrentSlice[3] = 7;
 
   // Set the page accessing methods for the hot spots in the last segment
   access.directPeekBase = 0;
@@ -114,7 +120,7 @@ uint8_t CartridgeE0::peek(uint16_t address)
     }
   }
 
-  return myImage[(myCurrentSlice[address >> 10] << 10) + (address & 0x03FF)];
+  return myImage[(myState->myCurrentSlice[address >> 10] << 10) + (address & 0x03FF)];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -143,7 +149,7 @@ void CartridgeE0::poke(uint16_t address, uint8_t)
 void CartridgeE0::segmentZero(uint16_t slice)
 {
   // Remember the new slice
-  myCurrentSlice[0] = slice;
+  myState->myCurrentSlice[0] = slice;
   uint16_t offset = slice << 10;
   uint16_t shift = mySystem->pageShift();
 
@@ -163,7 +169,7 @@ void CartridgeE0::segmentZero(uint16_t slice)
 void CartridgeE0::segmentOne(uint16_t slice)
 {
   // Remember the new slice
-  myCurrentSlice[1] = slice;
+  myState->myCurrentSlice[1] = slice;
   uint16_t offset = slice << 10;
   uint16_t shift = mySystem->pageShift();
 
@@ -183,7 +189,7 @@ void CartridgeE0::segmentOne(uint16_t slice)
 void CartridgeE0::segmentTwo(uint16_t slice)
 {
   // Remember the new slice
-  myCurrentSlice[2] = slice;
+  myState->myCurrentSlice[2] = slice;
   uint16_t offset = slice << 10;
   uint16_t shift = mySystem->pageShift();
 
@@ -200,60 +206,56 @@ void CartridgeE0::segmentTwo(uint16_t slice)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeE0::save(Serializer& out)
+size_t CartridgeE0::stateSize() const
 {
-  std::string cart = name();
-
-  try
-  {
-    out.putString(cart);
+  return sizeof(CartridgeE0State);
+}
 
-    out.putInt(4);
-    for(uint32_t i = 0; i < 4; ++i)
-      out.putInt(myCurrentSlice[i]);
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in save state for " << cart << std::endl;
-    return false;
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeE0::bindState(uint8_t* state)
+{
+  myState.bind(state);
+}
 
-  return true;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateWriter CartridgeE0::stateWriter() const
+{
+  return &writeState;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeE0::load(Deserializer& in)
+void CartridgeE0::writeState(const uint8_t* block, Serializer& out)
 {
-  std::string cart = name();
+  const CartridgeE0State* state =
+      reinterpret_cast<const CartridgeE0State*>(block);
 
-  try
-  {
-    if(in.getString() != cart)
-      return false;
+  // The slices in the four segments
+  out.putInt(4);
+  for(uint32_t i = 0; i < 4; ++i)
+    out.putInt(state->myCurrentSlice[i]);
+}
 
-    uint32_t limit = (uint32_t) in.getInt();
-    for(uint32_t i = 0; i < limit; ++i)
-      myCurrentSlice[i] = (uint16_t) in.getInt();
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in load state for " << cart << std::endl;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeE0::loadState(Deserializer& in, int)
+{
+  // The slices in the four segments
+  if((uint32_t) in.getInt() != 4)
     return false;
-  }
+  for(uint32_t i = 0; i < 4; ++i)
+    myState->myCurrentSlice[i] = (uint16_t) in.getInt();
 
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeE0::stateRestored()
+{
+  // Map the slices back into the first three segments
+  segmentZero(myState->myCurrentSlice[0]);
+  segmentOne(myState->myCurrentSlice[1]);
+  segmentTwo(myState->myCurrentSlice[2]);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeE0::bank(uint16_t bank)
 {
@@ -278,7 +280,7 @@ int CartridgeE0::bankCount()
 bool CartridgeE0::patch(uint16_t address, uint8_t value)
 {
   address = address & 0x0FFF;
-  myImage[(myCurrentSlice[address >> 10] << 10) + (address & 0x03FF)] = value;
+  myImage[(myState->myCurrentSlice[address >> 10] << 10) + (address & 0x03FF)] = value;
   return true;
 }
 
@@ -47,12 +47,18 @@ const char* CartridgeE7::name() const
   return "CartridgeE7";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t CartridgeE7::memoryUsage() const
+{
+  return sizeof(*this);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeE7::reset()
 {
   // Initialize RAM with random values
   for(uint32_t i = 0; i < 2048; ++i)
-    myRAM[i] = mySystem->rng().next();
+    myState->myRAM[i] = mySystem->rng().next();
 
   // Install some default banks for the RAM and first segment
   bankRAM(0);
@@ -88,7 +94,7 @@ void CartridgeE7::install(System& system)
     access.directPokeBase = 0;
     mySystem->setPageAccess(j >> shift, access);
   }
-  myCurrentSlice[1] = 7;
+  myState->myCurrentSlice[1] = 7;
 
   // Install some default banks for the RAM and first segment
   bankRAM(0);
@@ -113,7 +119,7 @@ uint8_t CartridgeE7::peek(uint16_t address)
   // NOTE: The following does not handle reading from RAM, however,
   // this function should never be called for RAM because of the
   // way page accessing has been setup
-  return myImage[(myCurrentSlice[address >> 11] << 11) + (address & 0x07FF)];
+  return myImage[(myState->myCurrentSlice[address >> 11] << 11) + (address & 0x07FF)];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -140,7 +146,7 @@ void CartridgeE7::poke(uint16_t address, uint8_t)
 void CartridgeE7::bankRAM(uint16_t bank)
 {
   // Remember what bank we're in
-  myCurrentRAM = bank;
+  myState->myCurrentRAM = bank;
   uint16_t offset = bank << 8;
   uint16_t shift = mySystem->pageShift();
 
@@ -153,7 +159,7 @@ void CartridgeE7::bankRAM(uint16_t bank)
   access.directPokeBase = 0;
   for(uint32_t j = 0x1800; j < 0x1900; j += (1 << shift))
   {
-    access.directPokeBase = &myRAM[1024 + offset + (j & 0x00FF)];
+    access.directPokeBase = &myState->myRAM[1024 + offset + (j & 0x00FF)];
     mySystem->setPageAccess(j >> shift, access);
   }
 
@@ -162,95 +168,85 @@ void CartridgeE7::bankRAM(uint16_t bank)
   access.directPokeBase = 0;
   for(uint32_t k = 0x1900; k < 0x1A00; k += (1 << shift))
   {
-    access.directPeekBase = &myRAM[1024 + offset + (k & 0x00FF)];
+    access.directPeekBase = &myState->myRAM[1024 + offset + (k & 0x00FF)];
     mySystem->setPageAccess(k >> shift, access);
   }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeE7::save(Serializer& out)
+size_t CartridgeE7::stateSize() const
 {
-  std::string cart = name();
+  return sizeof(CartridgeE7State);
+}
 
-  try
-  {
-    uint32_t i;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeE7::bindState(uint8_t* state)
+{
+  myState.bind(state);
+}
 
-    out.putString(cart);
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateWriter CartridgeE7::stateWriter() const
+{
+  return &writeState;
+}
 
-    out.putInt(2);
-    for(i = 0; i < 2; ++i)
-      out.putInt(myCurrentSlice[i]);
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeE7::writeState(const uint8_t* block, Serializer& out)
+{
+  const CartridgeE7State* state =
+      reinterpret_cast<const CartridgeE7State*>(block);
 
-    out.putInt(myCurrentRAM);
+  // The slices in the two segments
+  out.putInt(2);
+  for(uint32_t i = 0; i < 2; ++i)
+    out.putInt(state->myCurrentSlice[i]);
 
-    // The 2048 bytes of RAM
-    out.putInt(2048);
-    for(i = 0; i < 2048; ++i)
-      out.putInt(myRAM[i]);
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in save state for " << cart << std::endl;
-    return false;
-  }
+  // The 256 byte RAM bank in use
+  out.putInt(state->myCurrentRAM);
 
-  return true;
+  // The 2048 bytes of RAM
+  out.putInt(2048);
+  for(uint32_t i = 0; i < 2048; ++i)
+    out.putInt(state->myRAM[i]);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeE7::load(Deserializer& in)
+bool CartridgeE7::loadState(Deserializer& in, int)
 {
-  std::string cart = name();
-
-  try
-  {
-    if(in.getString() != cart)
-      return false;
-
-    uint32_t i, limit;
-
-    limit = (uint32_t) in.getInt();
-    for(i = 0; i < limit; ++i)
-      myCurrentSlice[i] = (uint16_t) in.getInt();
+  // The slices in the two segments
+  if((uint32_t) in.getInt() != 2)
+    return false;
+  for(uint32_t i = 0; i < 2; ++i)
+    myState->myCurrentSlice[i] = (uint16_t) in.getInt();
 
-    myCurrentRAM = (uint16_t) in.getInt();
+  // The 256 byte RAM bank in use
+  myState->myCurrentRAM = (uint16_t) in.getInt();
 
-    // The 2048 bytes of RAM
-    limit = (uint32_t) in.getInt();
-    for(i = 0; i < limit; ++i)
-      myRAM[i] = (uint8_t) in.getInt();
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
+  // The 2048 bytes of RAM
+  if((uint32_t) in.getInt() != 2048)
     return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in load state for " << cart << std::endl;
-    return false;
-  }
-
-  // Set up the previously used banks for the RAM and segment
-  bankRAM(myCurrentRAM);
-  bank(myCurrentSlice[0]);
+  for(uint32_t i = 0; i < 2048; ++i)
+    myState->myRAM[i] = (uint8_t) in.getInt();
 
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeE7::stateRestored()
+{
+  // Set up the previously used banks for the RAM and segment
+  bankRAM(myState->myCurrentRAM);
+  bank(myState->myCurrentSlice[0]);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeE7::bank(uint16_t slice)
 {
   if(bankLocked) return;
 
   // Remember what bank we're in
-  myCurrentSlice[0] = slice;
+  myState->myCurrentSlice[0] = slice;
   uint16_t offset = slice << 11;
   uint16_t shift = mySystem->pageShift();
 
@@ -278,7 +274,7 @@ void CartridgeE7::bank(uint16_t slice)
     access.directPokeBase = 0;
     for(uint32_t j = 0x1000; j < 0x1400; j += (1 << shift))
     {
-      access.directPokeBase = &myRAM[j & 0x03FF];
+      access.directPokeBase = &myState->myRAM[j & 0x03FF];
       mySystem->setPageAccess(j >> shift, access);
     }
 
@@ -287,7 +283,7 @@ void CartridgeE7::bank(uint16_t slice)
     access.directPokeBase = 0;
     for(uint32_t k = 0x1400; k < 0x1800; k += (1 << shift))
     {
-      access.directPeekBase = &myRAM[k & 0x03FF];
+      access.directPeekBase = &myState->myRAM[k & 0x03FF];
       mySystem->setPageAccess(k >> shift, access);
     }
   }
@@ -296,7 +292,7 @@ void CartridgeE7::bank(uint16_t slice)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int CartridgeE7::bank()
 {
-  return myCurrentSlice[0];
+  return myState->myCurrentSlice[0];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -309,8 +305,8 @@ int CartridgeE7::bankCount()
 bool CartridgeE7::patch(uint16_t address, uint8_t value)
 {
   address = address & 0x0FFF;
-  myImage[(myCurrentSlice[address >> 11] << 11) + (address & 0x07FF)] = value;
-  bank(myCurrentSlice[0]);
+  myImage[(myState->myCurrentSlice[address >> 11] << 11) + (address & 0x07FF)] = value;
+  bank(myState->myCurrentSlice[0]);
   return true;
 }
 
@@ -23,8 +23,6 @@ namespace ale {
 namespace stella {
 
 class System;
-class Serializer;
-class Deserializer;
 
 }  // namespace stella
 }  // namespace ale
@@ -34,6 +32,22 @@ class Deserializer;
 namespace ale {
 namespace stella {
 
+/**
+  The bank switching state and RAM of the cartridge, kept apart from the
+  ROM image so that they can be saved and restored as one block.
+*/
+struct CartridgeE7State
+{
+  // Indicates which slice is in the segment
+  uint16_t myCurrentSlice[2];
+
+  // Indicates which 256 byte bank of RAM is being used
+  uint16_t myCurrentRAM;
+
+  // The 2048 bytes of RAM
+  uint8_t myRAM[2048];
+};
+
 /**
   This is the cartridge class for M-Network bankswitched games.
   In this bankswitching scheme the 2600's 4K cartridge address
@@ -86,6 +100,14 @@ class CartridgeE7 : public Cartridge
     */
     virtual const char* name() const;
 
+    /**
+      Answers the number of bytes of memory owned by the device, including
+      the device object itself
+
+      @return The number of bytes
+    */
+    virtual size_t memoryUsage() const;
+
     /**
       Reset device to its power-on state
     */
@@ -100,20 +122,43 @@ class CartridgeE7 : public Cartridge
     virtual void install(System& system);
 
     /**
-      Saves the current state of this device to the given Serializer.
+      Answers the number of bytes of the state block of the cartridge.
+
+      @return The size of the state block
+    */
+    virtual size_t stateSize() const;
+
+    /**
+      Moves the state block of the cartridge to the given stateSize() bytes
+      of the machine state.
 
-      @param out The serializer device to save to.
-      @return The result of the save.  True on success, false on failure.
+      @param state The bytes to move the block to
     */
-    virtual bool save(Serializer& out);
+    virtual void bindState(uint8_t* state);
 
     /**
-      Loads the current state of this device from the given Deserializer.
+      Answers the function writing the state block of the cartridge to a
+      saved state in the portable format.
+
+      @return The writer of the state block
+    */
+    virtual StateWriter stateWriter() const;
+
+    /**
+      Reads the state block of the cartridge from a saved state in the given
+      version of the portable format.
 
       @param in The deserializer device to load from.
+      @param version The version of the format
       @return The result of the load.  True on success, false on failure.
     */
-    virtual bool load(Deserializer& in);
+    virtual bool loadState(Deserializer& in, int version);
+
+    /**
+      Notification method invoked by the system right after it has
+      overwritten the machine state with a saved one.
+    */
+    virtual void stateRestored();
 
     /**
       Install pages for the specified bank in the system.
@@ -176,17 +221,15 @@ class CartridgeE7 : public Cartridge
     void bankRAM(uint16_t bank);
 
   private:
-    // Indicates which slice is in the segment
-    uint16_t myCurrentSlice[2];
-
-    // Indicates which 256 byte bank of RAM is being used
-    uint16_t myCurrentRAM;
-
     // The 16K ROM image of the cartridge
     uint8_t myImage[16384];
 
-    // The 2048 bytes of RAM
-    uint8_t myRAM[2048];
+  private:
+    // Writes a state block field by field
+    static void writeState(const uint8_t* block, Serializer& out);
+
+    // The bank switching state and RAM of the cartridge
+    StateView<CartridgeE7State> myState;
 };
 
 }  // namespace stella
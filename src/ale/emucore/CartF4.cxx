@@ -47,6 +47,12 @@ const char* CartridgeF4::name() const
   return "CartridgeF4";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t CartridgeF4::memoryUsage() const
+{
+  return sizeof(*this);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeF4::reset()
 {
@@ -89,7 +95,7 @@ uint8_t CartridgeF4::peek(uint16_t address)
     bank(address - 0x0FF4);
   }
 
-  return myImage[myCurrentBank * 4096 + address];
+  return myImage[myState->myCurrentBank * 4096 + address];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -105,68 +111,55 @@ void CartridgeF4::poke(uint16_t address, uint8_t)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeF4::save(Serializer& out)
+size_t CartridgeF4::stateSize() const
 {
-  std::string cart = name();
-
-  try
-  {
-    out.putString(cart);
-    out.putInt(myCurrentBank);
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in save state for " << cart << std::endl;
-    return false;
-  }
+  return sizeof(CartridgeF4State);
+}
 
-  return true;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeF4::bindState(uint8_t* state)
+{
+  myState.bind(state);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeF4::load(Deserializer& in)
+StateWriter CartridgeF4::stateWriter() const
 {
-  std::string cart = name();
+  return &writeState;
+}
 
-  try
-  {
-    if(in.getString() != cart)
-    {
-      return false;
-    }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeF4::writeState(const uint8_t* block, Serializer& out)
+{
+  const CartridgeF4State* state =
+      reinterpret_cast<const CartridgeF4State*>(block);
 
-    myCurrentBank = (uint16_t)in.getInt();
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in load state for " << cart << std::endl;
-    return false;
-  }
+  out.putInt(state->myCurrentBank);
+}
 
-  // Remember what bank we were in
-  bank(myCurrentBank);
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeF4::loadState(Deserializer& in, int)
+{
+  myState->myCurrentBank = (uint16_t) in.getInt();
 
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeF4::stateRestored()
+{
+  // Remember what bank we were in
+  bank(myState->myCurrentBank);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeF4::bank(uint16_t bank)
 {
   if(bankLocked) return;
 
   // Remember what bank we're in
-  myCurrentBank = bank;
-  uint16_t offset = myCurrentBank * 4096;
+  myState->myCurrentBank = bank;
+  uint16_t offset = myState->myCurrentBank * 4096;
   uint16_t shift = mySystem->pageShift();
   uint16_t mask = mySystem->pageMask();
 
@@ -187,7 +180,7 @@ void CartridgeF4::bank(uint16_t bank)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int CartridgeF4::bank()
 {
-  return myCurrentBank;
+  return myState->myCurrentBank;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -200,7 +193,7 @@ int CartridgeF4::bankCount()
 bool CartridgeF4::patch(uint16_t address, uint8_t value)
 {
   address = address & 0x0FFF;
-  myImage[myCurrentBank * 4096 + address] = value;
+  myImage[myState->myCurrentBank * 4096 + address] = value;
   return true;
 }
 
@@ -48,12 +48,18 @@ const char* CartridgeF4SC::name() const
   return "CartridgeF4SC";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t CartridgeF4SC::memoryUsage() const
+{
+  return sizeof(*this);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeF4SC::reset()
 {
   // Initialize RAM with random values
   for(uint32_t i = 0; i < 128; ++i)
-    myRAM[i] = mySystem->rng().next();
+    myState->myRAM[i] = mySystem->rng().next();
 
   // Upon reset we switch to bank 0
   bank(0);
@@ -84,7 +90,7 @@ void CartridgeF4SC::install(System& system)
   {
     access.device = this;
     access.directPeekBase = 0;
-    access.directPokeBase = &myRAM[j & 0x007F];
+    access.directPokeBase = &myState->myRAM[j & 0x007F];
     mySystem->setPageAccess(j >> shift, access);
   }
 
@@ -92,7 +98,7 @@ void CartridgeF4SC::install(System& system)
   for(uint32_t k = 0x1080; k < 0x1100; k += (1 << shift))
   {
     access.device = this;
-    access.directPeekBase = &myRAM[k & 0x007F];
+    access.directPeekBase = &myState->myRAM[k & 0x007F];
     access.directPokeBase = 0;
     mySystem->setPageAccess(k >> shift, access);
   }
@@ -115,7 +121,7 @@ uint8_t CartridgeF4SC::peek(uint16_t address)
   // NOTE: This does not handle accessing RAM, however, this function
   // should never be called for RAM because of the way page accessing
   // has been setup
-  return myImage[myCurrentBank * 4096 + address];
+  return myImage[myState->myCurrentBank * 4096 + address];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -133,76 +139,66 @@ void CartridgeF4SC::poke(uint16_t address, uint8_t)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeF4SC::save(Serializer& out)
+size_t CartridgeF4SC::stateSize() const
 {
-  std::string cart = name();
-
-  try
-  {
-    out.putString(cart);
-
-    out.putInt(myCurrentBank);
+  return sizeof(CartridgeF4SCState);
+}
 
-    // The 128 bytes of RAM
-    out.putInt(128);
-    for(uint32_t i = 0; i < 128; ++i)
-      out.putInt(myRAM[i]);
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in save state for " << cart << std::endl;
-    return false;
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeF4SC::bindState(uint8_t* state)
+{
+  myState.bind(state);
+}
 
-  return true;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateWriter CartridgeF4SC::stateWriter() const
+{
+  return &writeState;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeF4SC::load(Deserializer& in)
+void CartridgeF4SC::writeState(const uint8_t* block, Serializer& out)
 {
-  std::string cart = name();
+  const CartridgeF4SCState* state =
+      reinterpret_cast<const CartridgeF4SCState*>(block);
 
-  try
-  {
-    if(in.getString() != cart)
-      return false;
+  out.putInt(state->myCurrentBank);
 
-    myCurrentBank = (uint16_t) in.getInt();
+  // The 128 bytes of RAM
+  out.putInt(128);
+  for(uint32_t i = 0; i < 128; ++i)
+    out.putInt(state->myRAM[i]);
+}
 
-    uint32_t limit = (uint32_t) in.getInt();
-    for(uint32_t i = 0; i < limit; ++i)
-      myRAM[i] = (uint8_t) in.getInt();
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in load state for " << cart << std::endl;
-    return false;
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeF4SC::loadState(Deserializer& in, int)
+{
+  myState->myCurrentBank = (uint16_t) in.getInt();
 
-  // Remember what bank we were in
-  bank(myCurrentBank);
+  // The 128 bytes of RAM
+  if((uint32_t) in.getInt() != 128)
+    return false;
+  for(uint32_t i = 0; i < 128; ++i)
+    myState->myRAM[i] = (uint8_t) in.getInt();
 
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeF4SC::stateRestored()
+{
+  // Remember what bank we were in
+  bank(myState->myCurrentBank);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeF4SC::bank(uint16_t bank)
 {
   if(bankLocked) return;
 
   // Remember what bank we're in
-  myCurrentBank = bank;
-  uint16_t offset = myCurrentBank * 4096;
+  myState->myCurrentBank = bank;
+  uint16_t offset = myState->myCurrentBank * 4096;
   uint16_t shift = mySystem->pageShift();
   uint16_t mask = mySystem->pageMask();
 
@@ -223,7 +219,7 @@ void CartridgeF4SC::bank(uint16_t bank)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int CartridgeF4SC::bank()
 {
-  return myCurrentBank;
+  return myState->myCurrentBank;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -236,7 +232,7 @@ int CartridgeF4SC::bankCount()
 bool CartridgeF4SC::patch(uint16_t address, uint8_t value)
 {
   address = address & 0x0FFF;
-  myImage[myCurrentBank * 4096 + address] = value;
+  myImage[myState->myCurrentBank * 4096 + address] = value;
   return true;
 }
 
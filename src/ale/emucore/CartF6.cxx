@@ -47,6 +47,12 @@ const char* CartridgeF6::name() const
   return "CartridgeF6";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t CartridgeF6::memoryUsage() const
+{
+  return sizeof(*this);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeF6::reset()
 {
@@ -110,7 +116,7 @@ uint8_t CartridgeF6::peek(uint16_t address)
       break;
   }
 
-  return myImage[myCurrentBank * 4096 + address];
+  return myImage[myState->myCurrentBank * 4096 + address];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -147,67 +153,55 @@ void CartridgeF6::poke(uint16_t address, uint8_t)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeF6::save(Serializer& out)
+size_t CartridgeF6::stateSize() const
 {
-  std::string cart = name();
-
-  try
-  {
-    out.putString(cart);
-
-    out.putInt(myCurrentBank);
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in save state for " << cart << std::endl;
-    return false;
-  }
+  return sizeof(CartridgeF6State);
+}
 
-  return true;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeF6::bindState(uint8_t* state)
+{
+  myState.bind(state);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeF6::load(Deserializer& in)
+StateWriter CartridgeF6::stateWriter() const
 {
-  std::string cart = name();
+  return &writeState;
+}
 
-  try
-  {
-    if(in.getString() != cart)
-      return false;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeF6::writeState(const uint8_t* block, Serializer& out)
+{
+  const CartridgeF6State* state =
+      reinterpret_cast<const CartridgeF6State*>(block);
 
-    myCurrentBank = (uint16_t) in.getInt();
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in load state for " << cart << std::endl;
-    return false;
-  }
+  out.putInt(state->myCurrentBank);
+}
 
-  // Remember what bank we were in
-  bank(myCurrentBank);
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeF6::loadState(Deserializer& in, int)
+{
+  myState->myCurrentBank = (uint16_t) in.getInt();
 
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeF6::stateRestored()
+{
+  // Remember what bank we were in
+  bank(myState->myCurrentBank);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeF6::bank(uint16_t bank)
 {
   if(bankLocked) return;
 
   // Remember what bank we're in
-  myCurrentBank = bank;
-  uint16_t offset = myCurrentBank * 4096;
+  myState->myCurrentBank = bank;
+  uint16_t offset = myState->myCurrentBank * 4096;
   uint16_t shift = mySystem->pageShift();
   uint16_t mask = mySystem->pageMask();
 
@@ -228,7 +222,7 @@ void CartridgeF6::bank(uint16_t bank)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int CartridgeF6::bank()
 {
-  return myCurrentBank;
+  return myState->myCurrentBank;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -241,7 +235,7 @@ int CartridgeF6::bankCount()
 bool CartridgeF6::patch(uint16_t address, uint8_t value)
 {
   address = address & 0x0FFF;
-  myImage[myCurrentBank * 4096 + address] = value;
+  myImage[myState->myCurrentBank * 4096 + address] = value;
   return true;
 }
 
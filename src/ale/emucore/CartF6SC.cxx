@@ -47,12 +47,18 @@ const char* CartridgeF6SC::name() const
   return "CartridgeF6SC";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t CartridgeF6SC::memoryUsage() const
+{
+  return sizeof(*this);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeF6SC::reset()
 {
   // Initialize RAM with random values
   for(uint32_t i = 0; i < 128; ++i)
-    myRAM[i] = mySystem->rng().next();
+    myState->myRAM[i] = mySystem->rng().next();
 
   // Upon reset we switch to bank 0
   bank(0);
@@ -83,7 +89,7 @@ void CartridgeF6SC::install(System& system)
   {
     access.device = this;
     access.directPeekBase = 0;
-    access.directPokeBase = &myRAM[j & 0x007F];
+    access.directPokeBase = &myState->myRAM[j & 0x007F];
     mySystem->setPageAccess(j >> shift, access);
   }
 
@@ -91,7 +97,7 @@ void CartridgeF6SC::install(System& system)
   for(uint32_t k = 0x1080; k < 0x1100; k += (1 << shift))
   {
     access.device = this;
-    access.directPeekBase = &myRAM[k & 0x007F];
+    access.directPeekBase = &myState->myRAM[k & 0x007F];
     access.directPokeBase = 0;
     mySystem->setPageAccess(k >> shift, access);
   }
@@ -135,7 +141,7 @@ uint8_t CartridgeF6SC::peek(uint16_t address)
   // NOTE: This does not handle accessing RAM, however, this function
   // should never be called for RAM because of the way page accessing
   // has been setup
-  return myImage[myCurrentBank * 4096 + address];
+  return myImage[myState->myCurrentBank * 4096 + address];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -176,78 +182,66 @@ void CartridgeF6SC::poke(uint16_t address, uint8_t)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeF6SC::save(Serializer& out)
+size_t CartridgeF6SC::stateSize() const
 {
-  std::string cart = name();
+  return sizeof(CartridgeF6SCState);
+}
 
-  try
-  {
-    out.putString(cart);
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeF6SC::bindState(uint8_t* state)
+{
+  myState.bind(state);
+}
 
-    out.putInt(myCurrentBank);
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateWriter CartridgeF6SC::stateWriter() const
+{
+  return &writeState;
+}
 
-    // The 128 bytes of RAM
-    out.putInt(128);
-    for(uint32_t i = 0; i < 128; ++i)
-      out.putInt(myRAM[i]);
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeF6SC::writeState(const uint8_t* block, Serializer& out)
+{
+  const CartridgeF6SCState* state =
+      reinterpret_cast<const CartridgeF6SCState*>(block);
 
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in save state for " << cart << std::endl;
-    return false;
-  }
+  out.putInt(state->myCurrentBank);
 
-  return true;
+  // The 128 bytes of RAM
+  out.putInt(128);
+  for(uint32_t i = 0; i < 128; ++i)
+    out.putInt(state->myRAM[i]);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeF6SC::load(Deserializer& in)
+bool CartridgeF6SC::loadState(Deserializer& in, int)
 {
-  std::string cart = name();
-
-  try
-  {
-    if(in.getString() != cart)
-      return false;
+  myState->myCurrentBank = (uint16_t) in.getInt();
 
-    myCurrentBank = (uint16_t) in.getInt();
-
-    // The 128 bytes of RAM
-    uint32_t limit = (uint32_t) in.getInt();
-    for(uint32_t i = 0; i < limit; ++i)
-      myRAM[i] = (uint8_t) in.getInt();
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in load state for " << cart << std::endl;
+  // The 128 bytes of RAM
+  if((uint32_t) in.getInt() != 128)
     return false;
-  }
-
-  // Remember what bank we were in
-  bank(myCurrentBank);
+  for(uint32_t i = 0; i < 128; ++i)
+    myState->myRAM[i] = (uint8_t) in.getInt();
 
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeF6SC::stateRestored()
+{
+  // Remember what bank we were in
+  bank(myState->myCurrentBank);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeF6SC::bank(uint16_t bank)
 {
   if(bankLocked) return;
 
   // Remember what bank we're in
-  myCurrentBank = bank;
-  uint16_t offset = myCurrentBank * 4096;
+  myState->myCurrentBank = bank;
+  uint16_t offset = myState->myCurrentBank * 4096;
   uint16_t shift = mySystem->pageShift();
   uint16_t mask = mySystem->pageMask();
 
@@ -268,7 +262,7 @@ void CartridgeF6SC::bank(uint16_t bank)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int CartridgeF6SC::bank()
 {
-  return myCurrentBank;
+  return myState->myCurrentBank;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -281,7 +275,7 @@ int CartridgeF6SC::bankCount()
 bool CartridgeF6SC::patch(uint16_t address, uint8_t value)
 {
   address = address & 0x0FFF;
-  myImage[myCurrentBank * 4096 + address] = value;
+  myImage[myState->myCurrentBank * 4096 + address] = value;
   return true;
 }
 
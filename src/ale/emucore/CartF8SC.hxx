@@ -23,8 +23,6 @@ namespace ale {
 namespace stella {
 
 class System;
-class Serializer;
-class Deserializer;
 
 }  // namespace stella
 }  // namespace ale
@@ -34,6 +32,19 @@ class Deserializer;
 namespace ale {
 namespace stella {
 
+/**
+  The bank switching state and RAM of the cartridge, kept apart from the
+  ROM image so that they can be saved and restored as one block.
+*/
+struct CartridgeF8SCState
+{
+  // Indicates which bank is currently active
+  uint16_t myCurrentBank;
+
+  // The 128 bytes of RAM
+  uint8_t myRAM[128];
+};
+
 /**
   Cartridge class used for Atari's 8K bankswitched games with
   128 bytes of RAM.  There are two 4K banks.
@@ -64,6 +75,14 @@ class CartridgeF8SC : public Cartridge
     */
     virtual const char* name() const;
 
+    /**
+      Answers the number of bytes of memory owned by the device, including
+      the device object itself
+
+      @return The number of bytes
+    */
+    virtual size_t memoryUsage() const;
+
     /**
       Reset device to its power-on state
     */
@@ -78,20 +97,43 @@ class CartridgeF8SC : public Cartridge
     virtual void install(System& system);
 
     /**
-      Saves the current state of this device to the given Serializer.
+      Answers the number of bytes of the state block of the cartridge.
+
+      @return The size of the state block
+    */
+    virtual size_t stateSize() const;
+
+    /**
+      Moves the state block of the cartridge to the given stateSize() bytes
+      of the machine state.
+
+      @param state The bytes to move the block to
+    */
+    virtual void bindState(uint8_t* state);
+
+    /**
+      Answers the function writing the state block of the cartridge to a
+      saved state in the portable format.
 
-      @param out The serializer device to save to.
-      @return The result of the save.  True on success, false on failure.
+      @return The writer of the state block
     */
-    virtual bool save(Serializer& out);
+    virtual StateWriter stateWriter() const;
 
     /**
-      Loads the current state of this device from the given Deserializer.
+      Reads the state block of the cartridge from a saved state in the given
+      version of the portable format.
 
       @param in The deserializer device to load from.
+      @param version The version of the format
       @return The result of the load.  True on success, false on failure.
     */
-    virtual bool load(Deserializer& in);
+    virtual bool loadState(Deserializer& in, int version);
+
+    /**
+      Notification method invoked by the system right after it has
+      overwritten the machine state with a saved one.
+    */
+    virtual void stateRestored();
 
     /**
       Install pages for the specified bank in the system.
@@ -146,14 +188,15 @@ class CartridgeF8SC : public Cartridge
     virtual void poke(uint16_t address, uint8_t value);
 
   private:
-    // Indicates which bank is currently active
-    uint16_t myCurrentBank;
-
     // The 8K ROM image of the cartridge
     uint8_t myImage[8192];
 
-    // The 128 bytes of RAM
-    uint8_t myRAM[128];
+  private:
+    // Writes a state block field by field
+    static void writeState(const uint8_t* block, Serializer& out);
+
+    // The bank switching state and RAM of the cartridge
+    StateView<CartridgeF8SCState> myState;
 };
 
 }  // namespace stella
@@ -47,12 +47,18 @@ const char* CartridgeFASC::name() const
   return "CartridgeFASC";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t CartridgeFASC::memoryUsage() const
+{
+  return sizeof(*this);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeFASC::reset()
 {
   // Initialize RAM with random values
   for(uint32_t i = 0; i < 256; ++i)
-    myRAM[i] = mySystem->rng().next();
+    myState->myRAM[i] = mySystem->rng().next();
 
   // Upon reset we switch to bank 2
   bank(2);
@@ -83,7 +89,7 @@ void CartridgeFASC::install(System& system)
   {
     access.device = this;
     access.directPeekBase = 0;
-    access.directPokeBase = &myRAM[j & 0x00FF];
+    access.directPokeBase = &myState->myRAM[j & 0x00FF];
     mySystem->setPageAccess(j >> shift, access);
   }
 
@@ -91,7 +97,7 @@ void CartridgeFASC::install(System& system)
   for(uint32_t k = 0x1100; k < 0x1200; k += (1 << shift))
   {
     access.device = this;
-    access.directPeekBase = &myRAM[k & 0x00FF];
+    access.directPeekBase = &myState->myRAM[k & 0x00FF];
     access.directPokeBase = 0;
     mySystem->setPageAccess(k >> shift, access);
   }
@@ -130,7 +136,7 @@ uint8_t CartridgeFASC::peek(uint16_t address)
   // NOTE: This does not handle accessing RAM, however, this function
   // should never be called for RAM because of the way page accessing
   // has been setup
-  return myImage[myCurrentBank * 4096 + address];
+  return myImage[myState->myCurrentBank * 4096 + address];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -166,76 +172,66 @@ void CartridgeFASC::poke(uint16_t address, uint8_t)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeFASC::save(Serializer& out)
+size_t CartridgeFASC::stateSize() const
 {
-  std::string cart = name();
-
-  try
-  {
-    out.putString(cart);
-
-    out.putInt(myCurrentBank);
+  return sizeof(CartridgeFASCState);
+}
 
-    // The 256 bytes of RAM
-    out.putInt(256);
-    for(uint32_t i = 0; i < 256; ++i)
-      out.putInt(myRAM[i]);
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in save state for " << cart << std::endl;
-    return false;
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeFASC::bindState(uint8_t* state)
+{
+  myState.bind(state);
+}
 
-  return true;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateWriter CartridgeFASC::stateWriter() const
+{
+  return &writeState;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeFASC::load(Deserializer& in)
+void CartridgeFASC::writeState(const uint8_t* block, Serializer& out)
 {
-  std::string cart = name();
+  const CartridgeFASCState* state =
+      reinterpret_cast<const CartridgeFASCState*>(block);
 
-  try
-  {
-    if(in.getString() != cart)
-      return false;
+  out.putInt(state->myCurrentBank);
 
-    myCurrentBank = (uint16_t) in.getInt();
+  // The 256 bytes of RAM
+  out.putInt(256);
+  for(uint32_t i = 0; i < 256; ++i)
+    out.putInt(state->myRAM[i]);
+}
 
-    uint32_t limit = (uint32_t) in.getInt();
-    for(uint32_t i = 0; i < limit; ++i)
-      myRAM[i] = (uint8_t) in.getInt();
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in load state for " << cart << std::endl;
-    return false;
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeFASC::loadState(Deserializer& in, int)
+{
+  myState->myCurrentBank = (uint16_t) in.getInt();
 
-  // Remember what bank we were in
-  bank(myCurrentBank);
+  // The 256 bytes of RAM
+  if((uint32_t) in.getInt() != 256)
+    return false;
+  for(uint32_t i = 0; i < 256; ++i)
+    myState->myRAM[i] = (uint8_t) in.getInt();
 
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeFASC::stateRestored()
+{
+  // Remember what bank we were in
+  bank(myState->myCurrentBank);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeFASC::bank(uint16_t bank)
 {
   if(bankLocked) return;
 
   // Remember what bank we're in
-  myCurrentBank = bank;
-  uint16_t offset = myCurrentBank * 4096;
+  myState->myCurrentBank = bank;
+  uint16_t offset = myState->myCurrentBank * 4096;
   uint16_t shift = mySystem->pageShift();
   uint16_t mask = mySystem->pageMask();
 
@@ -256,7 +252,7 @@ void CartridgeFASC::bank(uint16_t bank)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int CartridgeFASC::bank()
 {
-  return myCurrentBank;
+  return myState->myCurrentBank;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -269,7 +265,7 @@ int CartridgeFASC::bankCount()
 bool CartridgeFASC::patch(uint16_t address, uint8_t value)
 {
   address = address & 0x0FFF;
-  myImage[myCurrentBank * 4096 + address] = value;
+  myImage[myState->myCurrentBank * 4096 + address] = value;
   return true;
 }
 
@@ -19,8 +19,6 @@
 #include <cassert>
 
 #include "ale/emucore/System.hxx"
-#include "ale/emucore/Serializer.hxx"
-#include "ale/emucore/Deserializer.hxx"
 #include "ale/emucore/CartFE.hxx"
 
 namespace ale {
@@ -47,6 +45,12 @@ const char* CartridgeFE::name() const
   return "CartridgeFE";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t CartridgeFE::memoryUsage() const
+{
+  return sizeof(*this);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeFE::reset()
 {
@@ -86,49 +90,25 @@ void CartridgeFE::poke(uint16_t, uint8_t)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeFE::save(Serializer& out)
+size_t CartridgeFE::stateSize() const
 {
-  std::string cart = name();
-
-  try
-  {
-    out.putString(cart);
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in save state for " << cart << std::endl;
-    return false;
-  }
-
-  return true;
+  return 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeFE::load(Deserializer& in)
+void CartridgeFE::bindState(uint8_t*)
 {
-  std::string cart = name();
+}
 
-  try
-  {
-    if(in.getString() != cart)
-      return false;
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in load state for " << cart << std::endl;
-    return false;
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateWriter CartridgeFE::stateWriter() const
+{
+  return 0;
+}
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeFE::loadState(Deserializer&, int)
+{
   return true;
 }
 
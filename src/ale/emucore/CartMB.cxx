@@ -47,11 +47,17 @@ const char* CartridgeMB::name() const
   return "CartridgeMB";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t CartridgeMB::memoryUsage() const
+{
+  return sizeof(*this);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeMB::reset()
 {
   // Upon reset we switch to bank 1
-  myCurrentBank = 0;
+  myState->myCurrentBank = 0;
   incbank();
 }
 
@@ -76,7 +82,7 @@ void CartridgeMB::install(System& system)
   }
 
   // Install pages for bank 1
-  myCurrentBank = 0;
+  myState->myCurrentBank = 0;
   incbank();
 }
 
@@ -88,7 +94,7 @@ uint8_t CartridgeMB::peek(uint16_t address)
   // Switch to next bank
   if(address == 0x0FF0) incbank();
 
-  return myImage[myCurrentBank * 4096 + address];
+  return myImage[myState->myCurrentBank * 4096 + address];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -106,9 +112,9 @@ void CartridgeMB::incbank()
   if(bankLocked) return;
 
   // Remember what bank we're in
-  myCurrentBank ++;
-  myCurrentBank &= 0x0F;
-  uint16_t offset = myCurrentBank * 4096;
+  myState->myCurrentBank ++;
+  myState->myCurrentBank &= 0x0F;
+  uint16_t offset = myState->myCurrentBank * 4096;
   uint16_t shift = mySystem->pageShift();
   uint16_t mask = mySystem->pageMask();
 
@@ -127,58 +133,46 @@ void CartridgeMB::incbank()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeMB::save(Serializer& out)
+size_t CartridgeMB::stateSize() const
 {
-  std::string cart = name();
-
-  try
-  {
-    out.putString(cart);
+  return sizeof(CartridgeMBState);
+}
 
-    out.putInt(myCurrentBank);
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in save state for " << cart << std::endl;
-    return false;
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeMB::bindState(uint8_t* state)
+{
+  myState.bind(state);
+}
 
-  return true;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateWriter CartridgeMB::stateWriter() const
+{
+  return &writeState;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeMB::load(Deserializer& in)
+void CartridgeMB::writeState(const uint8_t* block, Serializer& out)
 {
-  std::string cart = name();
+  const CartridgeMBState* state =
+      reinterpret_cast<const CartridgeMBState*>(block);
 
-  try
-  {
-    if(in.getString() != cart)
-      return false;
+  out.putInt(state->myCurrentBank);
+}
 
-    myCurrentBank = (uint16_t) in.getInt();
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in load state for " << cart << std::endl;
-    return false;
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeMB::loadState(Deserializer& in, int)
+{
+  myState->myCurrentBank = (uint16_t) in.getInt();
+
+  return true;
+}
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeMB::stateRestored()
+{
   // Remember what bank we were in
-  --myCurrentBank;
+  --myState->myCurrentBank;
   incbank();
-
-  return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -186,14 +180,14 @@ void CartridgeMB::bank(uint16_t bank)
 {
   if(bankLocked) return;
 
-  myCurrentBank = (bank - 1);
+  myState->myCurrentBank = (bank - 1);
   incbank();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int CartridgeMB::bank()
 {
-  return myCurrentBank;
+  return myState->myCurrentBank;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -206,7 +200,7 @@ int CartridgeMB::bankCount()
 bool CartridgeMB::patch(uint16_t address, uint8_t value)
 {
   address = address & 0x0FFF;
-  myImage[myCurrentBank * 4096 + address] = value;
+  myImage[myState->myCurrentBank * 4096 + address] = value;
   return true;
 }
 
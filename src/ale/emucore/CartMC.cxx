@@ -28,14 +28,12 @@ namespace stella {
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 CartridgeMC::CartridgeMC(const uint8_t* image, uint32_t size)
-  : mySlot3Locked(false)
 {
+  myState->mySlot3Locked = false;
+
   // Make sure size is reasonable
   assert(size <= 128 * 1024);
 
-  // Allocate array for the cart's RAM
-  myRAM = new uint8_t[32 * 1024];
-
   // Allocate array for the ROM image
   myImage = new uint8_t[128 * 1024];
 
@@ -55,7 +53,6 @@ CartridgeMC::CartridgeMC(const uint8_t* image, uint32_t size)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 CartridgeMC::~CartridgeMC()
 {
-  delete[] myRAM;
   delete[] myImage;
 }
 
@@ -65,12 +62,18 @@ const char* CartridgeMC::name() const
   return "CartridgeMC";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t CartridgeMC::memoryUsage() const
+{
+  return sizeof(*this) + 128 * 1024;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeMC::reset()
 {
   // Initialize RAM with random values
   for(uint32_t i = 0; i < 32 * 1024; ++i)
-    myRAM[i] = mySystem->rng().next();
+    myState->myRAM[i] = mySystem->rng().next();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -119,13 +122,13 @@ uint8_t CartridgeMC::peek(uint16_t address)
   if((address == 0x1FFC) || (address == 0x1FFD))
   {
     // Indicate that slot 3 is locked for now
-    mySlot3Locked = true;
+    myState->mySlot3Locked = true;
   }
   // Should we unlock slot 3?
-  else if(mySlot3Locked && (address >= 0x1000) && (address <= 0x1BFF))
+  else if(myState->mySlot3Locked && (address >= 0x1000) && (address <= 0x1BFF))
   {
     // Indicate that slot 3 is unlocked now
-    mySlot3Locked = false;
+    myState->mySlot3Locked = false;
   }
 
   // Handle reads made to the TIA addresses
@@ -137,13 +140,13 @@ uint8_t CartridgeMC::peek(uint16_t address)
   {
     uint8_t block;
 
-    if(mySlot3Locked && ((address & 0x0C00) == 0x0C00))
+    if(myState->mySlot3Locked && ((address & 0x0C00) == 0x0C00))
     {
       block = 0xFF;
     }
     else
     {
-      block = myCurrentBlock[(address & 0x0C00) >> 10];
+      block = myState->myCurrentBlock[(address & 0x0C00) >> 10];
     }
 
     // Is this a RAM or a ROM access
@@ -158,12 +161,12 @@ uint8_t CartridgeMC::peek(uint16_t address)
       if(address & 0x0200)
       {
         // Reading from the read port of the RAM block
-        return myRAM[(uint32_t)(block & 0x3F) * 512 + (address & 0x01FF)];
+        return myState->myRAM[(uint32_t)(block & 0x3F) * 512 + (address & 0x01FF)];
       }
       else
       {
         // Oops, reading from the write port of the RAM block!
-        myRAM[(uint32_t)(block & 0x3F) * 512 + (address & 0x01FF)] = 0;
+        myState->myRAM[(uint32_t)(block & 0x3F) * 512 + (address & 0x01FF)] = 0;
         return 0;
       }
     }
@@ -179,109 +182,98 @@ void CartridgeMC::poke(uint16_t address, uint8_t value)
   if((address == 0x1FFC) || (address == 0x1FFD))
   {
     // Indicate that slot 3 is locked for now
-    mySlot3Locked = true;
+    myState->mySlot3Locked = true;
   }
   // Should we unlock slot 3?
-  else if(mySlot3Locked && (address >= 0x1000) && (address <= 0x1BFF))
+  else if(myState->mySlot3Locked && (address >= 0x1000) && (address <= 0x1BFF))
   {
     // Indicate that slot 3 is unlocked now
-    mySlot3Locked = false;
+    myState->mySlot3Locked = false;
   }
 
   // Handle bank-switching writes
   if((address >= 0x003C) && (address <= 0x003F))
   {
-    myCurrentBlock[address - 0x003C] = value;
+    myState->myCurrentBlock[address - 0x003C] = value;
   }
   else
   {
     uint8_t block;
 
-    if(mySlot3Locked && ((address & 0x0C00) == 0x0C00))
+    if(myState->mySlot3Locked && ((address & 0x0C00) == 0x0C00))
     {
       block = 0xFF;
     }
     else
     {
-      block = myCurrentBlock[(address & 0x0C00) >> 10];
+      block = myState->myCurrentBlock[(address & 0x0C00) >> 10];
     }
 
     // Is this a RAM write access
     if(!(block & 0x80) && !(address & 0x0200))
     {
       // Handle the write to RAM
-      myRAM[(uint32_t)(block & 0x3F) * 512 + (address & 0x01FF)] = value;
+      myState->myRAM[(uint32_t)(block & 0x3F) * 512 + (address & 0x01FF)] = value;
     }
   }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeMC::save(Serializer& out)
+size_t CartridgeMC::stateSize() const
 {
-  uint32_t i;
-  std::string cart = name();
-
-  try
-  {
-    out.putString(cart);
-
-    // The currentBlock array
-    out.putInt(4);
-    for(i = 0; i < 4; ++i)
-      out.putInt(myCurrentBlock[i]);
+  return sizeof(CartridgeMCState);
+}
 
-    // The 32K of RAM
-    out.putInt(32 * 1024);
-    for(i = 0; i < 32 * 1024; ++i)
-      out.putInt(myRAM[i]);
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in save state for " << cart << std::endl;
-    return false;
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeMC::bindState(uint8_t* state)
+{
+  myState.bind(state);
+}
 
-  return true;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateWriter CartridgeMC::stateWriter() const
+{
+  return &writeState;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeMC::load(Deserializer& in)
+void CartridgeMC::writeState(const uint8_t* block, Serializer& out)
 {
-  uint32_t i;
-  std::string cart = name();
+  const CartridgeMCState* state =
+      reinterpret_cast<const CartridgeMCState*>(block);
 
-  try
-  {
-    uint32_t limit;
+  // The currentBlock array
+  out.putInt(4);
+  for(uint32_t i = 0; i < 4; ++i)
+    out.putInt(state->myCurrentBlock[i]);
 
-    if(in.getString() != cart)
-      return false;
+  // The 32K of RAM
+  out.putInt(32 * 1024);
+  for(uint32_t i = 0; i < 32 * 1024; ++i)
+    out.putInt(state->myRAM[i]);
 
-    // The currentBlock array
-    limit = (uint32_t) in.getInt();
-    for(i = 0; i < limit; ++i)
-      myCurrentBlock[i] = (uint8_t) in.getInt();
+  // Indicates if slot 3 is locked to block $FF
+  out.putBool(state->mySlot3Locked);
+}
 
-    // The 32K of RAM
-    limit = (uint32_t) in.getInt();
-    for(i = 0; i < limit; ++i)
-      myRAM[i] = (uint8_t) in.getInt();
-  }
-  catch(const char* msg)
-  {
-    ale::Logger::Error << msg << std::endl;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeMC::loadState(Deserializer& in, int version)
+{
+  // The currentBlock array
+  if((uint32_t) in.getInt() != 4)
     return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in load state for " << cart << std::endl;
+  for(uint32_t i = 0; i < 4; ++i)
+    myState->myCurrentBlock[i] = (uint8_t) in.getInt();
+
+  // The 32K of RAM
+  if((uint32_t) in.getInt() != 32 * 1024)
     return false;
-  }
+  for(uint32_t i = 0; i < 32 * 1024; ++i)
+    myState->myRAM[i] = (uint8_t) in.getInt();
+
+  // Not in states of older versions of ALE
+  if(version != 0)
+    myState->mySlot3Locked = in.getBool();
 
   return true;
 }
@@ -23,8 +23,6 @@ namespace ale {
 namespace stella {
 
 class System;
-class Serializer;
-class Deserializer;
 
 }  // namespace stella
 }  // namespace ale
@@ -34,6 +32,22 @@ class Deserializer;
 namespace ale {
 namespace stella {
 
+/**
+  The block mapping and the 32K of RAM of the cartridge, kept apart from
+  the ROM image so that they can be saved and restored as one block.
+*/
+struct CartridgeMCState
+{
+  // Indicates which block is currently active for the four segments
+  uint8_t myCurrentBlock[4];
+
+  // Indicates if slot 3 is locked to block $FF or not
+  bool mySlot3Locked;
+
+  // The 32K bytes of RAM for the cartridge
+  uint8_t myRAM[32 * 1024];
+};
+
 /**
   This is the cartridge class for Chris Wilkson's Megacart.  It does not
   handle battery-backed RAM at this time and the code could use some serious
@@ -171,6 +185,14 @@ class CartridgeMC : public Cartridge
     */
     virtual const char* name() const;
 
+    /**
+      Answers the number of bytes of memory owned by the device, including
+      the device object itself
+
+      @return The number of bytes
+    */
+    virtual size_t memoryUsage() const;
+
     /**
       Reset device to its power-on state
     */
@@ -185,20 +207,37 @@ class CartridgeMC : public Cartridge
     virtual void install(System& system);
 
     /**
-      Saves the current state of this device to the given Serializer.
+      Answers the number of bytes of the state block of the cartridge.
 
-      @param out The serializer device to save to.
-      @return The result of the save.  True on success, false on failure.
+      @return The size of the state block
     */
-    virtual bool save(Serializer& out);
+    virtual size_t stateSize() const;
 
     /**
-      Loads the current state of this device from the given Deserializer.
+      Moves the state block of the cartridge to the given stateSize() bytes
+      of the machine state.
+
+      @param state The bytes to move the block to
+    */
+    virtual void bindState(uint8_t* state);
+
+    /**
+      Answers the function writing the state block of the cartridge to a
+      saved state in the portable format.
+
+      @return The writer of the state block
+    */
+    virtual StateWriter stateWriter() const;
+
+    /**
+      Reads the state block of the cartridge from a saved state in the given
+      version of the portable format.
 
       @param in The deserializer device to load from.
+      @param version The version of the format
       @return The result of the load.  True on success, false on failure.
     */
-    virtual bool load(Deserializer& in);
+    virtual bool loadState(Deserializer& in, int version);
 
     /**
       Install pages for the specified bank in the system.
@@ -253,17 +292,15 @@ class CartridgeMC : public Cartridge
     virtual void poke(uint16_t address, uint8_t value);
 
   private:
-    // Indicates which block is currently active for the four segments
-    uint8_t myCurrentBlock[4];
-
-    // Indicates if slot 3 is locked to block $FF or not
-    bool mySlot3Locked;
-
-    // Pointer to the 32K bytes of RAM for the cartridge
-    uint8_t* myRAM;
-
     // Pointer to the 128K bytes of ROM for the cartridge
     uint8_t* myImage;
+
+  private:
+    // Writes a state block field by field
+    static void writeState(const uint8_t* block, Serializer& out);
+
+    // The bank switching state and RAM of the cartridge
+    StateView<CartridgeMCState> myState;
 };
 
 }  // namespace stella
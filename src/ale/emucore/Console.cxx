@@ -29,6 +29,7 @@
 #include "ale/emucore/Joystick.hxx"
 #include "ale/emucore/M6502Hi.hxx"
 #include "ale/emucore/M6502Low.hxx"
+#include "ale/emucore/M6502LowFast.hxx"
 #include "ale/emucore/M6532.hxx"
 #include "ale/emucore/MediaSrc.hxx"
 #include "ale/emucore/Paddles.hxx"
@@ -42,6 +43,7 @@
 #include "ale/emucore/OSystem.hxx"
 
 #include "ale/common/Log.hpp"
+#include "ale/common/MemoryUsage.hpp"
 
 namespace ale {
 namespace stella {
@@ -49,7 +51,8 @@ namespace stella {
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Console::Console(OSystem* osystem, Cartridge* cart, const Properties& props)
   : myOSystem(osystem),
-    myProperties(props)
+    myProperties(props),
+    myCart(cart)
 {
   myControllers[0] = 0;
   myControllers[1] = 0;
@@ -108,19 +111,21 @@ Console::Console(OSystem* osystem, Cartridge* cart, const Properties& props)
   myControllers[0]->setSystem(mySystem);
   myControllers[1]->setSystem(mySystem);
 
+  M6532* m6532 = new M6532(*this);
+
+  TIA *tia = new TIA(*this, myOSystem->settings());
+  tia->setSound(myOSystem->sound());
+
+  // The low compatibility CPU is specialised for the cartridge type when
+  // one is available, which saves the virtual calls on I/O and hotspots
   M6502* m6502;
   if(myOSystem->settings().getString("cpu") == "low") {
-    m6502 = new M6502Low(1);
+    m6502 = createM6502Low(1, *cart, *m6532, *tia);
   }
   else {
     m6502 = new M6502High(1);
   }
 
-  M6532* m6532 = new M6532(*this);
-
-  TIA *tia = new TIA(*this, myOSystem->settings());
-  tia->setSound(myOSystem->sound());
-
   mySystem->attach(m6502);
   mySystem->attach(m6532);
   mySystem->attach(tia);
@@ -186,6 +191,27 @@ void Console::setProperties(const Properties& props)
   myProperties = props;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Console::memoryUsage(MemoryUsage& usage) const
+{
+  size_t bytes = sizeof(*this) - sizeof(myProperties) +
+                 myProperties.memoryUsage() + sizeof(Switches) +
+                 MemoryUsage::heapBytes(myDisplayFormat) +
+                 MemoryUsage::heapBytes(myAboutString);
+  for(int i = 0; i < 2; ++i)
+  {
+    if(dynamic_cast<const Paddles*>(myControllers[i]) != 0)
+      bytes += sizeof(Paddles);
+    else if(myControllers[i] != 0)
+      bytes += sizeof(Joystick);
+  }
+  usage.add("Console", bytes);
+
+  // The media source is the TIA, which the system accounts for
+  mySystem->memoryUsage(usage);
+  usage.add("TIA tables", TIA::tablesMemoryUsage(), true);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uint32_t Console::getFrameRate() const
 {
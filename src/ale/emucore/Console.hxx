@@ -31,6 +31,9 @@ class Switches;
 class System;
 
 }  // namespace stella
+
+class MemoryUsage;
+
 }  // namespace ale
 
 #include "ale/emucore/Control.hxx"
@@ -111,6 +114,13 @@ class Console
     */
     System& system() const { return *mySystem; }
 
+    /**
+      Get the cartridge plugged into the console
+
+      @return The cartridge
+    */
+    Cartridge& cartridge() const { return *myCart; }
+
     /**
       Returns the OSystem for this emulator.
 
@@ -130,6 +140,14 @@ class Console
     */
     const std::string& about() const { return myAboutString; }
 
+    /**
+      Adds the memory held by this console and its system to the given
+      accounting, one entry per object.
+
+      @param usage The accounting to add to
+    */
+    void memoryUsage(MemoryUsage& usage) const;
+
   public:
     /**
       Overloaded assignment operator
@@ -173,6 +191,9 @@ class Console
     // Pointer to the 6502 based system being emulated
     System* mySystem;
 
+    // Pointer to the cartridge, which is attached to the system
+    Cartridge* myCart;
+
     // The currently defined display format (NTSC/PAL/PAL60)
     std::string myDisplayFormat;
 
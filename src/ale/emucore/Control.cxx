@@ -26,7 +26,8 @@ namespace stella {
 Controller::Controller(Jack jack, const Event& event, Type type)
   : myJack(jack),
     myEvent(event),
-    myType(type)
+    myType(type),
+    myPolled(false)
 {
 }
 
@@ -51,7 +52,8 @@ const int Controller::minimumResistance = 0x00000000;
 Controller::Controller(const Controller& c)
   : myJack(c.myJack),
     myEvent(c.myEvent),
-    myType(c.myType)
+    myType(c.myType),
+    myPolled(false)
 {
   assert(false);
 }
@@ -149,6 +149,21 @@ class Controller
     */
     virtual void write(DigitalPin pin, bool value) = 0;
 
+  public:
+    /**
+      Answers true iff the game has read one of the input pins of this
+      controller since the last call to resetPolled().  This is used to
+      find out whether the game is listening to the player at all.
+
+      @return Whether the controller has been polled
+    */
+    bool polled() const { return myPolled; }
+
+    /**
+      Forget about any previous reads of the input pins.
+    */
+    void resetPolled() { myPolled = false; }
+
   public:
     /// Constant which represents maximum resistance for analog pins
     static const int maximumResistance;
@@ -169,6 +184,9 @@ class Controller
     /// Pointer to the System object (used for timing purposes)
     System* mySystem;
 
+    /// Set whenever the game reads one of the input pins
+    bool myPolled;
+
   protected:
     // Copy constructor isn't supported by controllers so make it private
     Controller(const Controller&);
@@ -84,5 +84,23 @@ bool Deserializer::getBool(void)
   return result;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Deserializer::getBytes(uint8_t* data, uint32_t size)
+{
+  if((uint32_t) getInt() != size)
+    throw "Deserializer: data corruption";
+
+  myStream.read((char*)data, (std::streamsize)size);
+
+  if(myStream.bad() || (uint32_t) myStream.gcount() != size)
+    throw "Deserializer: file read failed";
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t Deserializer::position(void)
+{
+  return (size_t) myStream.tellg();
+}
+
 }  // namespace stella
 }  // namespace ale
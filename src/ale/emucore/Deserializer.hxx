@@ -19,6 +19,7 @@
 #ifndef DESERIALIZER_HXX
 #define DESERIALIZER_HXX
 
+#include <cstdint>
 #include <sstream>
 
 namespace ale {
@@ -70,6 +71,22 @@ class Deserializer {
          */
         bool getBool(void);
 
+        /**
+         Reads a block of bytes written by Serializer::putBytes from the
+         current input stream.  The block must have the given size.
+
+         @param data The buffer to read the bytes into.
+         @param size The number of bytes expected.
+         */
+        void getBytes(uint8_t* data, uint32_t size);
+
+        /**
+         Answers the number of bytes read so far.
+
+         @result The offset of the next byte to read.
+         */
+        size_t position(void);
+
         bool isOpen(void) {return true;}
     private:
         // The stream to get the deserialized data from.
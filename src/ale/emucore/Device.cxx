@@ -38,5 +38,31 @@ void Device::systemCyclesReset()
   // By default I do nothing when my system resets its cycle counter
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Device::stateRestoring()
+{
+  // By default I have nothing to do before my state block is overwritten
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Device::stateRestored()
+{
+  // By default nothing is derived from my state block
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Device::save(Serializer&)
+{
+  // By default all of my state is in my state block
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Device::load(Deserializer&)
+{
+  // By default all of my state is in my state block
+  return true;
+}
+
 }  // namespace stella
 }  // namespace ale
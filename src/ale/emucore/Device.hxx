@@ -29,11 +29,69 @@ class Deserializer;
 }  // namespace stella
 }  // namespace ale
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <new>
 
 namespace ale {
 namespace stella {
 
+/**
+  Writes a state block of a part of the system field by field, in the
+  portable format of saved states, to the given Serializer.  The block is
+  aligned as in the machine state, but need not belong to a live part.
+*/
+typedef void (*StateWriter)(const uint8_t* state, Serializer& out);
+
+/**
+  The access a part of the system has to its state block.  The block
+  starts out in storage of its own and is moved into the machine state
+  of the system by bind(); the part reaches its fields through the view
+  wherever the block is.
+*/
+template<class State>
+class StateView
+{
+  public:
+    /**
+      Create a view of a new, zeroed block
+    */
+    StateView()
+      : myStorage(new State()),
+        myState(myStorage.get())
+    {
+    }
+
+    /**
+      Moves the block to the given sizeof(State) bytes
+
+      @param state The bytes to move the block to
+    */
+    void bind(uint8_t* state)
+    {
+      myState = new(state) State(*myState);
+      myStorage.reset();
+    }
+
+    State* operator->() const { return myState; }
+    State& operator*() const { return *myState; }
+
+  private:
+    // The block until it is bound, or the null pointer
+    std::unique_ptr<State> myStorage;
+
+    // The block
+    State* myState;
+
+  private:
+    // Copy constructor isn't supported by this class so make it private
+    StateView(const StateView&);
+
+    // Assignment operator isn't supported by this class so make it private
+    StateView& operator = (const StateView&);
+};
+
 /**
   Abstract base class for devices which can be attached to a 6502
   based system.
@@ -62,6 +120,14 @@ class Device
     */
     virtual const char* name() const = 0;
 
+    /**
+      Answers the number of bytes of memory owned by the device, including
+      the device object itself
+
+      @return The number of bytes
+    */
+    virtual size_t memoryUsage() const = 0;
+
     /**
       Reset device to its power-on state
     */
@@ -83,20 +149,73 @@ class Device
     virtual void install(System& system) = 0;
 
     /**
-      Saves the current state of this device to the given Serializer.
+      Answers the number of bytes of the state block of the device.  The
+      block holds everything that changes while the device runs; read-only
+      data such as ROM images is left out.
+
+      @return The size of the state block
+    */
+    virtual size_t stateSize() const = 0;
+
+    /**
+      Moves the state block of the device to the given stateSize() bytes
+      of the machine state, where the device works on it from then on.
+      Invoked by the system when the machine state is laid out.
+
+      @param state The bytes to move the block to
+    */
+    virtual void bindState(uint8_t* state) = 0;
+
+    /**
+      Answers the function writing the state block of the device to a
+      saved state in the portable format.
+
+      @return The writer of the state block
+    */
+    virtual StateWriter stateWriter() const = 0;
+
+    /**
+      Reads the state block of the device from a saved state in the given
+      version of the portable format (version 0 is the format of older
+      versions of ALE).  The name of the device has been read already.
+
+      @param in The deserializer device to load from.
+      @param version The version of the format
+      @return The result of the load.  True on success, false on failure.
+    */
+    virtual bool loadState(Deserializer& in, int version) = 0;
+
+    /**
+      Notification method invoked by the system right before it
+      overwrites the machine state with a saved one.
+    */
+    virtual void stateRestoring();
+
+    /**
+      Notification method invoked by the system right after it has
+      overwritten the machine state with a saved one.  Devices which
+      derive anything from their state block, such as the pages mapped to
+      the current bank, bring it up to date here.
+    */
+    virtual void stateRestored();
+
+    /**
+      Saves any state of this device which is kept outside of its state
+      block to the given Serializer.  The default saves nothing.
 
       @param out The serializer device to save to.
       @return The result of the save.  True on success, false on failure.
     */
-    virtual bool save(Serializer& out) = 0;
+    virtual bool save(Serializer& out);
 
     /**
-      Loads the current state of this device from the given Deserializer.
+      Loads any state of this device which is kept outside of its state
+      block from the given Deserializer.  The default loads nothing.
 
       @param in The deserializer device to load from.
       @return The result of the load.  True on success, false on failure.
     */
-    virtual bool load(Deserializer& in) = 0;
+    virtual bool load(Deserializer& in);
 
   public:
     /**
@@ -37,6 +37,8 @@ Joystick::~Joystick()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Joystick::read(DigitalPin pin)
 {
+  myPolled = true;
+
   switch(pin)
   {
     case One:
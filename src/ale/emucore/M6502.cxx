@@ -17,6 +17,8 @@
 //============================================================================
 
 #include "ale/emucore/M6502.hxx"
+#include "ale/emucore/Serializer.hxx"
+#include "ale/emucore/Deserializer.hxx"
 
 #include <mutex>
 #include <cstdint>
@@ -29,8 +31,7 @@ namespace stella {
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 M6502::M6502(uint32_t systemCyclesPerProcessorCycle)
-    : myExecutionStatus(0),
-      mySystem(0),
+    : mySystem(0),
       mySystemCyclesPerProcessorCycle(systemCyclesPerProcessorCycle)
 {
   // Compute the BCD lookup table
@@ -68,36 +69,105 @@ void M6502::install(System& system)
 void M6502::reset()
 {
   // Clear the execution status flags
-  myExecutionStatus = 0;
+  myState->myExecutionStatus = 0;
 
   // Set registers to default values
-  A = X = Y = 0;
-  SP = 0xff;
+  myState->A = myState->X = myState->Y = 0;
+  myState->SP = 0xff;
   PS(0x20);
 
   // Reset access flag
-  myLastAccessWasRead = true;
+  myState->myLastAccessWasRead = true;
 
   // Load PC from the reset vector
-  PC = (uint16_t)mySystem->peek(0xfffc) | ((uint16_t)mySystem->peek(0xfffd) << 8);
+  myState->PC = (uint16_t)mySystem->peek(0xfffc) | ((uint16_t)mySystem->peek(0xfffd) << 8);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::irq()
 {
-  myExecutionStatus |= MaskableInterruptBit;
+  myState->myExecutionStatus |= MaskableInterruptBit;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::nmi()
 {
-  myExecutionStatus |= NonmaskableInterruptBit;
+  myState->myExecutionStatus |= NonmaskableInterruptBit;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::stop()
 {
-  myExecutionStatus |= StopExecutionBit;
+  myState->myExecutionStatus |= StopExecutionBit;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t M6502::stateSize() const
+{
+  return sizeof(M6502State);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::bindState(uint8_t* state)
+{
+  myState.bind(state);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateWriter M6502::stateWriter() const
+{
+  return &writeState;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::writeState(const uint8_t* block, Serializer& out)
+{
+  const M6502State* state = reinterpret_cast<const M6502State*>(block);
+
+  out.putInt(state->A);    // Accumulator
+  out.putInt(state->X);    // X index register
+  out.putInt(state->Y);    // Y index register
+  out.putInt(state->SP);   // Stack Pointer
+  out.putInt(state->IR);   // Instruction register
+  out.putInt(state->PC);   // Program Counter
+
+  out.putBool(state->N);     // N flag for processor status register
+  out.putBool(state->V);     // V flag for processor status register
+  out.putBool(state->B);     // B flag for processor status register
+  out.putBool(state->D);     // D flag for processor status register
+  out.putBool(state->I);     // I flag for processor status register
+  out.putBool(state->notZ);  // Z flag complement for processor status register
+  out.putBool(state->C);     // C flag for processor status register
+
+  out.putInt(state->myExecutionStatus);
+  out.putBool(state->myLastAccessWasRead);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool M6502::loadState(Deserializer& in, int version)
+{
+  myState->A = (uint8_t) in.getInt();    // Accumulator
+  myState->X = (uint8_t) in.getInt();    // X index register
+  myState->Y = (uint8_t) in.getInt();    // Y index register
+  myState->SP = (uint8_t) in.getInt();   // Stack Pointer
+  myState->IR = (uint8_t) in.getInt();   // Instruction register
+  myState->PC = (uint16_t) in.getInt();  // Program Counter
+
+  myState->N = in.getBool();     // N flag for processor status register
+  myState->V = in.getBool();     // V flag for processor status register
+  myState->B = in.getBool();     // B flag for processor status register
+  myState->D = in.getBool();     // D flag for processor status register
+  myState->I = in.getBool();     // I flag for processor status register
+  myState->notZ = in.getBool();  // Z flag complement for processor status register
+  myState->C = in.getBool();     // C flag for processor status register
+
+  myState->myExecutionStatus = (uint8_t) in.getInt();
+
+  // Not in states of older versions of ALE
+  if(version != 0)
+    myState->myLastAccessWasRead = in.getBool();
+
+  return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -111,19 +181,19 @@ uint8_t M6502::PS() const
 {
   uint8_t ps = 0x20;
 
-  if(N)
+  if(myState->N)
     ps |= 0x80;
-  if(V)
+  if(myState->V)
     ps |= 0x40;
-  if(B)
+  if(myState->B)
     ps |= 0x10;
-  if(D)
+  if(myState->D)
     ps |= 0x08;
-  if(I)
+  if(myState->I)
     ps |= 0x04;
-  if(!notZ)
+  if(!myState->notZ)
     ps |= 0x02;
-  if(C)
+  if(myState->C)
     ps |= 0x01;
 
   return ps;
@@ -132,13 +202,13 @@ uint8_t M6502::PS() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::PS(uint8_t ps)
 {
-  N = ps & 0x80;
-  V = ps & 0x40;
-  B = true;        // B = ps & 0x10;  The 6507's B flag always true
-  D = ps & 0x08;
-  I = ps & 0x04;
-  notZ = !(ps & 0x02);
-  C = ps & 0x01;
+  myState->N = ps & 0x80;
+  myState->V = ps & 0x40;
+  myState->B = true;        // B = ps & 0x10;  The 6507's B flag always true
+  myState->D = ps & 0x08;
+  myState->I = ps & 0x04;
+  myState->notZ = !(ps & 0x02);
+  myState->C = ps & 0x01;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -23,18 +23,50 @@ namespace ale {
 namespace stella {
 
 class M6502;
-class Serializer;
-class Deserializer;
 
 }  // namespace stella
 }  // namespace ale
 
 #include "ale/emucore/System.hxx"
+#include <cstddef>
 #include <cstdint>
 
 namespace ale {
 namespace stella {
 
+/**
+  The registers and execution status of the 6502.  They are kept together
+  in a trivially copyable block, which the processor works on in the
+  machine state of its system.
+*/
+struct M6502State
+{
+  uint8_t A;    // Accumulator
+  uint8_t X;    // X index register
+  uint8_t Y;    // Y index register
+  uint8_t SP;   // Stack Pointer
+  uint8_t IR;   // Instruction register
+  uint16_t PC;  // Program Counter
+
+  bool N;     // N flag for processor status register
+  bool V;     // V flag for processor status register
+  bool B;     // B flag for processor status register
+  bool D;     // D flag for processor status register
+  bool I;     // I flag for processor status register
+  bool notZ;  // Z flag complement for processor status register
+  bool C;     // C flag for processor status register
+
+  /**
+    Bit fields used to indicate that certain conditions need to be
+    handled such as stopping execution, fatal errors, maskable interrupts
+    and non-maskable interrupts
+  */
+  uint8_t myExecutionStatus;
+
+  /// Indicates if the last memory access was a read or not
+  bool myLastAccessWasRead;
+};
+
 /**
   This is an abstract base class for classes that emulate the
   6502 microprocessor.  The 6502 is an 8-bit microprocessor that
@@ -45,6 +77,8 @@ namespace stella {
 */
 class M6502
 {
+  friend class M6502Lockstep;
+
   public:
     /**
       Enumeration of the 6502 addressing modes
@@ -98,20 +132,40 @@ class M6502
     virtual void nmi();
 
     /**
-      Saves the current state of this device to the given Serializer.
+      Answers the number of bytes of the state block of the processor.
+
+      @return The size of the state block
+    */
+    virtual size_t stateSize() const;
+
+    /**
+      Moves the state block of the processor to the given stateSize()
+      bytes of the machine state, where the processor works on it from
+      then on.
+
+      @param state The bytes to move the block to
+    */
+    virtual void bindState(uint8_t* state);
+
+    /**
+      Answers the function writing the state block of the processor to a
+      saved state in the portable format.
 
-      @param out The serializer device to save to.
-      @return The result of the save.  True on success, false on failure.
+      @return The writer of the state block
     */
-    virtual bool save(Serializer& out) = 0;
+    virtual StateWriter stateWriter() const;
 
     /**
-      Loads the current state of this device from the given Deserializer.
+      Reads the state block of the processor from a saved state in the
+      given version of the portable format (version 0 is the format of
+      older versions of ALE).  The name of the processor has been read
+      already.
 
       @param in The deserializer device to load from.
+      @param version The version of the format
       @return The result of the load.  True on success, false on failure.
     */
-    virtual bool load(Deserializer& in) = 0;
+    virtual bool loadState(Deserializer& in, int version);
 
     /**
       Get a null terminated string which is the processor's name (i.e. "M6532")
@@ -120,6 +174,14 @@ class M6502
     */
     virtual const char* name() const = 0;
 
+    /**
+      Answers the number of bytes of memory owned by the processor,
+      including the processor object itself
+
+      @return The number of bytes
+    */
+    virtual size_t memoryUsage() const = 0;
+
   public:
     /**
       Get the addressing mode of the specified instruction
@@ -155,7 +217,7 @@ class M6502
     */
     bool fatalError() const
     {
-      return myExecutionStatus & FatalErrorBit;
+      return myState->myExecutionStatus & FatalErrorBit;
     }
 
     /**
@@ -163,14 +225,14 @@ class M6502
 
       @return The program counter register
     */
-    uint16_t getPC() const { return PC; }
+    uint16_t getPC() const { return myState->PC; }
 
     /**
       Answer true iff the last memory access was a read.
 
       @return true iff last access was a read.
     */
-    bool lastAccessWasRead() const { return myLastAccessWasRead; }
+    bool lastAccessWasRead() const { return myState->myLastAccessWasRead; }
 
   public:
     /**
@@ -197,28 +259,6 @@ class M6502
     void PS(uint8_t ps);
 
   protected:
-    uint8_t A;    // Accumulator
-    uint8_t X;    // X index register
-    uint8_t Y;    // Y index register
-    uint8_t SP;   // Stack Pointer
-    uint8_t IR;   // Instruction register
-    uint16_t PC;  // Program Counter
-
-    bool N;     // N flag for processor status register
-    bool V;     // V flag for processor status register
-    bool B;     // B flag for processor status register
-    bool D;     // D flag for processor status register
-    bool I;     // I flag for processor status register
-    bool notZ;  // Z flag complement for processor status register
-    bool C;     // C flag for processor status register
-
-    /**
-      Bit fields used to indicate that certain conditions need to be
-      handled such as stopping execution, fatal errors, maskable interrupts
-      and non-maskable interrupts
-    */
-    uint8_t myExecutionStatus;
-
     /**
       Constants used for setting bits in myExecutionStatus
     */
@@ -233,15 +273,15 @@ class M6502
     /// Pointer to the system the processor is installed in or the null pointer
     System* mySystem;
 
+    /// The registers and execution status
+    StateView<M6502State> myState;
+
     /// Indicates the number of system cycles per processor cycle
     const uint32_t mySystemCyclesPerProcessorCycle;
 
     /// Table of system cycles for each instruction
     uint32_t myInstructionSystemCycleTable[256];
 
-    /// Indicates if the last memory access was a read or not
-    bool myLastAccessWasRead;
-
   protected:
     /// Addressing mode for each of the 256 opcodes
     static AddressingMode ourAddressingModeTable[256];
@@ -259,6 +299,10 @@ class M6502
     static const char* ourInstructionMnemonicTable[256];
 
     int myTotalInstructionCount;
+
+  protected:
+    /// Writes the registers and execution status of a state block
+    static void writeState(const uint8_t* block, Serializer& out);
 };
 
 }  // namespace stella
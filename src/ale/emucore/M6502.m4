@@ -28,646 +28,647 @@
 #endif
 
 define(M6502_ADC, `{
-  uint8_t oldA = A;
+  uint8_t oldA = myState->A;
 
-  if(!D)
+  if(!myState->D)
   {
-    int16_t sum = (int16_t)((int8_t)A) + (int16_t)((int8_t)operand) + (C ? 1 : 0);
-    V = ((sum > 127) || (sum < -128));
-
-    sum = (int16_t)A + (int16_t)operand + (C ? 1 : 0);
-    A = sum;
-    C = (sum > 0xff);
-    notZ = A;
-    N = A & 0x80;
+    int16_t sum = (int16_t)((int8_t)myState->A) + (int16_t)((int8_t)operand) + (myState->C ? 1 : 0);
+    myState->V = ((sum > 127) || (sum < -128));
+
+    sum = (int16_t)myState->A + (int16_t)operand + (myState->C ? 1 : 0);
+    myState->A = sum;
+    myState->C = (sum > 0xff);
+    myState->notZ = myState->A;
+    myState->N = myState->A & 0x80;
   }
   else
   {
-    int16_t sum = ourBCDTable[0][A] + ourBCDTable[0][operand] + (C ? 1 : 0);
+    int16_t sum = ourBCDTable[0][myState->A] + ourBCDTable[0][operand] + (myState->C ? 1 : 0);
 
-    C = (sum > 99);
-    A = ourBCDTable[1][sum & 0xff];
-    notZ = A;
-    N = A & 0x80;
-    V = ((oldA ^ A) & 0x80) && ((A ^ operand) & 0x80);
+    myState->C = (sum > 99);
+    myState->A = ourBCDTable[1][sum & 0xff];
+    myState->notZ = myState->A;
+    myState->N = myState->A & 0x80;
+    myState->V = ((oldA ^ myState->A) & 0x80) && ((myState->A ^ operand) & 0x80);
   }
 }')
 
 define(M6502_ANC, `{
-  A &= operand;
-  notZ = A;
-  N = A & 0x80;
-  C = N;
+  myState->A &= operand;
+  myState->notZ = myState->A;
+  myState->N = myState->A & 0x80;
+  myState->C = myState->N;
 }')
 
 define(M6502_AND, `{
-  A &= operand;
-  notZ = A;
-  N = A & 0x80;
+  myState->A &= operand;
+  myState->notZ = myState->A;
+  myState->N = myState->A & 0x80;
 }')
 
 define(M6502_ANE, `{
   // NOTE: The implementation of this instruction is based on
   // information from the 64doc.txt file.  This instruction is
   // reported to be unstable!
-  A = (A | 0xee) & X & operand;
-  notZ = A;
-  N = A & 0x80;
+  myState->A = (myState->A | 0xee) & myState->X & operand;
+  myState->notZ = myState->A;
+  myState->N = myState->A & 0x80;
 }')
 
 define(M6502_ARR, `{
   // NOTE: The implementation of this instruction is based on
   // information from the 64doc.txt file.  There are mixed
   // reports on its operation!
-  if(!D)
+  if(!myState->D)
   {
-    A &= operand;
-    A = ((A >> 1) & 0x7f) | (C ? 0x80 : 0x00);
+    myState->A &= operand;
+    myState->A = ((myState->A >> 1) & 0x7f) | (myState->C ? 0x80 : 0x00);
 
-    C = A & 0x40;
-    V = (A & 0x40) ^ ((A & 0x20) << 1);
+    myState->C = myState->A & 0x40;
+    myState->V = (myState->A & 0x40) ^ ((myState->A & 0x20) << 1);
 
-    notZ = A;
-    N = A & 0x80;
+    myState->notZ = myState->A;
+    myState->N = myState->A & 0x80;
   }
   else
   {
-    uint8_t value = A & operand;
+    uint8_t value = myState->A & operand;
 
-    A = ((value >> 1) & 0x7f) | (C ? 0x80 : 0x00);
-    N = C;
-    notZ = A;
-    V = (value ^ A) & 0x40;
+    myState->A = ((value >> 1) & 0x7f) | (myState->C ? 0x80 : 0x00);
+    myState->N = myState->C;
+    myState->notZ = myState->A;
+    myState->V = (value ^ myState->A) & 0x40;
 
     if(((value & 0x0f) + (value & 0x01)) > 0x05)
     {
-      A = (A & 0xf0) | ((A + 0x06) & 0x0f);
+      myState->A = (myState->A & 0xf0) | ((myState->A + 0x06) & 0x0f);
     }
 
     if(((value & 0xf0) + (value & 0x10)) > 0x50)
     {
-      A = (A + 0x60) & 0xff;
-      C = 1;
+      myState->A = (myState->A + 0x60) & 0xff;
+      myState->C = 1;
     }
     else
     {
-      C = 0;
+      myState->C = 0;
     }
   }
 }')
 
 define(M6502_ASL, `{
   // Set carry flag according to the left-most bit in value
-  C = operand & 0x80;
+  myState->C = operand & 0x80;
 
   operand <<= 1;
   poke(operandAddress, operand);
 
-  notZ = operand;
-  N = operand & 0x80;
+  myState->notZ = operand;
+  myState->N = operand & 0x80;
 }')
 
 define(M6502_ASLA, `{
   // Set carry flag according to the left-most bit in A
-  C = A & 0x80;
+  myState->C = myState->A & 0x80;
 
-  A <<= 1;
+  myState->A <<= 1;
 
-  notZ = A;
-  N = A & 0x80;
+  myState->notZ = myState->A;
+  myState->N = myState->A & 0x80;
 }')
 
 define(M6502_ASR, `{
-  A &= operand;
+  myState->A &= operand;
 
   // Set carry flag according to the right-most bit
-  C = A & 0x01;
+  myState->C = myState->A & 0x01;
 
-  A = (A >> 1) & 0x7f;
+  myState->A = (myState->A >> 1) & 0x7f;
 
-  notZ = A;
-  N = A & 0x80;
+  myState->notZ = myState->A;
+  myState->N = myState->A & 0x80;
 }')
 
 define(M6502_BIT, `{
-  notZ = (A & operand);
-  N = operand & 0x80;
-  V = operand & 0x40;
+  myState->notZ = (myState->A & operand);
+  myState->N = operand & 0x80;
+  myState->V = operand & 0x40;
 }')
 
 define(M6502_BRK, `{
-  peek(PC++);
+  peek(myState->PC++);
 
-  B = true;
+  myState->B = true;
 
-  poke(0x0100 + SP--, PC >> 8);
-  poke(0x0100 + SP--, PC & 0x00ff);
-  poke(0x0100 + SP--, PS());
+  poke(0x0100 + myState->SP--, myState->PC >> 8);
+  poke(0x0100 + myState->SP--, myState->PC & 0x00ff);
+  poke(0x0100 + myState->SP--, PS());
 
-  I = true;
+  myState->I = true;
 
-  PC = peek(0xfffe);
-  PC |= ((uint16_t)peek(0xffff) << 8);
+  myState->PC = peek(0xfffe);
+  myState->PC |= ((uint16_t)peek(0xffff) << 8);
 }')
 
 define(M6502_CLC, `{
-  C = false;
+  myState->C = false;
 }')
 
 define(M6502_CLD, `{
-  D = false;
+  myState->D = false;
 }')
 
 define(M6502_CLI, `{
-  I = false;
+  myState->I = false;
 }')
 
 define(M6502_CLV, `{
-  V = false;
+  myState->V = false;
 }')
 
 define(M6502_CMP, `{
-  uint16_t value = (uint16_t)A - (uint16_t)operand;
+  uint16_t value = (uint16_t)myState->A - (uint16_t)operand;
 
-  notZ = value;
-  N = value & 0x0080;
-  C = !(value & 0x0100);
+  myState->notZ = value;
+  myState->N = value & 0x0080;
+  myState->C = !(value & 0x0100);
 }')
 
 define(M6502_CPX, `{
-  uint16_t value = (uint16_t)X - (uint16_t)operand;
+  uint16_t value = (uint16_t)myState->X - (uint16_t)operand;
 
-  notZ = value;
-  N = value & 0x0080;
-  C = !(value & 0x0100);
+  myState->notZ = value;
+  myState->N = value & 0x0080;
+  myState->C = !(value & 0x0100);
 }')
 
 define(M6502_CPY, `{
-  uint16_t value = (uint16_t)Y - (uint16_t)operand;
+  uint16_t value = (uint16_t)myState->Y - (uint16_t)operand;
 
-  notZ = value;
-  N = value & 0x0080;
-  C = !(value & 0x0100);
+  myState->notZ = value;
+  myState->N = value & 0x0080;
+  myState->C = !(value & 0x0100);
 }')
 
 define(M6502_DCP, `{
   uint8_t value = operand - 1;
   poke(operandAddress, value);
 
-  uint16_t value2 = (uint16_t)A - (uint16_t)value;
-  notZ = value2;
-  N = value2 & 0x0080;
-  C = !(value2 & 0x0100);
+  uint16_t value2 = (uint16_t)myState->A - (uint16_t)value;
+  myState->notZ = value2;
+  myState->N = value2 & 0x0080;
+  myState->C = !(value2 & 0x0100);
 }')
 
 define(M6502_DEC, `{
   uint8_t value = operand - 1;
   poke(operandAddress, value);
 
-  notZ = value;
-  N = value & 0x80;
+  myState->notZ = value;
+  myState->N = value & 0x80;
 }')
 
 define(M6502_DEX, `{
-  X--;
+  myState->X--;
 
-  notZ = X;
-  N = X & 0x80;
+  myState->notZ = myState->X;
+  myState->N = myState->X & 0x80;
 }')
 
 
 define(M6502_DEY, `{
-  Y--;
+  myState->Y--;
 
-  notZ = Y;
-  N = Y & 0x80;
+  myState->notZ = myState->Y;
+  myState->N = myState->Y & 0x80;
 }')
 
 define(M6502_EOR, `{
-  A ^= operand;
-  notZ = A;
-  N = A & 0x80;
+  myState->A ^= operand;
+  myState->notZ = myState->A;
+  myState->N = myState->A & 0x80;
 }')
 
 define(M6502_INC, `{
   uint8_t value = operand + 1;
   poke(operandAddress, value);
 
-  notZ = value;
-  N = value & 0x80;
+  myState->notZ = value;
+  myState->N = value & 0x80;
 }')
 
 define(M6502_INX, `{
-  X++;
-  notZ = X;
-  N = X & 0x80;
+  myState->X++;
+  myState->notZ = myState->X;
+  myState->N = myState->X & 0x80;
 }')
 
 define(M6502_INY, `{
-  Y++;
-  notZ = Y;
-  N = Y & 0x80;
+  myState->Y++;
+  myState->notZ = myState->Y;
+  myState->N = myState->Y & 0x80;
 }')
 
 define(M6502_ISB, `{
   operand = operand + 1;
   poke(operandAddress, operand);
 
-  uint8_t oldA = A;
+  uint8_t oldA = myState->A;
 
-  if(!D)
+  if(!myState->D)
   {
     operand = ~operand;
-    int16_t difference = (int16_t)((int8_t)A) + (int16_t)((int8_t)operand) + (C ? 1 : 0);
-    V = ((difference > 127) || (difference < -128));
-
-    difference = ((int16_t)A) + ((int16_t)operand) + (C ? 1 : 0);
-    A = difference;
-    C = (difference > 0xff);
-    notZ = A;
-    N = A & 0x80;
+    int16_t difference = (int16_t)((int8_t)myState->A) + (int16_t)((int8_t)operand) + (myState->C ? 1 : 0);
+    myState->V = ((difference > 127) || (difference < -128));
+
+    difference = ((int16_t)myState->A) + ((int16_t)operand) + (myState->C ? 1 : 0);
+    myState->A = difference;
+    myState->C = (difference > 0xff);
+    myState->notZ = myState->A;
+    myState->N = myState->A & 0x80;
   }
   else
   {
-    int16_t difference = ourBCDTable[0][A] - ourBCDTable[0][operand]
-        - (C ? 0 : 1);
+    int16_t difference = ourBCDTable[0][myState->A] - ourBCDTable[0][operand]
+        - (myState->C ? 0 : 1);
 
     if(difference < 0)
       difference += 100;
 
-    A = ourBCDTable[1][difference];
-    notZ = A;
-    N = A & 0x80;
+    myState->A = ourBCDTable[1][difference];
+    myState->notZ = myState->A;
+    myState->N = myState->A & 0x80;
 
-    C = (oldA >= (operand + (C ? 0 : 1)));
-    V = ((oldA ^ A) & 0x80) && ((A ^ operand) & 0x80);
+    myState->C = (oldA >= (operand + (myState->C ? 0 : 1)));
+    myState->V = ((oldA ^ myState->A) & 0x80) && ((myState->A ^ operand) & 0x80);
   }
 }')
 
 define(M6502_JMP, `{
-  PC = operandAddress;
+  myState->PC = operandAddress;
 }')
 
 define(M6502_JSR, `{
-  uint8_t low = peek(PC++);
-  peek(0x0100 + SP);
+  uint8_t low = peek(myState->PC++);
+  peek(0x0100 + myState->SP);
 
   // It seems that the 650x does not push the address of the next instruction
   // on the stack it actually pushes the address of the next instruction
   // minus one.  This is compensated for in the RTS instruction
-  poke(0x0100 + SP--, PC >> 8);
-  poke(0x0100 + SP--, PC & 0xff);
+  poke(0x0100 + myState->SP--, myState->PC >> 8);
+  poke(0x0100 + myState->SP--, myState->PC & 0xff);
 
-  PC = low | ((uint16_t)peek(PC++) << 8);
+  uint8_t high = peek(myState->PC);
+  myState->PC = low | ((uint16_t)high << 8);
 }')
 
 define(M6502_LAS, `{
-  A = X = SP = SP & operand;
-  notZ = A;
-  N = A & 0x80;
+  myState->A = myState->X = myState->SP = myState->SP & operand;
+  myState->notZ = myState->A;
+  myState->N = myState->A & 0x80;
 }')
 
 define(M6502_LAX, `{
-  A = operand;
-  X = operand;
-  notZ = A;
-  N = A & 0x80;
+  myState->A = operand;
+  myState->X = operand;
+  myState->notZ = myState->A;
+  myState->N = myState->A & 0x80;
 }')
 
 define(M6502_LDA, `{
-  A = operand;
-  notZ = A;
-  N = A & 0x80;
+  myState->A = operand;
+  myState->notZ = myState->A;
+  myState->N = myState->A & 0x80;
 }')
 
 define(M6502_LDX, `{
-  X = operand;
-  notZ = X;
-  N = X & 0x80;
+  myState->X = operand;
+  myState->notZ = myState->X;
+  myState->N = myState->X & 0x80;
 }')
 
 define(M6502_LDY, `{
-  Y = operand;
-  notZ = Y;
-  N = Y & 0x80;
+  myState->Y = operand;
+  myState->notZ = myState->Y;
+  myState->N = myState->Y & 0x80;
 }')
 
 define(M6502_LSR, `{
   // Set carry flag according to the right-most bit in value
-  C = operand & 0x01;
+  myState->C = operand & 0x01;
 
   operand = (operand >> 1) & 0x7f;
   poke(operandAddress, operand);
 
-  notZ = operand;
-  N = operand & 0x80;
+  myState->notZ = operand;
+  myState->N = operand & 0x80;
 }')
 
 define(M6502_LSRA, `{
   // Set carry flag according to the right-most bit
-  C = A & 0x01;
+  myState->C = myState->A & 0x01;
 
-  A = (A >> 1) & 0x7f;
+  myState->A = (myState->A >> 1) & 0x7f;
 
-  notZ = A;
-  N = A & 0x80;
+  myState->notZ = myState->A;
+  myState->N = myState->A & 0x80;
 }')
 
 define(M6502_LXA, `{
   // NOTE: The implementation of this instruction is based on
   // information from the 64doc.txt file.  This instruction is
   // reported to be very unstable!
-  A = X = (A | 0xee) & operand;
-  notZ = A;
-  N = A & 0x80;
+  myState->A = myState->X = (myState->A | 0xee) & operand;
+  myState->notZ = myState->A;
+  myState->N = myState->A & 0x80;
 }')
 
 define(M6502_NOP, `{
 }')
 
 define(M6502_ORA, `{
-  A |= operand;
-  notZ = A;
-  N = A & 0x80;
+  myState->A |= operand;
+  myState->notZ = myState->A;
+  myState->N = myState->A & 0x80;
 }')
 
 define(M6502_PHA, `{
-  poke(0x0100 + SP--, A);
+  poke(0x0100 + myState->SP--, myState->A);
 }')
 
 define(M6502_PHP, `{
-  poke(0x0100 + SP--, PS());
+  poke(0x0100 + myState->SP--, PS());
 }')
 
 define(M6502_PLA, `{
-  peek(0x0100 + SP++);
-  A = peek(0x0100 + SP);
-  notZ = A;
-  N = A & 0x80;
+  peek(0x0100 + myState->SP++);
+  myState->A = peek(0x0100 + myState->SP);
+  myState->notZ = myState->A;
+  myState->N = myState->A & 0x80;
 }')
 
 define(M6502_PLP, `{
-  peek(0x0100 + SP++);
-  PS(peek(0x0100 + SP));
+  peek(0x0100 + myState->SP++);
+  PS(peek(0x0100 + myState->SP));
 }')
 
 define(M6502_RLA, `{
-  uint8_t value = (operand << 1) | (C ? 1 : 0);
+  uint8_t value = (operand << 1) | (myState->C ? 1 : 0);
   poke(operandAddress, value);
 
-  A &= value;
-  C = operand & 0x80;
-  notZ = A;
-  N = A & 0x80;
+  myState->A &= value;
+  myState->C = operand & 0x80;
+  myState->notZ = myState->A;
+  myState->N = myState->A & 0x80;
 }')
 
 define(M6502_ROL, `{
-  bool oldC = C;
+  bool oldC = myState->C;
 
   // Set carry flag according to the left-most bit in operand
-  C = operand & 0x80;
+  myState->C = operand & 0x80;
 
   operand = (operand << 1) | (oldC ? 1 : 0);
   poke(operandAddress, operand);
 
-  notZ = operand;
-  N = operand & 0x80;
+  myState->notZ = operand;
+  myState->N = operand & 0x80;
 }')
 
 define(M6502_ROLA, `{
-  bool oldC = C;
+  bool oldC = myState->C;
 
   // Set carry flag according to the left-most bit
-  C = A & 0x80;
+  myState->C = myState->A & 0x80;
 
-  A = (A << 1) | (oldC ? 1 : 0);
+  myState->A = (myState->A << 1) | (oldC ? 1 : 0);
 
-  notZ = A;
-  N = A & 0x80;
+  myState->notZ = myState->A;
+  myState->N = myState->A & 0x80;
 }')
 
 define(M6502_ROR, `{
-  bool oldC = C;
+  bool oldC = myState->C;
 
   // Set carry flag according to the right-most bit
-  C = operand & 0x01;
+  myState->C = operand & 0x01;
 
   operand = ((operand >> 1) & 0x7f) | (oldC ? 0x80 : 0x00);
   poke(operandAddress, operand);
 
-  notZ = operand;
-  N = operand & 0x80;
+  myState->notZ = operand;
+  myState->N = operand & 0x80;
 }')
 
 define(M6502_RORA, `{
-  bool oldC = C;
+  bool oldC = myState->C;
 
   // Set carry flag according to the right-most bit
-  C = A & 0x01;
+  myState->C = myState->A & 0x01;
 
-  A = ((A >> 1) & 0x7f) | (oldC ? 0x80 : 0x00);
+  myState->A = ((myState->A >> 1) & 0x7f) | (oldC ? 0x80 : 0x00);
 
-  notZ = A;
-  N = A & 0x80;
+  myState->notZ = myState->A;
+  myState->N = myState->A & 0x80;
 }')
 
 define(M6502_RRA, `{
-  uint8_t oldA = A;
-  bool oldC = C;
+  uint8_t oldA = myState->A;
+  bool oldC = myState->C;
 
   // Set carry flag according to the right-most bit
-  C = operand & 0x01;
+  myState->C = operand & 0x01;
 
   operand = ((operand >> 1) & 0x7f) | (oldC ? 0x80 : 0x00);
   poke(operandAddress, operand);
 
-  if(!D)
+  if(!myState->D)
   {
-    int16_t sum = (int16_t)((int8_t)A) + (int16_t)((int8_t)operand) + (C ? 1 : 0);
-    V = ((sum > 127) || (sum < -128));
-
-    sum = (int16_t)A + (int16_t)operand + (C ? 1 : 0);
-    A = sum;
-    C = (sum > 0xff);
-    notZ = A;
-    N = A & 0x80;
+    int16_t sum = (int16_t)((int8_t)myState->A) + (int16_t)((int8_t)operand) + (myState->C ? 1 : 0);
+    myState->V = ((sum > 127) || (sum < -128));
+
+    sum = (int16_t)myState->A + (int16_t)operand + (myState->C ? 1 : 0);
+    myState->A = sum;
+    myState->C = (sum > 0xff);
+    myState->notZ = myState->A;
+    myState->N = myState->A & 0x80;
   }
   else
   {
-    int16_t sum = ourBCDTable[0][A] + ourBCDTable[0][operand] + (C ? 1 : 0);
+    int16_t sum = ourBCDTable[0][myState->A] + ourBCDTable[0][operand] + (myState->C ? 1 : 0);
 
-    C = (sum > 99);
-    A = ourBCDTable[1][sum & 0xff];
-    notZ = A;
-    N = A & 0x80;
-    V = ((oldA ^ A) & 0x80) && ((A ^ operand) & 0x80);
+    myState->C = (sum > 99);
+    myState->A = ourBCDTable[1][sum & 0xff];
+    myState->notZ = myState->A;
+    myState->N = myState->A & 0x80;
+    myState->V = ((oldA ^ myState->A) & 0x80) && ((myState->A ^ operand) & 0x80);
   }
 }')
 
 define(M6502_RTI, `{
-  peek(0x0100 + SP++);
-  PS(peek(0x0100 + SP++));
-  PC = peek(0x0100 + SP++);
-  PC |= ((uint16_t)peek(0x0100 + SP) << 8);
+  peek(0x0100 + myState->SP++);
+  PS(peek(0x0100 + myState->SP++));
+  myState->PC = peek(0x0100 + myState->SP++);
+  myState->PC |= ((uint16_t)peek(0x0100 + myState->SP) << 8);
 }')
 
 define(M6502_RTS, `{
-  peek(0x0100 + SP++);
-  PC = peek(0x0100 + SP++);
-  PC |= ((uint16_t)peek(0x0100 + SP) << 8);
-  peek(PC++);
+  peek(0x0100 + myState->SP++);
+  myState->PC = peek(0x0100 + myState->SP++);
+  myState->PC |= ((uint16_t)peek(0x0100 + myState->SP) << 8);
+  peek(myState->PC++);
 }')
 
 define(M6502_SAX, `{
-  poke(operandAddress, A & X);
+  poke(operandAddress, myState->A & myState->X);
 }')
 
 define(M6502_SBC, `{
-  uint8_t oldA = A;
+  uint8_t oldA = myState->A;
 
-  if(!D)
+  if(!myState->D)
   {
     operand = ~operand;
-    int16_t difference = (int16_t)((int8_t)A) + (int16_t)((int8_t)operand) + (C ? 1 : 0);
-    V = ((difference > 127) || (difference < -128));
-
-    difference = ((int16_t)A) + ((int16_t)operand) + (C ? 1 : 0);
-    A = difference;
-    C = (difference > 0xff);
-    notZ = A;
-    N = A & 0x80;
+    int16_t difference = (int16_t)((int8_t)myState->A) + (int16_t)((int8_t)operand) + (myState->C ? 1 : 0);
+    myState->V = ((difference > 127) || (difference < -128));
+
+    difference = ((int16_t)myState->A) + ((int16_t)operand) + (myState->C ? 1 : 0);
+    myState->A = difference;
+    myState->C = (difference > 0xff);
+    myState->notZ = myState->A;
+    myState->N = myState->A & 0x80;
   }
   else
   {
-    int16_t difference = ourBCDTable[0][A] - ourBCDTable[0][operand]
-        - (C ? 0 : 1);
+    int16_t difference = ourBCDTable[0][myState->A] - ourBCDTable[0][operand]
+        - (myState->C ? 0 : 1);
 
     if(difference < 0)
       difference += 100;
 
-    A = ourBCDTable[1][difference];
-    notZ = A;
-    N = A & 0x80;
+    myState->A = ourBCDTable[1][difference];
+    myState->notZ = myState->A;
+    myState->N = myState->A & 0x80;
 
-    C = (oldA >= (operand + (C ? 0 : 1)));
-    V = ((oldA ^ A) & 0x80) && ((A ^ operand) & 0x80);
+    myState->C = (oldA >= (operand + (myState->C ? 0 : 1)));
+    myState->V = ((oldA ^ myState->A) & 0x80) && ((myState->A ^ operand) & 0x80);
   }
 }')
 
 define(M6502_SBX, `{
-  uint16_t value = (uint16_t)(X & A) - (uint16_t)operand;
-  X = (value & 0xff);
+  uint16_t value = (uint16_t)(myState->X & myState->A) - (uint16_t)operand;
+  myState->X = (value & 0xff);
 
-  notZ = X;
-  N = X & 0x80;
-  C = !(value & 0x0100);
+  myState->notZ = myState->X;
+  myState->N = myState->X & 0x80;
+  myState->C = !(value & 0x0100);
 }')
 
 define(M6502_SEC, `{
-  C = true;
+  myState->C = true;
 }')
 
 define(M6502_SED, `{
-  D = true;
+  myState->D = true;
 }')
 
 define(M6502_SEI, `{
-  I = true;
+  myState->I = true;
 }')
 
 define(M6502_SHA, `{
   // NOTE: There are mixed reports on the actual operation
   // of this instruction!
-  poke(operandAddress, A & X & (((operandAddress >> 8) & 0xff) + 1));
+  poke(operandAddress, myState->A & myState->X & (((operandAddress >> 8) & 0xff) + 1));
 }')
 
 define(M6502_SHS, `{
   // NOTE: There are mixed reports on the actual operation
   // of this instruction!
-  SP = A & X;
-  poke(operandAddress, A & X & (((operandAddress >> 8) & 0xff) + 1));
+  myState->SP = myState->A & myState->X;
+  poke(operandAddress, myState->A & myState->X & (((operandAddress >> 8) & 0xff) + 1));
 }')
 
 define(M6502_SHX, `{
   // NOTE: There are mixed reports on the actual operation
   // of this instruction!
-  poke(operandAddress, X & (((operandAddress >> 8) & 0xff) + 1));
+  poke(operandAddress, myState->X & (((operandAddress >> 8) & 0xff) + 1));
 }')
 
 define(M6502_SHY, `{
   // NOTE: There are mixed reports on the actual operation
   // of this instruction!
-  poke(operandAddress, Y & (((operandAddress >> 8) & 0xff) + 1));
+  poke(operandAddress, myState->Y & (((operandAddress >> 8) & 0xff) + 1));
 }')
 
 define(M6502_SLO, `{
   // Set carry flag according to the left-most bit in value
-  C = operand & 0x80;
+  myState->C = operand & 0x80;
 
   operand <<= 1;
   poke(operandAddress, operand);
 
-  A |= operand;
-  notZ = A;
-  N = A & 0x80;
+  myState->A |= operand;
+  myState->notZ = myState->A;
+  myState->N = myState->A & 0x80;
 }')
 
 define(M6502_SRE, `{
   // Set carry flag according to the right-most bit in value
-  C = operand & 0x01;
+  myState->C = operand & 0x01;
 
   operand = (operand >> 1) & 0x7f;
   poke(operandAddress, operand);
 
-  A ^= operand;
-  notZ = A;
-  N = A & 0x80;
+  myState->A ^= operand;
+  myState->notZ = myState->A;
+  myState->N = myState->A & 0x80;
 }')
 
 define(M6502_STA, `{
-  poke(operandAddress, A);
+  poke(operandAddress, myState->A);
 }')
 
 define(M6502_STX, `{
-  poke(operandAddress, X);
+  poke(operandAddress, myState->X);
 }')
 
 define(M6502_STY, `{
-  poke(operandAddress, Y);
+  poke(operandAddress, myState->Y);
 }')
 
 define(M6502_TAX, `{
-  X = A;
-  notZ = X;
-  N = X & 0x80;
+  myState->X = myState->A;
+  myState->notZ = myState->X;
+  myState->N = myState->X & 0x80;
 }')
 
 define(M6502_TAY, `{
-  Y = A;
-  notZ = Y;
-  N = Y & 0x80;
+  myState->Y = myState->A;
+  myState->notZ = myState->Y;
+  myState->N = myState->Y & 0x80;
 }')
 
 define(M6502_TSX, `{
-  X = SP;
-  notZ = X;
-  N = X & 0x80;
+  myState->X = myState->SP;
+  myState->notZ = myState->X;
+  myState->N = myState->X & 0x80;
 }')
 
 define(M6502_TXA, `{
-  A = X;
-  notZ = A;
-  N = A & 0x80;
+  myState->A = myState->X;
+  myState->notZ = myState->A;
+  myState->N = myState->A & 0x80;
 }')
 
 define(M6502_TXS, `{
-  SP = X;
+  myState->SP = myState->X;
 }')
 
 define(M6502_TYA, `{
-  A = Y;
-  notZ = A;
-  N = A & 0x80;
+  myState->A = myState->Y;
+  myState->notZ = myState->A;
+  myState->N = myState->A & 0x80;
 }')
 
 
@@ -22,17 +22,26 @@
 
 #include "ale/common/Log.hpp"
 
+#include <cstddef>
+
 namespace ale {
 namespace stella {
 
 #define debugStream ale::Logger::Info
 
+// The state block of the high compatibility 6502
+struct M6502HighBlock
+{
+  M6502State registers;
+  M6502HighState accesses;
+};
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 M6502High::M6502High(uint32_t systemCyclesPerProcessorCycle)
     : M6502(systemCyclesPerProcessorCycle)
 {
-  myNumberOfDistinctAccesses = 0;
-  myLastAddress = 0;
+  myHighState->myNumberOfDistinctAccesses = 0;
+  myHighState->myLastAddress = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -43,102 +52,102 @@ M6502High::~M6502High()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline uint8_t M6502High::peek(uint16_t address)
 {
-  if(address != myLastAddress)
+  if(address != myHighState->myLastAddress)
   {
-    myNumberOfDistinctAccesses++;
-    myLastAddress = address;
+    myHighState->myNumberOfDistinctAccesses++;
+    myHighState->myLastAddress = address;
   }
   mySystem->incrementCycles(mySystemCyclesPerProcessorCycle);
 
   uint8_t result = mySystem->peek(address);
-  myLastAccessWasRead = true;
+  myState->myLastAccessWasRead = true;
   return result;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline void M6502High::poke(uint16_t address, uint8_t value)
 {
-  if(address != myLastAddress)
+  if(address != myHighState->myLastAddress)
   {
-    myNumberOfDistinctAccesses++;
-    myLastAddress = address;
+    myHighState->myNumberOfDistinctAccesses++;
+    myHighState->myLastAddress = address;
   }
   mySystem->incrementCycles(mySystemCyclesPerProcessorCycle);
 
   mySystem->poke(address, value);
-  myLastAccessWasRead = false;
+  myState->myLastAccessWasRead = false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool M6502High::execute(uint32_t number)
 {
   // Clear all of the execution status bits except for the fatal error bit
-  myExecutionStatus &= FatalErrorBit;
+  myState->myExecutionStatus &= FatalErrorBit;
 
   // Loop until execution is stopped or a fatal error occurs
   for(;;)
   {
-    for(; !myExecutionStatus && (number != 0); --number)
+    for(; !myState->myExecutionStatus && (number != 0); --number)
     {
       uint16_t operandAddress = 0;
       uint8_t operand = 0;
 
 #ifdef DEBUG
-      debugStream << "PC=" << hex << setw(4) << PC << " ";
+      debugStream << "PC=" << hex << setw(4) << myState->PC << " ";
 #endif
 
       // Fetch instruction at the program counter
-      IR = peek(PC++);
+      myState->IR = peek(myState->PC++);
 
 #ifdef DEBUG
-      debugStream << "IR=" << hex << setw(2) << (int)IR << " ";
-      debugStream << "<" << ourAddressingModeTable[IR] << " ";
+      debugStream << "IR=" << hex << setw(2) << (int)myState->IR << " ";
+      debugStream << "<" << ourAddressingModeTable[myState->IR] << " ";
 #endif
 
       // Call code to execute the instruction
-      switch(IR)
+      switch(myState->IR)
       {
         // 6502 instruction emulation is generated by an M4 macro file
         #include "ale/emucore/M6502Hi.ins"
 
         default:
           // Oops, illegal instruction executed so set fatal error flag
-          myExecutionStatus |= FatalErrorBit;
+          myState->myExecutionStatus |= FatalErrorBit;
       }
 
       myTotalInstructionCount++;
 
 #ifdef DEBUG
       debugStream << hex << setw(4) << operandAddress << " ";
-      debugStream << setw(4) << ourInstructionMnemonicTable[IR];
+      debugStream << setw(4) << ourInstructionMnemonicTable[myState->IR];
       debugStream << "> ";
-      debugStream << "A=" << ::hex << setw(2) << (int)A << " ";
-      debugStream << "X=" << ::hex << setw(2) << (int)X << " ";
-      debugStream << "Y=" << ::hex << setw(2) << (int)Y << " ";
+      debugStream << "A=" << ::hex << setw(2) << (int)myState->A << " ";
+      debugStream << "X=" << ::hex << setw(2) << (int)myState->X << " ";
+      debugStream << "Y=" << ::hex << setw(2) << (int)myState->Y << " ";
       debugStream << "PS=" << ::hex << setw(2) << (int)PS() << " ";
-      debugStream << "SP=" << ::hex << setw(2) << (int)SP << " ";
+      debugStream << "SP=" << ::hex << setw(2) << (int)myState->SP << " ";
       debugStream << "Cyc=" << dec << mySystem->cycles();
       debugStream << std::endl;
 #endif
     }
 
     // See if we need to handle an interrupt
-    if((myExecutionStatus & MaskableInterruptBit) ||
-        (myExecutionStatus & NonmaskableInterruptBit))
+    if((myState->myExecutionStatus & MaskableInterruptBit) ||
+        (myState->myExecutionStatus & NonmaskableInterruptBit))
     {
       // Yes, so handle the interrupt
       interruptHandler();
     }
 
     // See if execution has been stopped
-    if(myExecutionStatus & StopExecutionBit)
+    if(myState->myExecutionStatus & StopExecutionBit)
     {
       // Yes, so answer that everything finished fine
       return true;
     }
 
     // See if a fatal error has occured
-    if(myExecutionStatus & FatalErrorBit)
+    if(myState->myExecutionStatus & FatalErrorBit)
     {
       // Yes, so answer that something when wrong
       return false;
@@ -157,118 +166,75 @@ bool M6502High::execute(uint32_t number)
 void M6502High::interruptHandler()
 {
   // Handle the interrupt
-  if((myExecutionStatus & MaskableInterruptBit) && !I)
+  if((myState->myExecutionStatus & MaskableInterruptBit) && !myState->I)
   {
     mySystem->incrementCycles(7 * mySystemCyclesPerProcessorCycle);
-    mySystem->poke(0x0100 + SP--, (PC - 1) >> 8);
-    mySystem->poke(0x0100 + SP--, (PC - 1) & 0x00ff);
-    mySystem->poke(0x0100 + SP--, PS() & (~0x10));
-    D = false;
-    I = true;
-    PC = (uint16_t)mySystem->peek(0xFFFE) | ((uint16_t)mySystem->peek(0xFFFF) << 8);
+    mySystem->poke(0x0100 + myState->SP--, (myState->PC - 1) >> 8);
+    mySystem->poke(0x0100 + myState->SP--, (myState->PC - 1) & 0x00ff);
+    mySystem->poke(0x0100 + myState->SP--, PS() & (~0x10));
+    myState->D = false;
+    myState->I = true;
+    myState->PC = (uint16_t)mySystem->peek(0xFFFE) | ((uint16_t)mySystem->peek(0xFFFF) << 8);
   }
-  else if(myExecutionStatus & NonmaskableInterruptBit)
+  else if(myState->myExecutionStatus & NonmaskableInterruptBit)
   {
     mySystem->incrementCycles(7 * mySystemCyclesPerProcessorCycle);
-    mySystem->poke(0x0100 + SP--, (PC - 1) >> 8);
-    mySystem->poke(0x0100 + SP--, (PC - 1) & 0x00ff);
-    mySystem->poke(0x0100 + SP--, PS() & (~0x10));
-    D = false;
-    PC = (uint16_t)mySystem->peek(0xFFFA) | ((uint16_t)mySystem->peek(0xFFFB) << 8);
+    mySystem->poke(0x0100 + myState->SP--, (myState->PC - 1) >> 8);
+    mySystem->poke(0x0100 + myState->SP--, (myState->PC - 1) & 0x00ff);
+    mySystem->poke(0x0100 + myState->SP--, PS() & (~0x10));
+    myState->D = false;
+    myState->PC = (uint16_t)mySystem->peek(0xFFFA) | ((uint16_t)mySystem->peek(0xFFFB) << 8);
   }
 
   // Clear the interrupt bits in myExecutionStatus
-  myExecutionStatus &= ~(MaskableInterruptBit | NonmaskableInterruptBit);
+  myState->myExecutionStatus &= ~(MaskableInterruptBit | NonmaskableInterruptBit);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool M6502High::save(Serializer& out)
+size_t M6502High::stateSize() const
 {
-  std::string CPU = name();
-
-  try
-  {
-    out.putString(CPU);
-
-    out.putInt(A);    // Accumulator
-    out.putInt(X);    // X index register
-    out.putInt(Y);    // Y index register
-    out.putInt(SP);   // Stack Pointer
-    out.putInt(IR);   // Instruction register
-    out.putInt(PC);   // Program Counter
-
-    out.putBool(N);     // N flag for processor status register
-    out.putBool(V);     // V flag for processor status register
-    out.putBool(B);     // B flag for processor status register
-    out.putBool(D);     // D flag for processor status register
-    out.putBool(I);     // I flag for processor status register
-    out.putBool(notZ);  // Z flag complement for processor status register
-    out.putBool(C);     // C flag for processor status register
-
-    out.putInt(myExecutionStatus);
-
-    // Indicates the number of distinct memory accesses
-    out.putInt(myNumberOfDistinctAccesses);
-    // Indicates the last address which was accessed
-    out.putInt(myLastAddress);
+  return sizeof(M6502HighBlock);
+}
 
-  }
-  catch(char *msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in save state for " << CPU << std::endl;
-    return false;
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502High::bindState(uint8_t* state)
+{
+  M6502::bindState(state + offsetof(M6502HighBlock, registers));
+  myHighState.bind(state + offsetof(M6502HighBlock, accesses));
+}
 
-  return true;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateWriter M6502High::stateWriter() const
+{
+  return &writeState;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool M6502High::load(Deserializer& in)
+void M6502High::writeState(const uint8_t* block, Serializer& out)
 {
-  std::string CPU = name();
+  M6502::writeState(block + offsetof(M6502HighBlock, registers), out);
 
-  try
-  {
-    if(in.getString() != CPU)
-      return false;
+  const M6502HighState* state = reinterpret_cast<const M6502HighState*>(
+      block + offsetof(M6502HighBlock, accesses));
 
-    A = (uint8_t) in.getInt();    // Accumulator
-    X = (uint8_t) in.getInt();    // X index register
-    Y = (uint8_t) in.getInt();    // Y index register
-    SP = (uint8_t) in.getInt();   // Stack Pointer
-    IR = (uint8_t) in.getInt();   // Instruction register
-    PC = (uint16_t) in.getInt();  // Program Counter
-
-    N = in.getBool();     // N flag for processor status register
-    V = in.getBool();     // V flag for processor status register
-    B = in.getBool();     // B flag for processor status register
-    D = in.getBool();     // D flag for processor status register
-    I = in.getBool();     // I flag for processor status register
-    notZ = in.getBool();  // Z flag complement for processor status register
-    C = in.getBool();     // C flag for processor status register
-
-    myExecutionStatus = (uint8_t) in.getInt();
-
-    // Indicates the number of distinct memory accesses
-    myNumberOfDistinctAccesses = (uint32_t) in.getInt();
-    // Indicates the last address which was accessed
-    myLastAddress = (uint16_t) in.getInt();
-  }
-  catch(char *msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in load state for " << CPU << std::endl;
+  // Indicates the number of distinct memory accesses
+  out.putInt(state->myNumberOfDistinctAccesses);
+
+  // Indicates the last address which was accessed
+  out.putInt(state->myLastAddress);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool M6502High::loadState(Deserializer& in, int version)
+{
+  if(!M6502::loadState(in, version))
     return false;
-  }
+
+  // Indicates the number of distinct memory accesses
+  myHighState->myNumberOfDistinctAccesses = (uint32_t) in.getInt();
+
+  // Indicates the last address which was accessed
+  myHighState->myLastAddress = (uint16_t) in.getInt();
 
   return true;
 }
@@ -279,5 +245,11 @@ const char* M6502High::name() const
   return "M6502High";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t M6502High::memoryUsage() const
+{
+  return sizeof(*this);
+}
+
 }  // namespace stella
 }  // namespace ale
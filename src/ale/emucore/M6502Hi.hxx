@@ -23,8 +23,6 @@ namespace ale {
 namespace stella {
 
 class M6502High;
-class Serializer;
-class Deserializer;
 
 }  // namespace stella
 }  // namespace ale
@@ -34,6 +32,19 @@ class Deserializer;
 namespace ale {
 namespace stella {
 
+/**
+  The memory access bookkeeping of the high compatibility 6502, which
+  follows the registers of the base class in its state block.
+*/
+struct M6502HighState
+{
+  // Indicates the numer of distinct memory accesses
+  uint32_t myNumberOfDistinctAccesses;
+
+  // Indicates the last address which was accessed
+  uint16_t myLastAddress;
+};
+
 /**
   This class provides a high compatibility 6502 microprocessor emulator.
   The memory accesses and cycle counts it generates are valid at the
@@ -73,20 +84,37 @@ class M6502High : public M6502
     virtual bool execute(uint32_t number);
 
     /**
-      Saves the current state of this device to the given Serializer.
+      Answers the number of bytes of the state block of the processor.
+
+      @return The size of the state block
+    */
+    virtual size_t stateSize() const;
+
+    /**
+      Moves the state block of the processor to the given stateSize()
+      bytes of the machine state.
+
+      @param state The bytes to move the block to
+    */
+    virtual void bindState(uint8_t* state);
+
+    /**
+      Answers the function writing the state block of the processor to a
+      saved state in the portable format.
 
-      @param out The serializer device to save to.
-      @return The result of the save.  True on success, false on failure.
+      @return The writer of the state block
     */
-    virtual bool save(Serializer& out);
+    virtual StateWriter stateWriter() const;
 
     /**
-      Loads the current state of this device from the given Deserializer.
+      Reads the state block of the processor from a saved state in the
+      given version of the portable format.
 
       @param in The deserializer device to load from.
+      @param version The version of the format
       @return The result of the load.  True on success, false on failure.
     */
-    virtual bool load(Deserializer& in);
+    virtual bool loadState(Deserializer& in, int version);
 
     /**
       Get a null terminated string which is the processors's name (i.e. "M6532")
@@ -95,6 +123,14 @@ class M6502High : public M6502
     */
     virtual const char* name() const;
 
+    /**
+      Answers the number of bytes of memory owned by the processor,
+      including the processor object itself
+
+      @return The number of bytes
+    */
+    virtual size_t memoryUsage() const;
+
   public:
     /**
       Get the number of memory accesses to distinct memory locations
@@ -103,7 +139,7 @@ class M6502High : public M6502
     */
     uint32_t distinctAccesses() const
     {
-      return myNumberOfDistinctAccesses;
+      return myHighState->myNumberOfDistinctAccesses;
     }
 
   protected:
@@ -131,11 +167,11 @@ class M6502High : public M6502
     inline void poke(uint16_t address, uint8_t value);
 
   private:
-    // Indicates the numer of distinct memory accesses
-    uint32_t myNumberOfDistinctAccesses;
+    // Writes the registers and memory access bookkeeping of a state block
+    static void writeState(const uint8_t* block, Serializer& out);
 
-    // Indicates the last address which was accessed
-    uint16_t myLastAddress;
+    // The memory access bookkeeping
+    StateView<M6502HighState> myHighState;
 };
 
 }  // namespace stella
@@ -29,138 +29,138 @@
 #endif
 
 define(M6502_IMPLIED, `{
-  peek(PC);
+  peek(myState->PC);
 }')
 
 define(M6502_IMMEDIATE_READ, `{
-  operand = peek(PC++);
+  operand = peek(myState->PC++);
 }')
 
 define(M6502_ABSOLUTE_READ, `{
-  uint16_t address = peek(PC++);
-  address |= ((uint16_t)peek(PC++) << 8);
+  uint16_t address = peek(myState->PC++);
+  address |= ((uint16_t)peek(myState->PC++) << 8);
   operand = peek(address);
 }')
 
 define(M6502_ABSOLUTE_WRITE, `{
-  operandAddress = peek(PC++);
-  operandAddress |= ((uint16_t)peek(PC++) << 8);
+  operandAddress = peek(myState->PC++);
+  operandAddress |= ((uint16_t)peek(myState->PC++) << 8);
 }')
 
 define(M6502_ABSOLUTE_READMODIFYWRITE, `{
-  operandAddress = peek(PC++);
-  operandAddress |= ((uint16_t)peek(PC++) << 8);
+  operandAddress = peek(myState->PC++);
+  operandAddress |= ((uint16_t)peek(myState->PC++) << 8);
   operand = peek(operandAddress);
   poke(operandAddress, operand);
 }')
 
 define(M6502_ABSOLUTEX_READ, `{
-  uint16_t low = peek(PC++);
-  uint16_t high = ((uint16_t)peek(PC++) << 8);
-  operand = peek(high | (uint8_t)(low + X));
-  if((low + X) > 0xFF)
-    operand = peek((high | low) + X);
+  uint16_t low = peek(myState->PC++);
+  uint16_t high = ((uint16_t)peek(myState->PC++) << 8);
+  operand = peek(high | (uint8_t)(low + myState->X));
+  if((low + myState->X) > 0xFF)
+    operand = peek((high | low) + myState->X);
 }')
 
 define(M6502_ABSOLUTEX_WRITE, `{
-  uint16_t low = peek(PC++);
-  uint16_t high = ((uint16_t)peek(PC++) << 8);
-  peek(high | (uint8_t)(low + X));
-  operandAddress = (high | low) + X;
+  uint16_t low = peek(myState->PC++);
+  uint16_t high = ((uint16_t)peek(myState->PC++) << 8);
+  peek(high | (uint8_t)(low + myState->X));
+  operandAddress = (high | low) + myState->X;
 }')
 
 define(M6502_ABSOLUTEX_READMODIFYWRITE, `{
-  uint16_t low = peek(PC++);
-  uint16_t high = ((uint16_t)peek(PC++) << 8);
-  peek(high | (uint8_t)(low + X));
-  operandAddress = (high | low) + X;
+  uint16_t low = peek(myState->PC++);
+  uint16_t high = ((uint16_t)peek(myState->PC++) << 8);
+  peek(high | (uint8_t)(low + myState->X));
+  operandAddress = (high | low) + myState->X;
   operand = peek(operandAddress);
   poke(operandAddress, operand);
 }')
 
 define(M6502_ABSOLUTEY_READ, `{
-  uint16_t low = peek(PC++);
-  uint16_t high = ((uint16_t)peek(PC++) << 8);
-  operand = peek(high | (uint8_t)(low + Y));
-  if((low + Y) > 0xFF)
-    operand = peek((high | low) + Y);
+  uint16_t low = peek(myState->PC++);
+  uint16_t high = ((uint16_t)peek(myState->PC++) << 8);
+  operand = peek(high | (uint8_t)(low + myState->Y));
+  if((low + myState->Y) > 0xFF)
+    operand = peek((high | low) + myState->Y);
 }')
 
 define(M6502_ABSOLUTEY_WRITE, `{
-  uint16_t low = peek(PC++);
-  uint16_t high = ((uint16_t)peek(PC++) << 8);
-  peek(high | (uint8_t)(low + Y));
-  operandAddress = (high | low) + Y;
+  uint16_t low = peek(myState->PC++);
+  uint16_t high = ((uint16_t)peek(myState->PC++) << 8);
+  peek(high | (uint8_t)(low + myState->Y));
+  operandAddress = (high | low) + myState->Y;
 }')
 
 define(M6502_ABSOLUTEY_READMODIFYWRITE, `{
-  uint16_t low = peek(PC++);
-  uint16_t high = ((uint16_t)peek(PC++) << 8);
-  peek(high | (uint8_t)(low + Y));
-  operandAddress = (high | low) + Y;
+  uint16_t low = peek(myState->PC++);
+  uint16_t high = ((uint16_t)peek(myState->PC++) << 8);
+  peek(high | (uint8_t)(low + myState->Y));
+  operandAddress = (high | low) + myState->Y;
   operand = peek(operandAddress);
   poke(operandAddress, operand);
 }')
 
 define(M6502_ZERO_READ, `{
-  operand = peek(peek(PC++));
+  operand = peek(peek(myState->PC++));
 }')
 
 define(M6502_ZERO_WRITE, `{
-  operandAddress = peek(PC++);
+  operandAddress = peek(myState->PC++);
 }')
 
 define(M6502_ZERO_READMODIFYWRITE, `{
-  operandAddress = peek(PC++);
+  operandAddress = peek(myState->PC++);
   operand = peek(operandAddress);
   poke(operandAddress, operand);
 }')
 
 define(M6502_ZEROX_READ, `{
-  uint8_t address = peek(PC++);
+  uint8_t address = peek(myState->PC++);
   peek(address);
-  address += X;
+  address += myState->X;
   operand = peek(address);
 }')
 
 define(M6502_ZEROX_WRITE, `{
-  operandAddress = peek(PC++);
+  operandAddress = peek(myState->PC++);
   peek(operandAddress);
-  operandAddress = (operandAddress + X) & 0xFF;
+  operandAddress = (operandAddress + myState->X) & 0xFF;
 }')
 
 define(M6502_ZEROX_READMODIFYWRITE, `{
-  operandAddress = peek(PC++);
+  operandAddress = peek(myState->PC++);
   peek(operandAddress);
-  operandAddress = (operandAddress + X) & 0xFF;
+  operandAddress = (operandAddress + myState->X) & 0xFF;
   operand = peek(operandAddress);
   poke(operandAddress, operand);
 }')
 
 define(M6502_ZEROY_READ, `{
-  uint8_t address = peek(PC++);
+  uint8_t address = peek(myState->PC++);
   peek(address);
-  address += Y;
+  address += myState->Y;
   operand = peek(address);
 }')
 
 define(M6502_ZEROY_WRITE, `{
-  operandAddress = peek(PC++);
+  operandAddress = peek(myState->PC++);
   peek(operandAddress);
-  operandAddress = (operandAddress + Y) & 0xFF;
+  operandAddress = (operandAddress + myState->Y) & 0xFF;
 }')
 
 define(M6502_ZEROY_READMODIFYWRITE, `{
-  operandAddress = peek(PC++);
+  operandAddress = peek(myState->PC++);
   peek(operandAddress);
-  operandAddress = (operandAddress + Y) & 0xFF;
+  operandAddress = (operandAddress + myState->Y) & 0xFF;
   operand = peek(operandAddress);
   poke(operandAddress, operand);
 }')
 
 define(M6502_INDIRECT, `{
-  uint16_t addr = peek(PC++);
-  addr |= ((uint16_t)peek(PC++) << 8);
+  uint16_t addr = peek(myState->PC++);
+  addr |= ((uint16_t)peek(myState->PC++) << 8);
 
   // Simulate the error in the indirect addressing mode!
   uint16_t high = NOTSAMEPAGE(addr, addr + 1) ? (addr & 0xff00) : (addr + 1);
@@ -170,26 +170,26 @@ define(M6502_INDIRECT, `{
 }')
 
 define(M6502_INDIRECTX_READ, `{
-  uint8_t pointer = peek(PC++);
+  uint8_t pointer = peek(myState->PC++);
   peek(pointer);
-  pointer += X;
+  pointer += myState->X;
   uint16_t address = peek(pointer++);
   address |= ((uint16_t)peek(pointer) << 8);
   operand = peek(address);
 }')
 
 define(M6502_INDIRECTX_WRITE, `{
-  uint8_t pointer = peek(PC++);
+  uint8_t pointer = peek(myState->PC++);
   peek(pointer);
-  pointer += X;
+  pointer += myState->X;
   operandAddress = peek(pointer++);
   operandAddress |= ((uint16_t)peek(pointer) << 8);
 }')
 
 define(M6502_INDIRECTX_READMODIFYWRITE, `{
-  uint8_t pointer = peek(PC++);
+  uint8_t pointer = peek(myState->PC++);
   peek(pointer);
-  pointer += X;
+  pointer += myState->X;
   operandAddress = peek(pointer++);
   operandAddress |= ((uint16_t)peek(pointer) << 8);
   operand = peek(operandAddress);
@@ -197,117 +197,117 @@ define(M6502_INDIRECTX_READMODIFYWRITE, `{
 }')
 
 define(M6502_INDIRECTY_READ, `{
-  uint8_t pointer = peek(PC++);
+  uint8_t pointer = peek(myState->PC++);
   uint16_t low = peek(pointer++);
   uint16_t high = ((uint16_t)peek(pointer) << 8);
-  operand = peek(high | (uint8_t)(low + Y));
-  if((low + Y) > 0xFF)
-    operand = peek((high | low) + Y);
+  operand = peek(high | (uint8_t)(low + myState->Y));
+  if((low + myState->Y) > 0xFF)
+    operand = peek((high | low) + myState->Y);
 }')
 
 define(M6502_INDIRECTY_WRITE, `{
-  uint8_t pointer = peek(PC++);
+  uint8_t pointer = peek(myState->PC++);
   uint16_t low = peek(pointer++);
   uint16_t high = ((uint16_t)peek(pointer) << 8);
-  peek(high | (uint8_t)(low + Y));
-  operandAddress = (high | low) + Y;
+  peek(high | (uint8_t)(low + myState->Y));
+  operandAddress = (high | low) + myState->Y;
 }')
 
 define(M6502_INDIRECTY_READMODIFYWRITE, `{
-  uint8_t pointer = peek(PC++);
+  uint8_t pointer = peek(myState->PC++);
   uint16_t low = peek(pointer++);
   uint16_t high = ((uint16_t)peek(pointer) << 8);
-  peek(high | (uint8_t)(low + Y));
-  operandAddress = (high | low) + Y;
+  peek(high | (uint8_t)(low + myState->Y));
+  operandAddress = (high | low) + myState->Y;
   operand = peek(operandAddress);
   poke(operandAddress, operand);
 }')
 
 
 define(M6502_BCC, `{
-  if(!C)
+  if(!myState->C)
   {
-    peek(PC);
-    uint16_t address = PC + (int8_t)operand;
-    if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF));
-    PC = address;
+    peek(myState->PC);
+    uint16_t address = myState->PC + (int8_t)operand;
+    if(NOTSAMEPAGE(myState->PC, address))
+      peek((myState->PC & 0xFF00) | (address & 0x00FF));
+    myState->PC = address;
   }
 }')
 
 define(M6502_BCS, `{
-  if(C)
+  if(myState->C)
   {
-    peek(PC);
-    uint16_t address = PC + (int8_t)operand;
-    if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF));
-    PC = address;
+    peek(myState->PC);
+    uint16_t address = myState->PC + (int8_t)operand;
+    if(NOTSAMEPAGE(myState->PC, address))
+      peek((myState->PC & 0xFF00) | (address & 0x00FF));
+    myState->PC = address;
   }
 }')
 
 define(M6502_BEQ, `{
-  if(!notZ)
+  if(!myState->notZ)
   {
-    peek(PC);
-    uint16_t address = PC + (int8_t)operand;
-    if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF));
-    PC = address;
+    peek(myState->PC);
+    uint16_t address = myState->PC + (int8_t)operand;
+    if(NOTSAMEPAGE(myState->PC, address))
+      peek((myState->PC & 0xFF00) | (address & 0x00FF));
+    myState->PC = address;
   }
 }')
 
 define(M6502_BMI, `{
-  if(N)
+  if(myState->N)
   {
-    peek(PC);
-    uint16_t address = PC + (int8_t)operand;
-    if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF));
-    PC = address;
+    peek(myState->PC);
+    uint16_t address = myState->PC + (int8_t)operand;
+    if(NOTSAMEPAGE(myState->PC, address))
+      peek((myState->PC & 0xFF00) | (address & 0x00FF));
+    myState->PC = address;
   }
 }')
 
 define(M6502_BNE, `{
-  if(notZ)
+  if(myState->notZ)
   {
-    peek(PC);
-    uint16_t address = PC + (int8_t)operand;
-    if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF));
-    PC = address;
+    peek(myState->PC);
+    uint16_t address = myState->PC + (int8_t)operand;
+    if(NOTSAMEPAGE(myState->PC, address))
+      peek((myState->PC & 0xFF00) | (address & 0x00FF));
+    myState->PC = address;
   }
 }')
 
 define(M6502_BPL, `{
-  if(!N)
+  if(!myState->N)
   {
-    peek(PC);
-    uint16_t address = PC + (int8_t)operand;
-    if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF));
-    PC = address;
+    peek(myState->PC);
+    uint16_t address = myState->PC + (int8_t)operand;
+    if(NOTSAMEPAGE(myState->PC, address))
+      peek((myState->PC & 0xFF00) | (address & 0x00FF));
+    myState->PC = address;
   }
 }')
 
 define(M6502_BVC, `{
-  if(!V)
+  if(!myState->V)
   {
-    peek(PC);
-    uint16_t address = PC + (int8_t)operand;
-    if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF));
-    PC = address;
+    peek(myState->PC);
+    uint16_t address = myState->PC + (int8_t)operand;
+    if(NOTSAMEPAGE(myState->PC, address))
+      peek((myState->PC & 0xFF00) | (address & 0x00FF));
+    myState->PC = address;
   }
 }')
 
 define(M6502_BVS, `{
-  if(V)
+  if(myState->V)
   {
-    peek(PC);
-    uint16_t address = PC + (int8_t)operand;
-    if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF));
-    PC = address;
+    peek(myState->PC);
+    uint16_t address = myState->PC + (int8_t)operand;
+    if(NOTSAMEPAGE(myState->PC, address))
+      peek((myState->PC & 0xFF00) | (address & 0x00FF));
+    myState->PC = address;
   }
 }')
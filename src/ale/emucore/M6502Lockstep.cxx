@@ -0,0 +1,2450 @@
+//============================================================================
+//
+// MM     MM  6666  555555  0000   2222
+// MMMM MMMM 66  66 55     00  00 22  22
+// MM MMM MM 66     55     00  00     22
+// MM  M  MM 66666  55555  00  00  22222  --  "A 6502 Microprocessor Emulator"
+// MM     MM 66  66     55 00  00 22
+// MM     MM 66  66 55  55 00  00 22
+// MM     MM  6666   5555   0000  222222
+//
+// Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+//
+// See the file "license" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+//============================================================================
+
+#include "ale/emucore/M6502Lockstep.hxx"
+#include "ale/emucore/M6502Low.hxx"
+#include "ale/emucore/System.hxx"
+#include "ale/emucore/Cart.hxx"
+#include "ale/emucore/Cart2K.hxx"
+#include "ale/emucore/Cart4K.hxx"
+#include "ale/emucore/CartF4.hxx"
+#include "ale/emucore/CartF4SC.hxx"
+#include "ale/emucore/CartF6.hxx"
+#include "ale/emucore/CartF6SC.hxx"
+#include "ale/emucore/CartF8.hxx"
+#include "ale/emucore/CartF8SC.hxx"
+
+#include <algorithm>
+#include <cassert>
+#include <typeinfo>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#define LOCKSTEP_SIMD_X86
+#include <emmintrin.h>
+#endif
+
+#ifndef NOTSAMEPAGE
+  #define NOTSAMEPAGE(_addr1, _addr2) (((_addr1) ^ (_addr2)) & 0xff00)
+#endif
+
+namespace ale {
+namespace stella {
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Answers the lanes whose byte in the mask is set, as a bit mask
+static inline uint32_t laneBits(const uint8_t* mask)
+{
+#ifdef LOCKSTEP_SIMD_X86
+  __m128i low = _mm_load_si128((const __m128i*)mask);
+  __m128i high = _mm_load_si128((const __m128i*)(mask + 16));
+  return (uint32_t)_mm_movemask_epi8(low) |
+      ((uint32_t)_mm_movemask_epi8(high) << 16);
+#else
+  uint32_t bits = 0;
+  for(int lane = 0; lane < M6502Lockstep::MaxLanes; ++lane)
+    bits |= (uint32_t)(mask[lane] & 1) << lane;
+  return bits;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Answers a in the lanes whose byte in the mask is set and b in the others.
+// Blending with the mask rather than branching on it lets the compiler turn
+// the loops over the lanes into vector code.
+static inline uint8_t blend(uint8_t mask, uint8_t a, uint8_t b)
+{
+  return (uint8_t)((a & mask) | (b & ~mask));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static inline uint16_t blend16(uint8_t mask, uint16_t a, uint16_t b)
+{
+  uint16_t wide = (uint16_t)(int16_t)(int8_t)mask;
+  return (uint16_t)((a & wide) | (b & ~wide));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static inline uint32_t blend32(uint8_t mask, uint32_t a, uint32_t b)
+{
+  uint32_t wide = (uint32_t)(int32_t)(int8_t)mask;
+  return (a & wide) | (b & ~wide);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Answers the lowest lane in a non-empty bit mask
+static inline int lowestLane(uint32_t bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctz(bits);
+#else
+  int lane = 0;
+  while(!(bits & 1))
+  {
+    bits >>= 1;
+    ++lane;
+  }
+  return lane;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Answers the number of lanes in a bit mask
+static inline int countLanes(uint32_t bits)
+{
+  int count = 0;
+  for(; bits; bits &= bits - 1)
+    ++count;
+  return count;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Answers the offset of the pointer into the block, which is at least the
+// size of the block if the pointer is outside of it
+static inline size_t offsetIn(const uint8_t* pointer, const uint8_t* block)
+{
+  return (size_t)((uintptr_t)pointer - (uintptr_t)block);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+M6502Lockstep::M6502Lockstep()
+    : myGroup(0),
+      myLeader(0),
+      myRunning(0),
+      myStopped(0),
+      myBankSwitched(false),
+      myPCPerLane(false),
+      myUniform(false),
+      myUniformAddress(0),
+      myMachineStateSize(0),
+      myInstructionSystemCycleTable(0),
+      mySystemCyclesPerProcessorCycle(1)
+{
+  myStatistics.groupInstructions = 0;
+  myStatistics.laneInstructions = 0;
+  myStatistics.scalarInstructions = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+M6502Lockstep::~M6502Lockstep()
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool M6502Lockstep::supports(System& system, Cartridge& cart)
+{
+  // The pages of these cartridges are decided by the bank alone, so the
+  // lanes in the same bank share their ROM pages.  Only an exact type match
+  // counts, since a subclass could map its pages differently.
+  const std::type_info& type = typeid(cart);
+  bool banked = type == typeid(Cartridge2K) || type == typeid(Cartridge4K) ||
+      type == typeid(CartridgeF4) || type == typeid(CartridgeF4SC) ||
+      type == typeid(CartridgeF6) || type == typeid(CartridgeF6SC) ||
+      type == typeid(CartridgeF8) || type == typeid(CartridgeF8SC);
+
+  return banked && dynamic_cast<M6502Low*>(&system.m6502()) != 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::execute(System* const* systems, Cartridge* const* carts,
+    uint32_t count, uint32_t number)
+{
+  for(uint32_t first = 0; first < count; first += MaxLanes)
+  {
+    run(systems + first, carts + first,
+        std::min<uint32_t>(count - first, MaxLanes), number);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::run(System* const* systems, Cartridge* const* carts,
+    uint32_t count, uint32_t number)
+{
+  M6502& first = systems[0]->m6502();
+  myInstructionSystemCycleTable = first.myInstructionSystemCycleTable;
+  mySystemCyclesPerProcessorCycle = first.mySystemCyclesPerProcessorCycle;
+  myMachineStateSize = systems[0]->myMachineState.size();
+
+  myRunning = 0;
+  for(int lane = 0; lane < MaxLanes; ++lane)
+  {
+    myKey[lane] = ~0u;
+    if(lane >= (int)count)
+      continue;
+
+    System& system = *systems[lane];
+    mySystem[lane] = &system;
+    myCart[lane] = carts[lane];
+    myCPUState[lane] = &*system.m6502().myState;
+    mySystemState[lane] = &*system.myState;
+    myMachineState[lane] = system.myMachineState.data();
+
+    // The M6532 installs its RAM as the page at 0x80
+    myRIOT[lane] = pageAccess(&system, 0x80).directPeekBase;
+
+    assert(system.myMachineState.size() == myMachineStateSize);
+    assert(offsetIn(myRIOT[lane], myMachineState[lane]) ==
+           offsetIn(myRIOT[0], myMachineState[0]));
+
+    // Clear all of the execution status bits except for the fatal error bit
+    myCPUState[lane]->myExecutionStatus &= M6502::FatalErrorBit;
+
+    loadLane(lane);
+    myRemaining[lane] = number;
+    if(!myCPUState[lane]->myExecutionStatus && (number != 0))
+    {
+      myRunning |= 1u << lane;
+      myKey[lane] = ((uint32_t)myBank[lane] << 16) | myPC[lane];
+    }
+  }
+
+  while(myRunning)
+  {
+    selectGroup();
+    step();
+  }
+
+  for(int lane = 0; lane < (int)count; ++lane)
+    storeLane(lane);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline const System::PageAccess& M6502Lockstep::pageAccess(System* system,
+    uint16_t address)
+{
+  // The accesses of a lane go through its own page table
+  return system->myPageAccessTable[
+      (address & System::myAddressMask) >> System::myPageSize];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::loadLane(int lane)
+{
+  const M6502State& cpu = *myCPUState[lane];
+  myA[lane] = cpu.A;
+  myX[lane] = cpu.X;
+  myY[lane] = cpu.Y;
+  mySP[lane] = cpu.SP;
+  myIR[lane] = cpu.IR;
+  myPC[lane] = cpu.PC;
+  myN[lane] = cpu.N;
+  myV[lane] = cpu.V;
+  myB[lane] = cpu.B;
+  myD[lane] = cpu.D;
+  myI[lane] = cpu.I;
+  myNotZ[lane] = cpu.notZ;
+  myC[lane] = cpu.C;
+  myLastAccessWasRead[lane] = cpu.myLastAccessWasRead;
+
+  myDataBus[lane] = mySystemState[lane]->myDataBusState;
+  myCycles[lane] = mySystemState[lane]->myCycles;
+
+  for(int i = 0; i < 128; ++i)
+    myRAM[i][lane] = myRIOT[lane][i];
+
+  myBank[lane] = (uint8_t)myCart[lane]->bank();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::storeLane(int lane)
+{
+  M6502State& cpu = *myCPUState[lane];
+  cpu.A = myA[lane];
+  cpu.X = myX[lane];
+  cpu.Y = myY[lane];
+  cpu.SP = mySP[lane];
+  cpu.IR = myIR[lane];
+  cpu.PC = myPC[lane];
+  cpu.N = myN[lane];
+  cpu.V = myV[lane];
+  cpu.B = myB[lane];
+  cpu.D = myD[lane];
+  cpu.I = myI[lane];
+  cpu.notZ = myNotZ[lane];
+  cpu.C = myC[lane];
+  cpu.myLastAccessWasRead = myLastAccessWasRead[lane];
+
+  mySystemState[lane]->myDataBusState = myDataBus[lane];
+  mySystemState[lane]->myCycles = myCycles[lane];
+
+  for(int i = 0; i < 128; ++i)
+    myRIOT[lane][i] = myRAM[i][lane];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::selectGroup()
+{
+  // The running lanes at the lowest program counter of the lowest bank go
+  // next: after a forward branch the lanes which skipped ahead wait for the
+  // others, after a loop the lanes which left it wait for the others
+  uint32_t key = ~0u;
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    key = std::min(key, myKey[lane]);
+
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    myMask[lane] = (myKey[lane] == key) ? 0xff : 0;
+
+  myGroup = laneBits(myMask);
+  myLeader = lowestLane(myGroup);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::step()
+{
+  uint16_t pc = myPC[myLeader];
+
+  // Code outside the ROM, and the instructions which are not run in
+  // lockstep, are left to the processor of each lane
+  uint8_t length = 0;
+  if(inROM(pc))
+  {
+    const System::PageAccess& access = pageAccess(mySystem[myLeader], pc);
+    length = ourInstructionLengthTable[
+        access.directPeekBase[pc & mySystem[myLeader]->pageMask()]];
+    if((length > 1) && !inROM(pc + length - 1))
+      length = 0;
+  }
+
+  if(length == 0)
+  {
+    for(uint32_t bits = myGroup; bits; bits &= bits - 1)
+      stepScalar(lowestLane(bits));
+    return;
+  }
+
+  myStopped = 0;
+  myBankSwitched = false;
+  myPCPerLane = false;
+
+  // Fetch instruction at the program counter
+  uint8_t opcode = fetch(pc);
+
+  // Update system cycles
+  uint32_t cycles = myInstructionSystemCycleTable[opcode];
+  for(int lane = 0; lane < MaxLanes; ++lane)
+  {
+    myIR[lane] = blend(myMask[lane], opcode, myIR[lane]);
+    myCycles[lane] += blend32(myMask[lane], cycles, 0);
+  }
+
+  switch(opcode)
+  {
+    // Generated from the case list of M6502.m4, with the opcodes whose
+    // length is 0 in ourInstructionLengthTable left out
+    case 0x01:
+      indirectX(pc, Read);
+      ORA();
+      break;
+
+    case 0x03:
+      indirectX(pc, Modify);
+      SLO();
+      break;
+
+    case 0x04:
+    case 0x44:
+    case 0x64:
+      zero(pc, Read);
+      break;
+
+    case 0x05:
+      zero(pc, Read);
+      ORA();
+      break;
+
+    case 0x06:
+      zero(pc, Modify);
+      ASL();
+      break;
+
+    case 0x07:
+      zero(pc, Modify);
+      SLO();
+      break;
+
+    case 0x08:
+      PHP();
+      break;
+
+    case 0x09:
+      immediate(pc);
+      ORA();
+      break;
+
+    case 0x0a:
+      ASLA();
+      break;
+
+    case 0x0b:
+    case 0x2b:
+      immediate(pc);
+      ANC();
+      break;
+
+    case 0x0c:
+      absolute(pc, Read);
+      break;
+
+    case 0x0d:
+      absolute(pc, Read);
+      ORA();
+      break;
+
+    case 0x0e:
+      absolute(pc, Modify);
+      ASL();
+      break;
+
+    case 0x0f:
+      absolute(pc, Modify);
+      SLO();
+      break;
+
+    case 0x10:
+      branch(pc, myN, false);
+      break;
+
+    case 0x11:
+      indirectY(pc, Read);
+      ORA();
+      break;
+
+    case 0x13:
+      indirectY(pc, Modify);
+      SLO();
+      break;
+
+    case 0x14:
+    case 0x34:
+    case 0x54:
+    case 0x74:
+    case 0xd4:
+    case 0xf4:
+      zeroX(pc, Read);
+      break;
+
+    case 0x15:
+      zeroX(pc, Read);
+      ORA();
+      break;
+
+    case 0x16:
+      zeroX(pc, Modify);
+      ASL();
+      break;
+
+    case 0x17:
+      zeroX(pc, Modify);
+      SLO();
+      break;
+
+    case 0x18:
+      assignFlag(myC, 0);
+      break;
+
+    case 0x19:
+      absoluteY(pc, Read);
+      ORA();
+      break;
+
+    case 0x1a:
+    case 0x3a:
+    case 0x5a:
+    case 0x7a:
+    case 0xda:
+    case 0xea:
+    case 0xfa:
+      break;
+
+    case 0x1b:
+      absoluteY(pc, Modify);
+      SLO();
+      break;
+
+    case 0x1c:
+    case 0x3c:
+    case 0x5c:
+    case 0x7c:
+    case 0xdc:
+    case 0xfc:
+      absoluteX(pc, Read);
+      break;
+
+    case 0x1d:
+      absoluteX(pc, Read);
+      ORA();
+      break;
+
+    case 0x1e:
+      absoluteX(pc, Modify);
+      ASL();
+      break;
+
+    case 0x1f:
+      absoluteX(pc, Modify);
+      SLO();
+      break;
+
+    case 0x20:
+      JSR(pc);
+      break;
+
+    case 0x21:
+      indirectX(pc, Read);
+      AND();
+      break;
+
+    case 0x23:
+      indirectX(pc, Modify);
+      RLA();
+      break;
+
+    case 0x24:
+      zero(pc, Read);
+      BIT();
+      break;
+
+    case 0x25:
+      zero(pc, Read);
+      AND();
+      break;
+
+    case 0x26:
+      zero(pc, Modify);
+      ROL();
+      break;
+
+    case 0x27:
+      zero(pc, Modify);
+      RLA();
+      break;
+
+    case 0x28:
+      PLP();
+      break;
+
+    case 0x29:
+      immediate(pc);
+      AND();
+      break;
+
+    case 0x2a:
+      ROLA();
+      break;
+
+    case 0x2c:
+      absolute(pc, Read);
+      BIT();
+      break;
+
+    case 0x2d:
+      absolute(pc, Read);
+      AND();
+      break;
+
+    case 0x2e:
+      absolute(pc, Modify);
+      ROL();
+      break;
+
+    case 0x2f:
+      absolute(pc, Modify);
+      RLA();
+      break;
+
+    case 0x30:
+      branch(pc, myN, true);
+      break;
+
+    case 0x31:
+      indirectY(pc, Read);
+      AND();
+      break;
+
+    case 0x33:
+      indirectY(pc, Modify);
+      RLA();
+      break;
+
+    case 0x35:
+      zeroX(pc, Read);
+      AND();
+      break;
+
+    case 0x36:
+      zeroX(pc, Modify);
+      ROL();
+      break;
+
+    case 0x37:
+      zeroX(pc, Modify);
+      RLA();
+      break;
+
+    case 0x38:
+      assignFlag(myC, 1);
+      break;
+
+    case 0x39:
+      absoluteY(pc, Read);
+      AND();
+      break;
+
+    case 0x3b:
+      absoluteY(pc, Modify);
+      RLA();
+      break;
+
+    case 0x3d:
+      absoluteX(pc, Read);
+      AND();
+      break;
+
+    case 0x3e:
+      absoluteX(pc, Modify);
+      ROL();
+      break;
+
+    case 0x3f:
+      absoluteX(pc, Modify);
+      RLA();
+      break;
+
+    case 0x41:
+      indirectX(pc, Read);
+      EOR();
+      break;
+
+    case 0x43:
+      indirectX(pc, Modify);
+      SRE();
+      break;
+
+    case 0x45:
+      zero(pc, Read);
+      EOR();
+      break;
+
+    case 0x46:
+      zero(pc, Modify);
+      LSR();
+      break;
+
+    case 0x47:
+      zero(pc, Modify);
+      SRE();
+      break;
+
+    case 0x48:
+      PHA();
+      break;
+
+    case 0x49:
+      immediate(pc);
+      EOR();
+      break;
+
+    case 0x4a:
+      LSRA();
+      break;
+
+    case 0x4b:
+      immediate(pc);
+      ASR();
+      break;
+
+    case 0x4c:
+      JMP(pc, false);
+      break;
+
+    case 0x4d:
+      absolute(pc, Read);
+      EOR();
+      break;
+
+    case 0x4e:
+      absolute(pc, Modify);
+      LSR();
+      break;
+
+    case 0x4f:
+      absolute(pc, Modify);
+      SRE();
+      break;
+
+    case 0x50:
+      branch(pc, myV, false);
+      break;
+
+    case 0x51:
+      indirectY(pc, Read);
+      EOR();
+      break;
+
+    case 0x53:
+      indirectY(pc, Modify);
+      SRE();
+      break;
+
+    case 0x55:
+      zeroX(pc, Read);
+      EOR();
+      break;
+
+    case 0x56:
+      zeroX(pc, Modify);
+      LSR();
+      break;
+
+    case 0x57:
+      zeroX(pc, Modify);
+      SRE();
+      break;
+
+    case 0x58:
+      assignFlag(myI, 0);
+      break;
+
+    case 0x59:
+      absoluteY(pc, Read);
+      EOR();
+      break;
+
+    case 0x5b:
+      absoluteY(pc, Modify);
+      SRE();
+      break;
+
+    case 0x5d:
+      absoluteX(pc, Read);
+      EOR();
+      break;
+
+    case 0x5e:
+      absoluteX(pc, Modify);
+      LSR();
+      break;
+
+    case 0x5f:
+      absoluteX(pc, Modify);
+      SRE();
+      break;
+
+    case 0x60:
+      RTS();
+      break;
+
+    case 0x61:
+      indirectX(pc, Read);
+      ADC(myOperand);
+      break;
+
+    case 0x63:
+      indirectX(pc, Modify);
+      RRA();
+      break;
+
+    case 0x65:
+      zero(pc, Read);
+      ADC(myOperand);
+      break;
+
+    case 0x66:
+      zero(pc, Modify);
+      ROR();
+      break;
+
+    case 0x67:
+      zero(pc, Modify);
+      RRA();
+      break;
+
+    case 0x68:
+      PLA();
+      break;
+
+    case 0x69:
+      immediate(pc);
+      ADC(myOperand);
+      break;
+
+    case 0x6a:
+      RORA();
+      break;
+
+    case 0x6c:
+      JMP(pc, true);
+      break;
+
+    case 0x6d:
+      absolute(pc, Read);
+      ADC(myOperand);
+      break;
+
+    case 0x6e:
+      absolute(pc, Modify);
+      ROR();
+      break;
+
+    case 0x6f:
+      absolute(pc, Modify);
+      RRA();
+      break;
+
+    case 0x70:
+      branch(pc, myV, true);
+      break;
+
+    case 0x71:
+      indirectY(pc, Read);
+      ADC(myOperand);
+      break;
+
+    case 0x73:
+      indirectY(pc, Modify);
+      RRA();
+      break;
+
+    case 0x75:
+      zeroX(pc, Read);
+      ADC(myOperand);
+      break;
+
+    case 0x76:
+      zeroX(pc, Modify);
+      ROR();
+      break;
+
+    case 0x77:
+      zeroX(pc, Modify);
+      RRA();
+      break;
+
+    case 0x78:
+      assignFlag(myI, 1);
+      break;
+
+    case 0x79:
+      absoluteY(pc, Read);
+      ADC(myOperand);
+      break;
+
+    case 0x7b:
+      absoluteY(pc, Modify);
+      RRA();
+      break;
+
+    case 0x7d:
+      absoluteX(pc, Read);
+      ADC(myOperand);
+      break;
+
+    case 0x7e:
+      absoluteX(pc, Modify);
+      ROR();
+      break;
+
+    case 0x7f:
+      absoluteX(pc, Modify);
+      RRA();
+      break;
+
+    case 0x80:
+    case 0x82:
+    case 0x89:
+    case 0xc2:
+    case 0xe2:
+      immediate(pc);
+      break;
+
+    case 0x81:
+      indirectX(pc, Write);
+      store(myA);
+      break;
+
+    case 0x83:
+      indirectX(pc, Write);
+      SAX();
+      break;
+
+    case 0x84:
+      zero(pc, Write);
+      store(myY);
+      break;
+
+    case 0x85:
+      zero(pc, Write);
+      store(myA);
+      break;
+
+    case 0x86:
+      zero(pc, Write);
+      store(myX);
+      break;
+
+    case 0x87:
+      zero(pc, Write);
+      SAX();
+      break;
+
+    case 0x88:
+      increment(myY, 0xff);
+      break;
+
+    case 0x8a:
+      transfer(myX, myA, true);
+      break;
+
+    case 0x8c:
+      absolute(pc, Write);
+      store(myY);
+      break;
+
+    case 0x8d:
+      absolute(pc, Write);
+      store(myA);
+      break;
+
+    case 0x8e:
+      absolute(pc, Write);
+      store(myX);
+      break;
+
+    case 0x8f:
+      absolute(pc, Write);
+      SAX();
+      break;
+
+    case 0x90:
+      branch(pc, myC, false);
+      break;
+
+    case 0x91:
+      indirectY(pc, Write);
+      store(myA);
+      break;
+
+    case 0x94:
+      zeroX(pc, Write);
+      store(myY);
+      break;
+
+    case 0x95:
+      zeroX(pc, Write);
+      store(myA);
+      break;
+
+    case 0x96:
+      zeroY(pc, Write);
+      store(myX);
+      break;
+
+    case 0x97:
+      zeroY(pc, Write);
+      SAX();
+      break;
+
+    case 0x98:
+      transfer(myY, myA, true);
+      break;
+
+    case 0x99:
+      absoluteY(pc, Write);
+      store(myA);
+      break;
+
+    case 0x9a:
+      transfer(myX, mySP, false);
+      break;
+
+    case 0x9d:
+      absoluteX(pc, Write);
+      store(myA);
+      break;
+
+    case 0xa0:
+      immediate(pc);
+      LDY();
+      break;
+
+    case 0xa1:
+      indirectX(pc, Read);
+      LDA();
+      break;
+
+    case 0xa2:
+      immediate(pc);
+      LDX();
+      break;
+
+    case 0xa3:
+      indirectX(pc, Read);
+      LAX();
+      break;
+
+    case 0xa4:
+      zero(pc, Read);
+      LDY();
+      break;
+
+    case 0xa5:
+      zero(pc, Read);
+      LDA();
+      break;
+
+    case 0xa6:
+      zero(pc, Read);
+      LDX();
+      break;
+
+    case 0xa7:
+      zero(pc, Read);
+      LAX();
+      break;
+
+    case 0xa8:
+      transfer(myA, myY, true);
+      break;
+
+    case 0xa9:
+      immediate(pc);
+      LDA();
+      break;
+
+    case 0xaa:
+      transfer(myA, myX, true);
+      break;
+
+    case 0xac:
+      absolute(pc, Read);
+      LDY();
+      break;
+
+    case 0xad:
+      absolute(pc, Read);
+      LDA();
+      break;
+
+    case 0xae:
+      absolute(pc, Read);
+      LDX();
+      break;
+
+    case 0xaf:
+      absolute(pc, Read);
+      LAX();
+      break;
+
+    case 0xb0:
+      branch(pc, myC, true);
+      break;
+
+    case 0xb1:
+      indirectY(pc, Read);
+      LDA();
+      break;
+
+    case 0xb3:
+      indirectY(pc, Read);
+      LAX();
+      break;
+
+    case 0xb4:
+      zeroX(pc, Read);
+      LDY();
+      break;
+
+    case 0xb5:
+      zeroX(pc, Read);
+      LDA();
+      break;
+
+    case 0xb6:
+      zeroY(pc, Read);
+      LDX();
+      break;
+
+    case 0xb7:
+      zeroY(pc, Read);
+      LAX();
+      break;
+
+    case 0xb8:
+      assignFlag(myV, 0);
+      break;
+
+    case 0xb9:
+      absoluteY(pc, Read);
+      LDA();
+      break;
+
+    case 0xba:
+      transfer(mySP, myX, true);
+      break;
+
+    case 0xbc:
+      absoluteX(pc, Read);
+      LDY();
+      break;
+
+    case 0xbd:
+      absoluteX(pc, Read);
+      LDA();
+      break;
+
+    case 0xbe:
+      absoluteY(pc, Read);
+      LDX();
+      break;
+
+    case 0xbf:
+      absoluteY(pc, Read);
+      LAX();
+      break;
+
+    case 0xc0:
+      immediate(pc);
+      compare(myY);
+      break;
+
+    case 0xc1:
+      indirectX(pc, Read);
+      compare(myA);
+      break;
+
+    case 0xc3:
+      indirectX(pc, Modify);
+      DCP();
+      break;
+
+    case 0xc4:
+      zero(pc, Read);
+      compare(myY);
+      break;
+
+    case 0xc5:
+      zero(pc, Read);
+      compare(myA);
+      break;
+
+    case 0xc6:
+      zero(pc, Modify);
+      DEC();
+      break;
+
+    case 0xc7:
+      zero(pc, Modify);
+      DCP();
+      break;
+
+    case 0xc8:
+      increment(myY, 1);
+      break;
+
+    case 0xc9:
+      immediate(pc);
+      compare(myA);
+      break;
+
+    case 0xca:
+      increment(myX, 0xff);
+      break;
+
+    case 0xcb:
+      immediate(pc);
+      SBX();
+      break;
+
+    case 0xcc:
+      absolute(pc, Read);
+      compare(myY);
+      break;
+
+    case 0xcd:
+      absolute(pc, Read);
+      compare(myA);
+      break;
+
+    case 0xce:
+      absolute(pc, Modify);
+      DEC();
+      break;
+
+    case 0xcf:
+      absolute(pc, Modify);
+      DCP();
+      break;
+
+    case 0xd0:
+      branch(pc, myNotZ, true);
+      break;
+
+    case 0xd1:
+      indirectY(pc, Read);
+      compare(myA);
+      break;
+
+    case 0xd3:
+      indirectY(pc, Modify);
+      DCP();
+      break;
+
+    case 0xd5:
+      zeroX(pc, Read);
+      compare(myA);
+      break;
+
+    case 0xd6:
+      zeroX(pc, Modify);
+      DEC();
+      break;
+
+    case 0xd7:
+      zeroX(pc, Modify);
+      DCP();
+      break;
+
+    case 0xd8:
+      assignFlag(myD, 0);
+      break;
+
+    case 0xd9:
+      absoluteY(pc, Read);
+      compare(myA);
+      break;
+
+    case 0xdb:
+      absoluteY(pc, Modify);
+      DCP();
+      break;
+
+    case 0xdd:
+      absoluteX(pc, Read);
+      compare(myA);
+      break;
+
+    case 0xde:
+      absoluteX(pc, Modify);
+      DEC();
+      break;
+
+    case 0xdf:
+      absoluteX(pc, Modify);
+      DCP();
+      break;
+
+    case 0xe0:
+      immediate(pc);
+      compare(myX);
+      break;
+
+    case 0xe1:
+      indirectX(pc, Read);
+      SBC(myOperand);
+      break;
+
+    case 0xe3:
+      indirectX(pc, Modify);
+      ISB();
+      break;
+
+    case 0xe4:
+      zero(pc, Read);
+      compare(myX);
+      break;
+
+    case 0xe5:
+      zero(pc, Read);
+      SBC(myOperand);
+      break;
+
+    case 0xe6:
+      zero(pc, Modify);
+      INC();
+      break;
+
+    case 0xe7:
+      zero(pc, Modify);
+      ISB();
+      break;
+
+    case 0xe8:
+      increment(myX, 1);
+      break;
+
+    case 0xe9:
+    case 0xeb:
+      immediate(pc);
+      SBC(myOperand);
+      break;
+
+    case 0xec:
+      absolute(pc, Read);
+      compare(myX);
+      break;
+
+    case 0xed:
+      absolute(pc, Read);
+      SBC(myOperand);
+      break;
+
+    case 0xee:
+      absolute(pc, Modify);
+      INC();
+      break;
+
+    case 0xef:
+      absolute(pc, Modify);
+      ISB();
+      break;
+
+    case 0xf0:
+      branch(pc, myNotZ, false);
+      break;
+
+    case 0xf1:
+      indirectY(pc, Read);
+      SBC(myOperand);
+      break;
+
+    case 0xf3:
+      indirectY(pc, Modify);
+      ISB();
+      break;
+
+    case 0xf5:
+      zeroX(pc, Read);
+      SBC(myOperand);
+      break;
+
+    case 0xf6:
+      zeroX(pc, Modify);
+      INC();
+      break;
+
+    case 0xf7:
+      zeroX(pc, Modify);
+      ISB();
+      break;
+
+    case 0xf8:
+      assignFlag(myD, 1);
+      break;
+
+    case 0xf9:
+      absoluteY(pc, Read);
+      SBC(myOperand);
+      break;
+
+    case 0xfb:
+      absoluteY(pc, Modify);
+      ISB();
+      break;
+
+    case 0xfd:
+      absoluteX(pc, Read);
+      SBC(myOperand);
+      break;
+
+    case 0xfe:
+      absoluteX(pc, Modify);
+      INC();
+      break;
+
+    case 0xff:
+      absoluteX(pc, Modify);
+      ISB();
+      break;
+  }
+
+  ++myStatistics.groupInstructions;
+  myStatistics.laneInstructions += countLanes(myGroup);
+
+  // Count the instruction, and move the lanes on to the next one
+  alignas(32) uint8_t done[MaxLanes];
+  if(!myPCPerLane)
+  {
+    for(int lane = 0; lane < MaxLanes; ++lane)
+      myPC[lane] = blend16(myMask[lane], pc, myPC[lane]);
+  }
+  for(int lane = 0; lane < MaxLanes; ++lane)
+  {
+    myRemaining[lane] -= myMask[lane] & 1;
+    done[lane] = myMask[lane] & ((myRemaining[lane] == 0) ? 0xff : 0);
+    myKey[lane] = blend32(myMask[lane],
+        ((uint32_t)myBank[lane] << 16) | myPC[lane], myKey[lane]);
+  }
+
+  // Lanes stopped by a device, or out of instructions, are finished
+  uint32_t finished = myStopped | laneBits(done);
+  myRunning &= ~finished;
+  for(; finished; finished &= finished - 1)
+    myKey[lowestLane(finished)] = ~0u;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::stepScalar(int lane)
+{
+  storeLane(lane);
+  mySystem[lane]->m6502().execute(1);
+  loadLane(lane);
+
+  ++myStatistics.scalarInstructions;
+
+  if(myCPUState[lane]->myExecutionStatus || (--myRemaining[lane] == 0))
+  {
+    myRunning &= ~(1u << lane);
+    myKey[lane] = ~0u;
+  }
+  else
+  {
+    myKey[lane] = ((uint32_t)myBank[lane] << 16) | myPC[lane];
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline bool M6502Lockstep::inROM(uint16_t address) const
+{
+  const System::PageAccess& access = pageAccess(mySystem[myLeader], address);
+  return (access.directPeekBase != 0) &&
+      (offsetIn(access.directPeekBase, myMachineState[myLeader]) >=
+       myMachineStateSize);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline uint8_t M6502Lockstep::fetch(uint16_t& address)
+{
+  System* system = mySystem[myLeader];
+  uint8_t value = pageAccess(system, address).directPeekBase[
+      address & system->pageMask()];
+  ++address;
+
+  for(int lane = 0; lane < MaxLanes; ++lane)
+  {
+    myDataBus[lane] = blend(myMask[lane], value, myDataBus[lane]);
+    myLastAccessWasRead[lane] |= myMask[lane] & 1;
+  }
+  return value;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::read(uint16_t address, uint8_t* value)
+{
+  System* system = mySystem[myLeader];
+  const System::PageAccess& access = pageAccess(system, address);
+  if(access.directPeekBase != 0)
+  {
+    const uint8_t* base = access.directPeekBase +
+        (address & system->pageMask());
+
+    // The M6532 RAM is read from its array
+    size_t row = offsetIn(base, myRIOT[myLeader]);
+    if(row < 128)
+    {
+      const uint8_t* ram = myRAM[row];
+      for(int lane = 0; lane < MaxLanes; ++lane)
+      {
+        value[lane] = ram[lane];
+        myDataBus[lane] = blend(myMask[lane], ram[lane], myDataBus[lane]);
+        myLastAccessWasRead[lane] |= myMask[lane] & 1;
+      }
+      return;
+    }
+
+    // The ROM of the group is read once
+    if(!myBankSwitched &&
+       (offsetIn(base, myMachineState[myLeader]) >= myMachineStateSize))
+    {
+      uint8_t byte = *base;
+      for(int lane = 0; lane < MaxLanes; ++lane)
+      {
+        value[lane] = byte;
+        myDataBus[lane] = blend(myMask[lane], byte, myDataBus[lane]);
+        myLastAccessWasRead[lane] |= myMask[lane] & 1;
+      }
+      return;
+    }
+  }
+
+  for(uint32_t bits = myGroup; bits; bits &= bits - 1)
+  {
+    int lane = lowestLane(bits);
+    value[lane] = readLane(lane, address);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::readLanes(const uint16_t* address, uint8_t* value)
+{
+  uint16_t first = address[myLeader];
+  uint16_t differ = 0;
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    differ |= blend16(myMask[lane], address[lane] ^ first, 0);
+
+  if(!differ)
+  {
+    read(first, value);
+    return;
+  }
+
+  for(uint32_t bits = myGroup; bits; bits &= bits - 1)
+  {
+    int lane = lowestLane(bits);
+    value[lane] = readLane(lane, address[lane]);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::write(uint16_t address, const uint8_t* value)
+{
+  System* system = mySystem[myLeader];
+  const System::PageAccess& access = pageAccess(system, address);
+  if(access.directPokeBase != 0)
+  {
+    // The M6532 RAM is written to its array
+    size_t row = offsetIn(access.directPokeBase +
+        (address & system->pageMask()), myRIOT[myLeader]);
+    if(row < 128)
+    {
+      uint8_t* ram = myRAM[row];
+      for(int lane = 0; lane < MaxLanes; ++lane)
+      {
+        ram[lane] = blend(myMask[lane], value[lane], ram[lane]);
+        myDataBus[lane] = blend(myMask[lane], value[lane], myDataBus[lane]);
+        myLastAccessWasRead[lane] &= ~myMask[lane];
+      }
+      return;
+    }
+  }
+
+  for(uint32_t bits = myGroup; bits; bits &= bits - 1)
+  {
+    int lane = lowestLane(bits);
+    writeLane(lane, address, value[lane]);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::writeLanes(const uint16_t* address, const uint8_t* value)
+{
+  uint16_t first = address[myLeader];
+  uint16_t differ = 0;
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    differ |= blend16(myMask[lane], address[lane] ^ first, 0);
+
+  if(!differ)
+  {
+    write(first, value);
+    return;
+  }
+
+  for(uint32_t bits = myGroup; bits; bits &= bits - 1)
+  {
+    int lane = lowestLane(bits);
+    writeLane(lane, address[lane], value[lane]);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline uint8_t M6502Lockstep::readLane(int lane, uint16_t address)
+{
+  System* system = mySystem[lane];
+  const System::PageAccess& access = pageAccess(system, address);
+  if(access.directPeekBase == 0)
+    return devicePeek(lane, address);
+
+  const uint8_t* base = access.directPeekBase +
+      (address & system->pageMask());
+  size_t row = offsetIn(base, myRIOT[lane]);
+  uint8_t value = (row < 128) ? myRAM[row][lane] : *base;
+
+  myDataBus[lane] = value;
+  myLastAccessWasRead[lane] = 1;
+  return value;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void M6502Lockstep::writeLane(int lane, uint16_t address,
+    uint8_t value)
+{
+  System* system = mySystem[lane];
+  const System::PageAccess& access = pageAccess(system, address);
+  if(access.directPokeBase == 0)
+  {
+    devicePoke(lane, address, value);
+    return;
+  }
+
+  uint8_t* base = access.directPokeBase + (address & system->pageMask());
+  size_t row = offsetIn(base, myRIOT[lane]);
+  if(row < 128)
+    myRAM[row][lane] = value;
+  else
+    *base = value;
+
+  myDataBus[lane] = value;
+  myLastAccessWasRead[lane] = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uint8_t M6502Lockstep::devicePeek(int lane, uint16_t address)
+{
+  // The device sees the cycles, the data bus and the last access of the
+  // lane, as its processor would have left them
+  mySystemState[lane]->myCycles = myCycles[lane];
+  mySystemState[lane]->myDataBusState = myDataBus[lane];
+  myCPUState[lane]->myLastAccessWasRead = myLastAccessWasRead[lane];
+
+  Device* device = pageAccess(mySystem[lane], address).device;
+  uint8_t value = device->peek(address);
+
+  myDataBus[lane] = value;
+  myLastAccessWasRead[lane] = 1;
+  deviceAccessed(lane, device);
+  return value;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::devicePoke(int lane, uint16_t address, uint8_t value)
+{
+  mySystemState[lane]->myCycles = myCycles[lane];
+  mySystemState[lane]->myDataBusState = myDataBus[lane];
+  myCPUState[lane]->myLastAccessWasRead = myLastAccessWasRead[lane];
+
+  Device* device = pageAccess(mySystem[lane], address).device;
+  device->poke(address, value);
+
+  myDataBus[lane] = value;
+  myLastAccessWasRead[lane] = 0;
+  deviceAccessed(lane, device);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::deviceAccessed(int lane, const void* device)
+{
+  // The TIA may have halted the processor until the end of the scanline,
+  // or stopped it at the end of the frame
+  myCycles[lane] = mySystemState[lane]->myCycles;
+  if(myCPUState[lane]->myExecutionStatus)
+    myStopped |= 1u << lane;
+
+  // A hotspot may have switched banks
+  if(device == static_cast<const Device*>(myCart[lane]))
+  {
+    uint8_t bank = (uint8_t)myCart[lane]->bank();
+    if(bank != myBank[lane])
+    {
+      myBank[lane] = bank;
+      myBankSwitched = true;
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::readOperand()
+{
+  if(myUniform)
+  {
+    read(myUniformAddress, myOperand);
+    return;
+  }
+
+  for(uint32_t bits = myGroup; bits; bits &= bits - 1)
+  {
+    int lane = lowestLane(bits);
+    myOperand[lane] = readLane(lane, myAddress[lane]);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::writeOperand(const uint8_t* value)
+{
+  if(myUniform)
+  {
+    write(myUniformAddress, value);
+    return;
+  }
+
+  for(uint32_t bits = myGroup; bits; bits &= bits - 1)
+  {
+    int lane = lowestLane(bits);
+    writeLane(lane, myAddress[lane], value[lane]);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::immediate(uint16_t& pc)
+{
+  uint8_t value = fetch(pc);
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    myOperand[lane] = value;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::zero(uint16_t& pc, Access access)
+{
+  myUniform = true;
+  myUniformAddress = fetch(pc);
+  if(access != Write)
+    readOperand();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::zeroX(uint16_t& pc, Access access)
+{
+  indexed(fetch(pc), myX, true, access);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::zeroY(uint16_t& pc, Access access)
+{
+  indexed(fetch(pc), myY, true, access);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::absolute(uint16_t& pc, Access access)
+{
+  uint16_t low = fetch(pc);
+  uint16_t high = fetch(pc);
+  myUniform = true;
+  myUniformAddress = low | (high << 8);
+  if(access != Write)
+    readOperand();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::absoluteX(uint16_t& pc, Access access)
+{
+  uint16_t low = fetch(pc);
+  uint16_t high = fetch(pc);
+  indexed(low | (high << 8), myX, false, access);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::absoluteY(uint16_t& pc, Access access)
+{
+  uint16_t low = fetch(pc);
+  uint16_t high = fetch(pc);
+  indexed(low | (high << 8), myY, false, access);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::indexed(uint16_t base, const uint8_t* index, bool zeroPage,
+    Access access)
+{
+  // See if we need to add one cycle for indexing across a page boundary
+  uint32_t penalty = (access == Read) && !zeroPage ?
+      mySystemCyclesPerProcessorCycle : 0;
+
+  uint16_t first = (uint16_t)(base + index[myLeader]);
+  uint16_t differ = 0;
+  for(int lane = 0; lane < MaxLanes; ++lane)
+  {
+    uint16_t address = base + index[lane];
+    uint8_t crossed = NOTSAMEPAGE(base, address) ? 0xff : 0;
+    myCycles[lane] += blend32(myMask[lane] & crossed, penalty, 0);
+    myAddress[lane] = zeroPage ? (uint8_t)address : address;
+    differ |= blend16(myMask[lane], address ^ first, 0);
+  }
+
+  myUniform = !differ;
+  myUniformAddress = myAddress[myLeader];
+  if(access != Write)
+    readOperand();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::indirectX(uint16_t& pc, Access access)
+{
+  uint8_t base = fetch(pc);
+
+  alignas(64) uint16_t pointer[MaxLanes];
+  alignas(32) uint8_t low[MaxLanes];
+  alignas(32) uint8_t high[MaxLanes];
+
+  // The pointer wraps around the zero page, the byte after it does not
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    pointer[lane] = (uint8_t)(base + myX[lane]);
+  readLanes(pointer, low);
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    ++pointer[lane];
+  readLanes(pointer, high);
+
+  uint16_t first = low[myLeader] | (high[myLeader] << 8);
+  uint16_t differ = 0;
+  for(int lane = 0; lane < MaxLanes; ++lane)
+  {
+    myAddress[lane] = low[lane] | (high[lane] << 8);
+    differ |= blend16(myMask[lane], myAddress[lane] ^ first, 0);
+  }
+
+  myUniform = !differ;
+  myUniformAddress = first;
+  if(access != Write)
+    readOperand();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::indirectY(uint16_t& pc, Access access)
+{
+  uint8_t pointer = fetch(pc);
+
+  alignas(32) uint8_t low[MaxLanes];
+  alignas(32) uint8_t high[MaxLanes];
+  read(pointer, low);
+  read(pointer + 1, high);
+
+  uint32_t penalty = (access == Read) ? mySystemCyclesPerProcessorCycle : 0;
+  uint16_t first = (uint16_t)((low[myLeader] | (high[myLeader] << 8)) +
+      myY[myLeader]);
+  uint16_t differ = 0;
+  for(int lane = 0; lane < MaxLanes; ++lane)
+  {
+    uint16_t base = low[lane] | (high[lane] << 8);
+    uint16_t address = base + myY[lane];
+    uint8_t crossed = NOTSAMEPAGE(base, address) ? 0xff : 0;
+    myCycles[lane] += blend32(myMask[lane] & crossed, penalty, 0);
+    myAddress[lane] = address;
+    differ |= blend16(myMask[lane], address ^ first, 0);
+  }
+
+  myUniform = !differ;
+  myUniformAddress = first;
+  if(access != Write)
+    readOperand();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::stack(int offset)
+{
+  // Move the stack pointers by the offset, and address the stack there
+  uint16_t differ = 0;
+  for(int lane = 0; lane < MaxLanes; ++lane)
+  {
+    mySP[lane] += myMask[lane] & (uint8_t)offset;
+    myAddress[lane] = 0x0100 + mySP[lane];
+    differ |= blend16(myMask[lane], mySP[lane] ^ mySP[myLeader], 0);
+  }
+
+  myUniform = !differ;
+  myUniformAddress = myAddress[myLeader];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void M6502Lockstep::assign(uint8_t* reg, const uint8_t* value)
+{
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    reg[lane] = blend(myMask[lane], value[lane], reg[lane]);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void M6502Lockstep::setNZ(const uint8_t* value)
+{
+  for(int lane = 0; lane < MaxLanes; ++lane)
+  {
+    myNotZ[lane] = blend(myMask[lane], (value[lane] != 0), myNotZ[lane]);
+    myN[lane] = blend(myMask[lane], (value[lane] >> 7), myN[lane]);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void M6502Lockstep::assignNZ(uint8_t* reg, const uint8_t* value)
+{
+  assign(reg, value);
+  setNZ(reg);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void M6502Lockstep::assignFlag(uint8_t* flag, uint8_t value)
+{
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    flag[lane] = blend(myMask[lane], value, flag[lane]);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline bool M6502Lockstep::anyDecimal() const
+{
+  uint8_t decimal = 0;
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    decimal |= myD[lane] & myMask[lane];
+  return decimal;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::ADC(const uint8_t* operand)
+{
+  if(!anyDecimal())
+  {
+    for(int lane = 0; lane < MaxLanes; ++lane)
+    {
+      uint8_t a = myA[lane];
+      uint16_t sum = a + operand[lane] + myC[lane];
+      uint8_t result = (uint8_t)sum;
+      uint8_t overflow = ((a ^ result) & (operand[lane] ^ result)) >> 7;
+      uint8_t mask = myMask[lane];
+      myA[lane] = blend(mask, result, a);
+      myC[lane] = blend(mask, (uint8_t)(sum >> 8), myC[lane]);
+      myV[lane] = blend(mask, overflow, myV[lane]);
+      myNotZ[lane] = blend(mask, (result != 0), myNotZ[lane]);
+      myN[lane] = blend(mask, (result >> 7), myN[lane]);
+    }
+    return;
+  }
+
+  // Some lanes add in BCD, which goes through the lookup tables lane by lane
+  for(uint32_t bits = myGroup; bits; bits &= bits - 1)
+  {
+    int lane = lowestLane(bits);
+    uint8_t oldA = myA[lane];
+    uint8_t value = operand[lane];
+
+    if(!myD[lane])
+    {
+      int16_t sum = (int16_t)((int8_t)oldA) + (int16_t)((int8_t)value) +
+          (myC[lane] ? 1 : 0);
+      myV[lane] = ((sum > 127) || (sum < -128));
+
+      sum = (int16_t)oldA + (int16_t)value + (myC[lane] ? 1 : 0);
+      myA[lane] = sum;
+      myC[lane] = (sum > 0xff);
+    }
+    else
+    {
+      int16_t sum = M6502::ourBCDTable[0][oldA] +
+          M6502::ourBCDTable[0][value] + (myC[lane] ? 1 : 0);
+
+      myC[lane] = (sum > 99);
+      myA[lane] = M6502::ourBCDTable[1][sum & 0xff];
+      myV[lane] = ((oldA ^ myA[lane]) & 0x80) &&
+          ((myA[lane] ^ value) & 0x80);
+    }
+    myNotZ[lane] = (myA[lane] != 0);
+    myN[lane] = myA[lane] >> 7;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::SBC(const uint8_t* operand)
+{
+  if(!anyDecimal())
+  {
+    alignas(32) uint8_t complement[MaxLanes];
+    for(int lane = 0; lane < MaxLanes; ++lane)
+      complement[lane] = ~operand[lane];
+    ADC(complement);
+    return;
+  }
+
+  for(uint32_t bits = myGroup; bits; bits &= bits - 1)
+  {
+    int lane = lowestLane(bits);
+    uint8_t oldA = myA[lane];
+    uint8_t value = operand[lane];
+
+    if(!myD[lane])
+    {
+      value = ~value;
+      int16_t difference = (int16_t)((int8_t)oldA) +
+          (int16_t)((int8_t)value) + (myC[lane] ? 1 : 0);
+      myV[lane] = ((difference > 127) || (difference < -128));
+
+      difference = ((int16_t)oldA) + ((int16_t)value) + (myC[lane] ? 1 : 0);
+      myA[lane] = difference;
+      myC[lane] = (difference > 0xff);
+    }
+    else
+    {
+      int16_t difference = M6502::ourBCDTable[0][oldA] -
+          M6502::ourBCDTable[0][value] - (myC[lane] ? 0 : 1);
+
+      if(difference < 0)
+        difference += 100;
+
+      myA[lane] = M6502::ourBCDTable[1][difference];
+      myC[lane] = (oldA >= (value + (myC[lane] ? 0 : 1)));
+      myV[lane] = ((oldA ^ myA[lane]) & 0x80) &&
+          ((myA[lane] ^ value) & 0x80);
+    }
+    myNotZ[lane] = (myA[lane] != 0);
+    myN[lane] = myA[lane] >> 7;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::compare(const uint8_t* reg)
+{
+  for(int lane = 0; lane < MaxLanes; ++lane)
+  {
+    uint8_t r = reg[lane];
+    uint8_t o = myOperand[lane];
+    uint8_t mask = myMask[lane];
+    myNotZ[lane] = blend(mask, (r != o), myNotZ[lane]);
+    myN[lane] = blend(mask, ((uint8_t)(r - o) >> 7), myN[lane]);
+    myC[lane] = blend(mask, (r >= o), myC[lane]);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::shiftLeft(uint8_t* value, bool rotate)
+{
+  // Set carry flag according to the left-most bit, and shift the old one in
+  for(int lane = 0; lane < MaxLanes; ++lane)
+  {
+    uint8_t old = value[lane];
+    uint8_t carry = rotate ? myC[lane] : 0;
+    uint8_t mask = myMask[lane];
+    value[lane] = blend(mask, (uint8_t)((old << 1) | carry), old);
+    myC[lane] = blend(mask, (old >> 7), myC[lane]);
+  }
+  setNZ(value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::shiftRight(uint8_t* value, bool rotate)
+{
+  // Set carry flag according to the right-most bit, and shift the old one in
+  for(int lane = 0; lane < MaxLanes; ++lane)
+  {
+    uint8_t old = value[lane];
+    uint8_t carry = rotate ? (uint8_t)(myC[lane] << 7) : 0;
+    uint8_t mask = myMask[lane];
+    value[lane] = blend(mask, (uint8_t)((old >> 1) | carry), old);
+    myC[lane] = blend(mask, (old & 0x01), myC[lane]);
+  }
+  setNZ(value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::ASL()
+{
+  shiftLeft(myOperand, false);
+  writeOperand(myOperand);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::LSR()
+{
+  shiftRight(myOperand, false);
+  writeOperand(myOperand);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::ROL()
+{
+  shiftLeft(myOperand, true);
+  writeOperand(myOperand);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::ROR()
+{
+  shiftRight(myOperand, true);
+  writeOperand(myOperand);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::ASLA()
+{
+  shiftLeft(myA, false);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::LSRA()
+{
+  shiftRight(myA, false);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::ROLA()
+{
+  shiftLeft(myA, true);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::RORA()
+{
+  shiftRight(myA, true);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::AND()
+{
+  alignas(32) uint8_t value[MaxLanes];
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    value[lane] = myA[lane] & myOperand[lane];
+  assignNZ(myA, value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::ORA()
+{
+  alignas(32) uint8_t value[MaxLanes];
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    value[lane] = myA[lane] | myOperand[lane];
+  assignNZ(myA, value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::EOR()
+{
+  alignas(32) uint8_t value[MaxLanes];
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    value[lane] = myA[lane] ^ myOperand[lane];
+  assignNZ(myA, value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::BIT()
+{
+  for(int lane = 0; lane < MaxLanes; ++lane)
+  {
+    uint8_t operand = myOperand[lane];
+    uint8_t mask = myMask[lane];
+    myNotZ[lane] = blend(mask, ((myA[lane] & operand) != 0), myNotZ[lane]);
+    myN[lane] = blend(mask, (operand >> 7), myN[lane]);
+    myV[lane] = blend(mask, ((operand >> 6) & 0x01), myV[lane]);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::LDA()
+{
+  assignNZ(myA, myOperand);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::LDX()
+{
+  assignNZ(myX, myOperand);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::LDY()
+{
+  assignNZ(myY, myOperand);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::LAX()
+{
+  assign(myX, myOperand);
+  assignNZ(myA, myOperand);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::INC()
+{
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    ++myOperand[lane];
+  writeOperand(myOperand);
+  setNZ(myOperand);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::DEC()
+{
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    --myOperand[lane];
+  writeOperand(myOperand);
+  setNZ(myOperand);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::DCP()
+{
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    --myOperand[lane];
+  writeOperand(myOperand);
+  compare(myA);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::ISB()
+{
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    ++myOperand[lane];
+  writeOperand(myOperand);
+  SBC(myOperand);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::SLO()
+{
+  shiftLeft(myOperand, false);
+  writeOperand(myOperand);
+  ORA();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::RLA()
+{
+  shiftLeft(myOperand, true);
+  writeOperand(myOperand);
+  AND();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::SRE()
+{
+  shiftRight(myOperand, false);
+  writeOperand(myOperand);
+  EOR();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::RRA()
+{
+  shiftRight(myOperand, true);
+  writeOperand(myOperand);
+  ADC(myOperand);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::ANC()
+{
+  AND();
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    myC[lane] = blend(myMask[lane], myN[lane], myC[lane]);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::ASR()
+{
+  alignas(32) uint8_t value[MaxLanes];
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    value[lane] = myA[lane] & myOperand[lane];
+  assign(myA, value);
+  shiftRight(myA, false);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::SBX()
+{
+  alignas(32) uint8_t value[MaxLanes];
+  for(int lane = 0; lane < MaxLanes; ++lane)
+  {
+    uint8_t both = myX[lane] & myA[lane];
+    value[lane] = both - myOperand[lane];
+    myC[lane] = blend(myMask[lane], (both >= myOperand[lane]), myC[lane]);
+  }
+  assignNZ(myX, value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::store(const uint8_t* reg)
+{
+  writeOperand(reg);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::SAX()
+{
+  alignas(32) uint8_t value[MaxLanes];
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    value[lane] = myA[lane] & myX[lane];
+  writeOperand(value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::increment(uint8_t* reg, uint8_t amount)
+{
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    reg[lane] += myMask[lane] & amount;
+  setNZ(reg);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::transfer(const uint8_t* from, uint8_t* to, bool flags)
+{
+  assign(to, from);
+  if(flags)
+    setNZ(to);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::branch(uint16_t& pc, const uint8_t* flag, bool set)
+{
+  int8_t offset = (int8_t)fetch(pc);
+  uint16_t address = pc + offset;
+  uint32_t cycles = NOTSAMEPAGE(pc, address) ?
+      mySystemCyclesPerProcessorCycle << 1 : mySystemCyclesPerProcessorCycle;
+
+  // The lanes which take the branch leave the group
+  uint8_t expected = set ? 1 : 0;
+  for(int lane = 0; lane < MaxLanes; ++lane)
+  {
+    uint8_t taken = myMask[lane] & ((flag[lane] == expected) ? 0xff : 0);
+    myPC[lane] = blend16(taken, address, blend16(myMask[lane], pc, myPC[lane]));
+    myCycles[lane] += blend32(taken, cycles, 0);
+  }
+  myPCPerLane = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::PHA()
+{
+  stack(0);
+  writeOperand(myA);
+  stack(-1);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::PHP()
+{
+  alignas(32) uint8_t ps[MaxLanes];
+  for(int lane = 0; lane < MaxLanes; ++lane)
+  {
+    ps[lane] = 0x20 | (myN[lane] << 7) | (myV[lane] << 6) |
+        (myB[lane] << 4) | (myD[lane] << 3) | (myI[lane] << 2) |
+        ((myNotZ[lane] ^ 1) << 1) | myC[lane];
+  }
+
+  stack(0);
+  writeOperand(ps);
+  stack(-1);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::PLA()
+{
+  stack(0);
+  readOperand();
+  stack(1);
+  readOperand();
+  assignNZ(myA, myOperand);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::PLP()
+{
+  stack(0);
+  readOperand();
+  stack(1);
+  readOperand();
+
+  // The 6507's B flag always true
+  for(int lane = 0; lane < MaxLanes; ++lane)
+  {
+    uint8_t ps = myOperand[lane];
+    uint8_t mask = myMask[lane];
+    myN[lane] = blend(mask, (ps >> 7), myN[lane]);
+    myV[lane] = blend(mask, ((ps >> 6) & 0x01), myV[lane]);
+    myB[lane] = blend(mask, 1, myB[lane]);
+    myD[lane] = blend(mask, ((ps >> 3) & 0x01), myD[lane]);
+    myI[lane] = blend(mask, ((ps >> 2) & 0x01), myI[lane]);
+    myNotZ[lane] = blend(mask, (((ps >> 1) & 0x01) ^ 1), myNotZ[lane]);
+    myC[lane] = blend(mask, (ps & 0x01), myC[lane]);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::JSR(uint16_t& pc)
+{
+  uint8_t low = fetch(pc);
+  stack(0);
+  readOperand();
+
+  // It seems that the 650x does not push the address of the next instruction
+  // on the stack it actually pushes the address of the next instruction
+  // minus one.  This is compensated for in the RTS instruction
+  alignas(32) uint8_t value[MaxLanes];
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    value[lane] = pc >> 8;
+  writeOperand(value);
+  stack(-1);
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    value[lane] = pc & 0xff;
+  writeOperand(value);
+  stack(-1);
+
+  uint16_t address = pc;
+  uint8_t high = fetch(address);
+  pc = low | ((uint16_t)high << 8);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::RTS()
+{
+  alignas(32) uint8_t low[MaxLanes];
+  alignas(64) uint16_t address[MaxLanes];
+
+  stack(0);
+  readOperand();
+  stack(1);
+  readOperand();
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    low[lane] = myOperand[lane];
+  stack(1);
+  readOperand();
+
+  // The return addresses may differ, so the group may split here
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    address[lane] = low[lane] | (myOperand[lane] << 8);
+  readLanes(address, myOperand);
+  for(int lane = 0; lane < MaxLanes; ++lane)
+    myPC[lane] = blend16(myMask[lane], address[lane] + 1, myPC[lane]);
+  myPCPerLane = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Lockstep::JMP(uint16_t& pc, bool indirect)
+{
+  uint16_t low = fetch(pc);
+  uint16_t high = fetch(pc);
+  uint16_t address = low | (high << 8);
+  if(!indirect)
+  {
+    pc = address;
+    return;
+  }
+
+  // Simulate the error in the indirect addressing mode!
+  uint16_t next = NOTSAMEPAGE(address, address + 1) ?
+      (address & 0xff00) : (address + 1);
+
+  alignas(32) uint8_t target[MaxLanes];
+  read(address, target);
+  read(next, myOperand);
+  for(int lane = 0; lane < MaxLanes; ++lane)
+  {
+    uint16_t jump = target[lane] | (myOperand[lane] << 8);
+    myPC[lane] = blend16(myMask[lane], jump, myPC[lane]);
+  }
+  myPCPerLane = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const uint8_t M6502Lockstep::ourInstructionLengthTable[256] = {
+  0, 2, 0, 2, 2, 2, 2, 2, 1, 2, 1, 2, 3, 3, 3, 3,   // 0
+  2, 2, 0, 2, 2, 2, 2, 2, 1, 3, 1, 3, 3, 3, 3, 3,   // 1
+  3, 2, 0, 2, 2, 2, 2, 2, 1, 2, 1, 2, 3, 3, 3, 3,   // 2
+  2, 2, 0, 2, 2, 2, 2, 2, 1, 3, 1, 3, 3, 3, 3, 3,   // 3
+  0, 2, 0, 2, 2, 2, 2, 2, 1, 2, 1, 2, 3, 3, 3, 3,   // 4
+  2, 2, 0, 2, 2, 2, 2, 2, 1, 3, 1, 3, 3, 3, 3, 3,   // 5
+  1, 2, 0, 2, 2, 2, 2, 2, 1, 2, 1, 0, 3, 3, 3, 3,   // 6
+  2, 2, 0, 2, 2, 2, 2, 2, 1, 3, 1, 3, 3, 3, 3, 3,   // 7
+  2, 2, 2, 2, 2, 2, 2, 2, 1, 2, 1, 0, 3, 3, 3, 3,   // 8
+  2, 2, 0, 0, 2, 2, 2, 2, 1, 3, 1, 0, 0, 3, 0, 0,   // 9
+  2, 2, 2, 2, 2, 2, 2, 2, 1, 2, 1, 0, 3, 3, 3, 3,   // A
+  2, 2, 0, 2, 2, 2, 2, 2, 1, 3, 1, 0, 3, 3, 3, 3,   // B
+  2, 2, 2, 2, 2, 2, 2, 2, 1, 2, 1, 2, 3, 3, 3, 3,   // C
+  2, 2, 0, 2, 2, 2, 2, 2, 1, 3, 1, 3, 3, 3, 3, 3,   // D
+  2, 2, 2, 2, 2, 2, 2, 2, 1, 2, 1, 2, 3, 3, 3, 3,   // E
+  2, 2, 0, 2, 2, 2, 2, 2, 1, 3, 1, 3, 3, 3, 3, 3   // F
+};
+
+}  // namespace stella
+}  // namespace ale
@@ -0,0 +1,307 @@
+//============================================================================
+//
+// MM     MM  6666  555555  0000   2222
+// MMMM MMMM 66  66 55     00  00 22  22
+// MM MMM MM 66     55     00  00     22
+// MM  M  MM 66666  55555  00  00  22222  --  "A 6502 Microprocessor Emulator"
+// MM     MM 66  66     55 00  00 22
+// MM     MM 66  66 55  55 00  00 22
+// MM     MM  6666   5555   0000  222222
+//
+// Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+//
+// See the file "license" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+//============================================================================
+
+#ifndef M6502LOCKSTEP_HXX
+#define M6502LOCKSTEP_HXX
+
+namespace ale {
+namespace stella {
+
+class Cartridge;
+struct M6502State;
+
+}  // namespace stella
+}  // namespace ale
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ale/emucore/System.hxx"
+
+namespace ale {
+namespace stella {
+
+/**
+  Runs the low compatibility 6502s of several systems running the same ROM
+  in lockstep.  Each system is a lane: the registers, flags, cycle counters
+  and M6532 RAM of the lanes are held as structure of arrays, one array of
+  MaxLanes entries per register and per RAM byte, so that an instruction is
+  decoded once and carried out for a whole group of lanes by fixed width
+  loops the compiler turns into vector code.
+
+  A group is made of the lanes at the same program counter in the same bank
+  of the cartridge, and the group with the lowest program counter runs next,
+  so lanes whose control flow diverged at a branch meet again where the
+  paths join.  Instruction bytes are read once from the ROM of the first
+  lane of the group.  Reads and writes of the M6532 RAM use the arrays,
+  other memory is read per lane and the TIA, the M6532 timer and the
+  bank switching hotspots are accessed per lane through the devices of the
+  lane, with its cycle counter, data bus and last access handed over.
+  Instructions which are not run in lockstep (BRK, RTI, the unstable
+  illegal opcodes, and code outside the ROM) are handed to the processor of
+  each lane one at a time.
+
+  Every lane ends up exactly where its own M6502Low::execute would have
+  left it.
+*/
+class M6502Lockstep
+{
+  public:
+    /// The largest number of lanes run together
+    enum { MaxLanes = 32 };
+
+    /**
+      Counters of the instructions executed, for reporting
+    */
+    struct Statistics
+    {
+      // Instructions decoded for a group of lanes
+      uint64_t groupInstructions;
+      // Instructions executed by the lanes of those groups
+      uint64_t laneInstructions;
+      // Instructions handed to the processor of a lane
+      uint64_t scalarInstructions;
+    };
+
+  public:
+    /**
+      Create a new lockstep runner
+    */
+    M6502Lockstep();
+
+    /**
+      Destructor
+    */
+    ~M6502Lockstep();
+
+  public:
+    /**
+      Answers true iff the given system can be run as a lane: its processor
+      is a low compatibility 6502 and its cartridge maps its memory by bank
+      alone.
+
+      @param system The system
+      @param cart The cartridge attached to the system
+      @return true iff the system can be run as a lane
+    */
+    static bool supports(System& system, Cartridge& cart);
+
+    /**
+      Executes instructions on each of the given systems as its processor's
+      execute(number) would, running them as lanes of up to MaxLanes
+      systems at a time.  The systems must run the same ROM on the same
+      kind of cartridge, and be supported (see supports()).
+
+      @param systems The systems to run
+      @param carts The cartridges attached to the systems
+      @param count The number of systems
+      @param number The number of instructions each system executes at most
+    */
+    void execute(System* const* systems, Cartridge* const* carts,
+                 uint32_t count, uint32_t number);
+
+    /**
+      Answers the instructions executed since this runner was created
+
+      @return The counters of the instructions executed
+    */
+    const Statistics& statistics() const { return myStatistics; }
+
+  private:
+    // How an addressing mode accesses its operand
+    enum Access { Read, Write, Modify };
+
+    // Run the given lanes until each of them stops
+    void run(System* const* systems, Cartridge* const* carts,
+             uint32_t count, uint32_t number);
+
+    // Move the state of a lane into the arrays, and back into its system
+    void loadLane(int lane);
+    void storeLane(int lane);
+
+    // Choose the lanes which execute the next instruction
+    void selectGroup();
+
+    // Execute one instruction for the lanes of the group
+    void step();
+
+    // Hand the next instruction of a lane to its own processor
+    void stepScalar(int lane);
+
+    // Answers how the lane's system accesses the page of the address
+    static const System::PageAccess& pageAccess(System* system,
+                                                uint16_t address);
+
+    // Answers true iff the address is in ROM for the lanes of the group
+    bool inROM(uint16_t address) const;
+
+    // Read the byte at the address from the ROM of the group, advancing it
+    uint8_t fetch(uint16_t& address);
+
+    // Access the same address, or one address per lane, for the group
+    void read(uint16_t address, uint8_t* value);
+    void readLanes(const uint16_t* address, uint8_t* value);
+    void write(uint16_t address, const uint8_t* value);
+    void writeLanes(const uint16_t* address, const uint8_t* value);
+
+    // Access an address for one lane
+    uint8_t readLane(int lane, uint16_t address);
+    void writeLane(int lane, uint16_t address, uint8_t value);
+
+    // Access a device for one lane, as its own System::peek and poke would
+    uint8_t devicePeek(int lane, uint16_t address);
+    void devicePoke(int lane, uint16_t address, uint8_t value);
+    void deviceAccessed(int lane, const void* device);
+
+    // Read or write the operand at the addresses of the addressing mode
+    void readOperand();
+    void writeOperand(const uint8_t* value);
+
+    // Addressing modes, which leave the operand or its addresses behind
+    void immediate(uint16_t& pc);
+    void zero(uint16_t& pc, Access access);
+    void zeroX(uint16_t& pc, Access access);
+    void zeroY(uint16_t& pc, Access access);
+    void absolute(uint16_t& pc, Access access);
+    void absoluteX(uint16_t& pc, Access access);
+    void absoluteY(uint16_t& pc, Access access);
+    void indirectX(uint16_t& pc, Access access);
+    void indirectY(uint16_t& pc, Access access);
+    void indexed(uint16_t base, const uint8_t* index, bool wrap,
+                 Access access);
+    void stack(int offset);
+
+    // Assign a value to a register, and the N and Z flags, for the group
+    void assign(uint8_t* reg, const uint8_t* value);
+    void assignNZ(uint8_t* reg, const uint8_t* value);
+    void assignFlag(uint8_t* flag, uint8_t value);
+    void setNZ(const uint8_t* value);
+
+    // Answers true iff a lane of the group is in decimal mode
+    bool anyDecimal() const;
+
+    // Instructions, named after their mnemonics
+    void ADC(const uint8_t* operand);
+    void SBC(const uint8_t* operand);
+    void compare(const uint8_t* reg);
+    void shiftLeft(uint8_t* value, bool rotate);
+    void shiftRight(uint8_t* value, bool rotate);
+    void ASL(); void LSR(); void ROL(); void ROR();
+    void ASLA(); void LSRA(); void ROLA(); void RORA();
+    void AND(); void ORA(); void EOR(); void BIT();
+    void LDA(); void LDX(); void LDY(); void LAX();
+    void INC(); void DEC(); void DCP(); void ISB();
+    void SLO(); void RLA(); void SRE(); void RRA();
+    void ANC(); void ASR(); void SBX();
+    void store(const uint8_t* reg);
+    void SAX();
+    void increment(uint8_t* reg, uint8_t amount);
+    void transfer(const uint8_t* from, uint8_t* to, bool flags);
+    void branch(uint16_t& pc, const uint8_t* flag, bool set);
+    void PHA(); void PHP(); void PLA(); void PLP();
+    void JSR(uint16_t& pc);
+    void RTS();
+    void JMP(uint16_t& pc, bool indirect);
+
+  private:
+    // The registers and flags of the lanes; flags are 0 or 1
+    alignas(64) uint8_t myA[MaxLanes];
+    alignas(32) uint8_t myX[MaxLanes];
+    alignas(32) uint8_t myY[MaxLanes];
+    alignas(32) uint8_t mySP[MaxLanes];
+    alignas(32) uint8_t myIR[MaxLanes];
+    alignas(32) uint8_t myN[MaxLanes];
+    alignas(32) uint8_t myV[MaxLanes];
+    alignas(32) uint8_t myB[MaxLanes];
+    alignas(32) uint8_t myD[MaxLanes];
+    alignas(32) uint8_t myI[MaxLanes];
+    alignas(32) uint8_t myNotZ[MaxLanes];
+    alignas(32) uint8_t myC[MaxLanes];
+    alignas(64) uint16_t myPC[MaxLanes];
+
+    // The data bus, the kind of the last access and the system cycles of
+    // the lanes
+    alignas(32) uint8_t myDataBus[MaxLanes];
+    alignas(32) uint8_t myLastAccessWasRead[MaxLanes];
+    alignas(64) uint32_t myCycles[MaxLanes];
+
+    // The M6532 RAM of the lanes, one array per byte
+    alignas(64) uint8_t myRAM[128][MaxLanes];
+
+    // The bank of the cartridge and the program counter of the lanes which
+    // are still running, or ~0 for the lanes which stopped
+    alignas(64) uint32_t myKey[MaxLanes];
+    alignas(32) uint8_t myBank[MaxLanes];
+    uint32_t myRemaining[MaxLanes];
+
+    // The lanes of the group executing an instruction, as a byte mask
+    // (0xff or 0) and as a bit mask, and its first lane
+    alignas(32) uint8_t myMask[MaxLanes];
+    uint32_t myGroup;
+    int myLeader;
+
+    // The lanes which are still running, and those which were stopped by
+    // a device during the current instruction
+    uint32_t myRunning;
+    uint32_t myStopped;
+
+    // Set when a lane switched banks during the current instruction
+    bool myBankSwitched;
+
+    // Set when the current instruction left a program counter per lane
+    bool myPCPerLane;
+
+    // The operand and its addresses for the current instruction, and the
+    // address if it is the same for the whole group
+    alignas(32) uint8_t myOperand[MaxLanes];
+    alignas(64) uint16_t myAddress[MaxLanes];
+    bool myUniform;
+    uint16_t myUniformAddress;
+
+    // The systems of the lanes and where their parts of the machine state
+    // are
+    System* mySystem[MaxLanes];
+    Cartridge* myCart[MaxLanes];
+    M6502State* myCPUState[MaxLanes];
+    SystemState* mySystemState[MaxLanes];
+    uint8_t* myMachineState[MaxLanes];
+    uint8_t* myRIOT[MaxLanes];
+    size_t myMachineStateSize;
+
+    // The system cycles of each instruction, and per processor cycle
+    const uint32_t* myInstructionSystemCycleTable;
+    uint32_t mySystemCyclesPerProcessorCycle;
+
+    Statistics myStatistics;
+
+  private:
+    // Number of bytes of each opcode run in lockstep, or 0 for the opcodes
+    // handed to the processor of each lane
+    static const uint8_t ourInstructionLengthTable[256];
+
+  private:
+    // Copy constructor isn't supported by this class so make it private
+    M6502Lockstep(const M6502Lockstep&);
+
+    // Assignment operator isn't supported by this class so make it private
+    M6502Lockstep& operator = (const M6502Lockstep&);
+};
+
+}  // namespace stella
+}  // namespace ale
+
+#endif
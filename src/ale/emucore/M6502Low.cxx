@@ -17,8 +17,6 @@
 //============================================================================
 
 #include "ale/emucore/M6502Low.hxx"
-#include "ale/emucore/Serializer.hxx"
-#include "ale/emucore/Deserializer.hxx"
 
 #include <iostream>
 
@@ -42,7 +40,7 @@ M6502Low::~M6502Low()
 inline uint8_t M6502Low::peek(uint16_t address)
 {
   uint8_t result = mySystem->peek(address);
-  myLastAccessWasRead = true;
+  myState->myLastAccessWasRead = true;
   return result;
 }
 
@@ -50,81 +48,81 @@ inline uint8_t M6502Low::peek(uint16_t address)
 inline void M6502Low::poke(uint16_t address, uint8_t value)
 {
   mySystem->poke(address, value);
-  myLastAccessWasRead = false;
+  myState->myLastAccessWasRead = false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool M6502Low::execute(uint32_t number)
 {
   // Clear all of the execution status bits except for the fatal error bit
-  myExecutionStatus &= FatalErrorBit;
+  myState->myExecutionStatus &= FatalErrorBit;
 
   // Loop until execution is stopped or a fatal error occurs
   for(;;)
   {
-    for(; !myExecutionStatus && (number != 0); --number)
+    for(; !myState->myExecutionStatus && (number != 0); --number)
     {
       uint16_t operandAddress = 0;
       uint8_t operand = 0;
 
 #ifdef DEBUG
-      debugStream << "PC=" << std::hex << setw(4) << PC << " ";
+      debugStream << "PC=" << std::hex << setw(4) << myState->PC << " ";
 #endif
 
       // Fetch instruction at the program counter
-      IR = peek(PC++);
+      myState->IR = peek(myState->PC++);
 
 #ifdef DEBUG
-      debugStream << "IR=" << std::hex << setw(2) << (int)IR << " ";
-      debugStream << "<" << ourAddressingModeTable[IR] << " ";
+      debugStream << "IR=" << std::hex << setw(2) << (int)myState->IR << " ";
+      debugStream << "<" << ourAddressingModeTable[myState->IR] << " ";
 #endif
 
       // Update system cycles
-      mySystem->incrementCycles(myInstructionSystemCycleTable[IR]);
+      mySystem->incrementCycles(myInstructionSystemCycleTable[myState->IR]);
 
       // Call code to execute the instruction
-      switch(IR)
+      switch(myState->IR)
       {
         // 6502 instruction emulation is generated by an M4 macro file
         #include "ale/emucore/M6502Low.ins"
 
         default:
           // Oops, illegal instruction executed so set fatal error flag
-          myExecutionStatus |= FatalErrorBit;
-          std::cerr << "Illegal Instruction! " << std::hex << (int) IR << std::endl;
+          myState->myExecutionStatus |= FatalErrorBit;
+          std::cerr << "Illegal Instruction! " << std::hex << (int) myState->IR << std::endl;
       }
 
 #ifdef DEBUG
       debugStream << std::hex << std::setw(4) << operandAddress << " ";
-      debugStream << std::setw(4) << ourInstructionMnemonicTable[IR];
+      debugStream << std::setw(4) << ourInstructionMnemonicTable[myState->IR];
       debugStream << "> ";
-      debugStream << "A=" << std::hex << std::setw(2) << (int)A << " ";
-      debugStream << "X=" << std::hex << std::setw(2) << (int)X << " ";
-      debugStream << "Y=" << std::hex << std::setw(2) << (int)Y << " ";
+      debugStream << "A=" << std::hex << std::setw(2) << (int)myState->A << " ";
+      debugStream << "X=" << std::hex << std::setw(2) << (int)myState->X << " ";
+      debugStream << "Y=" << std::hex << std::setw(2) << (int)myState->Y << " ";
       debugStream << "PS=" << std::hex << std::setw(2) << (int)PS() << " ";
-      debugStream << "SP=" << std::hex << std::setw(2) << (int)SP << " ";
+      debugStream << "SP=" << std::hex << std::setw(2) << (int)myState->SP << " ";
       debugStream << "Cyc=" << std::dec << mySystem->cycles();
       debugStream << std::endl;
 #endif
     }
 
     // See if we need to handle an interrupt
-    if((myExecutionStatus & MaskableInterruptBit) ||
-        (myExecutionStatus & NonmaskableInterruptBit))
+    if((myState->myExecutionStatus & MaskableInterruptBit) ||
+        (myState->myExecutionStatus & NonmaskableInterruptBit))
     {
       // Yes, so handle the interrupt
       interruptHandler();
     }
 
     // See if execution has been stopped
-    if(myExecutionStatus & StopExecutionBit)
+    if(myState->myExecutionStatus & StopExecutionBit)
     {
       // Yes, so answer that everything finished fine
       return true;
     }
 
     // See if a fatal error has occured
-    if(myExecutionStatus & FatalErrorBit)
+    if(myState->myExecutionStatus & FatalErrorBit)
     {
       // Yes, so answer that something when wrong
       return false;
@@ -143,115 +141,40 @@ bool M6502Low::execute(uint32_t number)
 void M6502Low::interruptHandler()
 {
   // Handle the interrupt
-  if((myExecutionStatus & MaskableInterruptBit) && !I)
+  if((myState->myExecutionStatus & MaskableInterruptBit) && !myState->I)
   {
     mySystem->incrementCycles(7 * mySystemCyclesPerProcessorCycle);
-    mySystem->poke(0x0100 + SP--, (PC - 1) >> 8);
-    mySystem->poke(0x0100 + SP--, (PC - 1) & 0x00ff);
-    mySystem->poke(0x0100 + SP--, PS() & (~0x10));
-    D = false;
-    I = true;
-    PC = (uint16_t)mySystem->peek(0xFFFE) | ((uint16_t)mySystem->peek(0xFFFF) << 8);
+    mySystem->poke(0x0100 + myState->SP--, (myState->PC - 1) >> 8);
+    mySystem->poke(0x0100 + myState->SP--, (myState->PC - 1) & 0x00ff);
+    mySystem->poke(0x0100 + myState->SP--, PS() & (~0x10));
+    myState->D = false;
+    myState->I = true;
+    myState->PC = (uint16_t)mySystem->peek(0xFFFE) | ((uint16_t)mySystem->peek(0xFFFF) << 8);
   }
-  else if(myExecutionStatus & NonmaskableInterruptBit)
+  else if(myState->myExecutionStatus & NonmaskableInterruptBit)
   {
     mySystem->incrementCycles(7 * mySystemCyclesPerProcessorCycle);
-    mySystem->poke(0x0100 + SP--, (PC - 1) >> 8);
-    mySystem->poke(0x0100 + SP--, (PC - 1) & 0x00ff);
-    mySystem->poke(0x0100 + SP--, PS() & (~0x10));
-    D = false;
-    PC = (uint16_t)mySystem->peek(0xFFFA) | ((uint16_t)mySystem->peek(0xFFFB) << 8);
+    mySystem->poke(0x0100 + myState->SP--, (myState->PC - 1) >> 8);
+    mySystem->poke(0x0100 + myState->SP--, (myState->PC - 1) & 0x00ff);
+    mySystem->poke(0x0100 + myState->SP--, PS() & (~0x10));
+    myState->D = false;
+    myState->PC = (uint16_t)mySystem->peek(0xFFFA) | ((uint16_t)mySystem->peek(0xFFFB) << 8);
   }
 
   // Clear the interrupt bits in myExecutionStatus
-  myExecutionStatus &= ~(MaskableInterruptBit | NonmaskableInterruptBit);
+  myState->myExecutionStatus &= ~(MaskableInterruptBit | NonmaskableInterruptBit);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool M6502Low::save(Serializer& out)
-{
-  std::string CPU = name();
-
-  try
-  {
-    out.putString(CPU);
-
-    out.putInt(A);    // Accumulator
-    out.putInt(X);    // X index register
-    out.putInt(Y);    // Y index register
-    out.putInt(SP);   // Stack Pointer
-    out.putInt(IR);   // Instruction register
-    out.putInt(PC);   // Program Counter
-
-    out.putBool(N);     // N flag for processor status register
-    out.putBool(V);     // V flag for processor status register
-    out.putBool(B);     // B flag for processor status register
-    out.putBool(D);     // D flag for processor status register
-    out.putBool(I);     // I flag for processor status register
-    out.putBool(notZ);  // Z flag complement for processor status register
-    out.putBool(C);     // C flag for processor status register
-
-    out.putInt(myExecutionStatus);
-  }
-  catch(char *msg)
-  {
-    std::cerr << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    std::cerr << "Unknown error in save state for " << CPU << std::endl;
-    return false;
-  }
-
-  return true;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool M6502Low::load(Deserializer& in)
+const char* M6502Low::name() const
 {
-  std::string CPU = name();
-
-  try
-  {
-    if(in.getString() != CPU)
-      return false;
-
-    A = (uint8_t) in.getInt();    // Accumulator
-    X = (uint8_t) in.getInt();    // X index register
-    Y = (uint8_t) in.getInt();    // Y index register
-    SP = (uint8_t) in.getInt();   // Stack Pointer
-    IR = (uint8_t) in.getInt();   // Instruction register
-    PC = (uint16_t) in.getInt();  // Program Counter
-
-    N = in.getBool();     // N flag for processor status register
-    V = in.getBool();     // V flag for processor status register
-    B = in.getBool();     // B flag for processor status register
-    D = in.getBool();     // D flag for processor status register
-    I = in.getBool();     // I flag for processor status register
-    notZ = in.getBool();  // Z flag complement for processor status register
-    C = in.getBool();     // C flag for processor status register
-
-    myExecutionStatus = (uint8_t) in.getInt();
-  }
-  catch(char *msg)
-  {
-    std::cerr << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    std::cerr << "Unknown error in load state for " << CPU << std::endl;
-    return false;
-  }
-
-  return true;
+  return "M6502Low";
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-const char* M6502Low::name() const
+size_t M6502Low::memoryUsage() const
 {
-  return "M6502Low";
+  return sizeof(*this);
 }
 
 }  // namespace stella
@@ -23,8 +23,6 @@ namespace ale {
 namespace stella {
 
 class M6502Low;
-class Serializer;
-class Deserializer;
 
 }  // namespace stella
 }  // namespace ale
@@ -79,27 +77,19 @@ class M6502Low : public M6502
     virtual bool execute(uint32_t number);
 
     /**
-      Saves the current state of this device to the given Serializer.
-
-      @param out The serializer device to save to.
-      @return The result of the save.  True on success, false on failure.
-    */
-    virtual bool save(Serializer& out);
-
-    /**
-      Loads the current state of this device from the given Deserializer.
+      Get a null terminated string which is the processors's name (i.e. "M6532")
 
-      @param in The deserializer device to load from.
-      @return The result of the load.  True on success, false on failure.
+      @return The name of the device
     */
-    virtual bool load(Deserializer& in);
+    virtual const char* name() const;
 
     /**
-      Get a null terminated string which is the processors's name (i.e. "M6532")
+      Answers the number of bytes of memory owned by the processor,
+      including the processor object itself
 
-      @return The name of the device
+      @return The number of bytes
     */
-    virtual const char* name() const;
+    virtual size_t memoryUsage() const;
 
   protected:
     /**
@@ -32,126 +32,126 @@ define(M6502_IMPLIED, `{
 }')
 
 define(M6502_IMMEDIATE_READ, `{
-  operandAddress = PC++;
+  operandAddress = myState->PC++;
   operand = peek(operandAddress);
 }')
 
 define(M6502_ABSOLUTE_READ, `{
-  operandAddress = (uint16_t)peek(PC) | ((uint16_t)peek(PC + 1) << 8);
-  PC += 2;
+  operandAddress = (uint16_t)peek(myState->PC) | ((uint16_t)peek(myState->PC + 1) << 8);
+  myState->PC += 2;
   operand = peek(operandAddress);
 }')
 
 define(M6502_ABSOLUTE_WRITE, `{
-  operandAddress = (uint16_t)peek(PC) | ((uint16_t)peek(PC + 1) << 8);
-  PC += 2;
+  operandAddress = (uint16_t)peek(myState->PC) | ((uint16_t)peek(myState->PC + 1) << 8);
+  myState->PC += 2;
 }')
 
 define(M6502_ABSOLUTE_READMODIFYWRITE, `{
-  operandAddress = (uint16_t)peek(PC) | ((uint16_t)peek(PC + 1) << 8);
-  PC += 2;
+  operandAddress = (uint16_t)peek(myState->PC) | ((uint16_t)peek(myState->PC + 1) << 8);
+  myState->PC += 2;
   operand = peek(operandAddress);
 }')
 
 define(M6502_ABSOLUTEX_READ, `{
-  operandAddress = (uint16_t)peek(PC) | ((uint16_t)peek(PC + 1) << 8);
-  PC += 2;
+  operandAddress = (uint16_t)peek(myState->PC) | ((uint16_t)peek(myState->PC + 1) << 8);
+  myState->PC += 2;
 
   // See if we need to add one cycle for indexing across a page boundary
-  if(NOTSAMEPAGE(operandAddress, operandAddress + X))
+  if(NOTSAMEPAGE(operandAddress, operandAddress + myState->X))
   {
     mySystem->incrementCycles(mySystemCyclesPerProcessorCycle);
   }
 
-  operandAddress += X;
+  operandAddress += myState->X;
   operand = peek(operandAddress);
 }')
 
 define(M6502_ABSOLUTEX_WRITE, `{
-  operandAddress = (uint16_t)peek(PC) | ((uint16_t)peek(PC + 1) << 8);
-  PC += 2;
-  operandAddress += X;
+  operandAddress = (uint16_t)peek(myState->PC) | ((uint16_t)peek(myState->PC + 1) << 8);
+  myState->PC += 2;
+  operandAddress += myState->X;
 }')
 
 define(M6502_ABSOLUTEX_READMODIFYWRITE, `{
-  operandAddress = (uint16_t)peek(PC) | ((uint16_t)peek(PC + 1) << 8);
-  PC += 2;
-  operandAddress += X;
+  operandAddress = (uint16_t)peek(myState->PC) | ((uint16_t)peek(myState->PC + 1) << 8);
+  myState->PC += 2;
+  operandAddress += myState->X;
   operand = peek(operandAddress);
 }')
 
 define(M6502_ABSOLUTEY_READ, `{
-  operandAddress = (uint16_t)peek(PC) | ((uint16_t)peek(PC + 1) << 8);
-  PC += 2;
+  operandAddress = (uint16_t)peek(myState->PC) | ((uint16_t)peek(myState->PC + 1) << 8);
+  myState->PC += 2;
 
   // See if we need to add one cycle for indexing across a page boundary
-  if(NOTSAMEPAGE(operandAddress, operandAddress + Y))
+  if(NOTSAMEPAGE(operandAddress, operandAddress + myState->Y))
   {
     mySystem->incrementCycles(mySystemCyclesPerProcessorCycle);
   }
 
-  operandAddress += Y;
+  operandAddress += myState->Y;
   operand = peek(operandAddress);
 }')
 
 define(M6502_ABSOLUTEY_WRITE, `{
-  operandAddress = (uint16_t)peek(PC) | ((uint16_t)peek(PC + 1) << 8);
-  PC += 2;
-  operandAddress += Y;
+  operandAddress = (uint16_t)peek(myState->PC) | ((uint16_t)peek(myState->PC + 1) << 8);
+  myState->PC += 2;
+  operandAddress += myState->Y;
 }')
 
 define(M6502_ABSOLUTEY_READMODIFYWRITE, `{
-  operandAddress = (uint16_t)peek(PC) | ((uint16_t)peek(PC + 1) << 8);
-  PC += 2;
-  operandAddress += Y;
+  operandAddress = (uint16_t)peek(myState->PC) | ((uint16_t)peek(myState->PC + 1) << 8);
+  myState->PC += 2;
+  operandAddress += myState->Y;
   operand = peek(operandAddress);
 }')
 
 define(M6502_ZERO_READ, `{
-  operandAddress = peek(PC++);
+  operandAddress = peek(myState->PC++);
   operand = peek(operandAddress);
 }')
 
 define(M6502_ZERO_WRITE, `{
-  operandAddress = peek(PC++);
+  operandAddress = peek(myState->PC++);
 }')
 
 define(M6502_ZERO_READMODIFYWRITE, `{
-  operandAddress = peek(PC++);
+  operandAddress = peek(myState->PC++);
   operand = peek(operandAddress);
 }')
 
 define(M6502_ZEROX_READ, `{
-  operandAddress = (uint8_t)(peek(PC++) + X);
+  operandAddress = (uint8_t)(peek(myState->PC++) + myState->X);
   operand = peek(operandAddress);
 }')
 
 define(M6502_ZEROX_WRITE, `{
-  operandAddress = (uint8_t)(peek(PC++) + X);
+  operandAddress = (uint8_t)(peek(myState->PC++) + myState->X);
 }')
 
 define(M6502_ZEROX_READMODIFYWRITE, `{
-  operandAddress = (uint8_t)(peek(PC++) + X);
+  operandAddress = (uint8_t)(peek(myState->PC++) + myState->X);
   operand = peek(operandAddress);
 }')
 
 define(M6502_ZEROY_READ, `{
-  operandAddress = (uint8_t)(peek(PC++) + Y);
+  operandAddress = (uint8_t)(peek(myState->PC++) + myState->Y);
   operand = peek(operandAddress);
 }')
 
 define(M6502_ZEROY_WRITE, `{
-  operandAddress = (uint8_t)(peek(PC++) + Y);
+  operandAddress = (uint8_t)(peek(myState->PC++) + myState->Y);
 }')
 
 define(M6502_ZEROY_READMODIFYWRITE, `{
-  operandAddress = (uint8_t)(peek(PC++) + Y);
+  operandAddress = (uint8_t)(peek(myState->PC++) + myState->Y);
   operand = peek(operandAddress);
 }')
 
 define(M6502_INDIRECT, `{
-  uint16_t addr = peek(PC) | ((uint16_t)peek(PC + 1) << 8);
-  PC += 2;
+  uint16_t addr = peek(myState->PC) | ((uint16_t)peek(myState->PC + 1) << 8);
+  myState->PC += 2;
 
   // Simulate the error in the indirect addressing mode!
   uint16_t high = NOTSAMEPAGE(addr, addr + 1) ? (addr & 0xff00) : (addr + 1);
@@ -160,125 +160,125 @@ define(M6502_INDIRECT, `{
 }')
 
 define(M6502_INDIRECTX_READ, `{
-  uint8_t pointer = peek(PC++) + X;
+  uint8_t pointer = peek(myState->PC++) + myState->X;
   operandAddress = peek(pointer) | ((uint16_t)peek(pointer + 1) << 8);
   operand = peek(operandAddress);
 }')
 
 define(M6502_INDIRECTX_WRITE, `{
-  uint8_t pointer = peek(PC++) + X;
+  uint8_t pointer = peek(myState->PC++) + myState->X;
   operandAddress = peek(pointer) | ((uint16_t)peek(pointer + 1) << 8);
 }')
 
 define(M6502_INDIRECTX_READMODIFYWRITE, `{
-  uint8_t pointer = peek(PC++) + X;
+  uint8_t pointer = peek(myState->PC++) + myState->X;
   operandAddress = peek(pointer) | ((uint16_t)peek(pointer + 1) << 8);
   operand = peek(operandAddress);
 }')
 
 define(M6502_INDIRECTY_READ, `{
-  uint8_t pointer = peek(PC++);
+  uint8_t pointer = peek(myState->PC++);
   operandAddress = (uint16_t)peek(pointer) | ((uint16_t)peek(pointer + 1) << 8);
 
-  if(NOTSAMEPAGE(operandAddress, operandAddress + Y))
+  if(NOTSAMEPAGE(operandAddress, operandAddress + myState->Y))
   {
     mySystem->incrementCycles(mySystemCyclesPerProcessorCycle);
   }
 
-  operandAddress += Y;
+  operandAddress += myState->Y;
   operand = peek(operandAddress);
 }')
 
 define(M6502_INDIRECTY_WRITE, `{
-  uint8_t pointer = peek(PC++);
+  uint8_t pointer = peek(myState->PC++);
   operandAddress = (uint16_t)peek(pointer) | ((uint16_t)peek(pointer + 1) << 8);
-  operandAddress += Y;
+  operandAddress += myState->Y;
 }')
 
 define(M6502_INDIRECTY_READMODIFYWRITE, `{
-  uint8_t pointer = peek(PC++);
+  uint8_t pointer = peek(myState->PC++);
   operandAddress = (uint16_t)peek(pointer) | ((uint16_t)peek(pointer + 1) << 8);
-  operandAddress += Y;
+  operandAddress += myState->Y;
   operand = peek(operandAddress);
 }')
 
 
 define(M6502_BCC, `{
-  if(!C)
+  if(!myState->C)
   {
-    uint16_t address = PC + (int8_t)operand;
-    mySystem->incrementCycles(NOTSAMEPAGE(PC, address) ?
+    uint16_t address = myState->PC + (int8_t)operand;
+    mySystem->incrementCycles(NOTSAMEPAGE(myState->PC, address) ?
         mySystemCyclesPerProcessorCycle << 1 : mySystemCyclesPerProcessorCycle);
-    PC = address;
+    myState->PC = address;
   }
 }')
 
 define(M6502_BCS, `{
-  if(C)
+  if(myState->C)
   {
-    uint16_t address = PC + (int8_t)operand;
-    mySystem->incrementCycles(NOTSAMEPAGE(PC, address) ?
+    uint16_t address = myState->PC + (int8_t)operand;
+    mySystem->incrementCycles(NOTSAMEPAGE(myState->PC, address) ?
         mySystemCyclesPerProcessorCycle << 1 : mySystemCyclesPerProcessorCycle);
-    PC = address;
+    myState->PC = address;
   }
 }')
 
 define(M6502_BEQ, `{
-  if(!notZ)
+  if(!myState->notZ)
   {
-    uint16_t address = PC + (int8_t)operand;
-    mySystem->incrementCycles(NOTSAMEPAGE(PC, address) ?
+    uint16_t address = myState->PC + (int8_t)operand;
+    mySystem->incrementCycles(NOTSAMEPAGE(myState->PC, address) ?
         mySystemCyclesPerProcessorCycle << 1 : mySystemCyclesPerProcessorCycle);
-    PC = address;
+    myState->PC = address;
   }
 }')
 
 define(M6502_BMI, `{
-  if(N)
+  if(myState->N)
   {
-    uint16_t address = PC + (int8_t)operand;
-    mySystem->incrementCycles(NOTSAMEPAGE(PC, address) ?
+    uint16_t address = myState->PC + (int8_t)operand;
+    mySystem->incrementCycles(NOTSAMEPAGE(myState->PC, address) ?
         mySystemCyclesPerProcessorCycle << 1 : mySystemCyclesPerProcessorCycle);
-    PC = address;
+    myState->PC = address;
   }
 }')
 
 define(M6502_BNE, `{
-  if(notZ)
+  if(myState->notZ)
   {
-    uint16_t address = PC + (int8_t)operand;
-    mySystem->incrementCycles(NOTSAMEPAGE(PC, address) ?
+    uint16_t address = myState->PC + (int8_t)operand;
+    mySystem->incrementCycles(NOTSAMEPAGE(myState->PC, address) ?
         mySystemCyclesPerProcessorCycle << 1 : mySystemCyclesPerProcessorCycle);
-    PC = address;
+    myState->PC = address;
   }
 }')
 
 define(M6502_BPL, `{
-  if(!N)
+  if(!myState->N)
   {
-    uint16_t address = PC + (int8_t)operand;
-    mySystem->incrementCycles(NOTSAMEPAGE(PC, address) ?
+    uint16_t address = myState->PC + (int8_t)operand;
+    mySystem->incrementCycles(NOTSAMEPAGE(myState->PC, address) ?
         mySystemCyclesPerProcessorCycle << 1 : mySystemCyclesPerProcessorCycle);
-    PC = address;
+    myState->PC = address;
   }
 }')
 
 define(M6502_BVC, `{
-  if(!V)
+  if(!myState->V)
   {
-    uint16_t address = PC + (int8_t)operand;
-    mySystem->incrementCycles(NOTSAMEPAGE(PC, address) ?
+    uint16_t address = myState->PC + (int8_t)operand;
+    mySystem->incrementCycles(NOTSAMEPAGE(myState->PC, address) ?
         mySystemCyclesPerProcessorCycle << 1 : mySystemCyclesPerProcessorCycle);
-    PC = address;
+    myState->PC = address;
   }
 }')
 
 define(M6502_BVS, `{
-  if(V)
+  if(myState->V)
   {
-    uint16_t address = PC + (int8_t)operand;
-    mySystem->incrementCycles(NOTSAMEPAGE(PC, address) ?
+    uint16_t address = myState->PC + (int8_t)operand;
+    mySystem->incrementCycles(NOTSAMEPAGE(myState->PC, address) ?
         mySystemCyclesPerProcessorCycle << 1 : mySystemCyclesPerProcessorCycle);
-    PC = address;
+    myState->PC = address;
   }
 }')
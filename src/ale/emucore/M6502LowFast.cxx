@@ -0,0 +1,227 @@
+//============================================================================
+//
+// MM     MM  6666  555555  0000   2222
+// MMMM MMMM 66  66 55     00  00 22  22
+// MM MMM MM 66     55     00  00     22
+// MM  M  MM 66666  55555  00  00  22222  --  "A 6502 Microprocessor Emulator"
+// MM     MM 66  66     55 00  00 22
+// MM     MM 66  66 55  55 00  00 22
+// MM     MM  6666   5555   0000  222222
+//
+// Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+//
+// See the file "license" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+//============================================================================
+
+#include "ale/emucore/M6502LowFast.hxx"
+#include "ale/emucore/System.hxx"
+#include "ale/emucore/M6532.hxx"
+#include "ale/emucore/TIA.hxx"
+#include "ale/emucore/Cart2K.hxx"
+#include "ale/emucore/Cart3F.hxx"
+#include "ale/emucore/Cart4K.hxx"
+#include "ale/emucore/CartE0.hxx"
+#include "ale/emucore/CartF4.hxx"
+#include "ale/emucore/CartF4SC.hxx"
+#include "ale/emucore/CartF6.hxx"
+#include "ale/emucore/CartF6SC.hxx"
+#include "ale/emucore/CartF8.hxx"
+#include "ale/emucore/CartF8SC.hxx"
+
+#include <iostream>
+#include <typeinfo>
+
+namespace ale {
+namespace stella {
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<class Cart>
+M6502LowFast<Cart>::M6502LowFast(uint32_t systemCyclesPerProcessorCycle,
+    Cart& cart, M6532& m6532, TIA& tia)
+    : M6502Low(systemCyclesPerProcessorCycle),
+      myCart(&cart),
+      myM6532(&m6532),
+      myTIA(&tia)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<class Cart>
+M6502LowFast<Cart>::~M6502LowFast()
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<class Cart>
+size_t M6502LowFast<Cart>::memoryUsage() const
+{
+  return sizeof(*this);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<class Cart>
+inline uint8_t M6502LowFast<Cart>::devicePeek(Device* device, uint16_t address)
+{
+  // Qualified calls bypass the vtable so the handlers can be inlined
+  if(device == myTIA)
+    return myTIA->TIA::peek(address);
+  else if(device == myM6532)
+    return myM6532->M6532::peek(address);
+  else if(device == myCart)
+    return myCart->Cart::peek(address);
+  else
+    return device->peek(address);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<class Cart>
+inline void M6502LowFast<Cart>::devicePoke(Device* device, uint16_t address,
+    uint8_t value)
+{
+  if(device == myTIA)
+    myTIA->TIA::poke(address, value);
+  else if(device == myM6532)
+    myM6532->M6532::poke(address, value);
+  else if(device == myCart)
+    myCart->Cart::poke(address, value);
+  else
+    device->poke(address, value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<class Cart>
+inline uint8_t M6502LowFast<Cart>::peek(uint16_t address)
+{
+  uint8_t result = mySystem->peek(address, *this);
+  myState->myLastAccessWasRead = true;
+  return result;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<class Cart>
+inline void M6502LowFast<Cart>::poke(uint16_t address, uint8_t value)
+{
+  mySystem->poke(address, value, *this);
+  myState->myLastAccessWasRead = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<class Cart>
+bool M6502LowFast<Cart>::execute(uint32_t number)
+{
+  // Clear all of the execution status bits except for the fatal error bit
+  myState->myExecutionStatus &= FatalErrorBit;
+
+  // Loop until execution is stopped or a fatal error occurs
+  for(;;)
+  {
+    for(; !myState->myExecutionStatus && (number != 0); --number)
+    {
+      uint16_t operandAddress = 0;
+      uint8_t operand = 0;
+
+      // Fetch instruction at the program counter
+      myState->IR = peek(myState->PC++);
+
+      // Update system cycles
+      mySystem->incrementCycles(myInstructionSystemCycleTable[myState->IR]);
+
+      // Call code to execute the instruction
+      switch(myState->IR)
+      {
+        // 6502 instruction emulation is generated by an M4 macro file
+        #include "ale/emucore/M6502Low.ins"
+
+        default:
+          // Oops, illegal instruction executed so set fatal error flag
+          myState->myExecutionStatus |= FatalErrorBit;
+          std::cerr << "Illegal Instruction! " << std::hex << (int) myState->IR << std::endl;
+      }
+    }
+
+    // See if we need to handle an interrupt
+    if((myState->myExecutionStatus & MaskableInterruptBit) ||
+        (myState->myExecutionStatus & NonmaskableInterruptBit))
+    {
+      // Yes, so handle the interrupt
+      interruptHandler();
+    }
+
+    // See if execution has been stopped
+    if(myState->myExecutionStatus & StopExecutionBit)
+    {
+      // Yes, so answer that everything finished fine
+      return true;
+    }
+
+    // See if a fatal error has occured
+    if(myState->myExecutionStatus & FatalErrorBit)
+    {
+      // Yes, so answer that something when wrong
+      return false;
+    }
+
+    // See if we've executed the specified number of instructions
+    if(number == 0)
+    {
+      // Yes, so answer that everything finished fine
+      return true;
+    }
+  }
+}
+
+// Specialisations for the cartridge types most ROMs use; anything else
+// runs on the plain M6502Low
+template class M6502LowFast<Cartridge2K>;
+template class M6502LowFast<Cartridge3F>;
+template class M6502LowFast<Cartridge4K>;
+template class M6502LowFast<CartridgeE0>;
+template class M6502LowFast<CartridgeF4>;
+template class M6502LowFast<CartridgeF4SC>;
+template class M6502LowFast<CartridgeF6>;
+template class M6502LowFast<CartridgeF6SC>;
+template class M6502LowFast<CartridgeF8>;
+template class M6502LowFast<CartridgeF8SC>;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<class Cart>
+static M6502Low* createFor(uint32_t systemCyclesPerProcessorCycle,
+    Cartridge& cart, M6532& m6532, TIA& tia)
+{
+  // Only an exact type match may be specialised, since a subclass could
+  // override peek/poke
+  if(typeid(cart) != typeid(Cart))
+    return 0;
+
+  return new M6502LowFast<Cart>(systemCyclesPerProcessorCycle,
+      static_cast<Cart&>(cart), m6532, tia);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+M6502Low* createM6502Low(uint32_t systemCyclesPerProcessorCycle,
+                         Cartridge& cart, M6532& m6532, TIA& tia)
+{
+  M6502Low* cpu = 0;
+  uint32_t c = systemCyclesPerProcessorCycle;
+
+  if(!cpu) cpu = createFor<CartridgeF8>(c, cart, m6532, tia);
+  if(!cpu) cpu = createFor<CartridgeF6>(c, cart, m6532, tia);
+  if(!cpu) cpu = createFor<CartridgeF8SC>(c, cart, m6532, tia);
+  if(!cpu) cpu = createFor<CartridgeF6SC>(c, cart, m6532, tia);
+  if(!cpu) cpu = createFor<Cartridge4K>(c, cart, m6532, tia);
+  if(!cpu) cpu = createFor<Cartridge2K>(c, cart, m6532, tia);
+  if(!cpu) cpu = createFor<CartridgeF4>(c, cart, m6532, tia);
+  if(!cpu) cpu = createFor<CartridgeF4SC>(c, cart, m6532, tia);
+  if(!cpu) cpu = createFor<CartridgeE0>(c, cart, m6532, tia);
+  if(!cpu) cpu = createFor<Cartridge3F>(c, cart, m6532, tia);
+
+  // Rare cartridge types use the dynamic path
+  if(!cpu) cpu = new M6502Low(c);
+
+  return cpu;
+}
+
+}  // namespace stella
+}  // namespace ale
@@ -0,0 +1,146 @@
+//============================================================================
+//
+// MM     MM  6666  555555  0000   2222
+// MMMM MMMM 66  66 55     00  00 22  22
+// MM MMM MM 66     55     00  00     22
+// MM  M  MM 66666  55555  00  00  22222  --  "A 6502 Microprocessor Emulator"
+// MM     MM 66  66     55 00  00 22
+// MM     MM 66  66 55  55 00  00 22
+// MM     MM  6666   5555   0000  222222
+//
+// Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+//
+// See the file "license" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+//============================================================================
+
+#ifndef M6502LOWFAST_HXX
+#define M6502LOWFAST_HXX
+
+namespace ale {
+namespace stella {
+
+class Cartridge;
+class Device;
+class M6532;
+class TIA;
+
+}  // namespace stella
+}  // namespace ale
+
+#include "ale/emucore/M6502Low.hxx"
+
+namespace ale {
+namespace stella {
+
+/**
+  A low compatibility 6502 whose memory accesses are specialised for one
+  concrete cartridge class.  Reads and writes which miss the direct access
+  pages are matched against the cartridge, TIA and M6532 installed in the
+  system and dispatched through non-virtual calls, so the bank-switching
+  hotspot checks and the TIA/RIOT register handlers can be inlined into
+  the instruction loop.  Any other device still goes through the virtual
+  Device interface.
+
+  The emulated behaviour and the saved state are identical to M6502Low.
+*/
+template<class Cart>
+class M6502LowFast : public M6502Low
+{
+  public:
+    /**
+      Create a new specialised low compatibility 6502 microprocessor.
+
+      @param systemCyclesPerProcessorCycle The cycle multiplier
+      @param cart The cartridge the processor will run
+      @param m6532 The M6532 attached to the same system
+      @param tia The TIA attached to the same system
+    */
+    M6502LowFast(uint32_t systemCyclesPerProcessorCycle,
+                 Cart& cart, M6532& m6532, TIA& tia);
+
+    /**
+      Destructor
+    */
+    virtual ~M6502LowFast();
+
+  public:
+    /**
+      Execute instructions until the specified number of instructions
+      is executed, someone stops execution, or an error occurs.  Answers
+      true iff execution stops normally.
+
+      @param number Indicates the number of instructions to execute
+      @return true iff execution stops normally
+    */
+    virtual bool execute(uint32_t number);
+
+    /**
+      Answers the number of bytes of memory owned by the processor,
+      including the processor object itself
+
+      @return The number of bytes
+    */
+    virtual size_t memoryUsage() const;
+
+  public:
+    /**
+      Device dispatch used by System::peek for pages without direct access
+
+      @param device The device mapped at the address
+      @param address The address to read
+      @return The byte at the specified address
+    */
+    inline uint8_t devicePeek(Device* device, uint16_t address);
+
+    /**
+      Device dispatch used by System::poke for pages without direct access
+
+      @param device The device mapped at the address
+      @param address The address where the value should be stored
+      @param value The value to be stored at the address
+    */
+    inline void devicePoke(Device* device, uint16_t address, uint8_t value);
+
+  protected:
+    /*
+      Get the byte at the specified address
+
+      @return The byte at the specified address
+    */
+    inline uint8_t peek(uint16_t address);
+
+    /**
+      Change the byte at the specified address to the given value
+
+      @param address The address where the value should be stored
+      @param value The value to be stored at the address
+    */
+    inline void poke(uint16_t address, uint8_t value);
+
+  private:
+    // The cartridge, RIOT and TIA this processor was specialised for
+    Cart* myCart;
+    M6532* myM6532;
+    TIA* myTIA;
+};
+
+/**
+  Create a low compatibility 6502 for the given cartridge.  Common
+  cartridge types get an M6502LowFast specialisation, every other type
+  gets a plain M6502Low.
+
+  @param systemCyclesPerProcessorCycle The cycle multiplier
+  @param cart The cartridge the processor will run
+  @param m6532 The M6532 attached to the same system
+  @param tia The TIA attached to the same system
+  @return The new processor
+*/
+M6502Low* createM6502Low(uint32_t systemCyclesPerProcessorCycle,
+                         Cartridge& cart, M6532& m6532, TIA& tia);
+
+}  // namespace stella
+}  // namespace ale
+
+#endif
@@ -20,11 +20,11 @@
 #include <cassert>
 
 #include "ale/emucore/Console.hxx"
+#include "ale/emucore/Serializer.hxx"
+#include "ale/emucore/Deserializer.hxx"
 #include "ale/emucore/M6532.hxx"
 #include "ale/emucore/Switches.hxx"
 #include "ale/emucore/System.hxx"
-#include "ale/emucore/Serializer.hxx"
-#include "ale/emucore/Deserializer.hxx"
 #include "ale/emucore/OSystem.hxx"
 #include "ale/common/Log.hpp"
 
@@ -39,7 +39,7 @@ M6532::M6532(const Console& console)
 
   for(uint32_t t = 0; t < 128; ++t)
   {
-    myRAM[t] = myConsole.system().rng().next();
+    myState->myRAM[t] = myConsole.system().rng().next();
   }
 
   // Initialize other data members
@@ -57,18 +57,24 @@ const char* M6532::name() const
   return "M6532";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t M6532::memoryUsage() const
+{
+  return sizeof(*this);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6532::reset()
 {
-  myTimer = 25 + (myConsole.system().rng().next() % 75);
-  myIntervalShift = 6;
-  myCyclesWhenTimerSet = 0;
-  myCyclesWhenInterruptReset = 0;
-  myTimerReadAfterInterrupt = false;
+  myState->myTimer = 25 + (myConsole.system().rng().next() % 75);
+  myState->myIntervalShift = 6;
+  myState->myCyclesWhenTimerSet = 0;
+  myState->myCyclesWhenInterruptReset = 0;
+  myState->myTimerReadAfterInterrupt = false;
 
   // Zero the I/O registers
-  myDDRA = 0x00;
-  myDDRB = 0x00;
+  myState->myDDRA = 0x00;
+  myState->myDDRB = 0x00;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -76,8 +82,8 @@ void M6532::systemCyclesReset()
 {
   // System cycles are being reset to zero so we need to adjust
   // the cycle count we remembered when the timer was last set
-  myCyclesWhenTimerSet -= mySystem->cycles();
-  myCyclesWhenInterruptReset -= mySystem->cycles();
+  myState->myCyclesWhenTimerSet -= mySystem->cycles();
+  myState->myCyclesWhenInterruptReset -= mySystem->cycles();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -103,8 +109,8 @@ void M6532::install(System& system)
     {
       if((address & 0x0200) == 0x0000)
       {
-        access.directPeekBase = &myRAM[address & 0x007f];
-        access.directPokeBase = &myRAM[address & 0x007f];
+        access.directPeekBase = &myState->myRAM[address & 0x007f];
+        access.directPokeBase = &myState->myRAM[address & 0x007f];
         mySystem->setPageAccess(address >> shift, access);
       }
       else
@@ -149,7 +155,7 @@ uint8_t M6532::peek(uint16_t addr)
 
     case 0x01:    // Port A Data Direction Register
     {
-      return myDDRA;
+      return myState->myDDRA;
     }
 
     case 0x02:    // Port B I/O Register (Console switches)
@@ -159,15 +165,15 @@ uint8_t M6532::peek(uint16_t addr)
 
     case 0x03:    // Port B Data Direction Register
     {
-      return myDDRB;
+      return myState->myDDRB;
     }
 
     case 0x04:    // Timer Output
     case 0x06:
     {
       uint32_t cycles = mySystem->cycles() - 1;
-      uint32_t delta = cycles - myCyclesWhenTimerSet;
-      int timer = (int)myTimer - (int)(delta >> myIntervalShift) - 1;
+      uint32_t delta = cycles - myState->myCyclesWhenTimerSet;
+      int timer = (int)myState->myTimer - (int)(delta >> myState->myIntervalShift) - 1;
 
       // See if the timer has expired yet?
       if(timer >= 0)
@@ -176,21 +182,21 @@ uint8_t M6532::peek(uint16_t addr)
       }
       else
       {
-        timer = (int)(myTimer << myIntervalShift) - (int)delta - 1;
+        timer = (int)(myState->myTimer << myState->myIntervalShift) - (int)delta - 1;
 
-        if((timer <= -2) && !myTimerReadAfterInterrupt)
+        if((timer <= -2) && !myState->myTimerReadAfterInterrupt)
         {
           // Indicate that timer has been read after interrupt occured
-          myTimerReadAfterInterrupt = true;
-          myCyclesWhenInterruptReset = mySystem->cycles();
+          myState->myTimerReadAfterInterrupt = true;
+          myState->myCyclesWhenInterruptReset = mySystem->cycles();
         }
 
-        if(myTimerReadAfterInterrupt)
+        if(myState->myTimerReadAfterInterrupt)
         {
-          int offset = myCyclesWhenInterruptReset -
-              (myCyclesWhenTimerSet + (myTimer << myIntervalShift));
+          int offset = myState->myCyclesWhenInterruptReset -
+              (myState->myCyclesWhenTimerSet + (myState->myTimer << myState->myIntervalShift));
 
-          timer = (int)myTimer - (int)(delta >> myIntervalShift) - offset;
+          timer = (int)myState->myTimer - (int)(delta >> myState->myIntervalShift) - offset;
         }
 
         return (uint8_t)timer;
@@ -201,10 +207,10 @@ uint8_t M6532::peek(uint16_t addr)
     case 0x07:
     {
       uint32_t cycles = mySystem->cycles() - 1;
-      uint32_t delta = cycles - myCyclesWhenTimerSet;
-      int timer = (int)myTimer - (int)(delta >> myIntervalShift) - 1;
+      uint32_t delta = cycles - myState->myCyclesWhenTimerSet;
+      int timer = (int)myState->myTimer - (int)(delta >> myState->myIntervalShift) - 1;
 
-      if((timer >= 0) || myTimerReadAfterInterrupt)
+      if((timer >= 0) || myState->myTimerReadAfterInterrupt)
         return 0x00;
       else
         return 0x80;
@@ -225,7 +231,7 @@ void M6532::poke(uint16_t addr, uint8_t value)
 {
   if((addr & 0x07) == 0x00)         // Port A I/O Register (Joystick)
   {
-    uint8_t a = value & myDDRA;
+    uint8_t a = value & myState->myDDRA;
 
     myConsole.controller(Controller::Left).write(Controller::One, a & 0x10);
     myConsole.controller(Controller::Left).write(Controller::Two, a & 0x20);
@@ -239,7 +245,7 @@ void M6532::poke(uint16_t addr, uint8_t value)
   }
   else if((addr & 0x07) == 0x01)    // Port A Data Direction Register
   {
-    myDDRA = value;
+    myState->myDDRA = value;
   }
   else if((addr & 0x07) == 0x02)    // Port B I/O Register (Console switches)
   {
@@ -252,31 +258,31 @@ void M6532::poke(uint16_t addr, uint8_t value)
   }
   else if((addr & 0x17) == 0x14)    // Write timer divide by 1
   {
-    myTimer = value;
-    myIntervalShift = 0;
-    myCyclesWhenTimerSet = mySystem->cycles();
-    myTimerReadAfterInterrupt = false;
+    myState->myTimer = value;
+    myState->myIntervalShift = 0;
+    myState->myCyclesWhenTimerSet = mySystem->cycles();
+    myState->myTimerReadAfterInterrupt = false;
   }
   else if((addr & 0x17) == 0x15)    // Write timer divide by 8
   {
-    myTimer = value;
-    myIntervalShift = 3;
-    myCyclesWhenTimerSet = mySystem->cycles();
-    myTimerReadAfterInterrupt = false;
+    myState->myTimer = value;
+    myState->myIntervalShift = 3;
+    myState->myCyclesWhenTimerSet = mySystem->cycles();
+    myState->myTimerReadAfterInterrupt = false;
   }
   else if((addr & 0x17) == 0x16)    // Write timer divide by 64
   {
-    myTimer = value;
-    myIntervalShift = 6;
-    myCyclesWhenTimerSet = mySystem->cycles();
-    myTimerReadAfterInterrupt = false;
+    myState->myTimer = value;
+    myState->myIntervalShift = 6;
+    myState->myCyclesWhenTimerSet = mySystem->cycles();
+    myState->myTimerReadAfterInterrupt = false;
   }
   else if((addr & 0x17) == 0x17)    // Write timer divide by 1024
   {
-    myTimer = value;
-    myIntervalShift = 10;
-    myCyclesWhenTimerSet = mySystem->cycles();
-    myTimerReadAfterInterrupt = false;
+    myState->myTimer = value;
+    myState->myIntervalShift = 10;
+    myState->myCyclesWhenTimerSet = mySystem->cycles();
+    myState->myTimerReadAfterInterrupt = false;
   }
   else if((addr & 0x14) == 0x04)    // Write Edge Detect Control
   {
@@ -297,80 +303,60 @@ void M6532::poke(uint16_t addr, uint8_t value)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool M6532::save(Serializer& out)
+size_t M6532::stateSize() const
 {
-  std::string device = name();
+  return sizeof(M6532State);
+}
 
-  try
-  {
-    out.putString(device);
-
-    // Output the RAM
-    out.putInt(128);
-    for(uint32_t t = 0; t < 128; ++t)
-      out.putInt(myRAM[t]);
-
-    out.putInt(myTimer);
-    out.putInt(myIntervalShift);
-    out.putInt(myCyclesWhenTimerSet);
-    out.putInt(myCyclesWhenInterruptReset);
-    out.putBool(myTimerReadAfterInterrupt);
-    out.putInt(myDDRA);
-    out.putInt(myDDRB);
-  }
-  catch(char *msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in save state for " << device << std::endl;
-    return false;
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6532::bindState(uint8_t* state)
+{
+  myState.bind(state);
+}
 
-  return true;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateWriter M6532::stateWriter() const
+{
+  return &writeState;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool M6532::load(Deserializer& in)
+void M6532::writeState(const uint8_t* block, Serializer& out)
 {
-  std::string device = name();
+  const M6532State* state = reinterpret_cast<const M6532State*>(block);
+
+  // The 128 bytes of RAM
+  out.putInt(128);
+  for(uint32_t i = 0; i < 128; ++i)
+    out.putInt(state->myRAM[i]);
+  out.putInt(state->myTimer);
+  out.putInt(state->myIntervalShift);
+  out.putInt(state->myCyclesWhenTimerSet);
+  out.putInt(state->myCyclesWhenInterruptReset);
+  out.putBool(state->myTimerReadAfterInterrupt);
+  out.putInt(state->myDDRA);
+  out.putInt(state->myDDRB);
+}
 
-  try
-  {
-    if(in.getString() != device)
-      return false;
-
-    // Input the RAM
-    uint32_t limit = (uint32_t) in.getInt();
-    for(uint32_t t = 0; t < limit; ++t)
-      myRAM[t] = (uint8_t) in.getInt();
-
-    myTimer = (uint32_t) in.getInt();
-    myIntervalShift = (uint32_t) in.getInt();
-    myCyclesWhenTimerSet = (uint32_t) in.getInt();
-    myCyclesWhenInterruptReset = (uint32_t) in.getInt();
-    myTimerReadAfterInterrupt = in.getBool();
-
-    myDDRA = (uint8_t) in.getInt();
-    myDDRB = (uint8_t) in.getInt();
-  }
-  catch(char *msg)
-  {
-    ale::Logger::Error << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    ale::Logger::Error << "Unknown error in load state for " << device << std::endl;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool M6532::loadState(Deserializer& in, int)
+{
+  // The 128 bytes of RAM
+  if((uint32_t) in.getInt() != 128)
     return false;
-  }
+  for(uint32_t i = 0; i < 128; ++i)
+    myState->myRAM[i] = (uint8_t) in.getInt();
+  myState->myTimer = (uint32_t) in.getInt();
+  myState->myIntervalShift = (uint32_t) in.getInt();
+  myState->myCyclesWhenTimerSet = (int) in.getInt();
+  myState->myCyclesWhenInterruptReset = (int) in.getInt();
+  myState->myTimerReadAfterInterrupt = in.getBool();
+  myState->myDDRA = (uint8_t) in.getInt();
+  myState->myDDRB = (uint8_t) in.getInt();
 
   return true;
 }
 
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 M6532::M6532(const M6532& c)
     : myConsole(c.myConsole)
@@ -24,8 +24,6 @@ namespace stella {
 
 class Console;
 class System;
-class Serializer;
-class Deserializer;
 
 }  // namespace stella
 }  // namespace ale
@@ -36,6 +34,37 @@ class Deserializer;
 namespace ale {
 namespace stella {
 
+/**
+  The RAM, timer and I/O registers of the RIOT, kept in a trivially
+  copyable block so that they can be saved and restored with memcpy.
+*/
+struct M6532State
+{
+  // An amazing 128 bytes of RAM
+  uint8_t myRAM[128];
+
+  // Current value of my Timer
+  uint32_t myTimer;
+
+  // Log base 2 of the number of cycles in a timer interval
+  uint32_t myIntervalShift;
+
+  // Indicates the number of cycles when the timer was last set
+  int myCyclesWhenTimerSet;
+
+  // Indicates when the timer was read after timer interrupt occured
+  int myCyclesWhenInterruptReset;
+
+  // Indicates if a read from timer has taken place after interrupt occured
+  bool myTimerReadAfterInterrupt;
+
+  // Data Direction Register for Port A
+  uint8_t myDDRA;
+
+  // Data Direction Register for Port B
+  uint8_t myDDRB;
+};
+
 /**
   RIOT
 
@@ -65,6 +94,14 @@ class M6532 : public Device
     */
     virtual const char* name() const;
 
+    /**
+      Answers the number of bytes of memory owned by the device, including
+      the device object itself
+
+      @return The number of bytes
+    */
+    virtual size_t memoryUsage() const;
+
     /**
       Reset cartridge to its power-on state
     */
@@ -86,20 +123,37 @@ class M6532 : public Device
     virtual void install(System& system);
 
     /**
-      Saves the current state of this device to the given Serializer.
+      Answers the number of bytes of the state block of the device.
 
-      @param out The serializer device to save to.
-      @return The result of the save.  True on success, false on failure.
+      @return The size of the state block
     */
-    virtual bool save(Serializer& out);
+    virtual size_t stateSize() const;
 
     /**
-      Loads the current state of this device from the given Deserializer.
+      Moves the state block of the device to the given stateSize() bytes
+      of the machine state.
+
+      @param state The bytes to move the block to
+    */
+    virtual void bindState(uint8_t* state);
+
+    /**
+      Answers the function writing the state block of the device to a
+      saved state in the portable format.
+
+      @return The writer of the state block
+    */
+    virtual StateWriter stateWriter() const;
+
+    /**
+      Reads the state block of the device from a saved state in the given
+      version of the portable format.
 
       @param in The deserializer device to load from.
+      @param version The version of the format
       @return The result of the load.  True on success, false on failure.
     */
-    virtual bool load(Deserializer& in);
+    virtual bool loadState(Deserializer& in, int version);
 
    public:
     /**
@@ -121,36 +175,19 @@ class M6532 : public Device
     // Reference to the console
     const Console& myConsole;
 
-    // An amazing 128 bytes of RAM
-    uint8_t myRAM[128];
-
-    // Current value of my Timer
-    uint32_t myTimer;
-
-    // Log base 2 of the number of cycles in a timer interval
-    uint32_t myIntervalShift;
-
-    // Indicates the number of cycles when the timer was last set
-    int myCyclesWhenTimerSet;
-
-    // Indicates when the timer was read after timer interrupt occured
-    int myCyclesWhenInterruptReset;
-
-    // Indicates if a read from timer has taken place after interrupt occured
-    bool myTimerReadAfterInterrupt;
-
-    // Data Direction Register for Port A
-    uint8_t myDDRA;
-
-    // Data Direction Register for Port B
-    uint8_t myDDRB;
-
   private:
     // Copy constructor isn't supported by this class so make it private
     M6532(const M6532&);
 
     // Assignment operator isn't supported by this class so make it private
     M6532& operator = (const M6532&);
+
+  private:
+    // Writes a state block field by field
+    static void writeState(const uint8_t* block, Serializer& out);
+
+    // The RAM, timer and ports
+    StateView<M6532State> myState;
 };
 
 }  // namespace stella
@@ -76,6 +76,27 @@ class MediaSource
     */
     virtual uint8_t* previousFrameBuffer() const = 0;
 
+    /**
+      Answers a bitmap of the rows of the current frame buffer that differ
+      from the previous frame buffer, one bit per row (bit row % 64 of word
+      row / 64), DirtyRowWords words long
+
+      @return Pointer to the bitmap
+    */
+    virtual const uint64_t* dirtyRows() const = 0;
+
+    // Words in the dirtyRows() bitmap, enough for the 300 buffer rows
+    enum { DirtyRowWords = 5 };
+
+    /**
+      Answers the 64-bit hash (see ale::hashScreen) of the first rows of
+      the current frame buffer
+
+      @param rows The number of rows to hash
+      @return The hash
+    */
+    virtual uint64_t frameHash(uint32_t rows) const = 0;
+
   public:
     /**
       Answers the height of the frame buffer
@@ -105,6 +126,21 @@ class MediaSource
     */
     virtual void setSound(Sound& sound) = 0;
 
+    /**
+      Turns pixel output on or off.  While it is off frames are emulated
+      exactly (collisions included) but the frame buffer isn't written.
+
+      @param fast True to skip writing the frame buffer
+    */
+    virtual void setFastUpdate(bool fast) = 0;
+
+    /**
+      Swaps the current and previous frame buffers back.  A frame emulated
+      again from the state it started in is then drawn into the buffer it
+      was first drawn into, with the frame before it still the previous one.
+    */
+    virtual void swapFrameBuffers() = 0;
+
   private:
     // Copy constructor isn't supported by this class so make it private
     MediaSource(const MediaSource&);
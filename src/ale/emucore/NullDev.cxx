@@ -17,8 +17,6 @@
 //============================================================================
 
 #include "ale/emucore/NullDev.hxx"
-#include "ale/emucore/Serializer.hxx"
-#include "ale/emucore/Deserializer.hxx"
 
 #include <iostream>
 
@@ -41,6 +39,12 @@ const char* NullDevice::name() const
   return "NULL";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t NullDevice::memoryUsage() const
+{
+  return sizeof(*this);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void NullDevice::reset()
 {
@@ -66,13 +70,24 @@ void NullDevice::poke(uint16_t address, uint8_t value)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool NullDevice::save(Serializer& out)
+size_t NullDevice::stateSize() const
 {
-  return true;
+  return 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void NullDevice::bindState(uint8_t*)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateWriter NullDevice::stateWriter() const
+{
+  return 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool NullDevice::load(Deserializer& in)
+bool NullDevice::loadState(Deserializer&, int)
 {
   return true;
 }
@@ -24,6 +24,7 @@
 #include <string>
 #include <zlib.h>
 
+#include "ale/common/MemoryUsage.hpp"
 #include "ale/emucore/MD5.hxx"
 #include "ale/emucore/Settings.hxx"
 #include "ale/emucore/PropsSet.hxx"
@@ -54,7 +55,6 @@ OSystem::OSystem()
     mySound(NULL),
     myScreen(NULL),
     mySettings(NULL),
-    myPropSet(NULL),
     myConsole(NULL),
     myRomFile("")
 {
@@ -71,8 +71,6 @@ OSystem::~OSystem()
   if (mySound != NULL)
     delete mySound;
 
-  if (myPropSet != NULL)
-    delete myPropSet;
   if (myEvent != NULL)
     delete myEvent;
   if (myScreen != NULL) {
@@ -89,11 +87,8 @@ bool OSystem::create()
   // Create the event object which will be used for this handler
   myEvent = new Event();
 
-  // Delete the previous properties set (if any).
-  delete myPropSet;
-
-  // Create a properties set for us to use and set it up
-  myPropSet = new PropertiesSet();
+  // Use the properties set shared by every system
+  myPropSet = PropertiesSet::shared();
 
   // Create the sound object; the sound subsystem isn't actually
   // opened until needed, so this is non-blocking (on those systems
@@ -222,6 +217,26 @@ void OSystem::deleteConsole()
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void OSystem::memoryUsage(MemoryUsage& usage) const
+{
+  size_t bytes = sizeof(*this) + MemoryUsage::heapBytes(myRomFile);
+  if(myEvent)
+    bytes += sizeof(Event);
+  bytes += m_colour_palette.userPalettesMemoryUsage();
+  usage.add("OSystem", bytes);
+  if(myPropSet)
+    usage.add("PropertiesSet", myPropSet->memoryUsage(), true);
+  usage.add("ColourPalette tables", m_colour_palette.tablesMemoryUsage(), true);
+
+  if(mySettings)
+    usage.add("Settings", mySettings->memoryUsage());
+  if(mySound)
+    usage.add("Sound", mySound->memoryUsage());
+  if(myConsole)
+    myConsole->memoryUsage(usage);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool OSystem::openROM(const fs::path& rom, std::string& md5, uint8_t** image, int* size)
 {
@@ -238,24 +253,6 @@ bool OSystem::openROM(const fs::path& rom, std::string& md5, uint8_t** image, in
   // Now we make sure that the file has a valid properties entry
   md5 = MD5(*image, *size);
 
-  // Some games may not have a name, since there may not
-  // be an entry in stella.pro.  In that case, we use the rom name
-  // and reinsert the properties object
-  Properties props;
-  myPropSet->getMD5(md5, props);
-
-  std::string name = props.get(Cartridge_Name);
-  if(name == "Untitled")
-  {
-    // Use the filename stem if we don't have this ROM in DefProps.
-    // Stem is just the filename excluding the extension.
-    // ROM is a valid file so we don't have to do extensive checks here
-    fs::path rom_path(rom);
-    props.set(Cartridge_MD5, md5);
-    props.set(Cartridge_Name, rom_path.stem().string());
-    myPropSet->insert(props, false);
-  }
-
   return true;
 }
 
@@ -268,6 +265,17 @@ bool OSystem::queryConsoleInfo(const uint8_t* image, uint32_t size,
   std::string s;
   myPropSet->getMD5(md5, props);
 
+  // Some games may not have a name, since there may not
+  // be an entry in stella.pro.  In that case, we use the rom name
+  if(props.get(Cartridge_Name) == "Untitled")
+  {
+    // Use the filename stem if we don't have this ROM in DefProps.
+    // Stem is just the filename excluding the extension.
+    // ROM is a valid file so we don't have to do extensive checks here
+    props.set(Cartridge_MD5, md5);
+    props.set(Cartridge_Name, fs::path(myRomFile).stem().string());
+  }
+
     s = mySettings->getString("type");
     if(s != "") props.set(Cartridge_Type, s);
     s = mySettings->getString("channels");
@@ -28,6 +28,7 @@ class PropertiesSet;
 }  // namespace ale
 
 #include <filesystem>
+#include <memory>
 
 #include "ale/emucore/Sound.hxx"
 #include "ale/emucore/Screen.hxx"
@@ -149,6 +150,14 @@ class OSystem
     */
     void deleteConsole();
 
+    /**
+      Adds the memory held by this system, its settings, its sound device
+      and the current console to the given accounting.
+
+      @param usage The accounting to add to
+    */
+    void memoryUsage(MemoryUsage& usage) const;
+
     /**
       Open the given ROM and return an array containing its contents.
 
@@ -174,8 +183,8 @@ class OSystem
     // Pointer to the Settings object
     Settings* mySettings;
 
-    // Pointer to the PropertiesSet object
-    PropertiesSet* myPropSet;
+    // The built-in properties, shared with every other system
+    std::shared_ptr<const PropertiesSet> myPropSet;
 
     // Pointer to the (currently defined) Console object
     Console* myConsole;
@@ -73,6 +73,8 @@ Paddles::~Paddles()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Paddles::read(DigitalPin pin)
 {
+  myPolled = true;
+
   switch(pin)
   {
     case Three:
@@ -92,6 +94,8 @@ bool Paddles::read(DigitalPin pin)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int Paddles::read(AnalogPin pin)
 {
+  myPolled = true;
+
   switch(pin)
   {
     case Five:
@@ -23,6 +23,7 @@
 #include <iostream>
 #include <cstdint>
 
+#include "ale/common/MemoryUsage.hpp"
 #include "ale/emucore/Props.hxx"
 
 namespace ale {
@@ -266,6 +267,15 @@ void Properties::print() const
             << std::endl;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t Properties::memoryUsage() const
+{
+  size_t bytes = sizeof(*this);
+  for(int i = 0; i < LastPropType; ++i)
+    bytes += MemoryUsage::heapBytes(myProperties[i]);
+  return bytes;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Properties::setDefaults()
 {
@@ -121,6 +121,14 @@ class Properties
     */
     void print() const;
 
+    /**
+      Answers the number of bytes of memory held by this properties object,
+      including the object itself.
+
+      @return The number of bytes
+    */
+    size_t memoryUsage() const;
+
     /**
       Resets all properties to their defaults
     */
@@ -20,6 +20,7 @@
 #include <sstream>
 #include <cstring>
 #include <iostream>
+#include <mutex>
 
 #include "ale/emucore/DefProps.hxx"
 #include "ale/emucore/Props.hxx"
@@ -41,6 +42,22 @@ PropertiesSet::~PropertiesSet()
   deleteNode(myRoot);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::shared_ptr<const PropertiesSet> PropertiesSet::shared()
+{
+  static std::mutex mutex;
+  static std::weak_ptr<const PropertiesSet> set;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  std::shared_ptr<const PropertiesSet> current = set.lock();
+  if(!current)
+  {
+    current = std::make_shared<const PropertiesSet>();
+    set = current;
+  }
+  return current;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void PropertiesSet::getMD5(const std::string& md5, Properties& properties,
                            bool useDefaults) const
@@ -193,11 +210,27 @@ void PropertiesSet::printNode(TreeNode *node) const
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t PropertiesSet::nodeMemoryUsage(const TreeNode* node)
+{
+  if(!node)
+    return 0;
+
+  return sizeof(TreeNode) + node->props->memoryUsage() +
+         nodeMemoryUsage(node->left) + nodeMemoryUsage(node->right);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uint32_t PropertiesSet::size() const
 {
   return mySize;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t PropertiesSet::memoryUsage() const
+{
+  return sizeof(*this) + nodeMemoryUsage(myRoot);
+}
+
 }  // namespace stella
 }  // namespace ale
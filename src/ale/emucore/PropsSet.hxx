@@ -19,7 +19,9 @@
 #ifndef PROPERTIES_SET_HXX
 #define PROPERTIES_SET_HXX
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 
 namespace ale {
 namespace stella {
@@ -51,6 +53,14 @@ class PropertiesSet
     */
     virtual ~PropertiesSet();
 
+    /**
+      Answers the set of built-in properties, which is immutable and
+      shared by every system that uses it.
+
+      @return  The shared set
+    */
+    static std::shared_ptr<const PropertiesSet> shared();
+
   public:
     /**
       Get the property from the set with the given MD5.
@@ -87,6 +97,14 @@ class PropertiesSet
     */
     uint32_t size() const;
 
+    /**
+      Answers the number of bytes of memory held by the collection,
+      including the object itself.
+
+      @return  The number of bytes
+    */
+    size_t memoryUsage() const;
+
     /**
       Prints the contents of the PropertiesSet as a flat file.
     */
@@ -125,6 +143,13 @@ class PropertiesSet
     */
     void printNode(TreeNode* node) const;
 
+    /**
+      Answers the number of bytes held by the given subtree.
+
+      @param node  The current subroot of the tree
+    */
+    static size_t nodeMemoryUsage(const TreeNode* node);
+
   private:
     // The root of the BST
     TreeNode* myRoot;
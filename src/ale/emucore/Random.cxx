@@ -16,116 +16,160 @@
 // $Id: Random.cxx,v 1.4 2007/01/01 18:04:49 stephena Exp $
 //============================================================================
 
-#include <time.h>
 #include "ale/emucore/Random.hxx"
 #include "ale/emucore/Serializer.hxx"
 #include "ale/emucore/Deserializer.hxx"
 
-// This uses C++11.
-#include <random>
 #include <sstream>
+#include <stdexcept>
+#include <type_traits>
 
 namespace ale {
 namespace stella {
 
-// Implementation of Random's random number generator wrapper.
-class Random::Impl {
-
-  typedef std::mt19937 randgen_t;
-
-  public:
-
-    Impl();
-
-    // Implementations of the methods defined in Random.hpp.
-    void seed(uint32_t value);
-    uint32_t next();
-    double nextDouble();
-
-  private:
-
-    friend class Random;
-
-    // Seed to use for creating new random number generators
-    uint32_t m_seed;
-
-    // Random number generator
-    randgen_t m_randgen;
-};
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Random::Generator Random::generatorFromName(const std::string& name)
+{
+  if(name == "mt19937")
+    return MT19937;
+  if(name == "pcg32")
+    return PCG32;
+  throw std::runtime_error("Unknown random_generator '" + name +
+                           "' (expected mt19937 or pcg32)");
+}
 
-Random::Impl::Impl()
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Random::Random()
+  : myGenerator(MT19937)
 {
-    // Initialize seed to time
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Random::Impl::seed(uint32_t value)
+void Random::seed(uint32_t value)
 {
-  m_seed = value;
-  m_randgen.seed(m_seed);
+  seed(value, 0);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uint32_t Random::Impl::next()
+void Random::seed(uint32_t value, uint64_t stream)
 {
-  return m_randgen();
+  if(myGenerator == PCG32)
+  {
+    // Seeding procedure of the PCG reference implementation
+    myPcg->state = 0;
+    myPcg->increment = (stream << 1) | 1;
+    nextPcg();
+    myPcg->state += value;
+    nextPcg();
+  }
+  else
+  {
+    myMersenne->seed(value);
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-double Random::Impl::nextDouble()
+void Random::setGenerator(Generator generator)
 {
-  return m_randgen() / double(m_randgen.max() + 1.0);
+  myGenerator = generator;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Random::Random() :
-    m_pimpl(new Random::Impl())
+bool Random::saveState(Serializer& ser)
 {
+  if(myGenerator == PCG32)
+  {
+    ser.putInt((uint32_t) myPcg->state);
+    ser.putInt((uint32_t) (myPcg->state >> 32));
+    ser.putInt((uint32_t) myPcg->increment);
+    ser.putInt((uint32_t) (myPcg->increment >> 32));
+    return true;
+  }
+
+  // The mt19937 object's serialization of choice is into a string.
+  std::ostringstream oss;
+  oss << *myMersenne;
+
+  ser.putString(oss.str());
+
+  return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Random::~Random() {
-  if (m_pimpl != NULL) {
-    delete m_pimpl;
-    m_pimpl = NULL;
+bool Random::loadState(Deserializer& deser)
+{
+  if(myGenerator == PCG32)
+  {
+    uint64_t low = (uint32_t) deser.getInt();
+    myPcg->state = low | ((uint64_t) (uint32_t) deser.getInt() << 32);
+    low = (uint32_t) deser.getInt();
+    myPcg->increment = low | ((uint64_t) (uint32_t) deser.getInt() << 32);
+    return true;
   }
+
+  // Deserialize into a string.
+  std::istringstream iss(deser.getString());
+
+  iss >> *myMersenne;
+
+  return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Random::seed(uint32_t value)
+size_t Random::stateSize() const
 {
-  m_pimpl->seed(value);
+  static_assert(std::is_trivially_copyable<std::mt19937>::value,
+                "The generator state is moved as a block");
+  return myGenerator == PCG32 ? sizeof(PcgState) : sizeof(std::mt19937);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uint32_t Random::next()
+void Random::bindState(uint8_t* state)
 {
-  return m_pimpl->next();
+  if(myGenerator == PCG32)
+    myPcg.bind(state);
+  else
+    myMersenne.bind(state);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-double Random::nextDouble()
+StateWriter Random::stateWriter() const
 {
-  return m_pimpl->nextDouble();
+  return myGenerator == PCG32 ? &writePcg : &writeMersenne;
 }
 
-bool Random::saveState(Serializer& ser) {
-  // The mt19937 object's serialization of choice is into a string.
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Random::writeMersenne(const uint8_t* block, Serializer& out)
+{
   std::ostringstream oss;
-  oss << m_pimpl->m_randgen;
+  oss << *reinterpret_cast<const std::mt19937*>(block);
 
-  ser.putString(oss.str());
-
-  return true;
+  out.putString("mt19937");
+  out.putString(oss.str());
 }
 
-bool Random::loadState(Deserializer& deser) {
-  // Deserialize into a string.
-  std::istringstream iss(deser.getString());
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Random::writePcg(const uint8_t* block, Serializer& out)
+{
+  const PcgState* state = reinterpret_cast<const PcgState*>(block);
 
-  iss >> m_pimpl->m_randgen;
+  out.putString("pcg32");
+  out.putInt((uint32_t) state->state);
+  out.putInt((uint32_t) (state->state >> 32));
+  out.putInt((uint32_t) state->increment);
+  out.putInt((uint32_t) (state->increment >> 32));
+}
 
-  return true;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Random::loadState(Deserializer& in, int version)
+{
+  // Older versions of ALE had only the Mersenne Twister, and did not name it
+  std::string name = version == 0 ? "mt19937" : in.getString();
+  if(generatorFromName(name) != myGenerator)
+    throw std::runtime_error("The state was saved with the " + name +
+                             " random_generator, which is not the one in use");
+
+  return loadState(in);
 }
 
 }  // namespace stella
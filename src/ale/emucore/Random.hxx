@@ -29,7 +29,12 @@ class Deserializer;
 }  // namespace stella
 }  // namespace ale
 
+#include <cstddef>
 #include <cstdint>
+#include <random>
+#include <string>
+
+#include "ale/emucore/Device.hxx"
 
 namespace ale {
 namespace stella {
@@ -37,10 +42,31 @@ namespace stella {
 /**
   This Random class uses a Mersenne Twister to provide pseudorandom numbers.
   The class itself is derived from the original 'Random' class by Bradford W. Mott.
+
+  A PCG32 generator (16 bytes of state, with a selectable stream) can be
+  used instead where snapshots of the generator should stay small.  The
+  state of the generator in use can be moved into the machine state of a
+  System, like the state block of a device.
 */
 class Random
 {
   public:
+    /**
+      The generators a Random can use
+    */
+    enum Generator
+    {
+      MT19937,  // Mersenne Twister, the default for compatibility with existing seeds
+      PCG32     // PCG-XSH-RR with 64 bits of state and a 63 bit stream selector
+    };
+
+    /**
+      Answers the generator named by the given string ("mt19937" or "pcg32")
+
+      @param name The name of the generator
+      @return The generator, or throws for an unknown name
+    */
+    static Generator generatorFromName(const std::string& name);
 
     /**
       Class method which allows you to set the seed that'll be used
@@ -50,26 +76,54 @@ class Random
     */
     void seed(uint32_t value);
 
+    /**
+      Seeds the generator on the given stream.  PCG32 generators seeded with
+      the same value on different streams produce independent sequences; the
+      stream is ignored by the Mersenne Twister.
+
+      @param value The value to seed the random number generator with
+      @param stream The stream to draw the numbers from
+    */
+    void seed(uint32_t value, uint64_t stream);
+
+    /**
+      Selects the generator used from now on.  The generator must be seeded
+      again after it is changed, and cannot be changed once its state has
+      been bound.
+
+      @param generator The generator to use
+    */
+    void setGenerator(Generator generator);
+
+    /**
+      Answers the generator in use
+    */
+    Generator generator() const { return myGenerator; }
+
     /**
       Create a new random number generator
     */
     Random();
 
-    ~Random();
-
     /**
       Answer the next random number from the random number generator
 
       @return A random number
     */
-    uint32_t next();
+    uint32_t next()
+    {
+      return myGenerator == PCG32 ? nextPcg() : uint32_t((*myMersenne)());
+    }
 
     /**
       Answer the next random number between 0 and 1 from the random number generator
 
       @return A random number between 0 and 1
     */
-    double nextDouble();
+    double nextDouble()
+    {
+      return next() / 4294967296.0;
+    }
 
     /**
       Serializes the RNG state.
@@ -81,11 +135,60 @@ class Random
     */
     bool loadState(Deserializer& in);
 
-    private:
+    /**
+      Answers the number of bytes of the state of the generator in use
+    */
+    size_t stateSize() const;
 
-    // Actual rng (implementation hidden away from the header to avoid depending on rng libraries).
-    class Impl;
-    Impl *m_pimpl;
+    /**
+      Moves the state of the generator in use to the given stateSize()
+      bytes of the machine state.
+    */
+    void bindState(uint8_t* state);
+
+    /**
+      Answers the function writing the state of the generator in use to a
+      saved state in the portable format, after the name of the generator.
+    */
+    StateWriter stateWriter() const;
+
+    /**
+      Reads the state of the generator in use from a saved state in the
+      given version of the portable format.  Throws std::runtime_error if
+      the state was saved with the other generator.
+    */
+    bool loadState(Deserializer& in, int version);
+
+  private:
+    // Advances the PCG32 generator and answers its output
+    uint32_t nextPcg()
+    {
+      uint64_t old = myPcg->state;
+      myPcg->state = old * 6364136223846793005ULL + myPcg->increment;
+      uint32_t xorshifted = uint32_t(((old >> 18) ^ old) >> 27);
+      uint32_t rot = uint32_t(old >> 59);
+      return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+
+  private:
+    struct PcgState
+    {
+      uint64_t state;
+      uint64_t increment;  // Always odd
+    };
+
+    // The generator next() draws from
+    Generator myGenerator;
+
+    // Write the state of each generator field by field
+    static void writeMersenne(const uint8_t* block, Serializer& out);
+    static void writePcg(const uint8_t* block, Serializer& out);
+
+    // Mersenne Twister state
+    StateView<std::mt19937> myMersenne;
+
+    // PCG32 state
+    StateView<PcgState> myPcg;
 };
 
 }  // namespace stella
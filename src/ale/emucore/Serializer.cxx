@@ -71,5 +71,15 @@ void Serializer::putBool(bool b)
     putInt(b ? TruePattern: FalsePattern);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Serializer::putBytes(const uint8_t* data, uint32_t size)
+{
+    putInt((int)size);
+    myStream.write((const char*)data, (std::streamsize)size);
+
+    if(myStream.bad())
+        throw "Serializer: file write failed";
+}
+
 }  // namespace stella
 }  // namespace ale
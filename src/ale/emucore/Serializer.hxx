@@ -19,6 +19,7 @@
 #ifndef SERIALIZER_HXX
 #define SERIALIZER_HXX
 
+#include <cstdint>
 #include <sstream>
 
 namespace ale {
@@ -82,6 +83,16 @@ class Serializer
     */
     void putBool(bool b);
 
+    /**
+      Writes a block of bytes to the current output stream, prepended by
+      its size.  The bytes are written as they are, so the block must only
+      be read back on a machine with the same layout.
+
+      @param data The bytes to write to the output stream.
+      @param size The number of bytes to write.
+    */
+    void putBytes(const uint8_t* data, uint32_t size);
+
     // Accessor for myStream
     // TODO: don't copy the whole streams.
     std::string get_str(void) const {
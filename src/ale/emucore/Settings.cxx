@@ -23,6 +23,7 @@
 #include <algorithm>
 #include <string>
 
+#include "ale/common/MemoryUsage.hpp"
 #include "ale/emucore/OSystem.hxx"
 #include "ale/emucore/Settings.hxx"
 
@@ -245,6 +246,46 @@ void Settings::setSize(const std::string& key, const int value1, const int value
   setString(key, buf.str());
 }
 
+// Heap bytes of a settings map: one tree node per entry, each holding the
+// key and value, plus whatever the key string keeps out of line
+template<typename ValueType>
+static size_t mapMemoryUsage(const std::map<std::string, ValueType>& dict)
+{
+  size_t bytes = 0;
+  for(const auto& entry : dict)
+    bytes += 4 * sizeof(void*) + sizeof(entry) +
+             MemoryUsage::heapBytes(entry.first);
+  return bytes;
+}
+
+static size_t mapMemoryUsage(const std::map<std::string, std::string>& dict)
+{
+  size_t bytes = 0;
+  for(const auto& entry : dict)
+    bytes += 4 * sizeof(void*) + sizeof(entry) +
+             MemoryUsage::heapBytes(entry.first) +
+             MemoryUsage::heapBytes(entry.second);
+  return bytes;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t Settings::memoryUsage() const
+{
+  size_t bytes = sizeof(*this);
+  const SettingsArray* arrays[] = { &myInternalSettings, &myExternalSettings };
+  for(const SettingsArray* array : arrays)
+  {
+    bytes += array->capacity() * sizeof(Setting);
+    for(const Setting& setting : *array)
+      bytes += MemoryUsage::heapBytes(setting.key) +
+               MemoryUsage::heapBytes(setting.value) +
+               MemoryUsage::heapBytes(setting.initialValue);
+  }
+
+  return bytes + mapMemoryUsage(intSettings) + mapMemoryUsage(boolSettings) +
+         mapMemoryUsage(floatSettings) + mapMemoryUsage(stringSettings);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int Settings::getInternalPos(const std::string& key) const
 {
@@ -405,15 +446,26 @@ void Settings::setDefaultSettings() {
     intSettings.insert(std::pair<std::string, int>("paddle_min", -1));
     intSettings.insert(std::pair<std::string, int>("paddle_max", -1));
 
-    // FIFO controller settings
+    // Legacy FIFO controller setting, kept so existing configurations still
+    // load; run-length encoded screens are requested per call through
+    // ALEInterface::encodeScreenRLE / ale_encodeScreenRLE
     boolSettings.insert(std::pair<std::string, bool>("run_length_encoding", true));
 
     // Environment customization settings
     boolSettings.insert(std::pair<std::string, bool>("restricted_action_set", false));
     intSettings.insert(std::pair<std::string, int>("random_seed", -1));
+    // Generator behind random_seed and system_random_seed: "mt19937", or
+    // "pcg32" for 16 byte generator snapshots. With pcg32, random_stream
+    // selects an independent sequence for the same seed (e.g. one per env)
+    stringSettings.insert(std::pair<std::string, std::string>("random_generator", "mt19937"));
+    intSettings.insert(std::pair<std::string, int>("random_stream", 0));
     boolSettings.insert(std::pair<std::string, bool>("color_averaging", false));
     boolSettings.insert(std::pair<std::string, bool>("send_rgb", false));
     intSettings.insert(std::pair<std::string, int>("frame_skip", 1));
+    // Keep emulating after frame_skip frames until the game reads its controllers,
+    // adding at most auto_frame_skip_max frames to a single act()
+    boolSettings.insert(std::pair<std::string, bool>("auto_frame_skip", false));
+    intSettings.insert(std::pair<std::string, int>("auto_frame_skip_max", 60));
     floatSettings.insert(std::pair<std::string, float>("repeat_action_probability", 0.25));
     stringSettings.insert(std::pair<std::string, std::string>("rom_file", ""));
     // Whether to truncate an episode on loss of life.
@@ -425,13 +477,59 @@ void Settings::setDefaultSettings() {
     // Record settings
     intSettings.insert(std::pair<std::string, int>("fragsize", 64)); // fragsize to 64 ensures proper sound sync
     stringSettings.insert(std::pair<std::string, std::string>("record_screen_dir", ""));
+    // Threads encoding the recorded screens in the background (0 encodes them
+    // inside act()), "rgb" or "indexed" (8-bit palette) PNGs, and the zlib
+    // compression level (-1 for zlib's default, 1 for the fastest)
+    intSettings.insert(std::pair<std::string, int>("record_screen_threads", 2));
+    stringSettings.insert(std::pair<std::string, std::string>("record_screen_format", "rgb"));
+    intSettings.insert(std::pair<std::string, int>("record_screen_compression", -1));
+    // Directory receiving one episode video file per episode (see EpisodeVideo.hpp)
+    stringSettings.insert(std::pair<std::string, std::string>("record_video_dir", ""));
+    // Directory receiving the trajectory dataset files (see TrajectoryDataset.hpp)
+    stringSettings.insert(std::pair<std::string, std::string>("dataset_dir", ""));
+    // Frames column of the dataset: none, raw (mappable in place) or zlib
+    stringSettings.insert(std::pair<std::string, std::string>("dataset_frames", "raw"));
+    // Records per dataset block, and blocks per dataset file
+    intSettings.insert(std::pair<std::string, int>("dataset_block_records", 256));
+    intSettings.insert(std::pair<std::string, int>("dataset_file_blocks", 64));
+    // Blocks between flushes of the dataset file to disk (0: only when it is closed)
+    intSettings.insert(std::pair<std::string, int>("dataset_sync_blocks", 1));
     stringSettings.insert(std::pair<std::string, std::string>("record_sound_filename", ""));
 
+    // Observations to maintain: "screen", "ram" (no pixel work at all) or "none"
+    stringSettings.insert(std::pair<std::string, std::string>("observation_mode", "screen"));
+    // Preprocessing of the observation buffer: max over the last two frames of
+    // a step and resizing (0 keeps the screen size) with nearest, bilinear, area
+    // or max (maximum over the covered pixels, so thin objects survive)
+    boolSettings.insert(std::pair<std::string, bool>("observation_max_pool", false));
+    intSettings.insert(std::pair<std::string, int>("observation_width", 0));
+    intSettings.insert(std::pair<std::string, int>("observation_height", 0));
+    stringSettings.insert(std::pair<std::string, std::string>("observation_interpolation", "area"));
+    // Ring buffer of the last frame_stack observations (0 for none), in the
+    // given observation format (0 palette, 1 grayscale, 2 RGB, 3 planar RGB, 4 RGBA)
+    intSettings.insert(std::pair<std::string, int>("frame_stack", 0));
+    intSettings.insert(std::pair<std::string, int>("frame_stack_format", 1));
+
     // Display Settings
     boolSettings.insert(std::pair<std::string, bool>("display_screen", false));
+    // Use the AVX2 palette converters when the CPU supports them
+    boolSettings.insert(std::pair<std::string, bool>("palette_simd", true));
+    // Use the SSE2/AVX2 scanline renderer when the CPU supports it
+    boolSettings.insert(std::pair<std::string, bool>("tia_simd", true));
+    // Never write the TIA frame buffer (collisions are still computed)
+    boolSettings.insert(std::pair<std::string, bool>("fast_tia_update", false));
+    // Only rasterise the frames of a frame_skip step that make up the observation
+    boolSettings.insert(std::pair<std::string, bool>("render_observed_frames_only", false));
+    // Log each frame's TIA writes and rasterise it only when the screen is read
+    boolSettings.insert(std::pair<std::string, bool>("deferred_tia_render", false));
+    // Scanlines the TIA rasterises: "all", or "even" to draw only even frame
+    // rows and fill each odd row with a copy of the row above it
+    stringSettings.insert(std::pair<std::string, std::string>("tia_render_lines", "all"));
 
     // Audio Settings
     boolSettings.insert(std::pair<std::string, bool>("sound_obs", false));
+    // Keep the audio of every frame of a step, not only of the last one
+    boolSettings.insert(std::pair<std::string, bool>("sound_obs_window", false));
 
     for(std::map<std::string, std::string>::iterator it = stringSettings.begin(); it != stringSettings.end(); it++) {
       this->setString(it->first, it->second);
@@ -146,6 +146,14 @@ class Settings
     */
     void setSize(const std::string& key, const int value1, const int value2);
 
+    /**
+      Answers the number of bytes of memory held by the settings, including
+      the object itself.
+
+      @return The number of bytes
+    */
+    size_t memoryUsage() const;
+
 
   private:
     // Copy constructor isn't supported by this class so make it private
@@ -19,6 +19,7 @@
 #ifndef SOUND_HXX
 #define SOUND_HXX
 
+#include <cstddef>
 #include <cstdint>
 
 namespace ale {
@@ -148,6 +149,18 @@ class Sound
       */
     virtual void process(uint8_t* buffer, uint32_t samples) = 0;
 
+    /**
+      * Answers the number of bytes of memory owned by the sound device,
+      * including the object itself
+      */
+    virtual size_t memoryUsage() const = 0;
+
+    /**
+      * Answers true if the sound device ignores everything it is given, so
+      * that register writes need not be forwarded to it at all
+      */
+    virtual bool isNull() const { return false; }
+
 public:
     /**
       Loads the current state of this device from the given Deserializer.
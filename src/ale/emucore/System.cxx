@@ -17,8 +17,13 @@
 //============================================================================
 
 #include <cassert>
+#include <cstddef>
+#include <cstring>
 #include <iostream>
+#include <stdexcept>
+#include <vector>
 
+#include "ale/common/MemoryUsage.hpp"
 #include "ale/emucore/Device.hxx"
 #include "ale/emucore/M6502.hxx"
 #include "ale/emucore/TIA.hxx"
@@ -35,11 +40,12 @@ System::System(Settings& settings)
   : myNumberOfDevices(0),
     myM6502(0),
     myTIA(0),
-    myCycles(0),
-    myDataBusState(0)
+    myProcessorRunner(0)
 {
   // Seed RNG with fixed seed to enable full determinism
   int32_t emulatorSeed = settings.getInt("system_random_seed");
+  myRandom.setGenerator(
+      Random::generatorFromName(settings.getString("random_generator")));
   myRandom.seed(emulatorSeed);
 
   // Allocate page table
@@ -57,6 +63,9 @@ System::System(Settings& settings)
 
   // Bus starts out unlocked (in other words, peek() changes myDataBusState)
   myDataBusLocked = false;
+
+  // Lay out the machine state of the system and its random generator
+  layoutState();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -102,6 +111,9 @@ void System::attach(Device* device)
   // Add device to my collection of devices
   myDevices[myNumberOfDevices++] = device;
 
+  // Make room for the state block of the device
+  layoutState();
+
   // Ask the device to install itself
   device->install(*this);
 }
@@ -109,13 +121,28 @@ void System::attach(Device* device)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void System::attach(M6502* m6502)
 {
+  // The processor is laid out before the devices
+  assert(myNumberOfDevices == 0);
+
   // Remember the processor
   myM6502 = m6502;
 
+  // Make room for the state block of the processor
+  layoutState();
+
   // Ask the processor to install itself
   myM6502->install(*this);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::executeProcessor(uint32_t number)
+{
+  if(myProcessorRunner != 0)
+    myProcessorRunner->execute(*this, number);
+  else
+    myM6502->execute(number);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void System::attach(TIA* tia)
 {
@@ -124,51 +151,117 @@ void System::attach(TIA* tia)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool System::save(Serializer& out)
+size_t System::stateSize() const
 {
-  try
-  {
-    out.putString("System");
-    out.putInt(myCycles);
-    myRandom.saveState(out);
-  }
-  catch(char *msg)
-  {
-    std::cerr << msg << std::endl;
-    return false;
-  }
-  catch(...)
-  {
-    std::cerr << "Unknown error in save state for \'System\'" << std::endl;
-    return false;
-  }
+  return myStateLayout->size;
+}
 
-  return true;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::saveState(uint8_t* state) const
+{
+  std::memcpy(state, myMachineState.data(), myMachineState.size());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool System::load(Deserializer& in)
+void System::loadState(const uint8_t* state)
 {
-  try
-  {
-    if(in.getString() != "System")
-      return false;
+  for(uint32_t i = 0; i < myNumberOfDevices; ++i)
+    myDevices[i]->stateRestoring();
 
-    myCycles = (uint32_t) in.getInt();
-    myRandom.loadState(in);
-  }
-  catch(char *msg)
-  {
-    std::cerr << msg << std::endl;
-    return false;
-  }
-  catch(...)
+  std::memcpy(myMachineState.data(), state, myMachineState.size());
+
+  for(uint32_t i = 0; i < myNumberOfDevices; ++i)
+    myDevices[i]->stateRestored();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Appends a part to the layout, aligned for any of the state blocks
+static void addPart(StateLayout& layout, const char* name, size_t size,
+    StateWriter write)
+{
+  const size_t alignment = alignof(std::max_align_t);
+
+  StateLayout::Part part;
+  part.name = name;
+  part.offset = (layout.size + alignment - 1) / alignment * alignment;
+  part.size = size;
+  part.write = write;
+
+  layout.parts.push_back(part);
+  layout.size = part.offset + size;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::layoutState()
+{
+  std::shared_ptr<StateLayout> layout(new StateLayout());
+  layout->size = 0;
+
+  // The random generator writes its own name, which tells the generators
+  // apart
+  addPart(*layout, "System", sizeof(SystemState), &writeState);
+  addPart(*layout, "", myRandom.stateSize(), myRandom.stateWriter());
+
+  if(myM6502 != 0)
+    addPart(*layout, myM6502->name(), myM6502->stateSize(),
+        myM6502->stateWriter());
+
+  for(uint32_t i = 0; i < myNumberOfDevices; ++i)
+    addPart(*layout, myDevices[i]->name(), myDevices[i]->stateSize(),
+        myDevices[i]->stateWriter());
+
+  // Move every block to the new machine state
+  std::vector<uint8_t> state(layout->size);
+  const std::vector<StateLayout::Part>& parts = layout->parts;
+  size_t part = 0;
+
+  myState.bind(state.data() + parts[part++].offset);
+  myRandom.bindState(state.data() + parts[part++].offset);
+
+  if(myM6502 != 0)
+    myM6502->bindState(state.data() + parts[part++].offset);
+
+  for(uint32_t i = 0; i < myNumberOfDevices; ++i)
+    myDevices[i]->bindState(state.data() + parts[part++].offset);
+
+  // Parts are only ever appended, so the pages accessing the old machine
+  // state directly all move by the same amount
+  uint8_t* oldBegin = myMachineState.data();
+  uint8_t* oldEnd = oldBegin + myMachineState.size();
+  for(int page = 0; page < myNumberOfPages; ++page)
   {
-    std::cerr << "Unknown error in load state for \'System\'" << std::endl;
-    return false;
+    PageAccess& access = myPageAccessTable[page];
+
+    if(access.directPeekBase >= oldBegin && access.directPeekBase < oldEnd)
+      access.directPeekBase = state.data() + (access.directPeekBase - oldBegin);
+    if(access.directPokeBase >= oldBegin && access.directPokeBase < oldEnd)
+      access.directPokeBase = state.data() + (access.directPokeBase - oldBegin);
   }
 
-  return true;
+  myMachineState.swap(state);
+  myStateLayout = layout;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::writeState(const uint8_t* block, Serializer& out)
+{
+  const SystemState* state = reinterpret_cast<const SystemState*>(block);
+
+  out.putInt(state->myCycles);
+  out.putInt(state->myDataBusState);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::memoryUsage(MemoryUsage& usage) const
+{
+  usage.add("System", sizeof(*this) + myNumberOfPages * sizeof(PageAccess) +
+      myMachineState.capacity());
+
+  if(myM6502 != 0)
+    usage.add(myM6502->name(), myM6502->memoryUsage());
+
+  for(uint32_t i = 0; i < myNumberOfDevices; ++i)
+    usage.add(myDevices[i]->name(), myDevices[i]->memoryUsage());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -181,7 +274,7 @@ void System::resetCycles()
   }
 
   // Now, we reset cycle count to zero
-  myCycles = 0;
+  myState->myCycles = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -205,6 +298,15 @@ const System::PageAccess& System::getPageAccess(uint16_t page)
   return myPageAccessTable[page];
 }
 
+// Tag and versions of the state format, written after the md5sum.  States
+// of older versions of ALE go on with the tag of the System device instead,
+// and are read as version 0.  The raw version holds the machine state as
+// one block, which only the process that saved it can read; the portable
+// version writes it field by field with fixed widths.
+static const char* const ourStateTag = "ALEState";
+static const int ourRawStateVersion = 1;
+static const int ourPortableStateVersion = 2;
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool System::saveState(const std::string& md5sum, Serializer& out)
 {
@@ -218,18 +320,20 @@ bool System::saveState(const std::string& md5sum, Serializer& out)
     // This is the first defensive check for an invalid state file
     out.putString(md5sum);
 
-    // First save state for this system
-    if(!save(out))
-      return false;
+    // Then the format of what follows
+    out.putString(ourStateTag);
+    out.putInt(ourRawStateVersion);
 
-    // Next, save state for the CPU
-    if(!myM6502->save(out))
-      return false;
+    // Then the machine state as a single block
+    out.putBytes(myMachineState.data(), (uint32_t) myMachineState.size());
 
-    // Now save the state of each device
+    // Now save the state each device keeps outside of its block, kept
+    // apart so that the block can be rewritten without reading it
+    Serializer extras;
     for(uint32_t i = 0; i < myNumberOfDevices; ++i)
-      if(!myDevices[i]->save(out))
+      if(!myDevices[i]->save(extras))
         return false;
+    out.putString(extras.get_str());
   }
   catch(char *msg)
   {
@@ -252,38 +356,147 @@ bool System::loadState(const std::string& md5sum, Deserializer& in)
   if(!in.isOpen())
     return false;
 
+  // Look at the beginning of the state file.  It should contain the md5sum
+  // of the current cartridge.  If it doesn't, this state file is invalid.
+  int version;
   try
   {
-    // Look at the beginning of the state file.  It should contain the md5sum
-    // of the current cartridge.  If it doesn't, this state file is invalid.
     if(in.getString() != md5sum)
       return false;
 
-    // First load state for this system
-    if(!load(in))
+    std::string tag = in.getString();
+    if(tag == ourStateTag)
+      version = in.getInt();
+    else if(tag == "System")
+      version = 0;
+    else
       return false;
+  }
+  catch(...)
+  {
+    return false;
+  }
 
-    // Next, load state for the CPU
-    if(!myM6502->load(in))
-      return false;
+  if(version != 0 && version != ourRawStateVersion &&
+     version != ourPortableStateVersion)
+    throw std::runtime_error("The state is in format version " +
+                             std::to_string(version) + ", which this " +
+                             "version of ALE cannot load");
 
-    // Now load the state of each device
-    for(uint32_t i = 0; i < myNumberOfDevices; ++i)
-      if(!myDevices[i]->load(in))
-        return false;
+  for(uint32_t i = 0; i < myNumberOfDevices; ++i)
+    myDevices[i]->stateRestoring();
+
+  bool loaded = false;
+  try
+  {
+    loaded = version == ourRawStateVersion ? loadRawState(in) :
+        loadPortableState(in, version);
   }
   catch(char *msg)
   {
     std::cerr << msg << std::endl;
-    return false;
+  }
+  catch(const std::runtime_error&)
+  {
+    for(uint32_t i = 0; i < myNumberOfDevices; ++i)
+      myDevices[i]->stateRestored();
+    throw;
   }
   catch(...)
   {
     std::cerr << "Unknown error in load state for \'System\'" << std::endl;
+  }
+
+  for(uint32_t i = 0; i < myNumberOfDevices; ++i)
+    myDevices[i]->stateRestored();
+
+  return loaded;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool System::loadRawState(Deserializer& in)
+{
+  // The machine state, which must have been saved by this process
+  in.getBytes(myMachineState.data(), (uint32_t) myMachineState.size());
+
+  // Now load the state each device keeps outside of its block
+  Deserializer extras(in.getString());
+  for(uint32_t i = 0; i < myNumberOfDevices; ++i)
+    if(!myDevices[i]->load(extras))
+      return false;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool System::loadPortableState(Deserializer& in, int version)
+{
+  // First load state for this system, whose tag was read already by
+  // versions which did not have the format tag
+  if(version != 0 && in.getString() != "System")
+    return false;
+
+  myState->myCycles = (uint32_t) in.getInt();
+  if(version != 0)
+    myState->myDataBusState = (uint8_t) in.getInt();
+
+  if(!myRandom.loadState(in, version))
     return false;
+
+  // Next, load state for the CPU
+  if(myM6502 != 0)
+    if(in.getString() != myM6502->name() || !myM6502->loadState(in, version))
+      return false;
+
+  // Now load the state of each device
+  for(uint32_t i = 0; i < myNumberOfDevices; ++i)
+    if(in.getString() != myDevices[i]->name() ||
+       !myDevices[i]->loadState(in, version))
+      return false;
+
+  // Versions which did not have the format tag load what the devices keep
+  // outside of their blocks along with the blocks
+  if(version == 0)
+    return true;
+
+  Deserializer extras(in.getString());
+  for(uint32_t i = 0; i < myNumberOfDevices; ++i)
+    if(!myDevices[i]->load(extras))
+      return false;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::string System::portableState(const std::string& state,
+                                  const StateLayout& layout)
+{
+  // States which are not raw are portable already
+  Deserializer in(state);
+  std::string md5sum = in.getString();
+  if(in.getString() != ourStateTag || in.getInt() != ourRawStateVersion)
+    return state;
+
+  std::vector<uint8_t> machine(layout.size);
+  in.getBytes(machine.data(), (uint32_t) machine.size());
+  std::string extras = in.getString();
+
+  Serializer out;
+  out.putString(md5sum);
+  out.putString(ourStateTag);
+  out.putInt(ourPortableStateVersion);
+
+  for(const StateLayout::Part& part : layout.parts)
+  {
+    if(!part.name.empty())
+      out.putString(part.name);
+    if(part.write != 0)
+      part.write(machine.data() + part.offset, out);
   }
 
-  return true;  // success
+  out.putString(extras);
+
+  return out.get_str() + state.substr(in.position());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
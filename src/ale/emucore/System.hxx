@@ -26,22 +26,87 @@ class Device;
 class M6502;
 class TIA;
 class NullDevice;
+class System;
 class Serializer;
 class Deserializer;
 class Settings;
 
 }  // namespace stella
+
+class MemoryUsage;
+
 }  // namespace ale
 
 #include "ale/emucore/Device.hxx"
 #include "ale/emucore/NullDev.hxx"
 #include "ale/emucore/Random.hxx"
 
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace ale {
 namespace stella {
 
+/**
+  The cycle counter and data bus of the system, kept in a block at the
+  start of the machine state.
+*/
+struct SystemState
+{
+  // Number of system cycles executed since the last reset
+  uint32_t myCycles;
+
+  // The current state of the Data Bus
+  uint8_t myDataBusState;
+};
+
+/**
+  Where each part of the machine state lives, and how it is written field
+  by field to a saved state in the portable format.  A raw copy of the
+  machine state can only be read back with the layout it was made with.
+*/
+struct StateLayout
+{
+  struct Part
+  {
+    // The name written before the part, or empty if the part has none
+    std::string name;
+
+    // The bytes of the machine state holding the part
+    size_t offset;
+    size_t size;
+
+    // Writes the part, or the null pointer if the part has no state
+    StateWriter write;
+  };
+
+  // The parts in the order they are laid out and written
+  std::vector<Part> parts;
+
+  // The size of the machine state
+  size_t size;
+};
+
+/**
+  Runs the processor of a system on its behalf, for instance together with
+  the processors of other systems.
+*/
+class ProcessorRunner
+{
+  public:
+    virtual ~ProcessorRunner() { }
+
+    /**
+      Executes at most the given number of instructions on the processor
+      of the system, with the same effect as its execute(number).
+
+      @param system The system whose processor runs
+      @param number The number of instructions to execute
+    */
+    virtual void execute(System& system, uint32_t number) = 0;
+};
+
 /**
   This class represents a system consisting of a 6502 microprocessor
   and a set of devices.  The devices are mapped into an addressing
@@ -63,6 +128,8 @@ namespace stella {
 */
 class System
 {
+  friend class M6502Lockstep;
+
   public:
     /**
       Create a new system with an addressing space of 2^13 bytes and
@@ -83,20 +150,47 @@ class System
     void reset();
 
     /**
-      Saves the current state of this system class to the given Serializer.
+      Answers the number of bytes of the machine state: the state blocks
+      of this system, its random generator, its processor and each of its
+      attached devices, one after the other.
 
-      @param out The serializer device to save to.
-      @return The result of the save.  True on success, false on failure.
+      @return The size of the machine state
     */
-    bool save(Serializer& out);
+    size_t stateSize() const;
 
     /**
-      Loads the current state of this system class from the given Deserializer.
+      Answers the layout of the machine state.  It is replaced, not
+      changed, when a device is attached.
 
-      @param in The deserializer device to load from.
-      @return The result of the load.  True on success, false on failure.
+      @return The layout of the machine state
     */
-    bool load(Deserializer& in);
+    std::shared_ptr<const StateLayout> stateLayout() const
+    {
+      return myStateLayout;
+    }
+
+    /**
+      Copies the machine state into the given block of stateSize() bytes.
+      The copy is only meant to be restored by this system.
+
+      @param state The block to copy to
+    */
+    void saveState(uint8_t* state) const;
+
+    /**
+      Restores the machine state from the given block of stateSize() bytes.
+
+      @param state The block to copy from
+    */
+    void loadState(const uint8_t* state);
+
+    /**
+      Adds the memory held by this system, its processor and each of its
+      attached devices to the given accounting, one entry per object.
+
+      @param usage The accounting to add to
+    */
+    void memoryUsage(MemoryUsage& usage) const;
 
   public:
     /**
@@ -124,8 +218,11 @@ class System
     void attach(TIA* tia);
 
     /**
-      Saves the current state of Stella to the given file.  Calls
-      save on every device and CPU attached to this system.
+      Saves the current state of Stella to the given file.  The machine
+      state is written as one raw block, after the version of the state
+      format and followed by whatever each device keeps outside of its
+      state block.  Such a state can only be loaded by this process; see
+      portableState() for one that can be kept.
 
       @param md5sum   MD5 of the current ROM
       @param out      The serializer device to save to
@@ -135,16 +232,31 @@ class System
     bool saveState(const std::string& md5sum, Serializer& out);
 
     /**
-      Loads the current state of Stella from the given file.  Calls
-      load on every device and CPU attached to this system.
+      Loads the current state of Stella from the given file, as written
+      by saveState(), converted by portableState() or saved by older
+      versions of ALE.  Throws std::runtime_error for a state saved in an
+      unknown version of the format.
 
       @param md5sum   MD5 of the current ROM
       @param in       The deserializer device to load from
 
-      @return  False on any errors, else true
+      @return  False on any other errors, else true
     */
     bool loadState(const std::string& md5sum, Deserializer& in);
 
+    /**
+      Converts a state written by saveState() to the portable format, in
+      which the machine state is written field by field with fixed widths.
+      Whatever follows the state of Stella is copied as it is.
+
+      @param state    The state, which may already be portable
+      @param layout   The layout of the machine state it was saved with
+
+      @return  The portable state
+    */
+    static std::string portableState(const std::string& state,
+                                     const StateLayout& layout);
+
   public:
     /**
       Answer the 6502 microprocessor attached to the system.  If a
@@ -188,6 +300,25 @@ class System
       return myNullDevice;
     }
 
+    /**
+      Execute at most the given number of instructions on the attached
+      processor, through the processor runner if one is set.
+
+      @param number The number of instructions to execute
+    */
+    void executeProcessor(uint32_t number);
+
+    /**
+      Set the runner which executes the processor on behalf of this system,
+      or the null pointer to execute it directly.  The runner is not owned.
+
+      @param runner The processor runner
+    */
+    void setProcessorRunner(ProcessorRunner* runner)
+    {
+      myProcessorRunner = runner;
+    }
+
     /**
       Get the total number of pages available in the system.
 
@@ -227,7 +358,7 @@ class System
     */
     uint32_t cycles() const
     {
-      return myCycles;
+      return myState->myCycles;
     }
 
     /**
@@ -237,7 +368,7 @@ class System
     */
     void incrementCycles(uint32_t amount)
     {
-      myCycles += amount;
+      myState->myCycles += amount;
     }
 
     /**
@@ -280,7 +411,7 @@ class System
         result = access.device->peek(addr);
       }
 
-      myDataBusState = result;
+      myState->myDataBusState = result;
 
       return result;
     }
@@ -307,7 +438,71 @@ class System
         access.device->poke(addr, value);
       }
 
-      myDataBusState = value;
+      myState->myDataBusState = value;
+    }
+
+    /**
+      Get the byte at the specified address, handing pages without
+      direct access to the given dispatcher instead of the virtual
+      Device::peek.  The dispatcher must provide
+
+        uint8_t devicePeek(Device* device, uint16_t addr)
+
+      which lets a caller that knows the concrete device classes (see
+      M6502LowFast) resolve the common cases at compile time.
+
+      @param addr The address to read
+      @param dispatch The device dispatcher
+      @return The byte at the specified address
+    */
+    template<class Dispatch>
+    inline uint8_t peek(uint16_t addr, Dispatch& dispatch)
+    {
+      PageAccess& access = myPageAccessTable[(addr & myAddressMask) >> myPageSize];
+
+      uint8_t result;
+
+      if(access.directPeekBase != 0)
+      {
+        result = *(access.directPeekBase + (addr & myPageMask));
+      }
+      else
+      {
+        result = dispatch.devicePeek(access.device, addr);
+      }
+
+      myState->myDataBusState = result;
+
+      return result;
+    }
+
+    /**
+      Change the byte at the specified address, handing pages without
+      direct access to the given dispatcher instead of the virtual
+      Device::poke.  The dispatcher must provide
+
+        void devicePoke(Device* device, uint16_t addr, uint8_t value)
+
+      @param addr The address where the value should be stored
+      @param value The value to be stored at the address
+      @param dispatch The device dispatcher
+    */
+    template<class Dispatch>
+    inline void poke(uint16_t addr, uint8_t value, Dispatch& dispatch)
+    {
+      PageAccess& access = myPageAccessTable[
+          (addr & myAddressMask) >> myPageSize];
+
+      if(access.directPokeBase != 0)
+      {
+        *(access.directPokeBase + (addr & myPageMask)) = value;
+      }
+      else
+      {
+        dispatch.devicePoke(access.device, addr, value);
+      }
+
+      myState->myDataBusState = value;
     }
 
     /**
@@ -398,24 +593,44 @@ class System
     // TIA device attached to the system or the null pointer
     TIA* myTIA;
 
+    // Runner of the processor or the null pointer
+    ProcessorRunner* myProcessorRunner;
+
     // Many devices need a source of random numbers, usually for emulating
     // unknown/undefined behaviour
     Random myRandom;
 
-    // Number of system cycles executed since the last reset
-    uint32_t myCycles;
-
     // Null device to use for page which are not installed
     NullDevice myNullDevice;
 
-    // The current state of the Data Bus
-    uint8_t myDataBusState;
-
     // Whether or not peek() updates the data bus state. This
     // is true during normal emulation, and false when the
     // debugger is active.
     bool myDataBusLocked;
 
+    // The cycle counter and data bus
+    StateView<SystemState> myState;
+
+    // The machine state: the blocks of this system, its random generator,
+    // its processor and its devices, where their state views point
+    std::vector<uint8_t> myMachineState;
+
+    // Where each part of the machine state lives
+    std::shared_ptr<const StateLayout> myStateLayout;
+
+  private:
+    // Lays the machine state out again for the attached devices, and moves
+    // the blocks there
+    void layoutState();
+
+    // Writes the block of this system field by field
+    static void writeState(const uint8_t* block, Serializer& out);
+
+    // Load the rest of a state in the raw or the portable format, after
+    // its version
+    bool loadRawState(Deserializer& in);
+    bool loadPortableState(Deserializer& in, int version);
+
   private:
     // Copy constructor isn't supported by this class so make it private
     System(const System&);
@@ -427,7 +642,7 @@ class System
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline uint8_t System::getDataBusState() const
 {
-  return myDataBusState;
+  return myState->myDataBusState;
 }
 
 }  // namespace stella
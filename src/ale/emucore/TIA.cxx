@@ -18,9 +18,10 @@
 
 #include <string>
 #include <iostream>
-#include <mutex>
 #include <cassert>
 #include <cstring>
+#include <stdexcept>
+#include <utility>
 
 #include "ale/emucore/Console.hxx"
 #include "ale/emucore/Control.hxx"
@@ -31,11 +32,10 @@
 #include "ale/emucore/Deserializer.hxx"
 #include "ale/emucore/Settings.hxx"
 #include "ale/emucore/Sound.hxx"
+#include "ale/common/ScreenHash.hpp"
 
 #define HBLANK 68
 
-static std::once_flag tia_init_once;
-
 namespace ale {
 namespace stella {
 
@@ -44,18 +44,15 @@ TIA::TIA(const Console& console, Settings& settings)
     : myConsole(console),
       mySettings(settings),
       mySound(NULL),
+      mySoundEnabled(false),
       myColorLossEnabled(false),
-      myMaximumNumberOfScanlines(262),
-      myCOLUBK(myColor[0]),
-      myCOLUPF(myColor[1]),
-      myCOLUP0(myColor[2]),
-      myCOLUP1(myColor[3])
+      myMaximumNumberOfScanlines(262)
 {
   uint32_t i;
 
-  // Allocate buffers for two frame buffers
-  myCurrentFrameBuffer = new uint8_t[160 * 300];
-  myPreviousFrameBuffer = new uint8_t[160 * 300];
+  myCurrentRowHashes = &myRowHashes[0];
+  myPreviousRowHashes = &myRowHashes[1];
+  invalidateRowHashes();
 
   myFrameGreyed = false;
   myPartialFrameFlag = false; //ALE : This was left uninitialized :(
@@ -63,67 +60,51 @@ TIA::TIA(const Console& console, Settings& settings)
   for(i = 0; i < 6; ++i)
     myBitEnabled[i] = true;
 
-  for(uint16_t x = 0; x < 2; ++x)
-  {
-    for(uint16_t enabled = 0; enabled < 256; ++enabled)
-    {
-      if(enabled & PriorityBit)
-      {
-        uint8_t color = 0;
-
-        if((enabled & (myP1Bit | myM1Bit)) != 0)
-          color = 3;
-        if((enabled & (myP0Bit | myM0Bit)) != 0)
-          color = 2;
-        if((enabled & myBLBit) != 0)
-          color = 1;
-        if((enabled & myPFBit) != 0)
-          color = 1;  // NOTE: Playfield has priority so ScoreBit isn't used
-
-        myPriorityEncoder[x][enabled] = color;
-      }
-      else
-      {
-        uint8_t color = 0;
+  // Init stats counters
+  myFrameCounter = 0;
 
-        if((enabled & myBLBit) != 0)
-          color = 1;
-        if((enabled & myPFBit) != 0)
-          color = (enabled & ScoreBit) ? ((x == 0) ? 2 : 3) : 1;
-        if((enabled & (myP1Bit | myM1Bit)) != 0)
-          color = (color != 2) ? 3 : 2;
-        if((enabled & (myP0Bit | myM0Bit)) != 0)
-          color = 2;
+  myAUDV0 = myAUDV1 = myAUDF0 = myAUDF1 = myAUDC0 = myAUDC1 = 0;
 
-        myPriorityEncoder[x][enabled] = color;
-      }
-    }
-  }
+  // Nothing reads the frame buffer unless the screen is being observed
+  fastUpdate = settings.getBool("fast_tia_update", false) ||
+               settings.getString("observation_mode") != "screen";
 
-  std::call_once(tia_init_once, []() {
-    // Compute all of the mask tables
-    computeBallMaskTable();
-    computeCollisionTable();
-    computeMissleMaskTable();
-    computePlayerMaskTable();
-    computePlayerPositionResetWhenTable();
-    computePlayerReflectTable();
-    computePlayfieldMaskTable();
-  });
+  myScanlineKernel = selectScanlineKernel(settings.getBool("tia_simd", true));
 
-  // Init stats counters
-  myFrameCounter = 0;
+  const std::string& lines = settings.getString("tia_render_lines");
+  if(lines != "all" && lines != "even")
+    throw std::runtime_error("Unknown tia_render_lines '" + lines +
+                             "' (expected all or even)");
+  myEvenLinesOnly = lines == "even";
 
-  myAUDV0 = myAUDV1 = myAUDF0 = myAUDF1 = myAUDC0 = myAUDC1 = 0;
+  // Deferred rendering runs the live emulation with pixel output off
+  myDeferredRendering = settings.getBool("deferred_tia_render", false) &&
+                        !fastUpdate;
+  fastUpdate = fastUpdate || myDeferredRendering;
 
-  fastUpdate = settings.getBool("fast_tia_update", false);
+  // Allocate buffers for two frame buffers.  If frames are never drawn the
+  // blanking writes of both can go to one, until setFastUpdate(false).
+  myCurrentFrameBuffer = new uint8_t[160 * 300];
+  myPreviousFrameBuffer = fastUpdate && !myDeferredRendering ?
+      myCurrentFrameBuffer : new uint8_t[160 * 300];
+  myReplaying = false;
+  myReplayCycles = 0;
+  markAllRowsDirty();
+  for(i = 0; i < 3; ++i)
+  {
+    myFrameLogs[i].endClock = 0;
+    myFrameLogs[i].pending = false;
+    if(myDeferredRendering)
+      myFrameLogs[i].pokes.reserve(1024);
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TIA::~TIA()
 {
+  if(myPreviousFrameBuffer != myCurrentFrameBuffer)
+    delete[] myPreviousFrameBuffer;
   delete[] myCurrentFrameBuffer;
-  delete[] myPreviousFrameBuffer;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -132,6 +113,17 @@ const char* TIA::name() const
   return "TIA";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t TIA::memoryUsage() const
+{
+  size_t bytes = sizeof(*this) + 160 * 300;
+  if(myPreviousFrameBuffer != myCurrentFrameBuffer)
+    bytes += 160 * 300;
+  for(int i = 0; i < 3; ++i)
+    bytes += myFrameLogs[i].pokes.capacity() * sizeof(PokeRecord);
+  return bytes;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::reset()
 {
@@ -139,66 +131,66 @@ void TIA::reset()
   mySound->reset();
 
   // Currently no objects are enabled
-  myEnabledObjects = 0;
+  myState->myEnabledObjects = 0;
 
   // Some default values for the registers
-  myVSYNC = 0;
-  myVBLANK = 0;
-  myNUSIZ0 = 0;
-  myNUSIZ1 = 0;
-  myCOLUP0 = 0;
-  myCOLUP1 = 0;
-  myCOLUPF = 0;
-  myPlayfieldPriorityAndScore = 0;
-  myCOLUBK = 0;
-  myCTRLPF = 0;
-  myREFP0 = false;
-  myREFP1 = false;
-  myPF = 0;
-  myGRP0 = 0;
-  myGRP1 = 0;
-  myDGRP0 = 0;
-  myDGRP1 = 0;
-  myENAM0 = false;
-  myENAM1 = false;
-  myENABL = false;
-  myDENABL = false;
-  myHMP0 = 0;
-  myHMP1 = 0;
-  myHMM0 = 0;
-  myHMM1 = 0;
-  myHMBL = 0;
-  myVDELP0 = false;
-  myVDELP1 = false;
-  myVDELBL = false;
-  myRESMP0 = false;
-  myRESMP1 = false;
-  myCollision = 0;
-  myPOSP0 = 0;
-  myPOSP1 = 0;
-  myPOSM0 = 0;
-  myPOSM1 = 0;
-  myPOSBL = 0;
+  myState->myVSYNC = 0;
+  myState->myVBLANK = 0;
+  myState->myNUSIZ0 = 0;
+  myState->myNUSIZ1 = 0;
+  myState->myColor[COLUP0] = 0;
+  myState->myColor[COLUP1] = 0;
+  myState->myColor[COLUPF] = 0;
+  myState->myPlayfieldPriorityAndScore = 0;
+  myState->myColor[COLUBK] = 0;
+  myState->myCTRLPF = 0;
+  myState->myREFP0 = false;
+  myState->myREFP1 = false;
+  myState->myPF = 0;
+  myState->myGRP0 = 0;
+  myState->myGRP1 = 0;
+  myState->myDGRP0 = 0;
+  myState->myDGRP1 = 0;
+  myState->myENAM0 = false;
+  myState->myENAM1 = false;
+  myState->myENABL = false;
+  myState->myDENABL = false;
+  myState->myHMP0 = 0;
+  myState->myHMP1 = 0;
+  myState->myHMM0 = 0;
+  myState->myHMM1 = 0;
+  myState->myHMBL = 0;
+  myState->myVDELP0 = false;
+  myState->myVDELP1 = false;
+  myState->myVDELBL = false;
+  myState->myRESMP0 = false;
+  myState->myRESMP1 = false;
+  myState->myCollision = 0;
+  myState->myPOSP0 = 0;
+  myState->myPOSP1 = 0;
+  myState->myPOSM0 = 0;
+  myState->myPOSM1 = 0;
+  myState->myPOSBL = 0;
 
   // Some default values for the "current" variables
-  myCurrentGRP0 = 0;
-  myCurrentGRP1 = 0;
-  myCurrentBLMask = ourBallMaskTable[0][0];
-  myCurrentM0Mask = ourMissleMaskTable[0][0][0];
-  myCurrentM1Mask = ourMissleMaskTable[0][0][0];
-  myCurrentP0Mask = ourPlayerMaskTable[0][0][0];
-  myCurrentP1Mask = ourPlayerMaskTable[0][0][0];
-  myCurrentPFMask = ourPlayfieldTable[0];
-
-  myLastHMOVEClock = 0;
-  myHMOVEBlankEnabled = false;
-  myM0CosmicArkMotionEnabled = false;
-  myM0CosmicArkCounter = 0;
+  myState->myCurrentGRP0 = 0;
+  myState->myCurrentGRP1 = 0;
+  myState->myCurrentBLMask = ourBallMaskTable[0][0];
+  myState->myCurrentM0Mask = ourMissleMaskTable[0][0][0];
+  myState->myCurrentM1Mask = ourMissleMaskTable[0][0][0];
+  myState->myCurrentP0Mask = ourPlayerMaskTable[0][0][0];
+  myState->myCurrentP1Mask = ourPlayerMaskTable[0][0][0];
+  myState->myCurrentPFMask = ourPlayfieldTable[0];
+
+  myState->myLastHMOVEClock = 0;
+  myState->myHMOVEBlankEnabled = false;
+  myState->myM0CosmicArkMotionEnabled = false;
+  myState->myM0CosmicArkCounter = 0;
 
   enableBits(true);
 
-  myDumpEnabled = false;
-  myDumpDisabledCycle = 0;
+  myState->myDumpEnabled = false;
+  myState->myDumpDisabledCycle = 0;
 
   myAllowHMOVEBlanks =
       (myConsole.properties().get(Emulation_HmoveBlanks) == "YES");
@@ -223,6 +215,11 @@ void TIA::frameReset()
 {
   // Clear frame buffers
   clearBuffers();
+  myFrameLogs[0].pending = myFrameLogs[1].pending =
+      myFrameLogs[2].pending = false;
+  if(myDeferredRendering)
+    startFrameLog();
+  markAllRowsDirty();
 
   // Reset pixel pointer and drawing flag
   myFramePointer = myCurrentFrameBuffer;
@@ -235,14 +232,14 @@ void TIA::frameReset()
   myStopDisplayOffset = myStartDisplayOffset + 228 * myHeight;
 
   // Reasonable values to start and stop the current frame drawing
-  myClockWhenFrameStarted = mySystem->cycles() * 3;
-  myClockStartDisplay = myClockWhenFrameStarted + myStartDisplayOffset;
-  myClockStopDisplay = myClockWhenFrameStarted + myStopDisplayOffset;
-  myClockAtLastUpdate = myClockWhenFrameStarted;
-  myClocksToEndOfScanLine = 228;
-  myVSYNCFinishClock = 0x7FFFFFFF;
-  myScanlineCountForLastFrame = 0;
-  myCurrentScanline = 0;
+  myState->myClockWhenFrameStarted = mySystem->cycles() * 3;
+  myState->myClockStartDisplay = myState->myClockWhenFrameStarted + myStartDisplayOffset;
+  myState->myClockStopDisplay = myState->myClockWhenFrameStarted + myStopDisplayOffset;
+  myState->myClockAtLastUpdate = myState->myClockWhenFrameStarted;
+  myState->myClocksToEndOfScanLine = 228;
+  myState->myVSYNCFinishClock = 0x7FFFFFFF;
+  myState->myScanlineCountForLastFrame = 0;
+  myState->myCurrentScanline = 0;
 
   myFrameXStart = 0;    // Hardcoded in preparation for new TIA class
   myFrameWidth  = 160;  // Hardcoded in preparation for new TIA class
@@ -268,18 +265,18 @@ void TIA::systemCyclesReset()
   mySound->adjustCycleCounter(-1 * cycles);
 
   // Adjust the dump cycle
-  myDumpDisabledCycle -= cycles;
+  myState->myDumpDisabledCycle -= cycles;
 
   // Get the current color clock the system is using
   uint32_t clocks = cycles * 3;
 
   // Adjust the clocks by this amount since we're reseting the clock to zero
-  myClockWhenFrameStarted -= clocks;
-  myClockStartDisplay -= clocks;
-  myClockStopDisplay -= clocks;
-  myClockAtLastUpdate -= clocks;
-  myVSYNCFinishClock -= clocks;
-  myLastHMOVEClock -= clocks;
+  myState->myClockWhenFrameStarted -= clocks;
+  myState->myClockStartDisplay -= clocks;
+  myState->myClockStopDisplay -= clocks;
+  myState->myClockAtLastUpdate -= clocks;
+  myState->myVSYNCFinishClock -= clocks;
+  myState->myLastHMOVEClock -= clocks;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -309,84 +306,201 @@ void TIA::install(System& system)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool TIA::save(Serializer& out)
+size_t TIA::stateSize() const
 {
-  std::string device = name();
+  return sizeof(TIAState);
+}
 
-  try
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::bindState(uint8_t* state)
+{
+  myState.bind(state);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateWriter TIA::stateWriter() const
+{
+  return &writeState;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::writeState(const uint8_t* block, Serializer& out)
+{
+  const TIAState* state = reinterpret_cast<const TIAState*>(block);
+
+  out.putInt(state->myClockWhenFrameStarted);
+  out.putInt(state->myClockStartDisplay);
+  out.putInt(state->myClockStopDisplay);
+  out.putInt(state->myClockAtLastUpdate);
+  out.putInt(state->myClocksToEndOfScanLine);
+  out.putInt(state->myScanlineCountForLastFrame);
+  out.putInt(state->myCurrentScanline);
+  out.putInt(state->myVSYNCFinishClock);
+  out.putInt(state->myEnabledObjects);
+  out.putInt(state->myVSYNC);
+  out.putInt(state->myVBLANK);
+  out.putInt(state->myNUSIZ0);
+  out.putInt(state->myNUSIZ1);
+  out.putInt(state->myColor[COLUP0]);
+  out.putInt(state->myColor[COLUP1]);
+  out.putInt(state->myColor[COLUPF]);
+  out.putInt(state->myColor[COLUBK]);
+  out.putInt(state->myCTRLPF);
+  out.putInt(state->myPlayfieldPriorityAndScore);
+  out.putBool(state->myREFP0);
+  out.putBool(state->myREFP1);
+  out.putInt(state->myPF);
+  out.putInt(state->myGRP0);
+  out.putInt(state->myGRP1);
+  out.putInt(state->myDGRP0);
+  out.putInt(state->myDGRP1);
+  out.putBool(state->myENAM0);
+  out.putBool(state->myENAM1);
+  out.putBool(state->myENABL);
+  out.putBool(state->myDENABL);
+  out.putInt(state->myHMP0);
+  out.putInt(state->myHMP1);
+  out.putInt(state->myHMM0);
+  out.putInt(state->myHMM1);
+  out.putInt(state->myHMBL);
+  out.putBool(state->myVDELP0);
+  out.putBool(state->myVDELP1);
+  out.putBool(state->myVDELBL);
+  out.putBool(state->myRESMP0);
+  out.putBool(state->myRESMP1);
+  out.putInt(state->myCollision);
+  out.putInt(state->myPOSP0);
+  out.putInt(state->myPOSP1);
+  out.putInt(state->myPOSM0);
+  out.putInt(state->myPOSM1);
+  out.putInt(state->myPOSBL);
+  out.putInt(state->myCurrentGRP0);
+  out.putInt(state->myCurrentGRP1);
+  out.putInt(state->myLastHMOVEClock);
+  out.putBool(state->myHMOVEBlankEnabled);
+  out.putBool(state->myM0CosmicArkMotionEnabled);
+  out.putInt(state->myM0CosmicArkCounter);
+  out.putBool(state->myDumpEnabled);
+  out.putInt(state->myDumpDisabledCycle);
+
+  // The mask pointers, as offsets from the start of the tables
+  const uint8_t* tables = reinterpret_cast<const uint8_t*>(&ourTables);
+  out.putInt(state->myCurrentBLMask - tables);
+  out.putInt(state->myCurrentM0Mask - tables);
+  out.putInt(state->myCurrentM1Mask - tables);
+  out.putInt(state->myCurrentP0Mask - tables);
+  out.putInt(state->myCurrentP1Mask - tables);
+  out.putInt(reinterpret_cast<const uint8_t*>(state->myCurrentPFMask) - tables);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIA::loadState(Deserializer& in, int version)
+{
+  myState->myClockWhenFrameStarted = (int) in.getInt();
+  myState->myClockStartDisplay = (int) in.getInt();
+  myState->myClockStopDisplay = (int) in.getInt();
+  myState->myClockAtLastUpdate = (int) in.getInt();
+  myState->myClocksToEndOfScanLine = (int) in.getInt();
+  myState->myScanlineCountForLastFrame = (int) in.getInt();
+  myState->myCurrentScanline = (int) in.getInt();
+  myState->myVSYNCFinishClock = (int) in.getInt();
+  myState->myEnabledObjects = (uint8_t) in.getInt();
+  myState->myVSYNC = (uint8_t) in.getInt();
+  myState->myVBLANK = (uint8_t) in.getInt();
+  myState->myNUSIZ0 = (uint8_t) in.getInt();
+  myState->myNUSIZ1 = (uint8_t) in.getInt();
+  myState->myColor[COLUP0] = (uint32_t) in.getInt();
+  myState->myColor[COLUP1] = (uint32_t) in.getInt();
+  myState->myColor[COLUPF] = (uint32_t) in.getInt();
+  myState->myColor[COLUBK] = (uint32_t) in.getInt();
+  myState->myCTRLPF = (uint8_t) in.getInt();
+  myState->myPlayfieldPriorityAndScore = (uint8_t) in.getInt();
+  myState->myREFP0 = in.getBool();
+  myState->myREFP1 = in.getBool();
+  myState->myPF = (uint32_t) in.getInt();
+  myState->myGRP0 = (uint8_t) in.getInt();
+  myState->myGRP1 = (uint8_t) in.getInt();
+  myState->myDGRP0 = (uint8_t) in.getInt();
+  myState->myDGRP1 = (uint8_t) in.getInt();
+  myState->myENAM0 = in.getBool();
+  myState->myENAM1 = in.getBool();
+  myState->myENABL = in.getBool();
+  myState->myDENABL = in.getBool();
+  myState->myHMP0 = (int8_t) in.getInt();
+  myState->myHMP1 = (int8_t) in.getInt();
+  myState->myHMM0 = (int8_t) in.getInt();
+  myState->myHMM1 = (int8_t) in.getInt();
+  myState->myHMBL = (int8_t) in.getInt();
+  myState->myVDELP0 = in.getBool();
+  myState->myVDELP1 = in.getBool();
+  myState->myVDELBL = in.getBool();
+  myState->myRESMP0 = in.getBool();
+  myState->myRESMP1 = in.getBool();
+  myState->myCollision = (uint16_t) in.getInt();
+  myState->myPOSP0 = (int16_t) in.getInt();
+  myState->myPOSP1 = (int16_t) in.getInt();
+  myState->myPOSM0 = (int16_t) in.getInt();
+  myState->myPOSM1 = (int16_t) in.getInt();
+  myState->myPOSBL = (int16_t) in.getInt();
+  myState->myCurrentGRP0 = (uint8_t) in.getInt();
+  myState->myCurrentGRP1 = (uint8_t) in.getInt();
+  myState->myLastHMOVEClock = (int) in.getInt();
+  myState->myHMOVEBlankEnabled = in.getBool();
+  myState->myM0CosmicArkMotionEnabled = in.getBool();
+  myState->myM0CosmicArkCounter = (uint32_t) in.getInt();
+  myState->myDumpEnabled = in.getBool();
+  myState->myDumpDisabledCycle = (int) in.getInt();
+
+  // States of older versions of ALE leave the mask pointers alone, and go
+  // on with the sound
+  if(version == 0)
+    return mySound->load(in);
+
+  const uint8_t* tables = reinterpret_cast<const uint8_t*>(&ourTables);
+  const uint8_t* masks[6];
+  for(int i = 0; i < 6; ++i)
   {
-    out.putString(device);
-
-    out.putInt(myClockWhenFrameStarted);
-    out.putInt(myClockStartDisplay);
-    out.putInt(myClockStopDisplay);
-    out.putInt(myClockAtLastUpdate);
-    out.putInt(myClocksToEndOfScanLine);
-    out.putInt(myScanlineCountForLastFrame);
-    out.putInt(myCurrentScanline);
-    out.putInt(myVSYNCFinishClock);
-
-    out.putInt(myEnabledObjects);
-
-    out.putInt(myVSYNC);
-    out.putInt(myVBLANK);
-    out.putInt(myNUSIZ0);
-    out.putInt(myNUSIZ1);
-
-    out.putInt(myCOLUP0);
-    out.putInt(myCOLUP1);
-    out.putInt(myCOLUPF);
-    out.putInt(myCOLUBK);
-
-    out.putInt(myCTRLPF);
-    out.putInt(myPlayfieldPriorityAndScore);
-    out.putBool(myREFP0);
-    out.putBool(myREFP1);
-    out.putInt(myPF);
-    out.putInt(myGRP0);
-    out.putInt(myGRP1);
-    out.putInt(myDGRP0);
-    out.putInt(myDGRP1);
-    out.putBool(myENAM0);
-    out.putBool(myENAM1);
-    out.putBool(myENABL);
-    out.putBool(myDENABL);
-    out.putInt(myHMP0);
-    out.putInt(myHMP1);
-    out.putInt(myHMM0);
-    out.putInt(myHMM1);
-    out.putInt(myHMBL);
-    out.putBool(myVDELP0);
-    out.putBool(myVDELP1);
-    out.putBool(myVDELBL);
-    out.putBool(myRESMP0);
-    out.putBool(myRESMP1);
-    out.putInt(myCollision);
-    out.putInt(myPOSP0);
-    out.putInt(myPOSP1);
-    out.putInt(myPOSM0);
-    out.putInt(myPOSM1);
-    out.putInt(myPOSBL);
-
-    out.putInt(myCurrentGRP0);
-    out.putInt(myCurrentGRP1);
-
-// pointers
-//  myCurrentBLMask = ourBallMaskTable[0][0];
-//  myCurrentM0Mask = ourMissleMaskTable[0][0][0];
-//  myCurrentM1Mask = ourMissleMaskTable[0][0][0];
-//  myCurrentP0Mask = ourPlayerMaskTable[0][0][0];
-//  myCurrentP1Mask = ourPlayerMaskTable[0][0][0];
-//  myCurrentPFMask = ourPlayfieldTable[0];
-
-    out.putInt(myLastHMOVEClock);
-    out.putBool(myHMOVEBlankEnabled);
-    out.putBool(myM0CosmicArkMotionEnabled);
-    out.putInt(myM0CosmicArkCounter);
-
-    out.putBool(myDumpEnabled);
-    out.putInt(myDumpDisabledCycle);
+    uint32_t offset = (uint32_t) in.getInt();
+    if(offset >= tablesMemoryUsage())
+      return false;
+    masks[i] = tables + offset;
+  }
+  myState->myCurrentBLMask = masks[0];
+  myState->myCurrentM0Mask = masks[1];
+  myState->myCurrentM1Mask = masks[2];
+  myState->myCurrentP0Mask = masks[3];
+  myState->myCurrentP1Mask = masks[4];
+  myState->myCurrentPFMask = reinterpret_cast<const uint32_t*>(masks[5]);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::stateRestoring()
+{
+  // The logged frames belong to the state being replaced; draw them so the
+  // frame buffers hold what they would have without deferred rendering
+  rasterisePendingFrames();
+  myFrameLogs[0].pending = myFrameLogs[1].pending =
+      myFrameLogs[2].pending = false;
+}
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::stateRestored()
+{
+  // Reset TIA bits to be on
+  enableBits(true);
+
+  // A frame that goes on from here is logged from the restored state
+  if(myDeferredRendering)
+    startFrameLog();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIA::save(Serializer& out)
+{
+  try
+  {
     // Save the sound sample stuff ...
     mySound->save(out);
   }
@@ -397,7 +511,7 @@ bool TIA::save(Serializer& out)
   }
   catch(...)
   {
-    ale::Logger::Error << "Unknown error in save state for " << device << std::endl;
+    ale::Logger::Error << "Unknown error in save state for " << name() << std::endl;
     return false;
   }
 
@@ -407,88 +521,10 @@ bool TIA::save(Serializer& out)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool TIA::load(Deserializer& in)
 {
-  std::string device = name();
-
   try
   {
-    if(in.getString() != device)
-      return false;
-
-    myClockWhenFrameStarted = (int) in.getInt();
-    myClockStartDisplay = (int) in.getInt();
-    myClockStopDisplay = (int) in.getInt();
-    myClockAtLastUpdate = (int) in.getInt();
-    myClocksToEndOfScanLine = (int) in.getInt();
-    myScanlineCountForLastFrame = (int) in.getInt();
-    myCurrentScanline = (int) in.getInt();
-    myVSYNCFinishClock = (int) in.getInt();
-
-    myEnabledObjects = (uint8_t) in.getInt();
-
-    myVSYNC = (uint8_t) in.getInt();
-    myVBLANK = (uint8_t) in.getInt();
-    myNUSIZ0 = (uint8_t) in.getInt();
-    myNUSIZ1 = (uint8_t) in.getInt();
-
-    myCOLUP0 = (uint32_t) in.getInt();
-    myCOLUP1 = (uint32_t) in.getInt();
-    myCOLUPF = (uint32_t) in.getInt();
-    myCOLUBK = (uint32_t) in.getInt();
-
-    myCTRLPF = (uint8_t) in.getInt();
-    myPlayfieldPriorityAndScore = (uint8_t) in.getInt();
-    myREFP0 = in.getBool();
-    myREFP1 = in.getBool();
-    myPF = (uint32_t) in.getInt();
-    myGRP0 = (uint8_t) in.getInt();
-    myGRP1 = (uint8_t) in.getInt();
-    myDGRP0 = (uint8_t) in.getInt();
-    myDGRP1 = (uint8_t) in.getInt();
-    myENAM0 = in.getBool();
-    myENAM1 = in.getBool();
-    myENABL = in.getBool();
-    myDENABL = in.getBool();
-    myHMP0 = (int8_t) in.getInt();
-    myHMP1 = (int8_t) in.getInt();
-    myHMM0 = (int8_t) in.getInt();
-    myHMM1 = (int8_t) in.getInt();
-    myHMBL = (int8_t) in.getInt();
-    myVDELP0 = in.getBool();
-    myVDELP1 = in.getBool();
-    myVDELBL = in.getBool();
-    myRESMP0 = in.getBool();
-    myRESMP1 = in.getBool();
-    myCollision = (uint16_t) in.getInt();
-    myPOSP0 = (int16_t) in.getInt();
-    myPOSP1 = (int16_t) in.getInt();
-    myPOSM0 = (int16_t) in.getInt();
-    myPOSM1 = (int16_t) in.getInt();
-    myPOSBL = (int16_t) in.getInt();
-
-    myCurrentGRP0 = (uint8_t) in.getInt();
-    myCurrentGRP1 = (uint8_t) in.getInt();
-
-// pointers
-//  myCurrentBLMask = ourBallMaskTable[0][0];
-//  myCurrentM0Mask = ourMissleMaskTable[0][0][0];
-//  myCurrentM1Mask = ourMissleMaskTable[0][0][0];
-//  myCurrentP0Mask = ourPlayerMaskTable[0][0][0];
-//  myCurrentP1Mask = ourPlayerMaskTable[0][0][0];
-//  myCurrentPFMask = ourPlayfieldTable[0];
-
-    myLastHMOVEClock = (int) in.getInt();
-    myHMOVEBlankEnabled = in.getBool();
-    myM0CosmicArkMotionEnabled = in.getBool();
-    myM0CosmicArkCounter = (uint32_t) in.getInt();
-
-    myDumpEnabled = in.getBool();
-    myDumpDisabledCycle = (int) in.getInt();
-
     // Load the sound sample stuff ...
     mySound->load(in);
-
-    // Reset TIA bits to be on
-    enableBits(true);
   }
   catch(char *msg)
   {
@@ -497,7 +533,7 @@ bool TIA::load(Deserializer& in)
   }
   catch(...)
   {
-    ale::Logger::Error << "Unknown error in load state for " << device << std::endl;
+    ale::Logger::Error << "Unknown error in load state for " << name() << std::endl;
     return false;
   }
 
@@ -510,6 +546,10 @@ void TIA::update()
   // if we've finished a frame, start a new one
   if(!myPartialFrameFlag)
     startFrame();
+  // An interrupted frame may have been drawn already (to grey it out), but
+  // it goes on being logged, so it has to be drawn again
+  else if(myDeferredRendering)
+    myFrameLogs[0].pending = true;
 
   // Partial frame flag starts out true here. When then 6502 strobes VSYNC,
   // TIA::poke() will set this flag to false, so we'll know whether the
@@ -517,16 +557,25 @@ void TIA::update()
   myPartialFrameFlag = true;
 
   // Execute instructions until frame is finished, or a breakpoint/trap hits
-  mySystem->m6502().execute(25000);
+  mySystem->executeProcessor(25000);
 
   // TODO: have code here that handles errors....
 
-  uint32_t totalClocks = (mySystem->cycles() * 3) - myClockWhenFrameStarted;
-  myCurrentScanline = totalClocks / 228;
+  // Reads and audio writes move the beam on too, and are not logged; one
+  // of them may even have ended the frame
+  if(myDeferredRendering)
+    myFrameLogs[0].endClock = myState->myClockAtLastUpdate;
+
+  uint32_t totalClocks = (mySystem->cycles() * 3) - myState->myClockWhenFrameStarted;
+  myState->myCurrentScanline = totalClocks / 228;
 
   if(myPartialFrameFlag) {
     // grey out old frame contents
-    if(!myFrameGreyed) greyOutFrame();
+    if(!myFrameGreyed) {
+      rasterisePendingFrames();
+      greyOutFrame();
+      markAllRowsDirty();
+    }
     myFrameGreyed = true;
   } else {
     endFrame();
@@ -536,26 +585,31 @@ void TIA::update()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline void TIA::startFrame()
 {
+  // The log of the frame before last is about to be dropped
+  if(myDeferredRendering)
+    rasteriseFrameBeforeLast();
+
   // This stuff should only happen at the beginning of a new frame.
   uint8_t* tmp = myCurrentFrameBuffer;
   myCurrentFrameBuffer = myPreviousFrameBuffer;
   myPreviousFrameBuffer = tmp;
+  std::swap(myCurrentRowHashes, myPreviousRowHashes);
 
   // Remember the number of clocks which have passed on the current scanline
   // so that we can adjust the frame's starting clock by this amount.  This
   // is necessary since some games position objects during VSYNC and the
   // TIA's internal counters are not reset by VSYNC.
-  uint32_t clocks = ((mySystem->cycles() * 3) - myClockWhenFrameStarted) % 228;
+  uint32_t clocks = ((mySystem->cycles() * 3) - myState->myClockWhenFrameStarted) % 228;
 
   // Ask the system to reset the cycle count so it doesn't overflow
   mySystem->resetCycles();
 
   // Setup clocks that'll be used for drawing this frame
-  myClockWhenFrameStarted = -1 * clocks;
-  myClockStartDisplay = myClockWhenFrameStarted + myStartDisplayOffset;
-  myClockStopDisplay = myClockWhenFrameStarted + myStopDisplayOffset;
-  myClockAtLastUpdate = myClockStartDisplay;
-  myClocksToEndOfScanLine = 228;
+  myState->myClockWhenFrameStarted = -1 * clocks;
+  myState->myClockStartDisplay = myState->myClockWhenFrameStarted + myStartDisplayOffset;
+  myState->myClockStopDisplay = myState->myClockWhenFrameStarted + myStopDisplayOffset;
+  myState->myClockAtLastUpdate = myState->myClockStartDisplay;
+  myState->myClocksToEndOfScanLine = 228;
 
   // Reset frame buffer pointer
   myFramePointer = myCurrentFrameBuffer;
@@ -564,23 +618,35 @@ inline void TIA::startFrame()
   // the number of scanlines in the last frame that was generated
   if(myColorLossEnabled)
   {
-    if(myScanlineCountForLastFrame & 0x01)
+    if(myState->myScanlineCountForLastFrame & 0x01)
     {
-      myCOLUP0 |= 0x01010101;
-      myCOLUP1 |= 0x01010101;
-      myCOLUPF |= 0x01010101;
-      myCOLUBK |= 0x01010101;
+      myState->myColor[COLUP0] |= 0x01010101;
+      myState->myColor[COLUP1] |= 0x01010101;
+      myState->myColor[COLUPF] |= 0x01010101;
+      myState->myColor[COLUBK] |= 0x01010101;
     }
     else
     {
-      myCOLUP0 &= 0xfefefefe;
-      myCOLUP1 &= 0xfefefefe;
-      myCOLUPF &= 0xfefefefe;
-      myCOLUBK &= 0xfefefefe;
+      myState->myColor[COLUP0] &= 0xfefefefe;
+      myState->myColor[COLUP1] &= 0xfefefefe;
+      myState->myColor[COLUPF] &= 0xfefefefe;
+      myState->myColor[COLUBK] &= 0xfefefefe;
     }
   }
 
   myFrameGreyed = false;
+
+  // Every row counts as changed until it is drawn and compared
+  markAllRowsDirty();
+
+  // Start logging the new frame in place of the oldest log
+  if(myDeferredRendering)
+  {
+    std::swap(myFrameLogs[1], myFrameLogs[2]);
+    std::swap(myFrameLogs[0], myFrameLogs[1]);
+    startFrameLog();
+    myFrameLogs[0].pending = true;
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -588,7 +654,7 @@ inline void TIA::endFrame()
 {
   // This stuff should only happen at the end of a frame
   // Compute the number of scanlines in the frame
-  myScanlineCountForLastFrame = myCurrentScanline;
+  myState->myScanlineCountForLastFrame = myState->myCurrentScanline;
 
   // Stats counters
   myFrameCounter++;
@@ -612,7 +678,7 @@ uint32_t TIA::height() const
 uint32_t TIA::scanlines() const
 {
   // calculate the current scanline
-  uint32_t totalClocks = (mySystem->cycles() * 3) - myClockWhenFrameStarted;
+  uint32_t totalClocks = (mySystem->cycles() * 3) - myState->myClockWhenFrameStarted;
   return totalClocks/228;
 }
 
@@ -620,7 +686,7 @@ uint32_t TIA::scanlines() const
 uint32_t TIA::clocksThisLine() const
 {
   // calculate the current scanline
-  uint32_t totalClocks = (mySystem->cycles() * 3) - myClockWhenFrameStarted;
+  uint32_t totalClocks = (mySystem->cycles() * 3) - myState->myClockWhenFrameStarted;
   return totalClocks%228;
 }
 
@@ -628,20 +694,73 @@ uint32_t TIA::clocksThisLine() const
 void TIA::setSound(Sound& sound)
 {
   mySound = &sound;
+  mySoundEnabled = !sound.isNull();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::setFastUpdate(bool fast)
+{
+  fastUpdate = fast || myDeferredRendering;
+
+  // Frames about to be drawn need a buffer each
+  if(!fastUpdate && myPreviousFrameBuffer == myCurrentFrameBuffer)
+  {
+    myPreviousFrameBuffer = new uint8_t[160 * 300];
+    std::memcpy(myPreviousFrameBuffer, myCurrentFrameBuffer, 160 * 300);
+    markAllRowsDirty();
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void TIA::computeBallMaskTable()
+void TIA::swapFrameBuffers()
+{
+  std::swap(myCurrentFrameBuffer, myPreviousFrameBuffer);
+  std::swap(myCurrentRowHashes, myPreviousRowHashes);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+struct TIA::Tables
+{
+  uint8_t ballMask[4][4][320];
+  uint16_t collision[64];
+  uint8_t missleMask[4][8][4][320];
+  uint8_t playerMask[4][2][8][320];
+  int8_t playerPositionResetWhen[8][160][160];
+  uint8_t playerReflect[256];
+  uint32_t playfield[2][160];
+  uint8_t priorityEncoder[2][256];
+  uint8_t disabledMask[640];
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+constexpr TIA::Tables TIA::computeTables()
+{
+  // Every entry starts out zero
+  Tables t = {};
+
+  computeBallMaskTable(t);
+  computeCollisionTable(t);
+  computeMissleMaskTable(t);
+  computePlayerMaskTable(t);
+  computePlayerPositionResetWhenTable(t);
+  computePlayerReflectTable(t);
+  computePlayfieldMaskTable(t);
+  computePriorityEncoder(t);
+  return t;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+constexpr void TIA::computeBallMaskTable(Tables& t)
 {
   // First, calculate masks for alignment 0
   for(int size = 0; size < 4; ++size)
   {
-    int x;
+    int x = 0;
 
     // Set all of the masks to false to start with
     for(x = 0; x < 160; ++x)
     {
-      ourBallMaskTable[0][size][x] = false;
+      t.ballMask[0][size][x] = false;
     }
 
     // Set the necessary fields true
@@ -649,14 +768,14 @@ void TIA::computeBallMaskTable()
     {
       if((x >= 0) && (x < (1 << size)))
       {
-        ourBallMaskTable[0][size][x % 160] = true;
+        t.ballMask[0][size][x % 160] = true;
       }
     }
 
     // Copy fields into the wrap-around area of the mask
     for(x = 0; x < 160; ++x)
     {
-      ourBallMaskTable[0][size][x + 160] = ourBallMaskTable[0][size][x];
+      t.ballMask[0][size][x + 160] = t.ballMask[0][size][x];
     }
   }
 
@@ -667,78 +786,78 @@ void TIA::computeBallMaskTable()
     {
       for(uint32_t x = 0; x < 320; ++x)
       {
-        ourBallMaskTable[align][size][x] =
-            ourBallMaskTable[0][size][(x + 320 - align) % 320];
+        t.ballMask[align][size][x] =
+            t.ballMask[0][size][(x + 320 - align) % 320];
       }
     }
   }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void TIA::computeCollisionTable()
+constexpr void TIA::computeCollisionTable(Tables& t)
 {
   for(uint8_t i = 0; i < 64; ++i)
   {
-    ourCollisionTable[i] = 0;
+    t.collision[i] = 0;
 
     if((i & myM0Bit) && (i & myP1Bit))    // M0-P1
-      ourCollisionTable[i] |= 0x0001;
+      t.collision[i] |= 0x0001;
 
     if((i & myM0Bit) && (i & myP0Bit))    // M0-P0
-      ourCollisionTable[i] |= 0x0002;
+      t.collision[i] |= 0x0002;
 
     if((i & myM1Bit) && (i & myP0Bit))    // M1-P0
-      ourCollisionTable[i] |= 0x0004;
+      t.collision[i] |= 0x0004;
 
     if((i & myM1Bit) && (i & myP1Bit))    // M1-P1
-      ourCollisionTable[i] |= 0x0008;
+      t.collision[i] |= 0x0008;
 
     if((i & myP0Bit) && (i & myPFBit))    // P0-PF
-      ourCollisionTable[i] |= 0x0010;
+      t.collision[i] |= 0x0010;
 
     if((i & myP0Bit) && (i & myBLBit))    // P0-BL
-      ourCollisionTable[i] |= 0x0020;
+      t.collision[i] |= 0x0020;
 
     if((i & myP1Bit) && (i & myPFBit))    // P1-PF
-      ourCollisionTable[i] |= 0x0040;
+      t.collision[i] |= 0x0040;
 
     if((i & myP1Bit) && (i & myBLBit))    // P1-BL
-      ourCollisionTable[i] |= 0x0080;
+      t.collision[i] |= 0x0080;
 
     if((i & myM0Bit) && (i & myPFBit))    // M0-PF
-      ourCollisionTable[i] |= 0x0100;
+      t.collision[i] |= 0x0100;
 
     if((i & myM0Bit) && (i & myBLBit))    // M0-BL
-      ourCollisionTable[i] |= 0x0200;
+      t.collision[i] |= 0x0200;
 
     if((i & myM1Bit) && (i & myPFBit))    // M1-PF
-      ourCollisionTable[i] |= 0x0400;
+      t.collision[i] |= 0x0400;
 
     if((i & myM1Bit) && (i & myBLBit))    // M1-BL
-      ourCollisionTable[i] |= 0x0800;
+      t.collision[i] |= 0x0800;
 
     if((i & myBLBit) && (i & myPFBit))    // BL-PF
-      ourCollisionTable[i] |= 0x1000;
+      t.collision[i] |= 0x1000;
 
     if((i & myP0Bit) && (i & myP1Bit))    // P0-P1
-      ourCollisionTable[i] |= 0x2000;
+      t.collision[i] |= 0x2000;
 
     if((i & myM0Bit) && (i & myM1Bit))    // M0-M1
-      ourCollisionTable[i] |= 0x4000;
+      t.collision[i] |= 0x4000;
   }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void TIA::computeMissleMaskTable()
+constexpr void TIA::computeMissleMaskTable(Tables& t)
 {
   // First, calculate masks for alignment 0
-  int x, size, number;
+  int x = 0, size = 0, number = 0;
 
   // Clear the missle table to start with
   for(number = 0; number < 8; ++number)
     for(size = 0; size < 4; ++size)
       for(x = 0; x < 160; ++x)
-        ourMissleMaskTable[0][number][size][x] = false;
+        t.missleMask[0][number][size][x] = false;
 
   for(number = 0; number < 8; ++number)
   {
@@ -750,58 +869,58 @@ void TIA::computeMissleMaskTable()
         if((number == 0x00) || (number == 0x05) || (number == 0x07))
         {
           if((x >= 0) && (x < (1 << size)))
-            ourMissleMaskTable[0][number][size][x % 160] = true;
+            t.missleMask[0][number][size][x % 160] = true;
         }
         // Two copies - close
         else if(number == 0x01)
         {
           if((x >= 0) && (x < (1 << size)))
-            ourMissleMaskTable[0][number][size][x % 160] = true;
+            t.missleMask[0][number][size][x % 160] = true;
           else if(((x - 16) >= 0) && ((x - 16) < (1 << size)))
-            ourMissleMaskTable[0][number][size][x % 160] = true;
+            t.missleMask[0][number][size][x % 160] = true;
         }
         // Two copies - medium
         else if(number == 0x02)
         {
           if((x >= 0) && (x < (1 << size)))
-            ourMissleMaskTable[0][number][size][x % 160] = true;
+            t.missleMask[0][number][size][x % 160] = true;
           else if(((x - 32) >= 0) && ((x - 32) < (1 << size)))
-            ourMissleMaskTable[0][number][size][x % 160] = true;
+            t.missleMask[0][number][size][x % 160] = true;
         }
         // Three copies - close
         else if(number == 0x03)
         {
           if((x >= 0) && (x < (1 << size)))
-            ourMissleMaskTable[0][number][size][x % 160] = true;
+            t.missleMask[0][number][size][x % 160] = true;
           else if(((x - 16) >= 0) && ((x - 16) < (1 << size)))
-            ourMissleMaskTable[0][number][size][x % 160] = true;
+            t.missleMask[0][number][size][x % 160] = true;
           else if(((x - 32) >= 0) && ((x - 32) < (1 << size)))
-            ourMissleMaskTable[0][number][size][x % 160] = true;
+            t.missleMask[0][number][size][x % 160] = true;
         }
         // Two copies - wide
         else if(number == 0x04)
         {
           if((x >= 0) && (x < (1 << size)))
-            ourMissleMaskTable[0][number][size][x % 160] = true;
+            t.missleMask[0][number][size][x % 160] = true;
           else if(((x - 64) >= 0) && ((x - 64) < (1 << size)))
-            ourMissleMaskTable[0][number][size][x % 160] = true;
+            t.missleMask[0][number][size][x % 160] = true;
         }
         // Three copies - medium
         else if(number == 0x06)
         {
           if((x >= 0) && (x < (1 << size)))
-            ourMissleMaskTable[0][number][size][x % 160] = true;
+            t.missleMask[0][number][size][x % 160] = true;
           else if(((x - 32) >= 0) && ((x - 32) < (1 << size)))
-            ourMissleMaskTable[0][number][size][x % 160] = true;
+            t.missleMask[0][number][size][x % 160] = true;
           else if(((x - 64) >= 0) && ((x - 64) < (1 << size)))
-            ourMissleMaskTable[0][number][size][x % 160] = true;
+            t.missleMask[0][number][size][x % 160] = true;
         }
       }
 
       // Copy data into wrap-around area
       for(x = 0; x < 160; ++x)
-        ourMissleMaskTable[0][number][size][x + 160] =
-          ourMissleMaskTable[0][number][size][x];
+        t.missleMask[0][number][size][x + 160] =
+          t.missleMask[0][number][size][x];
     }
   }
 
@@ -814,8 +933,8 @@ void TIA::computeMissleMaskTable()
       {
         for(x = 0; x < 320; ++x)
         {
-          ourMissleMaskTable[align][number][size][x] =
-            ourMissleMaskTable[0][number][size][(x + 320 - align) % 320];
+          t.missleMask[align][number][size][x] =
+            t.missleMask[0][number][size][(x + 320 - align) % 320];
         }
       }
     }
@@ -823,16 +942,16 @@ void TIA::computeMissleMaskTable()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void TIA::computePlayerMaskTable()
+constexpr void TIA::computePlayerMaskTable(Tables& t)
 {
   // First, calculate masks for alignment 0
-  int x, enable, mode;
+  int x = 0, enable = 0, mode = 0;
 
   // Set the player mask table to all zeros
   for(enable = 0; enable < 2; ++enable)
     for(mode = 0; mode < 8; ++mode)
       for(x = 0; x < 160; ++x)
-        ourPlayerMaskTable[0][enable][mode][x] = 0x00;
+        t.playerMask[0][enable][mode][x] = 0x00;
 
   // Now, compute the player mask table
   for(enable = 0; enable < 2; ++enable)
@@ -844,68 +963,68 @@ void TIA::computePlayerMaskTable()
         if(mode == 0x00)
         {
           if((enable == 0) && (x >= 0) && (x < 8))
-            ourPlayerMaskTable[0][enable][mode][x % 160] = 0x80 >> x;
+            t.playerMask[0][enable][mode][x % 160] = 0x80 >> x;
         }
         else if(mode == 0x01)
         {
           if((enable == 0) && (x >= 0) && (x < 8))
-            ourPlayerMaskTable[0][enable][mode][x % 160] = 0x80 >> x;
+            t.playerMask[0][enable][mode][x % 160] = 0x80 >> x;
           else if(((x - 16) >= 0) && ((x - 16) < 8))
-            ourPlayerMaskTable[0][enable][mode][x % 160] = 0x80 >> (x - 16);
+            t.playerMask[0][enable][mode][x % 160] = 0x80 >> (x - 16);
         }
         else if(mode == 0x02)
         {
           if((enable == 0) && (x >= 0) && (x < 8))
-            ourPlayerMaskTable[0][enable][mode][x % 160] = 0x80 >> x;
+            t.playerMask[0][enable][mode][x % 160] = 0x80 >> x;
           else if(((x - 32) >= 0) && ((x - 32) < 8))
-            ourPlayerMaskTable[0][enable][mode][x % 160] = 0x80 >> (x - 32);
+            t.playerMask[0][enable][mode][x % 160] = 0x80 >> (x - 32);
         }
         else if(mode == 0x03)
         {
           if((enable == 0) && (x >= 0) && (x < 8))
-            ourPlayerMaskTable[0][enable][mode][x % 160] = 0x80 >> x;
+            t.playerMask[0][enable][mode][x % 160] = 0x80 >> x;
           else if(((x - 16) >= 0) && ((x - 16) < 8))
-            ourPlayerMaskTable[0][enable][mode][x % 160] = 0x80 >> (x - 16);
+            t.playerMask[0][enable][mode][x % 160] = 0x80 >> (x - 16);
           else if(((x - 32) >= 0) && ((x - 32) < 8))
-            ourPlayerMaskTable[0][enable][mode][x % 160] = 0x80 >> (x - 32);
+            t.playerMask[0][enable][mode][x % 160] = 0x80 >> (x - 32);
         }
         else if(mode == 0x04)
         {
           if((enable == 0) && (x >= 0) && (x < 8))
-            ourPlayerMaskTable[0][enable][mode][x % 160] = 0x80 >> x;
+            t.playerMask[0][enable][mode][x % 160] = 0x80 >> x;
           else if(((x - 64) >= 0) && ((x - 64) < 8))
-            ourPlayerMaskTable[0][enable][mode][x % 160] = 0x80 >> (x - 64);
+            t.playerMask[0][enable][mode][x % 160] = 0x80 >> (x - 64);
         }
         else if(mode == 0x05)
         {
           // For some reason in double size mode the player's output
           // is delayed by one pixel thus we use > instead of >=
           if((enable == 0) && (x > 0) && (x <= 16))
-            ourPlayerMaskTable[0][enable][mode][x % 160] = 0x80 >> ((x - 1)/2);
+            t.playerMask[0][enable][mode][x % 160] = 0x80 >> ((x - 1)/2);
         }
         else if(mode == 0x06)
         {
           if((enable == 0) && (x >= 0) && (x < 8))
-            ourPlayerMaskTable[0][enable][mode][x % 160] = 0x80 >> x;
+            t.playerMask[0][enable][mode][x % 160] = 0x80 >> x;
           else if(((x - 32) >= 0) && ((x - 32) < 8))
-            ourPlayerMaskTable[0][enable][mode][x % 160] = 0x80 >> (x - 32);
+            t.playerMask[0][enable][mode][x % 160] = 0x80 >> (x - 32);
           else if(((x - 64) >= 0) && ((x - 64) < 8))
-            ourPlayerMaskTable[0][enable][mode][x % 160] = 0x80 >> (x - 64);
+            t.playerMask[0][enable][mode][x % 160] = 0x80 >> (x - 64);
         }
         else if(mode == 0x07)
         {
           // For some reason in quad size mode the player's output
           // is delayed by one pixel thus we use > instead of >=
           if((enable == 0) && (x > 0) && (x <= 32))
-            ourPlayerMaskTable[0][enable][mode][x % 160] = 0x80 >> ((x - 1)/4);
+            t.playerMask[0][enable][mode][x % 160] = 0x80 >> ((x - 1)/4);
         }
       }
 
       // Copy data into wrap-around area
       for(x = 0; x < 160; ++x)
       {
-        ourPlayerMaskTable[0][enable][mode][x + 160] =
-            ourPlayerMaskTable[0][enable][mode][x];
+        t.playerMask[0][enable][mode][x + 160] =
+            t.playerMask[0][enable][mode][x];
       }
     }
   }
@@ -919,8 +1038,8 @@ void TIA::computePlayerMaskTable()
       {
         for(x = 0; x < 320; ++x)
         {
-          ourPlayerMaskTable[align][enable][mode][x] =
-              ourPlayerMaskTable[0][enable][mode][(x + 320 - align) % 320];
+          t.playerMask[align][enable][mode][x] =
+              t.playerMask[0][enable][mode][(x + 320 - align) % 320];
         }
       }
     }
@@ -928,138 +1047,39 @@ void TIA::computePlayerMaskTable()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void TIA::computePlayerPositionResetWhenTable()
+constexpr void TIA::computePlayerPositionResetWhenTable(Tables& t)
 {
-  uint32_t mode, oldx, newx;
-
-  // Loop through all player modes, all old player positions, and all new
-  // player positions and determine where the new position is located:
-  // 1 means the new position is within the display of an old copy of the
-  // player, -1 means the new position is within the delay portion of an
-  // old copy of the player, and 0 means it's neither of these two
-  for(mode = 0; mode < 8; ++mode)
+  // Start offsets of the copies of the player in each mode, and the width
+  // of each copy
+  constexpr int copies[8][3] = {
+    { 0, -1, -1 }, { 0, 16, -1 }, { 0, 32, -1 }, { 0, 16, 32 },
+    { 0, 64, -1 }, { 0, -1, -1 }, { 0, 32, 64 }, { 0, -1, -1 }
+  };
+  constexpr int widths[8] = { 8, 8, 8, 8, 8, 16, 8, 32 };
+
+  // Loop through all player modes and all old player positions and mark
+  // where a new position is located: 1 means the new position is within the
+  // display of an old copy of the player, -1 means the new position is
+  // within the delay portion of an old copy of the player, and 0 (the
+  // initial value) means it's neither of these two
+  for(int mode = 0; mode < 8; ++mode)
   {
-    for(oldx = 0; oldx < 160; ++oldx)
+    for(int oldx = 0; oldx < 160; ++oldx)
     {
-      // Set everything to 0 for non-delay/non-display section
-      for(newx = 0; newx < 160; ++newx)
-      {
-        ourPlayerPositionResetWhenTable[mode][oldx][newx] = 0;
-      }
-
-      // Now, we'll set the entries for non-delay/non-display section
-      for(newx = 0; newx < 160 + 72 + 5; ++newx)
-      {
-        if(mode == 0x00)
-        {
-          if((newx >= oldx) && (newx < (oldx + 4)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = -1;
-
-          if((newx >= oldx + 4) && (newx < (oldx + 4 + 8)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = 1;
-        }
-        else if(mode == 0x01)
-        {
-          if((newx >= oldx) && (newx < (oldx + 4)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = -1;
-          else if((newx >= (oldx + 16)) && (newx < (oldx + 16 + 4)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = -1;
-
-          if((newx >= oldx + 4) && (newx < (oldx + 4 + 8)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = 1;
-          else if((newx >= oldx + 16 + 4) && (newx < (oldx + 16 + 4 + 8)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = 1;
-        }
-        else if(mode == 0x02)
-        {
-          if((newx >= oldx) && (newx < (oldx + 4)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = -1;
-          else if((newx >= (oldx + 32)) && (newx < (oldx + 32 + 4)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = -1;
-
-          if((newx >= oldx + 4) && (newx < (oldx + 4 + 8)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = 1;
-          else if((newx >= oldx + 32 + 4) && (newx < (oldx + 32 + 4 + 8)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = 1;
-        }
-        else if(mode == 0x03)
-        {
-          if((newx >= oldx) && (newx < (oldx + 4)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = -1;
-          else if((newx >= (oldx + 16)) && (newx < (oldx + 16 + 4)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = -1;
-          else if((newx >= (oldx + 32)) && (newx < (oldx + 32 + 4)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = -1;
-
-          if((newx >= oldx + 4) && (newx < (oldx + 4 + 8)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = 1;
-          else if((newx >= oldx + 16 + 4) && (newx < (oldx + 16 + 4 + 8)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = 1;
-          else if((newx >= oldx + 32 + 4) && (newx < (oldx + 32 + 4 + 8)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = 1;
-        }
-        else if(mode == 0x04)
-        {
-          if((newx >= oldx) && (newx < (oldx + 4)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = -1;
-          else if((newx >= (oldx + 64)) && (newx < (oldx + 64 + 4)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = -1;
-
-          if((newx >= oldx + 4) && (newx < (oldx + 4 + 8)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = 1;
-          else if((newx >= oldx + 64 + 4) && (newx < (oldx + 64 + 4 + 8)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = 1;
-        }
-        else if(mode == 0x05)
-        {
-          if((newx >= oldx) && (newx < (oldx + 4)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = -1;
-
-          if((newx >= oldx + 4) && (newx < (oldx + 4 + 16)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = 1;
-        }
-        else if(mode == 0x06)
-        {
-          if((newx >= oldx) && (newx < (oldx + 4)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = -1;
-          else if((newx >= (oldx + 32)) && (newx < (oldx + 32 + 4)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = -1;
-          else if((newx >= (oldx + 64)) && (newx < (oldx + 64 + 4)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = -1;
-
-          if((newx >= oldx + 4) && (newx < (oldx + 4 + 8)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = 1;
-          else if((newx >= oldx + 32 + 4) && (newx < (oldx + 32 + 4 + 8)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = 1;
-          else if((newx >= oldx + 64 + 4) && (newx < (oldx + 64 + 4 + 8)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = 1;
-        }
-        else if(mode == 0x07)
-        {
-          if((newx >= oldx) && (newx < (oldx + 4)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = -1;
-
-          if((newx >= oldx + 4) && (newx < (oldx + 4 + 32)))
-            ourPlayerPositionResetWhenTable[mode][oldx][newx % 160] = 1;
-        }
-      }
-
-      // Let's do a sanity check on our table entries
-      uint32_t s1 = 0, s2 = 0;
-      for(newx = 0; newx < 160; ++newx)
+      for(int copy = 0; copy < 3 && copies[mode][copy] >= 0; ++copy)
       {
-        if(ourPlayerPositionResetWhenTable[mode][oldx][newx] == -1)
-          ++s1;
-        if(ourPlayerPositionResetWhenTable[mode][oldx][newx] == 1)
-          ++s2;
+        int start = oldx + copies[mode][copy];
+        for(int newx = start; newx < start + 4; ++newx)
+          t.playerPositionResetWhen[mode][oldx][newx % 160] = -1;
+        for(int newx = start + 4; newx < start + 4 + widths[mode]; ++newx)
+          t.playerPositionResetWhen[mode][oldx][newx % 160] = 1;
       }
-      assert((s1 % 4 == 0) && (s2 % 8 == 0));
     }
   }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void TIA::computePlayerReflectTable()
+constexpr void TIA::computePlayerReflectTable(Tables& t)
 {
   for(uint16_t i = 0; i < 256; ++i)
   {
@@ -1070,47 +1090,88 @@ void TIA::computePlayerReflectTable()
       r = (r << 1) | ((i & t) ? 0x01 : 0x00);
     }
 
-    ourPlayerReflectTable[i] = r;
+    t.playerReflect[i] = r;
   }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void TIA::computePlayfieldMaskTable()
+constexpr void TIA::computePlayfieldMaskTable(Tables& t)
 {
-  int x;
+  int x = 0;
 
   // Compute playfield mask table for non-reflected mode
   for(x = 0; x < 160; ++x)
   {
     if(x < 16)
-      ourPlayfieldTable[0][x] = 0x00001 << (x / 4);
+      t.playfield[0][x] = 0x00001 << (x / 4);
     else if(x < 48)
-      ourPlayfieldTable[0][x] = 0x00800 >> ((x - 16) / 4);
+      t.playfield[0][x] = 0x00800 >> ((x - 16) / 4);
     else if(x < 80)
-      ourPlayfieldTable[0][x] = 0x01000 << ((x - 48) / 4);
+      t.playfield[0][x] = 0x01000 << ((x - 48) / 4);
     else if(x < 96)
-      ourPlayfieldTable[0][x] = 0x00001 << ((x - 80) / 4);
+      t.playfield[0][x] = 0x00001 << ((x - 80) / 4);
     else if(x < 128)
-      ourPlayfieldTable[0][x] = 0x00800 >> ((x - 96) / 4);
+      t.playfield[0][x] = 0x00800 >> ((x - 96) / 4);
     else if(x < 160)
-      ourPlayfieldTable[0][x] = 0x01000 << ((x - 128) / 4);
+      t.playfield[0][x] = 0x01000 << ((x - 128) / 4);
   }
 
   // Compute playfield mask table for reflected mode
   for(x = 0; x < 160; ++x)
   {
     if(x < 16)
-      ourPlayfieldTable[1][x] = 0x00001 << (x / 4);
+      t.playfield[1][x] = 0x00001 << (x / 4);
     else if(x < 48)
-      ourPlayfieldTable[1][x] = 0x00800 >> ((x - 16) / 4);
+      t.playfield[1][x] = 0x00800 >> ((x - 16) / 4);
     else if(x < 80)
-      ourPlayfieldTable[1][x] = 0x01000 << ((x - 48) / 4);
+      t.playfield[1][x] = 0x01000 << ((x - 48) / 4);
     else if(x < 112)
-      ourPlayfieldTable[1][x] = 0x80000 >> ((x - 80) / 4);
+      t.playfield[1][x] = 0x80000 >> ((x - 80) / 4);
     else if(x < 144)
-      ourPlayfieldTable[1][x] = 0x00010 << ((x - 112) / 4);
+      t.playfield[1][x] = 0x00010 << ((x - 112) / 4);
     else if(x < 160)
-      ourPlayfieldTable[1][x] = 0x00008 >> ((x - 144) / 4);
+      t.playfield[1][x] = 0x00008 >> ((x - 144) / 4);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+constexpr void TIA::computePriorityEncoder(Tables& t)
+{
+  for(uint16_t x = 0; x < 2; ++x)
+  {
+    for(uint16_t enabled = 0; enabled < 256; ++enabled)
+    {
+      if(enabled & PriorityBit)
+      {
+        uint8_t color = 0;
+
+        if((enabled & (myP1Bit | myM1Bit)) != 0)
+          color = 3;
+        if((enabled & (myP0Bit | myM0Bit)) != 0)
+          color = 2;
+        if((enabled & myBLBit) != 0)
+          color = 1;
+        if((enabled & myPFBit) != 0)
+          color = 1;  // NOTE: Playfield has priority so ScoreBit isn't used
+
+        t.priorityEncoder[x][enabled] = color;
+      }
+      else
+      {
+        uint8_t color = 0;
+
+        if((enabled & myBLBit) != 0)
+          color = 1;
+        if((enabled & myPFBit) != 0)
+          color = (enabled & ScoreBit) ? ((x == 0) ? 2 : 3) : 1;
+        if((enabled & (myP1Bit | myM1Bit)) != 0)
+          color = (color != 2) ? 3 : 2;
+        if((enabled & (myP0Bit | myM0Bit)) != 0)
+          color = 2;
+
+        t.priorityEncoder[x][enabled] = color;
+      }
+    }
   }
 }
 
@@ -1121,14 +1182,14 @@ inline void TIA::updateFrameScanline(uint32_t clocksToUpdate, uint32_t hpos)
   uint8_t* ending = myFramePointer + clocksToUpdate;
 
   // See if we're in the vertical blank region
-  if(myVBLANK & 0x02)
+  if(myState->myVBLANK & 0x02)
   {
     std::memset(myFramePointer, 0, clocksToUpdate);
   }
   // Handle all other possible combinations
   else
   {
-    switch(myEnabledObjects | myPlayfieldPriorityAndScore)
+    switch(myState->myEnabledObjects | myState->myPlayfieldPriorityAndScore)
     {
       // Background
       case 0x00:
@@ -1136,7 +1197,7 @@ inline void TIA::updateFrameScanline(uint32_t clocksToUpdate, uint32_t hpos)
       case 0x00 | PriorityBit:
       case 0x00 | PriorityBit | ScoreBit:
       {
-        std::memset(myFramePointer, myCOLUBK, clocksToUpdate);
+        std::memset(myFramePointer, myState->myColor[COLUBK], clocksToUpdate);
         break;
       }
 
@@ -1144,19 +1205,19 @@ inline void TIA::updateFrameScanline(uint32_t clocksToUpdate, uint32_t hpos)
       case myPFBit:
       case myPFBit | PriorityBit:
       {
-        const uint32_t* mask = &myCurrentPFMask[hpos];
+        const uint32_t* mask = &myState->myCurrentPFMask[hpos];
 
         // Update a uint8_t at a time until reaching a uint32_t boundary
         for(; ((uintptr_t)myFramePointer & 0x03) && (myFramePointer < ending);
             ++myFramePointer, ++mask)
         {
-          *myFramePointer = (myPF & *mask) ? myCOLUPF : myCOLUBK;
+          *myFramePointer = (myState->myPF & *mask) ? myState->myColor[COLUPF] : myState->myColor[COLUBK];
         }
 
         // Now, update a uint32_t at a time
         for(; myFramePointer < ending; myFramePointer += 4, mask += 4)
         {
-          *((uint32_t*)myFramePointer) = (myPF & *mask) ? myCOLUPF : myCOLUBK;
+          *((uint32_t*)myFramePointer) = (myState->myPF & *mask) ? myState->myColor[COLUPF] : myState->myColor[COLUBK];
         }
         break;
       }
@@ -1165,22 +1226,22 @@ inline void TIA::updateFrameScanline(uint32_t clocksToUpdate, uint32_t hpos)
       case myPFBit | ScoreBit:
       case myPFBit | ScoreBit | PriorityBit:
       {
-        const uint32_t* mask = &myCurrentPFMask[hpos];
+        const uint32_t* mask = &myState->myCurrentPFMask[hpos];
 
         // Update a uint8_t at a time until reaching a uint32_t boundary
         for(; ((uintptr_t)myFramePointer & 0x03) && (myFramePointer < ending);
             ++myFramePointer, ++mask, ++hpos)
         {
-          *myFramePointer = (myPF & *mask) ?
-              (hpos < 80 ? myCOLUP0 : myCOLUP1) : myCOLUBK;
+          *myFramePointer = (myState->myPF & *mask) ?
+              (hpos < 80 ? myState->myColor[COLUP0] : myState->myColor[COLUP1]) : myState->myColor[COLUBK];
         }
 
         // Now, update a uint32_t at a time
         for(; myFramePointer < ending;
             myFramePointer += 4, mask += 4, hpos += 4)
         {
-          *((uint32_t*)myFramePointer) = (myPF & *mask) ?
-              (hpos < 80 ? myCOLUP0 : myCOLUP1) : myCOLUBK;
+          *((uint32_t*)myFramePointer) = (myState->myPF & *mask) ?
+              (hpos < 80 ? myState->myColor[COLUP0] : myState->myColor[COLUP1]) : myState->myColor[COLUBK];
         }
         break;
       }
@@ -1191,18 +1252,18 @@ inline void TIA::updateFrameScanline(uint32_t clocksToUpdate, uint32_t hpos)
       case myP0Bit | PriorityBit:
       case myP0Bit | ScoreBit | PriorityBit:
       {
-        const uint8_t* mP0 = &myCurrentP0Mask[hpos];
+        const uint8_t* mP0 = &myState->myCurrentP0Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mP0)
           {
-            *(uint32_t*)myFramePointer = myCOLUBK;
+            *(uint32_t*)myFramePointer = myState->myColor[COLUBK];
             mP0 += 4; myFramePointer += 4;
           }
           else
           {
-            *myFramePointer = (myCurrentGRP0 & *mP0) ? myCOLUP0 : myCOLUBK;
+            *myFramePointer = (myState->myCurrentGRP0 & *mP0) ? myState->myColor[COLUP0] : myState->myColor[COLUBK];
             ++mP0; ++myFramePointer;
           }
         }
@@ -1215,18 +1276,18 @@ inline void TIA::updateFrameScanline(uint32_t clocksToUpdate, uint32_t hpos)
       case myP1Bit | PriorityBit:
       case myP1Bit | ScoreBit | PriorityBit:
       {
-        const uint8_t* mP1 = &myCurrentP1Mask[hpos];
+        const uint8_t* mP1 = &myState->myCurrentP1Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mP1)
           {
-            *(uint32_t*)myFramePointer = myCOLUBK;
+            *(uint32_t*)myFramePointer = myState->myColor[COLUBK];
             mP1 += 4; myFramePointer += 4;
           }
           else
           {
-            *myFramePointer = (myCurrentGRP1 & *mP1) ? myCOLUP1 : myCOLUBK;
+            *myFramePointer = (myState->myCurrentGRP1 & *mP1) ? myState->myColor[COLUP1] : myState->myColor[COLUBK];
             ++mP1; ++myFramePointer;
           }
         }
@@ -1239,24 +1300,24 @@ inline void TIA::updateFrameScanline(uint32_t clocksToUpdate, uint32_t hpos)
       case myP0Bit | myP1Bit | PriorityBit:
       case myP0Bit | myP1Bit | ScoreBit | PriorityBit:
       {
-        const uint8_t* mP0 = &myCurrentP0Mask[hpos];
-        const uint8_t* mP1 = &myCurrentP1Mask[hpos];
+        const uint8_t* mP0 = &myState->myCurrentP0Mask[hpos];
+        const uint8_t* mP1 = &myState->myCurrentP1Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mP0 &&
               !*(uint32_t*)mP1)
           {
-            *(uint32_t*)myFramePointer = myCOLUBK;
+            *(uint32_t*)myFramePointer = myState->myColor[COLUBK];
             mP0 += 4; mP1 += 4; myFramePointer += 4;
           }
           else
           {
-            *myFramePointer = (myCurrentGRP0 & *mP0) ?
-                myCOLUP0 : ((myCurrentGRP1 & *mP1) ? myCOLUP1 : myCOLUBK);
+            *myFramePointer = (myState->myCurrentGRP0 & *mP0) ?
+                myState->myColor[COLUP0] : ((myState->myCurrentGRP1 & *mP1) ? myState->myColor[COLUP1] : myState->myColor[COLUBK]);
 
-            if((myCurrentGRP0 & *mP0) && (myCurrentGRP1 & *mP1))
-              myCollision |= ourCollisionTable[myP0Bit | myP1Bit];
+            if((myState->myCurrentGRP0 & *mP0) && (myState->myCurrentGRP1 & *mP1))
+              myState->myCollision |= ourCollisionTable[myP0Bit | myP1Bit];
 
             ++mP0; ++mP1; ++myFramePointer;
           }
@@ -1270,18 +1331,18 @@ inline void TIA::updateFrameScanline(uint32_t clocksToUpdate, uint32_t hpos)
       case myM0Bit | PriorityBit:
       case myM0Bit | ScoreBit | PriorityBit:
       {
-        const uint8_t* mM0 = &myCurrentM0Mask[hpos];
+        const uint8_t* mM0 = &myState->myCurrentM0Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mM0)
           {
-            *(uint32_t*)myFramePointer = myCOLUBK;
+            *(uint32_t*)myFramePointer = myState->myColor[COLUBK];
             mM0 += 4; myFramePointer += 4;
           }
           else
           {
-            *myFramePointer = *mM0 ? myCOLUP0 : myCOLUBK;
+            *myFramePointer = *mM0 ? myState->myColor[COLUP0] : myState->myColor[COLUBK];
             ++mM0; ++myFramePointer;
           }
         }
@@ -1294,18 +1355,18 @@ inline void TIA::updateFrameScanline(uint32_t clocksToUpdate, uint32_t hpos)
       case myM1Bit | PriorityBit:
       case myM1Bit | ScoreBit | PriorityBit:
       {
-        const uint8_t* mM1 = &myCurrentM1Mask[hpos];
+        const uint8_t* mM1 = &myState->myCurrentM1Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mM1)
           {
-            *(uint32_t*)myFramePointer = myCOLUBK;
+            *(uint32_t*)myFramePointer = myState->myColor[COLUBK];
             mM1 += 4; myFramePointer += 4;
           }
           else
           {
-            *myFramePointer = *mM1 ? myCOLUP1 : myCOLUBK;
+            *myFramePointer = *mM1 ? myState->myColor[COLUP1] : myState->myColor[COLUBK];
             ++mM1; ++myFramePointer;
           }
         }
@@ -1318,18 +1379,18 @@ inline void TIA::updateFrameScanline(uint32_t clocksToUpdate, uint32_t hpos)
       case myBLBit | PriorityBit:
       case myBLBit | ScoreBit | PriorityBit:
       {
-        const uint8_t* mBL = &myCurrentBLMask[hpos];
+        const uint8_t* mBL = &myState->myCurrentBLMask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mBL)
           {
-            *(uint32_t*)myFramePointer = myCOLUBK;
+            *(uint32_t*)myFramePointer = myState->myColor[COLUBK];
             mBL += 4; myFramePointer += 4;
           }
           else
           {
-            *myFramePointer = *mBL ? myCOLUPF : myCOLUBK;
+            *myFramePointer = *mBL ? myState->myColor[COLUPF] : myState->myColor[COLUBK];
             ++mBL; ++myFramePointer;
           }
         }
@@ -1342,22 +1403,22 @@ inline void TIA::updateFrameScanline(uint32_t clocksToUpdate, uint32_t hpos)
       case myM0Bit | myM1Bit | PriorityBit:
       case myM0Bit | myM1Bit | ScoreBit | PriorityBit:
       {
-        const uint8_t* mM0 = &myCurrentM0Mask[hpos];
-        const uint8_t* mM1 = &myCurrentM1Mask[hpos];
+        const uint8_t* mM0 = &myState->myCurrentM0Mask[hpos];
+        const uint8_t* mM1 = &myState->myCurrentM1Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mM0 && !*(uint32_t*)mM1)
           {
-            *(uint32_t*)myFramePointer = myCOLUBK;
+            *(uint32_t*)myFramePointer = myState->myColor[COLUBK];
             mM0 += 4; mM1 += 4; myFramePointer += 4;
           }
           else
           {
-            *myFramePointer = *mM0 ? myCOLUP0 : (*mM1 ? myCOLUP1 : myCOLUBK);
+            *myFramePointer = *mM0 ? myState->myColor[COLUP0] : (*mM1 ? myState->myColor[COLUP1] : myState->myColor[COLUBK]);
 
             if(*mM0 && *mM1)
-              myCollision |= ourCollisionTable[myM0Bit | myM1Bit];
+              myState->myCollision |= ourCollisionTable[myM0Bit | myM1Bit];
 
             ++mM0; ++mM1; ++myFramePointer;
           }
@@ -1369,22 +1430,22 @@ inline void TIA::updateFrameScanline(uint32_t clocksToUpdate, uint32_t hpos)
       case myBLBit | myM0Bit:
       case myBLBit | myM0Bit | ScoreBit:
       {
-        const uint8_t* mBL = &myCurrentBLMask[hpos];
-        const uint8_t* mM0 = &myCurrentM0Mask[hpos];
+        const uint8_t* mBL = &myState->myCurrentBLMask[hpos];
+        const uint8_t* mM0 = &myState->myCurrentM0Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mBL && !*(uint32_t*)mM0)
           {
-            *(uint32_t*)myFramePointer = myCOLUBK;
+            *(uint32_t*)myFramePointer = myState->myColor[COLUBK];
             mBL += 4; mM0 += 4; myFramePointer += 4;
           }
           else
           {
-            *myFramePointer = (*mM0 ? myCOLUP0 : (*mBL ? myCOLUPF : myCOLUBK));
+            *myFramePointer = (*mM0 ? myState->myColor[COLUP0] : (*mBL ? myState->myColor[COLUPF] : myState->myColor[COLUBK]));
 
             if(*mBL && *mM0)
-              myCollision |= ourCollisionTable[myBLBit | myM0Bit];
+              myState->myCollision |= ourCollisionTable[myBLBit | myM0Bit];
 
             ++mBL; ++mM0; ++myFramePointer;
           }
@@ -1396,22 +1457,22 @@ inline void TIA::updateFrameScanline(uint32_t clocksToUpdate, uint32_t hpos)
       case myBLBit | myM0Bit | PriorityBit:
       case myBLBit | myM0Bit | ScoreBit | PriorityBit:
       {
-        const uint8_t* mBL = &myCurrentBLMask[hpos];
-        const uint8_t* mM0 = &myCurrentM0Mask[hpos];
+        const uint8_t* mBL = &myState->myCurrentBLMask[hpos];
+        const uint8_t* mM0 = &myState->myCurrentM0Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mBL && !*(uint32_t*)mM0)
           {
-            *(uint32_t*)myFramePointer = myCOLUBK;
+            *(uint32_t*)myFramePointer = myState->myColor[COLUBK];
             mBL += 4; mM0 += 4; myFramePointer += 4;
           }
           else
           {
-            *myFramePointer = (*mBL ? myCOLUPF : (*mM0 ? myCOLUP0 : myCOLUBK));
+            *myFramePointer = (*mBL ? myState->myColor[COLUPF] : (*mM0 ? myState->myColor[COLUP0] : myState->myColor[COLUBK]));
 
             if(*mBL && *mM0)
-              myCollision |= ourCollisionTable[myBLBit | myM0Bit];
+              myState->myCollision |= ourCollisionTable[myBLBit | myM0Bit];
 
             ++mBL; ++mM0; ++myFramePointer;
           }
@@ -1423,23 +1484,23 @@ inline void TIA::updateFrameScanline(uint32_t clocksToUpdate, uint32_t hpos)
       case myBLBit | myM1Bit:
       case myBLBit | myM1Bit | ScoreBit:
       {
-        const uint8_t* mBL = &myCurrentBLMask[hpos];
-        const uint8_t* mM1 = &myCurrentM1Mask[hpos];
+        const uint8_t* mBL = &myState->myCurrentBLMask[hpos];
+        const uint8_t* mM1 = &myState->myCurrentM1Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mBL &&
               !*(uint32_t*)mM1)
           {
-            *(uint32_t*)myFramePointer = myCOLUBK;
+            *(uint32_t*)myFramePointer = myState->myColor[COLUBK];
             mBL += 4; mM1 += 4; myFramePointer += 4;
           }
           else
           {
-            *myFramePointer = (*mM1 ? myCOLUP1 : (*mBL ? myCOLUPF : myCOLUBK));
+            *myFramePointer = (*mM1 ? myState->myColor[COLUP1] : (*mBL ? myState->myColor[COLUPF] : myState->myColor[COLUBK]));
 
             if(*mBL && *mM1)
-              myCollision |= ourCollisionTable[myBLBit | myM1Bit];
+              myState->myCollision |= ourCollisionTable[myBLBit | myM1Bit];
 
             ++mBL; ++mM1; ++myFramePointer;
           }
@@ -1451,23 +1512,23 @@ inline void TIA::updateFrameScanline(uint32_t clocksToUpdate, uint32_t hpos)
       case myBLBit | myM1Bit | PriorityBit:
       case myBLBit | myM1Bit | ScoreBit | PriorityBit:
       {
-        const uint8_t* mBL = &myCurrentBLMask[hpos];
-        const uint8_t* mM1 = &myCurrentM1Mask[hpos];
+        const uint8_t* mBL = &myState->myCurrentBLMask[hpos];
+        const uint8_t* mM1 = &myState->myCurrentM1Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mBL &&
               !*(uint32_t*)mM1)
           {
-            *(uint32_t*)myFramePointer = myCOLUBK;
+            *(uint32_t*)myFramePointer = myState->myColor[COLUBK];
             mBL += 4; mM1 += 4; myFramePointer += 4;
           }
           else
           {
-            *myFramePointer = (*mBL ? myCOLUPF : (*mM1 ? myCOLUP1 : myCOLUBK));
+            *myFramePointer = (*mBL ? myState->myColor[COLUPF] : (*mM1 ? myState->myColor[COLUP1] : myState->myColor[COLUBK]));
 
             if(*mBL && *mM1)
-              myCollision |= ourCollisionTable[myBLBit | myM1Bit];
+              myState->myCollision |= ourCollisionTable[myBLBit | myM1Bit];
 
             ++mBL; ++mM1; ++myFramePointer;
           }
@@ -1479,23 +1540,23 @@ inline void TIA::updateFrameScanline(uint32_t clocksToUpdate, uint32_t hpos)
       case myBLBit | myP1Bit:
       case myBLBit | myP1Bit | ScoreBit:
       {
-        const uint8_t* mBL = &myCurrentBLMask[hpos];
-        const uint8_t* mP1 = &myCurrentP1Mask[hpos];
+        const uint8_t* mBL = &myState->myCurrentBLMask[hpos];
+        const uint8_t* mP1 = &myState->myCurrentP1Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mP1 && !*(uint32_t*)mBL)
           {
-            *(uint32_t*)myFramePointer = myCOLUBK;
+            *(uint32_t*)myFramePointer = myState->myColor[COLUBK];
             mBL += 4; mP1 += 4; myFramePointer += 4;
           }
           else
           {
-            *myFramePointer = (myCurrentGRP1 & *mP1) ? myCOLUP1 :
-                (*mBL ? myCOLUPF : myCOLUBK);
+            *myFramePointer = (myState->myCurrentGRP1 & *mP1) ? myState->myColor[COLUP1] :
+                (*mBL ? myState->myColor[COLUPF] : myState->myColor[COLUBK]);
 
-            if(*mBL && (myCurrentGRP1 & *mP1))
-              myCollision |= ourCollisionTable[myBLBit | myP1Bit];
+            if(*mBL && (myState->myCurrentGRP1 & *mP1))
+              myState->myCollision |= ourCollisionTable[myBLBit | myP1Bit];
 
             ++mBL; ++mP1; ++myFramePointer;
           }
@@ -1507,23 +1568,23 @@ inline void TIA::updateFrameScanline(uint32_t clocksToUpdate, uint32_t hpos)
       case myBLBit | myP1Bit | PriorityBit:
       case myBLBit | myP1Bit | PriorityBit | ScoreBit:
       {
-        const uint8_t* mBL = &myCurrentBLMask[hpos];
-        const uint8_t* mP1 = &myCurrentP1Mask[hpos];
+        const uint8_t* mBL = &myState->myCurrentBLMask[hpos];
+        const uint8_t* mP1 = &myState->myCurrentP1Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mP1 && !*(uint32_t*)mBL)
           {
-            *(uint32_t*)myFramePointer = myCOLUBK;
+            *(uint32_t*)myFramePointer = myState->myColor[COLUBK];
             mBL += 4; mP1 += 4; myFramePointer += 4;
           }
           else
           {
-            *myFramePointer = *mBL ? myCOLUPF :
-                ((myCurrentGRP1 & *mP1) ? myCOLUP1 : myCOLUBK);
+            *myFramePointer = *mBL ? myState->myColor[COLUPF] :
+                ((myState->myCurrentGRP1 & *mP1) ? myState->myColor[COLUP1] : myState->myColor[COLUBK]);
 
-            if(*mBL && (myCurrentGRP1 & *mP1))
-              myCollision |= ourCollisionTable[myBLBit | myP1Bit];
+            if(*mBL && (myState->myCurrentGRP1 & *mP1))
+              myState->myCollision |= ourCollisionTable[myBLBit | myP1Bit];
 
             ++mBL; ++mP1; ++myFramePointer;
           }
@@ -1534,23 +1595,23 @@ inline void TIA::updateFrameScanline(uint32_t clocksToUpdate, uint32_t hpos)
       // Playfield and Player 0 are enabled and playfield priority is not set
       case myPFBit | myP0Bit:
       {
-        const uint32_t* mPF = &myCurrentPFMask[hpos];
-        const uint8_t* mP0 = &myCurrentP0Mask[hpos];
+        const uint32_t* mPF = &myState->myCurrentPFMask[hpos];
+        const uint8_t* mP0 = &myState->myCurrentP0Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mP0)
           {
-            *(uint32_t*)myFramePointer = (myPF & *mPF) ? myCOLUPF : myCOLUBK;
+            *(uint32_t*)myFramePointer = (myState->myPF & *mPF) ? myState->myColor[COLUPF] : myState->myColor[COLUBK];
             mPF += 4; mP0 += 4; myFramePointer += 4;
           }
           else
           {
-            *myFramePointer = (myCurrentGRP0 & *mP0) ?
-                  myCOLUP0 : ((myPF & *mPF) ? myCOLUPF : myCOLUBK);
+            *myFramePointer = (myState->myCurrentGRP0 & *mP0) ?
+                  myState->myColor[COLUP0] : ((myState->myPF & *mPF) ? myState->myColor[COLUPF] : myState->myColor[COLUBK]);
 
-            if((myPF & *mPF) && (myCurrentGRP0 & *mP0))
-              myCollision |= ourCollisionTable[myPFBit | myP0Bit];
+            if((myState->myPF & *mPF) && (myState->myCurrentGRP0 & *mP0))
+              myState->myCollision |= ourCollisionTable[myPFBit | myP0Bit];
 
             ++mPF; ++mP0; ++myFramePointer;
           }
@@ -1562,23 +1623,23 @@ inline void TIA::updateFrameScanline(uint32_t clocksToUpdate, uint32_t hpos)
       // Playfield and Player 0 are enabled and playfield priority is set
       case myPFBit | myP0Bit | PriorityBit:
       {
-        const uint32_t* mPF = &myCurrentPFMask[hpos];
-        const uint8_t* mP0 = &myCurrentP0Mask[hpos];
+        const uint32_t* mPF = &myState->myCurrentPFMask[hpos];
+        const uint8_t* mP0 = &myState->myCurrentP0Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mP0)
           {
-            *(uint32_t*)myFramePointer = (myPF & *mPF) ? myCOLUPF : myCOLUBK;
+            *(uint32_t*)myFramePointer = (myState->myPF & *mPF) ? myState->myColor[COLUPF] : myState->myColor[COLUBK];
             mPF += 4; mP0 += 4; myFramePointer += 4;
           }
           else
           {
-            *myFramePointer = (myPF & *mPF) ? myCOLUPF :
-                ((myCurrentGRP0 & *mP0) ? myCOLUP0 : myCOLUBK);
+            *myFramePointer = (myState->myPF & *mPF) ? myState->myColor[COLUPF] :
+                ((myState->myCurrentGRP0 & *mP0) ? myState->myColor[COLUP0] : myState->myColor[COLUBK]);
 
-            if((myPF & *mPF) && (myCurrentGRP0 & *mP0))
-              myCollision |= ourCollisionTable[myPFBit | myP0Bit];
+            if((myState->myPF & *mPF) && (myState->myCurrentGRP0 & *mP0))
+              myState->myCollision |= ourCollisionTable[myPFBit | myP0Bit];
 
             ++mPF; ++mP0; ++myFramePointer;
           }
@@ -1590,23 +1651,23 @@ inline void TIA::updateFrameScanline(uint32_t clocksToUpdate, uint32_t hpos)
       // Playfield and Player 1 are enabled and playfield priority is not set
       case myPFBit | myP1Bit:
       {
-        const uint32_t* mPF = &myCurrentPFMask[hpos];
-        const uint8_t* mP1 = &myCurrentP1Mask[hpos];
+        const uint32_t* mPF = &myState->myCurrentPFMask[hpos];
+        const uint8_t* mP1 = &myState->myCurrentP1Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mP1)
           {
-            *(uint32_t*)myFramePointer = (myPF & *mPF) ? myCOLUPF : myCOLUBK;
+            *(uint32_t*)myFramePointer = (myState->myPF & *mPF) ? myState->myColor[COLUPF] : myState->myColor[COLUBK];
             mPF += 4; mP1 += 4; myFramePointer += 4;
           }
           else
           {
-            *myFramePointer = (myCurrentGRP1 & *mP1) ?
-                  myCOLUP1 : ((myPF & *mPF) ? myCOLUPF : myCOLUBK);
+            *myFramePointer = (myState->myCurrentGRP1 & *mP1) ?
+                  myState->myColor[COLUP1] : ((myState->myPF & *mPF) ? myState->myColor[COLUPF] : myState->myColor[COLUBK]);
 
-            if((myPF & *mPF) && (myCurrentGRP1 & *mP1))
-              myCollision |= ourCollisionTable[myPFBit | myP1Bit];
+            if((myState->myPF & *mPF) && (myState->myCurrentGRP1 & *mP1))
+              myState->myCollision |= ourCollisionTable[myPFBit | myP1Bit];
 
             ++mPF; ++mP1; ++myFramePointer;
           }
@@ -1618,23 +1679,23 @@ inline void TIA::updateFrameScanline(uint32_t clocksToUpdate, uint32_t hpos)
       // Playfield and Player 1 are enabled and playfield priority is set
       case myPFBit | myP1Bit | PriorityBit:
       {
-        const uint32_t* mPF = &myCurrentPFMask[hpos];
-        const uint8_t* mP1 = &myCurrentP1Mask[hpos];
+        const uint32_t* mPF = &myState->myCurrentPFMask[hpos];
+        const uint8_t* mP1 = &myState->myCurrentP1Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mP1)
           {
-            *(uint32_t*)myFramePointer = (myPF & *mPF) ? myCOLUPF : myCOLUBK;
+            *(uint32_t*)myFramePointer = (myState->myPF & *mPF) ? myState->myColor[COLUPF] : myState->myColor[COLUBK];
             mPF += 4; mP1 += 4; myFramePointer += 4;
           }
           else
           {
-            *myFramePointer = (myPF & *mPF) ? myCOLUPF :
-                ((myCurrentGRP1 & *mP1) ? myCOLUP1 : myCOLUBK);
+            *myFramePointer = (myState->myPF & *mPF) ? myState->myColor[COLUPF] :
+                ((myState->myCurrentGRP1 & *mP1) ? myState->myColor[COLUP1] : myState->myColor[COLUBK]);
 
-            if((myPF & *mPF) && (myCurrentGRP1 & *mP1))
-              myCollision |= ourCollisionTable[myPFBit | myP1Bit];
+            if((myState->myPF & *mPF) && (myState->myCurrentGRP1 & *mP1))
+              myState->myCollision |= ourCollisionTable[myPFBit | myP1Bit];
 
             ++mPF; ++mP1; ++myFramePointer;
           }
@@ -1647,22 +1708,22 @@ inline void TIA::updateFrameScanline(uint32_t clocksToUpdate, uint32_t hpos)
       case myPFBit | myBLBit:
       case myPFBit | myBLBit | PriorityBit:
       {
-        const uint32_t* mPF = &myCurrentPFMask[hpos];
-        const uint8_t* mBL = &myCurrentBLMask[hpos];
+        const uint32_t* mPF = &myState->myCurrentPFMask[hpos];
+        const uint8_t* mBL = &myState->myCurrentBLMask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mBL)
           {
-            *(uint32_t*)myFramePointer = (myPF & *mPF) ? myCOLUPF : myCOLUBK;
+            *(uint32_t*)myFramePointer = (myState->myPF & *mPF) ? myState->myColor[COLUPF] : myState->myColor[COLUBK];
             mPF += 4; mBL += 4; myFramePointer += 4;
           }
           else
           {
-            *myFramePointer = ((myPF & *mPF) || *mBL) ? myCOLUPF : myCOLUBK;
+            *myFramePointer = ((myState->myPF & *mPF) || *mBL) ? myState->myColor[COLUPF] : myState->myColor[COLUBK];
 
-            if((myPF & *mPF) && *mBL)
-              myCollision |= ourCollisionTable[myPFBit | myBLBit];
+            if((myState->myPF & *mPF) && *mBL)
+              myState->myCollision |= ourCollisionTable[myPFBit | myBLBit];
 
             ++mPF; ++mBL; ++myFramePointer;
           }
@@ -1673,28 +1734,32 @@ inline void TIA::updateFrameScanline(uint32_t clocksToUpdate, uint32_t hpos)
       // Handle all of the other cases
       default:
       {
+        // Draw whole vectors with the SIMD renderer, the rest one by one
+        if(myScanlineKernel)
+          hpos += (this->*myScanlineKernel)(clocksToUpdate, hpos, true);
+
         for(; myFramePointer < ending; ++myFramePointer, ++hpos)
         {
-          uint8_t enabled = (myPF & myCurrentPFMask[hpos]) ? myPFBit : 0;
+          uint8_t enabled = (myState->myPF & myState->myCurrentPFMask[hpos]) ? myPFBit : 0;
 
-          if((myEnabledObjects & myBLBit) && myCurrentBLMask[hpos])
+          if((myState->myEnabledObjects & myBLBit) && myState->myCurrentBLMask[hpos])
             enabled |= myBLBit;
 
-          if(myCurrentGRP1 & myCurrentP1Mask[hpos])
+          if(myState->myCurrentGRP1 & myState->myCurrentP1Mask[hpos])
             enabled |= myP1Bit;
 
-          if((myEnabledObjects & myM1Bit) && myCurrentM1Mask[hpos])
+          if((myState->myEnabledObjects & myM1Bit) && myState->myCurrentM1Mask[hpos])
             enabled |= myM1Bit;
 
-          if(myCurrentGRP0 & myCurrentP0Mask[hpos])
+          if(myState->myCurrentGRP0 & myState->myCurrentP0Mask[hpos])
             enabled |= myP0Bit;
 
-          if((myEnabledObjects & myM0Bit) && myCurrentM0Mask[hpos])
+          if((myState->myEnabledObjects & myM0Bit) && myState->myCurrentM0Mask[hpos])
             enabled |= myM0Bit;
 
-          myCollision |= ourCollisionTable[enabled];
-          *myFramePointer = myColor[myPriorityEncoder[hpos < 80 ? 0 : 1]
-              [enabled | myPlayfieldPriorityAndScore]];
+          myState->myCollision |= ourCollisionTable[enabled];
+          *myFramePointer = myState->myColor[ourPriorityEncoder[hpos < 80 ? 0 : 1]
+              [enabled | myState->myPlayfieldPriorityAndScore]];
         }
         break;
       }
@@ -1708,17 +1773,17 @@ inline void TIA::updateFrame(int clock)
 {
   // See if we're in the nondisplayable portion of the screen or if
   // we've already updated this portion of the screen
-  if((clock < myClockStartDisplay) ||
-      (myClockAtLastUpdate >= myClockStopDisplay) ||
-      (myClockAtLastUpdate >= clock))
+  if((clock < myState->myClockStartDisplay) ||
+      (myState->myClockAtLastUpdate >= myState->myClockStopDisplay) ||
+      (myState->myClockAtLastUpdate >= clock))
   {
     return;
   }
 
   // Truncate the number of cycles to update to the stop display point
-  if(clock > myClockStopDisplay)
+  if(clock > myState->myClockStopDisplay)
   {
-    clock = myClockStopDisplay;
+    clock = myState->myClockStopDisplay;
   }
 
   // Update frame one scanline at a time
@@ -1728,22 +1793,22 @@ inline void TIA::updateFrame(int clock)
     int clocksToUpdate = 0;
 
     // Remember how many clocks we are from the left side of the screen
-    int clocksFromStartOfScanLine = 228 - myClocksToEndOfScanLine;
+    int clocksFromStartOfScanLine = 228 - myState->myClocksToEndOfScanLine;
 
     // See if we're updating more than the current scanline
-    if(clock > (myClockAtLastUpdate + myClocksToEndOfScanLine))
+    if(clock > (myState->myClockAtLastUpdate + myState->myClocksToEndOfScanLine))
     {
       // Yes, we have more than one scanline to update so finish current one
-      clocksToUpdate = myClocksToEndOfScanLine;
-      myClocksToEndOfScanLine = 228;
-      myClockAtLastUpdate += clocksToUpdate;
+      clocksToUpdate = myState->myClocksToEndOfScanLine;
+      myState->myClocksToEndOfScanLine = 228;
+      myState->myClockAtLastUpdate += clocksToUpdate;
     }
     else
     {
       // No, so do as much of the current scanline as possible
-      clocksToUpdate = clock - myClockAtLastUpdate;
-      myClocksToEndOfScanLine -= clocksToUpdate;
-      myClockAtLastUpdate = clock;
+      clocksToUpdate = clock - myState->myClockAtLastUpdate;
+      myState->myClocksToEndOfScanLine -= clocksToUpdate;
+      myState->myClockAtLastUpdate = clock;
     }
 
     int startOfScanLine = HBLANK + myFrameXStart;
@@ -1765,10 +1830,26 @@ inline void TIA::updateFrame(int clock)
     // Remember frame pointer in case HMOVE blanks need to be handled
     uint8_t* oldFramePointer = myFramePointer;
 
+    // Find the frame row being drawn.  The frame pointer is into the current
+    // buffer, or into the previous one while a deferred frame is replayed.
+    uint8_t* buffer = 0;
+    int row = 0;
+    if(!fastUpdate)
+    {
+      buffer = (myFramePointer >= myCurrentFrameBuffer &&
+          myFramePointer < myCurrentFrameBuffer + 160 * 300) ?
+          myCurrentFrameBuffer : myPreviousFrameBuffer;
+      row = (myFramePointer - buffer) / 160;
+    }
+
+    // Odd frame rows take the collision-only path when only even rows are
+    // drawn
+    bool skipRow = myEvenLinesOnly && buffer && (row & 1);
+
     // Update as much of the scanline as we can
     if(clocksToUpdate != 0)
     {
-      if (fastUpdate)
+      if (fastUpdate || skipRow)
         updateFrameScanlineFast(clocksToUpdate,
           clocksFromStartOfScanLine - HBLANK);
       else
@@ -1776,76 +1857,109 @@ inline void TIA::updateFrame(int clock)
     }
 
     // Handle HMOVE blanks if they are enabled
-    if(myHMOVEBlankEnabled && (startOfScanLine < HBLANK + 8) &&
+    if(myState->myHMOVEBlankEnabled && (startOfScanLine < HBLANK + 8) &&
         (clocksFromStartOfScanLine < (HBLANK + 8)))
     {
       int blanks = (HBLANK + 8) - clocksFromStartOfScanLine;
       std::memset(oldFramePointer, 0, blanks);
+      invalidateRowHash(oldFramePointer);
 
       if((clocksToUpdate + clocksFromStartOfScanLine) >= (HBLANK + 8))
       {
-        myHMOVEBlankEnabled = false;
+        myState->myHMOVEBlankEnabled = false;
       }
     }
 
+    // A row is only hashed once it is finished (which the last row of the
+    // display never is), so forget any hash it had while it is being drawn
+    if(buffer && myState->myClocksToEndOfScanLine != 228)
+      rowHashesOf(buffer)->valid[row >> 6] &= ~(uint64_t(1) << (row & 63));
+
     // See if we're at the end of a scanline
-    if(myClocksToEndOfScanLine == 228)
+    if(myState->myClocksToEndOfScanLine == 228)
     {
       myFramePointer -= (160 - myFrameWidth - myFrameXStart);
 
+      // Fill a skipped row with the row above it
+      if(skipRow)
+      {
+        uint8_t* line = buffer + row * 160;
+        std::memcpy(line, line - 160, 160);
+      }
+
+      // Clear the row's dirty bit if it came out the same as last frame's
+      // (not in a frame that was greyed out and continued), then hash it;
+      // an unchanged row has the hash of last frame's row
+      if(buffer)
+      {
+        uint64_t bit = uint64_t(1) << (row & 63);
+        RowHashes* hashes = rowHashesOf(buffer);
+        bool same = buffer == myCurrentFrameBuffer && !myFrameGreyed &&
+            std::memcmp(buffer + row * 160, myPreviousFrameBuffer + row * 160,
+                        160) == 0;
+        if(same)
+          myDirtyRows[row >> 6] &= ~bit;
+
+        if(same && (myPreviousRowHashes->valid[row >> 6] & bit))
+          hashes->hash[row] = myPreviousRowHashes->hash[row];
+        else
+          hashes->hash[row] = ale::hashScreenRow(buffer + row * 160, 160);
+        hashes->valid[row >> 6] |= bit;
+      }
+
       // Yes, so set PF mask based on current CTRLPF reflection state
-      myCurrentPFMask = ourPlayfieldTable[myCTRLPF & 0x01];
+      myState->myCurrentPFMask = ourPlayfieldTable[myState->myCTRLPF & 0x01];
 
       // TODO: These should be reset right after the first copy of the player
       // has passed.  However, for now we'll just reset at the end of the
       // scanline since the other way would be to slow (01/21/99).
-      myCurrentP0Mask = &ourPlayerMaskTable[myPOSP0 & 0x03]
-          [0][myNUSIZ0 & 0x07][160 - (myPOSP0 & 0xFC)];
-      myCurrentP1Mask = &ourPlayerMaskTable[myPOSP1 & 0x03]
-          [0][myNUSIZ1 & 0x07][160 - (myPOSP1 & 0xFC)];
+      myState->myCurrentP0Mask = &ourPlayerMaskTable[myState->myPOSP0 & 0x03]
+          [0][myState->myNUSIZ0 & 0x07][160 - (myState->myPOSP0 & 0xFC)];
+      myState->myCurrentP1Mask = &ourPlayerMaskTable[myState->myPOSP1 & 0x03]
+          [0][myState->myNUSIZ1 & 0x07][160 - (myState->myPOSP1 & 0xFC)];
 
       // Handle the "Cosmic Ark" TIA bug if it's enabled
-      if(myM0CosmicArkMotionEnabled)
+      if(myState->myM0CosmicArkMotionEnabled)
       {
         // Movement table associated with the bug
         static uint32_t m[4] = {18, 33, 0, 17};
 
-        myM0CosmicArkCounter = (myM0CosmicArkCounter + 1) & 3;
-        myPOSM0 -= m[myM0CosmicArkCounter];
+        myState->myM0CosmicArkCounter = (myState->myM0CosmicArkCounter + 1) & 3;
+        myState->myPOSM0 -= m[myState->myM0CosmicArkCounter];
 
-        if(myPOSM0 >= 160)
-          myPOSM0 -= 160;
-        else if(myPOSM0 < 0)
-          myPOSM0 += 160;
+        if(myState->myPOSM0 >= 160)
+          myState->myPOSM0 -= 160;
+        else if(myState->myPOSM0 < 0)
+          myState->myPOSM0 += 160;
 
-        if(myM0CosmicArkCounter == 1)
+        if(myState->myM0CosmicArkCounter == 1)
         {
           // Stretch this missle so it's at least 2 pixels wide
-          myCurrentM0Mask = &ourMissleMaskTable[myPOSM0 & 0x03]
-              [myNUSIZ0 & 0x07][((myNUSIZ0 & 0x30) >> 4) | 0x01]
-              [160 - (myPOSM0 & 0xFC)];
+          myState->myCurrentM0Mask = &ourMissleMaskTable[myState->myPOSM0 & 0x03]
+              [myState->myNUSIZ0 & 0x07][((myState->myNUSIZ0 & 0x30) >> 4) | 0x01]
+              [160 - (myState->myPOSM0 & 0xFC)];
         }
-        else if(myM0CosmicArkCounter == 2)
+        else if(myState->myM0CosmicArkCounter == 2)
         {
           // Missle is disabled on this line
-          myCurrentM0Mask = &ourDisabledMaskTable[0];
+          myState->myCurrentM0Mask = &ourDisabledMaskTable[0];
         }
         else
         {
-          myCurrentM0Mask = &ourMissleMaskTable[myPOSM0 & 0x03]
-              [myNUSIZ0 & 0x07][(myNUSIZ0 & 0x30) >> 4][160 - (myPOSM0 & 0xFC)];
+          myState->myCurrentM0Mask = &ourMissleMaskTable[myState->myPOSM0 & 0x03]
+              [myState->myNUSIZ0 & 0x07][(myState->myNUSIZ0 & 0x30) >> 4][160 - (myState->myPOSM0 & 0xFC)];
         }
       }
     }
   }
-  while(myClockAtLastUpdate < clock);
+  while(myState->myClockAtLastUpdate < clock);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline void TIA::waitHorizontalSync()
 {
   uint32_t cyclesToEndOfLine = 76 - ((mySystem->cycles() -
-      (myClockWhenFrameStarted / 3)) % 76);
+      (myState->myClockWhenFrameStarted / 3)) % 76);
 
   if(cyclesToEndOfLine < 76)
   {
@@ -1866,6 +1980,9 @@ void TIA::greyOutFrame()
           myCurrentFrameBuffer[ (s - myYStart) * 160 + i] = tmp;
       }
 
+  for(int i = 0; i < DirtyRowWords; ++i)
+    myCurrentRowHashes->valid[i] = 0;
+
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1875,6 +1992,7 @@ void TIA::clearBuffers()
   {
     myCurrentFrameBuffer[i] = myPreviousFrameBuffer[i] = 0;
   }
+  invalidateRowHashes();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1888,35 +2006,35 @@ uint8_t TIA::peek(uint16_t addr)
   switch(addr & 0x000f)
   {
     case 0x00:    // CXM0P
-      return ((myCollision & 0x0001) ? 0x80 : 0x00) |
-          ((myCollision & 0x0002) ? 0x40 : 0x00) | noise;
+      return ((myState->myCollision & 0x0001) ? 0x80 : 0x00) |
+          ((myState->myCollision & 0x0002) ? 0x40 : 0x00) | noise;
 
     case 0x01:    // CXM1P
-      return ((myCollision & 0x0004) ? 0x80 : 0x00) |
-          ((myCollision & 0x0008) ? 0x40 : 0x00) | noise;
+      return ((myState->myCollision & 0x0004) ? 0x80 : 0x00) |
+          ((myState->myCollision & 0x0008) ? 0x40 : 0x00) | noise;
 
     case 0x02:    // CXP0FB
-      return ((myCollision & 0x0010) ? 0x80 : 0x00) |
-          ((myCollision & 0x0020) ? 0x40 : 0x00) | noise;
+      return ((myState->myCollision & 0x0010) ? 0x80 : 0x00) |
+          ((myState->myCollision & 0x0020) ? 0x40 : 0x00) | noise;
 
     case 0x03:    // CXP1FB
-      return ((myCollision & 0x0040) ? 0x80 : 0x00) |
-          ((myCollision & 0x0080) ? 0x40 : 0x00) | noise;
+      return ((myState->myCollision & 0x0040) ? 0x80 : 0x00) |
+          ((myState->myCollision & 0x0080) ? 0x40 : 0x00) | noise;
 
     case 0x04:    // CXM0FB
-      return ((myCollision & 0x0100) ? 0x80 : 0x00) |
-          ((myCollision & 0x0200) ? 0x40 : 0x00) | noise;
+      return ((myState->myCollision & 0x0100) ? 0x80 : 0x00) |
+          ((myState->myCollision & 0x0200) ? 0x40 : 0x00) | noise;
 
     case 0x05:    // CXM1FB
-      return ((myCollision & 0x0400) ? 0x80 : 0x00) |
-          ((myCollision & 0x0800) ? 0x40 : 0x00) | noise;
+      return ((myState->myCollision & 0x0400) ? 0x80 : 0x00) |
+          ((myState->myCollision & 0x0800) ? 0x40 : 0x00) | noise;
 
     case 0x06:    // CXBLPF
-      return ((myCollision & 0x1000) ? 0x80 : 0x00) | noise;
+      return ((myState->myCollision & 0x1000) ? 0x80 : 0x00) | noise;
 
     case 0x07:    // CXPPMM
-      return ((myCollision & 0x2000) ? 0x80 : 0x00) |
-          ((myCollision & 0x4000) ? 0x40 : 0x00) | noise;
+      return ((myState->myCollision & 0x2000) ? 0x80 : 0x00) |
+          ((myState->myCollision & 0x4000) ? 0x40 : 0x00) | noise;
 
     case 0x08:    // INPT0
     {
@@ -1925,7 +2043,7 @@ uint8_t TIA::peek(uint16_t addr)
       {
         return 0x80 | noise;
       }
-      else if((r == Controller::maximumResistance) || myDumpEnabled)
+      else if((r == Controller::maximumResistance) || myState->myDumpEnabled)
       {
         return noise;
       }
@@ -1933,7 +2051,7 @@ uint8_t TIA::peek(uint16_t addr)
       {
         double t = (1.6 * r * 0.01E-6);
         uint32_t needed = (uint32_t)(t * 1.19E6);
-        if(mySystem->cycles() > (myDumpDisabledCycle + needed))
+        if(mySystem->cycles() > (myState->myDumpDisabledCycle + needed))
         {
           return 0x80 | noise;
         }
@@ -1951,7 +2069,7 @@ uint8_t TIA::peek(uint16_t addr)
       {
         return 0x80 | noise;
       }
-      else if((r == Controller::maximumResistance) || myDumpEnabled)
+      else if((r == Controller::maximumResistance) || myState->myDumpEnabled)
       {
         return noise;
       }
@@ -1959,7 +2077,7 @@ uint8_t TIA::peek(uint16_t addr)
       {
         double t = (1.6 * r * 0.01E-6);
         uint32_t needed = (uint32_t)(t * 1.19E6);
-        if(mySystem->cycles() > (myDumpDisabledCycle + needed))
+        if(mySystem->cycles() > (myState->myDumpDisabledCycle + needed))
         {
           return 0x80 | noise;
         }
@@ -1977,7 +2095,7 @@ uint8_t TIA::peek(uint16_t addr)
       {
         return 0x80 | noise;
       }
-      else if((r == Controller::maximumResistance) || myDumpEnabled)
+      else if((r == Controller::maximumResistance) || myState->myDumpEnabled)
       {
         return noise;
       }
@@ -1985,7 +2103,7 @@ uint8_t TIA::peek(uint16_t addr)
       {
         double t = (1.6 * r * 0.01E-6);
         uint32_t needed = (uint32_t)(t * 1.19E6);
-        if(mySystem->cycles() > (myDumpDisabledCycle + needed))
+        if(mySystem->cycles() > (myState->myDumpDisabledCycle + needed))
         {
           return 0x80 | noise;
         }
@@ -2003,7 +2121,7 @@ uint8_t TIA::peek(uint16_t addr)
       {
         return 0x80 | noise;
       }
-      else if((r == Controller::maximumResistance) || myDumpEnabled)
+      else if((r == Controller::maximumResistance) || myState->myDumpEnabled)
       {
         return noise;
       }
@@ -2011,7 +2129,7 @@ uint8_t TIA::peek(uint16_t addr)
       {
         double t = (1.6 * r * 0.01E-6);
         uint32_t needed = (uint32_t)(t * 1.19E6);
-        if(mySystem->cycles() > (myDumpDisabledCycle + needed))
+        if(mySystem->cycles() > (myState->myDumpDisabledCycle + needed))
         {
           return 0x80 | noise;
         }
@@ -2043,14 +2161,22 @@ void TIA::poke(uint16_t addr, uint8_t value)
 {
   addr = addr & 0x003f;
 
-  int clock = mySystem->cycles() * 3;
+  uint32_t cycles = myReplaying ? myReplayCycles : mySystem->cycles();
+  int clock = cycles * 3;
   int16_t delay = ourPokeDelayTable[addr];
 
+  // Remember video register writes so the frame can be drawn later
+  if(myDeferredRendering && !myReplaying && (addr < 0x15 || addr > 0x1A))
+  {
+    PokeRecord record = { cycles, (uint8_t)addr, value };
+    myFrameLogs[0].pokes.push_back(record);
+  }
+
   // See if this is a poke to a PF register
   if(delay == -1)
   {
     static uint32_t d[4] = {4, 5, 2, 3};
-    int x = ((clock - myClockWhenFrameStarted) % 228);
+    int x = ((clock - myState->myClockWhenFrameStarted) % 228);
     delay = d[(x / 3) & 3];
   }
 
@@ -2058,7 +2184,8 @@ void TIA::poke(uint16_t addr, uint8_t value)
   updateFrame(clock + delay);
 
   // If a VSYNC hasn't been generated in time go ahead and end the frame
-  if(((clock - myClockWhenFrameStarted) / 228) > myMaximumNumberOfScanlines)
+  if(!myReplaying &&
+     ((clock - myState->myClockWhenFrameStarted) / 228) > myMaximumNumberOfScanlines)
   {
     mySystem->m6502().stop();
      myPartialFrameFlag = false;
@@ -2068,23 +2195,26 @@ void TIA::poke(uint16_t addr, uint8_t value)
   {
     case 0x00:    // Vertical sync set-clear
     {
-      myVSYNC = value;
+      myState->myVSYNC = value;
 
-      if(myVSYNC & 0x02)
+      if(myState->myVSYNC & 0x02)
       {
         // Indicate when VSYNC should be finished.  This should really
         // be 3 * 228 according to Atari's documentation, however, some
         // games don't supply the full 3 scanlines of VSYNC.
-        myVSYNCFinishClock = clock + 228;
+        myState->myVSYNCFinishClock = clock + 228;
       }
-      else if(!(myVSYNC & 0x02) && (clock >= myVSYNCFinishClock))
+      else if(!(myState->myVSYNC & 0x02) && (clock >= myState->myVSYNCFinishClock))
       {
         // We're no longer interested in myVSYNCFinishClock
-        myVSYNCFinishClock = 0x7FFFFFFF;
+        myState->myVSYNCFinishClock = 0x7FFFFFFF;
 
         // Since we're finished with the frame tell the processor to halt
-        mySystem->m6502().stop();
-         myPartialFrameFlag = false;
+        if(!myReplaying)
+        {
+          mySystem->m6502().stop();
+          myPartialFrameFlag = false;
+        }
       }
       break;
     }
@@ -2092,19 +2222,19 @@ void TIA::poke(uint16_t addr, uint8_t value)
     case 0x01:    // Vertical blank set-clear
     {
       // Is the dump to ground path being set for I0, I1, I2, and I3?
-      if(!(myVBLANK & 0x80) && (value & 0x80))
+      if(!(myState->myVBLANK & 0x80) && (value & 0x80))
       {
-        myDumpEnabled = true;
+        myState->myDumpEnabled = true;
       }
 
       // Is the dump to ground path being removed from I0, I1, I2, and I3?
-      if((myVBLANK & 0x80) && !(value & 0x80))
+      if((myState->myVBLANK & 0x80) && !(value & 0x80))
       {
-        myDumpEnabled = false;
-        myDumpDisabledCycle = mySystem->cycles();
+        myState->myDumpEnabled = false;
+        myState->myDumpDisabledCycle = cycles;
       }
 
-      myVBLANK = value;
+      myState->myVBLANK = value;
       break;
     }
 
@@ -2117,7 +2247,7 @@ void TIA::poke(uint16_t addr, uint8_t value)
       // TODO - 08-30-2006: This halting isn't correct since it's
       // still halting on the original write.  The 6507 emulation
       // should be expanded to include a READY line.
-      if(mySystem->m6502().lastAccessWasRead())
+      if(!myReplaying && mySystem->m6502().lastAccessWasRead())
       {
         // Tell the cpu to waste the necessary amount of time
         waitHorizontalSync();
@@ -2133,32 +2263,32 @@ void TIA::poke(uint16_t addr, uint8_t value)
 
     case 0x04:    // Number-size of player-missle 0
     {
-      myNUSIZ0 = value;
+      myState->myNUSIZ0 = value;
 
       // TODO: Technically the "enable" part, [0], should depend on the current
       // enabled or disabled state.  This mean we probably need a data member
       // to maintain that state (01/21/99).
-      myCurrentP0Mask = &ourPlayerMaskTable[myPOSP0 & 0x03]
-          [0][myNUSIZ0 & 0x07][160 - (myPOSP0 & 0xFC)];
+      myState->myCurrentP0Mask = &ourPlayerMaskTable[myState->myPOSP0 & 0x03]
+          [0][myState->myNUSIZ0 & 0x07][160 - (myState->myPOSP0 & 0xFC)];
 
-      myCurrentM0Mask = &ourMissleMaskTable[myPOSM0 & 0x03]
-          [myNUSIZ0 & 0x07][(myNUSIZ0 & 0x30) >> 4][160 - (myPOSM0 & 0xFC)];
+      myState->myCurrentM0Mask = &ourMissleMaskTable[myState->myPOSM0 & 0x03]
+          [myState->myNUSIZ0 & 0x07][(myState->myNUSIZ0 & 0x30) >> 4][160 - (myState->myPOSM0 & 0xFC)];
 
       break;
     }
 
     case 0x05:    // Number-size of player-missle 1
     {
-      myNUSIZ1 = value;
+      myState->myNUSIZ1 = value;
 
       // TODO: Technically the "enable" part, [0], should depend on the current
       // enabled or disabled state.  This mean we probably need a data member
       // to maintain that state (01/21/99).
-      myCurrentP1Mask = &ourPlayerMaskTable[myPOSP1 & 0x03]
-          [0][myNUSIZ1 & 0x07][160 - (myPOSP1 & 0xFC)];
+      myState->myCurrentP1Mask = &ourPlayerMaskTable[myState->myPOSP1 & 0x03]
+          [0][myState->myNUSIZ1 & 0x07][160 - (myState->myPOSP1 & 0xFC)];
 
-      myCurrentM1Mask = &ourMissleMaskTable[myPOSM1 & 0x03]
-          [myNUSIZ1 & 0x07][(myNUSIZ1 & 0x30) >> 4][160 - (myPOSM1 & 0xFC)];
+      myState->myCurrentM1Mask = &ourMissleMaskTable[myState->myPOSM1 & 0x03]
+          [myState->myNUSIZ1 & 0x07][(myState->myNUSIZ1 & 0x30) >> 4][160 - (myState->myPOSM1 & 0xFC)];
 
       break;
     }
@@ -2166,65 +2296,65 @@ void TIA::poke(uint16_t addr, uint8_t value)
     case 0x06:    // Color-Luminance Player 0
     {
       uint32_t color = (uint32_t)(value & 0xfe);
-      if(myColorLossEnabled && (myScanlineCountForLastFrame & 0x01))
+      if(myColorLossEnabled && (myState->myScanlineCountForLastFrame & 0x01))
       {
         color |= 0x01;
       }
-      myCOLUP0 = (((((color << 8) | color) << 8) | color) << 8) | color;
+      myState->myColor[COLUP0] = (((((color << 8) | color) << 8) | color) << 8) | color;
       break;
     }
 
     case 0x07:    // Color-Luminance Player 1
     {
       uint32_t color = (uint32_t)(value & 0xfe);
-      if(myColorLossEnabled && (myScanlineCountForLastFrame & 0x01))
+      if(myColorLossEnabled && (myState->myScanlineCountForLastFrame & 0x01))
       {
         color |= 0x01;
       }
-      myCOLUP1 = (((((color << 8) | color) << 8) | color) << 8) | color;
+      myState->myColor[COLUP1] = (((((color << 8) | color) << 8) | color) << 8) | color;
       break;
     }
 
     case 0x08:    // Color-Luminance Playfield
     {
       uint32_t color = (uint32_t)(value & 0xfe);
-      if(myColorLossEnabled && (myScanlineCountForLastFrame & 0x01))
+      if(myColorLossEnabled && (myState->myScanlineCountForLastFrame & 0x01))
       {
         color |= 0x01;
       }
-      myCOLUPF = (((((color << 8) | color) << 8) | color) << 8) | color;
+      myState->myColor[COLUPF] = (((((color << 8) | color) << 8) | color) << 8) | color;
       break;
     }
 
     case 0x09:    // Color-Luminance Background
     {
       uint32_t color = (uint32_t)(value & 0xfe);
-      if(myColorLossEnabled && (myScanlineCountForLastFrame & 0x01))
+      if(myColorLossEnabled && (myState->myScanlineCountForLastFrame & 0x01))
       {
         color |= 0x01;
       }
-      myCOLUBK = (((((color << 8) | color) << 8) | color) << 8) | color;
+      myState->myColor[COLUBK] = (((((color << 8) | color) << 8) | color) << 8) | color;
       break;
     }
 
     case 0x0A:    // Control Playfield, Ball size, Collisions
     {
-      myCTRLPF = value;
+      myState->myCTRLPF = value;
 
       // The playfield priority and score bits from the control register
       // are accessed when the frame is being drawn.  We precompute the
       // necessary value here so we can save time while drawing.
-      myPlayfieldPriorityAndScore = ((myCTRLPF & 0x06) << 5);
+      myState->myPlayfieldPriorityAndScore = ((myState->myCTRLPF & 0x06) << 5);
 
       // Update the playfield mask based on reflection state if
       // we're still on the left hand side of the playfield
-      if(((clock - myClockWhenFrameStarted) % 228) < (68 + 79))
+      if(((clock - myState->myClockWhenFrameStarted) % 228) < (68 + 79))
       {
-        myCurrentPFMask = ourPlayfieldTable[myCTRLPF & 0x01];
+        myState->myCurrentPFMask = ourPlayfieldTable[myState->myCTRLPF & 0x01];
       }
 
-      myCurrentBLMask = &ourBallMaskTable[myPOSBL & 0x03]
-          [(myCTRLPF & 0x30) >> 4][160 - (myPOSBL & 0xFC)];
+      myState->myCurrentBLMask = &ourBallMaskTable[myState->myPOSBL & 0x03]
+          [(myState->myCTRLPF & 0x30) >> 4][160 - (myState->myPOSBL & 0xFC)];
 
       break;
     }
@@ -2232,10 +2362,10 @@ void TIA::poke(uint16_t addr, uint8_t value)
     case 0x0B:    // Reflect Player 0
     {
       // See if the reflection state of the player is being changed
-      if(((value & 0x08) && !myREFP0) || (!(value & 0x08) && myREFP0))
+      if(((value & 0x08) && !myState->myREFP0) || (!(value & 0x08) && myState->myREFP0))
       {
-        myREFP0 = (value & 0x08);
-        myCurrentGRP0 = ourPlayerReflectTable[myCurrentGRP0];
+        myState->myREFP0 = (value & 0x08);
+        myState->myCurrentGRP0 = ourPlayerReflectTable[myState->myCurrentGRP0];
       }
       break;
     }
@@ -2243,57 +2373,57 @@ void TIA::poke(uint16_t addr, uint8_t value)
     case 0x0C:    // Reflect Player 1
     {
       // See if the reflection state of the player is being changed
-      if(((value & 0x08) && !myREFP1) || (!(value & 0x08) && myREFP1))
+      if(((value & 0x08) && !myState->myREFP1) || (!(value & 0x08) && myState->myREFP1))
       {
-        myREFP1 = (value & 0x08);
-        myCurrentGRP1 = ourPlayerReflectTable[myCurrentGRP1];
+        myState->myREFP1 = (value & 0x08);
+        myState->myCurrentGRP1 = ourPlayerReflectTable[myState->myCurrentGRP1];
       }
       break;
     }
 
     case 0x0D:    // Playfield register byte 0
     {
-      myPF = (myPF & 0x000FFFF0) | ((value >> 4) & 0x0F);
+      myState->myPF = (myState->myPF & 0x000FFFF0) | ((value >> 4) & 0x0F);
 
-      if(!myBitEnabled[TIA::PF] || myPF == 0)
-        myEnabledObjects &= ~myPFBit;
+      if(!myBitEnabled[TIA::PF] || myState->myPF == 0)
+        myState->myEnabledObjects &= ~myPFBit;
       else
-        myEnabledObjects |= myPFBit;
+        myState->myEnabledObjects |= myPFBit;
 
       break;
     }
 
     case 0x0E:    // Playfield register byte 1
     {
-      myPF = (myPF & 0x000FF00F) | ((uint32_t)value << 4);
+      myState->myPF = (myState->myPF & 0x000FF00F) | ((uint32_t)value << 4);
 
-      if(!myBitEnabled[TIA::PF] || myPF == 0)
-        myEnabledObjects &= ~myPFBit;
+      if(!myBitEnabled[TIA::PF] || myState->myPF == 0)
+        myState->myEnabledObjects &= ~myPFBit;
       else
-        myEnabledObjects |= myPFBit;
+        myState->myEnabledObjects |= myPFBit;
 
       break;
     }
 
     case 0x0F:    // Playfield register byte 2
     {
-      myPF = (myPF & 0x00000FFF) | ((uint32_t)value << 12);
+      myState->myPF = (myState->myPF & 0x00000FFF) | ((uint32_t)value << 12);
 
-      if(!myBitEnabled[TIA::PF] || myPF == 0)
-        myEnabledObjects &= ~myPFBit;
+      if(!myBitEnabled[TIA::PF] || myState->myPF == 0)
+        myState->myEnabledObjects &= ~myPFBit;
       else
-        myEnabledObjects |= myPFBit;
+        myState->myEnabledObjects |= myPFBit;
 
       break;
     }
 
     case 0x10:    // Reset Player 0
     {
-      int hpos = (clock - myClockWhenFrameStarted) % 228;
+      int hpos = (clock - myState->myClockWhenFrameStarted) % 228;
       int newx = hpos < HBLANK ? 3 : (((hpos - HBLANK) + 5) % 160);
 
       // Find out under what condition the player is being reset
-      int8_t when = ourPlayerPositionResetWhenTable[myNUSIZ0 & 7][myPOSP0][newx];
+      int8_t when = ourPlayerPositionResetWhenTable[myState->myNUSIZ0 & 7][myState->myPOSP0][newx];
 
       // Player is being reset during the display of one of its copies
       if(when == 1)
@@ -2304,40 +2434,40 @@ void TIA::poke(uint16_t addr, uint8_t value)
         // delay by instead of just 1 (01/21/99).
         updateFrame(clock + 11);
 
-        myPOSP0 = newx;
+        myState->myPOSP0 = newx;
 
         // Setup the mask to skip the first copy of the player
-        myCurrentP0Mask = &ourPlayerMaskTable[myPOSP0 & 0x03]
-            [1][myNUSIZ0 & 0x07][160 - (myPOSP0 & 0xFC)];
+        myState->myCurrentP0Mask = &ourPlayerMaskTable[myState->myPOSP0 & 0x03]
+            [1][myState->myNUSIZ0 & 0x07][160 - (myState->myPOSP0 & 0xFC)];
       }
       // Player is being reset in neither the delay nor display section
       else if(when == 0)
       {
-        myPOSP0 = newx;
+        myState->myPOSP0 = newx;
 
         // So we setup the mask to skip the first copy of the player
-        myCurrentP0Mask = &ourPlayerMaskTable[myPOSP0 & 0x03]
-            [1][myNUSIZ0 & 0x07][160 - (myPOSP0 & 0xFC)];
+        myState->myCurrentP0Mask = &ourPlayerMaskTable[myState->myPOSP0 & 0x03]
+            [1][myState->myNUSIZ0 & 0x07][160 - (myState->myPOSP0 & 0xFC)];
       }
       // Player is being reset during the delay section of one of its copies
       else if(when == -1)
       {
-        myPOSP0 = newx;
+        myState->myPOSP0 = newx;
 
         // So we setup the mask to display all copies of the player
-        myCurrentP0Mask = &ourPlayerMaskTable[myPOSP0 & 0x03]
-            [0][myNUSIZ0 & 0x07][160 - (myPOSP0 & 0xFC)];
+        myState->myCurrentP0Mask = &ourPlayerMaskTable[myState->myPOSP0 & 0x03]
+            [0][myState->myNUSIZ0 & 0x07][160 - (myState->myPOSP0 & 0xFC)];
       }
       break;
     }
 
     case 0x11:    // Reset Player 1
     {
-      int hpos = (clock - myClockWhenFrameStarted) % 228;
+      int hpos = (clock - myState->myClockWhenFrameStarted) % 228;
       int newx = hpos < HBLANK ? 3 : (((hpos - HBLANK) + 5) % 160);
 
       // Find out under what condition the player is being reset
-      int8_t when = ourPlayerPositionResetWhenTable[myNUSIZ1 & 7][myPOSP1][newx];
+      int8_t when = ourPlayerPositionResetWhenTable[myState->myNUSIZ1 & 7][myState->myPOSP1][newx];
 
       // Player is being reset during the display of one of its copies
       if(when == 1)
@@ -2348,177 +2478,183 @@ void TIA::poke(uint16_t addr, uint8_t value)
         // delay by instead of just 1 (01/21/99).
         updateFrame(clock + 11);
 
-        myPOSP1 = newx;
+        myState->myPOSP1 = newx;
 
         // Setup the mask to skip the first copy of the player
-        myCurrentP1Mask = &ourPlayerMaskTable[myPOSP1 & 0x03]
-            [1][myNUSIZ1 & 0x07][160 - (myPOSP1 & 0xFC)];
+        myState->myCurrentP1Mask = &ourPlayerMaskTable[myState->myPOSP1 & 0x03]
+            [1][myState->myNUSIZ1 & 0x07][160 - (myState->myPOSP1 & 0xFC)];
       }
       // Player is being reset in neither the delay nor display section
       else if(when == 0)
       {
-        myPOSP1 = newx;
+        myState->myPOSP1 = newx;
 
         // So we setup the mask to skip the first copy of the player
-        myCurrentP1Mask = &ourPlayerMaskTable[myPOSP1 & 0x03]
-            [1][myNUSIZ1 & 0x07][160 - (myPOSP1 & 0xFC)];
+        myState->myCurrentP1Mask = &ourPlayerMaskTable[myState->myPOSP1 & 0x03]
+            [1][myState->myNUSIZ1 & 0x07][160 - (myState->myPOSP1 & 0xFC)];
       }
       // Player is being reset during the delay section of one of its copies
       else if(when == -1)
       {
-        myPOSP1 = newx;
+        myState->myPOSP1 = newx;
 
         // So we setup the mask to display all copies of the player
-        myCurrentP1Mask = &ourPlayerMaskTable[myPOSP1 & 0x03]
-            [0][myNUSIZ1 & 0x07][160 - (myPOSP1 & 0xFC)];
+        myState->myCurrentP1Mask = &ourPlayerMaskTable[myState->myPOSP1 & 0x03]
+            [0][myState->myNUSIZ1 & 0x07][160 - (myState->myPOSP1 & 0xFC)];
       }
       break;
     }
 
     case 0x12:    // Reset Missle 0
     {
-      int hpos = (clock - myClockWhenFrameStarted) % 228;
-      myPOSM0 = hpos < HBLANK ? 2 : (((hpos - HBLANK) + 4) % 160);
+      int hpos = (clock - myState->myClockWhenFrameStarted) % 228;
+      myState->myPOSM0 = hpos < HBLANK ? 2 : (((hpos - HBLANK) + 4) % 160);
 
       // TODO: Remove the following special hack for Dolphin by
       // figuring out what really happens when Reset Missle
       // occurs 20 cycles after an HMOVE (04/13/02).
-      if(((clock - myLastHMOVEClock) == (20 * 3)) && (hpos == 69))
+      if(((clock - myState->myLastHMOVEClock) == (20 * 3)) && (hpos == 69))
       {
-        myPOSM0 = 8;
+        myState->myPOSM0 = 8;
       }
 
-      myCurrentM0Mask = &ourMissleMaskTable[myPOSM0 & 0x03]
-          [myNUSIZ0 & 0x07][(myNUSIZ0 & 0x30) >> 4][160 - (myPOSM0 & 0xFC)];
+      myState->myCurrentM0Mask = &ourMissleMaskTable[myState->myPOSM0 & 0x03]
+          [myState->myNUSIZ0 & 0x07][(myState->myNUSIZ0 & 0x30) >> 4][160 - (myState->myPOSM0 & 0xFC)];
       break;
     }
 
     case 0x13:    // Reset Missle 1
     {
-      int hpos = (clock - myClockWhenFrameStarted) % 228;
-      myPOSM1 = hpos < HBLANK ? 2 : (((hpos - HBLANK) + 4) % 160);
+      int hpos = (clock - myState->myClockWhenFrameStarted) % 228;
+      myState->myPOSM1 = hpos < HBLANK ? 2 : (((hpos - HBLANK) + 4) % 160);
 
       // TODO: Remove the following special hack for Pitfall II by
       // figuring out what really happens when Reset Missle
       // occurs 3 cycles after an HMOVE (04/13/02).
-      if(((clock - myLastHMOVEClock) == (3 * 3)) && (hpos == 18))
+      if(((clock - myState->myLastHMOVEClock) == (3 * 3)) && (hpos == 18))
       {
-        myPOSM1 = 3;
+        myState->myPOSM1 = 3;
       }
 
-      myCurrentM1Mask = &ourMissleMaskTable[myPOSM1 & 0x03]
-          [myNUSIZ1 & 0x07][(myNUSIZ1 & 0x30) >> 4][160 - (myPOSM1 & 0xFC)];
+      myState->myCurrentM1Mask = &ourMissleMaskTable[myState->myPOSM1 & 0x03]
+          [myState->myNUSIZ1 & 0x07][(myState->myNUSIZ1 & 0x30) >> 4][160 - (myState->myPOSM1 & 0xFC)];
       break;
     }
 
     case 0x14:    // Reset Ball
     {
-      int hpos = (clock - myClockWhenFrameStarted) % 228 ;
-      myPOSBL = hpos < HBLANK ? 2 : (((hpos - HBLANK) + 4) % 160);
+      int hpos = (clock - myState->myClockWhenFrameStarted) % 228 ;
+      myState->myPOSBL = hpos < HBLANK ? 2 : (((hpos - HBLANK) + 4) % 160);
 
       // TODO: Remove the following special hack for Escape from the
       // Mindmaster by figuring out what really happens when Reset Ball
       // occurs 18 cycles after an HMOVE (01/09/99).
-      if(((clock - myLastHMOVEClock) == (18 * 3)) &&
+      if(((clock - myState->myLastHMOVEClock) == (18 * 3)) &&
           ((hpos == 60) || (hpos == 69)))
       {
-        myPOSBL = 10;
+        myState->myPOSBL = 10;
       }
       // TODO: Remove the following special hack for Decathlon by
       // figuring out what really happens when Reset Ball
       // occurs 3 cycles after an HMOVE (04/13/02).
-      else if(((clock - myLastHMOVEClock) == (3 * 3)) && (hpos == 18))
+      else if(((clock - myState->myLastHMOVEClock) == (3 * 3)) && (hpos == 18))
       {
-        myPOSBL = 3;
+        myState->myPOSBL = 3;
       }
       // TODO: Remove the following special hack for Robot Tank by
       // figuring out what really happens when Reset Ball
       // occurs 7 cycles after an HMOVE (04/13/02).
-      else if(((clock - myLastHMOVEClock) == (7 * 3)) && (hpos == 30))
+      else if(((clock - myState->myLastHMOVEClock) == (7 * 3)) && (hpos == 30))
       {
-        myPOSBL = 6;
+        myState->myPOSBL = 6;
       }
       // TODO: Remove the following special hack for Hole Hunter by
       // figuring out what really happens when Reset Ball
       // occurs 6 cycles after an HMOVE (04/13/02).
-      else if(((clock - myLastHMOVEClock) == (6 * 3)) && (hpos == 27))
+      else if(((clock - myState->myLastHMOVEClock) == (6 * 3)) && (hpos == 27))
       {
-        myPOSBL = 5;
+        myState->myPOSBL = 5;
       }
 
-      myCurrentBLMask = &ourBallMaskTable[myPOSBL & 0x03]
-          [(myCTRLPF & 0x30) >> 4][160 - (myPOSBL & 0xFC)];
+      myState->myCurrentBLMask = &ourBallMaskTable[myState->myPOSBL & 0x03]
+          [(myState->myCTRLPF & 0x30) >> 4][160 - (myState->myPOSBL & 0xFC)];
       break;
     }
 
     case 0x15:    // Audio control 0
     {
       myAUDC0 = value & 0x0f;
-      mySound->set(addr, value, mySystem->cycles());
+      if(mySoundEnabled)
+        mySound->set(addr, value, mySystem->cycles());
       break;
     }
 
     case 0x16:    // Audio control 1
     {
       myAUDC1 = value & 0x0f;
-      mySound->set(addr, value, mySystem->cycles());
+      if(mySoundEnabled)
+        mySound->set(addr, value, mySystem->cycles());
       break;
     }
 
     case 0x17:    // Audio frequency 0
     {
       myAUDF0 = value & 0x1f;
-      mySound->set(addr, value, mySystem->cycles());
+      if(mySoundEnabled)
+        mySound->set(addr, value, mySystem->cycles());
       break;
     }
 
     case 0x18:    // Audio frequency 1
     {
       myAUDF1 = value & 0x1f;
-      mySound->set(addr, value, mySystem->cycles());
+      if(mySoundEnabled)
+        mySound->set(addr, value, mySystem->cycles());
       break;
     }
 
     case 0x19:    // Audio volume 0
     {
       myAUDV0 = value & 0x0f;
-      mySound->set(addr, value, mySystem->cycles());
+      if(mySoundEnabled)
+        mySound->set(addr, value, mySystem->cycles());
       break;
     }
 
     case 0x1A:    // Audio volume 1
     {
       myAUDV1 = value & 0x0f;
-      mySound->set(addr, value, mySystem->cycles());
+      if(mySoundEnabled)
+        mySound->set(addr, value, mySystem->cycles());
       break;
     }
 
     case 0x1B:    // Graphics Player 0
     {
       // Set player 0 graphics
-      myGRP0 = (myBitEnabled[TIA::P0] ? value : 0);
+      myState->myGRP0 = (myBitEnabled[TIA::P0] ? value : 0);
 
       // Copy player 1 graphics into its delayed register
-      myDGRP1 = myGRP1;
+      myState->myDGRP1 = myState->myGRP1;
 
       // Get the "current" data for GRP0 base on delay register and reflect
-      uint8_t grp0 = myVDELP0 ? myDGRP0 : myGRP0;
-      myCurrentGRP0 = myREFP0 ? ourPlayerReflectTable[grp0] : grp0;
+      uint8_t grp0 = myState->myVDELP0 ? myState->myDGRP0 : myState->myGRP0;
+      myState->myCurrentGRP0 = myState->myREFP0 ? ourPlayerReflectTable[grp0] : grp0;
 
       // Get the "current" data for GRP1 base on delay register and reflect
-      uint8_t grp1 = myVDELP1 ? myDGRP1 : myGRP1;
-      myCurrentGRP1 = myREFP1 ? ourPlayerReflectTable[grp1] : grp1;
+      uint8_t grp1 = myState->myVDELP1 ? myState->myDGRP1 : myState->myGRP1;
+      myState->myCurrentGRP1 = myState->myREFP1 ? ourPlayerReflectTable[grp1] : grp1;
 
       // Set enabled object bits
-      if(myCurrentGRP0 != 0)
-        myEnabledObjects |= myP0Bit;
+      if(myState->myCurrentGRP0 != 0)
+        myState->myEnabledObjects |= myP0Bit;
       else
-        myEnabledObjects &= ~myP0Bit;
+        myState->myEnabledObjects &= ~myP0Bit;
 
-      if(myCurrentGRP1 != 0)
-        myEnabledObjects |= myP1Bit;
+      if(myState->myCurrentGRP1 != 0)
+        myState->myEnabledObjects |= myP1Bit;
       else
-        myEnabledObjects &= ~myP1Bit;
+        myState->myEnabledObjects &= ~myP1Bit;
 
       break;
     }
@@ -2526,84 +2662,84 @@ void TIA::poke(uint16_t addr, uint8_t value)
     case 0x1C:    // Graphics Player 1
     {
       // Set player 1 graphics
-      myGRP1 = (myBitEnabled[TIA::P1] ? value : 0);
+      myState->myGRP1 = (myBitEnabled[TIA::P1] ? value : 0);
 
       // Copy player 0 graphics into its delayed register
-      myDGRP0 = myGRP0;
+      myState->myDGRP0 = myState->myGRP0;
 
       // Copy ball graphics into its delayed register
-      myDENABL = myENABL;
+      myState->myDENABL = myState->myENABL;
 
       // Get the "current" data for GRP0 base on delay register
-      uint8_t grp0 = myVDELP0 ? myDGRP0 : myGRP0;
-      myCurrentGRP0 = myREFP0 ? ourPlayerReflectTable[grp0] : grp0;
+      uint8_t grp0 = myState->myVDELP0 ? myState->myDGRP0 : myState->myGRP0;
+      myState->myCurrentGRP0 = myState->myREFP0 ? ourPlayerReflectTable[grp0] : grp0;
 
       // Get the "current" data for GRP1 base on delay register
-      uint8_t grp1 = myVDELP1 ? myDGRP1 : myGRP1;
-      myCurrentGRP1 = myREFP1 ? ourPlayerReflectTable[grp1] : grp1;
+      uint8_t grp1 = myState->myVDELP1 ? myState->myDGRP1 : myState->myGRP1;
+      myState->myCurrentGRP1 = myState->myREFP1 ? ourPlayerReflectTable[grp1] : grp1;
 
       // Set enabled object bits
-      if(myCurrentGRP0 != 0)
-        myEnabledObjects |= myP0Bit;
+      if(myState->myCurrentGRP0 != 0)
+        myState->myEnabledObjects |= myP0Bit;
       else
-        myEnabledObjects &= ~myP0Bit;
+        myState->myEnabledObjects &= ~myP0Bit;
 
-      if(myCurrentGRP1 != 0)
-        myEnabledObjects |= myP1Bit;
+      if(myState->myCurrentGRP1 != 0)
+        myState->myEnabledObjects |= myP1Bit;
       else
-        myEnabledObjects &= ~myP1Bit;
+        myState->myEnabledObjects &= ~myP1Bit;
 
-      if(myVDELBL ? myDENABL : myENABL)
-        myEnabledObjects |= myBLBit;
+      if(myState->myVDELBL ? myState->myDENABL : myState->myENABL)
+        myState->myEnabledObjects |= myBLBit;
       else
-        myEnabledObjects &= ~myBLBit;
+        myState->myEnabledObjects &= ~myBLBit;
 
       break;
     }
 
     case 0x1D:    // Enable Missile 0 graphics
     {
-      myENAM0 = (myBitEnabled[TIA::M0] ? value & 0x02 : 0);
+      myState->myENAM0 = (myBitEnabled[TIA::M0] ? value & 0x02 : 0);
 
-      if(myENAM0 && !myRESMP0)
-        myEnabledObjects |= myM0Bit;
+      if(myState->myENAM0 && !myState->myRESMP0)
+        myState->myEnabledObjects |= myM0Bit;
       else
-        myEnabledObjects &= ~myM0Bit;
+        myState->myEnabledObjects &= ~myM0Bit;
       break;
     }
 
     case 0x1E:    // Enable Missile 1 graphics
     {
-      myENAM1 = (myBitEnabled[TIA::M1] ? value & 0x02 : 0);
+      myState->myENAM1 = (myBitEnabled[TIA::M1] ? value & 0x02 : 0);
 
-      if(myENAM1 && !myRESMP1)
-        myEnabledObjects |= myM1Bit;
+      if(myState->myENAM1 && !myState->myRESMP1)
+        myState->myEnabledObjects |= myM1Bit;
       else
-        myEnabledObjects &= ~myM1Bit;
+        myState->myEnabledObjects &= ~myM1Bit;
       break;
     }
 
     case 0x1F:    // Enable Ball graphics
     {
-      myENABL = (myBitEnabled[TIA::BL] ? value & 0x02 : 0);
+      myState->myENABL = (myBitEnabled[TIA::BL] ? value & 0x02 : 0);
 
-      if(myVDELBL ? myDENABL : myENABL)
-        myEnabledObjects |= myBLBit;
+      if(myState->myVDELBL ? myState->myDENABL : myState->myENABL)
+        myState->myEnabledObjects |= myBLBit;
       else
-        myEnabledObjects &= ~myBLBit;
+        myState->myEnabledObjects &= ~myBLBit;
 
       break;
     }
 
     case 0x20:    // Horizontal Motion Player 0
     {
-      myHMP0 = value >> 4;
+      myState->myHMP0 = value >> 4;
       break;
     }
 
     case 0x21:    // Horizontal Motion Player 1
     {
-      myHMP1 = value >> 4;
+      myState->myHMP1 = value >> 4;
       break;
     }
 
@@ -2612,199 +2748,199 @@ void TIA::poke(uint16_t addr, uint8_t value)
       int8_t tmp = value >> 4;
 
       // Should we enabled TIA M0 "bug" used for stars in Cosmic Ark?
-      if((clock == (myLastHMOVEClock + 21 * 3)) && (myHMM0 == 7) && (tmp == 6))
+      if((clock == (myState->myLastHMOVEClock + 21 * 3)) && (myState->myHMM0 == 7) && (tmp == 6))
       {
-        myM0CosmicArkMotionEnabled = true;
-        myM0CosmicArkCounter = 0;
+        myState->myM0CosmicArkMotionEnabled = true;
+        myState->myM0CosmicArkCounter = 0;
       }
 
-      myHMM0 = tmp;
+      myState->myHMM0 = tmp;
       break;
     }
 
     case 0x23:    // Horizontal Motion Missle 1
     {
-      myHMM1 = value >> 4;
+      myState->myHMM1 = value >> 4;
       break;
     }
 
     case 0x24:    // Horizontal Motion Ball
     {
-      myHMBL = value >> 4;
+      myState->myHMBL = value >> 4;
       break;
     }
 
     case 0x25:    // Vertial Delay Player 0
     {
-      myVDELP0 = value & 0x01;
+      myState->myVDELP0 = value & 0x01;
 
-      uint8_t grp0 = myVDELP0 ? myDGRP0 : myGRP0;
-      myCurrentGRP0 = myREFP0 ? ourPlayerReflectTable[grp0] : grp0;
+      uint8_t grp0 = myState->myVDELP0 ? myState->myDGRP0 : myState->myGRP0;
+      myState->myCurrentGRP0 = myState->myREFP0 ? ourPlayerReflectTable[grp0] : grp0;
 
-      if(myCurrentGRP0 != 0)
-        myEnabledObjects |= myP0Bit;
+      if(myState->myCurrentGRP0 != 0)
+        myState->myEnabledObjects |= myP0Bit;
       else
-        myEnabledObjects &= ~myP0Bit;
+        myState->myEnabledObjects &= ~myP0Bit;
       break;
     }
 
     case 0x26:    // Vertial Delay Player 1
     {
-      myVDELP1 = value & 0x01;
+      myState->myVDELP1 = value & 0x01;
 
-      uint8_t grp1 = myVDELP1 ? myDGRP1 : myGRP1;
-      myCurrentGRP1 = myREFP1 ? ourPlayerReflectTable[grp1] : grp1;
+      uint8_t grp1 = myState->myVDELP1 ? myState->myDGRP1 : myState->myGRP1;
+      myState->myCurrentGRP1 = myState->myREFP1 ? ourPlayerReflectTable[grp1] : grp1;
 
-      if(myCurrentGRP1 != 0)
-        myEnabledObjects |= myP1Bit;
+      if(myState->myCurrentGRP1 != 0)
+        myState->myEnabledObjects |= myP1Bit;
       else
-        myEnabledObjects &= ~myP1Bit;
+        myState->myEnabledObjects &= ~myP1Bit;
       break;
     }
 
     case 0x27:    // Vertial Delay Ball
     {
-      myVDELBL = value & 0x01;
+      myState->myVDELBL = value & 0x01;
 
-      if(myVDELBL ? myDENABL : myENABL)
-        myEnabledObjects |= myBLBit;
+      if(myState->myVDELBL ? myState->myDENABL : myState->myENABL)
+        myState->myEnabledObjects |= myBLBit;
       else
-        myEnabledObjects &= ~myBLBit;
+        myState->myEnabledObjects &= ~myBLBit;
       break;
     }
 
     case 0x28:    // Reset missle 0 to player 0
     {
-      if(myRESMP0 && !(value & 0x02))
+      if(myState->myRESMP0 && !(value & 0x02))
       {
         uint16_t middle;
 
-        if((myNUSIZ0 & 0x07) == 0x05)
+        if((myState->myNUSIZ0 & 0x07) == 0x05)
           middle = 8;
-        else if((myNUSIZ0 & 0x07) == 0x07)
+        else if((myState->myNUSIZ0 & 0x07) == 0x07)
           middle = 16;
         else
           middle = 4;
 
-        myPOSM0 = (myPOSP0 + middle) % 160;
-        myCurrentM0Mask = &ourMissleMaskTable[myPOSM0 & 0x03]
-            [myNUSIZ0 & 0x07][(myNUSIZ0 & 0x30) >> 4][160 - (myPOSM0 & 0xFC)];
+        myState->myPOSM0 = (myState->myPOSP0 + middle) % 160;
+        myState->myCurrentM0Mask = &ourMissleMaskTable[myState->myPOSM0 & 0x03]
+            [myState->myNUSIZ0 & 0x07][(myState->myNUSIZ0 & 0x30) >> 4][160 - (myState->myPOSM0 & 0xFC)];
       }
 
-      myRESMP0 = value & 0x02;
+      myState->myRESMP0 = value & 0x02;
 
-      if(myENAM0 && !myRESMP0)
-        myEnabledObjects |= myM0Bit;
+      if(myState->myENAM0 && !myState->myRESMP0)
+        myState->myEnabledObjects |= myM0Bit;
       else
-        myEnabledObjects &= ~myM0Bit;
+        myState->myEnabledObjects &= ~myM0Bit;
 
       break;
     }
 
     case 0x29:    // Reset missle 1 to player 1
     {
-      if(myRESMP1 && !(value & 0x02))
+      if(myState->myRESMP1 && !(value & 0x02))
       {
         uint16_t middle;
 
-        if((myNUSIZ1 & 0x07) == 0x05)
+        if((myState->myNUSIZ1 & 0x07) == 0x05)
           middle = 8;
-        else if((myNUSIZ1 & 0x07) == 0x07)
+        else if((myState->myNUSIZ1 & 0x07) == 0x07)
           middle = 16;
         else
           middle = 4;
 
-        myPOSM1 = (myPOSP1 + middle) % 160;
-        myCurrentM1Mask = &ourMissleMaskTable[myPOSM1 & 0x03]
-            [myNUSIZ1 & 0x07][(myNUSIZ1 & 0x30) >> 4][160 - (myPOSM1 & 0xFC)];
+        myState->myPOSM1 = (myState->myPOSP1 + middle) % 160;
+        myState->myCurrentM1Mask = &ourMissleMaskTable[myState->myPOSM1 & 0x03]
+            [myState->myNUSIZ1 & 0x07][(myState->myNUSIZ1 & 0x30) >> 4][160 - (myState->myPOSM1 & 0xFC)];
       }
 
-      myRESMP1 = value & 0x02;
+      myState->myRESMP1 = value & 0x02;
 
-      if(myENAM1 && !myRESMP1)
-        myEnabledObjects |= myM1Bit;
+      if(myState->myENAM1 && !myState->myRESMP1)
+        myState->myEnabledObjects |= myM1Bit;
       else
-        myEnabledObjects &= ~myM1Bit;
+        myState->myEnabledObjects &= ~myM1Bit;
       break;
     }
 
     case 0x2A:    // Apply horizontal motion
     {
       // Figure out what cycle we're at
-      int x = ((clock - myClockWhenFrameStarted) % 228) / 3;
+      int x = ((clock - myState->myClockWhenFrameStarted) % 228) / 3;
 
       // See if we need to enable the HMOVE blank bug
       if(myAllowHMOVEBlanks && ourHMOVEBlankEnableCycles[x])
       {
         // TODO: Allow this to be turned off using properties...
-        myHMOVEBlankEnabled = true;
+        myState->myHMOVEBlankEnabled = true;
       }
 
-      myPOSP0 += ourCompleteMotionTable[x][myHMP0];
-      myPOSP1 += ourCompleteMotionTable[x][myHMP1];
-      myPOSM0 += ourCompleteMotionTable[x][myHMM0];
-      myPOSM1 += ourCompleteMotionTable[x][myHMM1];
-      myPOSBL += ourCompleteMotionTable[x][myHMBL];
+      myState->myPOSP0 += ourCompleteMotionTable[x][myState->myHMP0];
+      myState->myPOSP1 += ourCompleteMotionTable[x][myState->myHMP1];
+      myState->myPOSM0 += ourCompleteMotionTable[x][myState->myHMM0];
+      myState->myPOSM1 += ourCompleteMotionTable[x][myState->myHMM1];
+      myState->myPOSBL += ourCompleteMotionTable[x][myState->myHMBL];
 
-      if(myPOSP0 >= 160)
-        myPOSP0 -= 160;
-      else if(myPOSP0 < 0)
-        myPOSP0 += 160;
+      if(myState->myPOSP0 >= 160)
+        myState->myPOSP0 -= 160;
+      else if(myState->myPOSP0 < 0)
+        myState->myPOSP0 += 160;
 
-      if(myPOSP1 >= 160)
-        myPOSP1 -= 160;
-      else if(myPOSP1 < 0)
-        myPOSP1 += 160;
+      if(myState->myPOSP1 >= 160)
+        myState->myPOSP1 -= 160;
+      else if(myState->myPOSP1 < 0)
+        myState->myPOSP1 += 160;
 
-      if(myPOSM0 >= 160)
-        myPOSM0 -= 160;
-      else if(myPOSM0 < 0)
-        myPOSM0 += 160;
+      if(myState->myPOSM0 >= 160)
+        myState->myPOSM0 -= 160;
+      else if(myState->myPOSM0 < 0)
+        myState->myPOSM0 += 160;
 
-      if(myPOSM1 >= 160)
-        myPOSM1 -= 160;
-      else if(myPOSM1 < 0)
-        myPOSM1 += 160;
+      if(myState->myPOSM1 >= 160)
+        myState->myPOSM1 -= 160;
+      else if(myState->myPOSM1 < 0)
+        myState->myPOSM1 += 160;
 
-      if(myPOSBL >= 160)
-        myPOSBL -= 160;
-      else if(myPOSBL < 0)
-        myPOSBL += 160;
+      if(myState->myPOSBL >= 160)
+        myState->myPOSBL -= 160;
+      else if(myState->myPOSBL < 0)
+        myState->myPOSBL += 160;
 
-      myCurrentBLMask = &ourBallMaskTable[myPOSBL & 0x03]
-          [(myCTRLPF & 0x30) >> 4][160 - (myPOSBL & 0xFC)];
+      myState->myCurrentBLMask = &ourBallMaskTable[myState->myPOSBL & 0x03]
+          [(myState->myCTRLPF & 0x30) >> 4][160 - (myState->myPOSBL & 0xFC)];
 
-      myCurrentP0Mask = &ourPlayerMaskTable[myPOSP0 & 0x03]
-          [0][myNUSIZ0 & 0x07][160 - (myPOSP0 & 0xFC)];
-      myCurrentP1Mask = &ourPlayerMaskTable[myPOSP1 & 0x03]
-          [0][myNUSIZ1 & 0x07][160 - (myPOSP1 & 0xFC)];
+      myState->myCurrentP0Mask = &ourPlayerMaskTable[myState->myPOSP0 & 0x03]
+          [0][myState->myNUSIZ0 & 0x07][160 - (myState->myPOSP0 & 0xFC)];
+      myState->myCurrentP1Mask = &ourPlayerMaskTable[myState->myPOSP1 & 0x03]
+          [0][myState->myNUSIZ1 & 0x07][160 - (myState->myPOSP1 & 0xFC)];
 
-      myCurrentM0Mask = &ourMissleMaskTable[myPOSM0 & 0x03]
-          [myNUSIZ0 & 0x07][(myNUSIZ0 & 0x30) >> 4][160 - (myPOSM0 & 0xFC)];
-      myCurrentM1Mask = &ourMissleMaskTable[myPOSM1 & 0x03]
-          [myNUSIZ1 & 0x07][(myNUSIZ1 & 0x30) >> 4][160 - (myPOSM1 & 0xFC)];
+      myState->myCurrentM0Mask = &ourMissleMaskTable[myState->myPOSM0 & 0x03]
+          [myState->myNUSIZ0 & 0x07][(myState->myNUSIZ0 & 0x30) >> 4][160 - (myState->myPOSM0 & 0xFC)];
+      myState->myCurrentM1Mask = &ourMissleMaskTable[myState->myPOSM1 & 0x03]
+          [myState->myNUSIZ1 & 0x07][(myState->myNUSIZ1 & 0x30) >> 4][160 - (myState->myPOSM1 & 0xFC)];
 
       // Remember what clock HMOVE occured at
-      myLastHMOVEClock = clock;
+      myState->myLastHMOVEClock = clock;
 
       // Disable TIA M0 "bug" used for stars in Cosmic ark
-      myM0CosmicArkMotionEnabled = false;
+      myState->myM0CosmicArkMotionEnabled = false;
       break;
     }
 
     case 0x2b:    // Clear horizontal motion registers
     {
-      myHMP0 = 0;
-      myHMP1 = 0;
-      myHMM0 = 0;
-      myHMM1 = 0;
-      myHMBL = 0;
+      myState->myHMP0 = 0;
+      myState->myHMP1 = 0;
+      myState->myHMM0 = 0;
+      myState->myHMM1 = 0;
+      myState->myHMBL = 0;
       break;
     }
 
     case 0x2c:    // Clear collision latches
     {
-      myCollision = 0;
+      myState->myCollision = 0;
       break;
     }
 
@@ -2819,13 +2955,24 @@ void TIA::poke(uint16_t addr, uint8_t value)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uint8_t TIA::ourBallMaskTable[4][4][320];
+// Generated by the compiler, so the tables are read-only data shared by every
+// instance and process, with nothing to set up at run time
+constexpr TIA::Tables TIA::ourTables = TIA::computeTables();
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t TIA::tablesMemoryUsage()
+{
+  return sizeof(Tables);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const uint8_t (&TIA::ourBallMaskTable)[4][4][320] = ourTables.ballMask;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uint16_t TIA::ourCollisionTable[64];
+const uint16_t (&TIA::ourCollisionTable)[64] = ourTables.collision;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-const uint8_t TIA::ourDisabledMaskTable[640] = {};
+const uint8_t (&TIA::ourDisabledMaskTable)[640] = ourTables.disabledMask;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const int16_t TIA::ourPokeDelayTable[64] = {
@@ -2836,7 +2983,7 @@ const int16_t TIA::ourPokeDelayTable[64] = {
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uint8_t TIA::ourMissleMaskTable[4][8][4][320];
+const uint8_t (&TIA::ourMissleMaskTable)[4][8][4][320] = ourTables.missleMask;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const bool TIA::ourHMOVEBlankEnableCycles[76] = {
@@ -2931,26 +3078,28 @@ const int TIA::ourCompleteMotionTable[76][16] = {
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uint8_t TIA::ourPlayerMaskTable[4][2][8][320];
+const uint8_t (&TIA::ourPlayerMaskTable)[4][2][8][320] = ourTables.playerMask;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-int8_t TIA::ourPlayerPositionResetWhenTable[8][160][160];
+const int8_t (&TIA::ourPlayerPositionResetWhenTable)[8][160][160] =
+    ourTables.playerPositionResetWhen;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uint8_t TIA::ourPlayerReflectTable[256];
+const uint8_t (&TIA::ourPlayerReflectTable)[256] = ourTables.playerReflect;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uint32_t TIA::ourPlayfieldTable[2][160];
+const uint32_t (&TIA::ourPlayfieldTable)[2][160] = ourTables.playfield;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const uint8_t (&TIA::ourPriorityEncoder)[2][256] = ourTables.priorityEncoder;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TIA::TIA(const TIA& c)
     : myConsole(c.myConsole),
       mySettings(c.mySettings),
       mySound(c.mySound),
-      myCOLUBK(myColor[0]),
-      myCOLUPF(myColor[1]),
-      myCOLUP0(myColor[2]),
-      myCOLUP1(myColor[3])
+      mySoundEnabled(c.mySoundEnabled),
+      myScanlineKernel(0)
 {
   assert(false);
 }
@@ -2963,6 +3112,145 @@ TIA& TIA::operator = (const TIA&)
   return *this;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::startFrameLog()
+{
+  myFrameLogs[0].start.state = *myState;
+  myFrameLogs[0].start.myFramePointer = myFramePointer;
+  myFrameLogs[0].pokes.clear();
+  myFrameLogs[0].endClock = myState->myClockAtLastUpdate;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::rasteriseFrame(int index)
+{
+  FrameLog& log = myFrameLogs[index];
+
+  // Set the live state aside, rewind to the start of the frame and feed the
+  // frame's writes through poke() again with pixel output turned on.  The
+  // frame pointer in the saved state already points into the frame's buffer.
+  RenderState live = { *myState, myFramePointer };
+  *myState = log.start.state;
+  myFramePointer = log.start.myFramePointer;
+
+  // Rows of the current frame are compared as they are drawn, which is only
+  // exact if the previous frame has been drawn already
+  if(index == 0)
+  {
+    markAllRowsDirty();
+    myDirtyRowsExact = !myFrameLogs[1].pending;
+  }
+
+  bool fast = fastUpdate;
+  fastUpdate = false;
+  myReplaying = true;
+
+  for(const PokeRecord& record : log.pokes)
+  {
+    myReplayCycles = record.cycles;
+    poke(record.addr, record.value);
+  }
+  updateFrame(log.endClock);
+
+  myReplaying = false;
+  fastUpdate = fast;
+
+  *myState = live.state;
+  myFramePointer = live.myFramePointer;
+  log.pending = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::rasteriseFrameBeforeLast()
+{
+  // The current frame is drawn into the buffer of the frame before last, and
+  // the rows it stops short of keep that frame's pixels
+  if(myFrameLogs[0].pending && myFrameLogs[2].pending &&
+     myFrameLogs[0].endClock < myState->myClockStopDisplay)
+    rasteriseFrame(2);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::rasterisePendingFrames()
+{
+  rasteriseFrameBeforeLast();
+
+  // Previous frame first, so the current one is compared against it
+  for(int i = 1; i >= 0; --i)
+  {
+    if(myFrameLogs[i].pending)
+      rasteriseFrame(i);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const uint64_t* TIA::dirtyRows() const
+{
+  TIA* self = const_cast<TIA*>(this);
+  self->rasterisePendingFrames();
+
+  // The current frame was drawn before the previous one, so compare again
+  if(!myDirtyRowsExact)
+  {
+    for(int row = 0; row < 300; ++row)
+    {
+      uint64_t bit = uint64_t(1) << (row & 63);
+      if(std::memcmp(myCurrentFrameBuffer + row * 160,
+                     myPreviousFrameBuffer + row * 160, 160) == 0)
+        self->myDirtyRows[row >> 6] &= ~bit;
+      else
+        self->myDirtyRows[row >> 6] |= bit;
+    }
+    self->myDirtyRowsExact = true;
+  }
+  return myDirtyRows;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uint64_t TIA::frameHash(uint32_t rows) const
+{
+  const uint8_t* buffer = currentFrameBuffer();
+  RowHashes* hashes = myCurrentRowHashes;
+
+  uint64_t hash = ale::kScreenHashSeed;
+  for(uint32_t row = 0; row < rows && row < 300; ++row)
+  {
+    uint64_t bit = uint64_t(1) << (row & 63);
+    if(!(hashes->valid[row >> 6] & bit))
+    {
+      hashes->hash[row] = ale::hashScreenRow(buffer + row * 160, 160);
+      hashes->valid[row >> 6] |= bit;
+    }
+    hash = ale::combineRowHash(hash, hashes->hash[row]);
+  }
+  return hash;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::invalidateRowHash(const uint8_t* pointer)
+{
+  const uint8_t* buffer = (pointer >= myCurrentFrameBuffer &&
+      pointer < myCurrentFrameBuffer + 160 * 300) ?
+      myCurrentFrameBuffer : myPreviousFrameBuffer;
+  int row = (pointer - buffer) / 160;
+  rowHashesOf(buffer)->valid[row >> 6] &= ~(uint64_t(1) << (row & 63));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::invalidateRowHashes()
+{
+  for(int i = 0; i < DirtyRowWords; ++i)
+    myRowHashes[0].valid[i] = myRowHashes[1].valid[i] = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::markAllRowsDirty()
+{
+  for(int i = 0; i < DirtyRowWords; ++i)
+    myDirtyRows[i] = ~uint64_t(0);
+  myDirtyRowsExact = true;
+}
+
 // MGB
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
@@ -2971,14 +3259,14 @@ inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
   uint8_t* ending = myFramePointer + clocksToUpdate;
 
   // See if we're in the vertical blank region
-  if(myVBLANK & 0x02)
+  if(myState->myVBLANK & 0x02)
   {
     // @strip memset(myFramePointer, 0, clocksToUpdate);
   }
   // Handle all other possible combinations
   else
   {
-    switch(myEnabledObjects | myPlayfieldPriorityAndScore)
+    switch(myState->myEnabledObjects | myState->myPlayfieldPriorityAndScore)
     {
       // Background
       case 0x00:
@@ -2986,7 +3274,7 @@ inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
       case 0x00 | PriorityBit:
       case 0x00 | PriorityBit | ScoreBit:
       /* @strip {
-        memset(myFramePointer, myCOLUBK, clocksToUpdate);
+        memset(myFramePointer, myColor[COLUBK], clocksToUpdate);
         break;
       } */
       break;
@@ -3002,13 +3290,13 @@ inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
         for(; ((uintptr_t)myFramePointer & 0x03) && (myFramePointer < ending);
             ++myFramePointer, ++mask)
         {
-          *myFramePointer = (myPF & *mask) ? myCOLUPF : myCOLUBK;
+          *myFramePointer = (myPF & *mask) ? myColor[COLUPF] : myColor[COLUBK];
         }
 
         // Now, update a uint32_t at a time
         for(; myFramePointer < ending; myFramePointer += 4, mask += 4)
         {
-          *((uint32_t*)myFramePointer) = (myPF & *mask) ? myCOLUPF : myCOLUBK;
+          *((uint32_t*)myFramePointer) = (myPF & *mask) ? myColor[COLUPF] : myColor[COLUBK];
         }
         break;
       } */ break;
@@ -3024,7 +3312,7 @@ inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
             ++myFramePointer, ++mask, ++hpos)
         {
           *myFramePointer = (myPF & *mask) ?
-              (hpos < 80 ? myCOLUP0 : myCOLUP1) : myCOLUBK;
+              (hpos < 80 ? myColor[COLUP0] : myColor[COLUP1]) : myColor[COLUBK];
         }
 
         // Now, update a uint32_t at a time
@@ -3032,7 +3320,7 @@ inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
             myFramePointer += 4, mask += 4, hpos += 4)
         {
           *((uint32_t*)myFramePointer) = (myPF & *mask) ?
-              (hpos < 80 ? myCOLUP0 : myCOLUP1) : myCOLUBK;
+              (hpos < 80 ? myColor[COLUP0] : myColor[COLUP1]) : myColor[COLUBK];
         }
         break;
       } */
@@ -3050,12 +3338,12 @@ inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mP0)
           {
-            *(uint32_t*)myFramePointer = myCOLUBK;
+            *(uint32_t*)myFramePointer = myColor[COLUBK];
             mP0 += 4; myFramePointer += 4;
           }
           else
           {
-            *myFramePointer = (myCurrentGRP0 & *mP0) ? myCOLUP0 : myCOLUBK;
+            *myFramePointer = (myCurrentGRP0 & *mP0) ? myColor[COLUP0] : myColor[COLUBK];
             ++mP0; ++myFramePointer;
           }
         }
@@ -3074,12 +3362,12 @@ inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mP1)
           {
-            *(uint32_t*)myFramePointer = myCOLUBK;
+            *(uint32_t*)myFramePointer = myColor[COLUBK];
             mP1 += 4; myFramePointer += 4;
           }
           else
           {
-            *myFramePointer = (myCurrentGRP1 & *mP1) ? myCOLUP1 : myCOLUBK;
+            *myFramePointer = (myCurrentGRP1 & *mP1) ? myColor[COLUP1] : myColor[COLUBK];
             ++mP1; ++myFramePointer;
           }
         }
@@ -3092,25 +3380,25 @@ inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
       case myP0Bit | myP1Bit | PriorityBit:
       case myP0Bit | myP1Bit | ScoreBit | PriorityBit:
       {
-        const uint8_t* mP0 = &myCurrentP0Mask[hpos];
-        const uint8_t* mP1 = &myCurrentP1Mask[hpos];
+        const uint8_t* mP0 = &myState->myCurrentP0Mask[hpos];
+        const uint8_t* mP1 = &myState->myCurrentP1Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mP0 &&
               !*(uint32_t*)mP1)
           {
-            // @strip *(uint32_t*)myFramePointer = myCOLUBK;
+            // @strip *(uint32_t*)myFramePointer = myColor[COLUBK];
             mP0 += 4; mP1 += 4; myFramePointer += 4;
           }
           else
           {
             /* @strip *myFramePointer = (myCurrentGRP0 & *mP0) ?
-                myCOLUP0 : ((myCurrentGRP1 & *mP1) ? myCOLUP1 : myCOLUBK);
+                myColor[COLUP0] : ((myCurrentGRP1 & *mP1) ? myColor[COLUP1] : myColor[COLUBK]);
             */
 
-            if((myCurrentGRP0 & *mP0) && (myCurrentGRP1 & *mP1))
-              myCollision |= ourCollisionTable[myP0Bit | myP1Bit];
+            if((myState->myCurrentGRP0 & *mP0) && (myState->myCurrentGRP1 & *mP1))
+              myState->myCollision |= ourCollisionTable[myP0Bit | myP1Bit];
 
             ++mP0; ++mP1; ++myFramePointer;
           }
@@ -3130,12 +3418,12 @@ inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mM0)
           {
-            *(uint32_t*)myFramePointer = myCOLUBK;
+            *(uint32_t*)myFramePointer = myColor[COLUBK];
             mM0 += 4; myFramePointer += 4;
           }
           else
           {
-            *myFramePointer = *mM0 ? myCOLUP0 : myCOLUBK;
+            *myFramePointer = *mM0 ? myColor[COLUP0] : myColor[COLUBK];
             ++mM0; ++myFramePointer;
           }
         }
@@ -3155,12 +3443,12 @@ inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mM1)
           {
-            *(uint32_t*)myFramePointer = myCOLUBK;
+            *(uint32_t*)myFramePointer = myColor[COLUBK];
             mM1 += 4; myFramePointer += 4;
           }
           else
           {
-            *myFramePointer = *mM1 ? myCOLUP1 : myCOLUBK;
+            *myFramePointer = *mM1 ? myColor[COLUP1] : myColor[COLUBK];
             ++mM1; ++myFramePointer;
           }
         }
@@ -3180,12 +3468,12 @@ inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mBL)
           {
-            *(uint32_t*)myFramePointer = myCOLUBK;
+            *(uint32_t*)myFramePointer = myColor[COLUBK];
             mBL += 4; myFramePointer += 4;
           }
           else
           {
-            *myFramePointer = *mBL ? myCOLUPF : myCOLUBK;
+            *myFramePointer = *mBL ? myColor[COLUPF] : myColor[COLUBK];
             ++mBL; ++myFramePointer;
           }
         }
@@ -3199,22 +3487,22 @@ inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
       case myM0Bit | myM1Bit | PriorityBit:
       case myM0Bit | myM1Bit | ScoreBit | PriorityBit:
       {
-        const uint8_t* mM0 = &myCurrentM0Mask[hpos];
-        const uint8_t* mM1 = &myCurrentM1Mask[hpos];
+        const uint8_t* mM0 = &myState->myCurrentM0Mask[hpos];
+        const uint8_t* mM1 = &myState->myCurrentM1Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mM0 && !*(uint32_t*)mM1)
           {
-            // @strip *(uint32_t*)myFramePointer = myCOLUBK;
+            // @strip *(uint32_t*)myFramePointer = myColor[COLUBK];
             mM0 += 4; mM1 += 4; myFramePointer += 4;
           }
           else
           {
-            // @strip *myFramePointer = *mM0 ? myCOLUP0 : (*mM1 ? myCOLUP1 : myCOLUBK);
+            // @strip *myFramePointer = *mM0 ? myColor[COLUP0] : (*mM1 ? myColor[COLUP1] : myColor[COLUBK]);
 
             if(*mM0 && *mM1)
-              myCollision |= ourCollisionTable[myM0Bit | myM1Bit];
+              myState->myCollision |= ourCollisionTable[myM0Bit | myM1Bit];
 
             ++mM0; ++mM1; ++myFramePointer;
           }
@@ -3226,22 +3514,22 @@ inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
       case myBLBit | myM0Bit:
       case myBLBit | myM0Bit | ScoreBit:
       {
-        const uint8_t* mBL = &myCurrentBLMask[hpos];
-        const uint8_t* mM0 = &myCurrentM0Mask[hpos];
+        const uint8_t* mBL = &myState->myCurrentBLMask[hpos];
+        const uint8_t* mM0 = &myState->myCurrentM0Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mBL && !*(uint32_t*)mM0)
           {
-            // @strip *(uint32_t*)myFramePointer = myCOLUBK;
+            // @strip *(uint32_t*)myFramePointer = myColor[COLUBK];
             mBL += 4; mM0 += 4; myFramePointer += 4;
           }
           else
           {
-            // @strip *myFramePointer = (*mM0 ? myCOLUP0 : (*mBL ? myCOLUPF : myCOLUBK));
+            // @strip *myFramePointer = (*mM0 ? myColor[COLUP0] : (*mBL ? myColor[COLUPF] : myColor[COLUBK]));
 
             if(*mBL && *mM0)
-              myCollision |= ourCollisionTable[myBLBit | myM0Bit];
+              myState->myCollision |= ourCollisionTable[myBLBit | myM0Bit];
 
             ++mBL; ++mM0; ++myFramePointer;
           }
@@ -3253,22 +3541,22 @@ inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
       case myBLBit | myM0Bit | PriorityBit:
       case myBLBit | myM0Bit | ScoreBit | PriorityBit:
       {
-        const uint8_t* mBL = &myCurrentBLMask[hpos];
-        const uint8_t* mM0 = &myCurrentM0Mask[hpos];
+        const uint8_t* mBL = &myState->myCurrentBLMask[hpos];
+        const uint8_t* mM0 = &myState->myCurrentM0Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mBL && !*(uint32_t*)mM0)
           {
-            // @strip *(uint32_t*)myFramePointer = myCOLUBK;
+            // @strip *(uint32_t*)myFramePointer = myColor[COLUBK];
             mBL += 4; mM0 += 4; myFramePointer += 4;
           }
           else
           {
-            // @strip *myFramePointer = (*mBL ? myCOLUPF : (*mM0 ? myCOLUP0 : myCOLUBK));
+            // @strip *myFramePointer = (*mBL ? myColor[COLUPF] : (*mM0 ? myColor[COLUP0] : myColor[COLUBK]));
 
             if(*mBL && *mM0)
-              myCollision |= ourCollisionTable[myBLBit | myM0Bit];
+              myState->myCollision |= ourCollisionTable[myBLBit | myM0Bit];
 
             ++mBL; ++mM0; ++myFramePointer;
           }
@@ -3280,23 +3568,23 @@ inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
       case myBLBit | myM1Bit:
       case myBLBit | myM1Bit | ScoreBit:
       {
-        const uint8_t* mBL = &myCurrentBLMask[hpos];
-        const uint8_t* mM1 = &myCurrentM1Mask[hpos];
+        const uint8_t* mBL = &myState->myCurrentBLMask[hpos];
+        const uint8_t* mM1 = &myState->myCurrentM1Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mBL &&
               !*(uint32_t*)mM1)
           {
-            // @strip *(uint32_t*)myFramePointer = myCOLUBK;
+            // @strip *(uint32_t*)myFramePointer = myColor[COLUBK];
             mBL += 4; mM1 += 4; myFramePointer += 4;
           }
           else
           {
-            // @strip *myFramePointer = (*mM1 ? myCOLUP1 : (*mBL ? myCOLUPF : myCOLUBK));
+            // @strip *myFramePointer = (*mM1 ? myColor[COLUP1] : (*mBL ? myColor[COLUPF] : myColor[COLUBK]));
 
             if(*mBL && *mM1)
-              myCollision |= ourCollisionTable[myBLBit | myM1Bit];
+              myState->myCollision |= ourCollisionTable[myBLBit | myM1Bit];
 
             ++mBL; ++mM1; ++myFramePointer;
           }
@@ -3308,23 +3596,23 @@ inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
       case myBLBit | myM1Bit | PriorityBit:
       case myBLBit | myM1Bit | ScoreBit | PriorityBit:
       {
-        const uint8_t* mBL = &myCurrentBLMask[hpos];
-        const uint8_t* mM1 = &myCurrentM1Mask[hpos];
+        const uint8_t* mBL = &myState->myCurrentBLMask[hpos];
+        const uint8_t* mM1 = &myState->myCurrentM1Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mBL &&
               !*(uint32_t*)mM1)
           {
-            // @strip *(uint32_t*)myFramePointer = myCOLUBK;
+            // @strip *(uint32_t*)myFramePointer = myColor[COLUBK];
             mBL += 4; mM1 += 4; myFramePointer += 4;
           }
           else
           {
-            // @strip *myFramePointer = (*mBL ? myCOLUPF : (*mM1 ? myCOLUP1 : myCOLUBK));
+            // @strip *myFramePointer = (*mBL ? myColor[COLUPF] : (*mM1 ? myColor[COLUP1] : myColor[COLUBK]));
 
             if(*mBL && *mM1)
-              myCollision |= ourCollisionTable[myBLBit | myM1Bit];
+              myState->myCollision |= ourCollisionTable[myBLBit | myM1Bit];
 
             ++mBL; ++mM1; ++myFramePointer;
           }
@@ -3336,23 +3624,23 @@ inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
       case myBLBit | myP1Bit:
       case myBLBit | myP1Bit | ScoreBit:
       {
-        const uint8_t* mBL = &myCurrentBLMask[hpos];
-        const uint8_t* mP1 = &myCurrentP1Mask[hpos];
+        const uint8_t* mBL = &myState->myCurrentBLMask[hpos];
+        const uint8_t* mP1 = &myState->myCurrentP1Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mP1 && !*(uint32_t*)mBL)
           {
-            // @strip *(uint32_t*)myFramePointer = myCOLUBK;
+            // @strip *(uint32_t*)myFramePointer = myColor[COLUBK];
             mBL += 4; mP1 += 4; myFramePointer += 4;
           }
           else
           {
-            /* @strip *myFramePointer = (myCurrentGRP1 & *mP1) ? myCOLUP1 :
-                (*mBL ? myCOLUPF : myCOLUBK); */
+            /* @strip *myFramePointer = (myCurrentGRP1 & *mP1) ? myColor[COLUP1] :
+                (*mBL ? myColor[COLUPF] : myColor[COLUBK]); */
 
-            if(*mBL && (myCurrentGRP1 & *mP1))
-              myCollision |= ourCollisionTable[myBLBit | myP1Bit];
+            if(*mBL && (myState->myCurrentGRP1 & *mP1))
+              myState->myCollision |= ourCollisionTable[myBLBit | myP1Bit];
 
             ++mBL; ++mP1; ++myFramePointer;
           }
@@ -3364,23 +3652,23 @@ inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
       case myBLBit | myP1Bit | PriorityBit:
       case myBLBit | myP1Bit | PriorityBit | ScoreBit:
       {
-        const uint8_t* mBL = &myCurrentBLMask[hpos];
-        const uint8_t* mP1 = &myCurrentP1Mask[hpos];
+        const uint8_t* mBL = &myState->myCurrentBLMask[hpos];
+        const uint8_t* mP1 = &myState->myCurrentP1Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mP1 && !*(uint32_t*)mBL)
           {
-            // @strip *(uint32_t*)myFramePointer = myCOLUBK;
+            // @strip *(uint32_t*)myFramePointer = myColor[COLUBK];
             mBL += 4; mP1 += 4; myFramePointer += 4;
           }
           else
           {
-            /* @strip *myFramePointer = *mBL ? myCOLUPF :
-                ((myCurrentGRP1 & *mP1) ? myCOLUP1 : myCOLUBK); */
+            /* @strip *myFramePointer = *mBL ? myColor[COLUPF] :
+                ((myCurrentGRP1 & *mP1) ? myColor[COLUP1] : myColor[COLUBK]); */
 
-            if(*mBL && (myCurrentGRP1 & *mP1))
-              myCollision |= ourCollisionTable[myBLBit | myP1Bit];
+            if(*mBL && (myState->myCurrentGRP1 & *mP1))
+              myState->myCollision |= ourCollisionTable[myBLBit | myP1Bit];
 
             ++mBL; ++mP1; ++myFramePointer;
           }
@@ -3391,23 +3679,23 @@ inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
       // Playfield and Player 0 are enabled and playfield priority is not set
       case myPFBit | myP0Bit:
       {
-        const uint32_t* mPF = &myCurrentPFMask[hpos];
-        const uint8_t* mP0 = &myCurrentP0Mask[hpos];
+        const uint32_t* mPF = &myState->myCurrentPFMask[hpos];
+        const uint8_t* mP0 = &myState->myCurrentP0Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mP0)
           {
-            // @strip *(uint32_t*)myFramePointer = (myPF & *mPF) ? myCOLUPF : myCOLUBK;
+            // @strip *(uint32_t*)myFramePointer = (myPF & *mPF) ? myColor[COLUPF] : myColor[COLUBK];
             mPF += 4; mP0 += 4; myFramePointer += 4;
           }
           else
           {
             /* @strip *myFramePointer = (myCurrentGRP0 & *mP0) ?
-                  myCOLUP0 : ((myPF & *mPF) ? myCOLUPF : myCOLUBK); */
+                  myColor[COLUP0] : ((myPF & *mPF) ? myColor[COLUPF] : myColor[COLUBK]); */
 
-            if((myPF & *mPF) && (myCurrentGRP0 & *mP0))
-              myCollision |= ourCollisionTable[myPFBit | myP0Bit];
+            if((myState->myPF & *mPF) && (myState->myCurrentGRP0 & *mP0))
+              myState->myCollision |= ourCollisionTable[myPFBit | myP0Bit];
 
             ++mPF; ++mP0; ++myFramePointer;
           }
@@ -3419,23 +3707,23 @@ inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
       // Playfield and Player 0 are enabled and playfield priority is set
       case myPFBit | myP0Bit | PriorityBit:
       {
-        const uint32_t* mPF = &myCurrentPFMask[hpos];
-        const uint8_t* mP0 = &myCurrentP0Mask[hpos];
+        const uint32_t* mPF = &myState->myCurrentPFMask[hpos];
+        const uint8_t* mP0 = &myState->myCurrentP0Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mP0)
           {
-            // @strip *(uint32_t*)myFramePointer = (myPF & *mPF) ? myCOLUPF : myCOLUBK;
+            // @strip *(uint32_t*)myFramePointer = (myPF & *mPF) ? myColor[COLUPF] : myColor[COLUBK];
             mPF += 4; mP0 += 4; myFramePointer += 4;
           }
           else
           {
-            /* @strip *myFramePointer = (myPF & *mPF) ? myCOLUPF :
-                ((myCurrentGRP0 & *mP0) ? myCOLUP0 : myCOLUBK); */
+            /* @strip *myFramePointer = (myPF & *mPF) ? myColor[COLUPF] :
+                ((myCurrentGRP0 & *mP0) ? myColor[COLUP0] : myColor[COLUBK]); */
 
-            if((myPF & *mPF) && (myCurrentGRP0 & *mP0))
-              myCollision |= ourCollisionTable[myPFBit | myP0Bit];
+            if((myState->myPF & *mPF) && (myState->myCurrentGRP0 & *mP0))
+              myState->myCollision |= ourCollisionTable[myPFBit | myP0Bit];
 
             ++mPF; ++mP0; ++myFramePointer;
           }
@@ -3447,23 +3735,23 @@ inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
       // Playfield and Player 1 are enabled and playfield priority is not set
       case myPFBit | myP1Bit:
       {
-        const uint32_t* mPF = &myCurrentPFMask[hpos];
-        const uint8_t* mP1 = &myCurrentP1Mask[hpos];
+        const uint32_t* mPF = &myState->myCurrentPFMask[hpos];
+        const uint8_t* mP1 = &myState->myCurrentP1Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mP1)
           {
-            // @strip *(uint32_t*)myFramePointer = (myPF & *mPF) ? myCOLUPF : myCOLUBK;
+            // @strip *(uint32_t*)myFramePointer = (myPF & *mPF) ? myColor[COLUPF] : myColor[COLUBK];
             mPF += 4; mP1 += 4; myFramePointer += 4;
           }
           else
           {
             /* @strip *myFramePointer = (myCurrentGRP1 & *mP1) ?
-                  myCOLUP1 : ((myPF & *mPF) ? myCOLUPF : myCOLUBK); */
+                  myColor[COLUP1] : ((myPF & *mPF) ? myColor[COLUPF] : myColor[COLUBK]); */
 
-            if((myPF & *mPF) && (myCurrentGRP1 & *mP1))
-              myCollision |= ourCollisionTable[myPFBit | myP1Bit];
+            if((myState->myPF & *mPF) && (myState->myCurrentGRP1 & *mP1))
+              myState->myCollision |= ourCollisionTable[myPFBit | myP1Bit];
 
             ++mPF; ++mP1; ++myFramePointer;
           }
@@ -3475,23 +3763,23 @@ inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
       // Playfield and Player 1 are enabled and playfield priority is set
       case myPFBit | myP1Bit | PriorityBit:
       {
-        const uint32_t* mPF = &myCurrentPFMask[hpos];
-        const uint8_t* mP1 = &myCurrentP1Mask[hpos];
+        const uint32_t* mPF = &myState->myCurrentPFMask[hpos];
+        const uint8_t* mP1 = &myState->myCurrentP1Mask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mP1)
           {
-            // @strip *(uint32_t*)myFramePointer = (myPF & *mPF) ? myCOLUPF : myCOLUBK;
+            // @strip *(uint32_t*)myFramePointer = (myPF & *mPF) ? myColor[COLUPF] : myColor[COLUBK];
             mPF += 4; mP1 += 4; myFramePointer += 4;
           }
           else
           {
-            /* @strip *myFramePointer = (myPF & *mPF) ? myCOLUPF :
-                ((myCurrentGRP1 & *mP1) ? myCOLUP1 : myCOLUBK); */
+            /* @strip *myFramePointer = (myPF & *mPF) ? myColor[COLUPF] :
+                ((myCurrentGRP1 & *mP1) ? myColor[COLUP1] : myColor[COLUBK]); */
 
-            if((myPF & *mPF) && (myCurrentGRP1 & *mP1))
-              myCollision |= ourCollisionTable[myPFBit | myP1Bit];
+            if((myState->myPF & *mPF) && (myState->myCurrentGRP1 & *mP1))
+              myState->myCollision |= ourCollisionTable[myPFBit | myP1Bit];
 
             ++mPF; ++mP1; ++myFramePointer;
           }
@@ -3504,22 +3792,22 @@ inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
       case myPFBit | myBLBit:
       case myPFBit | myBLBit | PriorityBit:
       {
-        const uint32_t* mPF = &myCurrentPFMask[hpos];
-        const uint8_t* mBL = &myCurrentBLMask[hpos];
+        const uint32_t* mPF = &myState->myCurrentPFMask[hpos];
+        const uint8_t* mBL = &myState->myCurrentBLMask[hpos];
 
         while(myFramePointer < ending)
         {
           if(!((uintptr_t)myFramePointer & 0x03) && !*(uint32_t*)mBL)
           {
-            // @strip *(uint32_t*)myFramePointer = (myPF & *mPF) ? myCOLUPF : myCOLUBK;
+            // @strip *(uint32_t*)myFramePointer = (myPF & *mPF) ? myColor[COLUPF] : myColor[COLUBK];
             mPF += 4; mBL += 4; myFramePointer += 4;
           }
           else
           {
-            // @strip *myFramePointer = ((myPF & *mPF) || *mBL) ? myCOLUPF : myCOLUBK;
+            // @strip *myFramePointer = ((myPF & *mPF) || *mBL) ? myColor[COLUPF] : myColor[COLUBK];
 
-            if((myPF & *mPF) && *mBL)
-              myCollision |= ourCollisionTable[myPFBit | myBLBit];
+            if((myState->myPF & *mPF) && *mBL)
+              myState->myCollision |= ourCollisionTable[myPFBit | myBLBit];
 
             ++mPF; ++mBL; ++myFramePointer;
           }
@@ -3530,27 +3818,30 @@ inline void TIA::updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos)
       // Handle all of the other cases
       default:
       {
+        if(myScanlineKernel)
+          hpos += (this->*myScanlineKernel)(clocksToUpdate, hpos, false);
+
         for(; myFramePointer < ending; ++myFramePointer, ++hpos)
         {
-          uint8_t enabled = (myPF & myCurrentPFMask[hpos]) ? myPFBit : 0;
+          uint8_t enabled = (myState->myPF & myState->myCurrentPFMask[hpos]) ? myPFBit : 0;
 
-          if((myEnabledObjects & myBLBit) && myCurrentBLMask[hpos])
+          if((myState->myEnabledObjects & myBLBit) && myState->myCurrentBLMask[hpos])
             enabled |= myBLBit;
 
-          if(myCurrentGRP1 & myCurrentP1Mask[hpos])
+          if(myState->myCurrentGRP1 & myState->myCurrentP1Mask[hpos])
             enabled |= myP1Bit;
 
-          if((myEnabledObjects & myM1Bit) && myCurrentM1Mask[hpos])
+          if((myState->myEnabledObjects & myM1Bit) && myState->myCurrentM1Mask[hpos])
             enabled |= myM1Bit;
 
-          if(myCurrentGRP0 & myCurrentP0Mask[hpos])
+          if(myState->myCurrentGRP0 & myState->myCurrentP0Mask[hpos])
             enabled |= myP0Bit;
 
-          if((myEnabledObjects & myM0Bit) && myCurrentM0Mask[hpos])
+          if((myState->myEnabledObjects & myM0Bit) && myState->myCurrentM0Mask[hpos])
             enabled |= myM0Bit;
 
-          myCollision |= ourCollisionTable[enabled];
-          /* @strip *myFramePointer = myColor[myPriorityEncoder[hpos < 80 ? 0 : 1]
+          myState->myCollision |= ourCollisionTable[enabled];
+          /* @strip *myFramePointer = myColor[ourPriorityEncoder[hpos < 80 ? 0 : 1]
               [enabled | myPlayfieldPriorityAndScore]]; */
         }
         break;
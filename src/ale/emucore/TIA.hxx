@@ -35,9 +35,151 @@ class Settings;
 #include "ale/emucore/Device.hxx"
 #include "ale/emucore/MediaSrc.hxx"
 
+#include <vector>
+
 namespace ale {
 namespace stella {
 
+/**
+  The registers and timing of the TIA that change while it runs.  They are
+  kept in one block of the machine state so that a snapshot of the TIA is
+  a copy of the block.  The frame buffers and the sound are kept outside
+  of the block.
+*/
+struct TIAState
+{
+  // Indicates color clocks when the current frame began
+  int myClockWhenFrameStarted;
+
+  // Indicates color clocks when frame should begin to be drawn
+  int myClockStartDisplay;
+
+  // Indicates color clocks when frame should stop being drawn
+  int myClockStopDisplay;
+
+  // Indicates color clocks when the frame was last updated
+  int myClockAtLastUpdate;
+
+  // Indicates how many color clocks remain until the end of
+  // current scanline.  This value is valid during the
+  // displayed portion of the frame.
+  int myClocksToEndOfScanLine;
+
+  // Indicates the total number of scanlines generated by the last frame
+  int myScanlineCountForLastFrame;
+
+  // Indicates the current scanline during a partial frame.
+  int myCurrentScanline;
+
+  // Color clock when VSYNC ending causes a new frame to be started
+  int myVSYNCFinishClock;
+
+  // Bitmap of the objects that should be considered while drawing
+  uint8_t myEnabledObjects;
+
+  uint8_t myVSYNC;        // Holds the VSYNC register value
+  uint8_t myVBLANK;       // Holds the VBLANK register value
+
+  uint8_t myNUSIZ0;       // Number and size of player 0 and missle 0
+  uint8_t myNUSIZ1;       // Number and size of player 1 and missle 1
+
+  uint8_t myPlayfieldPriorityAndScore;
+
+  // Background, playfield, player 0 and player 1 color registers
+  // (replicated 4 times), indexed by TIA::COLUBK ... TIA::COLUP1
+  uint32_t myColor[4];
+
+  uint8_t myCTRLPF;       // Playfield control register
+
+  bool myREFP0;         // Indicates if player 0 is being reflected
+  bool myREFP1;         // Indicates if player 1 is being reflected
+
+  uint32_t myPF;          // Playfield graphics (19-12:PF2 11-4:PF1 3-0:PF0)
+
+  uint8_t myGRP0;         // Player 0 graphics register
+  uint8_t myGRP1;         // Player 1 graphics register
+
+  uint8_t myDGRP0;        // Player 0 delayed graphics register
+  uint8_t myDGRP1;        // Player 1 delayed graphics register
+
+  bool myENAM0;         // Indicates if missle 0 is enabled
+  bool myENAM1;         // Indicates if missle 0 is enabled
+
+  bool myENABL;         // Indicates if the ball is enabled
+  bool myDENABL;        // Indicates if the virtically delayed ball is enabled
+
+  int8_t myHMP0;          // Player 0 horizontal motion register
+  int8_t myHMP1;          // Player 1 horizontal motion register
+  int8_t myHMM0;          // Missle 0 horizontal motion register
+  int8_t myHMM1;          // Missle 1 horizontal motion register
+  int8_t myHMBL;          // Ball horizontal motion register
+
+  bool myVDELP0;        // Indicates if player 0 is being virtically delayed
+  bool myVDELP1;        // Indicates if player 1 is being virtically delayed
+  bool myVDELBL;        // Indicates if the ball is being virtically delayed
+
+  bool myRESMP0;        // Indicates if missle 0 is reset to player 0
+  bool myRESMP1;        // Indicates if missle 1 is reset to player 1
+
+  uint16_t myCollision;    // Collision register
+
+  // Note that these position registers contain the color clock
+  // on which the object's serial output should begin (0 to 159)
+  int16_t myPOSP0;         // Player 0 position register
+  int16_t myPOSP1;         // Player 1 position register
+  int16_t myPOSM0;         // Missle 0 position register
+  int16_t myPOSM1;         // Missle 1 position register
+  int16_t myPOSBL;         // Ball position register
+
+  // Graphics for Player 0 that should be displayed.  This will be
+  // reflected if the player is being reflected.
+  uint8_t myCurrentGRP0;
+
+  // Graphics for Player 1 that should be displayed.  This will be
+  // reflected if the player is being reflected.
+  uint8_t myCurrentGRP1;
+
+  // It's VERY important that the BL, M0, M1, P0 and P1 current
+  // mask pointers are always on a uint32_t boundary.  Otherwise,
+  // the TIA code will fail on a good number of CPUs.
+
+  // Pointer to the currently active mask array for the ball
+  const uint8_t* myCurrentBLMask;
+
+  // Pointer to the currently active mask array for missle 0
+  const uint8_t* myCurrentM0Mask;
+
+  // Pointer to the currently active mask array for missle 1
+  const uint8_t* myCurrentM1Mask;
+
+  // Pointer to the currently active mask array for player 0
+  const uint8_t* myCurrentP0Mask;
+
+  // Pointer to the currently active mask array for player 1
+  const uint8_t* myCurrentP1Mask;
+
+  // Pointer to the currently active mask array for the playfield
+  const uint32_t* myCurrentPFMask;
+
+  // Indicates when the dump for paddles was last set
+  int myDumpDisabledCycle;
+
+  // Indicates if the dump is current enabled for the paddles
+  bool myDumpEnabled;
+
+  // Color clock when last HMOVE occured
+  int myLastHMOVEClock;
+
+  // Indicates if HMOVE blanks are currently enabled
+  bool myHMOVEBlankEnabled;
+
+  // TIA M0 "bug" used for stars in Cosmic Ark flag
+  bool myM0CosmicArkMotionEnabled;
+
+  // Counter used for TIA M0 "bug"
+  uint32_t myM0CosmicArkCounter;
+};
+
 /**
   This class is a device that emulates the Television Interface Adapator
   found in the Atari 2600 and 7800 consoles.  The Television Interface
@@ -78,6 +220,22 @@ class TIA : public Device , public MediaSource
     */
     virtual const char* name() const;
 
+    /**
+      Answers the number of bytes of memory owned by the device, including
+      the device object itself
+
+      @return The number of bytes
+    */
+    virtual size_t memoryUsage() const;
+
+    /**
+      Answers the number of bytes of the lookup tables, which are shared
+      by every TIA
+
+      @return The number of bytes
+    */
+    static size_t tablesMemoryUsage();
+
     /**
       Reset device to its power-on state
     */
@@ -104,7 +262,55 @@ class TIA : public Device , public MediaSource
     virtual void install(System& system);
 
     /**
-      Saves the current state of this device to the given Serializer.
+      Answers the number of bytes of the state block of the TIA
+
+      @return The size of the state block
+    */
+    virtual size_t stateSize() const;
+
+    /**
+      Moves the state block of the TIA to the given stateSize() bytes of
+      the machine state.
+
+      @param state The bytes to move the block to
+    */
+    virtual void bindState(uint8_t* state);
+
+    /**
+      Answers the function writing the state block of the TIA to a saved
+      state in the portable format.
+
+      @return The writer of the state block
+    */
+    virtual StateWriter stateWriter() const;
+
+    /**
+      Reads the state block of the TIA from a saved state in the given
+      version of the portable format.  The mask pointers are read as
+      offsets into the lookup tables.
+
+      @param in The deserializer device to load from.
+      @param version The version of the format
+      @return The result of the load.  True on success, false on failure.
+    */
+    virtual bool loadState(Deserializer& in, int version);
+
+    /**
+      Notification method invoked by the system right before it overwrites
+      the machine state with a saved one.  Frames still waiting to be drawn
+      are drawn from the state they were emulated in.
+    */
+    virtual void stateRestoring();
+
+    /**
+      Notification method invoked by the system right after it has
+      overwritten the machine state with a saved one.
+    */
+    virtual void stateRestored();
+
+    /**
+      Saves the state of the sound, which is kept outside of the state
+      block, to the given Serializer.
 
       @param out The serializer device to save to.
       @return The result of the save.  True on success, false on failure.
@@ -112,7 +318,8 @@ class TIA : public Device , public MediaSource
     virtual bool save(Serializer& out);
 
     /**
-      Loads the current state of this device from the given Deserializer.
+      Loads the state of the sound, which is kept outside of the state
+      block, from the given Deserializer.
 
       @param in The deserializer device to load from.
       @return The result of the load.  True on success, false on failure.
@@ -147,14 +354,49 @@ class TIA : public Device , public MediaSource
 
       @return Pointer to the current frame buffer
     */
-    uint8_t* currentFrameBuffer() const { return myCurrentFrameBuffer; }
+    uint8_t* currentFrameBuffer() const
+    {
+      if(myFrameLogs[0].pending)
+      {
+        TIA* self = const_cast<TIA*>(this);
+        self->rasteriseFrameBeforeLast();
+        self->rasteriseFrame(0);
+      }
+      return myCurrentFrameBuffer;
+    }
 
     /**
       Answers the previous frame buffer
 
       @return Pointer to the previous frame buffer
     */
-    uint8_t* previousFrameBuffer() const { return myPreviousFrameBuffer; }
+    uint8_t* previousFrameBuffer() const
+    {
+      if(myFrameLogs[1].pending)
+        const_cast<TIA*>(this)->rasteriseFrame(1);
+      return myPreviousFrameBuffer;
+    }
+
+    /**
+      Answers which rows of the current frame buffer differ from the same
+      rows of the previous frame buffer.  Rows are compared as they are
+      drawn; bit (row % 64) of word (row / 64) is set for a row that
+      changed or that this frame has not drawn (yet).
+
+      @return Pointer to DirtyRowWords words
+    */
+    const uint64_t* dirtyRows() const;
+
+    /**
+      Answers the hash of the first rows of the current frame buffer, as
+      ale::hashScreen() would compute it.  Rows are hashed as they are
+      drawn (an unchanged row takes the previous frame's hash), so only
+      rows nothing has hashed yet are read here.
+
+      @param rows The number of rows to hash
+      @return The 64-bit hash
+    */
+    uint64_t frameHash(uint32_t rows) const;
 
     /**
       Answers the height of the frame buffer
@@ -191,6 +433,21 @@ class TIA : public Device , public MediaSource
     */
     void setSound(Sound& sound);
 
+    /**
+      Turns pixel output on or off.  While it is off scanlines go through
+      updateFrameScanlineFast, which only computes collisions.  Pixel
+      output stays off while deferred rendering is on.
+
+      @param fast True to skip writing the frame buffer
+    */
+    void setFastUpdate(bool fast);
+
+    /**
+      Swaps the current and previous frame buffers back, together with
+      their row hashes, undoing the swap of the last frame started.
+    */
+    void swapFrameBuffers();
+
     enum TIABit {
       P0,   // Descriptor for Player 0 Bit
       P1,   // Descriptor for Player 1 Bit
@@ -222,26 +479,35 @@ class TIA : public Device , public MediaSource
     void enableBits(bool mode) { for(uint8_t i = 0; i < 6; ++i) myBitEnabled[i] = mode; }
 
   private:
+    // All of the static lookup tables below, built at compile time
+    struct Tables;
+
     // Compute the ball mask table
-    static void computeBallMaskTable();
+    static constexpr void computeBallMaskTable(Tables& t);
 
     // Compute the collision decode table
-    static void computeCollisionTable();
+    static constexpr void computeCollisionTable(Tables& t);
 
     // Compute the missle mask table
-    static void computeMissleMaskTable();
+    static constexpr void computeMissleMaskTable(Tables& t);
 
     // Compute the player mask table
-    static void computePlayerMaskTable();
+    static constexpr void computePlayerMaskTable(Tables& t);
 
     // Compute the player position reset when table
-    static void computePlayerPositionResetWhenTable();
+    static constexpr void computePlayerPositionResetWhenTable(Tables& t);
 
     // Compute the player reflect table
-    static void computePlayerReflectTable();
+    static constexpr void computePlayerReflectTable(Tables& t);
 
     // Compute playfield mask table
-    static void computePlayfieldMaskTable();
+    static constexpr void computePlayfieldMaskTable(Tables& t);
+
+    // Compute the priority encoder
+    static constexpr void computePriorityEncoder(Tables& t);
+
+    // Compute all of the tables
+    static constexpr Tables computeTables();
 
   private:
     // Update the current frame buffer up to one scanline
@@ -275,6 +541,9 @@ class TIA : public Device , public MediaSource
     // Sound object the TIA is associated with
     Sound* mySound;
 
+    // Indicates if audio register writes are forwarded to the sound object
+    bool mySoundEnabled;
+
   private:
     // Indicates if color loss should be enabled or disabled.  Color loss
     // occurs on PAL (and maybe SECAM) systems when the previous frame
@@ -325,36 +594,9 @@ class TIA : public Device , public MediaSource
     uint32_t myStopDisplayOffset;
 
   private:
-    // Indicates color clocks when the current frame began
-    int myClockWhenFrameStarted;
-
-    // Indicates color clocks when frame should begin to be drawn
-    int myClockStartDisplay;
-
-    // Indicates color clocks when frame should stop being drawn
-    int myClockStopDisplay;
-
-    // Indicates color clocks when the frame was last updated
-    int myClockAtLastUpdate;
-
-    // Indicates how many color clocks remain until the end of
-    // current scanline.  This value is valid during the
-    // displayed portion of the frame.
-    int myClocksToEndOfScanLine;
-
-    // Indicates the total number of scanlines generated by the last frame
-    int myScanlineCountForLastFrame;
-
-    // Indicates the current scanline during a partial frame.
-    int myCurrentScanline;
-
     // Indicates the maximum number of scanlines to be generated for a frame
     int myMaximumNumberOfScanlines;
 
-  private:
-    // Color clock when VSYNC ending causes a new frame to be started
-    int myVSYNCFinishClock;
-
   private:
     enum
     {
@@ -368,97 +610,14 @@ class TIA : public Device , public MediaSource
       PriorityBit = 0x080     // Bit for Playfield priority
     };
 
-    // Bitmap of the objects that should be considered while drawing
-    uint8_t myEnabledObjects;
-
-  private:
-    uint8_t myVSYNC;        // Holds the VSYNC register value
-    uint8_t myVBLANK;       // Holds the VBLANK register value
-
-    uint8_t myNUSIZ0;       // Number and size of player 0 and missle 0
-    uint8_t myNUSIZ1;       // Number and size of player 1 and missle 1
-
-    uint8_t myPlayfieldPriorityAndScore;
-    uint32_t myColor[4];
-    uint8_t myPriorityEncoder[2][256];
-
-    uint32_t& myCOLUBK;       // Background color register (replicated 4 times)
-    uint32_t& myCOLUPF;       // Playfield color register (replicated 4 times)
-    uint32_t& myCOLUP0;       // Player 0 color register (replicated 4 times)
-    uint32_t& myCOLUP1;       // Player 1 color register (replicated 4 times)
-
-    uint8_t myCTRLPF;       // Playfield control register
-
-    bool myREFP0;         // Indicates if player 0 is being reflected
-    bool myREFP1;         // Indicates if player 1 is being reflected
-
-    uint32_t myPF;          // Playfield graphics (19-12:PF2 11-4:PF1 3-0:PF0)
-
-    uint8_t myGRP0;         // Player 0 graphics register
-    uint8_t myGRP1;         // Player 1 graphics register
-
-    uint8_t myDGRP0;        // Player 0 delayed graphics register
-    uint8_t myDGRP1;        // Player 1 delayed graphics register
-
-    bool myENAM0;         // Indicates if missle 0 is enabled
-    bool myENAM1;         // Indicates if missle 0 is enabled
-
-    bool myENABL;         // Indicates if the ball is enabled
-    bool myDENABL;        // Indicates if the virtically delayed ball is enabled
-
-    int8_t myHMP0;          // Player 0 horizontal motion register
-    int8_t myHMP1;          // Player 1 horizontal motion register
-    int8_t myHMM0;          // Missle 0 horizontal motion register
-    int8_t myHMM1;          // Missle 1 horizontal motion register
-    int8_t myHMBL;          // Ball horizontal motion register
-
-    bool myVDELP0;        // Indicates if player 0 is being virtically delayed
-    bool myVDELP1;        // Indicates if player 1 is being virtically delayed
-    bool myVDELBL;        // Indicates if the ball is being virtically delayed
-
-    bool myRESMP0;        // Indicates if missle 0 is reset to player 0
-    bool myRESMP1;        // Indicates if missle 1 is reset to player 1
-
-    uint16_t myCollision;    // Collision register
-
-    // Note that these position registers contain the color clock
-    // on which the object's serial output should begin (0 to 159)
-    int16_t myPOSP0;         // Player 0 position register
-    int16_t myPOSP1;         // Player 1 position register
-    int16_t myPOSM0;         // Missle 0 position register
-    int16_t myPOSM1;         // Missle 1 position register
-    int16_t myPOSBL;         // Ball position register
-
-  private:
-    // Graphics for Player 0 that should be displayed.  This will be
-    // reflected if the player is being reflected.
-    uint8_t myCurrentGRP0;
-
-    // Graphics for Player 1 that should be displayed.  This will be
-    // reflected if the player is being reflected.
-    uint8_t myCurrentGRP1;
-
-    // It's VERY important that the BL, M0, M1, P0 and P1 current
-    // mask pointers are always on a uint32_t boundary.  Otherwise,
-    // the TIA code will fail on a good number of CPUs.
-
-    // Pointer to the currently active mask array for the ball
-    const uint8_t* myCurrentBLMask;
-
-    // Pointer to the currently active mask array for missle 0
-    const uint8_t* myCurrentM0Mask;
-
-    // Pointer to the currently active mask array for missle 1
-    const uint8_t* myCurrentM1Mask;
-
-    // Pointer to the currently active mask array for player 0
-    const uint8_t* myCurrentP0Mask;
-
-    // Pointer to the currently active mask array for player 1
-    const uint8_t* myCurrentP1Mask;
-
-    // Pointer to the currently active mask array for the playfield
-    const uint32_t* myCurrentPFMask;
+    // Indices of the color registers in myColor
+    enum
+    {
+      COLUBK = 0,       // Background color register
+      COLUPF = 1,       // Playfield color register
+      COLUP0 = 2,       // Player 0 color register
+      COLUP1 = 3        // Player 1 color register
+    };
 
     // Audio values. Only used by TIADebug.
     uint8_t myAUDV0;
@@ -469,28 +628,9 @@ class TIA : public Device , public MediaSource
     uint8_t myAUDF1;
 
   private:
-    // Indicates when the dump for paddles was last set
-    int myDumpDisabledCycle;
-
-    // Indicates if the dump is current enabled for the paddles
-    bool myDumpEnabled;
-
-  private:
-    // Color clock when last HMOVE occured
-    int myLastHMOVEClock;
-
-    // Indicates if HMOVE blanks are currently enabled
-    bool myHMOVEBlankEnabled;
-
     // Indicates if we're allowing HMOVE blanks to be enabled
     bool myAllowHMOVEBlanks;
 
-    // TIA M0 "bug" used for stars in Cosmic Ark flag
-    bool myM0CosmicArkMotionEnabled;
-
-    // Counter used for TIA M0 "bug"
-    uint32_t myM0CosmicArkCounter;
-
     // Answers whether specified bits (from TIABit) are enabled or disabled
     bool myBitEnabled[6];
 
@@ -499,19 +639,19 @@ class TIA : public Device , public MediaSource
 
   private:
     // Ball mask table (entries are true or false)
-    static uint8_t ourBallMaskTable[4][4][320];
+    static const uint8_t (&ourBallMaskTable)[4][4][320];
 
     // Used to set the collision register to the correct value
-    static uint16_t ourCollisionTable[64];
+    static const uint16_t (&ourCollisionTable)[64];
 
     // A mask table which can be used when an object is disabled
-    static const uint8_t ourDisabledMaskTable[640];
+    static const uint8_t (&ourDisabledMaskTable)[640];
 
     // Indicates the update delay associated with poking at a TIA address
     static const int16_t ourPokeDelayTable[64];
 
     // Missle mask table (entries are true or false)
-    static uint8_t ourMissleMaskTable[4][8][4][320];
+    static const uint8_t (&ourMissleMaskTable)[4][8][4][320];
 
     // Used to convert value written in a motion register into
     // its internal representation
@@ -521,16 +661,23 @@ class TIA : public Device , public MediaSource
     static const bool ourHMOVEBlankEnableCycles[76];
 
     // Player mask table
-    static uint8_t ourPlayerMaskTable[4][2][8][320];
+    static const uint8_t (&ourPlayerMaskTable)[4][2][8][320];
 
     // Indicates if player is being reset during delay, display or other times
-    static int8_t ourPlayerPositionResetWhenTable[8][160][160];
+    static const int8_t (&ourPlayerPositionResetWhenTable)[8][160][160];
 
     // Used to reflect a players graphics
-    static uint8_t ourPlayerReflectTable[256];
+    static const uint8_t (&ourPlayerReflectTable)[256];
 
     // Playfield mask table for reflected and non-reflected playfields
-    static uint32_t ourPlayfieldTable[2][160];
+    static const uint32_t (&ourPlayfieldTable)[2][160];
+
+    // Maps the enabled object bits to the color register shown, for the
+    // left and right halves of the playfield
+    static const uint8_t (&ourPriorityEncoder)[2][256];
+
+    // Storage for the tables above
+    static const Tables ourTables;
 
   private:
     // Copy constructor isn't supported by this class so make it private
@@ -546,6 +693,131 @@ class TIA : public Device , public MediaSource
     // Updates the frame's scanline but not the frame buffer
     void updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos);
 
+    // Vectorised renderers for the general case of updateFrameScanline
+    // (see TIASimd.cxx).  They handle as many whole vectors of pixels as fit
+    // in clocksToUpdate, update the collision register, advance the frame
+    // pointer and answer the number of pixels handled.  The frame buffer is
+    // only written when draw is true (updateFrameScanlineFast passes false).
+    typedef uint32_t (TIA::*ScanlineKernel)(uint32_t clocksToUpdate,
+                                            uint32_t hpos, bool draw);
+    uint32_t updateFrameScanlineSSE2(uint32_t clocksToUpdate, uint32_t hpos,
+                                     bool draw);
+    uint32_t updateFrameScanlineAVX2(uint32_t clocksToUpdate, uint32_t hpos,
+                                     bool draw);
+
+    // Collision register bits for the objects seen together with each of
+    // P0, M0, P1, M1, BL and PF
+    static uint16_t collisionsFromObjectMasks(const uint8_t* seen);
+
+    // Answers the best renderer this CPU supports, or null for none
+    static ScanlineKernel selectScanlineKernel(bool enabled);
+
+    // The renderer picked for this TIA at construction, or null
+    ScanlineKernel myScanlineKernel;
+
+    // Deferred rendering: while it is on, frames are emulated without
+    // writing the frame buffer (collisions are still computed as the CPU
+    // runs).  Each frame keeps the video registers as they were when it
+    // started plus every write the CPU made to them, and the frame buffer
+    // accessors replay that log through the normal renderer the first time
+    // the frame is looked at.
+
+    // The video state that rendering reads and poke() writes
+    struct RenderState
+    {
+      TIAState state;
+      uint8_t* myFramePointer;
+    };
+
+    // A register write made by the CPU during a frame
+    struct PokeRecord
+    {
+      uint32_t cycles;
+      uint8_t addr;
+      uint8_t value;
+    };
+
+    // Everything needed to draw one frame after the fact
+    struct FrameLog
+    {
+      RenderState start;
+      std::vector<PokeRecord> pokes;
+      int endClock;   // Clock drawn up to when emulation last stopped
+      bool pending;   // True until the frame has been drawn
+    };
+
+    // Starts the log of the current frame afresh from the live state
+    void startFrameLog();
+
+    // Draws the current (0), previous (1) or the frame before last (2) into
+    // its frame buffer by replaying its log
+    void rasteriseFrame(int index);
+
+    // Draws the frame before last if the rows below the end of the current
+    // frame still show it
+    void rasteriseFrameBeforeLast();
+
+    // Draws any frame that is still waiting to be drawn
+    void rasterisePendingFrames();
+
+    // Sets every bit of myDirtyRows
+    void markAllRowsDirty();
+
+    // Hashes of the rows of one frame buffer; a row's hash is only valid
+    // while its bit in valid is set
+    struct RowHashes
+    {
+      uint64_t hash[300];
+      uint64_t valid[DirtyRowWords];
+    };
+
+    // Answers the row hashes of the given frame buffer
+    RowHashes* rowHashesOf(const uint8_t* buffer)
+    {
+      return buffer == myCurrentFrameBuffer ? myCurrentRowHashes :
+                                              myPreviousRowHashes;
+    }
+
+    // Forgets the hash of the row containing the given frame pointer
+    void invalidateRowHash(const uint8_t* pointer);
+
+    // Forgets the hashes of every row of both frame buffers
+    void invalidateRowHashes();
+
+    // Indicates if only the even rows of the frame are rasterised
+    bool myEvenLinesOnly;
+
+    // Rows of the current frame buffer that differ from the previous one
+    uint64_t myDirtyRows[DirtyRowWords];
+
+    // Indicates if myDirtyRows was computed against the finished previous
+    // frame (false if a deferred current frame was drawn before it)
+    bool myDirtyRowsExact;
+
+    // Row hashes of the two frame buffers; the pointers swap with them
+    RowHashes myRowHashes[2];
+    RowHashes* myCurrentRowHashes;
+    RowHashes* myPreviousRowHashes;
+
+    // Indicates if deferred rendering is on
+    bool myDeferredRendering;
+
+    // Indicates if poke() is being called by rasteriseFrame()
+    bool myReplaying;
+
+    // System cycle of the write being replayed
+    uint32_t myReplayCycles;
+
+    // Logs for the current frame [0], the previous frame [1] and the frame
+    // before last [2], which shares its frame buffer with the current frame
+    FrameLog myFrameLogs[3];
+
+  private:
+    // Writes a state block field by field
+    static void writeState(const uint8_t* block, Serializer& out);
+
+    // The registers and timing of the TIA
+    StateView<TIAState> myState;
 };
 
 }  // namespace stella
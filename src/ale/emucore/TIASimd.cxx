@@ -0,0 +1,361 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+//
+// See the file "license" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+//============================================================================
+
+// Vectorised rendering of the general case of TIA::updateFrameScanline.
+// Every object mask is turned into a byte mask for a whole vector of
+// pixels, the priority encoder is applied as a chain of selects from the
+// lowest to the highest priority object, and collisions are gathered per
+// object and folded into the collision register once per span.
+
+#include "ale/emucore/TIA.hxx"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#define TIA_SIMD_X86
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define TIA_SIMD_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+namespace ale {
+namespace stella {
+
+#ifdef TIA_SIMD_X86
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static inline __m128i nonZero(__m128i v)
+{
+  return _mm_xor_si128(_mm_cmpeq_epi8(v, _mm_setzero_si128()),
+                       _mm_set1_epi8(-1));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static inline __m128i select(__m128i mask, __m128i a, __m128i b)
+{
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static inline uint8_t orLanes(__m128i v)
+{
+  v = _mm_or_si128(v, _mm_srli_si128(v, 8));
+  v = _mm_or_si128(v, _mm_srli_si128(v, 4));
+  v = _mm_or_si128(v, _mm_srli_si128(v, 2));
+  v = _mm_or_si128(v, _mm_srli_si128(v, 1));
+  return (uint8_t)_mm_cvtsi128_si32(v);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uint16_t TIA::collisionsFromObjectMasks(const uint8_t* seen)
+{
+  // seen[i] holds every object that was drawn on a pixel together with
+  // object i, so each pair is looked up on its own
+  static const uint8_t bits[6] =
+      { myP0Bit, myM0Bit, myP1Bit, myM1Bit, myBLBit, myPFBit };
+
+  uint16_t collision = 0;
+  for(int i = 0; i < 6; ++i)
+  {
+    uint8_t others = seen[i] & ~bits[i];
+    for(int j = 0; others != 0; ++j, others >>= 1)
+    {
+      if(others & 1)
+        collision |= ourCollisionTable[bits[i] | (1 << j)];
+    }
+  }
+  return collision;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uint32_t TIA::updateFrameScanlineSSE2(uint32_t clocksToUpdate, uint32_t hpos,
+                                      bool draw)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i pf = _mm_set1_epi32((int)myState->myPF);
+  const __m128i grp0 = _mm_set1_epi8((char)myState->myCurrentGRP0);
+  const __m128i grp1 = _mm_set1_epi8((char)myState->myCurrentGRP1);
+  const __m128i colubk = _mm_set1_epi8((char)myState->myColor[COLUBK]);
+  const __m128i colupf = _mm_set1_epi8((char)myState->myColor[COLUPF]);
+  const __m128i colup0 = _mm_set1_epi8((char)myState->myColor[COLUP0]);
+  const __m128i colup1 = _mm_set1_epi8((char)myState->myColor[COLUP1]);
+  const __m128i lanes = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                      8, 9, 10, 11, 12, 13, 14, 15);
+  const __m128i leftEdge = _mm_set1_epi8(79);
+
+  const bool blEnabled = myState->myEnabledObjects & myBLBit;
+  const bool m0Enabled = myState->myEnabledObjects & myM0Bit;
+  const bool m1Enabled = myState->myEnabledObjects & myM1Bit;
+  const bool priority = myState->myPlayfieldPriorityAndScore & PriorityBit;
+  const bool score = myState->myPlayfieldPriorityAndScore & ScoreBit;
+
+  __m128i seenP0 = zero, seenM0 = zero, seenP1 = zero;
+  __m128i seenM1 = zero, seenBL = zero, seenPF = zero;
+
+  uint32_t done = 0;
+  for(; done + 16 <= clocksToUpdate; done += 16, hpos += 16)
+  {
+    // Playfield masks are one uint32_t per pixel
+    const __m128i* pfMask = (const __m128i*)(myState->myCurrentPFMask + hpos);
+    __m128i pf0 = _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128(pfMask + 0), pf), zero);
+    __m128i pf1 = _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128(pfMask + 1), pf), zero);
+    __m128i pf2 = _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128(pfMask + 2), pf), zero);
+    __m128i pf3 = _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128(pfMask + 3), pf), zero);
+    __m128i mPF = _mm_xor_si128(_mm_packs_epi16(_mm_packs_epi32(pf0, pf1),
+                                                _mm_packs_epi32(pf2, pf3)),
+                                _mm_set1_epi8(-1));
+
+    __m128i mP0 = nonZero(_mm_and_si128(
+        _mm_loadu_si128((const __m128i*)(myState->myCurrentP0Mask + hpos)), grp0));
+    __m128i mP1 = nonZero(_mm_and_si128(
+        _mm_loadu_si128((const __m128i*)(myState->myCurrentP1Mask + hpos)), grp1));
+    __m128i mM0 = m0Enabled ?
+        nonZero(_mm_loadu_si128((const __m128i*)(myState->myCurrentM0Mask + hpos))) : zero;
+    __m128i mM1 = m1Enabled ?
+        nonZero(_mm_loadu_si128((const __m128i*)(myState->myCurrentM1Mask + hpos))) : zero;
+    __m128i mBL = blEnabled ?
+        nonZero(_mm_loadu_si128((const __m128i*)(myState->myCurrentBLMask + hpos))) : zero;
+
+    // Objects present on each pixel, as in TIABit
+    __m128i enabled = _mm_or_si128(
+        _mm_or_si128(_mm_and_si128(mP0, _mm_set1_epi8(myP0Bit)),
+                     _mm_and_si128(mM0, _mm_set1_epi8(myM0Bit))),
+        _mm_or_si128(
+            _mm_or_si128(_mm_and_si128(mP1, _mm_set1_epi8(myP1Bit)),
+                         _mm_and_si128(mM1, _mm_set1_epi8(myM1Bit))),
+            _mm_or_si128(_mm_and_si128(mBL, _mm_set1_epi8(myBLBit)),
+                         _mm_and_si128(mPF, _mm_set1_epi8(myPFBit)))));
+
+    seenP0 = _mm_or_si128(seenP0, _mm_and_si128(mP0, enabled));
+    seenM0 = _mm_or_si128(seenM0, _mm_and_si128(mM0, enabled));
+    seenP1 = _mm_or_si128(seenP1, _mm_and_si128(mP1, enabled));
+    seenM1 = _mm_or_si128(seenM1, _mm_and_si128(mM1, enabled));
+    seenBL = _mm_or_si128(seenBL, _mm_and_si128(mBL, enabled));
+    seenPF = _mm_or_si128(seenPF, _mm_and_si128(mPF, enabled));
+
+    if(!draw)
+    {
+      myFramePointer += 16;
+      continue;
+    }
+
+    // Same result as ourPriorityEncoder, lowest priority first
+    __m128i player0 = _mm_or_si128(mP0, mM0);
+    __m128i player1 = _mm_or_si128(mP1, mM1);
+    __m128i color;
+    if(priority)
+    {
+      color = select(player1, colup1, colubk);
+      color = select(player0, colup0, color);
+      color = select(_mm_or_si128(mPF, mBL), colupf, color);
+    }
+    else
+    {
+      __m128i h = _mm_add_epi8(_mm_set1_epi8((char)hpos), lanes);
+      __m128i left = _mm_cmpeq_epi8(_mm_min_epu8(h, leftEdge), h);
+
+      color = select(mBL, colupf, colubk);
+      if(score)
+      {
+        color = select(mPF, select(left, colup0, colup1), color);
+        // Score coloured playfield on the left keeps COLUP0 over player 1
+        player1 = _mm_andnot_si128(_mm_and_si128(mPF, left), player1);
+      }
+      else
+      {
+        color = select(mPF, colupf, color);
+      }
+      color = select(player1, colup1, color);
+      color = select(player0, colup0, color);
+    }
+
+    _mm_storeu_si128((__m128i*)myFramePointer, color);
+    myFramePointer += 16;
+  }
+
+  uint8_t seen[6] = { orLanes(seenP0), orLanes(seenM0), orLanes(seenP1),
+                      orLanes(seenM1), orLanes(seenBL), orLanes(seenPF) };
+  myState->myCollision |= collisionsFromObjectMasks(seen);
+
+  return done;
+}
+
+#ifdef TIA_SIMD_AVX2
+
+#define TIA_AVX2 __attribute__((target("avx2")))
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TIA_AVX2 static inline __m256i nonZero256(__m256i v)
+{
+  return _mm256_xor_si256(_mm256_cmpeq_epi8(v, _mm256_setzero_si256()),
+                          _mm256_set1_epi8(-1));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TIA_AVX2 static inline __m256i select256(__m256i mask, __m256i a, __m256i b)
+{
+  return _mm256_blendv_epi8(b, a, mask);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TIA_AVX2 static inline uint8_t orLanes256(__m256i v)
+{
+  return orLanes(_mm_or_si128(_mm256_castsi256_si128(v),
+                              _mm256_extracti128_si256(v, 1)));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TIA_AVX2 uint32_t TIA::updateFrameScanlineAVX2(uint32_t clocksToUpdate,
+                                               uint32_t hpos, bool draw)
+{
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i pf = _mm256_set1_epi32((int)myState->myPF);
+  const __m256i grp0 = _mm256_set1_epi8((char)myState->myCurrentGRP0);
+  const __m256i grp1 = _mm256_set1_epi8((char)myState->myCurrentGRP1);
+  const __m256i colubk = _mm256_set1_epi8((char)myState->myColor[COLUBK]);
+  const __m256i colupf = _mm256_set1_epi8((char)myState->myColor[COLUPF]);
+  const __m256i colup0 = _mm256_set1_epi8((char)myState->myColor[COLUP0]);
+  const __m256i colup1 = _mm256_set1_epi8((char)myState->myColor[COLUP1]);
+  const __m256i lanes = _mm256_setr_epi8(
+      0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+      16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31);
+  const __m256i leftEdge = _mm256_set1_epi8(79);
+  // Undoes the per 128-bit lane interleaving of the two pack steps
+  const __m256i unpack = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+  const bool blEnabled = myState->myEnabledObjects & myBLBit;
+  const bool m0Enabled = myState->myEnabledObjects & myM0Bit;
+  const bool m1Enabled = myState->myEnabledObjects & myM1Bit;
+  const bool priority = myState->myPlayfieldPriorityAndScore & PriorityBit;
+  const bool score = myState->myPlayfieldPriorityAndScore & ScoreBit;
+
+  __m256i seenP0 = zero, seenM0 = zero, seenP1 = zero;
+  __m256i seenM1 = zero, seenBL = zero, seenPF = zero;
+
+  uint32_t done = 0;
+  for(; done + 32 <= clocksToUpdate; done += 32, hpos += 32)
+  {
+    const __m256i* pfMask = (const __m256i*)(myState->myCurrentPFMask + hpos);
+    __m256i pf0 = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_loadu_si256(pfMask + 0), pf), zero);
+    __m256i pf1 = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_loadu_si256(pfMask + 1), pf), zero);
+    __m256i pf2 = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_loadu_si256(pfMask + 2), pf), zero);
+    __m256i pf3 = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_loadu_si256(pfMask + 3), pf), zero);
+    __m256i packed = _mm256_packs_epi16(_mm256_packs_epi32(pf0, pf1),
+                                        _mm256_packs_epi32(pf2, pf3));
+    __m256i mPF = _mm256_xor_si256(_mm256_permutevar8x32_epi32(packed, unpack),
+                                   _mm256_set1_epi8(-1));
+
+    __m256i mP0 = nonZero256(_mm256_and_si256(
+        _mm256_loadu_si256((const __m256i*)(myState->myCurrentP0Mask + hpos)), grp0));
+    __m256i mP1 = nonZero256(_mm256_and_si256(
+        _mm256_loadu_si256((const __m256i*)(myState->myCurrentP1Mask + hpos)), grp1));
+    __m256i mM0 = m0Enabled ?
+        nonZero256(_mm256_loadu_si256((const __m256i*)(myState->myCurrentM0Mask + hpos))) : zero;
+    __m256i mM1 = m1Enabled ?
+        nonZero256(_mm256_loadu_si256((const __m256i*)(myState->myCurrentM1Mask + hpos))) : zero;
+    __m256i mBL = blEnabled ?
+        nonZero256(_mm256_loadu_si256((const __m256i*)(myState->myCurrentBLMask + hpos))) : zero;
+
+    __m256i enabled = _mm256_or_si256(
+        _mm256_or_si256(_mm256_and_si256(mP0, _mm256_set1_epi8(myP0Bit)),
+                        _mm256_and_si256(mM0, _mm256_set1_epi8(myM0Bit))),
+        _mm256_or_si256(
+            _mm256_or_si256(_mm256_and_si256(mP1, _mm256_set1_epi8(myP1Bit)),
+                            _mm256_and_si256(mM1, _mm256_set1_epi8(myM1Bit))),
+            _mm256_or_si256(_mm256_and_si256(mBL, _mm256_set1_epi8(myBLBit)),
+                            _mm256_and_si256(mPF, _mm256_set1_epi8(myPFBit)))));
+
+    seenP0 = _mm256_or_si256(seenP0, _mm256_and_si256(mP0, enabled));
+    seenM0 = _mm256_or_si256(seenM0, _mm256_and_si256(mM0, enabled));
+    seenP1 = _mm256_or_si256(seenP1, _mm256_and_si256(mP1, enabled));
+    seenM1 = _mm256_or_si256(seenM1, _mm256_and_si256(mM1, enabled));
+    seenBL = _mm256_or_si256(seenBL, _mm256_and_si256(mBL, enabled));
+    seenPF = _mm256_or_si256(seenPF, _mm256_and_si256(mPF, enabled));
+
+    if(!draw)
+    {
+      myFramePointer += 32;
+      continue;
+    }
+
+    __m256i player0 = _mm256_or_si256(mP0, mM0);
+    __m256i player1 = _mm256_or_si256(mP1, mM1);
+    __m256i color;
+    if(priority)
+    {
+      color = select256(player1, colup1, colubk);
+      color = select256(player0, colup0, color);
+      color = select256(_mm256_or_si256(mPF, mBL), colupf, color);
+    }
+    else
+    {
+      __m256i h = _mm256_add_epi8(_mm256_set1_epi8((char)hpos), lanes);
+      __m256i left = _mm256_cmpeq_epi8(_mm256_min_epu8(h, leftEdge), h);
+
+      color = select256(mBL, colupf, colubk);
+      if(score)
+      {
+        color = select256(mPF, select256(left, colup0, colup1), color);
+        player1 = _mm256_andnot_si256(_mm256_and_si256(mPF, left), player1);
+      }
+      else
+      {
+        color = select256(mPF, colupf, color);
+      }
+      color = select256(player1, colup1, color);
+      color = select256(player0, colup0, color);
+    }
+
+    _mm256_storeu_si256((__m256i*)myFramePointer, color);
+    myFramePointer += 32;
+  }
+
+  uint8_t seen[6] = { orLanes256(seenP0), orLanes256(seenM0),
+                      orLanes256(seenP1), orLanes256(seenM1),
+                      orLanes256(seenBL), orLanes256(seenPF) };
+  myState->myCollision |= collisionsFromObjectMasks(seen);
+
+  // Leave the remaining whole vectors to the SSE2 kernel
+  return done + updateFrameScanlineSSE2(clocksToUpdate - done, hpos, draw);
+}
+
+#undef TIA_AVX2
+
+#endif  // TIA_SIMD_AVX2
+
+#endif  // TIA_SIMD_X86
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TIA::ScanlineKernel TIA::selectScanlineKernel(bool enabled)
+{
+  if(!enabled)
+    return 0;
+
+#if defined(TIA_SIMD_AVX2)
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("avx2"))
+    return &TIA::updateFrameScanlineAVX2;
+#endif
+#if defined(TIA_SIMD_X86)
+  return &TIA::updateFrameScanlineSSE2;
+#else
+  return 0;
+#endif
+}
+
+}  // namespace stella
+}  // namespace ale
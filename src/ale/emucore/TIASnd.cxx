@@ -19,6 +19,7 @@
 #include "ale/emucore/System.hxx"
 #include "ale/emucore/TIASnd.hxx"
 #include <cassert>
+#include <cstring>
 
 namespace ale {
 namespace stella {
@@ -146,12 +147,275 @@ void TIASound::volume(uint32_t percent)
     myVolumePercentage = percent;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Clocks the polynomial counters of a channel in distortion mode audc
+static inline void clockPolys(uint8_t audc, uint8_t& p4, uint8_t& p5)
+{
+  switch(audc)
+  {
+    case 0x00:    // Set to 1
+    {
+      // Shift a 1 into the 4-bit register each clock
+      p4 = (p4 << 1) | 0x01;
+      break;
+    }
+
+    case 0x01:    // 4 bit poly
+    {
+      // Clock P4 as a standard 4-bit LSFR taps at bits 3 & 2
+      p4 = (p4 & 0x0f) ?
+          ((p4 << 1) | (((p4 & 0x08) ? 1 : 0) ^
+          ((p4 & 0x04) ? 1 : 0))) : 1;
+      break;
+    }
+
+    case 0x02:    // div 31 -> 4 bit poly
+    {
+      // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
+      p5 = (p5 & 0x1f) ?
+        ((p5 << 1) | (((p5 & 0x10) ? 1 : 0) ^
+        ((p5 & 0x04) ? 1 : 0))) : 1;
+
+      // This does the divide-by 31 with length 13:18
+      if((p5 & 0x0f) == 0x08)
+      {
+        // Clock P4 as a standard 4-bit LSFR taps at bits 3 & 2
+        p4 = (p4 & 0x0f) ?
+            ((p4 << 1) | (((p4 & 0x08) ? 1 : 0) ^
+            ((p4 & 0x04) ? 1 : 0))) : 1;
+      }
+      break;
+    }
+
+    case 0x03:    // 5 bit poly -> 4 bit poly
+    {
+      // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
+      p5 = (p5 & 0x1f) ?
+        ((p5 << 1) | (((p5 & 0x10) ? 1 : 0) ^
+        ((p5 & 0x04) ? 1 : 0))) : 1;
+
+      // P5 clocks the 4 bit poly
+      if(p5 & 0x10)
+      {
+        // Clock P4 as a standard 4-bit LSFR taps at bits 3 & 2
+        p4 = (p4 & 0x0f) ?
+            ((p4 << 1) | (((p4 & 0x08) ? 1 : 0) ^
+            ((p4 & 0x04) ? 1 : 0))) : 1;
+      }
+      break;
+    }
+
+    case 0x04:    // div 2
+    {
+      // Clock P4 toggling the lower bit (divide by 2)
+      p4 = (p4 << 1) | ((p4 & 0x01) ? 0 : 1);
+      break;
+    }
+
+    case 0x05:    // div 2
+    {
+      // Clock P4 toggling the lower bit (divide by 2)
+      p4 = (p4 << 1) | ((p4 & 0x01) ? 0 : 1);
+      break;
+    }
+
+    case 0x06:    // div 31 -> div 2
+    {
+      // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
+      p5 = (p5 & 0x1f) ?
+        ((p5 << 1) | (((p5 & 0x10) ? 1 : 0) ^
+        ((p5 & 0x04) ? 1 : 0))) : 1;
+
+      // This does the divide-by 31 with length 13:18
+      if((p5 & 0x0f) == 0x08)
+      {
+        // Clock P4 toggling the lower bit (divide by 2)
+        p4 = (p4 << 1) | ((p4 & 0x01) ? 0 : 1);
+      }
+      break;
+    }
+
+    case 0x07:    // 5 bit poly -> div 2
+    {
+      // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
+      p5 = (p5 & 0x1f) ?
+        ((p5 << 1) | (((p5 & 0x10) ? 1 : 0) ^
+        ((p5 & 0x04) ? 1 : 0))) : 1;
+
+      // P5 clocks the 4 bit register
+      if(p5 & 0x10)
+      {
+        // Clock P4 toggling the lower bit (divide by 2)
+        p4 = (p4 << 1) | ((p4 & 0x01) ? 0 : 1);
+      }
+      break;
+    }
+
+    case 0x08:    // 9 bit poly
+    {
+      // Clock P5 & P4 as a standard 9-bit LSFR taps at 8 & 4
+      p5 = ((p5 & 0x1f) || (p4 & 0x0f)) ?
+        ((p5 << 1) | (((p4 & 0x08) ? 1 : 0) ^
+        ((p5 & 0x10) ? 1 : 0))) : 1;
+      p4 = (p4 << 1) | ((p5 & 0x20) ? 1 : 0);
+      break;
+    }
+
+    case 0x09:    // 5 bit poly
+    {
+      // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
+      p5 = (p5 & 0x1f) ?
+        ((p5 << 1) | (((p5 & 0x10) ? 1 : 0) ^
+        ((p5 & 0x04) ? 1 : 0))) : 1;
+
+      // Clock value out of P5 into P4 with no modification
+      p4 = (p4 << 1) | ((p5 & 0x20) ? 1 : 0);
+      break;
+    }
+
+    case 0x0a:    // div 31
+    {
+      // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
+      p5 = (p5 & 0x1f) ?
+        ((p5 << 1) | (((p5 & 0x10) ? 1 : 0) ^
+        ((p5 & 0x04) ? 1 : 0))) : 1;
+
+      // This does the divide-by 31 with length 13:18
+      if((p5 & 0x0f) == 0x08)
+      {
+        // Feed bit 4 of P5 into P4 (this will toggle back and forth)
+        p4 = (p4 << 1) | ((p5 & 0x10) ? 1 : 0);
+      }
+      break;
+    }
+
+    case 0x0b:    // Set last 4 bits to 1
+    {
+      // A 1 is shifted into the 4-bit register each clock
+      p4 = (p4 << 1) | 0x01;
+      break;
+    }
+
+    case 0x0c:    // div 6
+    {
+      // Use 4-bit register to generate sequence 000111000111
+      p4 = (~p4 << 1) |
+          ((!(!(p4 & 4) && ((p4 & 7)))) ? 0 : 1);
+      break;
+    }
+
+    case 0x0d:    // div 6
+    {
+      // Use 4-bit register to generate sequence 000111000111
+      p4 = (~p4 << 1) |
+          ((!(!(p4 & 4) && ((p4 & 7)))) ? 0 : 1);
+      break;
+    }
+
+    case 0x0e:    // div 31 -> div 6
+    {
+      // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
+      p5 = (p5 & 0x1f) ?
+        ((p5 << 1) | (((p5 & 0x10) ? 1 : 0) ^
+        ((p5 & 0x04) ? 1 : 0))) : 1;
+
+      // This does the divide-by 31 with length 13:18
+      if((p5 & 0x0f) == 0x08)
+      {
+        // Use 4-bit register to generate sequence 000111000111
+        p4 = (~p4 << 1) |
+            ((!(!(p4 & 4) && ((p4 & 7)))) ? 0 : 1);
+      }
+      break;
+    }
+
+    case 0x0f:    // poly 5 -> div 6
+    {
+      // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
+      p5 = (p5 & 0x1f) ?
+        ((p5 << 1) | (((p5 & 0x10) ? 1 : 0) ^
+        ((p5 & 0x04) ? 1 : 0))) : 1;
+
+      // Use poly 5 to clock 4-bit div register
+      if(p5 & 0x10)
+      {
+        // Use 4-bit register to generate sequence 000111000111
+        p4 = (~p4 << 1) |
+            ((!(!(p4 & 4) && ((p4 & 7)))) ? 0 : 1);
+      }
+      break;
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<uint8_t AUDC>
+void TIASound::mixChannel(uint32_t c, uint8_t volume, uint8_t* buffer, uint32_t samples)
+{
+  FreqDiv& div = myFreqDiv[c];
+  uint8_t p4 = myP4[c];
+  uint8_t p5 = myP5[c];
+
+  for(uint32_t i = 0; i < samples; )
+  {
+    uint32_t run = div.clocksToPulse();
+    if(run > samples - i)
+    {
+      // The buffer fills up before the next pulse
+      run = samples - i;
+      div.skip(run);
+      if(volume && (p4 & 8))
+        for(uint32_t j = i; j < samples; ++j)
+          buffer[j] += volume;
+      break;
+    }
+
+    // The output holds until the clock that pulses
+    if(volume && (p4 & 8))
+      for(uint32_t j = i; j < i + run - 1; ++j)
+        buffer[j] += volume;
+    div.skip(run - 1);
+    div.clock();
+
+    clockPolys(AUDC, p4, p5);
+    if(volume && (p4 & 8))
+      buffer[i + run - 1] += volume;
+    i += run;
+  }
+
+  myP4[c] = p4;
+  myP5[c] = p5;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const TIASound::Mixer TIASound::ourMixers[16] = {
+  &TIASound::mixChannel<0x00>, &TIASound::mixChannel<0x01>,
+  &TIASound::mixChannel<0x02>, &TIASound::mixChannel<0x03>,
+  &TIASound::mixChannel<0x04>, &TIASound::mixChannel<0x05>,
+  &TIASound::mixChannel<0x06>, &TIASound::mixChannel<0x07>,
+  &TIASound::mixChannel<0x08>, &TIASound::mixChannel<0x09>,
+  &TIASound::mixChannel<0x0a>, &TIASound::mixChannel<0x0b>,
+  &TIASound::mixChannel<0x0c>, &TIASound::mixChannel<0x0d>,
+  &TIASound::mixChannel<0x0e>, &TIASound::mixChannel<0x0f>
+};
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIASound::process(uint8_t* buffer, uint32_t samples)
 {
   int v0 = ((myAUDV[0] << 2) * myVolumePercentage) / 100;
   int v1 = ((myAUDV[1] << 2) * myVolumePercentage) / 100;
 
+  // When every TIA clock makes exactly one mono sample, the channels are
+  // mixed one after the other into the buffer
+  if(myChannels == 1 && myOutputFrequency == myTIAFrequency &&
+     myOutputCounter >= 0 && myOutputCounter < myTIAFrequency)
+  {
+    std::memset(buffer, myVolumeClip, samples);
+    (this->*ourMixers[myAUDC[0]])(0, v0, buffer, samples);
+    (this->*ourMixers[myAUDC[1]])(1, v1, buffer, samples);
+    return;
+  }
+
   // Loop until the sample buffer is full
   while(samples > 0)
   {
@@ -160,203 +424,7 @@ void TIASound::process(uint8_t* buffer, uint32_t samples)
     {
       // Update P4 & P5 registers for channel if freq divider outputs a pulse
       if((myFreqDiv[c].clock()))
-      {
-        switch(myAUDC[c])
-        {
-          case 0x00:    // Set to 1
-          {
-            // Shift a 1 into the 4-bit register each clock
-            myP4[c] = (myP4[c] << 1) | 0x01;
-            break;
-          }
-
-          case 0x01:    // 4 bit poly
-          {
-            // Clock P4 as a standard 4-bit LSFR taps at bits 3 & 2
-            myP4[c] = (myP4[c] & 0x0f) ?
-                ((myP4[c] << 1) | (((myP4[c] & 0x08) ? 1 : 0) ^
-                ((myP4[c] & 0x04) ? 1 : 0))) : 1;
-            break;
-          }
-
-          case 0x02:    // div 31 -> 4 bit poly
-          {
-            // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
-            myP5[c] = (myP5[c] & 0x1f) ?
-              ((myP5[c] << 1) | (((myP5[c] & 0x10) ? 1 : 0) ^
-              ((myP5[c] & 0x04) ? 1 : 0))) : 1;
-
-            // This does the divide-by 31 with length 13:18
-            if((myP5[c] & 0x0f) == 0x08)
-            {
-              // Clock P4 as a standard 4-bit LSFR taps at bits 3 & 2
-              myP4[c] = (myP4[c] & 0x0f) ?
-                  ((myP4[c] << 1) | (((myP4[c] & 0x08) ? 1 : 0) ^
-                  ((myP4[c] & 0x04) ? 1 : 0))) : 1;
-            }
-            break;
-          }
-
-          case 0x03:    // 5 bit poly -> 4 bit poly
-          {
-            // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
-            myP5[c] = (myP5[c] & 0x1f) ?
-              ((myP5[c] << 1) | (((myP5[c] & 0x10) ? 1 : 0) ^
-              ((myP5[c] & 0x04) ? 1 : 0))) : 1;
-
-            // P5 clocks the 4 bit poly
-            if(myP5[c] & 0x10)
-            {
-              // Clock P4 as a standard 4-bit LSFR taps at bits 3 & 2
-              myP4[c] = (myP4[c] & 0x0f) ?
-                  ((myP4[c] << 1) | (((myP4[c] & 0x08) ? 1 : 0) ^
-                  ((myP4[c] & 0x04) ? 1 : 0))) : 1;
-            }
-            break;
-          }
-
-          case 0x04:    // div 2
-          {
-            // Clock P4 toggling the lower bit (divide by 2)
-            myP4[c] = (myP4[c] << 1) | ((myP4[c] & 0x01) ? 0 : 1);
-            break;
-          }
-
-          case 0x05:    // div 2
-          {
-            // Clock P4 toggling the lower bit (divide by 2)
-            myP4[c] = (myP4[c] << 1) | ((myP4[c] & 0x01) ? 0 : 1);
-            break;
-          }
-
-          case 0x06:    // div 31 -> div 2
-          {
-            // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
-            myP5[c] = (myP5[c] & 0x1f) ?
-              ((myP5[c] << 1) | (((myP5[c] & 0x10) ? 1 : 0) ^
-              ((myP5[c] & 0x04) ? 1 : 0))) : 1;
-
-            // This does the divide-by 31 with length 13:18
-            if((myP5[c] & 0x0f) == 0x08)
-            {
-              // Clock P4 toggling the lower bit (divide by 2)
-              myP4[c] = (myP4[c] << 1) | ((myP4[c] & 0x01) ? 0 : 1);
-            }
-            break;
-          }
-
-          case 0x07:    // 5 bit poly -> div 2
-          {
-            // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
-            myP5[c] = (myP5[c] & 0x1f) ?
-              ((myP5[c] << 1) | (((myP5[c] & 0x10) ? 1 : 0) ^
-              ((myP5[c] & 0x04) ? 1 : 0))) : 1;
-
-            // P5 clocks the 4 bit register
-            if(myP5[c] & 0x10)
-            {
-              // Clock P4 toggling the lower bit (divide by 2)
-              myP4[c] = (myP4[c] << 1) | ((myP4[c] & 0x01) ? 0 : 1);
-            }
-            break;
-          }
-
-          case 0x08:    // 9 bit poly
-          {
-            // Clock P5 & P4 as a standard 9-bit LSFR taps at 8 & 4
-            myP5[c] = ((myP5[c] & 0x1f) || (myP4[c] & 0x0f)) ?
-              ((myP5[c] << 1) | (((myP4[c] & 0x08) ? 1 : 0) ^
-              ((myP5[c] & 0x10) ? 1 : 0))) : 1;
-            myP4[c] = (myP4[c] << 1) | ((myP5[c] & 0x20) ? 1 : 0);
-            break;
-          }
-
-          case 0x09:    // 5 bit poly
-          {
-            // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
-            myP5[c] = (myP5[c] & 0x1f) ?
-              ((myP5[c] << 1) | (((myP5[c] & 0x10) ? 1 : 0) ^
-              ((myP5[c] & 0x04) ? 1 : 0))) : 1;
-
-            // Clock value out of P5 into P4 with no modification
-            myP4[c] = (myP4[c] << 1) | ((myP5[c] & 0x20) ? 1 : 0);
-            break;
-          }
-
-          case 0x0a:    // div 31
-          {
-            // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
-            myP5[c] = (myP5[c] & 0x1f) ?
-              ((myP5[c] << 1) | (((myP5[c] & 0x10) ? 1 : 0) ^
-              ((myP5[c] & 0x04) ? 1 : 0))) : 1;
-
-            // This does the divide-by 31 with length 13:18
-            if((myP5[c] & 0x0f) == 0x08)
-            {
-              // Feed bit 4 of P5 into P4 (this will toggle back and forth)
-              myP4[c] = (myP4[c] << 1) | ((myP5[c] & 0x10) ? 1 : 0);
-            }
-            break;
-          }
-
-          case 0x0b:    // Set last 4 bits to 1
-          {
-            // A 1 is shifted into the 4-bit register each clock
-            myP4[c] = (myP4[c] << 1) | 0x01;
-            break;
-          }
-
-          case 0x0c:    // div 6
-          {
-            // Use 4-bit register to generate sequence 000111000111
-            myP4[c] = (~myP4[c] << 1) |
-                ((!(!(myP4[c] & 4) && ((myP4[c] & 7)))) ? 0 : 1);
-            break;
-          }
-
-          case 0x0d:    // div 6
-          {
-            // Use 4-bit register to generate sequence 000111000111
-            myP4[c] = (~myP4[c] << 1) |
-                ((!(!(myP4[c] & 4) && ((myP4[c] & 7)))) ? 0 : 1);
-            break;
-          }
-
-          case 0x0e:    // div 31 -> div 6
-          {
-            // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
-            myP5[c] = (myP5[c] & 0x1f) ?
-              ((myP5[c] << 1) | (((myP5[c] & 0x10) ? 1 : 0) ^
-              ((myP5[c] & 0x04) ? 1 : 0))) : 1;
-
-            // This does the divide-by 31 with length 13:18
-            if((myP5[c] & 0x0f) == 0x08)
-            {
-              // Use 4-bit register to generate sequence 000111000111
-              myP4[c] = (~myP4[c] << 1) |
-                  ((!(!(myP4[c] & 4) && ((myP4[c] & 7)))) ? 0 : 1);
-            }
-            break;
-          }
-
-          case 0x0f:    // poly 5 -> div 6
-          {
-            // Clock P5 as a standard 5-bit LSFR taps at bits 4 & 2
-            myP5[c] = (myP5[c] & 0x1f) ?
-              ((myP5[c] << 1) | (((myP5[c] & 0x10) ? 1 : 0) ^
-              ((myP5[c] & 0x04) ? 1 : 0))) : 1;
-
-            // Use poly 5 to clock 4-bit div register
-            if(myP5[c] & 0x10)
-            {
-              // Use 4-bit register to generate sequence 000111000111
-              myP4[c] = (~myP4[c] << 1) |
-                  ((!(!(myP4[c] & 4) && ((myP4[c] & 7)))) ? 0 : 1);
-            }
-            break;
-          }
-        }
-      }
+        clockPolys(myAUDC[c], myP4[c], myP5[c]);
     }
 
     myOutputCounter += myOutputFrequency;
@@ -129,11 +129,38 @@ class TIASound
           return false;
         }
 
+        // Answers the number of clocks up to and including the next pulse
+        uint32_t clocksToPulse() const
+        {
+          return myCounter < myDivideByValue ? myDivideByValue - myCounter + 1 : 1;
+        }
+
+        // Advances by fewer clocks than clocksToPulse()
+        void skip(uint32_t clocks)
+        {
+          myCounter += clocks;
+        }
+
       private:
         uint32_t myDivideByValue;
         uint32_t myCounter;
     };
 
+  private:
+    /**
+      Adds the output of the given channel, in distortion mode AUDC, to the
+      given mono samples when every TIA clock makes exactly one sample.  The
+      output only changes on the pulses of the channel's frequency divider,
+      so it is added in runs between them.
+    */
+    template<uint8_t AUDC>
+    void mixChannel(uint32_t c, uint8_t volume, uint8_t* buffer, uint32_t samples);
+
+    typedef void (TIASound::*Mixer)(uint32_t, uint8_t, uint8_t*, uint32_t);
+
+    // mixChannel for each of the 16 distortion modes
+    static const Mixer ourMixers[16];
+
   private:
     uint8_t myAUDC[2];
     uint8_t myAUDF[2];
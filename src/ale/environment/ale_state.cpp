@@ -72,7 +72,9 @@ void ALEState::load(OSystem* osystem, RomSettings* settings, Random* rng, std::s
   // Deserialize the stored string into the emulator state
   Deserializer deser(rhs.m_serialized_state);
 
-  osystem->console().system().loadState(md5, deser);
+  if (!osystem->console().system().loadState(md5, deser))
+    throw std::runtime_error("Could not restore the state: it belongs to "
+                             "another ROM or is damaged");
   settings->loadState(deser);
   bool rng_included = deser.getBool();
   if (rng_included) {
@@ -103,7 +105,10 @@ ALEState ALEState::save(OSystem* osystem, RomSettings* settings, std::optional<R
   }
 
   // Now make a copy of this state, also storing the emulator serialization
-  return ALEState(*this, ser.get_str());
+  // and the layout needed to make it portable
+  ALEState state(*this, ser.get_str());
+  state.m_state_layout = osystem->console().system().stateLayout();
+  return state;
 }
 
 void ALEState::incrementFrame(int steps /* = 1 */) {
@@ -122,7 +127,7 @@ std::string ALEState::serialize() {
   ser.putInt(this->m_episode_frame_number);
   ser.putInt(this->m_mode);
   ser.putInt(this->m_difficulty);
-  ser.putString(this->m_serialized_state);
+  ser.putString(this->portableState());
   ser.putInt(this->m_paddle_min);
   ser.putInt(this->m_paddle_max);
 
@@ -488,8 +493,20 @@ void ALEState::resetKeys(Event* event) {
   setDifficultySwitches(event, m_difficulty);
 }
 
+std::string ALEState::portableState() const {
+  // The machine state is raw in memory, and written field by field
+  if (m_state_layout) {
+    return System::portableState(m_serialized_state, *m_state_layout);
+  }
+  return m_serialized_state;
+}
+
 bool ALEState::equals(ALEState& rhs) {
-  return (rhs.m_serialized_state == this->m_serialized_state &&
+  // Raw states are only comparable if they were laid out alike
+  bool same_state = rhs.m_state_layout == this->m_state_layout
+                        ? rhs.m_serialized_state == this->m_serialized_state
+                        : rhs.portableState() == this->portableState();
+  return (same_state &&
           rhs.m_left_paddle == this->m_left_paddle &&
           rhs.m_right_paddle == this->m_right_paddle &&
           rhs.m_frame_number == this->m_frame_number &&
@@ -18,6 +18,7 @@
 #ifndef __ALE_STATE_HPP__
 #define __ALE_STATE_HPP__
 
+#include <memory>
 #include <string>
 #include <optional>
 
@@ -31,6 +32,10 @@ namespace ale {
 
 class RomSettings;
 
+namespace stella {
+struct StateLayout;
+}  // namespace stella
+
 #define PADDLE_DELTA 23000
 // MGB Values taken from Paddles.cxx (Stella 3.3) - 1400000 * [5,235] / 255
 #define PADDLE_MIN 27450
@@ -128,6 +133,9 @@ class ALEState {
   /** Applies the current difficulty setting, which is effectively part of the action */
   void setDifficultySwitches(stella::Event* event, unsigned int value);
 
+  /** Answers the stored environment state, with its machine state written field by field */
+  std::string portableState() const;
+
  private:
   int m_left_paddle;               // Current value for the left-paddle
   int m_right_paddle;              // Current value for the right-paddle
@@ -140,6 +148,9 @@ class ALEState {
 
   std::string m_serialized_state;  // The stored environment state, if this is a saved state
 
+  // The layout of the raw machine state in m_serialized_state, if it has one
+  std::shared_ptr<const stella::StateLayout> m_state_layout;
+
   game_mode_t m_mode;              // The current mode we are in
   difficulty_t m_difficulty;       // The current difficulty we are in
 };
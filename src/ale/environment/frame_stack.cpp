@@ -0,0 +1,58 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  frame_stack.cpp
+ *
+ *  Ring buffer of the last K observations of an environment.
+ *
+ **************************************************************************** */
+
+#include "ale/environment/frame_stack.hpp"
+
+#include <cstring>
+
+namespace ale {
+
+FrameStack::FrameStack(int depth, size_t frame_bytes)
+    : m_depth(depth),
+      m_frame_bytes(frame_bytes),
+      m_head(depth - 1),
+      m_storage((size_t)depth * frame_bytes, 0),
+      m_data(m_storage.data()) {}
+
+void FrameStack::setBuffer(uint8_t* buffer) {
+  uint8_t* target = buffer != NULL ? buffer : m_storage.data();
+  if (target != m_data)
+    std::memcpy(target, m_data, size());
+  m_data = target;
+}
+
+uint8_t* FrameStack::advance() {
+  m_head = (m_head + 1) % m_depth;
+  return m_data + m_head * m_frame_bytes;
+}
+
+void FrameStack::fillFromHead() {
+  const uint8_t* newest = m_data + m_head * m_frame_bytes;
+  for (int i = 0; i < m_depth; i++) {
+    if (i != m_head)
+      std::memcpy(m_data + i * m_frame_bytes, newest, m_frame_bytes);
+  }
+}
+
+void FrameStack::copyOrdered(uint8_t* dst) const {
+  // The oldest observation is in the slot after the head
+  int oldest = (m_head + 1) % m_depth;
+  size_t tail = (m_depth - oldest) * m_frame_bytes;
+  std::memcpy(dst, m_data + oldest * m_frame_bytes, tail);
+  std::memcpy(dst + tail, m_data, oldest * m_frame_bytes);
+}
+
+}  // namespace ale
@@ -0,0 +1,74 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  frame_stack.hpp
+ *
+ *  Ring buffer of the last K observations of an environment.
+ *
+ **************************************************************************** */
+
+#ifndef __FRAME_STACK_HPP__
+#define __FRAME_STACK_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ale {
+
+/** Holds the last `depth` observations in `depth` fixed slots. Each new
+ *  observation is written into the slot after the head, which then becomes
+ *  the head, so older observations are never moved: slot
+ *  (head - k) mod depth holds the observation k steps back. */
+class FrameStack {
+ public:
+  FrameStack(int depth, size_t frame_bytes);
+
+  int depth() const { return m_depth; }
+  size_t frameBytes() const { return m_frame_bytes; }
+
+  /** Bytes of all the slots, depth * frameBytes(). */
+  size_t size() const { return m_depth * m_frame_bytes; }
+
+  /** The slots, back to back, and the slot of the newest observation. */
+  const uint8_t* data() const { return m_data; }
+  int head() const { return m_head; }
+
+  /** Bytes held by the stack, including the object itself; slots in caller
+   *  memory are not counted. */
+  size_t memoryUsage() const { return sizeof(*this) + m_storage.capacity(); }
+
+  /** Keeps the slots in caller memory of size() bytes from now on, or in
+   *  memory of our own if buffer is NULL. The current contents are copied
+   *  across. */
+  void setBuffer(uint8_t* buffer);
+
+  /** Moves the head to the next slot and returns it, to be written with the
+   *  newest observation. */
+  uint8_t* advance();
+
+  /** Copies the head slot into every other slot, so that a new episode does
+   *  not see observations of the previous one. */
+  void fillFromHead();
+
+  /** Writes the observations into dst from oldest to newest. */
+  void copyOrdered(uint8_t* dst) const;
+
+ private:
+  int m_depth;
+  size_t m_frame_bytes;
+  int m_head;
+  std::vector<uint8_t> m_storage;  // Used unless the caller supplies memory
+  uint8_t* m_data;                 // Either m_storage or caller memory
+};
+
+}  // namespace ale
+
+#endif  // __FRAME_STACK_HPP__
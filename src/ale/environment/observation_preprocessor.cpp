@@ -0,0 +1,309 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  observation_preprocessor.cpp
+ *
+ *  DQN-style observation preprocessing (max-pool of the last two frames,
+ *  palette conversion and resizing) done inside the environment.
+ *
+ **************************************************************************** */
+
+#include "ale/environment/observation_preprocessor.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#if (defined(__x86_64__) || defined(_M_X64) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define PREPROCESSOR_SIMD_AVX2
+#include <immintrin.h>
+#endif
+
+namespace ale {
+namespace {
+
+// Horizontal pass over one row: n output bytes, each the weighted sum (or
+// with max, the maximum over the covered taps) of `taps` floats of row
+
+void filterRowScalar(const float* row, const int* index, const float* weights,
+                     int n, int taps, int channels, bool max, int start,
+                     uint8_t* out) {
+  for (int e = start; e < n; e++) {
+    const float* in = row + index[e];
+    float sum = 0.0f;
+    if (max) {
+      // Padding taps have zero weight and are not covered
+      for (int t = 0; t < taps; t++)
+        if (weights[(size_t)t * n + e] != 0.0f)
+          sum = std::max(sum, in[t * channels]);
+    } else {
+      for (int t = 0; t < taps; t++)
+        sum += weights[(size_t)t * n + e] * in[t * channels];
+    }
+    out[e] = (uint8_t)std::min(sum + 0.5f, 255.0f);
+  }
+}
+
+#ifdef PREPROCESSOR_SIMD_AVX2
+#define PREPROCESSOR_AVX2 __attribute__((target("avx2")))
+
+// The same for 8 output bytes at a time, gathering each tap's inputs, and
+// answers how many bytes it did. The sums are formed in the scalar order, so
+// the results are identical. The weights of max are 0 or 1 and the inputs
+// are not negative, so weight * input drops the padding taps.
+PREPROCESSOR_AVX2 int filterRowAVX2(const float* row, const int* index,
+                                    const float* weights, int n, int taps,
+                                    int channels, bool max, uint8_t* out) {
+  const __m256 half = _mm256_set1_ps(0.5f);
+  const __m256 limit = _mm256_set1_ps(255.0f);
+  const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  int e = 0;
+  for (; e + 8 <= n; e += 8) {
+    __m256i first = _mm256_loadu_si256((const __m256i*)(index + e));
+    __m256 sum = _mm256_setzero_ps();
+    for (int t = 0; t < taps; t++) {
+      __m256i at = _mm256_add_epi32(first, _mm256_set1_epi32(t * channels));
+      __m256 in = _mm256_i32gather_ps(row, at, 4);
+      __m256 w = _mm256_loadu_ps(weights + (size_t)t * n + e);
+      sum = max ? _mm256_max_ps(sum, _mm256_mul_ps(w, in))
+                : _mm256_add_ps(sum, _mm256_mul_ps(w, in));
+    }
+    __m256i value = _mm256_cvttps_epi32(
+        _mm256_min_ps(_mm256_add_ps(sum, half), limit));
+    __m256i words = _mm256_packus_epi32(value, value);
+    __m256i bytes = _mm256_permutevar8x32_epi32(
+        _mm256_packus_epi16(words, words), order);
+    _mm_storel_epi64((__m128i*)(out + e), _mm256_castsi256_si128(bytes));
+  }
+  return e;
+}
+#endif  // PREPROCESSOR_SIMD_AVX2
+
+}  // namespace
+
+ObservationPreprocessor::ObservationPreprocessor(int src_width, int src_height,
+                                                 int dst_width, int dst_height,
+                                                 bool max_pool,
+                                                 Interpolation interpolation)
+    : m_src_width(src_width),
+      m_src_height(src_height),
+      m_dst_width(dst_width > 0 ? dst_width : src_width),
+      m_dst_height(dst_height > 0 ? dst_height : src_height),
+      m_max_pool(max_pool),
+      m_interpolation(interpolation) {
+  m_x_filter = makeFilter(m_src_width, m_dst_width, interpolation);
+  m_y_filter = makeFilter(m_src_height, m_dst_height, interpolation);
+
+  // Room for the widest format (RGBA)
+  size_t frame_bytes = (size_t)m_src_width * m_src_height * 4;
+  m_frame.resize(frame_bytes);
+  if (m_max_pool)
+    m_previous.resize(frame_bytes);
+}
+
+ObservationPreprocessor::Interpolation
+ObservationPreprocessor::parseInterpolation(const std::string& name) {
+  if (name == "nearest")
+    return INTERP_NEAREST;
+  if (name == "bilinear")
+    return INTERP_BILINEAR;
+  if (name == "area")
+    return INTERP_AREA;
+  if (name == "max")
+    return INTERP_MAX;
+  throw std::runtime_error("Unknown observation_interpolation '" + name +
+                           "' (expected nearest, bilinear, area or max)");
+}
+
+bool ObservationPreprocessor::resizes() const {
+  return m_dst_width != m_src_width || m_dst_height != m_src_height;
+}
+
+bool ObservationPreprocessor::supports(ObservationFormat format) const {
+  if (format != OBS_PALETTE_INDEX)
+    return true;
+  return !m_max_pool && (!resizes() || m_interpolation == INTERP_NEAREST);
+}
+
+size_t ObservationPreprocessor::memoryUsage() const {
+  size_t bytes =
+      sizeof(*this) +
+      (m_x_filter.first.capacity() + m_y_filter.first.capacity()) * sizeof(int) +
+      (m_x_filter.weights.capacity() + m_y_filter.weights.capacity() +
+       m_rows.capacity()) * sizeof(float) +
+      m_frame.capacity() + m_previous.capacity();
+  for (const RowFilter& filter : m_row_filters) {
+    bytes += filter.index.capacity() * sizeof(int) +
+             filter.weights.capacity() * sizeof(float);
+  }
+  return bytes;
+}
+
+ObservationPreprocessor::AxisFilter
+ObservationPreprocessor::makeFilter(int src_size, int dst_size,
+                                    Interpolation interpolation) {
+  // Collect the (source pixel, weight) pairs of every output pixel
+  std::vector<std::vector<std::pair<int, float>>> contributions(dst_size);
+  double scale = (double)src_size / dst_size;
+  for (int i = 0; i < dst_size; i++) {
+    std::vector<std::pair<int, float>>& c = contributions[i];
+    switch (interpolation) {
+      case INTERP_NEAREST: {
+        int j = std::min((int)((i + 0.5) * scale), src_size - 1);
+        c.push_back(std::make_pair(j, 1.0f));
+        break;
+      }
+      case INTERP_BILINEAR: {
+        double centre = std::max((i + 0.5) * scale - 0.5, 0.0);
+        int j = std::min((int)centre, src_size - 1);
+        float f = (float)(centre - j);
+        if (j + 1 < src_size && f > 0) {
+          c.push_back(std::make_pair(j, 1.0f - f));
+          c.push_back(std::make_pair(j + 1, f));
+        } else {
+          c.push_back(std::make_pair(j, 1.0f));
+        }
+        break;
+      }
+      case INTERP_AREA:
+      case INTERP_MAX: {
+        // Max only needs to know which pixels are covered, so weights are 1
+        double start = i * scale;
+        double end = (i + 1) * scale;
+        for (int j = (int)start; j < src_size && j < end; j++) {
+          double overlap = std::min(end, j + 1.0) - std::max(start, (double)j);
+          if (overlap > 0) {
+            float w = interpolation == INTERP_MAX ? 1.0f : (float)(overlap / scale);
+            c.push_back(std::make_pair(j, w));
+          }
+        }
+        break;
+      }
+    }
+  }
+
+  // Lay them out with a fixed number of taps, padding with zero weights
+  AxisFilter filter;
+  filter.taps = 1;
+  for (int i = 0; i < dst_size; i++)
+    filter.taps = std::max(filter.taps, (int)contributions[i].size());
+  filter.first.resize(dst_size);
+  filter.weights.assign((size_t)dst_size * filter.taps, 0.0f);
+  for (int i = 0; i < dst_size; i++) {
+    int first = std::max(0, std::min(contributions[i].front().first,
+                                     src_size - filter.taps));
+    filter.first[i] = first;
+    for (size_t k = 0; k < contributions[i].size(); k++) {
+      int tap = contributions[i][k].first - first;
+      filter.weights[(size_t)i * filter.taps + tap] = contributions[i][k].second;
+    }
+  }
+  return filter;
+}
+
+const ObservationPreprocessor::RowFilter&
+ObservationPreprocessor::rowFilter(int channels) {
+  RowFilter& filter = m_row_filters[channels - 1];
+  if (filter.index.empty()) {
+    int taps = m_x_filter.taps;
+    int n = m_dst_width * channels;
+    filter.index.resize(n);
+    filter.weights.resize((size_t)taps * n);
+    for (int e = 0; e < n; e++) {
+      int x = e / channels;
+      filter.index[e] = m_x_filter.first[x] * channels + e % channels;
+      for (int t = 0; t < taps; t++) {
+        filter.weights[(size_t)t * n + e] =
+            m_x_filter.weights[(size_t)x * taps + t];
+      }
+    }
+  }
+  return filter;
+}
+
+void ObservationPreprocessor::process(const ColourPalette& palette,
+                                      const uint8_t* frame,
+                                      const uint8_t* previous,
+                                      ObservationFormat format, uint8_t* dst) {
+  size_t pixels = (size_t)m_src_width * m_src_height;
+  size_t frame_bytes = pixels * ColourPalette::bytesPerPixel(format);
+
+  // Without resizing the converted (and pooled) frame is the observation
+  uint8_t* converted = resizes() ? m_frame.data() : dst;
+  palette.applyPalette(converted, frame, pixels, format);
+
+  if (m_max_pool && previous != NULL) {
+    palette.applyPalette(m_previous.data(), previous, pixels, format);
+    const uint8_t* other = m_previous.data();
+    // Plain loop on purpose: it compiles to packed unsigned byte maxima
+    for (size_t i = 0; i < frame_bytes; i++)
+      converted[i] = std::max(converted[i], other[i]);
+  }
+
+  if (!resizes())
+    return;
+
+  if (format == OBS_RGB_PLANAR) {
+    size_t dst_plane = (size_t)m_dst_width * m_dst_height;
+    for (int c = 0; c < 3; c++)
+      resizePlane(converted + c * pixels, 1, dst + c * dst_plane,
+                  palette.simdEnabled());
+  } else {
+    resizePlane(converted, (int)ColourPalette::bytesPerPixel(format), dst,
+                palette.simdEnabled());
+  }
+}
+
+void ObservationPreprocessor::resizePlane(const uint8_t* src, int channels,
+                                          uint8_t* dst, bool simd) {
+  // Vertical pass: whole rows at a time, so the inner loop runs over
+  // contiguous bytes and vectorises
+  size_t row_length = (size_t)m_src_width * channels;
+  m_rows.assign((size_t)m_dst_height * row_length, 0.0f);
+  for (int y = 0; y < m_dst_height; y++) {
+    float* row = &m_rows[y * row_length];
+    const float* weights = &m_y_filter.weights[(size_t)y * m_y_filter.taps];
+    for (int t = 0; t < m_y_filter.taps; t++) {
+      float w = weights[t];
+      if (w == 0.0f)
+        continue;
+      const uint8_t* s = src + (m_y_filter.first[y] + t) * row_length;
+      if (m_interpolation == INTERP_MAX) {
+        for (size_t k = 0; k < row_length; k++)
+          row[k] = std::max(row[k], (float)s[k]);
+      } else {
+        for (size_t k = 0; k < row_length; k++)
+          row[k] += w * s[k];
+      }
+    }
+  }
+
+  // Horizontal pass: one row filter over all the bytes of each output row,
+  // so the channels are handled alike and the AVX2 kernel takes 8 at a time
+  const RowFilter& filter = rowFilter(channels);
+  bool max = m_interpolation == INTERP_MAX;
+  int n = m_dst_width * channels;
+  for (int y = 0; y < m_dst_height; y++) {
+    const float* row = &m_rows[y * row_length];
+    uint8_t* out = dst + (size_t)y * n;
+    int done = 0;
+#ifdef PREPROCESSOR_SIMD_AVX2
+    if (simd) {
+      done = filterRowAVX2(row, filter.index.data(), filter.weights.data(), n,
+                           m_x_filter.taps, channels, max, out);
+    }
+#endif
+    filterRowScalar(row, filter.index.data(), filter.weights.data(), n,
+                    m_x_filter.taps, channels, max, done, out);
+  }
+}
+
+}  // namespace ale
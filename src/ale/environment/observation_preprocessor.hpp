@@ -0,0 +1,118 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  observation_preprocessor.hpp
+ *
+ *  DQN-style observation preprocessing (max-pool of the last two frames,
+ *  palette conversion and resizing) done inside the environment.
+ *
+ **************************************************************************** */
+
+#ifndef __OBSERVATION_PREPROCESSOR_HPP__
+#define __OBSERVATION_PREPROCESSOR_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ale/common/ColourPalette.hpp"
+#include "ale/common/Constants.h"
+
+namespace ale {
+
+class ObservationPreprocessor {
+ public:
+  enum Interpolation {
+    INTERP_NEAREST,   // The source pixel under the output pixel's centre,
+                      // floor((i + 0.5) * src / dst); 2i + 1 when halving
+    INTERP_BILINEAR,  // Linear in x and y between the four nearest pixels
+    INTERP_AREA,      // Average over the source area the output pixel covers
+    INTERP_MAX        // Maximum over the source area the output pixel covers
+  };
+
+  /** Sets up preprocessing of src_width x src_height frames into dst_width x
+   *  dst_height observations; a dimension of 0 keeps the source size. With
+   *  max_pool, each observation is the per-channel maximum of two frames. */
+  ObservationPreprocessor(int src_width, int src_height, int dst_width,
+                          int dst_height, bool max_pool,
+                          Interpolation interpolation);
+
+  /** Parses "nearest", "bilinear", "area" or "max"; throws on anything
+   *  else. */
+  static Interpolation parseInterpolation(const std::string& name);
+
+  int width() const { return m_dst_width; }
+  int height() const { return m_dst_height; }
+  bool maxPool() const { return m_max_pool; }
+
+  /** Whether the observation differs in size from the source frames. */
+  bool resizes() const;
+
+  /** Whether the given format can be preprocessed: palette indices can only
+   *  be resized with nearest-neighbour sampling and cannot be max-pooled. */
+  bool supports(ObservationFormat format) const;
+
+  /** Bytes held by the preprocessor, including the object itself. */
+  size_t memoryUsage() const;
+
+  /** Writes the observation of the palette-indexed frame into dst in the
+   *  given format. previous is the frame before it, used when max-pooling. */
+  void process(const ColourPalette& palette, const uint8_t* frame,
+               const uint8_t* previous, ObservationFormat format,
+               uint8_t* dst);
+
+ private:
+  // Source pixels and weights contributing to each output pixel along one
+  // axis; output i reads `taps` pixels from first[i] with weights
+  // weights[i * taps ...]
+  struct AxisFilter {
+    int taps;
+    std::vector<int> first;
+    std::vector<float> weights;
+  };
+
+  // The horizontal filter unrolled over the width * channels bytes of an
+  // output row: output byte e reads tap t from index[e] + t * channels of the
+  // vertically filtered row, with weight weights[t * row_length + e]
+  struct RowFilter {
+    std::vector<int> index;
+    std::vector<float> weights;
+  };
+
+  static AxisFilter makeFilter(int src_size, int dst_size,
+                               Interpolation interpolation);
+
+  /** Returns the row filter for the given number of channels, building it on
+   *  first use. */
+  const RowFilter& rowFilter(int channels);
+
+  /** Resizes one plane of interleaved channels from src into dst. */
+  void resizePlane(const uint8_t* src, int channels, uint8_t* dst,
+                   bool simd);
+
+ private:
+  int m_src_width, m_src_height;
+  int m_dst_width, m_dst_height;
+  bool m_max_pool;
+  Interpolation m_interpolation;
+
+  AxisFilter m_x_filter;
+  AxisFilter m_y_filter;
+  RowFilter m_row_filters[4];       // Indexed by channels - 1
+
+  std::vector<uint8_t> m_frame;     // Converted frame
+  std::vector<uint8_t> m_previous;  // Converted previous frame
+  std::vector<float> m_rows;        // Vertically filtered rows
+};
+
+}  // namespace ale
+
+#endif  // __OBSERVATION_PREPROCESSOR_HPP__
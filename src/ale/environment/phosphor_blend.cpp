@@ -16,109 +16,173 @@
 
 #include "ale/environment/phosphor_blend.hpp"
 
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <vector>
+
 #include "ale/emucore/Console.hxx"
 
+#if (defined(__x86_64__) || defined(_M_X64) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define PHOSPHOR_SIMD_AVX2
+#include <immintrin.h>
+#endif
+
 namespace ale {
 using namespace stella;   // OSystem
 
+namespace {
+
+uint8_t getPhosphor(uint8_t v1, uint8_t v2, uint8_t blend_ratio) {
+  if (v1 < v2) {
+    int tmp = v1;
+    v1 = v2;
+    v2 = tmp;
+  }
+
+  uint32_t blendedValue = ((v1 - v2) * blend_ratio) / 100 + v2;
+  if (blendedValue > 255)
+    return 255;
+  else
+    return (uint8_t)blendedValue;
+}
+
+void blendScalar(uint8_t* dst, const uint8_t* current, const uint8_t* previous,
+                 size_t n, const uint8_t* table) {
+  for (size_t i = 0; i < n; i++)
+    dst[i] = table[(current[i] << 8) | previous[i]];
+}
+
+#ifdef PHOSPHOR_SIMD_AVX2
+#define PHOSPHOR_AVX2 __attribute__((target("avx2")))
+
+PHOSPHOR_AVX2 inline __m256i blend8(const uint8_t* table,
+                                    const uint8_t* current,
+                                    const uint8_t* previous) {
+  __m256i cv = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)current));
+  __m256i pv = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)previous));
+  __m256i index = _mm256_or_si256(_mm256_slli_epi32(cv, 8), pv);
+  return _mm256_and_si256(
+      _mm256_i32gather_epi32((const int*)table, index, 1),
+      _mm256_set1_epi32(0xFF));
+}
+
+// Blends 32 pixels per iteration with byte-granular 32-bit gathers into the
+// padded table and answers how many pixels it did
+PHOSPHOR_AVX2 size_t blendAVX2(uint8_t* dst, const uint8_t* current,
+                               const uint8_t* previous, size_t n,
+                               const uint8_t* table) {
+  // Undo the lane interleaving of the two pack steps
+  const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __m256i a = blend8(table, current + i, previous + i);
+    __m256i b = blend8(table, current + i + 8, previous + i + 8);
+    __m256i c = blend8(table, current + i + 16, previous + i + 16);
+    __m256i d = blend8(table, current + i + 24, previous + i + 24);
+    __m256i bytes = _mm256_packus_epi16(_mm256_packus_epi32(a, b),
+                                        _mm256_packus_epi32(c, d));
+    bytes = _mm256_permutevar8x32_epi32(bytes, order);
+    _mm256_storeu_si256((__m256i*)(dst + i), bytes);
+  }
+  return i;
+}
+#endif  // PHOSPHOR_SIMD_AVX2
+
+}  // namespace
+
 PhosphorBlend::PhosphorBlend(OSystem* osystem) : m_osystem(osystem) {
   // Taken from default Stella settings
   m_phosphor_blend_ratio = 77;
-
-  makeAveragePalette();
 }
 
 void PhosphorBlend::process(ALEScreen& screen) {
+  if (!m_table)
+    m_table = getTable(m_osystem->colourPalette(), m_phosphor_blend_ratio);
+
   Console& console = m_osystem->console();
 
   // Fetch current and previous frame buffers from the emulator
-  uint8_t* current_buffer = console.mediaSource().currentFrameBuffer();
-  uint8_t* previous_buffer = console.mediaSource().previousFrameBuffer();
-
-  // Process each pixel in turn
-  for (size_t i = 0; i < screen.arraySize(); i++) {
-    int cv = current_buffer[i];
-    int pv = previous_buffer[i];
-
-    // Find out the corresponding rgb color
-    uint32_t rgb = m_avg_palette[cv][pv];
+  const uint8_t* current_buffer = console.mediaSource().currentFrameBuffer();
+  const uint8_t* previous_buffer = console.mediaSource().previousFrameBuffer();
+
+  uint8_t* dst = screen.getArray();
+  size_t n = screen.arraySize();
+  size_t done = 0;
+#ifdef PHOSPHOR_SIMD_AVX2
+  if (m_osystem->colourPalette().simdEnabled())
+    done = blendAVX2(dst, current_buffer, previous_buffer, n, m_table->blend);
+#endif
+  blendScalar(dst + done, current_buffer + done, previous_buffer + done,
+              n - done, m_table->blend);
+}
 
-    // Set the corresponding pixel in the array
-    screen.getArray()[i] = rgbToNTSC(rgb);
+std::shared_ptr<const PhosphorBlend::Table>
+PhosphorBlend::getTable(const ColourPalette& palette, uint8_t blend_ratio) {
+  static std::mutex mutex;
+  static std::map<std::vector<uint32_t>, std::weak_ptr<const Table>> tables;
+
+  // Key on the palette colours themselves, so user palettes and the three
+  // display formats each get their own table
+  std::vector<uint32_t> key(257);
+  for (int c = 0; c < 256; c++)
+    key[c] = palette.getRGB(c);
+  key[256] = blend_ratio;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  std::shared_ptr<const Table> table = tables[key].lock();
+  if (!table) {
+    std::shared_ptr<Table> fresh = std::make_shared<Table>();
+    makeTable(palette, blend_ratio, *fresh);
+    table = fresh;
+    tables[key] = table;
   }
+  return table;
 }
-void PhosphorBlend::makeAveragePalette() {
-  ColourPalette& palette = m_osystem->colourPalette();
 
-  // Precompute the average RGB values for phosphor-averaged colors c1 and c2.
+void PhosphorBlend::makeTable(const ColourPalette& palette, uint8_t blend_ratio,
+                              Table& table) {
+  int rgb[128][3];
+  for (int c = 0; c < 256; c += 2)
+    palette.getRGB(c, rgb[c >> 1][0], rgb[c >> 1][1], rgb[c >> 1][2]);
+
+  // Closest NTSC match of each blended colour, found on a grid that drops
+  // the lowest two bits of each component. Only the grid points actually
+  // reached are searched.
+  std::vector<int16_t> nearest(64 * 64 * 64, -1);
+
   for (int c1 = 0; c1 < 256; c1 += 2) {
     for (int c2 = 0; c2 < 256; c2 += 2) {
-      int r1, g1, b1;
-      int r2, g2, b2;
-      palette.getRGB(c1, r1, g1, b1);
-      palette.getRGB(c2, r2, g2, b2);
-
-      uint8_t r = getPhosphor(r1, r2);
-      uint8_t g = getPhosphor(g1, g2);
-      uint8_t b = getPhosphor(b1, b2);
-      m_avg_palette[c1][c2] = makeRGB(r, g, b);
-    }
-  }
-
-  // Also make a RGB to NTSC color map. We drop the lowest two bits to speed
-  // the initialization a little. TODO(mgbellemare): Find a better solution.
-  for (int r = 0; r < 256; r += 4) {
-    for (int g = 0; g < 256; g += 4) {
-      for (int b = 0; b < 256; b += 4) {
-        // For each RGB point, we find its closest NTSC match
+      const int* p1 = rgb[c1 >> 1];
+      const int* p2 = rgb[c2 >> 1];
+      int r = getPhosphor(p1[0], p2[0], blend_ratio) & ~3;
+      int g = getPhosphor(p1[1], p2[1], blend_ratio) & ~3;
+      int b = getPhosphor(p1[2], p2[2], blend_ratio) & ~3;
+
+      int16_t& match = nearest[((r >> 2) << 12) | ((g >> 2) << 6) | (b >> 2)];
+      if (match < 0) {
+        // Odd palette entries correspond to grayscale values and are ignored
         int minDist = 256 * 3 + 1;
-        int minIndex = -1;
-
-        // Look for the closest NTSC value matching (r,g,b). Odd palette
-        // entries correspond to grayscale values and are ignored.
-        for (int c1 = 0; c1 < 256; c1 += 2) {
-          // Get the RGB corresponding to c1
-          int r1, g1, b1;
-          palette.getRGB(c1, r1, g1, b1);
-
-          int dist = abs(r1 - r) + abs(g1 - g) + abs(b1 - b);
+        for (int c = 0; c < 256; c += 2) {
+          const int* p = rgb[c >> 1];
+          int dist = abs(p[0] - r) + abs(p[1] - g) + abs(p[2] - b);
           if (dist < minDist) {
             minDist = dist;
-            minIndex = c1;
+            match = c;
           }
         }
-
-        m_rgb_ntsc[r >> 2][g >> 2][b >> 2] = minIndex;
       }
+      table.blend[(c1 << 8) | c2] = (uint8_t)match;
     }
   }
-}
-
-uint8_t PhosphorBlend::getPhosphor(uint8_t v1, uint8_t v2) {
-  if (v1 < v2) {
-    int tmp = v1;
-    v1 = v2;
-    v2 = tmp;
-  }
-
-  uint32_t blendedValue = ((v1 - v2) * m_phosphor_blend_ratio) / 100 + v2;
-  if (blendedValue > 255)
-    return 255;
-  else
-    return (uint8_t)blendedValue;
-}
-
-uint32_t PhosphorBlend::makeRGB(uint8_t r, uint8_t g, uint8_t b) {
-  return (r << 16) | (g << 8) | b;
-}
-
-/** Converts a RGB value to an 8-bit format */
-uint8_t PhosphorBlend::rgbToNTSC(uint32_t rgb) {
-  int r = (rgb >> 16) & 0xFF;
-  int g = (rgb >> 8) & 0xFF;
-  int b = rgb & 0xFF;
 
-  return m_rgb_ntsc[r >> 2][g >> 2][b >> 2];
+  // Odd indices blend like the colour they differ from in the lowest bit
+  for (int c1 = 0; c1 < 256; c1++)
+    for (int c2 = 0; c2 < 256; c2++)
+      table.blend[(c1 << 8) | c2] = table.blend[((c1 & ~1) << 8) | (c2 & ~1)];
+  table.blend[256 * 256] = table.blend[256 * 256 + 1] =
+      table.blend[256 * 256 + 2] = 0;
 }
 
 }  // namespace ale
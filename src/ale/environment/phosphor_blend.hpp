@@ -17,6 +17,9 @@
 #ifndef __PHOSPHOR_BLEND_HPP__
 #define __PHOSPHOR_BLEND_HPP__
 
+#include <cstdint>
+#include <memory>
+
 #include "ale/emucore/OSystem.hxx"
 #include "ale/environment/ale_screen.hpp"
 
@@ -26,21 +29,34 @@ class PhosphorBlend {
  public:
   PhosphorBlend(stella::OSystem*);
 
+  /** Blends the current and previous frames into the given screen. The blend
+   *  table is fetched on the first call, so environments without colour
+   *  averaging never build one. */
   void process(ALEScreen& screen);
 
+  /** Bytes of the blend table in use, which is shared with other blenders,
+   *  or 0 before the first process(). */
+  size_t tableMemoryUsage() const { return m_table ? sizeof(Table) : 0; }
+
+  /** Blended colour of every (current, previous) pair of palette indices.
+   *  Tables are immutable and shared by all blenders with the same palette
+   *  and blend ratio. */
+  struct Table {
+    // Indexed by (current << 8) | previous; three bytes of padding let the
+    // vectorised kernel read each entry with a 32-bit gather
+    uint8_t blend[256 * 256 + 3];
+  };
+
  private:
-  void makeAveragePalette();
-  uint8_t getPhosphor(uint8_t v1, uint8_t v2);
-  uint32_t makeRGB(uint8_t r, uint8_t g, uint8_t b);
-  /** Converts a RGB value to an 8-bit format */
-  uint8_t rgbToNTSC(uint32_t rgb);
+  static std::shared_ptr<const Table> getTable(const ColourPalette& palette,
+                                               uint8_t blend_ratio);
+  static void makeTable(const ColourPalette& palette, uint8_t blend_ratio,
+                        Table& table);
 
  private:
   stella::OSystem* m_osystem;
 
-  uint8_t m_rgb_ntsc[64][64][64];
-
-  uint32_t m_avg_palette[256][256];
+  std::shared_ptr<const Table> m_table;  // NULL until the first process()
   uint8_t m_phosphor_blend_ratio;
 };
 
@@ -20,9 +20,15 @@
 #include <algorithm>
 #include <sstream>
 #include <cstring>
+#include <iomanip>
 #include <optional>
+#include <stdexcept>
 
+#include "ale/common/ScreenCodec.hpp"
+#include "ale/common/ScreenHash.hpp"
 #include "ale/common/SoundRaw.hxx"
+#include "ale/emucore/Console.hxx"
+#include "ale/emucore/Control.hxx"
 #include "ale/emucore/System.hxx"
 
 namespace ale {
@@ -52,14 +58,17 @@ StellaEnvironment::StellaEnvironment(OSystem* osystem, RomSettings* settings)
   m_cartridge_md5 = m_osystem->console().properties().get(Cartridge_MD5);
 
   // Initialize RNG
+  m_random.setGenerator(
+      Random::generatorFromName(m_osystem->settings().getString("random_generator")));
+  uint64_t stream = (uint32_t)m_osystem->settings().getInt("random_stream");
   int32_t seed;
   if (m_osystem->settings().getInt("random_seed") == -1) {
     seed = time(NULL);
-    m_random.seed((uint32_t)seed);
+    m_random.seed((uint32_t)seed, stream);
   } else {
     seed = m_osystem->settings().getInt("random_seed");
     assert(seed >= 0);
-    m_random.seed((uint32_t)seed);
+    m_random.seed((uint32_t)seed, stream);
   }
   Logger::Info << "Random seed is " << seed << std::endl;
 
@@ -84,21 +93,160 @@ StellaEnvironment::StellaEnvironment(OSystem* osystem, RomSettings* settings)
     m_frame_skip = 1;
   }
 
+  m_auto_frame_skip = m_osystem->settings().getBool("auto_frame_skip");
+  m_auto_frame_skip_max = m_osystem->settings().getInt("auto_frame_skip_max");
+  if (m_auto_frame_skip_max < 0) {
+    Logger::Warning << "Warning: auto frame skip max set to < 0. Setting to 0.\n";
+    m_auto_frame_skip_max = 0;
+  }
+  m_last_act_frames = 0;
+
+  // Which observations are kept up to date: the screen, the RAM, or neither
+  const std::string& observationMode =
+      m_osystem->settings().getString("observation_mode");
+  if (observationMode != "screen" && observationMode != "ram" &&
+      observationMode != "none") {
+    throw std::runtime_error("Unknown observation_mode '" + observationMode +
+                             "' (expected screen, ram or none)");
+  }
+  m_observe_screen = observationMode == "screen";
+  m_observe_ram = observationMode != "none";
+
   // If so desired, we record all emulated frames to a given directory
   std::string recordDir = m_osystem->settings().getString("record_screen_dir");
-  if (!recordDir.empty()) {
+  if (!recordDir.empty() && !m_observe_screen) {
+    Logger::Warning << "Warning: record_screen_dir is ignored when "
+                    << "observation_mode is " << observationMode << ".\n";
+  } else if (!recordDir.empty()) {
     Logger::Info << "Recording screens to directory: " << recordDir << "\n";
 
+    const std::string& format = m_osystem->settings().getString("record_screen_format");
+    if (format != "rgb" && format != "indexed") {
+      throw std::runtime_error("Unknown record_screen_format '" + format +
+                               "' (expected rgb or indexed)");
+    }
+    int compression = m_osystem->settings().getInt("record_screen_compression");
+    if (compression < -1 || compression > 9) {
+      throw std::runtime_error("Invalid record_screen_compression " +
+                               std::to_string(compression) +
+                               " (expected -1 to 9)");
+    }
+
     // Create the screen exporter
-    m_screen_exporter.reset(
-        new ScreenExporter(m_osystem->colourPalette(), recordDir));
+    m_screen_exporter.reset(new ScreenExporter(
+        m_osystem->colourPalette(), recordDir,
+        m_osystem->settings().getInt("record_screen_threads"), format == "indexed",
+        compression));
+  }
+
+  // If so desired, we record every episode into a video file of its own
+  m_video_dir = m_osystem->settings().getString("record_video_dir");
+  m_video_episode = 0;
+  if (!m_video_dir.empty() && !m_observe_screen) {
+    Logger::Warning << "Warning: record_video_dir is ignored when "
+                    << "observation_mode is " << observationMode << ".\n";
+  } else if (!m_video_dir.empty()) {
+    Logger::Info << "Recording episode videos to directory: " << m_video_dir << "\n";
+    m_video_writer.reset(new EpisodeVideoWriter(m_osystem->colourPalette()));
+  }
+
+  // If so desired, we append every transition to an offline dataset
+  std::string datasetDir = m_osystem->settings().getString("dataset_dir");
+  if (!datasetDir.empty()) {
+    TrajectoryFrames frames = TrajectoryDatasetWriter::parseFrames(
+        m_osystem->settings().getString("dataset_frames"));
+    if (frames != TRAJECTORY_FRAMES_NONE && !m_observe_screen) {
+      Logger::Warning << "Warning: the dataset has no frames when "
+                      << "observation_mode is " << observationMode << ".\n";
+      frames = TRAJECTORY_FRAMES_NONE;
+    }
+    Logger::Info << "Writing the trajectory dataset to directory: " << datasetDir << "\n";
+    m_dataset_writer.reset(new TrajectoryDatasetWriter(
+        datasetDir, frames,
+        m_osystem->settings().getInt("dataset_block_records"),
+        m_osystem->settings().getInt("dataset_file_blocks"),
+        m_osystem->settings().getInt("dataset_sync_blocks")));
+  }
+
+  m_deferred_screen =
+      m_observe_screen &&
+      m_osystem->settings().getBool("deferred_tia_render") &&
+      !m_osystem->settings().getBool("fast_tia_update");
+  m_screen_stale = false;
+  m_observation_buffer = NULL;
+  m_observation_format = OBS_PALETTE_INDEX;
+
+  // In-engine preprocessing of the observation buffer
+  bool maxPool = m_osystem->settings().getBool("observation_max_pool");
+  if (maxPool && m_colour_averaging) {
+    Logger::Warning << "Warning: observation_max_pool is ignored with "
+                    << "color_averaging, which already blends the two frames.\n";
+    maxPool = false;
+  }
+  int observationWidth = m_osystem->settings().getInt("observation_width");
+  int observationHeight = m_osystem->settings().getInt("observation_height");
+  ObservationPreprocessor::Interpolation interpolation =
+      ObservationPreprocessor::parseInterpolation(
+          m_osystem->settings().getString("observation_interpolation"));
+  if (maxPool || (observationWidth > 0 && observationWidth != (int)m_screen.width()) ||
+      (observationHeight > 0 && observationHeight != (int)m_screen.height())) {
+    m_preprocessor.reset(new ObservationPreprocessor(
+        m_screen.width(), m_screen.height(), observationWidth,
+        observationHeight, maxPool, interpolation));
+  }
+
+  // Ring buffer of the last observations
+  int frameStackDepth = m_osystem->settings().getInt("frame_stack");
+  m_frame_stack_format =
+      (ObservationFormat)m_osystem->settings().getInt("frame_stack_format");
+  if (m_frame_stack_format < OBS_PALETTE_INDEX || m_frame_stack_format > OBS_RGBA) {
+    throw std::runtime_error("Unknown frame_stack_format " +
+                             std::to_string(m_frame_stack_format));
+  }
+  if (frameStackDepth > 0 && !m_observe_screen) {
+    Logger::Warning << "Warning: frame_stack is ignored when the screen is not "
+                    << "observed (observation_mode is not screen).\n";
+  } else if (frameStackDepth > 0) {
+    if (m_preprocessor && !m_preprocessor->supports(m_frame_stack_format)) {
+      throw std::runtime_error("Palette-indexed frame stacks cannot be max-pooled "
+                               "or resized other than with nearest interpolation");
+    }
+    m_frame_stack.reset(new FrameStack(
+        frameStackDepth, (size_t)getObservationWidth() * getObservationHeight() *
+                             ColourPalette::bytesPerPixel(m_frame_stack_format)));
   }
 
+  // Frames that are not part of the observation can skip rasterisation, unless
+  // something else (the display, the screen recorder) looks at every frame.
+  // Deferred rendering already skips every frame nobody looks at.
+  m_render_observed_only =
+      m_observe_screen &&
+      m_osystem->settings().getBool("render_observed_frames_only") &&
+      !m_osystem->settings().getBool("fast_tia_update") &&
+      !m_deferred_screen &&
+      !m_osystem->settings().getBool("display_screen") &&
+      m_screen_exporter.get() == NULL &&
+      m_video_writer.get() == NULL;
+  m_render_frame = true;
+
+  // Without sound observations or recording, the sound device is a null
+  // device and the audio path is skipped altogether
+  m_sound_active = !m_osystem->sound().isNull();
+  m_sound_window = m_sound_active && m_osystem->settings().getBool("sound_obs_window");
+  if (m_render_observed_only && m_sound_active)
+    m_mute_sound.reset(new SoundNull(&m_osystem->settings()));
   m_sound.resize(SoundRaw::SamplesPerFrame, 0);
+
+  m_frames_emulated = 0;
+  m_delta_frame = 0;
 }
 
 /** Resets the system to its start state. */
 void StellaEnvironment::reset() {
+  // The next recorded frame starts the next episode's video
+  if (m_video_writer)
+    m_video_writer->close();
+
   m_state.resetEpisodeFrameNumber();
   // Reset the paddles
   m_state.resetPaddles(m_osystem->event());
@@ -127,6 +275,11 @@ void StellaEnvironment::reset() {
   for (size_t i = 0; i < startingActions.size(); i++) {
     emulate(startingActions[i], PLAYER_B_NOOP, 1.0, 1.0);
   }
+
+  writeObservation(true);
+
+  if (m_dataset_writer)
+    recordTransition(-1, 0);
 }
 
 ALEState StellaEnvironment::cloneState(bool include_rng) {
@@ -162,40 +315,108 @@ reward_t StellaEnvironment::act(Action player_a_action, Action player_b_action,
 
   Random& rng = getEnvironmentRNG();
 
+  if (m_sound_window)
+    m_sound.clear();
+
   // Apply the same action for a given number of times... note that act() will refuse to emulate
   //  past the terminal state
-  for (size_t i = 0; i < m_frame_skip; i++) {
-    // Stochastically drop actions, according to m_repeat_action_probability
-    if (rng.nextDouble() >= m_repeat_action_probability) {
+  size_t num_frames = m_frame_skip;
+  for (size_t i = 0; i < num_frames; i++) {
+    // Only the last frame (or the last two, which colour averaging blends) is
+    // observed; the others are emulated without writing the frame buffer
+    if (m_render_observed_only) {
+      size_t observed_frames =
+          (m_colour_averaging || (m_preprocessor && m_preprocessor->maxPool())) ? 2 : 1;
+      setFrameRendering(i + observed_frames >= num_frames);
+    }
+
+    // Stochastically drop actions, according to m_repeat_action_probability.
+    // Without stickiness every action is taken and no numbers are drawn
+    if (m_repeat_action_probability <= 0) {
       m_player_a_action = player_a_action;
       m_paddle_a_strength = paddle_a_strength;
-    }
-    // @todo Possibly optimize by avoiding call to rand() when player B is "off" ?
-    if (rng.nextDouble() >= m_repeat_action_probability) {
       m_player_b_action = player_b_action;
       m_paddle_b_strength = paddle_b_strength;
+    } else {
+      if (rng.nextDouble() >= m_repeat_action_probability) {
+        m_player_a_action = player_a_action;
+        m_paddle_a_strength = paddle_a_strength;
+      }
+      // @todo Possibly optimize by avoiding call to rand() when player B is "off" ?
+      if (rng.nextDouble() >= m_repeat_action_probability) {
+        m_player_b_action = player_b_action;
+        m_paddle_b_strength = paddle_b_strength;
+      }
     }
 
     // If so desired, request one frame's worth of sound (this does nothing if recording
     // is not enabled)
-    m_osystem->sound().recordNextFrame();
+    if (m_sound_active)
+      m_osystem->sound().recordNextFrame();
 
     // Render screen if we're displaying it
     m_osystem->screen().render();
 
     // Similarly record screen as needed
     if (m_screen_exporter.get() != NULL)
-      m_screen_exporter->saveNext(m_screen);
+      m_screen_exporter->saveNext(getScreen());
+
+    if (m_auto_frame_skip)
+      resetInputPolled();
+
+    // Use the stored actions, which may or may not have changed this frame;
+    // past the end of the episode oneStepAct() emulates nothing
+    bool emulated = !isTerminal();
+
+    // A frame that is not rasterised may still end the game and so be
+    // observed after all; keep the state it starts from to draw it then
+    bool replayable = emulated && m_render_observed_only && !m_render_frame;
+    if (replayable) {
+      stella::System& system = m_osystem->console().system();
+      m_frame_state.resize(system.stateSize());
+      system.saveState(m_frame_state.data());
+    }
+
+    reward_t reward = oneStepAct(m_player_a_action, m_player_b_action,
+                                 m_paddle_a_strength, m_paddle_b_strength);
+    sum_rewards += reward;
+
+    if (replayable && isTerminal())
+      renderEndingFrame();
+
+    if (m_video_writer && emulated)
+      recordVideoFrame(reward, m_player_a_action);
 
-    // Use the stored actions, which may or may not have changed this frame
-    sum_rewards += oneStepAct(m_player_a_action, m_player_b_action,
-                              m_paddle_a_strength, m_paddle_b_strength);
+    // Keep the audio of every frame of the step that was emulated
+    if (m_sound_window && emulated) {
+      m_sound.resize(m_sound.size() + SoundRaw::SamplesPerFrame);
+      processAudio(i);
+    }
+
+    // With automatic frame skipping, keep emulating past frame_skip until the game
+    // reads its controllers again; until then the next action could not matter anyway
+    if (m_auto_frame_skip && i + 1 == num_frames && !inputPolled() && !isTerminal() &&
+        num_frames < m_frame_skip + m_auto_frame_skip_max) {
+      num_frames++;
+    }
+  }
+  m_last_act_frames = num_frames;
 
-    // Process audio for user queries (accounts for frame_skip)
-    processAudio(i);
+  // Leave rendering on for reset() and the frames emulated outside act()
+  if (m_render_observed_only) {
+    setFrameRendering(true);
   }
 
-  return std::clamp(sum_rewards, m_reward_min, m_reward_max);
+  // Process audio for user queries (accounts for frame_skip)
+  if (m_sound_active && !m_sound_window)
+    processAudio(0);
+
+  writeObservation(false);
+
+  reward_t reward = std::clamp(sum_rewards, m_reward_min, m_reward_max);
+  if (m_dataset_writer)
+    recordTransition(player_a_action, reward);
+  return reward;
 }
 
 /** This functions emulates a push on the reset button of the console */
@@ -256,8 +477,7 @@ void StellaEnvironment::pressSelect(size_t num_steps) {
   for (size_t t = 0; t < num_steps; t++) {
     m_osystem->console().mediaSource().update();
   }
-  processScreen();
-  processRAM();
+  processObservation();
   emulate(PLAYER_A_NOOP, PLAYER_B_NOOP, 1.0, 1.0);
   m_state.incrementFrame();
 }
@@ -290,6 +510,7 @@ void StellaEnvironment::emulate(
 
       m_osystem->console().mediaSource().update();
       m_settings->step(m_osystem->console().system());
+      m_frames_emulated++;
     }
   } else {
     // In joystick mode we only need to set the action events once
@@ -298,12 +519,15 @@ void StellaEnvironment::emulate(
     for (size_t t = 0; t < num_steps; t++) {
       m_osystem->console().mediaSource().update();
       m_settings->step(m_osystem->console().system());
+      m_frames_emulated++;
     }
   }
 
-  // Parse screen and RAM into their respective data structures
-  processScreen();
-  processRAM();
+  // Parse screen and RAM into their respective data structures; act() skips
+  // this for frames that are not part of the observation
+  if (m_render_frame) {
+    processObservation();
+  }
 }
 
 /** Accessor methods for the environment state. */
@@ -316,6 +540,185 @@ std::unique_ptr<StellaEnvironmentWrapper> StellaEnvironment::getWrapper() {
       new StellaEnvironmentWrapper(*this));
 }
 
+void StellaEnvironment::memoryUsage(MemoryUsage& usage) const {
+  // Screen, RAM, state and blender objects are held inline
+  usage.add("StellaEnvironment",
+            sizeof(*this) + m_sound.capacity() + m_delta_reference.capacity() +
+                MemoryUsage::heapBytes(m_cartridge_md5) +
+                MemoryUsage::heapBytes(m_state.m_serialized_state));
+  usage.add("ALEScreen", m_screen.arraySize());
+  if (m_preprocessor)
+    usage.add("ObservationPreprocessor", m_preprocessor->memoryUsage());
+  if (m_frame_stack)
+    usage.add("FrameStack", m_frame_stack->memoryUsage());
+  if (m_screen_exporter)
+    usage.add("ScreenExporter", m_screen_exporter->memoryUsage());
+  if (m_video_writer)
+    usage.add("EpisodeVideoWriter", m_video_writer->memoryUsage());
+  if (m_dataset_writer)
+    usage.add("TrajectoryDatasetWriter", m_dataset_writer->memoryUsage());
+  if (m_phosphor_blend.tableMemoryUsage() > 0)
+    usage.add("PhosphorBlend table", m_phosphor_blend.tableMemoryUsage(), true);
+}
+
+const ALEScreen& StellaEnvironment::getScreen() {
+  checkScreenObserved("getScreen");
+  // With deferred rendering the TIA draws the frame when processScreen()
+  // asks for its frame buffer
+  if (m_screen_stale) {
+    processScreen();
+    m_screen_stale = false;
+  }
+  return m_screen;
+}
+
+void StellaEnvironment::processObservation() {
+  if (m_observe_screen) {
+    // The screen is produced on demand by getScreen() or writeObservation()
+    if (m_deferred_screen || m_observation_buffer != NULL || m_frame_stack)
+      m_screen_stale = true;
+    else
+      processScreen();
+  }
+  if (m_observe_ram)
+    processRAM();
+}
+
+void StellaEnvironment::checkScreenObserved(const char* caller) const {
+  if (!m_observe_screen) {
+    throw std::runtime_error(std::string(caller) +
+                             "() needs observation_mode screen (it is " +
+                             (m_observe_ram ? "ram" : "none") + ")");
+  }
+}
+
+void StellaEnvironment::setObservationBuffer(uint8_t* buffer,
+                                             ObservationFormat format) {
+  if (buffer != NULL)
+    checkScreenObserved("setObservationBuffer");
+  if (buffer != NULL && m_preprocessor && !m_preprocessor->supports(format)) {
+    throw std::runtime_error("Palette-indexed observations cannot be max-pooled "
+                             "or resized other than with nearest interpolation");
+  }
+  m_observation_buffer = buffer;
+  m_observation_format = format;
+}
+
+int StellaEnvironment::getObservationWidth() const {
+  return m_preprocessor ? m_preprocessor->width() : m_screen.width();
+}
+
+int StellaEnvironment::getObservationHeight() const {
+  return m_preprocessor ? m_preprocessor->height() : m_screen.height();
+}
+
+void StellaEnvironment::setFrameStackBuffer(uint8_t* buffer) {
+  if (!m_frame_stack)
+    throw std::runtime_error("No frame stack: frame_stack is 0");
+  m_frame_stack->setBuffer(buffer);
+}
+
+void StellaEnvironment::getScreenDirtyRows(uint8_t* bitmap) {
+  checkScreenObserved("getScreenDirtyRows");
+  int height = (int)m_screen.height();
+  size_t bitmap_size = (height + 7) / 8;
+  if (m_colour_averaging) {
+    std::memset(bitmap, 0xff, bitmap_size);
+    return;
+  }
+
+  // Repack the TIA's 64-bit words into bytes
+  const uint64_t* rows = m_osystem->console().mediaSource().dirtyRows();
+  for (size_t i = 0; i < bitmap_size; i++)
+    bitmap[i] = (uint8_t)(rows[i / 8] >> (8 * (i % 8)));
+}
+
+uint64_t StellaEnvironment::getScreenHash() {
+  checkScreenObserved("getScreenHash");
+  if (!m_colour_averaging)
+    return m_osystem->console().mediaSource().frameHash(m_screen.height());
+
+  const ALEScreen& screen = getScreen();
+  return hashScreen(screen.getArray(), screen.width(), screen.height());
+}
+
+size_t StellaEnvironment::getScreenDelta(uint8_t* dst) {
+  const ALEScreen& screen = getScreen();
+  int width = (int)screen.width();
+  int height = (int)screen.height();
+  std::vector<uint8_t> changed((height + 7) / 8);
+
+  if (m_delta_reference.empty()) {
+    std::fill(changed.begin(), changed.end(), 0xff);
+    m_delta_reference.resize(screen.arraySize());
+  } else if (m_delta_frame + 1 == m_frames_emulated && !m_colour_averaging) {
+    // The reference is the TIA's previous frame, which it compared every row
+    // against while drawing this one
+    getScreenDirtyRows(changed.data());
+  } else {
+    findChangedRows(screen.getArray(), m_delta_reference.data(), width, height,
+                    changed.data());
+  }
+
+  size_t size = encodeScreenDelta(screen.getArray(), changed.data(), width,
+                                  height, dst);
+  decodeScreenDelta(dst, size, width, height, m_delta_reference.data());
+  m_delta_frame = m_frames_emulated;
+  return size;
+}
+
+void StellaEnvironment::resetScreenDelta() {
+  m_delta_reference.clear();
+}
+
+void StellaEnvironment::writeObservation(bool new_episode) {
+  if ((m_observation_buffer == NULL && !m_frame_stack) || !m_observe_screen)
+    return;
+
+  // Without colour averaging a stale screen is exactly the TIA frame buffer,
+  // so convert straight from it and leave m_screen for getScreen() to fill
+  const pixel_t* frame;
+  if (m_screen_stale && !m_colour_averaging)
+    frame = m_osystem->console().mediaSource().currentFrameBuffer();
+  else
+    frame = getScreen().getArray();
+
+  // Only the newest slot is written; older observations stay where they are
+  const uint8_t* stacked = NULL;
+  if (m_frame_stack) {
+    uint8_t* slot = m_frame_stack->advance();
+    renderObservation(frame, m_frame_stack_format, slot);
+    if (new_episode)
+      m_frame_stack->fillFromHead();
+    stacked = slot;
+  }
+
+  if (m_observation_buffer != NULL) {
+    if (stacked != NULL && m_observation_format == m_frame_stack_format)
+      std::memcpy(m_observation_buffer, stacked, m_frame_stack->frameBytes());
+    else
+      renderObservation(frame, m_observation_format, m_observation_buffer);
+  }
+}
+
+void StellaEnvironment::renderObservation(const pixel_t* frame,
+                                          ObservationFormat format,
+                                          uint8_t* dst) {
+  if (m_preprocessor) {
+    // Max-pooling reads the frame before the observed one, which the TIA
+    // still holds as its previous frame buffer
+    const uint8_t* previous = NULL;
+    if (m_preprocessor->maxPool())
+      previous = m_osystem->console().mediaSource().previousFrameBuffer();
+    m_preprocessor->process(m_osystem->colourPalette(), frame, previous,
+                            format, dst);
+    return;
+  }
+
+  m_osystem->colourPalette().applyPalette(dst, frame, m_screen.arraySize(),
+                                          format);
+}
+
 void StellaEnvironment::processScreen() {
   if (m_colour_averaging) {
     // Perform phosphor averaging; the blender stores its result in the given screen
@@ -328,14 +731,75 @@ void StellaEnvironment::processScreen() {
   }
 }
 
-void StellaEnvironment::processAudio(size_t i_frame) {
-    // Processes audio for sound observation (waits for final frame of frame_skip batch)
-    if ((i_frame+1) == m_frame_skip) {
-      // clear audio data from the previous frame.
-      std::fill(m_sound.begin(), m_sound.end(), 0);
+void StellaEnvironment::recordVideoFrame(reward_t reward, Action action) {
+  const ALEScreen& screen = getScreen();
+  if (!m_video_writer->isOpen()) {
+    std::ostringstream filename;
+    filename << m_video_dir << "/episode_" << std::setw(6) << std::setfill('0')
+             << m_video_episode++ << ".alv";
+    m_video_writer->open(filename.str(), screen.width(), screen.height());
+  }
+  m_video_writer->addFrame(screen.getArray(), reward, action);
+}
 
-      m_osystem->sound().process(m_sound.data(), m_sound.size());
-    }
+void StellaEnvironment::recordTransition(int action, reward_t reward) {
+  if (!m_observe_ram)
+    processRAM();
+  int terminal = isGameTerminal() ? 1 : isGameTruncated() ? 2 : 0;
+  const ALEScreen* screen = m_observe_screen ? &getScreen() : NULL;
+  m_dataset_writer->addRecord(screen ? screen->getArray() : NULL,
+                              m_screen.width(), m_screen.height(), action,
+                              reward, terminal, m_settings->lives(),
+                              m_ram.array(), m_ram.size());
+}
+
+void StellaEnvironment::processAudio(size_t frame) {
+    // Processes audio for sound observation (called once the frame_skip batch is done,
+    // or after every frame with sound_obs_window)
+    // clear audio data from the previous frame.
+    uint8_t* samples = m_sound.data() + frame * SoundRaw::SamplesPerFrame;
+    std::fill(samples, samples + SoundRaw::SamplesPerFrame, 0);
+
+    m_osystem->sound().process(samples, SoundRaw::SamplesPerFrame);
+}
+
+void StellaEnvironment::setFrameRendering(bool render) {
+  m_render_frame = render;
+  m_osystem->console().mediaSource().setFastUpdate(!render);
+}
+
+void StellaEnvironment::renderEndingFrame() {
+  stella::MediaSource& media = m_osystem->console().mediaSource();
+
+  // Draw into the buffer the frame was emulated into, so the previous frame
+  // buffer keeps the last frame drawn. Colour averaging and max-pooling
+  // blend with that one, which is the frame just before unless it was not
+  // rasterised either.
+  m_osystem->console().system().loadState(m_frame_state.data());
+  media.swapFrameBuffers();
+  setFrameRendering(true);
+
+  // The frame's audio, reward and frame count were taken the first time;
+  // the inputs it read are still set
+  if (m_mute_sound)
+    media.setSound(*m_mute_sound);
+  media.update();
+  if (m_mute_sound)
+    media.setSound(m_osystem->sound());
+
+  processObservation();
+}
+
+bool StellaEnvironment::inputPolled() const {
+  const stella::Console& console = m_osystem->console();
+  return console.controller(stella::Controller::Left).polled() ||
+         console.controller(stella::Controller::Right).polled();
+}
+
+void StellaEnvironment::resetInputPolled() {
+  const stella::Console& console = m_osystem->console();
+  console.controller(stella::Controller::Left).resetPolled();
+  console.controller(stella::Controller::Right).resetPolled();
 }
 
 void StellaEnvironment::processRAM() {
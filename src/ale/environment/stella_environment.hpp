@@ -21,6 +21,8 @@
 #include "ale/environment/ale_ram.hpp"
 #include "ale/environment/ale_screen.hpp"
 #include "ale/environment/ale_state.hpp"
+#include "ale/environment/frame_stack.hpp"
+#include "ale/environment/observation_preprocessor.hpp"
 #include "ale/environment/phosphor_blend.hpp"
 #include "ale/environment/stella_environment_wrapper.hpp"
 #include "ale/emucore/Event.hxx"
@@ -30,7 +32,10 @@
 #include "ale/common/Constants.h"
 #include "ale/games/RomSettings.hpp"
 #include "ale/common/Log.hpp"
+#include "ale/common/MemoryUsage.hpp"
+#include "ale/common/EpisodeVideo.hpp"
 #include "ale/common/ScreenExporter.hpp"
+#include "ale/common/TrajectoryDataset.hpp"
 
 #include <cstddef>
 #include <memory>
@@ -102,20 +107,71 @@ class StellaEnvironment {
   void setState(const ALEState& state);
   const ALEState& getState() const;
 
-  /** Returns the current screen after processing (e.g. colour averaging) */
-  const ALEScreen& getScreen() const { return m_screen; }
+  /** Returns the current screen after processing (e.g. colour averaging).
+   *  Throws std::runtime_error unless observation_mode is screen, as do the
+   *  other screen accessors below: the screen is not kept up to date then. */
+  const ALEScreen& getScreen();
+
+  /** Dimensions of the screen, which are known in every observation_mode */
+  int getScreenWidth() const { return m_screen.width(); }
+  int getScreenHeight() const { return m_screen.height(); }
+
+  /** Registers caller memory that receives the observed screen at the end of
+   *  every act() and reset(), converted to the given format (observation_mode
+   *  must be screen). The buffer must
+   *  hold width * height * ColourPalette::bytesPerPixel(format) bytes and stay valid
+   *  until it is replaced or unregistered by passing NULL. While a buffer is
+   *  registered, getScreen() is only filled in when it is called. */
+  void setObservationBuffer(uint8_t* buffer, ObservationFormat format);
+
+  /** Dimensions of the observations written into the observation buffer,
+   *  which differ from the screen's when observation_width/height are set */
+  int getObservationWidth() const;
+  int getObservationHeight() const;
+
+  /** The ring buffer of the last frame_stack observations, or NULL when
+   *  frame_stack is 0. Every act() and reset() writes one slot; reset() then
+   *  copies it into the others. */
+  const FrameStack* getFrameStack() const { return m_frame_stack.get(); }
+
+  /** Keeps the frame stack's slots in caller memory of
+   *  getFrameStack()->size() bytes, or in the environment's own if NULL */
+  void setFrameStackBuffer(uint8_t* buffer);
+
+  /** Writes a bitmap of the rows of getScreen() that differ from the screen
+   *  of the frame before it ((height + 7) / 8 bytes, bit row % 8 of byte
+   *  row / 8), as tracked by the TIA while drawing. Every row is marked with
+   *  colour averaging, which blends two frames. */
+  void getScreenDirtyRows(uint8_t* bitmap);
+
+  /** Returns the 64-bit hash of getScreen() (see ScreenHash.hpp). Without
+   *  colour averaging it comes from the row hashes the TIA keeps while
+   *  drawing; with it the blended screen is hashed here. */
+  uint64_t getScreenHash();
+
+  /** Writes getScreen() delta-encoded against the screen of the previous
+   *  call (see ScreenCodec.hpp) into dst, which must hold screenDeltaBound()
+   *  bytes, and returns its size. The first call, and the first after
+   *  resetScreenDelta(), marks every row. */
+  size_t getScreenDelta(uint8_t* dst);
+  void resetScreenDelta();
 
   /** Accessor methods for RAM. `setRAM` can be useful to alter the environment.
    *  For example, learning a causal model of RAM transitions, changing environment dynamics, etc. */
   void setRAM(size_t memory_index, byte_t value);
   const ALERAM& getRAM() const { return m_ram; }
 
-  /** Returns the current audio frame */
+  /** Returns the audio of the last frame, or with sound_obs_window of every
+   *  frame of the last act() (SoundRaw::SamplesPerFrame samples per frame) */
   const std::vector<uint8_t>& getAudio() const { return m_sound; }
 
   int getFrameNumber() const { return m_state.getFrameNumber(); }
   int getEpisodeFrameNumber() const { return m_state.getEpisodeFrameNumber(); }
 
+  /** Returns the number of frames emulated by the last call to act(). This is
+   *  frame_skip unless auto_frame_skip extended the step. */
+  int getLastActFrames() const { return m_last_act_frames; }
+
   stella::Random& getEnvironmentRNG() { return m_random; }
 
   // Returns the current difficulty switch setting in use by the environment.
@@ -126,6 +182,10 @@ class StellaEnvironment {
   // game mode changes only take effect when the environment is reset.
   game_mode_t getMode() const { return m_state.getCurrentMode(); }
 
+  /** Adds the memory held by the environment, outside the emulator, to the
+   *  given accounting. The game's RomSettings are not included. */
+  void memoryUsage(MemoryUsage& usage) const;
+
   /** Returns a wrapper providing #include-free access to our methods. */
   std::unique_ptr<StellaEnvironmentWrapper> getWrapper();
 
@@ -143,13 +203,44 @@ class StellaEnvironment {
    *   from the minimal set of actions. */
   void noopIllegalActions(Action& player_a_action, Action& player_b_action);
 
+  /** Updates the observations selected by observation_mode */
+  void processObservation();
+  /** Throws std::runtime_error naming caller unless the screen is observed */
+  void checkScreenObserved(const char* caller) const;
+
+  /** Writes the current screen into the registered observation buffer and
+   *  the frame stack; a new episode refills the whole stack */
+  void writeObservation(bool new_episode);
+
+  /** Converts and preprocesses frame into dst in the given format */
+  void renderObservation(const pixel_t* frame, ObservationFormat format,
+                         uint8_t* dst);
+
   /** Processes the current emulator screen and saves it in m_screen */
   void processScreen();
-  /** Processes the current emulator audio and saves it in m_sound */
-  void processAudio(size_t i_frame);
+  /** Appends the current screen to the episode video, starting the next
+   *  episode's file if none is open */
+  void recordVideoFrame(reward_t reward, Action action);
+  /** Appends the current observation, with the action (-1 after a reset)
+   *  and reward that led to it, to the trajectory dataset */
+  void recordTransition(int action, reward_t reward);
+  /** Processes the current emulator audio and saves it in the given frame's
+   *  SoundRaw::SamplesPerFrame samples of m_sound */
+  void processAudio(size_t frame);
   /** Processes the emulator RAM and saves it in m_ram */
   void processRAM();
 
+  /** Turns frame buffer writes and screen/RAM processing on or off for the
+   *  frames emulated next */
+  void setFrameRendering(bool render);
+  /** Emulates the frame that just ended the game again from m_frame_state,
+   *  this time drawing it, for the observation of the terminal state */
+  void renderEndingFrame();
+
+  /** Returns true if the game read either controller since resetInputPolled() */
+  bool inputPolled() const;
+  void resetInputPolled();
+
  private:
   stella::OSystem* m_osystem;
   RomSettings* m_settings;
@@ -160,7 +251,7 @@ class StellaEnvironment {
   ALEState m_state;   // Current environment state
   ALEScreen m_screen; // The current ALE screen (possibly colour-averaged)
   ALERAM m_ram;       // The current ALE RAM
-  std::vector<uint8_t> m_sound; // The current audio frame
+  std::vector<uint8_t> m_sound; // The current audio frame(s)
 
   bool m_use_paddles; // Whether this game uses paddles
 
@@ -170,7 +261,32 @@ class StellaEnvironment {
   int m_max_num_frames_per_episode;  // Maxmimum number of frames per episode
   size_t m_frame_skip;               // How many frames to emulate per act()
   float m_repeat_action_probability; // Stochasticity of the environment
+  bool m_auto_frame_skip;            // Whether to skip frames until the game polls input
+  int m_auto_frame_skip_max;         // Extra frames auto_frame_skip may add per act()
+  int m_last_act_frames;             // Frames emulated by the last act()
+  bool m_render_observed_only;       // Whether to rasterise only observed frames
+  bool m_render_frame;               // Whether the current frame is rasterised
+  std::vector<uint8_t> m_frame_state; // Machine state before the last frame not rasterised
+  std::unique_ptr<SoundNull> m_mute_sound; // Sound device while a frame is emulated again
+  bool m_sound_active;               // Whether the sound device is not a null device
+  bool m_sound_window;               // Whether m_sound holds every frame of a step
+  bool m_observe_screen;             // Whether m_screen is kept up to date
+  bool m_observe_ram;                // Whether m_ram is kept up to date
+  bool m_deferred_screen;            // Whether m_screen is only filled in when read
+  bool m_screen_stale;               // Whether m_screen lags behind the emulator
+  uint8_t* m_observation_buffer;     // Caller memory for the observed screen, or NULL
+  ObservationFormat m_observation_format; // Pixel format of m_observation_buffer
+  std::unique_ptr<ObservationPreprocessor> m_preprocessor; // Max-pool/resize, or NULL
+  std::unique_ptr<FrameStack> m_frame_stack; // Last frame_stack observations, or NULL
+  ObservationFormat m_frame_stack_format;    // Pixel format of m_frame_stack
+  uint64_t m_frames_emulated;                // Frames emulated since construction
+  std::vector<uint8_t> m_delta_reference;    // Screen of the last getScreenDelta(), or empty
+  uint64_t m_delta_frame;                    // m_frames_emulated at that call
   std::unique_ptr<ScreenExporter> m_screen_exporter; // Automatic screen recorder
+  std::unique_ptr<EpisodeVideoWriter> m_video_writer; // Episode video recorder, or NULL
+  std::string m_video_dir;                   // Directory of the episode videos
+  int m_video_episode;                       // Number of the next episode video
+  std::unique_ptr<TrajectoryDatasetWriter> m_dataset_writer; // Offline dataset, or NULL
   int m_max_lives;                  // Maximum number of lives at the start of an episode.
   bool m_truncate_on_loss_of_life;  // Whether to truncate episodes on loss of life.
   int m_reward_min;                // Minimum reward value